@@ -0,0 +1,74 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/assets/asset_manager.h"
+
+#include <utility>
+
+#include "flutter/glue/trace_event.h"
+
+namespace blink {
+
+AssetManager::AssetManager() = default;
+
+AssetManager::~AssetManager() = default;
+
+void AssetManager::PushFront(fxl::RefPtr<AssetResolver> resolver) {
+  if (!resolver || !resolver->IsValid()) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(resolvers_mutex_);
+  resolvers_.push_front(std::move(resolver));
+}
+
+void AssetManager::PushBack(fxl::RefPtr<AssetResolver> resolver) {
+  if (!resolver || !resolver->IsValid()) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(resolvers_mutex_);
+  resolvers_.push_back(std::move(resolver));
+}
+
+std::deque<fxl::RefPtr<AssetResolver>> AssetManager::GetResolvers() const {
+  std::lock_guard<std::mutex> lock(resolvers_mutex_);
+  return resolvers_;
+}
+
+// |blink::AssetResolver|
+bool AssetManager::IsValid() const {
+  std::lock_guard<std::mutex> lock(resolvers_mutex_);
+  return !resolvers_.empty();
+}
+
+// |blink::AssetResolver|
+bool AssetManager::GetAsBuffer(const std::string& asset_name,
+                               std::vector<uint8_t>* data) {
+  TRACE_EVENT0("flutter", "AssetManager::GetAsBuffer");
+  if (asset_name.empty()) {
+    return false;
+  }
+  for (const auto& resolver : GetResolvers()) {
+    if (resolver->GetAsBuffer(asset_name, data)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// |blink::AssetResolver|
+std::unique_ptr<fml::Mapping> AssetManager::GetAsMapping(
+    const std::string& asset_name) {
+  TRACE_EVENT0("flutter", "AssetManager::GetAsMapping");
+  if (asset_name.empty()) {
+    return nullptr;
+  }
+  for (const auto& resolver : GetResolvers()) {
+    if (auto mapping = resolver->GetAsMapping(asset_name)) {
+      return mapping;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace blink
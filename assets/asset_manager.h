@@ -0,0 +1,54 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_ASSETS_ASSET_MANAGER_H_
+#define FLUTTER_ASSETS_ASSET_MANAGER_H_
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "flutter/assets/asset_resolver.h"
+#include "lib/fxl/macros.h"
+#include "lib/fxl/memory/ref_ptr.h"
+
+namespace blink {
+
+// Looks assets up in an ordered list of resolvers, returning the asset of the
+// first resolver that has it.
+class AssetManager final : public AssetResolver {
+ public:
+  AssetManager();
+
+  ~AssetManager() override;
+
+  void PushFront(fxl::RefPtr<AssetResolver> resolver);
+
+  void PushBack(fxl::RefPtr<AssetResolver> resolver);
+
+  // |blink::AssetResolver|
+  bool IsValid() const override;
+
+  // |blink::AssetResolver|
+  bool GetAsBuffer(const std::string& asset_name,
+                   std::vector<uint8_t>* data) override;
+
+  // |blink::AssetResolver|
+  std::unique_ptr<fml::Mapping> GetAsMapping(
+      const std::string& asset_name) override;
+
+ private:
+  mutable std::mutex resolvers_mutex_;
+  std::deque<fxl::RefPtr<AssetResolver>> resolvers_;
+
+  // Copies the resolvers so that lookups don't hold the lock.
+  std::deque<fxl::RefPtr<AssetResolver>> GetResolvers() const;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(AssetManager);
+};
+
+}  // namespace blink
+
+#endif  // FLUTTER_ASSETS_ASSET_MANAGER_H_
@@ -0,0 +1,42 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_ASSETS_ASSET_RESOLVER_H_
+#define FLUTTER_ASSETS_ASSET_RESOLVER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "flutter/fml/mapping.h"
+#include "lib/fxl/macros.h"
+#include "lib/fxl/memory/ref_counted.h"
+
+namespace blink {
+
+// A source of assets, such as a zip bundle or a directory. Resolvers may be
+// used from any thread.
+class AssetResolver : public fxl::RefCountedThreadSafe<AssetResolver> {
+ public:
+  AssetResolver() = default;
+
+  virtual ~AssetResolver() = default;
+
+  virtual bool IsValid() const = 0;
+
+  virtual bool GetAsBuffer(const std::string& asset_name,
+                           std::vector<uint8_t>* data) = 0;
+
+  // Returns the contents of the asset, or null if there is no such asset.
+  // Resolvers map the asset rather than copy it where they can.
+  virtual std::unique_ptr<fml::Mapping> GetAsMapping(
+      const std::string& asset_name) = 0;
+
+ private:
+  FXL_DISALLOW_COPY_AND_ASSIGN(AssetResolver);
+};
+
+}  // namespace blink
+
+#endif  // FLUTTER_ASSETS_ASSET_RESOLVER_H_
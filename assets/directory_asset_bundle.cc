@@ -7,15 +7,24 @@
 #include <fcntl.h>
 #include <unistd.h>
 
+#include <memory>
 #include <utility>
 
+#include "lib/fxl/files/directory.h"
 #include "lib/fxl/files/eintr_wrapper.h"
 #include "lib/fxl/files/file.h"
 #include "lib/fxl/files/path.h"
 #include "lib/fxl/files/unique_fd.h"
+#include "lib/fxl/logging.h"
 
 namespace blink {
 
+// |blink::AssetResolver|
+bool DirectoryAssetBundle::IsValid() const {
+  return files::IsDirectory(directory_);
+}
+
+// |blink::AssetResolver|
 bool DirectoryAssetBundle::GetAsBuffer(const std::string& asset_name,
                                        std::vector<uint8_t>* data) {
   std::string asset_path = GetPathForAsset(asset_name);
@@ -24,6 +33,18 @@ bool DirectoryAssetBundle::GetAsBuffer(const std::string& asset_name,
   return files::ReadFileToVector(asset_path, data);
 }
 
+// |blink::AssetResolver|
+std::unique_ptr<fml::Mapping> DirectoryAssetBundle::GetAsMapping(
+    const std::string& asset_name) {
+  std::string asset_path = GetPathForAsset(asset_name);
+  if (asset_path.empty())
+    return nullptr;
+  auto mapping = std::make_unique<fml::FileMapping>(asset_path);
+  if (mapping->GetMapping() == nullptr)
+    return nullptr;
+  return mapping;
+}
+
 DirectoryAssetBundle::~DirectoryAssetBundle() {}
 
 DirectoryAssetBundle::DirectoryAssetBundle(std::string directory)
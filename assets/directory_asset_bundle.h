@@ -8,16 +8,26 @@
 #include <string>
 #include <vector>
 
+#include "flutter/assets/asset_resolver.h"
 #include "lib/fxl/macros.h"
 
 namespace blink {
 
-class DirectoryAssetBundle {
+class DirectoryAssetBundle final : public AssetResolver {
  public:
   explicit DirectoryAssetBundle(std::string directory);
-  ~DirectoryAssetBundle();
+  ~DirectoryAssetBundle() override;
 
-  bool GetAsBuffer(const std::string& asset_name, std::vector<uint8_t>* data);
+  // |blink::AssetResolver|
+  bool IsValid() const override;
+
+  // |blink::AssetResolver|
+  bool GetAsBuffer(const std::string& asset_name,
+                   std::vector<uint8_t>* data) override;
+
+  // |blink::AssetResolver|
+  std::unique_ptr<fml::Mapping> GetAsMapping(
+      const std::string& asset_name) override;
 
  private:
   std::string GetPathForAsset(const std::string& asset_name);
@@ -5,25 +5,163 @@
 #include "flutter/assets/zip_asset_store.h"
 
 #include <fcntl.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
+#include <atomic>
+#include <map>
 #include <string>
+#include <tuple>
 #include <utility>
 
 #include "flutter/glue/trace_event.h"
 #include "lib/fxl/files/eintr_wrapper.h"
 #include "lib/fxl/files/unique_fd.h"
 #include "lib/zip/unique_unzipper.h"
+#include "third_party/zlib/zlib.h"
 
 namespace blink {
+namespace {
+
+// The bytes held by the inflated asset caches of all stores.
+std::atomic<size_t> g_inflated_cache_bytes{0};
+
+// A stored entry of the bundle, pointing into the bundle mapping.
+class BundleEntryMapping : public fml::Mapping {
+ public:
+  BundleEntryMapping(std::shared_ptr<fml::Mapping> bundle_mapping,
+                     size_t offset,
+                     size_t size)
+      : bundle_mapping_(std::move(bundle_mapping)),
+        offset_(offset),
+        size_(size) {}
+
+  ~BundleEntryMapping() override = default;
+
+  size_t GetSize() const override { return size_; }
+
+  const uint8_t* GetMapping() const override {
+    return bundle_mapping_->GetMapping() + offset_;
+  }
+
+ private:
+  std::shared_ptr<fml::Mapping> bundle_mapping_;
+  const size_t offset_;
+  const size_t size_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(BundleEntryMapping);
+};
+
+// An inflated entry of the bundle, which may be shared with the inflated
+// asset cache.
+class InflatedAssetMapping : public fml::Mapping {
+ public:
+  explicit InflatedAssetMapping(
+      std::shared_ptr<const std::vector<uint8_t>> data)
+      : data_(std::move(data)) {}
+
+  ~InflatedAssetMapping() override = default;
+
+  size_t GetSize() const override { return data_->size(); }
+
+  const uint8_t* GetMapping() const override { return data_->data(); }
+
+ private:
+  const std::shared_ptr<const std::vector<uint8_t>> data_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(InflatedAssetMapping);
+};
+
+// Inflates the raw deflate stream of a zip entry into data, which is sized to
+// the uncompressed contents.
+bool InflateEntryData(const uint8_t* compressed,
+                      size_t compressed_size,
+                      std::vector<uint8_t>* data) {
+  z_stream stream = {};
+  if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+    return false;
+  }
+  stream.next_in = const_cast<Bytef*>(compressed);
+  stream.avail_in = compressed_size;
+  stream.next_out = data->data();
+  stream.avail_out = data->size();
+  int result = inflate(&stream, Z_FINISH);
+  inflateEnd(&stream);
+  return result == Z_STREAM_END && stream.total_out == data->size();
+}
+
+// Identifies a version of a bundle file.
+struct BundleKey {
+  std::string path;
+  off_t size;
+  time_t modification_time;
+
+  bool operator<(const BundleKey& other) const {
+    return std::tie(path, size, modification_time) <
+           std::tie(other.path, other.size, other.modification_time);
+  }
+};
+
+}  // namespace
 
 ZipAssetStore::ZipAssetStore(UnzipperProvider unzipper_provider)
     : unzipper_provider_(std::move(unzipper_provider)) {
   BuildStatCache();
 }
 
-ZipAssetStore::~ZipAssetStore() = default;
+ZipAssetStore::ZipAssetStore(const std::string& zip_path)
+    : unzipper_provider_(GetUnzipperProviderForPath(zip_path)) {
+  auto mapping = std::make_shared<fml::FileMapping>(zip_path);
+  if (mapping->GetMapping() != nullptr) {
+    bundle_mapping_ = std::move(mapping);
+  }
+  BuildStatCache();
+}
+
+ZipAssetStore::~ZipAssetStore() {
+  g_inflated_cache_bytes -= inflated_cache_bytes_;
+}
+
+size_t ZipAssetStore::GetTotalInflatedCacheBytes() {
+  return g_inflated_cache_bytes.load();
+}
+
+fxl::RefPtr<ZipAssetStore> ZipAssetStore::GetShared(
+    const std::string& zip_path) {
+  struct stat stat_result = {};
+  if (::stat(zip_path.c_str(), &stat_result) != 0) {
+    return fxl::MakeRefCounted<ZipAssetStore>(zip_path);
+  }
+  BundleKey key = {zip_path, stat_result.st_size, stat_result.st_mtime};
+
+  static std::mutex stores_mutex;
+  static std::map<BundleKey, fxl::RefPtr<ZipAssetStore>>* stores =
+      new std::map<BundleKey, fxl::RefPtr<ZipAssetStore>>();
+  std::lock_guard<std::mutex> lock(stores_mutex);
+  auto found = stores->find(key);
+  if (found != stores->end()) {
+    return found->second;
+  }
+
+  // Only the latest version of each bundle is kept.
+  for (auto it = stores->begin(); it != stores->end();) {
+    if (it->first.path == zip_path) {
+      it = stores->erase(it);
+    } else {
+      ++it;
+    }
+  }
+  auto store = fxl::MakeRefCounted<ZipAssetStore>(zip_path);
+  (*stores)[key] = store;
+  return store;
+}
+
+// |blink::AssetResolver|
+bool ZipAssetStore::IsValid() const {
+  return !stat_cache_.empty();
+}
 
+// |blink::AssetResolver|
 bool ZipAssetStore::GetAsBuffer(const std::string& asset_name,
                                 std::vector<uint8_t>* data) {
   TRACE_EVENT0("flutter", "ZipAssetStore::GetAsBuffer");
@@ -33,27 +171,72 @@ bool ZipAssetStore::GetAsBuffer(const std::string& asset_name,
     return false;
   }
 
-  auto unzipper = unzipper_provider_();
+  if (!found->second.is_stored && IsInflatedCacheEnabled()) {
+    InflatedAsset asset = GetInflatedAsset(asset_name, &found->second);
+    if (!asset) {
+      return false;
+    }
+    data->assign(asset->begin(), asset->end());
+    return true;
+  }
 
-  if (!unzipper.is_valid()) {
-    return false;
+  return ReadEntry(&found->second, data);
+}
+
+std::unique_ptr<fml::Mapping> ZipAssetStore::GetAsMapping(
+    const std::string& asset_name) {
+  TRACE_EVENT0("flutter", "ZipAssetStore::GetAsMapping");
+  auto found = stat_cache_.find(asset_name);
+
+  if (found == stat_cache_.end()) {
+    return nullptr;
   }
 
-  int result = UNZ_OK;
+  bool is_stored = false;
+  size_t data_offset = GetDataOffset(&found->second, &is_stored);
+  if (data_offset != 0 && is_stored) {
+    return std::make_unique<BundleEntryMapping>(
+        bundle_mapping_, data_offset, found->second.uncompressed_size);
+  }
 
-  result = unzGoToFilePos(unzipper.get(), &(found->second.file_pos));
-  if (result != UNZ_OK) {
-    FXL_LOG(WARNING) << "unzGetCurrentFileInfo failed, error=" << result;
-    return false;
+  InflatedAsset asset = GetInflatedAsset(asset_name, &found->second);
+  if (!asset) {
+    return nullptr;
   }
+  return std::make_unique<InflatedAssetMapping>(std::move(asset));
+}
 
-  result = unzOpenCurrentFile(unzipper.get());
-  if (result != UNZ_OK) {
-    FXL_LOG(WARNING) << "unzOpenCurrentFile failed, error=" << result;
+void ZipAssetStore::SetInflatedCacheMaxBytes(size_t max_bytes) {
+  std::lock_guard<std::mutex> lock(inflated_cache_mutex_);
+  inflated_cache_max_bytes_ = max_bytes;
+  EvictInflatedAssetsLocked();
+}
+
+bool ZipAssetStore::IsInflatedCacheEnabled() {
+  std::lock_guard<std::mutex> lock(inflated_cache_mutex_);
+  return inflated_cache_max_bytes_ != 0;
+}
+
+bool ZipAssetStore::ReadEntry(CacheEntry* entry, std::vector<uint8_t>* data) {
+  bool is_stored = false;
+  size_t data_offset = GetDataOffset(entry, &is_stored);
+  if (data_offset != 0) {
+    const uint8_t* entry_data = bundle_mapping_->GetMapping() + data_offset;
+    if (is_stored) {
+      data->assign(entry_data, entry_data + entry->uncompressed_size);
+      return true;
+    }
+    TRACE_EVENT0("flutter", "ZipAssetStore::InflateEntryData");
+    data->resize(entry->uncompressed_size);
+    return InflateEntryData(entry_data, entry->compressed_size, data);
+  }
+
+  auto unzipper = OpenEntry(*entry);
+  if (!unzipper.is_valid()) {
     return false;
   }
 
-  data->resize(found->second.uncompressed_size);
+  data->resize(entry->uncompressed_size);
   int total_read = 0;
   while (total_read < static_cast<int>(data->size())) {
     int bytes_read = unzReadCurrentFile(
@@ -67,6 +250,107 @@ bool ZipAssetStore::GetAsBuffer(const std::string& asset_name,
   return true;
 }
 
+ZipAssetStore::InflatedAsset ZipAssetStore::GetInflatedAsset(
+    const std::string& asset_name,
+    CacheEntry* entry) {
+  {
+    std::lock_guard<std::mutex> lock(inflated_cache_mutex_);
+    auto found = inflated_asset_index_.find(asset_name);
+    if (found != inflated_asset_index_.end()) {
+      inflated_assets_.splice(inflated_assets_.begin(), inflated_assets_,
+                              found->second);
+      return found->second->second;
+    }
+  }
+
+  // Inflate without holding the lock so that other assets can be read in the
+  // meantime.
+  auto data = std::make_shared<std::vector<uint8_t>>();
+  if (!ReadEntry(entry, data.get())) {
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> lock(inflated_cache_mutex_);
+  if (data->size() <= inflated_cache_max_bytes_ &&
+      inflated_asset_index_.count(asset_name) == 0) {
+    inflated_assets_.emplace_front(asset_name, data);
+    inflated_asset_index_[asset_name] = inflated_assets_.begin();
+    inflated_cache_bytes_ += data->size();
+    g_inflated_cache_bytes += data->size();
+    EvictInflatedAssetsLocked();
+  }
+  return data;
+}
+
+void ZipAssetStore::EvictInflatedAssetsLocked() {
+  while (inflated_cache_bytes_ > inflated_cache_max_bytes_) {
+    const auto& oldest = inflated_assets_.back();
+    inflated_cache_bytes_ -= oldest.second->size();
+    g_inflated_cache_bytes -= oldest.second->size();
+    inflated_asset_index_.erase(oldest.first);
+    inflated_assets_.pop_back();
+  }
+}
+
+zip::UniqueUnzipper ZipAssetStore::OpenEntry(const CacheEntry& entry) {
+  auto unzipper = unzipper_provider_();
+
+  if (!unzipper.is_valid()) {
+    return unzipper;
+  }
+
+  unz_file_pos file_pos = entry.file_pos;
+  int result = unzGoToFilePos(unzipper.get(), &file_pos);
+  if (result != UNZ_OK) {
+    FXL_LOG(WARNING) << "unzGetCurrentFileInfo failed, error=" << result;
+    return zip::UniqueUnzipper();
+  }
+
+  result = unzOpenCurrentFile(unzipper.get());
+  if (result != UNZ_OK) {
+    FXL_LOG(WARNING) << "unzOpenCurrentFile failed, error=" << result;
+    return zip::UniqueUnzipper();
+  }
+
+  return unzipper;
+}
+
+size_t ZipAssetStore::GetDataOffset(CacheEntry* entry, bool* is_stored) {
+  if (!bundle_mapping_) {
+    return 0;
+  }
+
+  std::lock_guard<std::mutex> lock(data_offset_mutex_);
+  *is_stored = entry->is_stored;
+  if (!entry->is_stored && !entry->is_deflated) {
+    return 0;
+  }
+
+  if (entry->data_offset == 0) {
+    // The central directory does not record where the data starts, as the
+    // local header before it has a variable size. Opening the entry reads
+    // that header.
+    auto unzipper = OpenEntry(*entry);
+    if (!unzipper.is_valid()) {
+      return 0;
+    }
+    ZPOS64_T offset = unzGetCurrentFileZStreamPos64(unzipper.get());
+    const size_t data_size = entry->is_stored ? entry->uncompressed_size
+                                              : entry->compressed_size;
+    if (offset == 0 || offset > bundle_mapping_->GetSize() ||
+        bundle_mapping_->GetSize() - offset < data_size) {
+      FXL_LOG(WARNING) << "Zip entry data is outside of the bundle.";
+      entry->is_stored = false;
+      entry->is_deflated = false;
+      *is_stored = false;
+      return 0;
+    }
+    entry->data_offset = offset;
+  }
+
+  return entry->data_offset;
+}
+
 void ZipAssetStore::BuildStatCache() {
   TRACE_EVENT0("flutter", "ZipAssetStore::BuildStatCache");
   auto unzipper = unzipper_provider_();
@@ -102,8 +386,15 @@ void ZipAssetStore::BuildStatCache() {
       continue;
     }
 
+    // Encrypted entries need to be decrypted even when they are stored.
+    bool is_encrypted = (file_info.flag & 1) != 0;
+    bool is_stored = file_info.compression_method == 0 && !is_encrypted;
+    bool is_deflated =
+        file_info.compression_method == Z_DEFLATED && !is_encrypted;
+
     std::string file_name_key(file_name, file_info.size_filename);
-    CacheEntry entry(file_pos, file_info.uncompressed_size);
+    CacheEntry entry(file_pos, file_info.uncompressed_size,
+                     file_info.compressed_size, is_stored, is_deflated);
     stat_cache_.emplace(std::move(file_name_key), std::move(entry));
 
   } while (unzGoToNextFile(unzipper.get()) == UNZ_OK);
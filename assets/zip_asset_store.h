@@ -5,36 +5,125 @@
 #ifndef FLUTTER_ASSETS_ZIP_ASSET_STORE_H_
 #define FLUTTER_ASSETS_ZIP_ASSET_STORE_H_
 
+#include <list>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "flutter/assets/asset_resolver.h"
 #include "flutter/assets/unzipper_provider.h"
+#include "flutter/fml/mapping.h"
 #include "lib/fxl/macros.h"
-#include "lib/fxl/memory/ref_counted.h"
+#include "lib/fxl/memory/ref_ptr.h"
 #include "third_party/zlib/contrib/minizip/unzip.h"
 
 namespace blink {
 
-class ZipAssetStore : public fxl::RefCountedThreadSafe<ZipAssetStore> {
+class ZipAssetStore final : public AssetResolver {
  public:
   explicit ZipAssetStore(UnzipperProvider unzipper_provider);
-  ~ZipAssetStore();
 
-  bool GetAsBuffer(const std::string& asset_name, std::vector<uint8_t>* data);
+  // Maps the bundle at zip_path so that GetAsMapping can return entries
+  // stored without compression without copying them.
+  explicit ZipAssetStore(const std::string& zip_path);
+
+  ~ZipAssetStore() override;
+
+  // Returns the store of the bundle at zip_path, creating it if there is none
+  // or the file changed since it was created. Sharing the store avoids
+  // scanning the central directory of the bundle again.
+  static fxl::RefPtr<ZipAssetStore> GetShared(const std::string& zip_path);
+
+  // |blink::AssetResolver|
+  bool IsValid() const override;
+
+  // |blink::AssetResolver|
+  bool GetAsBuffer(const std::string& asset_name,
+                   std::vector<uint8_t>* data) override;
+
+  // |blink::AssetResolver|
+  // Uncompressed entries of a mapped bundle point into the bundle mapping,
+  // which the returned mapping keeps alive. Other entries are inflated into a
+  // buffer that the returned mapping shares with the inflated asset cache.
+  std::unique_ptr<fml::Mapping> GetAsMapping(
+      const std::string& asset_name) override;
+
+  // Keeps up to max_bytes of recently read compressed assets inflated, so
+  // that reading them again does not inflate them again. Evicts the least
+  // recently used assets beyond the new budget. Defaults to zero, which
+  // disables the cache.
+  void SetInflatedCacheMaxBytes(size_t max_bytes);
+
+  // The bytes held by the inflated asset caches of all stores in the process.
+  static size_t GetTotalInflatedCacheBytes();
 
  private:
   struct CacheEntry {
     unz_file_pos file_pos;
     size_t uncompressed_size;
-    CacheEntry(unz_file_pos p_file_pos, size_t p_uncompressed_size)
-        : file_pos(p_file_pos), uncompressed_size(p_uncompressed_size) {}
+    size_t compressed_size;
+    // Whether the data is the contents or a raw deflate stream of them. Both
+    // are cleared if the data turns out not to be within the bundle. Guarded
+    // by data_offset_mutex_.
+    bool is_stored;
+    bool is_deflated;
+    // The offset of the data of the entry in the bundle, or zero until it is
+    // first read from the bundle mapping. Guarded by data_offset_mutex_.
+    size_t data_offset = 0;
+    CacheEntry(unz_file_pos p_file_pos,
+               size_t p_uncompressed_size,
+               size_t p_compressed_size,
+               bool p_is_stored,
+               bool p_is_deflated)
+        : file_pos(p_file_pos),
+          uncompressed_size(p_uncompressed_size),
+          compressed_size(p_compressed_size),
+          is_stored(p_is_stored),
+          is_deflated(p_is_deflated) {}
   };
 
   UnzipperProvider unzipper_provider_;
+  std::shared_ptr<fml::Mapping> bundle_mapping_;
   std::map<std::string, CacheEntry> stat_cache_;
+  std::mutex data_offset_mutex_;
+
+  using InflatedAsset = std::shared_ptr<const std::vector<uint8_t>>;
+  // Most recently used first.
+  using InflatedAssetList = std::list<std::pair<std::string, InflatedAsset>>;
+  std::mutex inflated_cache_mutex_;
+  size_t inflated_cache_max_bytes_ = 0;
+  size_t inflated_cache_bytes_ = 0;
+  InflatedAssetList inflated_assets_;
+  std::unordered_map<std::string, InflatedAssetList::iterator>
+      inflated_asset_index_;
 
   void BuildStatCache();
 
+  // Reads the uncompressed contents of the entry. Entries in a mapped bundle
+  // are copied or inflated straight from the mapping. Others are read through
+  // a new unzipper.
+  bool ReadEntry(CacheEntry* entry, std::vector<uint8_t>* data);
+
+  // Returns the contents of the entry from the inflated asset cache, reading
+  // and adding them on a miss. Returns null if the entry can not be read.
+  InflatedAsset GetInflatedAsset(const std::string& asset_name,
+                                 CacheEntry* entry);
+
+  bool IsInflatedCacheEnabled();
+
+  void EvictInflatedAssetsLocked();
+
+  // Positions an unzipper at the entry and opens it for reading.
+  zip::UniqueUnzipper OpenEntry(const CacheEntry& entry);
+
+  // Returns the offset of the data of a stored or deflated entry in
+  // bundle_mapping_, or zero if it can not be read from the mapping. Sets
+  // is_stored to whether the data is the contents of the entry.
+  size_t GetDataOffset(CacheEntry* entry, bool* is_stored);
+
   FXL_DISALLOW_COPY_AND_ASSIGN(ZipAssetStore);
 };
 
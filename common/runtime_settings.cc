@@ -0,0 +1,58 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/common/runtime_settings.h"
+
+#include <mutex>
+#include <sstream>
+
+#include "flutter/common/settings.h"
+
+namespace blink {
+namespace {
+
+std::mutex g_mutex;
+RuntimeSettings* g_runtime_settings = nullptr;
+
+// Called with |g_mutex| held.
+RuntimeSettings& GetLocked() {
+  if (!g_runtime_settings) {
+    const Settings& settings = Settings::Get();
+    g_runtime_settings = new RuntimeSettings();
+    g_runtime_settings->raster_cache_max_bytes =
+        settings.raster_cache_max_bytes;
+    g_runtime_settings->gpu_resource_cache_max_bytes =
+        settings.gpu_resource_cache_max_bytes;
+    g_runtime_settings->enable_layer_tree_diffing =
+        settings.enable_layer_tree_diffing;
+    g_runtime_settings->throttle_idle_frames = settings.throttle_idle_frames;
+  }
+  return *g_runtime_settings;
+}
+
+}  // namespace
+
+std::string RuntimeSettings::ToJSON() const {
+  std::stringstream json;
+  json << "{\"rasterCacheThreshold\":" << raster_cache_threshold;
+  json << ",\"rasterCacheMaxBytes\":" << raster_cache_max_bytes;
+  json << ",\"gpuResourceCacheMaxBytes\":" << gpu_resource_cache_max_bytes;
+  json << ",\"layerTreeDiffing\":"
+       << (enable_layer_tree_diffing ? "true" : "false");
+  json << ",\"throttleIdleFrames\":"
+       << (throttle_idle_frames ? "true" : "false") << "}";
+  return json.str();
+}
+
+RuntimeSettings RuntimeSettings::Get() {
+  std::lock_guard<std::mutex> lock(g_mutex);
+  return GetLocked();
+}
+
+void RuntimeSettings::Set(const RuntimeSettings& settings) {
+  std::lock_guard<std::mutex> lock(g_mutex);
+  GetLocked() = settings;
+}
+
+}  // namespace blink
@@ -0,0 +1,44 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_COMMON_RUNTIME_SETTINGS_H_
+#define FLUTTER_COMMON_RUNTIME_SETTINGS_H_
+
+#include <stddef.h>
+
+#include <string>
+
+namespace blink {
+
+// The settings that may be changed while the engine runs, through the
+// _flutter.setRuntimeSettings service protocol extension and the
+// flutter/runtimesettings channel. Start out with the values of |Settings|.
+// May be accessed on any thread.
+struct RuntimeSettings {
+  // The consecutive frames a picture is drawn in before it is rasterized into
+  // the raster cache. Zero disables caching.
+  size_t raster_cache_threshold = 3;
+  // See |Settings::raster_cache_max_bytes|.
+  size_t raster_cache_max_bytes = 0;
+  // See |Settings::gpu_resource_cache_max_bytes|.
+  size_t gpu_resource_cache_max_bytes = 0;
+  // See |Settings::enable_layer_tree_diffing|.
+  bool enable_layer_tree_diffing = false;
+  // See |Settings::throttle_idle_frames|.
+  bool throttle_idle_frames = false;
+
+  // Returns a JSON object with the settings, keyed by the names the service
+  // protocol and the channel take them by.
+  std::string ToJSON() const;
+
+  static RuntimeSettings Get();
+  // Replaces the current settings. Only engine components created afterwards
+  // pick them up; |shell::Shell::UpdateRuntimeSettings| also applies them to
+  // the running ones.
+  static void Set(const RuntimeSettings& settings);
+};
+
+}  // namespace blink
+
+#endif  // FLUTTER_COMMON_RUNTIME_SETTINGS_H_
@@ -5,6 +5,7 @@
 #ifndef FLUTTER_COMMON_SETTINGS_H_
 #define FLUTTER_COMMON_SETTINGS_H_
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include <string>
@@ -21,18 +22,163 @@ struct Settings {
   uint32_t diagnostic_port = 0;
   bool ipv6 = false;
   bool start_paused = false;
+  // Hold back the start of the service isolate until the first frame has
+  // been rendered, so that it does not compete with the root isolate for the
+  // CPU during startup.
+  bool lazy_service_isolate = false;
   bool trace_startup = false;
   bool endless_trace_buffer = false;
+  // Keep the most recent trace events of each thread in memory, independently
+  // of the Dart timeline, and write them out along with slow frames.
+  bool enable_trace_recorder = false;
+  // The Skia trace categories that are passed on when Skia tracing is
+  // enabled. Empty passes on all of them.
+  std::vector<std::string> skia_trace_categories;
+  // Pass on the Skia trace events of every Nth frame only. Zero and one pass
+  // on those of every frame.
+  uint32_t skia_trace_frame_interval = 0;
   bool enable_dart_profiling = false;
+  // Read the kernel program of a bundle once and load the secondary isolates
+  // spawned from the bundle from it instead of reading the kernel for each.
+  bool share_isolate_program = false;
+  // The number of secondary isolates the root isolate keeps created ahead of
+  // time for |Isolate.spawn|. Zero creates them as they are spawned.
+  size_t isolate_pool_size = 0;
   bool use_test_fonts = false;
   bool dart_non_checked_mode = false;
   bool enable_software_rendering = false;
+  // With software rendering, record each frame and play it back in tiles
+  // concurrently on the worker threads.
+  bool enable_tiled_software_rendering = false;
   bool using_blink = true;
+  // The number of bytes of rasterized pictures the raster cache may retain
+  // across frames. Zero evicts entries as soon as they go unused for a frame.
+  size_t raster_cache_max_bytes = 0;
+  // Rasterize pictures admitted into the raster cache after the frame has been
+  // presented instead of during the preroll of the frame that admitted them.
+  bool raster_cache_deferred_population = false;
+  // Rasterize deferred raster cache entries on the worker threads. Implies
+  // |raster_cache_deferred_population|.
+  bool raster_cache_concurrent_population = false;
+  // Rasterize opaque pictures into 565 raster cache entries where the
+  // destination has no color space.
+  bool raster_cache_rgb565 = false;
+  // Rasterize raster cache entries at this many scales per power of two, so
+  // that zooming reuses entries. Zero rasterizes them at the exact scale.
+  size_t raster_cache_scale_buckets_per_octave = 0;
+  // Compare each layer tree with the previously rasterized one and skip
+  // frames that would not change what is on screen.
+  bool enable_layer_tree_diffing = false;
+  // The number of layer trees the UI thread may produce ahead of the GPU
+  // thread. Larger depths absorb GPU stalls at the cost of latency.
+  uint32_t layer_tree_pipeline_depth = 2;
+  // Delay the start of each frame after vsync based on how long recent frames
+  // took to build and rasterize to reduce input latency.
+  bool enable_frame_pacing = false;
+  // Begin frames only every few vsyncs while the frames requested in a row
+  // rendered nothing, such as those of a ticker whose animation is done.
+  bool throttle_idle_frames = false;
+  // Begin frames only on every this many vsyncs, capping the frame rate to a
+  // fraction of the display rate to save power. The platform and the app may
+  // change the cap with the flutter/framerate channel.
+  uint32_t frame_rate_divisor = 1;
+  // The platform channels whose messages are parsed as JSON on the IO thread
+  // and handed to Dart already decoded, once Dart listens for them.
+  std::vector<std::string> json_platform_message_channels;
+  // Hand pointer moves and hovers to Dart once per frame instead of as they
+  // arrive.
+  bool enable_pointer_coalescing = false;
+  // Replace the coalesced moves of each pointer with a single move at the
+  // frame time. Implies |enable_pointer_coalescing|.
+  bool enable_pointer_resampling = false;
+  // The number of bytes of GPU resources Skia may keep cached for the
+  // rasterizer's context.
+  size_t gpu_resource_cache_max_bytes = 512 << 20;
+  // The number of bytes of GPU resources Skia may keep cached for the IO
+  // thread's resource context. Zero frees textures created by the image
+  // decoders as soon as no image references them.
+  size_t resource_context_cache_max_bytes = 0;
+  // Decode large images into buffers the GPU samples from directly, where the
+  // platform supports it.
+  bool enable_hardware_image_buffers = true;
+  // The number of bytes of decoded images that may be uploaded to the GPU per
+  // frame interval. Zero uploads images as soon as they are decoded.
+  size_t image_upload_max_bytes_per_frame = 0;
+  // Pack small decoded images into shared textures, so that their draws can
+  // be batched.
+  bool enable_image_atlas = false;
+  // Raise the scheduling priority of the UI and GPU threads and lower that of
+  // the IO thread.
+  bool enable_thread_priorities = true;
+  // Run the GPU tasks on the UI thread and rasterize each frame as soon as it
+  // is rendered, for devices where one fast core beats two slow ones. Ignored
+  // when the embedder provides the GPU task runner.
+  bool merge_ui_and_gpu_threads = false;
+  // Break and shape the newline-delimited blocks of long paragraphs on the
+  // worker threads.
+  bool concurrent_text_layout = false;
+  // The number of shaped words kept by the text layout cache. Zero keeps all
+  // of them.
+  size_t text_layout_cache_max_entries = 5000;
+  // The number of fonts kept ready for shaping by the text layout cache. Zero
+  // keeps all of them.
+  size_t text_font_cache_max_entries = 100;
+  // Keep the shaped words in a file in the temporary directory so that later
+  // launches do not shape the same text again.
+  bool persistent_text_layout_cache = false;
+  // The directory of the hyph-<locale>.hyb hyphenation pattern files. When
+  // set, paragraphs are hyphenated in the locale of the window, loading the
+  // patterns of each locale the first time it is used. Empty disables
+  // hyphenation.
+  std::string hyphenation_patterns_path;
+  // Keep the programs and pipelines compiled for the GPU in files in the
+  // temporary directory so that later launches do not compile them again.
+  bool persistent_gpu_cache = false;
+  // Present Vulkan swapchain images in mailbox mode where it is supported, so
+  // that acquiring an image does not wait for the previous one to display.
+  bool enable_vulkan_mailbox_present_mode = false;
+  // Render with Metal instead of OpenGL ES on iOS devices that support it.
+  // Only available in builds with shell_enable_metal.
+  bool enable_metal = false;
+  // Measure how long the GPU spends on each frame with timer queries and show
+  // it in the performance overlay and the traces.
+  bool enable_gpu_timer_queries = false;
+  // On GL surfaces without sRGB support, render straight to the onscreen
+  // framebuffer without color management instead of into an sRGB offscreen
+  // surface that is copied onscreen every frame.
+  bool enable_legacy_color_rendering = false;
+  // Lower the scale at which frames are rendered, down to this one, while
+  // frames miss their budget, on surfaces that support scaling. One renders
+  // at full scale always.
+  double dynamic_resolution_min_scale = 1.0;
+  // Aggregate statistics of the presented frames over intervals of this many
+  // seconds and hand them to the platform view. Zero aggregates none.
+  uint32_t frame_statistics_interval_seconds = 0;
+  // Pace frames with synthetic frame times instead of the display's vsync and
+  // record the build and raster times of each frame, so that benchmarks are
+  // reproducible.
+  bool benchmark_mode = false;
+  // In benchmark mode, begin frames at this fixed cadence. Zero begins each
+  // frame as soon as the GPU thread is done with the previous ones.
+  uint32_t benchmark_frame_interval_micros = 0;
+  // The CSV file benchmark frames are recorded to. Defaults to
+  // benchmark_frames.csv in the temporary directory.
+  std::string benchmark_output_path;
+  // Pictures serialized with |shell::SerializePicture| that are drawn
+  // offscreen before the first frame, so that the shader programs they need
+  // are compiled ahead of the frames that first need them.
+  std::vector<std::string> shader_warmup_picture_paths;
+  // The number of bytes of inflated assets the zip bundle keeps for assets
+  // read again, such as fonts. Zero inflates them on every read.
+  size_t asset_cache_max_bytes = 0;
   std::string aot_snapshot_path;
   std::string aot_vm_snapshot_data_filename;
   std::string aot_vm_snapshot_instr_filename;
   std::string aot_isolate_snapshot_data_filename;
   std::string aot_isolate_snapshot_instr_filename;
+  // Where to write the pages of the isolate instructions snapshot that are
+  // resident once the first frame has been rendered. Empty to not record.
+  std::string snapshot_page_profile_path;
   std::string application_library_path;
   std::string temp_directory_path;
   std::vector<std::string> dart_flags;
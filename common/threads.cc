@@ -18,11 +18,13 @@ Threads::Threads() {}
 Threads::Threads(fxl::RefPtr<fxl::TaskRunner> platform,
                  fxl::RefPtr<fxl::TaskRunner> gpu,
                  fxl::RefPtr<fxl::TaskRunner> ui,
-                 fxl::RefPtr<fxl::TaskRunner> io)
+                 fxl::RefPtr<fxl::TaskRunner> io,
+                 fxl::RefPtr<fxl::TaskRunner> worker)
     : platform_(std::move(platform)),
       gpu_(std::move(gpu)),
       ui_(std::move(ui)),
-      io_(std::move(io)) {}
+      io_(std::move(io)),
+      worker_(std::move(worker)) {}
 
 Threads::~Threads() {}
 
@@ -42,6 +44,10 @@ const fxl::RefPtr<fxl::TaskRunner>& Threads::IO() {
   return Get().io_;
 }
 
+const fxl::RefPtr<fxl::TaskRunner>& Threads::Worker() {
+  return Get().worker_;
+}
+
 const Threads& Threads::Get() {
   FXL_CHECK(g_threads);
   return *g_threads;
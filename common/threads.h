@@ -24,7 +24,8 @@ class Threads {
   Threads(fxl::RefPtr<fxl::TaskRunner> platform,
           fxl::RefPtr<fxl::TaskRunner> gpu,
           fxl::RefPtr<fxl::TaskRunner> ui,
-          fxl::RefPtr<fxl::TaskRunner> io);
+          fxl::RefPtr<fxl::TaskRunner> io,
+          fxl::RefPtr<fxl::TaskRunner> worker = nullptr);
   ~Threads();
 
   static const fxl::RefPtr<fxl::TaskRunner>& Platform();
@@ -32,6 +33,10 @@ class Threads {
   static const fxl::RefPtr<fxl::TaskRunner>& UI();
   static const fxl::RefPtr<fxl::TaskRunner>& IO();
 
+  // Tasks posted to the worker runner may run concurrently with each other.
+  // May be null if the embedder does not provide workers.
+  static const fxl::RefPtr<fxl::TaskRunner>& Worker();
+
   static void Set(const Threads& settings);
 
  private:
@@ -41,6 +46,7 @@ class Threads {
   fxl::RefPtr<fxl::TaskRunner> gpu_;
   fxl::RefPtr<fxl::TaskRunner> ui_;
   fxl::RefPtr<fxl::TaskRunner> io_;
+  fxl::RefPtr<fxl::TaskRunner> worker_;
 };
 
 }  // namespace blink
@@ -5,6 +5,7 @@
 #include "flutter/content_handler/accessibility_bridge.h"
 
 #include <unordered_set>
+#include <utility>
 
 #include "flutter/lib/ui/semantics/semantics_node.h"
 #include "lib/app/cpp/application_context.h"
@@ -20,9 +21,10 @@ AccessibilityBridge::AccessibilityBridge(app::ApplicationContext* context)
     : writer_(context->ConnectToEnvironmentService<maxwell::ContextWriter>()) {}
 
 void AccessibilityBridge::UpdateSemantics(
-    const std::vector<blink::SemanticsNode>& update) {
-  for (const auto& node : update) {
-    semantics_nodes_[node.id] = node;
+    std::vector<blink::SemanticsNode> update) {
+  for (auto& node : update) {
+    const int id = node.id;
+    semantics_nodes_[id] = std::move(node);
   }
   std::vector<int> visited_nodes;
   UpdateVisitedForNodeAndChildren(0, &visited_nodes);
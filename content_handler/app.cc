@@ -115,6 +115,7 @@ void App::WaitForPlatformViewsIdsUIThread(
     info.view_id = reinterpret_cast<uintptr_t>(controller);
     info.isolate_id = controller->GetUIIsolateMainPort();
     info.isolate_name = controller->GetUIIsolateName();
+    info.gpu_usage = controller->GetGpuUsage();
     platform_view_ids->push_back(info);
   }
   latch->Signal();
@@ -37,6 +37,9 @@ class App : public app::ApplicationRunner {
     uintptr_t view_id;
     int64_t isolate_id;
     std::string isolate_name;
+    // The time the view spent drawing on the GPU thread shared by the
+    // applications of the process.
+    DrawScheduler::Usage gpu_usage;
   };
 
   void WaitForPlatformViewIds(std::vector<PlatformViewInfo>* platform_view_ids);
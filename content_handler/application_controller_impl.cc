@@ -137,6 +137,12 @@ Dart_Port ApplicationControllerImpl::GetUIIsolateMainPort() {
   return runtime_holder_->GetUIIsolateMainPort();
 }
 
+DrawScheduler::Usage ApplicationControllerImpl::GetGpuUsage() {
+  if (!runtime_holder_)
+    return DrawScheduler::Usage();
+  return runtime_holder_->GetGpuUsage();
+}
+
 std::string ApplicationControllerImpl::GetUIIsolateName() {
   if (!runtime_holder_) {
     return "";
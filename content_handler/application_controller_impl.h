@@ -9,6 +9,7 @@
 
 #include <fdio/namespace.h>
 
+#include "flutter/content_handler/draw_scheduler.h"
 #include "lib/app/fidl/application_controller.fidl.h"
 #include "lib/app/fidl/application_runner.fidl.h"
 #include "lib/app/fidl/service_provider.fidl.h"
@@ -49,6 +50,7 @@ class ApplicationControllerImpl : public app::ApplicationController,
 
   Dart_Port GetUIIsolateMainPort();
   std::string GetUIIsolateName();
+  DrawScheduler::Usage GetGpuUsage();
 
  private:
   void StartRuntimeIfReady();
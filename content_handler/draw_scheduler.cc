@@ -0,0 +1,76 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/content_handler/draw_scheduler.h"
+
+#include <utility>
+
+#include "flutter/common/threads.h"
+#include "flutter/glue/trace_event.h"
+
+namespace flutter_runner {
+
+DrawScheduler& DrawScheduler::Get() {
+  static DrawScheduler* scheduler = new DrawScheduler();
+  return *scheduler;
+}
+
+DrawScheduler::DrawScheduler() = default;
+
+DrawScheduler::~DrawScheduler() = default;
+
+void DrawScheduler::PostDraw(const void* client,
+                             fxl::TimePoint deadline,
+                             fxl::Closure draw) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_draws_.emplace(DrawKey(deadline, next_sequence_number_++),
+                           PendingDraw{client, std::move(draw)});
+  }
+  blink::Threads::Gpu()->PostTask([this]() { RunNextDraw(); });
+}
+
+void DrawScheduler::RemoveClient(const void* client) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto it = pending_draws_.begin(); it != pending_draws_.end();) {
+    if (it->second.client == client) {
+      it = pending_draws_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  usage_.erase(client);
+}
+
+DrawScheduler::Usage DrawScheduler::GetUsage(const void* client) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto found = usage_.find(client);
+  return found != usage_.end() ? found->second : Usage();
+}
+
+void DrawScheduler::RunNextDraw() {
+  ASSERT_IS_GPU_THREAD;
+  TRACE_EVENT0("flutter", "DrawScheduler::RunNextDraw");
+  PendingDraw next;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Draws of removed clients leave their tasks without a draw.
+    if (pending_draws_.empty())
+      return;
+    auto first = pending_draws_.begin();
+    next = std::move(first->second);
+    pending_draws_.erase(first);
+  }
+
+  const fxl::TimePoint start = fxl::TimePoint::Now();
+  next.draw();
+  const fxl::TimeDelta duration = fxl::TimePoint::Now() - start;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  Usage& usage = usage_[next.client];
+  usage.gpu_time = usage.gpu_time + duration;
+  usage.draw_count++;
+}
+
+}  // namespace flutter_runner
@@ -0,0 +1,72 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_CONTENT_HANDLER_DRAW_SCHEDULER_H_
+#define FLUTTER_CONTENT_HANDLER_DRAW_SCHEDULER_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+#include "lib/fxl/functional/closure.h"
+#include "lib/fxl/macros.h"
+#include "lib/fxl/time/time_delta.h"
+#include "lib/fxl/time/time_point.h"
+
+namespace flutter_runner {
+
+// Orders the draws of the applications of the process on the GPU thread they
+// share. Rather than in the order they were posted, pending draws run in the
+// order of the deadlines of their frames, so that an application whose frames
+// take long to rasterize does not push back the frames of the others. Also
+// keeps the time each application spent drawing.
+class DrawScheduler {
+ public:
+  // The GPU time an application has used so far.
+  struct Usage {
+    fxl::TimeDelta gpu_time;
+    int64_t draw_count = 0;
+  };
+
+  static DrawScheduler& Get();
+
+  // Posts |draw| to run on the GPU thread on behalf of |client|. Draws that
+  // are pending at the same time run by earliest |deadline|.
+  void PostDraw(const void* client, fxl::TimePoint deadline, fxl::Closure draw);
+
+  // Drops the pending draws and the usage of |client|. A draw of |client|
+  // that is running already completes.
+  void RemoveClient(const void* client);
+
+  Usage GetUsage(const void* client);
+
+ private:
+  struct PendingDraw {
+    const void* client = nullptr;
+    fxl::Closure draw;
+  };
+
+  // Keyed by deadline and then by the order of posting.
+  using DrawKey = std::pair<fxl::TimePoint, int64_t>;
+
+  std::mutex mutex_;
+  std::map<DrawKey, PendingDraw> pending_draws_;
+  int64_t next_sequence_number_ = 0;
+  std::unordered_map<const void*, Usage> usage_;
+
+  DrawScheduler();
+  ~DrawScheduler();
+
+  // Runs the pending draw with the earliest deadline. One of these tasks is
+  // posted for every draw.
+  void RunNextDraw();
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(DrawScheduler);
+};
+
+}  // namespace flutter_runner
+
+#endif  // FLUTTER_CONTENT_HANDLER_DRAW_SCHEDULER_H_
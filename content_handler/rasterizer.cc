@@ -7,6 +7,23 @@
 
 namespace flutter_runner {
 
+fxl::TimePoint Rasterizer::PresentationInfo::GetNextPresentationTime(
+    fxl::TimePoint time) const {
+  if (presentation_interval <= fxl::TimeDelta::Zero() ||
+      presentation_time == fxl::TimePoint()) {
+    return time;
+  }
+  if (time < presentation_time) {
+    return presentation_time;
+  }
+  const int64_t intervals_elapsed =
+      (time - presentation_time).ToNanoseconds() /
+      presentation_interval.ToNanoseconds();
+  return presentation_time +
+         fxl::TimeDelta::FromNanoseconds(
+             presentation_interval.ToNanoseconds() * (intervals_elapsed + 1));
+}
+
 Rasterizer::~Rasterizer() = default;
 
 std::unique_ptr<Rasterizer> Rasterizer::Create() {
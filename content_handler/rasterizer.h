@@ -5,11 +5,14 @@
 #ifndef FLUTTER_CONTENT_HANDLER_RASTERIZER_H_
 #define FLUTTER_CONTENT_HANDLER_RASTERIZER_H_
 
+#include <functional>
 #include <memory>
 
 #include "flutter/flow/layers/layer_tree.h"
 #include "lib/fxl/functional/closure.h"
 #include "lib/fxl/macros.h"
+#include "lib/fxl/time/time_delta.h"
+#include "lib/fxl/time/time_point.h"
 #include "lib/ui/scenic/fidl/session.fidl.h"
 #include "zircon/system/ulib/zx/include/zx/eventpair.h"
 
@@ -17,6 +20,19 @@ namespace flutter_runner {
 
 class Rasterizer {
  public:
+  // When the compositor last showed a frame and how often it shows them, as
+  // reported by Scenic. Both are zero until a frame has been shown.
+  struct PresentationInfo {
+    fxl::TimePoint presentation_time;
+    fxl::TimeDelta presentation_interval;
+
+    // The first time the compositor is expected to show a frame after |time|,
+    // or |time| itself while the cadence is unknown.
+    fxl::TimePoint GetNextPresentationTime(fxl::TimePoint time) const;
+  };
+
+  using DrawCallback = std::function<void(const PresentationInfo&)>;
+
   virtual ~Rasterizer();
 
   static std::unique_ptr<Rasterizer> Create();
@@ -26,8 +42,10 @@ class Rasterizer {
       zx::eventpair import_token,
       fxl::Closure metrics_changed_callback) = 0;
 
+  // |callback| is invoked once the frame was shown, with the presentation
+  // info Scenic reported for it, or once it was dropped, with none.
   virtual void Draw(std::unique_ptr<flow::LayerTree> layer_tree,
-                    fxl::Closure callback) = 0;
+                    DrawCallback callback) = 0;
 };
 
 }  // namespace flutter_runner
@@ -7,12 +7,14 @@
 #include <dlfcn.h>
 #include <fdio/namespace.h>
 #include <zircon/dlfcn.h>
+#include <algorithm>
 #include <utility>
 
 #include "dart-pkg/zircon/sdk_ext/handle.h"
 #include "flutter/assets/zip_asset_store.h"
 #include "flutter/common/threads.h"
 #include "flutter/content_handler/accessibility_bridge.h"
+#include "flutter/content_handler/draw_scheduler.h"
 #include "flutter/content_handler/rasterizer.h"
 #include "flutter/content_handler/service_protocol_hooks.h"
 #include "flutter/lib/snapshot/snapshot.h"
@@ -86,6 +88,65 @@ blink::PointerData::DeviceKind GetKindFromPointerType(
   }
 }
 
+bool IsUtf8Continuation(char byte) {
+  return (static_cast<uint8_t>(byte) & 0xC0) == 0x80;
+}
+
+// The number of UTF-16 code units in the first |length| bytes of the UTF-8
+// |text|, which is how the framework indexes strings.
+int GetUtf16Length(const std::string& text, size_t length) {
+  int units = 0;
+  for (size_t i = 0; i < length; i++) {
+    if (IsUtf8Continuation(text[i]))
+      continue;
+    // Code points of four bytes are surrogate pairs.
+    units += static_cast<uint8_t>(text[i]) >= 0xF0 ? 2 : 1;
+  }
+  return units;
+}
+
+// Adds the range of |old_text| that was replaced and the text that replaced
+// it to |encoded_state|. Only the code points between the common prefix and
+// suffix of the old and new text are sent, so a keystroke in a long document
+// sends one character.
+void AddTextDelta(const std::string& old_text,
+                  const std::string& new_text,
+                  rapidjson::Value* encoded_state,
+                  rapidjson::Document::AllocatorType& allocator) {
+  const size_t limit = std::min(old_text.size(), new_text.size());
+  size_t prefix = 0;
+  while (prefix < limit && old_text[prefix] == new_text[prefix])
+    prefix++;
+  // Never split a code point.
+  while (prefix > 0 && ((prefix < old_text.size() &&
+                         IsUtf8Continuation(old_text[prefix])) ||
+                        (prefix < new_text.size() &&
+                         IsUtf8Continuation(new_text[prefix])))) {
+    prefix--;
+  }
+  size_t suffix = 0;
+  while (suffix < old_text.size() - prefix &&
+         suffix < new_text.size() - prefix &&
+         old_text[old_text.size() - 1 - suffix] ==
+             new_text[new_text.size() - 1 - suffix]) {
+    suffix++;
+  }
+  while (suffix > 0 && IsUtf8Continuation(old_text[old_text.size() - suffix]))
+    suffix--;
+
+  const size_t old_end = old_text.size() - suffix;
+  const size_t new_end = new_text.size() - suffix;
+  encoded_state->AddMember("deltaStart", GetUtf16Length(old_text, prefix),
+                           allocator);
+  encoded_state->AddMember("deltaEnd", GetUtf16Length(old_text, old_end),
+                           allocator);
+  rapidjson::Value delta_text;
+  delta_text.SetString(new_text.data() + prefix,
+                       static_cast<rapidjson::SizeType>(new_end - prefix),
+                       allocator);
+  encoded_state->AddMember("deltaText", delta_text, allocator);
+}
+
 }  // namespace
 
 RuntimeHolder::RuntimeHolder()
@@ -95,6 +156,8 @@ RuntimeHolder::RuntimeHolder()
       weak_factory_(this) {}
 
 RuntimeHolder::~RuntimeHolder() {
+  // Pending draws refer to the rasterizer.
+  DrawScheduler::Get().RemoveClient(this);
   blink::Threads::Gpu()->PostTask(
       fxl::MakeCopyable([rasterizer = std::move(rasterizer_)](){
           // Deletes rasterizer.
@@ -266,10 +329,8 @@ void RuntimeHolder::CreateView(
     isolate_snapshot_instr = reinterpret_cast<const uint8_t*>(
         dlsym(dylib_handle_, "_kDartIsolateSnapshotInstructions"));
   }
-  std::vector<uint8_t> empty_platform_kernel;
   runtime_->CreateDartController(script_uri, isolate_snapshot_data,
-                                 isolate_snapshot_instr,
-                                 std::move(empty_platform_kernel));
+                                 isolate_snapshot_instr, nullptr);
 
   runtime_->SetViewportMetrics(viewport_metrics_);
 
@@ -286,6 +347,10 @@ void RuntimeHolder::CreateView(
       [this](int32_t return_code) { return_code_ = return_code; });
 }
 
+DrawScheduler::Usage RuntimeHolder::GetGpuUsage() {
+  return DrawScheduler::Get().GetUsage(this);
+}
+
 Dart_Port RuntimeHolder::GetUIIsolateMainPort() {
   if (!runtime_)
     return ILLEGAL_PORT;
@@ -328,25 +393,31 @@ void RuntimeHolder::Render(std::unique_ptr<flow::LayerTree> layer_tree) {
                                            viewport_metrics_.physical_height));
   layer_tree->set_device_pixel_ratio(viewport_metrics_.device_pixel_ratio);
 
-  // We are on the Platform/UI thread. Post to the GPU thread to render.
+  // We are on the Platform/UI thread. Post to the GPU thread to render. The
+  // GPU thread is shared with the other applications of the process, so the
+  // draw is ordered among theirs by when the frame is to be shown.
   ASSERT_IS_PLATFORM_THREAD;
-  blink::Threads::Gpu()->PostTask(fxl::MakeCopyable([
+  const fxl::TimePoint deadline =
+      presentation_info_.GetNextPresentationTime(last_begin_frame_time_);
+  DrawScheduler::Get().PostDraw(this, deadline, fxl::MakeCopyable([
     rasterizer = rasterizer_.get(),      //
     layer_tree = std::move(layer_tree),  //
     weak_runtime_holder = GetWeakPtr()   //
   ]() mutable {
     // On the GPU Thread.
     ASSERT_IS_GPU_THREAD;
-    rasterizer->Draw(std::move(layer_tree), [weak_runtime_holder]() {
+    rasterizer->Draw(std::move(layer_tree), [weak_runtime_holder](
+        const Rasterizer::PresentationInfo& presentation_info) {
       // This is on the GPU thread thread. Post to the Platform/UI thread
       // for the completion callback.
       ASSERT_IS_GPU_THREAD;
-      blink::Threads::Platform()->PostTask([weak_runtime_holder]() {
+      blink::Threads::Platform()->PostTask([weak_runtime_holder,
+                                            presentation_info]() {
         // On the Platform/UI thread.
         ASSERT_IS_UI_THREAD;
         if (weak_runtime_holder) {
           weak_runtime_holder->frame_rendering_ = false;
-          weak_runtime_holder->OnFrameComplete();
+          weak_runtime_holder->OnFrameComplete(presentation_info);
         }
       });
     });
@@ -354,7 +425,7 @@ void RuntimeHolder::Render(std::unique_ptr<flow::LayerTree> layer_tree) {
 }
 
 void RuntimeHolder::UpdateSemantics(std::vector<blink::SemanticsNode> update) {
-  accessibility_bridge_->UpdateSemantics(update);
+  accessibility_bridge_->UpdateSemantics(std::move(update));
 }
 
 void RuntimeHolder::HandlePlatformMessage(
@@ -441,9 +512,8 @@ bool RuntimeHolder::HandleAssetPlatformMessage(
   fxl::RefPtr<blink::PlatformMessageResponse> response = message->response();
   if (!response)
     return false;
-  const auto& data = message->data();
-  std::string asset_name(reinterpret_cast<const char*>(data.data()),
-                         data.size());
+  std::string asset_name(reinterpret_cast<const char*>(message->data()),
+                         message->size());
   std::vector<uint8_t> asset_data;
   if (asset_store_ && asset_store_->GetAsBuffer(asset_name, &asset_data)) {
     response->Complete(std::move(asset_data));
@@ -455,10 +525,9 @@ bool RuntimeHolder::HandleAssetPlatformMessage(
 
 bool RuntimeHolder::HandleTextInputPlatformMessage(
     blink::PlatformMessage* message) {
-  const auto& data = message->data();
-
   rapidjson::Document document;
-  document.Parse(reinterpret_cast<const char*>(data.data()), data.size());
+  document.Parse(reinterpret_cast<const char*>(message->data()),
+                 message->size());
   if (document.HasParseError() || !document.IsObject())
     return false;
   auto root = document.GetObject();
@@ -489,6 +558,11 @@ bool RuntimeHolder::HandleTextInputPlatformMessage(
       return false;
     // TODO(abarth): Read the keyboard type form the configuration.
     current_text_input_client_ = args->value[0].GetInt();
+    auto enable_deltas = configuration.FindMember("enableDeltaModel");
+    text_input_sends_deltas_ = enable_deltas != configuration.MemberEnd() &&
+                               enable_deltas->value.IsBool() &&
+                               enable_deltas->value.GetBool();
+    last_text_input_text_.clear();
     mozart::TextInputStatePtr state = mozart::TextInputState::New();
     state->text = std::string();
     state->selection = mozart::TextSelection::New();
@@ -508,8 +582,10 @@ bool RuntimeHolder::HandleTextInputPlatformMessage(
       state->composing = mozart::TextRange::New();
       // TODO(abarth): Deserialize state.
       auto text = args.FindMember("text");
-      if (text != args.MemberEnd() && text->value.IsString())
+      if (text != args.MemberEnd() && text->value.IsString()) {
         state->text = text->value.GetString();
+        last_text_input_text_ = text->value.GetString();
+      }
       auto selection_base = args.FindMember("selectionBase");
       if (selection_base != args.MemberEnd() && selection_base->value.IsInt())
         state->selection->base = selection_base->value.GetInt();
@@ -675,7 +751,13 @@ void RuntimeHolder::DidUpdateState(mozart::TextInputStatePtr state,
   auto& allocator = document.GetAllocator();
 
   rapidjson::Value encoded_state(rapidjson::kObjectType);
-  encoded_state.AddMember("text", state->text.get(), allocator);
+  if (text_input_sends_deltas_) {
+    const std::string& text = state->text.get();
+    AddTextDelta(last_text_input_text_, text, &encoded_state, allocator);
+    last_text_input_text_ = text;
+  } else {
+    encoded_state.AddMember("text", state->text.get(), allocator);
+  }
   encoded_state.AddMember("selectionBase", state->selection->base, allocator);
   encoded_state.AddMember("selectionExtent", state->selection->extent,
                           allocator);
@@ -700,9 +782,13 @@ void RuntimeHolder::DidUpdateState(mozart::TextInputStatePtr state,
   args.PushBack(encoded_state, allocator);
 
   document.SetObject();
-  document.AddMember("method",
-                     rapidjson::Value("TextInputClient.updateEditingState"),
-                     allocator);
+  document.AddMember(
+      "method",
+      rapidjson::Value(rapidjson::StringRef(
+          text_input_sends_deltas_
+              ? "TextInputClient.updateEditingStateWithDeltas"
+              : "TextInputClient.updateEditingState")),
+      allocator);
   document.AddMember("args", args, allocator);
 
   rapidjson::StringBuffer buffer;
@@ -761,12 +847,19 @@ void RuntimeHolder::BeginFrame() {
   frame_scheduled_ = false;
   frame_outstanding_ = true;
   last_begin_frame_time_ = fxl::TimePoint::Now();
-  runtime_->BeginFrame(last_begin_frame_time_);
+  // Animations advance to when the frame is expected to be shown, so that
+  // consecutive frames are a whole number of presentation intervals apart.
+  runtime_->BeginFrame(
+      presentation_info_.GetNextPresentationTime(last_begin_frame_time_));
 }
 
-void RuntimeHolder::OnFrameComplete() {
+void RuntimeHolder::OnFrameComplete(
+    const Rasterizer::PresentationInfo& presentation_info) {
   ASSERT_IS_UI_THREAD
   FXL_DCHECK(frame_outstanding_);
+  // Dropped frames report no presentation info.
+  if (presentation_info.presentation_time != fxl::TimePoint())
+    presentation_info_ = presentation_info;
   frame_outstanding_ = false;
   if (frame_scheduled_)
     PostBeginFrame();
@@ -8,12 +8,15 @@
 #include <fdio/namespace.h>
 #include <zx/channel.h>
 
+#include <string>
 #include <unordered_set>
 
 #include "dart-pkg/fuchsia/sdk_ext/fuchsia.h"
 #include "flutter/assets/unzipper_provider.h"
 #include "flutter/assets/zip_asset_store.h"
 #include "flutter/content_handler/accessibility_bridge.h"
+#include "flutter/content_handler/draw_scheduler.h"
+#include "flutter/content_handler/rasterizer.h"
 #include "flutter/flow/layers/layer_tree.h"
 #include "flutter/lib/ui/window/viewport_metrics.h"
 #include "flutter/runtime/runtime_controller.h"
@@ -32,8 +35,6 @@
 
 namespace flutter_runner {
 
-class Rasterizer;
-
 class RuntimeHolder : public blink::RuntimeDelegate,
                       public mozart::NativesDelegate,
                       public mozart::ViewListener,
@@ -53,6 +54,7 @@ class RuntimeHolder : public blink::RuntimeDelegate,
 
   Dart_Port GetUIIsolateMainPort();
   std::string GetUIIsolateName();
+  DrawScheduler::Usage GetGpuUsage();
 
   int32_t return_code() { return return_code_; }
 
@@ -96,7 +98,7 @@ class RuntimeHolder : public blink::RuntimeDelegate,
 
   void PostBeginFrame();
   void BeginFrame();
-  void OnFrameComplete();
+  void OnFrameComplete(const Rasterizer::PresentationInfo& presentation_info);
   void OnRedrawFrame();
   void Invalidate();
 
@@ -118,7 +120,12 @@ class RuntimeHolder : public blink::RuntimeDelegate,
   mozart::InputMethodEditorPtr input_method_editor_;
   fidl::Binding<mozart::InputMethodEditorClient> text_input_binding_;
   int current_text_input_client_ = 0;
+  // Whether the client takes edits as deltas against the text it last saw,
+  // which is |last_text_input_text_|.
+  bool text_input_sends_deltas_ = false;
+  std::string last_text_input_text_;
   fxl::TimePoint last_begin_frame_time_;
+  Rasterizer::PresentationInfo presentation_info_;
   bool frame_outstanding_ = false;
   bool frame_scheduled_ = false;
   bool frame_rendering_ = false;
@@ -29,9 +29,12 @@ static void AppendIsolateRef(std::stringstream* stream,
 static void AppendFlutterView(std::stringstream* stream,
                               uintptr_t view_id,
                               int64_t isolate_id,
-                              const std::string isolate_name) {
+                              const std::string isolate_name,
+                              const DrawScheduler::Usage& gpu_usage) {
   *stream << "{\"type\":\"FlutterView\", \"id\": \"" << kViewIdPrefx << "0x"
           << std::hex << view_id << std::dec << "\"";
+  *stream << ",\"gpuTimeMicros\":" << gpu_usage.gpu_time.ToMicroseconds()
+          << ",\"drawCount\":" << gpu_usage.draw_count;
   if (isolate_id != ILLEGAL_PORT) {
     // Append the isolate (if it exists).
     *stream << ","
@@ -80,7 +83,8 @@ bool ServiceProtocolHooks::ListViews(const char* method,
     } else {
       prefix_comma = true;
     }
-    AppendFlutterView(&response, view_id, isolate_id, isolate_name);
+    AppendFlutterView(&response, view_id, isolate_id, isolate_name,
+                      it->gpu_usage);
   }
   response << "]}";
   // Copy the response.
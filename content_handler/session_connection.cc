@@ -56,7 +56,7 @@ void SessionConnection::OnSessionEvents(fidl::Array<scenic::EventPtr> events) {
 }
 
 void SessionConnection::Present(flow::CompositorContext::ScopedFrame& frame,
-                                fxl::Closure on_present_callback) {
+                                Rasterizer::DrawCallback on_present_callback) {
   ASSERT_IS_GPU_THREAD;
   FXL_DCHECK(pending_on_present_callback_ == nullptr);
   FXL_DCHECK(on_present_callback != nullptr);
@@ -65,8 +65,13 @@ void SessionConnection::Present(flow::CompositorContext::ScopedFrame& frame,
   // Flush all session ops. Paint tasks have not yet executed but those are
   // fenced. The compositor can start processing ops while we finalize paint
   // tasks.
-  session_.Present(0,                 // presentation_time. Placeholder for now.
-                   present_callback_  // callback
+  // Scenic does not show the frame before the requested time, so targeting
+  // the next vsync keeps frames from piling up behind the compositor.
+  const fxl::TimePoint presentation_time =
+      presentation_info_.GetNextPresentationTime(fxl::TimePoint::Now());
+  session_.Present(
+      presentation_time.ToEpochDelta().ToNanoseconds(),  // presentation_time
+      present_callback_                                  // callback
   );
 
   // Execute paint tasks and signal fences.
@@ -76,21 +81,32 @@ void SessionConnection::Present(flow::CompositorContext::ScopedFrame& frame,
   // book-keeping on buffer caches.
   surface_producer_->OnSurfacesPresented(std::move(surfaces_to_submit));
 
+  // Release the Scenic resources the frame did not use.
+  scene_update_context_.EndFrame();
+
   // Prepare for the next frame.
   EnqueueClearOps();
 }
 
 void SessionConnection::OnPresent(scenic::PresentationInfoPtr info) {
   ASSERT_IS_GPU_THREAD;
+  if (info) {
+    presentation_info_.presentation_time =
+        fxl::TimePoint::FromEpochDelta(fxl::TimeDelta::FromNanoseconds(
+            static_cast<int64_t>(info->presentation_time)));
+    presentation_info_.presentation_interval = fxl::TimeDelta::FromNanoseconds(
+        static_cast<int64_t>(info->presentation_interval));
+  }
   auto callback = pending_on_present_callback_;
   pending_on_present_callback_ = nullptr;
-  callback();
+  callback(presentation_info_);
 }
 
 void SessionConnection::EnqueueClearOps() {
   ASSERT_IS_GPU_THREAD;
-  // We are going to be sending down a fresh node hierarchy every frame. So just
-  // enqueue a detach op on the imported root node.
+  // The next frame attaches its node hierarchy again. The nodes it shares
+  // with this frame are reused. So just enqueue a detach op on the imported
+  // root node.
   session_.Enqueue(scenic_lib::NewDetachChildrenOp(root_node_.id()));
 }
 
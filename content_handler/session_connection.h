@@ -6,6 +6,7 @@
 #define FLUTTER_CONTENT_HANDLER_SESSION_CONNECTION_H_
 
 #include "flutter/common/threads.h"
+#include "flutter/content_handler/rasterizer.h"
 #include "flutter/content_handler/vulkan_surface_producer.h"
 #include "flutter/flow/compositor_context.h"
 #include "flutter/flow/scene_update_context.h"
@@ -40,14 +41,21 @@ class SessionConnection {
     return root_node_;
   }
 
+  // Asks the compositor to show the frame at the next presentation time
+  // predicted from the previous ones.
   void Present(flow::CompositorContext::ScopedFrame& frame,
-               fxl::Closure on_present_callback);
+               Rasterizer::DrawCallback on_present_callback);
+
+  const Rasterizer::PresentationInfo& presentation_info() const {
+    return presentation_info_;
+  }
 
  private:
   scenic_lib::Session session_;
   scenic_lib::ImportNode root_node_;
   scenic_lib::Session::PresentCallback present_callback_;
-  fxl::Closure pending_on_present_callback_;
+  Rasterizer::DrawCallback pending_on_present_callback_;
+  Rasterizer::PresentationInfo presentation_info_;
   std::unique_ptr<VulkanSurfaceProducer> surface_producer_;
   flow::SceneUpdateContext scene_update_context_;
   fxl::Closure metrics_changed_callback_;
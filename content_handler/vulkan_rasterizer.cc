@@ -67,25 +67,25 @@ void VulkanRasterizer::SetScene(
 }
 
 void VulkanRasterizer::Draw(std::unique_ptr<flow::LayerTree> layer_tree,
-                            fxl::Closure callback) {
+                            DrawCallback callback) {
   ASSERT_IS_GPU_THREAD;
   FXL_DCHECK(callback != nullptr);
 
   if (layer_tree == nullptr) {
     FXL_LOG(ERROR) << "Layer tree was not valid.";
-    callback();
+    callback(PresentationInfo());
     return;
   }
 
   if (!session_connection_) {
     FXL_LOG(ERROR) << "Session was not valid.";
-    callback();
+    callback(PresentationInfo());
     return;
   }
 
   if (!session_connection_->has_metrics()) {
     // Still awaiting metrics.  Will redraw when we get them.
-    callback();
+    callback(PresentationInfo());
     return;
   }
 
@@ -111,8 +111,7 @@ void VulkanRasterizer::Draw(std::unique_ptr<flow::LayerTree> layer_tree,
   {
     // Flush all pending session ops.
     TRACE_EVENT0("flutter", "SessionPresent");
-    session_connection_->Present(
-        frame, [callback = std::move(callback)]() { callback(); });
+    session_connection_->Present(frame, std::move(callback));
   }
 }
 
@@ -27,7 +27,7 @@ class VulkanRasterizer : public Rasterizer {
                 fxl::Closure metrics_changed_callback) override;
 
   void Draw(std::unique_ptr<flow::LayerTree> layer_tree,
-            fxl::Closure callback) override;
+            DrawCallback callback) override;
 
  private:
   flow::CompositorContext compositor_context_;
@@ -67,9 +67,40 @@ SkISize VulkanSurface::GetSize() const {
     return SkISize::Make(0, 0);
   }
 
+  return viewport_size_;
+}
+
+SkISize VulkanSurface::GetAllocatedSize() const {
+  // Still reported after the surface became invalid, since its memory is
+  // only released when it is collected.
+  if (sk_surface_ == nullptr) {
+    return SkISize::Make(0, 0);
+  }
+
   return SkISize::Make(sk_surface_->width(), sk_surface_->height());
 }
 
+bool VulkanSurface::SetViewportSize(const SkISize& size) {
+  ASSERT_IS_GPU_THREAD;
+  if (!valid_) {
+    return false;
+  }
+
+  if (size == viewport_size_) {
+    return true;
+  }
+
+  FXL_DCHECK(size.width() <= sk_surface_->width() &&
+             size.height() <= sk_surface_->height());
+
+  if (!PushSessionImageOps(size)) {
+    valid_ = false;
+    return false;
+  }
+
+  return true;
+}
+
 GrBackendSemaphore VulkanSurface::GetAcquireSemaphore() const {
   GrBackendSemaphore gr_semaphore;
   gr_semaphore.initVulkan(acquire_semaphore_);
@@ -289,21 +320,37 @@ bool VulkanSurface::PushSessionImageSetupOps(scenic_lib::Session* session,
     return false;
   }
 
-  scenic_lib::Memory memory(session, std::move(exported_vmo),
-                            scenic::MemoryType::VK_DEVICE_MEMORY);
+  session_memory_ = std::make_unique<scenic_lib::Memory>(
+      session, std::move(exported_vmo), scenic::MemoryType::VK_DEVICE_MEMORY);
+
+  return PushSessionImageOps(
+      SkISize::Make(sk_surface_->width(), sk_surface_->height()));
+}
 
+bool VulkanSurface::PushSessionImageOps(const SkISize& viewport_size) {
+  if (session_memory_ == nullptr) {
+    return false;
+  }
+
+  // The rows keep the stride of the whole surface, so the image is a view of
+  // its top left corner.
   auto image_info = scenic::ImageInfo::New();
-  image_info->width = sk_surface_->width();
-  image_info->height = sk_surface_->height();
+  image_info->width = viewport_size.width();
+  image_info->height = viewport_size.height();
   image_info->stride = 4 * sk_surface_->width();
   image_info->pixel_format = scenic::ImageInfo::PixelFormat::BGRA_8;
   image_info->color_space = scenic::ImageInfo::ColorSpace::SRGB;
   image_info->tiling = scenic::ImageInfo::Tiling::LINEAR;
 
   session_image_ = std::make_unique<scenic_lib::Image>(
-      memory, 0 /* memory offset */, std::move(image_info));
+      *session_memory_, 0 /* memory offset */, std::move(image_info));
 
-  return session_image_ != nullptr;
+  if (session_image_ == nullptr) {
+    return false;
+  }
+
+  viewport_size_ = viewport_size;
+  return true;
 }
 
 scenic_lib::Image* VulkanSurface::GetImage() {
@@ -36,8 +36,19 @@ class VulkanSurface : public flow::SceneUpdateContext::SurfaceProducerSurface,
 
   bool IsValid() const override;
 
+  // The size of the viewport, which is the part of the surface shown by the
+  // session image.
   SkISize GetSize() const override;
 
+  // The size the surface was allocated at, which is at least the size of the
+  // viewport. Zero if the allocation failed.
+  SkISize GetAllocatedSize() const;
+
+  // Shows only the top left |size| of the surface in the session image, so
+  // that a surface can be reused for a smaller request. |size| must fit in
+  // the allocated size.
+  bool SetViewportSize(const SkISize& size);
+
   // Note: It is safe for the caller to collect the surface in the
   // |on_writes_committed| callback.
   void SignalWritesFinished(
@@ -62,7 +73,9 @@ class VulkanSurface : public flow::SceneUpdateContext::SurfaceProducerSurface,
   vulkan::VulkanHandle<VkImage> vk_image_;
   vulkan::VulkanHandle<VkDeviceMemory> vk_memory_;
   sk_sp<SkSurface> sk_surface_;
+  std::unique_ptr<scenic_lib::Memory> session_memory_;
   std::unique_ptr<scenic_lib::Image> session_image_;
+  SkISize viewport_size_ = SkISize::Make(0, 0);
   zx::event acquire_event_;
   vulkan::VulkanHandle<VkSemaphore> acquire_semaphore_;
   zx::event release_event_;
@@ -90,6 +103,8 @@ class VulkanSurface : public flow::SceneUpdateContext::SurfaceProducerSurface,
   bool PushSessionImageSetupOps(scenic_lib::Session* session,
                                 zx::vmo exported_vmo);
 
+  bool PushSessionImageOps(const SkISize& viewport_size);
+
   void Reset();
 
   vulkan::VulkanHandle<VkSemaphore> SemaphoreFromEvent(
@@ -4,10 +4,43 @@
 
 #include <trace/event.h>
 
+#include <algorithm>
+#include <iterator>
+
 #include "flutter/content_handler/vulkan_surface_pool.h"
 #include "third_party/skia/include/gpu/GrContext.h"
 
 namespace flutter_runner {
+namespace {
+
+constexpr int kMinBucketStep = 64;
+
+// A request is not served by an available surface with more than this many
+// times the area of its bucket.
+constexpr int64_t kMaxReusedAreaRatio = 2;
+
+// Rounds up to a multiple of an eighth of the next power of two, so that a
+// surface is at most about an eighth larger than its request in each
+// dimension.
+int RoundUpToBucket(int dimension) {
+  int power_of_two = kMinBucketStep;
+  while (power_of_two < dimension) {
+    power_of_two <<= 1;
+  }
+  const int step = std::max(kMinBucketStep, power_of_two / 8);
+  return (dimension + step - 1) / step * step;
+}
+
+int64_t GetArea(const SkISize& size) {
+  return static_cast<int64_t>(size.width()) * size.height();
+}
+
+// TODO(chinmaygarde): Assuming for now that all surfaces are 32bpp.
+size_t GetBytes(const SkISize& size) {
+  return GetArea(size) * 4;
+}
+
+}  // namespace
 
 VulkanSurfacePool::VulkanSurfacePool(vulkan::VulkanProcTable& p_vk,
                                      sk_sp<GrContext> context,
@@ -37,27 +70,44 @@ VulkanSurfacePool::AcquireSurface(const SkISize& size) {
   return surface;
 }
 
-std::unique_ptr<flow::SceneUpdateContext::SurfaceProducerSurface>
-VulkanSurfacePool::GetCachedOrCreateSurface(const SkISize& size) {
-  auto found_in_available = available_surfaces_.find(size);
-  if (found_in_available == available_surfaces_.end()) {
-    return CreateSurface(size);
+std::unique_ptr<VulkanSurface> VulkanSurfacePool::GetCachedOrCreateSurface(
+    const SkISize& size) {
+  const SkISize bucket = SkISize::Make(RoundUpToBucket(size.width()),
+                                       RoundUpToBucket(size.height()));
+
+  // Find the smallest available surface the request fits in, preferring the
+  // most recently used among equals.
+  auto best = available_surfaces_.end();
+  for (auto it = available_surfaces_.begin(); it != available_surfaces_.end();
+       ++it) {
+    const SkISize allocated = (*it)->GetAllocatedSize();
+    if (allocated.width() < size.width() ||
+        allocated.height() < size.height() ||
+        GetArea(allocated) > kMaxReusedAreaRatio * GetArea(bucket)) {
+      continue;
+    }
+    if (best == available_surfaces_.end() ||
+        GetArea(allocated) <= GetArea((*best)->GetAllocatedSize())) {
+      best = it;
+    }
   }
-  SurfacesSet& available_surfaces = found_in_available->second;
-  FXL_DCHECK(available_surfaces.size() > 0);
-  auto acquired_surface = std::move(available_surfaces.back());
-  available_surfaces.pop_back();
-  if (available_surfaces.size() == 0) {
-    available_surfaces_.erase(found_in_available);
+
+  if (best != available_surfaces_.end()) {
+    auto acquired_surface = TakeAvailableSurface(best);
+    // The surface may have been invalidated between the time it was sent into
+    // the available surfaces and now. Extremely unlikely.
+    if (acquired_surface->IsValid() &&
+        acquired_surface->SetViewportSize(size)) {
+      trace_surfaces_reused_++;
+      return acquired_surface;
+    }
   }
-  if (acquired_surface->IsValid()) {
-    trace_surfaces_reused_++;
-    return acquired_surface;
+
+  auto surface = CreateSurface(bucket);
+  if (surface == nullptr || !surface->SetViewportSize(size)) {
+    return nullptr;
   }
-  // This is only likely to happen if the surface was invalidated between the
-  // time it was sent into the available buffers cache and accessed now.
-  // Extremely unlikely.
-  return CreateSurface(size);
+  return surface;
 }
 
 void VulkanSurfacePool::SubmitSurface(
@@ -111,47 +161,43 @@ void VulkanSurfacePool::RecycleSurface(uintptr_t surface_key) {
     return;
   }
 
-  // Recycle the buffer by putting it in the list of available surfaces if the
-  // maximum size of buffers in the collection is not already present.
-  auto& available_surfaces = available_surfaces_[surface_to_recycle->GetSize()];
-  if (available_surfaces.size() < kMaxSurfacesOfSameSize) {
-    available_surfaces.emplace_back(std::move(surface_to_recycle));
+  // Recycle the surface by putting it in the list of available surfaces and
+  // collect the least recently used ones over the budget. The pool only hands
+  // out its own surfaces.
+  auto surface = std::unique_ptr<VulkanSurface>(
+      static_cast<VulkanSurface*>(surface_to_recycle.release()));
+  available_surfaces_bytes_ += GetBytes(surface->GetAllocatedSize());
+  available_surfaces_.emplace_back(std::move(surface));
+  while (available_surfaces_bytes_ > kMaxCachedBytes) {
+    TakeAvailableSurface(available_surfaces_.begin());
+    trace_surfaces_collected_++;
   }
 }
 
+std::unique_ptr<VulkanSurface> VulkanSurfacePool::TakeAvailableSurface(
+    SurfacesSet::iterator position) {
+  auto surface = std::move(*position);
+  available_surfaces_.erase(position);
+  available_surfaces_bytes_ -= GetBytes(surface->GetAllocatedSize());
+  return surface;
+}
+
 void VulkanSurfacePool::AgeAndCollectOldBuffers() {
-  std::vector<SkISize> sizes_to_erase;
-  for (auto& surface_iterator : available_surfaces_) {
-    SurfacesSet& old_surfaces = surface_iterator.second;
-    SurfacesSet new_surfaces;
-    for (auto& surface : old_surfaces) {
-      if (surface->AdvanceAndGetAge() < kMaxSurfaceAge) {
-        new_surfaces.emplace_back(std::move(surface));
-      }
-    }
-    if (new_surfaces.size() == 0) {
-      sizes_to_erase.emplace_back(surface_iterator.first);
+  for (auto it = available_surfaces_.begin();
+       it != available_surfaces_.end();) {
+    if ((*it)->AdvanceAndGetAge() < kMaxSurfaceAge) {
+      ++it;
+      continue;
     }
-    old_surfaces.swap(new_surfaces);
-  }
-  for (const auto& size : sizes_to_erase) {
-    available_surfaces_.erase(size);
+    auto next = std::next(it);
+    TakeAvailableSurface(it);
+    trace_surfaces_collected_++;
+    it = next;
   }
   TraceStats();
 }
 
 void VulkanSurfacePool::TraceStats() {
-  // Resources held in cached buffers.
-  size_t cached_surfaces = 0;
-  size_t cached_surfaces_bytes = 0;
-  for (const auto& surfaces : available_surfaces_) {
-    const auto surface_count = surfaces.second.size();
-    cached_surfaces += surface_count;
-    // TODO(chinmaygarde): Assuming for now that all surfaces are 32bpp.
-    cached_surfaces_bytes +=
-        (surfaces.first.fWidth * surfaces.first.fHeight * 4 * surface_count);
-  }
-
   // Resources held by Skia.
   int skia_resources = 0;
   size_t skia_bytes = 0;
@@ -160,10 +206,11 @@ void VulkanSurfacePool::TraceStats() {
       context_->getResourceCachePurgeableBytes();
 
   TRACE_COUNTER("flutter", "SurfacePool", 0u,                     //
-                "CachedCount", cached_surfaces,                   //
-                "CachedBytes", cached_surfaces_bytes,             //
+                "CachedCount", available_surfaces_.size(),        //
+                "CachedBytes", available_surfaces_bytes_,         //
                 "Created", trace_surfaces_created_,               //
                 "Reused", trace_surfaces_reused_,                 //
+                "Collected", trace_surfaces_collected_,           //
                 "PendingInCompositor", pending_surfaces_.size(),  //
                 "SkiaCacheResources", skia_resources,             //
                 "SkiaCacheBytes", skia_bytes,                     //
@@ -173,6 +220,7 @@ void VulkanSurfacePool::TraceStats() {
   // Reset per present/frame stats.
   trace_surfaces_created_ = 0;
   trace_surfaces_reused_ = 0;
+  trace_surfaces_collected_ = 0;
 }
 
 }  // namespace flutter_runner
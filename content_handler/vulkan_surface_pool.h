@@ -11,11 +11,18 @@
 
 namespace flutter_runner {
 
+// Keeps the surfaces the compositor is done with for later frames. Surfaces
+// are allocated in size buckets and a request is served by the smallest
+// available surface it fits in, so that layers whose size changes every frame
+// still reuse surfaces.
 class VulkanSurfacePool {
  public:
-  static const size_t kMaxSurfacesOfSameSize = 3;
   static const size_t kMaxSurfaceAge = 3;
 
+  // The bytes that the surfaces waiting to be reused may hold in total. The
+  // least recently used ones are collected first.
+  static const size_t kMaxCachedBytes = 64 * 1024 * 1024;
+
   VulkanSurfacePool(vulkan::VulkanProcTable& vk,
                     sk_sp<GrContext> context,
                     sk_sp<GrVkBackendContext> backend_context,
@@ -33,42 +40,32 @@ class VulkanSurfacePool {
   void AgeAndCollectOldBuffers();
 
  private:
-  using SurfacesSet = std::list<
-      std::unique_ptr<flow::SceneUpdateContext::SurfaceProducerSurface>>;
-
-  template <class T>
-  static void HashCombine(size_t& seed, T const& v) {
-    seed ^= std::hash<T>()(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-  }
-
-  struct SkISizeHash {
-    std::size_t operator()(const SkISize& key) const {
-      size_t seed = 0;
-      HashCombine(seed, key.fWidth);
-      HashCombine(seed, key.fHeight);
-      return seed;
-    }
-  };
+  // Ordered from the least to the most recently used.
+  using SurfacesSet = std::list<std::unique_ptr<VulkanSurface>>;
 
   vulkan::VulkanProcTable& vk_;
   sk_sp<GrContext> context_;
   sk_sp<GrVkBackendContext> backend_context_;
   scenic_lib::Session* mozart_session_;
-  std::unordered_map<SkISize, SurfacesSet, SkISizeHash> available_surfaces_;
+  SurfacesSet available_surfaces_;
+  size_t available_surfaces_bytes_ = 0;
   std::unordered_map<
       uintptr_t,
       std::unique_ptr<flow::SceneUpdateContext::SurfaceProducerSurface>>
       pending_surfaces_;
   size_t trace_surfaces_created_ = 0;
   size_t trace_surfaces_reused_ = 0;
+  size_t trace_surfaces_collected_ = 0;
 
-  std::unique_ptr<flow::SceneUpdateContext::SurfaceProducerSurface>
-  GetCachedOrCreateSurface(const SkISize& size);
+  std::unique_ptr<VulkanSurface> GetCachedOrCreateSurface(const SkISize& size);
 
   std::unique_ptr<VulkanSurface> CreateSurface(const SkISize& size);
 
   void RecycleSurface(uintptr_t surface_key);
 
+  std::unique_ptr<VulkanSurface> TakeAvailableSurface(
+      SurfacesSet::iterator position);
+
   void TraceStats();
 
   FXL_DISALLOW_COPY_AND_ASSIGN(VulkanSurfacePool);
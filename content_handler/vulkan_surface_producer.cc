@@ -3,9 +3,11 @@
 // found in the LICENSE file.
 
 #include "flutter/content_handler/vulkan_surface_producer.h"
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
+#include "flutter/common/threads.h"
 #include "third_party/skia/include/gpu/GrBackendSemaphore.h"
 #include "third_party/skia/include/gpu/GrContext.h"
 #include "third_party/skia/include/gpu/vk/GrVkTypes.h"
@@ -13,103 +15,119 @@
 
 namespace flutter_runner {
 
-VulkanSurfaceProducer::VulkanSurfaceProducer(
-    scenic_lib::Session* mozart_session) {
-  valid_ = Initialize(mozart_session);
-
-  if (valid_) {
-    FXL_LOG(INFO)
-        << "Flutter engine: Vulkan surface producer initialization: Successful";
-  } else {
-    FXL_LOG(ERROR)
-        << "Flutter engine: Vulkan surface producer initialization: Failed";
-  }
-}
-
-VulkanSurfaceProducer::~VulkanSurfaceProducer() {
-  // Make sure queue is idle before we start destroying surfaces
-  VkResult wait_result =
-      VK_CALL_LOG_ERROR(vk_->QueueWaitIdle(backend_context_->fQueue));
-  FXL_DCHECK(wait_result == VK_SUCCESS);
+namespace {
+
+// The share of the Skia resource cache each producer adds, up to the limit of
+// a single context.
+constexpr size_t kGrCacheBytesPerProducer = 128 * (1 << 20);
+
+// The device and Skia context all the surface producers of the process render
+// with, so that the applications of the runner share the compiled pipelines
+// and glyphs in the caches of one context instead of warming up their own.
+// Like those caches, they live as long as the process.
+struct SharedContext {
+  fxl::RefPtr<vulkan::VulkanContext> vulkan_context;
+  sk_sp<GrVkBackendContext> backend_context;
+  sk_sp<GrContext> context;
+  size_t producer_count = 0;
 };
 
-bool VulkanSurfaceProducer::Initialize(scenic_lib::Session* mozart_session) {
-  vk_ = fxl::MakeRefCounted<vulkan::VulkanProcTable>();
-
+SharedContext* CreateSharedContext() {
   std::vector<std::string> extensions = {
       VK_KHR_SURFACE_EXTENSION_NAME,
       VK_KHR_EXTERNAL_SEMAPHORE_CAPABILITIES_EXTENSION_NAME,
   };
-  application_ = std::make_unique<vulkan::VulkanApplication>(
-      *vk_, "FlutterContentHandler", std::move(extensions));
+  auto vulkan_context = fxl::MakeRefCounted<vulkan::VulkanContext>(
+      fxl::MakeRefCounted<vulkan::VulkanProcTable>(), std::move(extensions));
+  if (!vulkan_context->IsValid()) {
+    FXL_LOG(ERROR) << "Could not create the Vulkan device.";
+    return nullptr;
+  }
 
-  if (!application_->IsValid() || !vk_->AreInstanceProcsSetup()) {
-    // Make certain the application instance was created and it setup the
-    // instance proc table entries.
-    FXL_LOG(ERROR) << "Instance proc addresses have not been setup.";
-    return false;
+  auto backend_context = vulkan_context->CreateSkiaBackendContext(0);
+  if (backend_context == nullptr) {
+    FXL_LOG(ERROR) << "Could not create the Skia backend context.";
+    return nullptr;
   }
 
-  // Create the device.
+  sk_sp<GrContext> context(GrContext::Create(
+      kVulkan_GrBackend,
+      reinterpret_cast<GrBackendContext>(backend_context.get())));
+  if (context == nullptr) {
+    FXL_LOG(ERROR) << "Could not create the Skia context.";
+    return nullptr;
+  }
 
-  logical_device_ = application_->AcquireFirstCompatibleLogicalDevice();
+  auto shared = new SharedContext();
+  shared->vulkan_context = std::move(vulkan_context);
+  shared->backend_context = std::move(backend_context);
+  shared->context = std::move(context);
+  return shared;
+}
 
-  if (logical_device_ == nullptr || !logical_device_->IsValid() ||
-      !vk_->AreDeviceProcsSetup()) {
-    // Make certain the device was created and it setup the device proc table
-    // entries.
-    FXL_LOG(ERROR) << "Device proc addresses have not been setup.";
-    return false;
-  }
+SharedContext* GetSharedContext() {
+  ASSERT_IS_GPU_THREAD;
+  static SharedContext* shared = CreateSharedContext();
+  return shared;
+}
 
-  if (!vk_->HasAcquiredMandatoryProcAddresses()) {
-    FXL_LOG(ERROR) << "Failed to acquire mandatory proc addresses.";
-    return false;
+// Gives each producer its budget of the shared cache. Skia purges the least
+// recently used resources when the limit goes down.
+void UpdateResourceCacheLimits(SharedContext* shared) {
+  const size_t bytes =
+      std::min(shared->producer_count * kGrCacheBytesPerProducer,
+               vulkan::kGrCacheMaxByteSize);
+  shared->context->setResourceCacheLimits(vulkan::kGrCacheMaxCount, bytes);
+}
+
+}  // namespace
+
+VulkanSurfaceProducer::VulkanSurfaceProducer(
+    scenic_lib::Session* mozart_session) {
+  valid_ = Initialize(mozart_session);
+
+  if (valid_) {
+    FXL_LOG(INFO)
+        << "Flutter engine: Vulkan surface producer initialization: Successful";
+  } else {
+    FXL_LOG(ERROR)
+        << "Flutter engine: Vulkan surface producer initialization: Failed";
   }
+}
 
-  if (!vk_->IsValid()) {
-    FXL_LOG(ERROR) << "VulkanProcTable invalid";
-    return false;
+VulkanSurfaceProducer::~VulkanSurfaceProducer() {
+  if (!valid_) {
+    return;
   }
 
-  auto interface = vk_->CreateSkiaInterface();
+  // Make sure queue is idle before we start destroying surfaces
+  VkResult wait_result = VK_CALL_LOG_ERROR(
+      vulkan_context_->GetProcTable()->QueueWaitIdle(backend_context_->fQueue));
+  FXL_DCHECK(wait_result == VK_SUCCESS);
 
-  if (interface == nullptr || !interface->validate(0)) {
-    FXL_LOG(ERROR) << "Skia interface invalid.";
-    return false;
-  }
+  surface_pool_.reset();
 
-  uint32_t skia_features = 0;
-  if (!logical_device_->GetPhysicalDeviceFeaturesSkia(&skia_features)) {
-    FXL_LOG(ERROR) << "Failed to get physical device features.";
+  SharedContext* shared = GetSharedContext();
+  shared->producer_count--;
+  UpdateResourceCacheLimits(shared);
+};
 
+bool VulkanSurfaceProducer::Initialize(scenic_lib::Session* mozart_session) {
+  SharedContext* shared = GetSharedContext();
+  if (shared == nullptr) {
     return false;
   }
 
-  backend_context_ = sk_make_sp<GrVkBackendContext>();
-  backend_context_->fInstance = application_->GetInstance();
-  backend_context_->fPhysicalDevice =
-      logical_device_->GetPhysicalDeviceHandle();
-  backend_context_->fDevice = logical_device_->GetHandle();
-  backend_context_->fQueue = logical_device_->GetQueueHandle();
-  backend_context_->fGraphicsQueueIndex =
-      logical_device_->GetGraphicsQueueIndex();
-  backend_context_->fMinAPIVersion = application_->GetAPIVersion();
-  backend_context_->fFeatures = skia_features;
-  backend_context_->fInterface.reset(interface.release());
-
-  logical_device_->ReleaseDeviceOwnership();
-  application_->ReleaseInstanceOwnership();
-
-  context_.reset(GrContext::Create(
-      kVulkan_GrBackend,
-      reinterpret_cast<GrBackendContext>(backend_context_.get())));
+  vulkan_context_ = shared->vulkan_context;
+  backend_context_ = shared->backend_context;
+  context_ = shared->context;
 
-  context_->setResourceCacheLimits(vulkan::kGrCacheMaxCount,
-                                   vulkan::kGrCacheMaxByteSize);
+  shared->producer_count++;
+  UpdateResourceCacheLimits(shared);
 
   surface_pool_ = std::make_unique<VulkanSurfacePool>(
-      *vk_, context_, backend_context_, mozart_session);
+      *vulkan_context_->GetProcTable(), context_, backend_context_,
+      mozart_session);
 
   return true;
 }
@@ -9,7 +9,7 @@
 #include "flutter/content_handler/vulkan_surface_pool.h"
 #include "flutter/flow/scene_update_context.h"
 #include "flutter/vulkan/vulkan_application.h"
-#include "flutter/vulkan/vulkan_device.h"
+#include "flutter/vulkan/vulkan_context.h"
 #include "flutter/vulkan/vulkan_proc_table.h"
 #include "lib/fsl/tasks/message_loop.h"
 #include "lib/fxl/macros.h"
@@ -42,16 +42,9 @@ class VulkanSurfaceProducer : public flow::SceneUpdateContext::SurfaceProducer {
           surfaces);
 
  private:
-  // Note: the order here is very important. The proctable must be destroyed
-  // last because it contains the function pointers for VkDestroyDevice and
-  // VkDestroyInstance. The backend context owns the VkDevice and the
-  // VkInstance, so it must be destroyed after the logical device and the
-  // application, which own other vulkan objects associated with the device
-  // and instance.
-  fxl::RefPtr<vulkan::VulkanProcTable> vk_;
+  // Shared with the other producers of the process.
+  fxl::RefPtr<vulkan::VulkanContext> vulkan_context_;
   sk_sp<GrVkBackendContext> backend_context_;
-  std::unique_ptr<vulkan::VulkanDevice> logical_device_;
-  std::unique_ptr<vulkan::VulkanApplication> application_;
   sk_sp<GrContext> context_;
   std::unique_ptr<VulkanSurfacePool> surface_pool_;
   bool valid_ = false;
@@ -0,0 +1,145 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/benchmarks/benchmark_layer_trees.h"
+
+#include <dirent.h>
+
+#include <algorithm>
+
+#include "flutter/flow/layer_tree_serialization.h"
+#include "flutter/flow/layers/default_layer_builder.h"
+#include "lib/fxl/logging.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkPicture.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+
+namespace flow {
+namespace {
+
+constexpr char kLayerTreeExtension[] = ".flt";
+constexpr char kPictureExtension[] = ".skp";
+
+bool HasSuffix(const std::string& value, const std::string& suffix) {
+  return value.size() >= suffix.size() &&
+         value.compare(value.size() - suffix.size(), suffix.size(), suffix) ==
+             0;
+}
+
+std::vector<std::string> ListFiles(const std::string& directory,
+                                   const std::string& extension) {
+  std::vector<std::string> names;
+  DIR* dir = opendir(directory.c_str());
+  if (dir == nullptr) {
+    FXL_LOG(ERROR) << "Could not open " << directory;
+    return names;
+  }
+  while (dirent* entry = readdir(dir)) {
+    std::string name = entry->d_name;
+    if (HasSuffix(name, extension)) {
+      names.push_back(std::move(name));
+    }
+  }
+  closedir(dir);
+  // Keep the benchmark order stable across runs.
+  std::sort(names.begin(), names.end());
+  return names;
+}
+
+sk_sp<SkPicture> CreateListItemPicture(const SkSize& size, int index) {
+  SkPictureRecorder recorder;
+  SkCanvas* canvas = recorder.beginRecording(SkRect::MakeSize(size));
+  SkPaint paint;
+  paint.setAntiAlias(true);
+  paint.setColor(index % 2 ? SK_ColorWHITE : SK_ColorLTGRAY);
+  canvas->drawRect(SkRect::MakeSize(size), paint);
+  paint.setColor(SK_ColorBLUE);
+  canvas->drawCircle(size.height() / 2, size.height() / 2,
+                     size.height() / 2 - 8, paint);
+  paint.setColor(SK_ColorDKGRAY);
+  for (int line = 0; line < 3; line++) {
+    canvas->drawRoundRect(
+        SkRect::MakeXYWH(size.height() + 8, 16 + line * 24,
+                         size.width() - size.height() - 24, 12),
+        4, 4, paint);
+  }
+  return recorder.finishRecordingAsPicture();
+}
+
+}  // namespace
+
+std::vector<BenchmarkLayerTree> LoadBenchmarkLayerTrees(
+    const std::string& directory) {
+  std::vector<BenchmarkLayerTree> trees;
+  for (const std::string& name : ListFiles(directory, kLayerTreeExtension)) {
+    const std::string path = directory + "/" + name;
+    sk_sp<SkData> data = SkData::MakeFromFileName(path.c_str());
+    std::unique_ptr<LayerTree> tree =
+        data ? DeserializeLayerTree(data->data(), data->size()) : nullptr;
+    if (tree == nullptr || tree->root_layer() == nullptr) {
+      FXL_LOG(ERROR) << "Could not read the layer tree in " << path;
+      continue;
+    }
+    trees.push_back({name, std::move(tree)});
+  }
+
+  for (const std::string& name : ListFiles(directory, kPictureExtension)) {
+    const std::string path = directory + "/" + name;
+    sk_sp<SkData> data = SkData::MakeFromFileName(path.c_str());
+    sk_sp<SkPicture> picture =
+        data ? SkPicture::MakeFromData(data.get()) : nullptr;
+    if (picture == nullptr) {
+      FXL_LOG(ERROR) << "Could not read the picture in " << path;
+      continue;
+    }
+
+    const SkIRect bounds = picture->cullRect().roundOut();
+    if (bounds.isEmpty()) {
+      continue;
+    }
+
+    DefaultLayerBuilder builder;
+    builder.PushTransform(SkMatrix::I());
+    builder.PushPicture(SkPoint::Make(0, 0), std::move(picture), true, false);
+    builder.Pop();
+
+    auto tree = std::make_unique<LayerTree>();
+    tree->set_root_layer(builder.TakeLayer());
+    tree->set_frame_size(SkISize::Make(bounds.right(), bounds.bottom()));
+    trees.push_back({name, std::move(tree)});
+  }
+  return trees;
+}
+
+BenchmarkLayerTree CreateSyntheticLayerTree() {
+  const SkISize frame_size = SkISize::Make(1080, 1920);
+  const SkSize item_size = SkSize::Make(1080, 120);
+
+  DefaultLayerBuilder builder;
+  builder.PushTransform(SkMatrix::I());
+  builder.PushClipRect(SkRect::Make(frame_size));
+  // Scrolled by a fraction of an item, as lists usually are.
+  builder.PushTransform(SkMatrix::MakeTrans(0, -37));
+  for (int index = 0; index * item_size.height() < frame_size.height() + 37;
+       index++) {
+    if (index % 4 == 3) {
+      builder.PushOpacity(192);
+    }
+    builder.PushPicture(SkPoint::Make(0, index * item_size.height()),
+                        CreateListItemPicture(item_size, index), true, false);
+    if (index % 4 == 3) {
+      builder.Pop();
+    }
+  }
+  builder.Pop();
+  builder.Pop();
+  builder.Pop();
+
+  auto tree = std::make_unique<LayerTree>();
+  tree->set_root_layer(builder.TakeLayer());
+  tree->set_frame_size(frame_size);
+  return {"synthetic_list", std::move(tree)};
+}
+
+}  // namespace flow
@@ -0,0 +1,35 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_BENCHMARKS_BENCHMARK_LAYER_TREES_H_
+#define FLUTTER_FLOW_BENCHMARKS_BENCHMARK_LAYER_TREES_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "flutter/flow/layers/layer_tree.h"
+
+namespace flow {
+
+struct BenchmarkLayerTree {
+  std::string name;
+  std::unique_ptr<LayerTree> tree;
+};
+
+// Loads a layer tree for each serialized layer tree (.flt) in |directory|,
+// such as those captured with the _flutter.captureLayerTree service
+// extension, and for each serialized picture (.skp), such as the slow frames
+// captured by the rasterizer. Pictures are drawn in a single picture layer the
+// size of the picture.
+std::vector<BenchmarkLayerTree> LoadBenchmarkLayerTrees(
+    const std::string& directory);
+
+// A tree of transformed, clipped and translucent picture layers that stands
+// in for a scrolling list, for runs without recorded trees.
+BenchmarkLayerTree CreateSyntheticLayerTree();
+
+}  // namespace flow
+
+#endif  // FLUTTER_FLOW_BENCHMARKS_BENCHMARK_LAYER_TREES_H_
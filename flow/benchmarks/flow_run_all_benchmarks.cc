@@ -0,0 +1,44 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <vector>
+
+#include "flutter/common/threads.h"
+#include "flutter/flow/benchmarks/benchmark_layer_trees.h"
+#include "flutter/flow/benchmarks/layer_tree_benchmarks.h"
+#include "flutter/fml/thread.h"
+#include "lib/fxl/command_line.h"
+#include "third_party/benchmark/include/benchmark/benchmark_api.h"
+#include "third_party/skia/include/core/SkGraphics.h"
+
+// Replays the layer trees and pictures recorded in --layer-tree-directory,
+// such as captured layer trees and slow frames, or a synthetic tree without
+// it.
+int main(int argc, char** argv) {
+  ::benchmark::Initialize(&argc, argv);
+  fxl::CommandLine command_line = fxl::CommandLineFromArgcArgv(argc, argv);
+
+  SkGraphics::Init();
+
+  // Layers release their pictures on the IO thread.
+  fml::Thread io_thread("io");
+  blink::Threads::Set(blink::Threads(
+      io_thread.GetTaskRunner(), io_thread.GetTaskRunner(),
+      io_thread.GetTaskRunner(), io_thread.GetTaskRunner()));
+
+  std::vector<flow::BenchmarkLayerTree> trees;
+  std::string directory;
+  if (command_line.GetOptionValue("layer-tree-directory", &directory)) {
+    trees = flow::LoadBenchmarkLayerTrees(directory);
+  } else {
+    trees.push_back(flow::CreateSyntheticLayerTree());
+  }
+
+  for (auto& tree : trees) {
+    flow::RegisterLayerTreeBenchmarks(tree.tree.get(), tree.name);
+  }
+
+  ::benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
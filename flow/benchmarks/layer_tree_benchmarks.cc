@@ -0,0 +1,138 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/benchmarks/layer_tree_benchmarks.h"
+
+#include <string>
+
+#include "flutter/flow/compositor_context.h"
+#include "third_party/benchmark/include/benchmark/benchmark_api.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/gpu/GrContext.h"
+#include "third_party/skia/tools/gpu/GrContextFactory.h"
+
+namespace flow {
+namespace {
+
+// The number of frames rasterized before a warm cache run is measured. The
+// raster cache admits pictures once they have been drawn in a few
+// consecutive frames.
+constexpr int kWarmUpFrames = 5;
+
+enum class Backend { kRaster, kGL };
+
+enum class Phase { kPreroll, kPaint };
+
+sk_gpu_test::GrContextFactory& GetContextFactory() {
+  static sk_gpu_test::GrContextFactory* factory =
+      new sk_gpu_test::GrContextFactory();
+  return *factory;
+}
+
+// Leaves |gr_context| null for raster surfaces.
+sk_sp<SkSurface> CreateSurface(Backend backend,
+                               const SkISize& size,
+                               GrContext** gr_context) {
+  const SkImageInfo info =
+      SkImageInfo::MakeN32Premul(size.width(), size.height());
+  *gr_context = nullptr;
+  if (backend == Backend::kRaster) {
+    return SkSurface::MakeRaster(info);
+  }
+
+  sk_gpu_test::ContextInfo context_info = GetContextFactory().getContextInfo(
+      sk_gpu_test::GrContextFactory::kGL_ContextType);
+  if (context_info.grContext() == nullptr) {
+    return nullptr;
+  }
+  context_info.testContext()->makeCurrent();
+  *gr_context = context_info.grContext();
+  return SkSurface::MakeRenderTarget(*gr_context, SkBudgeted::kNo, info);
+}
+
+// Waits for the GPU to finish drawing by reading back a pixel.
+void Finish(SkSurface* surface) {
+  surface->getCanvas()->flush();
+  uint32_t pixel = 0;
+  surface->readPixels(SkImageInfo::MakeN32Premul(1, 1), &pixel, sizeof(pixel),
+                      0, 0);
+}
+
+void BM_LayerTree(benchmark::State& state,
+                  LayerTree* tree,
+                  Backend backend,
+                  Phase phase,
+                  bool warm_cache) {
+  GrContext* gr_context = nullptr;
+  sk_sp<SkSurface> surface =
+      CreateSurface(backend, tree->frame_size(), &gr_context);
+  if (surface == nullptr) {
+    state.SkipWithError("Could not create the surface.");
+    return;
+  }
+  SkCanvas* canvas = surface->getCanvas();
+  CompositorContext compositor_context(nullptr);
+
+  if (warm_cache) {
+    for (int i = 0; i < kWarmUpFrames; i++) {
+      auto frame = compositor_context.AcquireFrame(gr_context, canvas, false);
+      tree->Raster(frame);
+    }
+    Finish(surface.get());
+  }
+
+  while (state.KeepRunning()) {
+    state.PauseTiming();
+    if (!warm_cache) {
+      compositor_context.raster_cache().Clear();
+    }
+    {
+      auto frame = compositor_context.AcquireFrame(gr_context, canvas, false);
+      if (phase == Phase::kPreroll) {
+        state.ResumeTiming();
+        tree->Preroll(frame);
+        state.PauseTiming();
+        tree->Paint(frame);
+      } else {
+        tree->Preroll(frame);
+        state.ResumeTiming();
+        tree->Paint(frame);
+        Finish(surface.get());
+        state.PauseTiming();
+      }
+    }
+    // Sweeping the raster cache at the end of the frame is not measured.
+    state.ResumeTiming();
+  }
+}
+
+}  // namespace
+
+void RegisterLayerTreeBenchmarks(LayerTree* tree, const std::string& name) {
+  const struct {
+    const char* name;
+    Backend backend;
+  } backends[] = {{"Raster", Backend::kRaster}, {"GL", Backend::kGL}};
+  const struct {
+    const char* name;
+    Phase phase;
+  } phases[] = {{"Preroll", Phase::kPreroll}, {"Paint", Phase::kPaint}};
+
+  for (const auto& backend : backends) {
+    for (const auto& phase : phases) {
+      for (bool warm_cache : {false, true}) {
+        const std::string benchmark_name =
+            std::string("BM_LayerTree") + phase.name + "/" + backend.name +
+            (warm_cache ? "/WarmCache/" : "/ColdCache/") + name;
+        benchmark::RegisterBenchmark(benchmark_name.c_str(), &BM_LayerTree,
+                                     tree, backend.backend, phase.phase,
+                                     warm_cache)
+            ->Unit(benchmark::kMicrosecond);
+      }
+    }
+  }
+}
+
+}  // namespace flow
@@ -0,0 +1,21 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_BENCHMARKS_LAYER_TREE_BENCHMARKS_H_
+#define FLUTTER_FLOW_BENCHMARKS_LAYER_TREE_BENCHMARKS_H_
+
+#include <string>
+
+#include "flutter/flow/layers/layer_tree.h"
+
+namespace flow {
+
+// Registers benchmarks timing the preroll and the paint of |tree| into raster
+// and GL surfaces, with the raster cache cleared before each frame and with
+// it warmed up. |tree| must outlive the benchmark run.
+void RegisterLayerTreeBenchmarks(LayerTree* tree, const std::string& name);
+
+}  // namespace flow
+
+#endif  // FLUTTER_FLOW_BENCHMARKS_LAYER_TREE_BENCHMARKS_H_
@@ -4,17 +4,32 @@
 
 #include "flutter/flow/compositor_context.h"
 
+#include "flutter/flow/image_memory_tracker.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 
 namespace flow {
 
 CompositorContext::CompositorContext(std::unique_ptr<ProcessInfo> info)
-    : process_info_(std::move(info)) {}
+    : process_info_(std::move(info)), reported_raster_cache_bytes_(0) {}
 
-CompositorContext::~CompositorContext() = default;
+CompositorContext::~CompositorContext() {
+  ImageMemoryTracker::Get().Add(ImageMemoryTracker::Category::kRasterCache,
+                                -static_cast<int64_t>(
+                                    reported_raster_cache_bytes_));
+}
+
+void CompositorContext::ReportRasterCacheBytes() {
+  const size_t bytes = raster_cache_.resident_bytes();
+  ImageMemoryTracker::Get().Add(
+      ImageMemoryTracker::Category::kRasterCache,
+      static_cast<int64_t>(bytes) -
+          static_cast<int64_t>(reported_raster_cache_bytes_));
+  reported_raster_cache_bytes_ = bytes;
+}
 
 void CompositorContext::BeginFrame(ScopedFrame& frame,
                                    bool enable_instrumentation) {
+  frame_work_counts_ = FrameWorkCounts();
   if (enable_instrumentation) {
     frame_count_.Increment();
     frame_time_.Start();
@@ -22,12 +37,15 @@ void CompositorContext::BeginFrame(ScopedFrame& frame,
     if (process_info_ && process_info_->SampleNow()) {
       memory_usage_.Add(process_info_->GetResidentMemorySize());
     }
+
+    image_memory_usage_.Add(ImageMemoryTracker::Get().GetTotalBytes());
   }
 }
 
 void CompositorContext::EndFrame(ScopedFrame& frame,
                                  bool enable_instrumentation) {
   raster_cache_.SweepAfterFrame();
+  ReportRasterCacheBytes();
   if (enable_instrumentation) {
     frame_time_.Stop();
   }
@@ -57,8 +75,18 @@ CompositorContext::ScopedFrame::~ScopedFrame() {
   context_.EndFrame(*this, instrumentation_enabled_);
 }
 
+void CompositorContext::SetRasterCacheMaxBytes(size_t max_bytes) {
+  raster_cache_.SetMaxBytes(max_bytes);
+}
+
+void CompositorContext::OnGrContextCreated() {
+  texture_registry_.OnGrContextCreated();
+}
+
 void CompositorContext::OnGrContextDestroyed() {
+  texture_registry_.OnGrContextDestroyed();
   raster_cache_.Clear();
+  ReportRasterCacheBytes();
 }
 
 }  // namespace flow
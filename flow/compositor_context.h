@@ -11,6 +11,7 @@
 #include "flutter/flow/instrumentation.h"
 #include "flutter/flow/process_info.h"
 #include "flutter/flow/raster_cache.h"
+#include "flutter/flow/texture.h"
 #include "lib/fxl/macros.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkPictureRecorder.h"
@@ -55,28 +56,59 @@ class CompositorContext {
                            SkCanvas* canvas,
                            bool instrumentation_enabled = true);
 
+  void OnGrContextCreated();
+
   void OnGrContextDestroyed();
 
   RasterCache& raster_cache() { return raster_cache_; }
 
+  TextureRegistry& texture_registry() { return texture_registry_; }
+
+  // The number of bytes the raster cache may hold on to across frames. See
+  // |RasterCache::SetMaxBytes|.
+  void SetRasterCacheMaxBytes(size_t max_bytes);
+
+  size_t raster_cache_max_bytes() const { return raster_cache_.max_bytes(); }
+
   const Counter& frame_count() const { return frame_count_; }
 
   const Stopwatch& frame_time() const { return frame_time_; }
 
   Stopwatch& engine_time() { return engine_time_; }
 
+  // The time the GPU spent on recent frames, where the surface measures it.
+  // Laps are recorded some frames late, once the measurements complete.
+  Stopwatch& gpu_time() { return gpu_time_; }
+
   const CounterValues& memory_usage() const { return memory_usage_; }
 
+  // The work done to draw the current frame. Reset when each frame begins.
+  FrameWorkCounts& frame_work_counts() { return frame_work_counts_; }
+
+  // Samples of the bytes held by native images across the engine. See
+  // |ImageMemoryTracker|.
+  const CounterValues& image_memory_usage() const {
+    return image_memory_usage_;
+  }
+
  private:
   RasterCache raster_cache_;
+  TextureRegistry texture_registry_;
   std::unique_ptr<ProcessInfo> process_info_;
   Counter frame_count_;
   Stopwatch frame_time_;
   Stopwatch engine_time_;
+  Stopwatch gpu_time_;
   CounterValues memory_usage_;
+  CounterValues image_memory_usage_;
+  FrameWorkCounts frame_work_counts_;
+  // The raster cache bytes last reported to the |ImageMemoryTracker|.
+  size_t reported_raster_cache_bytes_;
 
   void BeginFrame(ScopedFrame& frame, bool enable_instrumentation);
 
+  void ReportRasterCacheBytes();
+
   void EndFrame(ScopedFrame& frame, bool enable_instrumentation);
 
   FXL_DISALLOW_COPY_AND_ASSIGN(CompositorContext);
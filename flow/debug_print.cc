@@ -71,7 +71,9 @@ std::ostream& operator<<(std::ostream& os, const SkPoint& r) {
 }
 
 std::ostream& operator<<(std::ostream& os, const flow::RasterCacheKey& k) {
-  os << "Picture: " << k.picture_id() << " Scale: " << k.scale_key().width()
-     << ", " << k.scale_key().height();
+  os << (k.kind() == flow::RasterCacheKey::Kind::kPicture ? "Picture: "
+                                                           : "Layer: ")
+     << k.id() << " Scale: " << k.scale_key().width() << ", "
+     << k.scale_key().height();
   return os;
 }
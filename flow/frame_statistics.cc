@@ -0,0 +1,60 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/frame_statistics.h"
+
+#include <algorithm>
+
+namespace flow {
+
+double FrameStatistics::GetRasterCacheHitRate() const {
+  const size_t lookups = raster_cache_hit_count + raster_cache_miss_count;
+  if (lookups == 0) {
+    return 0;
+  }
+  return static_cast<double>(raster_cache_hit_count) / lookups;
+}
+
+FrameStatisticsAggregator::FrameStatisticsAggregator(
+    fxl::TimeDelta frame_budget)
+    : frame_budget_(frame_budget) {
+  statistics_.start = fxl::TimePoint::Now();
+}
+
+FrameStatisticsAggregator::~FrameStatisticsAggregator() = default;
+
+void FrameStatisticsAggregator::AddFrame(const FrameTiming& timing,
+                                         const FrameWorkCounts& work_counts,
+                                         int64_t gpu_resource_cache_bytes) {
+  const fxl::TimeDelta build_time = timing.Get(FrameTiming::kBuildFinish) -
+                                    timing.Get(FrameTiming::kBuildStart);
+  const fxl::TimeDelta raster_time = timing.Get(FrameTiming::kRasterFinish) -
+                                     timing.Get(FrameTiming::kRasterStart);
+
+  statistics_.frame_count++;
+  statistics_.build_time_counts[fml::LatencyHistogram::GetBucketIndex(
+      build_time)]++;
+  statistics_.raster_time_counts[fml::LatencyHistogram::GetBucketIndex(
+      raster_time)]++;
+  if (build_time > frame_budget_) {
+    statistics_.janky_build_frame_count++;
+  }
+  if (raster_time > frame_budget_) {
+    statistics_.janky_raster_frame_count++;
+  }
+  statistics_.raster_cache_hit_count += work_counts.raster_cache_hits;
+  statistics_.raster_cache_miss_count += work_counts.raster_cache_misses;
+  statistics_.peak_gpu_resource_cache_bytes = std::max(
+      statistics_.peak_gpu_resource_cache_bytes, gpu_resource_cache_bytes);
+}
+
+FrameStatistics FrameStatisticsAggregator::Take(fxl::TimePoint now) {
+  FrameStatistics statistics = statistics_;
+  statistics.end = now;
+  statistics_ = FrameStatistics();
+  statistics_.start = now;
+  return statistics;
+}
+
+}  // namespace flow
@@ -0,0 +1,69 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_FRAME_STATISTICS_H_
+#define FLUTTER_FLOW_FRAME_STATISTICS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "flutter/flow/frame_timing.h"
+#include "flutter/flow/instrumentation.h"
+#include "flutter/fml/latency_histogram.h"
+#include "lib/fxl/macros.h"
+#include "lib/fxl/time/time_delta.h"
+#include "lib/fxl/time/time_point.h"
+
+namespace flow {
+
+// Statistics of the frames presented over an interval. The durations are
+// counted in the buckets of |fml::LatencyHistogram|.
+struct FrameStatistics {
+  fxl::TimePoint start;
+  fxl::TimePoint end;
+  size_t frame_count = 0;
+  // The time the UI thread spent building each frame.
+  fml::LatencyHistogram::Counts build_time_counts = {};
+  // The time the GPU thread spent rasterizing each frame.
+  fml::LatencyHistogram::Counts raster_time_counts = {};
+  // Frames whose build or raster time exceeded the frame budget.
+  size_t janky_build_frame_count = 0;
+  size_t janky_raster_frame_count = 0;
+  size_t raster_cache_hit_count = 0;
+  size_t raster_cache_miss_count = 0;
+  // The most bytes the GPU resource cache held after any of the frames.
+  int64_t peak_gpu_resource_cache_bytes = 0;
+
+  // Zero if the raster cache was not consulted.
+  double GetRasterCacheHitRate() const;
+};
+
+// Aggregates the statistics of presented frames. Only used on the GPU thread.
+class FrameStatisticsAggregator {
+ public:
+  explicit FrameStatisticsAggregator(fxl::TimeDelta frame_budget);
+
+  ~FrameStatisticsAggregator();
+
+  void AddFrame(const FrameTiming& timing,
+                const FrameWorkCounts& work_counts,
+                int64_t gpu_resource_cache_bytes);
+
+  // The time the statistics being aggregated started to be collected.
+  fxl::TimePoint start() const { return statistics_.start; }
+
+  // Returns the statistics aggregated since the previous call, ending at
+  // |now|, and starts over.
+  FrameStatistics Take(fxl::TimePoint now);
+
+ private:
+  const fxl::TimeDelta frame_budget_;
+  FrameStatistics statistics_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(FrameStatisticsAggregator);
+};
+
+}  // namespace flow
+
+#endif  // FLUTTER_FLOW_FRAME_STATISTICS_H_
@@ -0,0 +1,87 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/frame_statistics.h"
+#include "third_party/gtest/include/gtest/gtest.h"
+
+namespace {
+
+const fxl::TimeDelta kFrameBudget = fxl::TimeDelta::FromMilliseconds(16);
+
+flow::FrameTiming MakeTiming(int64_t build_millis, int64_t raster_millis) {
+  flow::FrameTiming timing;
+  const fxl::TimePoint start = fxl::TimePoint::Now();
+  timing.Set(flow::FrameTiming::kBuildStart, start);
+  timing.Set(flow::FrameTiming::kBuildFinish,
+             start + fxl::TimeDelta::FromMilliseconds(build_millis));
+  timing.Set(flow::FrameTiming::kRasterStart, start);
+  timing.Set(flow::FrameTiming::kRasterFinish,
+             start + fxl::TimeDelta::FromMilliseconds(raster_millis));
+  return timing;
+}
+
+}  // namespace
+
+TEST(FrameStatisticsAggregator, CountsJankyFramesPerThread) {
+  flow::FrameStatisticsAggregator aggregator(kFrameBudget);
+  aggregator.AddFrame(MakeTiming(5, 5), flow::FrameWorkCounts(), 0);
+  aggregator.AddFrame(MakeTiming(20, 5), flow::FrameWorkCounts(), 0);
+  aggregator.AddFrame(MakeTiming(20, 30), flow::FrameWorkCounts(), 0);
+
+  const flow::FrameStatistics statistics =
+      aggregator.Take(fxl::TimePoint::Now());
+  ASSERT_EQ(statistics.frame_count, 3u);
+  ASSERT_EQ(statistics.janky_build_frame_count, 2u);
+  ASSERT_EQ(statistics.janky_raster_frame_count, 1u);
+}
+
+TEST(FrameStatisticsAggregator, CountsTimesInHistogramBuckets) {
+  flow::FrameStatisticsAggregator aggregator(kFrameBudget);
+  aggregator.AddFrame(MakeTiming(3, 20), flow::FrameWorkCounts(), 0);
+  aggregator.AddFrame(MakeTiming(3, 20), flow::FrameWorkCounts(), 0);
+
+  const flow::FrameStatistics statistics =
+      aggregator.Take(fxl::TimePoint::Now());
+  const size_t build_bucket = fml::LatencyHistogram::GetBucketIndex(
+      fxl::TimeDelta::FromMilliseconds(3));
+  const size_t raster_bucket = fml::LatencyHistogram::GetBucketIndex(
+      fxl::TimeDelta::FromMilliseconds(20));
+  ASSERT_NE(build_bucket, raster_bucket);
+  ASSERT_EQ(statistics.build_time_counts[build_bucket], 2u);
+  ASSERT_EQ(statistics.raster_time_counts[raster_bucket], 2u);
+  ASSERT_EQ(statistics.build_time_counts[raster_bucket], 0u);
+}
+
+TEST(FrameStatisticsAggregator, TracksRasterCacheAndPeakGpuMemory) {
+  flow::FrameStatisticsAggregator aggregator(kFrameBudget);
+  flow::FrameWorkCounts counts;
+  counts.raster_cache_hits = 3;
+  counts.raster_cache_misses = 1;
+  aggregator.AddFrame(MakeTiming(1, 1), counts, 100);
+  aggregator.AddFrame(MakeTiming(1, 1), counts, 300);
+  aggregator.AddFrame(MakeTiming(1, 1), counts, 200);
+
+  const flow::FrameStatistics statistics =
+      aggregator.Take(fxl::TimePoint::Now());
+  ASSERT_EQ(statistics.raster_cache_hit_count, 9u);
+  ASSERT_EQ(statistics.raster_cache_miss_count, 3u);
+  ASSERT_DOUBLE_EQ(statistics.GetRasterCacheHitRate(), 0.75);
+  ASSERT_EQ(statistics.peak_gpu_resource_cache_bytes, 300);
+}
+
+TEST(FrameStatisticsAggregator, TakeStartsOver) {
+  flow::FrameStatisticsAggregator aggregator(kFrameBudget);
+  aggregator.AddFrame(MakeTiming(20, 20), flow::FrameWorkCounts(), 100);
+
+  const fxl::TimePoint now = fxl::TimePoint::Now();
+  const flow::FrameStatistics first = aggregator.Take(now);
+  ASSERT_EQ(first.end, now);
+  ASSERT_EQ(aggregator.start(), now);
+
+  const flow::FrameStatistics second = aggregator.Take(now);
+  ASSERT_EQ(second.frame_count, 0u);
+  ASSERT_EQ(second.janky_build_frame_count, 0u);
+  ASSERT_EQ(second.peak_gpu_resource_cache_bytes, 0);
+  ASSERT_DOUBLE_EQ(second.GetRasterCacheHitRate(), 0);
+}
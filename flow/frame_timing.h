@@ -0,0 +1,53 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_FRAME_TIMING_H_
+#define FLUTTER_FLOW_FRAME_TIMING_H_
+
+#include <stdint.h>
+
+#include "lib/fxl/time/time_point.h"
+
+namespace flow {
+
+// The points in time a single frame passed through on its way to the screen.
+// The UI thread fills in the vsync and build phases. The GPU thread fills in
+// the raster and present phases, and the display phase once the surface
+// reports when the frame appeared on the display. Phases that are not known
+// are left null.
+class FrameTiming {
+ public:
+  enum Phase {
+    kVsyncStart,
+    kBuildStart,
+    kBuildFinish,
+    kRasterStart,
+    kRasterFinish,
+    kPresent,
+    kDisplay,
+    kPhaseCount,
+  };
+
+  int64_t frame_number() const { return frame_number_; }
+
+  void set_frame_number(int64_t frame_number) { frame_number_ = frame_number; }
+
+  fxl::TimePoint Get(Phase phase) const { return timestamps_[phase]; }
+
+  void Set(Phase phase, fxl::TimePoint time) { timestamps_[phase] = time; }
+
+  // Microseconds since the epoch of |fxl::TimePoint|. This is the time base
+  // of the frame times handed to Dart via |Window::BeginFrame|.
+  int64_t GetMicros(Phase phase) const {
+    return (timestamps_[phase] - fxl::TimePoint()).ToMicroseconds();
+  }
+
+ private:
+  int64_t frame_number_ = 0;
+  fxl::TimePoint timestamps_[kPhaseCount];
+};
+
+}  // namespace flow
+
+#endif  // FLUTTER_FLOW_FRAME_TIMING_H_
@@ -0,0 +1,51 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/image_memory_tracker.h"
+
+namespace flow {
+
+ImageMemoryTracker& ImageMemoryTracker::Get() {
+  static ImageMemoryTracker* tracker = new ImageMemoryTracker();
+  return *tracker;
+}
+
+ImageMemoryTracker::ImageMemoryTracker() : image_count_(0) {
+  for (auto& bytes : bytes_) {
+    bytes = 0;
+  }
+}
+
+int64_t ImageMemoryTracker::GetImageBytes(const SkImage& image) {
+  return static_cast<int64_t>(image.width()) * image.height() * 4;
+}
+
+void ImageMemoryTracker::Add(Category category, int64_t bytes) {
+  bytes_[static_cast<size_t>(category)].fetch_add(bytes,
+                                                  std::memory_order_relaxed);
+}
+
+void ImageMemoryTracker::AddImage(const SkImage& image, int count) {
+  Add(image.isTextureBacked() ? Category::kGPUResident : Category::kDecoded,
+      count * GetImageBytes(image));
+  image_count_.fetch_add(count, std::memory_order_relaxed);
+}
+
+int64_t ImageMemoryTracker::GetBytes(Category category) const {
+  return bytes_[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+}
+
+int64_t ImageMemoryTracker::GetTotalBytes() const {
+  int64_t total = 0;
+  for (const auto& bytes : bytes_) {
+    total += bytes.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+int64_t ImageMemoryTracker::GetImageCount() const {
+  return image_count_.load(std::memory_order_relaxed);
+}
+
+}  // namespace flow
@@ -0,0 +1,63 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_IMAGE_MEMORY_TRACKER_H_
+#define FLUTTER_FLOW_IMAGE_MEMORY_TRACKER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+#include "lib/fxl/macros.h"
+#include "third_party/skia/include/core/SkImage.h"
+
+namespace flow {
+
+// Counts the bytes of live native images across the engine. The counts are
+// updated from any thread by whoever holds on to the images.
+class ImageMemoryTracker {
+ public:
+  enum class Category {
+    // Images held by Dart in CPU memory.
+    kDecoded,
+    // Images held by Dart whose pixels live in a texture.
+    kGPUResident,
+    // Pictures and layers rasterized by the raster cache.
+    kRasterCache,
+  };
+
+  static constexpr size_t kCategoryCount = 3;
+
+  static ImageMemoryTracker& Get();
+
+  // The bytes accounted for |image|.
+  static int64_t GetImageBytes(const SkImage& image);
+
+  // Use a negative |bytes| when memory is released.
+  void Add(Category category, int64_t bytes);
+
+  // Accounts |image| as held by Dart (|count| 1) or released by it (|count|
+  // -1). Texture backed images are GPU resident.
+  void AddImage(const SkImage& image, int count);
+
+  int64_t GetBytes(Category category) const;
+
+  int64_t GetTotalBytes() const;
+
+  // The number of images accounted through |AddImage|.
+  int64_t GetImageCount() const;
+
+ private:
+  ImageMemoryTracker();
+
+  std::atomic<int64_t> bytes_[kCategoryCount];
+  std::atomic<int64_t> image_count_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(ImageMemoryTracker);
+};
+
+}  // namespace flow
+
+#endif  // FLUTTER_FLOW_IMAGE_MEMORY_TRACKER_H_
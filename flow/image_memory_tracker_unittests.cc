@@ -0,0 +1,41 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/image_memory_tracker.h"
+#include "third_party/gtest/include/gtest/gtest.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+
+TEST(ImageMemoryTracker, RasterImagesAreDecoded) {
+  auto& tracker = flow::ImageMemoryTracker::Get();
+  const int64_t decoded = tracker.GetBytes(
+      flow::ImageMemoryTracker::Category::kDecoded);
+  const int64_t count = tracker.GetImageCount();
+
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(10, 20);
+  sk_sp<SkImage> image = SkImage::MakeFromBitmap(bitmap);
+
+  tracker.AddImage(*image, 1);
+  ASSERT_EQ(tracker.GetBytes(flow::ImageMemoryTracker::Category::kDecoded),
+            decoded + 10 * 20 * 4);
+  ASSERT_EQ(tracker.GetImageCount(), count + 1);
+
+  tracker.AddImage(*image, -1);
+  ASSERT_EQ(tracker.GetBytes(flow::ImageMemoryTracker::Category::kDecoded),
+            decoded);
+  ASSERT_EQ(tracker.GetImageCount(), count);
+}
+
+TEST(ImageMemoryTracker, TotalIncludesAllCategories) {
+  auto& tracker = flow::ImageMemoryTracker::Get();
+  const int64_t total = tracker.GetTotalBytes();
+
+  tracker.Add(flow::ImageMemoryTracker::Category::kRasterCache, 100);
+  tracker.Add(flow::ImageMemoryTracker::Category::kGPUResident, 20);
+  ASSERT_EQ(tracker.GetTotalBytes(), total + 120);
+
+  tracker.Add(flow::ImageMemoryTracker::Category::kRasterCache, -100);
+  tracker.Add(flow::ImageMemoryTracker::Category::kGPUResident, -20);
+  ASSERT_EQ(tracker.GetTotalBytes(), total);
+}
@@ -4,7 +4,10 @@
 
 #include "flutter/flow/instrumentation.h"
 
+#include <math.h>
+
 #include <algorithm>
+#include <atomic>
 #include <limits>
 
 #include "third_party/skia/include/core/SkPath.h"
@@ -14,6 +17,19 @@ namespace flow {
 static const size_t kMaxSamples = 120;
 static const size_t kMaxFrameMarkers = 8;
 
+static std::atomic<double> g_frame_budget_ms(1e3 / 60.0);
+
+double FrameBudgetMS() {
+  return g_frame_budget_ms.load(std::memory_order_relaxed);
+}
+
+void SetFrameBudget(fxl::TimeDelta interval) {
+  if (interval <= fxl::TimeDelta::Zero())
+    return;
+  g_frame_budget_ms.store(interval.ToMillisecondsF(),
+                          std::memory_order_relaxed);
+}
+
 Stopwatch::Stopwatch() : start_(fxl::TimePoint::Now()), current_sample_(0) {
   const fxl::TimeDelta delta = fxl::TimeDelta::Zero();
   laps_.resize(kMaxSamples, delta);
@@ -39,8 +55,8 @@ const fxl::TimeDelta& Stopwatch::LastLap() const {
   return laps_[(current_sample_ - 1) % kMaxSamples];
 }
 
-static inline constexpr double UnitFrameInterval(double frame_time_ms) {
-  return frame_time_ms * 60.0 * 1e-3;
+static inline double UnitFrameInterval(double frame_time_ms) {
+  return frame_time_ms / FrameBudgetMS();
 }
 
 static inline double UnitHeight(double frame_time_ms,
@@ -60,6 +76,23 @@ fxl::TimeDelta Stopwatch::MaxDelta() const {
   return max_delta;
 }
 
+fxl::TimeDelta Stopwatch::Percentile(double percentile) const {
+  std::vector<fxl::TimeDelta> sorted_laps(laps_);
+  std::sort(sorted_laps.begin(), sorted_laps.end());
+  const double rank = std::ceil(percentile / 100.0 * kMaxSamples);
+  const size_t index = std::min<size_t>(
+      kMaxSamples - 1, static_cast<size_t>(std::max(rank, 1.0)) - 1);
+  return sorted_laps[index];
+}
+
+size_t Stopwatch::OverBudgetCount() const {
+  const double frame_budget_ms = FrameBudgetMS();
+  return std::count_if(laps_.begin(), laps_.end(),
+                       [frame_budget_ms](const fxl::TimeDelta& lap) {
+                         return lap.ToMillisecondsF() > frame_budget_ms;
+                       });
+}
+
 void Stopwatch::Visualize(SkCanvas& canvas, const SkRect& rect) const {
   SkPaint paint;
 
@@ -77,7 +110,8 @@ void Stopwatch::Visualize(SkCanvas& canvas, const SkRect& rect) const {
 
   // Scale the graph to show frame times up to those that are 3 times the frame
   // time.
-  const double max_interval = kOneFrameMS * 3.0;
+  const double frame_budget_ms = FrameBudgetMS();
+  const double max_interval = frame_budget_ms * 3.0;
   const double max_unit_interval = UnitFrameInterval(max_interval);
 
   // Prepare a path for the data.
@@ -116,9 +150,10 @@ void Stopwatch::Visualize(SkCanvas& canvas, const SkRect& rect) const {
   paint.setStyle(SkPaint::Style::kStroke_Style);
   paint.setColor(0xCC000000);
 
-  if (max_interval > kOneFrameMS) {
+  if (max_interval > frame_budget_ms) {
     // Paint the horizontal markers
-    size_t frame_marker_count = static_cast<size_t>(max_interval / kOneFrameMS);
+    size_t frame_marker_count =
+        static_cast<size_t>(max_interval / frame_budget_ms);
 
     // Limit the number of markers displayed. After a certain point, the graph
     // becomes crowded
@@ -128,8 +163,9 @@ void Stopwatch::Visualize(SkCanvas& canvas, const SkRect& rect) const {
     for (size_t frame_index = 0; frame_index < frame_marker_count;
          frame_index++) {
       const double frame_height =
-          height * (1.0 - (UnitFrameInterval((frame_index + 1) * kOneFrameMS) /
-                           max_unit_interval));
+          height *
+          (1.0 - (UnitFrameInterval((frame_index + 1) * frame_budget_ms) /
+                  max_unit_interval));
       canvas.drawLine(x, y + frame_height, right, y + frame_height, paint);
     }
   }
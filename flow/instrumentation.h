@@ -14,7 +14,12 @@
 
 namespace flow {
 
-static const double kOneFrameMS = 1e3 / 60.0;
+// The refresh interval of the display in milliseconds, which is the budget of
+// each frame. It is that of a 60Hz display until the vsync waiter reports the
+// actual interval with |SetFrameBudget|. Thread safe.
+double FrameBudgetMS();
+
+void SetFrameBudget(fxl::TimeDelta interval);
 
 class Stopwatch {
  public:
@@ -28,6 +33,12 @@ class Stopwatch {
 
   fxl::TimeDelta MaxDelta() const;
 
+  // The lap time that |percentile| percent of the recent laps do not exceed.
+  fxl::TimeDelta Percentile(double percentile) const;
+
+  // The number of recent laps that took longer than a frame interval.
+  size_t OverBudgetCount() const;
+
   void Visualize(SkCanvas& canvas, const SkRect& rect) const;
 
   void Start();
@@ -60,6 +71,19 @@ class Counter {
   FXL_DISALLOW_COPY_AND_ASSIGN(Counter);
 };
 
+// The work done to draw the frame being rasterized.
+struct FrameWorkCounts {
+  size_t raster_cache_hits = 0;
+  size_t raster_cache_misses = 0;
+  size_t raster_cache_bytes = 0;
+  // The offscreen layers saved by layers. Those within pictures are not
+  // counted.
+  size_t save_layers = 0;
+  // The approximate number of operations of the pictures drawn directly
+  // rather than from the raster cache.
+  size_t picture_ops = 0;
+};
+
 class CounterValues {
  public:
   CounterValues();
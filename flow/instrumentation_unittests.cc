@@ -0,0 +1,46 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/instrumentation.h"
+#include "third_party/gtest/include/gtest/gtest.h"
+
+TEST(Stopwatch, PercentilesOfLaps) {
+  flow::Stopwatch stopwatch;
+  // 120 laps of 1ms to 120ms.
+  for (int i = 1; i <= 120; i++) {
+    stopwatch.SetLapTime(fxl::TimeDelta::FromMilliseconds(i));
+  }
+
+  ASSERT_EQ(stopwatch.Percentile(50).ToMilliseconds(), 60);
+  ASSERT_EQ(stopwatch.Percentile(90).ToMilliseconds(), 108);
+  ASSERT_EQ(stopwatch.Percentile(99).ToMilliseconds(), 119);
+  ASSERT_EQ(stopwatch.Percentile(100).ToMilliseconds(), 120);
+  ASSERT_EQ(stopwatch.Percentile(0).ToMilliseconds(), 1);
+}
+
+TEST(Stopwatch, OverBudgetLapsAreCounted) {
+  flow::Stopwatch stopwatch;
+  ASSERT_EQ(stopwatch.OverBudgetCount(), 0u);
+
+  stopwatch.SetLapTime(fxl::TimeDelta::FromMilliseconds(10));
+  stopwatch.SetLapTime(fxl::TimeDelta::FromMilliseconds(20));
+  stopwatch.SetLapTime(fxl::TimeDelta::FromMilliseconds(40));
+  ASSERT_EQ(stopwatch.OverBudgetCount(), 2u);
+}
+
+TEST(Stopwatch, OverBudgetCountFollowsTheFrameBudget) {
+  flow::Stopwatch stopwatch;
+  stopwatch.SetLapTime(fxl::TimeDelta::FromMilliseconds(5));
+  stopwatch.SetLapTime(fxl::TimeDelta::FromMilliseconds(10));
+  stopwatch.SetLapTime(fxl::TimeDelta::FromMilliseconds(20));
+
+  flow::SetFrameBudget(fxl::TimeDelta::FromSecondsF(1.0 / 120.0));
+  ASSERT_EQ(stopwatch.OverBudgetCount(), 2u);
+
+  flow::SetFrameBudget(fxl::TimeDelta::Zero());
+  ASSERT_EQ(stopwatch.OverBudgetCount(), 2u);
+
+  flow::SetFrameBudget(fxl::TimeDelta::FromSecondsF(1.0 / 60.0));
+  ASSERT_EQ(stopwatch.OverBudgetCount(), 1u);
+}
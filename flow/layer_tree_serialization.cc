@@ -0,0 +1,470 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layer_tree_serialization.h"
+
+#include <string.h>
+
+#include "flutter/flow/layers/default_layer_builder.h"
+#include "flutter/flow/layers/layer_tree.h"
+#include "lib/fxl/logging.h"
+#include "third_party/skia/include/core/SkFlattenableSerialization.h"
+#include "third_party/skia/include/core/SkImageFilter.h"
+#include "third_party/skia/include/core/SkShader.h"
+
+namespace flow {
+namespace {
+
+// "FLTR" in little endian.
+constexpr uint32_t kMagic = 0x52544c46;
+// Bump when the format changes.
+constexpr uint32_t kVersion = 1;
+
+bool IsLittleEndian() {
+  const uint16_t value = 1;
+  uint8_t first_byte;
+  memcpy(&first_byte, &value, 1);
+  return first_byte == 1;
+}
+
+// Reads the values written by |LayerTreeWriter|. Reads past the end of the
+// data fail and leave the reader failed.
+class LayerTreeReader {
+ public:
+  LayerTreeReader(const void* data, size_t size)
+      : data_(static_cast<const uint8_t*>(data)), size_(size) {}
+
+  bool failed() const { return failed_; }
+  bool at_end() const { return offset_ == size_; }
+
+  bool ReadOp(LayerTreeWriter::Op* op) {
+    uint8_t value;
+    if (!ReadBytes(&value, sizeof(value)) ||
+        value > static_cast<uint8_t>(LayerTreeWriter::Op::kPushTexture)) {
+      return Fail();
+    }
+    *op = static_cast<LayerTreeWriter::Op>(value);
+    return true;
+  }
+
+  bool ReadBool(bool* value) {
+    uint8_t byte;
+    if (!ReadBytes(&byte, sizeof(byte)) || byte > 1)
+      return Fail();
+    *value = byte == 1;
+    return true;
+  }
+
+  bool ReadUInt32(uint32_t* value) { return ReadBytes(value, sizeof(*value)); }
+  bool ReadInt64(int64_t* value) { return ReadBytes(value, sizeof(*value)); }
+  bool ReadUInt64(uint64_t* value) { return ReadBytes(value, sizeof(*value)); }
+  bool ReadScalar(SkScalar* value) { return ReadBytes(value, sizeof(*value)); }
+
+  bool ReadPoint(SkPoint* point) {
+    SkScalar x, y;
+    if (!ReadScalar(&x) || !ReadScalar(&y))
+      return false;
+    point->set(x, y);
+    return true;
+  }
+
+  bool ReadSize(SkSize* size) {
+    SkScalar width, height;
+    if (!ReadScalar(&width) || !ReadScalar(&height))
+      return false;
+    size->set(width, height);
+    return true;
+  }
+
+  bool ReadRect(SkRect* rect) {
+    SkScalar left, top, right, bottom;
+    if (!ReadScalar(&left) || !ReadScalar(&top) || !ReadScalar(&right) ||
+        !ReadScalar(&bottom)) {
+      return false;
+    }
+    rect->setLTRB(left, top, right, bottom);
+    return true;
+  }
+
+  bool ReadRRect(SkRRect* rrect) {
+    const void* bytes;
+    size_t size;
+    if (!ReadByteArray(&bytes, &size))
+      return false;
+    if (size != SkRRect::kSizeInMemory ||
+        rrect->readFromMemory(bytes, size) != size) {
+      return Fail();
+    }
+    return true;
+  }
+
+  bool ReadMatrix(SkMatrix* matrix) {
+    SkScalar values[9];
+    for (SkScalar& value : values) {
+      if (!ReadScalar(&value))
+        return false;
+    }
+    matrix->set9(values);
+    return true;
+  }
+
+  bool ReadPath(SkPath* path) {
+    const void* bytes;
+    size_t size;
+    if (!ReadByteArray(&bytes, &size))
+      return false;
+    if (path->readFromMemory(bytes, size) != size)
+      return Fail();
+    return true;
+  }
+
+  bool ReadImageFilter(sk_sp<SkImageFilter>* filter) {
+    const void* bytes;
+    size_t size;
+    if (!ReadByteArray(&bytes, &size))
+      return false;
+    if (size == 0) {
+      *filter = nullptr;
+      return true;
+    }
+    *filter = SkValidatingDeserializeImageFilter(bytes, size);
+    return *filter ? true : Fail();
+  }
+
+  bool ReadShader(sk_sp<SkShader>* shader) {
+    const void* bytes;
+    size_t size;
+    if (!ReadByteArray(&bytes, &size))
+      return false;
+    if (size == 0) {
+      *shader = nullptr;
+      return true;
+    }
+    shader->reset(static_cast<SkShader*>(SkValidatingDeserializeFlattenable(
+        bytes, size, SkFlattenable::kSkShaderBase_Type)));
+    return *shader ? true : Fail();
+  }
+
+  bool ReadPicture(sk_sp<SkPicture>* picture) {
+    const void* bytes;
+    size_t size;
+    if (!ReadByteArray(&bytes, &size))
+      return false;
+    *picture = SkPicture::MakeFromData(bytes, size);
+    return *picture ? true : Fail();
+  }
+
+ private:
+  const uint8_t* const data_;
+  const size_t size_;
+  size_t offset_ = 0;
+  bool failed_ = false;
+
+  bool Fail() {
+    failed_ = true;
+    return false;
+  }
+
+  bool ReadBytes(void* bytes, size_t size) {
+    if (failed_ || size > size_ - offset_)
+      return Fail();
+    memcpy(bytes, data_ + offset_, size);
+    offset_ += size;
+    return true;
+  }
+
+  // Points |bytes| into the data instead of copying them.
+  bool ReadByteArray(const void** bytes, size_t* size) {
+    uint32_t length;
+    if (!ReadUInt32(&length) || length > size_ - offset_)
+      return Fail();
+    *bytes = data_ + offset_;
+    *size = length;
+    offset_ += length;
+    return true;
+  }
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(LayerTreeReader);
+};
+
+// Makes the |LayerBuilder| call of |op| with the arguments that follow it.
+// Updates |depth| to the number of layers that have not been popped.
+bool ReadLayer(LayerTreeWriter::Op op,
+               LayerTreeReader* reader,
+               DefaultLayerBuilder* builder,
+               size_t* depth) {
+  using Op = LayerTreeWriter::Op;
+  switch (op) {
+    case Op::kPop:
+      if (*depth == 0)
+        return false;
+      builder->Pop();
+      (*depth)--;
+      return true;
+    case Op::kPushTransform: {
+      SkMatrix matrix;
+      if (!reader->ReadMatrix(&matrix))
+        return false;
+      builder->PushTransform(matrix);
+      (*depth)++;
+      return true;
+    }
+    case Op::kPushClipRect: {
+      SkRect rect;
+      if (!reader->ReadRect(&rect))
+        return false;
+      builder->PushClipRect(rect);
+      (*depth)++;
+      return true;
+    }
+    case Op::kPushClipRoundedRect: {
+      SkRRect rrect;
+      if (!reader->ReadRRect(&rrect))
+        return false;
+      builder->PushClipRoundedRect(rrect);
+      (*depth)++;
+      return true;
+    }
+    case Op::kPushClipPath: {
+      SkPath path;
+      if (!reader->ReadPath(&path))
+        return false;
+      builder->PushClipPath(path);
+      (*depth)++;
+      return true;
+    }
+    case Op::kPushOpacity: {
+      uint32_t alpha;
+      if (!reader->ReadUInt32(&alpha) || alpha > 255)
+        return false;
+      builder->PushOpacity(alpha);
+      (*depth)++;
+      return true;
+    }
+    case Op::kPushColorFilter: {
+      uint32_t color, blend_mode;
+      if (!reader->ReadUInt32(&color) || !reader->ReadUInt32(&blend_mode) ||
+          blend_mode > static_cast<uint32_t>(SkBlendMode::kLastMode)) {
+        return false;
+      }
+      builder->PushColorFilter(color, static_cast<SkBlendMode>(blend_mode));
+      (*depth)++;
+      return true;
+    }
+    case Op::kPushBackdropFilter: {
+      sk_sp<SkImageFilter> filter;
+      SkVector blur_sigma;
+      if (!reader->ReadImageFilter(&filter) || !reader->ReadPoint(&blur_sigma))
+        return false;
+      builder->PushBackdropFilter(std::move(filter), blur_sigma);
+      (*depth)++;
+      return true;
+    }
+    case Op::kPushShaderMask: {
+      sk_sp<SkShader> shader;
+      SkRect rect;
+      uint32_t blend_mode;
+      if (!reader->ReadShader(&shader) || !reader->ReadRect(&rect) ||
+          !reader->ReadUInt32(&blend_mode) ||
+          blend_mode > static_cast<uint32_t>(SkBlendMode::kLastMode)) {
+        return false;
+      }
+      builder->PushShaderMask(std::move(shader), rect,
+                              static_cast<SkBlendMode>(blend_mode));
+      (*depth)++;
+      return true;
+    }
+    case Op::kPushPhysicalModel: {
+      SkRRect rrect;
+      SkScalar elevation, device_pixel_ratio;
+      uint32_t color;
+      if (!reader->ReadRRect(&rrect) || !reader->ReadScalar(&elevation) ||
+          !reader->ReadUInt32(&color) ||
+          !reader->ReadScalar(&device_pixel_ratio)) {
+        return false;
+      }
+      builder->PushPhysicalModel(rrect, elevation, color, device_pixel_ratio);
+      (*depth)++;
+      return true;
+    }
+    case Op::kPushPerformanceOverlay: {
+      uint64_t options;
+      SkRect rect;
+      if (!reader->ReadUInt64(&options) || !reader->ReadRect(&rect))
+        return false;
+      builder->PushPerformanceOverlay(options, rect);
+      return true;
+    }
+    case Op::kPushPicture: {
+      SkPoint offset;
+      bool is_complex, will_change;
+      sk_sp<SkPicture> picture;
+      if (!reader->ReadPoint(&offset) || !reader->ReadBool(&is_complex) ||
+          !reader->ReadBool(&will_change) || !reader->ReadPicture(&picture)) {
+        return false;
+      }
+      builder->PushPicture(offset, std::move(picture), is_complex,
+                           will_change);
+      return true;
+    }
+    case Op::kPushTexture: {
+      SkPoint offset;
+      SkSize size;
+      int64_t texture_id;
+      if (!reader->ReadPoint(&offset) || !reader->ReadSize(&size) ||
+          !reader->ReadInt64(&texture_id)) {
+        return false;
+      }
+      builder->PushTexture(offset, size, texture_id);
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+LayerTreeWriter::LayerTreeWriter(SkPixelSerializer* pixel_serializer)
+    : pixel_serializer_(pixel_serializer) {}
+
+LayerTreeWriter::~LayerTreeWriter() = default;
+
+void LayerTreeWriter::WriteOp(Op op) {
+  const uint8_t value = static_cast<uint8_t>(op);
+  WriteBytes(&value, sizeof(value));
+}
+
+void LayerTreeWriter::WriteBool(bool value) {
+  const uint8_t byte = value ? 1 : 0;
+  WriteBytes(&byte, sizeof(byte));
+}
+
+void LayerTreeWriter::WriteUInt32(uint32_t value) {
+  WriteBytes(&value, sizeof(value));
+}
+
+void LayerTreeWriter::WriteInt64(int64_t value) {
+  WriteBytes(&value, sizeof(value));
+}
+
+void LayerTreeWriter::WriteUInt64(uint64_t value) {
+  WriteBytes(&value, sizeof(value));
+}
+
+void LayerTreeWriter::WriteScalar(SkScalar value) {
+  WriteBytes(&value, sizeof(value));
+}
+
+void LayerTreeWriter::WritePoint(const SkPoint& point) {
+  WriteScalar(point.x());
+  WriteScalar(point.y());
+}
+
+void LayerTreeWriter::WriteSize(const SkSize& size) {
+  WriteScalar(size.width());
+  WriteScalar(size.height());
+}
+
+void LayerTreeWriter::WriteRect(const SkRect& rect) {
+  WriteScalar(rect.left());
+  WriteScalar(rect.top());
+  WriteScalar(rect.right());
+  WriteScalar(rect.bottom());
+}
+
+void LayerTreeWriter::WriteRRect(const SkRRect& rrect) {
+  uint8_t bytes[SkRRect::kSizeInMemory];
+  rrect.writeToMemory(bytes);
+  WriteByteArray(bytes, sizeof(bytes));
+}
+
+void LayerTreeWriter::WriteMatrix(const SkMatrix& matrix) {
+  SkScalar values[9];
+  matrix.get9(values);
+  for (SkScalar value : values) {
+    WriteScalar(value);
+  }
+}
+
+void LayerTreeWriter::WritePath(const SkPath& path) {
+  std::vector<uint8_t> bytes(path.writeToMemory(nullptr));
+  path.writeToMemory(bytes.data());
+  WriteByteArray(bytes.data(), bytes.size());
+}
+
+void LayerTreeWriter::WriteFlattenable(SkFlattenable* flattenable) {
+  if (!flattenable) {
+    WriteByteArray(nullptr, 0);
+    return;
+  }
+  sk_sp<SkData> bytes = SkValidatingSerializeFlattenable(flattenable);
+  WriteByteArray(bytes->data(), bytes->size());
+}
+
+void LayerTreeWriter::WritePicture(SkPicture* picture) {
+  sk_sp<SkData> bytes = picture->serialize(pixel_serializer_);
+  WriteByteArray(bytes->data(), bytes->size());
+}
+
+void LayerTreeWriter::WriteBytes(const void* bytes, size_t size) {
+  const uint8_t* begin = static_cast<const uint8_t*>(bytes);
+  data_.insert(data_.end(), begin, begin + size);
+}
+
+void LayerTreeWriter::WriteByteArray(const void* bytes, size_t size) {
+  WriteUInt32(size);
+  if (size > 0) {
+    WriteBytes(bytes, size);
+  }
+}
+
+sk_sp<SkData> SerializeLayerTree(const LayerTree& tree,
+                                 SkPixelSerializer* pixel_serializer) {
+  // Numbers are copied in host order, see |LayerTreeReader|.
+  FXL_DCHECK(IsLittleEndian());
+
+  LayerTreeWriter writer(pixel_serializer);
+  writer.WriteUInt32(kMagic);
+  writer.WriteUInt32(kVersion);
+  writer.WriteUInt32(tree.frame_size().width());
+  writer.WriteUInt32(tree.frame_size().height());
+  writer.WriteUInt32(tree.rasterizer_tracing_threshold());
+  if (tree.root_layer()) {
+    tree.root_layer()->Serialize(&writer);
+  }
+  return SkData::MakeWithCopy(writer.data().data(), writer.data().size());
+}
+
+std::unique_ptr<LayerTree> DeserializeLayerTree(const void* data,
+                                                size_t size) {
+  if (!IsLittleEndian())
+    return nullptr;
+
+  LayerTreeReader reader(data, size);
+  uint32_t magic, version, width, height, rasterizer_tracing_threshold;
+  if (!reader.ReadUInt32(&magic) || magic != kMagic ||
+      !reader.ReadUInt32(&version) || version != kVersion ||
+      !reader.ReadUInt32(&width) || !reader.ReadUInt32(&height) ||
+      !reader.ReadUInt32(&rasterizer_tracing_threshold)) {
+    return nullptr;
+  }
+
+  DefaultLayerBuilder builder;
+  size_t depth = 0;
+  while (!reader.at_end()) {
+    LayerTreeWriter::Op op;
+    if (!reader.ReadOp(&op) || !ReadLayer(op, &reader, &builder, &depth))
+      return nullptr;
+  }
+  if (depth != 0)
+    return nullptr;
+
+  auto tree = std::make_unique<LayerTree>();
+  tree->set_frame_size(SkISize::Make(width, height));
+  tree->set_rasterizer_tracing_threshold(rasterizer_tracing_threshold);
+  tree->set_root_layer(builder.TakeLayer());
+  return tree;
+}
+
+}  // namespace flow
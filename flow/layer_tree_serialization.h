@@ -0,0 +1,94 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_LAYER_TREE_SERIALIZATION_H_
+#define FLUTTER_FLOW_LAYER_TREE_SERIALIZATION_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "lib/fxl/macros.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkFlattenable.h"
+#include "third_party/skia/include/core/SkMatrix.h"
+#include "third_party/skia/include/core/SkPath.h"
+#include "third_party/skia/include/core/SkPicture.h"
+#include "third_party/skia/include/core/SkPixelSerializer.h"
+#include "third_party/skia/include/core/SkRRect.h"
+#include "third_party/skia/include/core/SkRect.h"
+
+namespace flow {
+
+class LayerTree;
+
+// A layer tree is serialized as a header followed by the |LayerBuilder| calls
+// that rebuild its layers, in the order they are made. Each call is an
+// |Op| followed by its arguments. Containers are followed by their children
+// and a |kPop|. Numbers are little endian, skia objects are byte arrays with
+// a length prefix.
+class LayerTreeWriter {
+ public:
+  enum class Op : uint8_t {
+    kPop = 0,
+    kPushTransform,
+    kPushClipRect,
+    kPushClipRoundedRect,
+    kPushClipPath,
+    kPushOpacity,
+    kPushColorFilter,
+    kPushBackdropFilter,
+    kPushShaderMask,
+    kPushPhysicalModel,
+    kPushPerformanceOverlay,
+    kPushPicture,
+    kPushTexture,
+  };
+
+  // Images in pictures are encoded with |pixel_serializer|, or with Skia's
+  // default encoder if it is null.
+  explicit LayerTreeWriter(SkPixelSerializer* pixel_serializer);
+
+  ~LayerTreeWriter();
+
+  void WriteOp(Op op);
+  void WriteBool(bool value);
+  void WriteUInt32(uint32_t value);
+  void WriteInt64(int64_t value);
+  void WriteUInt64(uint64_t value);
+  void WriteScalar(SkScalar value);
+  void WritePoint(const SkPoint& point);
+  void WriteSize(const SkSize& size);
+  void WriteRect(const SkRect& rect);
+  void WriteRRect(const SkRRect& rrect);
+  void WriteMatrix(const SkMatrix& matrix);
+  void WritePath(const SkPath& path);
+  // Null flattenables are written as empty byte arrays.
+  void WriteFlattenable(SkFlattenable* flattenable);
+  void WritePicture(SkPicture* picture);
+
+  const std::vector<uint8_t>& data() const { return data_; }
+
+ private:
+  SkPixelSerializer* const pixel_serializer_;
+  std::vector<uint8_t> data_;
+
+  void WriteBytes(const void* bytes, size_t size);
+  void WriteByteArray(const void* bytes, size_t size);
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(LayerTreeWriter);
+};
+
+// Serializes the layers, the frame size and the rasterizer tracing threshold
+// of |tree|. External textures are referred to by their identifiers only.
+sk_sp<SkData> SerializeLayerTree(const LayerTree& tree,
+                                 SkPixelSerializer* pixel_serializer = nullptr);
+
+// Returns null if |data| is not a serialized layer tree of this version.
+std::unique_ptr<LayerTree> DeserializeLayerTree(const void* data, size_t size);
+
+}  // namespace flow
+
+#endif  // FLUTTER_FLOW_LAYER_TREE_SERIALIZATION_H_
@@ -0,0 +1,61 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layer_tree_serialization.h"
+
+#include "flutter/flow/layers/default_layer_builder.h"
+#include "flutter/flow/layers/layer_tree.h"
+#include "third_party/gtest/include/gtest/gtest.h"
+
+namespace {
+
+std::unique_ptr<flow::LayerTree> CreateLayerTree() {
+  flow::DefaultLayerBuilder builder;
+  builder.PushTransform(SkMatrix::MakeScale(2));
+  builder.PushClipRoundedRect(
+      SkRRect::MakeRectXY(SkRect::MakeWH(100, 100), 10, 10));
+  builder.PushOpacity(128);
+  builder.PushTexture(SkPoint::Make(10, 20), SkSize::Make(30, 40), 7);
+  builder.Pop();
+  builder.Pop();
+  builder.PushColorFilter(SK_ColorRED, SkBlendMode::kSrcIn);
+  builder.PushPerformanceOverlay(3, SkRect::MakeWH(50, 60));
+  builder.Pop();
+  builder.Pop();
+
+  auto tree = std::make_unique<flow::LayerTree>();
+  tree->set_frame_size(SkISize::Make(200, 300));
+  tree->set_rasterizer_tracing_threshold(2);
+  tree->set_root_layer(builder.TakeLayer());
+  return tree;
+}
+
+}  // namespace
+
+TEST(LayerTreeSerialization, RoundTrips) {
+  std::unique_ptr<flow::LayerTree> tree = CreateLayerTree();
+  sk_sp<SkData> data = flow::SerializeLayerTree(*tree);
+  ASSERT_TRUE(data);
+
+  std::unique_ptr<flow::LayerTree> copy =
+      flow::DeserializeLayerTree(data->data(), data->size());
+  ASSERT_TRUE(copy);
+  ASSERT_EQ(copy->frame_size(), SkISize::Make(200, 300));
+  ASSERT_EQ(copy->rasterizer_tracing_threshold(), 2u);
+  ASSERT_STREQ(copy->root_layer()->type_name(), "TransformLayer");
+
+  // The copy is rebuilt with the same builder calls as the original.
+  sk_sp<SkData> copy_data = flow::SerializeLayerTree(*copy);
+  ASSERT_TRUE(copy_data->equals(data.get()));
+}
+
+TEST(LayerTreeSerialization, RejectsMalformedData) {
+  sk_sp<SkData> data = flow::SerializeLayerTree(*CreateLayerTree());
+
+  ASSERT_FALSE(flow::DeserializeLayerTree(data->data(), data->size() - 1));
+
+  std::vector<uint8_t> corrupt(data->bytes(), data->bytes() + data->size());
+  corrupt[0] ^= 0xff;
+  ASSERT_FALSE(flow::DeserializeLayerTree(corrupt.data(), corrupt.size()));
+}
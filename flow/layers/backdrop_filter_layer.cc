@@ -4,21 +4,193 @@
 
 #include "flutter/flow/layers/backdrop_filter_layer.h"
 
+#include <algorithm>
+#include <cmath>
+
+#include "flutter/flow/layer_tree_serialization.h"
 #include "third_party/skia/include/core/SkImageFilter.h"
+#include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/effects/SkBlurImageFilter.h"
 
 namespace flow {
 
+// Device space sigmas from which blurs are computed at half and quarter
+// resolution. The lost detail is well below what such blurs retain.
+static constexpr SkScalar kHalfResolutionSigma = 8;
+static constexpr SkScalar kQuarterResolutionSigma = 24;
+
+// Makes a blur with |sigma| that, for large |device_sigma|, samples the
+// source down, blurs it with a correspondingly smaller sigma and samples the
+// result back up.
+static sk_sp<SkImageFilter> MakeBlurFilter(const SkVector& sigma,
+                                           SkScalar device_sigma) {
+  SkScalar scale = 1;
+  if (device_sigma >= kQuarterResolutionSigma) {
+    scale = 4;
+  } else if (device_sigma >= kHalfResolutionSigma) {
+    scale = 2;
+  }
+
+  if (scale == 1) {
+    return SkBlurImageFilter::Make(sigma.x(), sigma.y(), nullptr);
+  }
+
+  sk_sp<SkImageFilter> downsample = SkImageFilter::MakeMatrixFilter(
+      SkMatrix::MakeScale(1 / scale), kLow_SkFilterQuality, nullptr);
+  sk_sp<SkImageFilter> blur = SkBlurImageFilter::Make(
+      sigma.x() / scale, sigma.y() / scale, std::move(downsample));
+  return SkImageFilter::MakeMatrixFilter(SkMatrix::MakeScale(scale),
+                                         kLow_SkFilterQuality,
+                                         std::move(blur));
+}
+
+// The largest factor by which |matrix| scales sigmas.
+static SkScalar GetSigmaScale(const SkMatrix& matrix) {
+  return std::max(std::abs(matrix.getScaleX()) + std::abs(matrix.getSkewX()),
+                  std::abs(matrix.getScaleY()) + std::abs(matrix.getSkewY()));
+}
+
 BackdropFilterLayer::BackdropFilterLayer() = default;
 
 BackdropFilterLayer::~BackdropFilterLayer() = default;
 
+void BackdropFilterLayer::Preroll(PrerollContext* context,
+                                  const SkMatrix& matrix) {
+  ContainerLayer::Preroll(context, matrix);
+
+  if (is_blur()) {
+    const SkScalar sigma_scale = GetSigmaScale(matrix);
+    layer_filter_ = MakeBlurFilter(
+        blur_sigma_,
+        std::min(blur_sigma_.x(), blur_sigma_.y()) * sigma_scale);
+  } else {
+    layer_filter_ = filter_;
+  }
+}
+
+void BackdropFilterLayer::Diff(const Layer* old_layer, SkRect* damage) const {
+  const BackdropFilterLayer* old_backdrop =
+      old_layer ? old_layer->as_backdrop_filter_layer() : nullptr;
+
+  // At this point, |damage| holds the damage of everything painted before
+  // this layer, which includes everything the filter reads.
+  backdrop_unchanged_ = is_blur() && old_backdrop != nullptr &&
+                        old_backdrop->blur_sigma_ == blur_sigma_ &&
+                        old_backdrop->device_paint_bounds() ==
+                            device_paint_bounds() &&
+                        !damage->intersects(device_paint_bounds());
+
+  if (!backdrop_unchanged_ || !old_backdrop->cached_backdrop_) {
+    // The filter is computed again. It reads beyond any partial region that
+    // would be repainted, so the whole layer must be.
+    Layer::Diff(old_layer, damage);
+    return;
+  }
+
+  cached_backdrop_ = old_backdrop->cached_backdrop_;
+  cached_backdrop_bounds_ = old_backdrop->cached_backdrop_bounds_;
+
+  // The cached backdrop can be drawn into any part of the layer. So only the
+  // children that changed need to be repainted.
+  DiffChildren(old_backdrop, damage);
+}
+
+bool BackdropFilterLayer::CanCacheBackdrop(const PaintContext& context) const {
+  if (!backdrop_unchanged_ || context.canvas.getSurface() == nullptr ||
+      !context.canvas.getTotalMatrix().isScaleTranslate()) {
+    return false;
+  }
+
+  for (const ContainerLayer* ancestor = parent(); ancestor != nullptr;
+       ancestor = ancestor->parent()) {
+    if (ancestor->MayPaintChildrenOffscreen()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool BackdropFilterLayer::CacheBackdrop(const PaintContext& context) const {
+  TRACE_EVENT0("flutter", "BackdropFilterLayer::CacheBackdrop");
+
+  const SkMatrix& matrix = context.canvas.getTotalMatrix();
+  SkRect device_bounds;
+  matrix.mapRect(&device_bounds, paint_bounds());
+
+  SkSurface* surface = context.canvas.getSurface();
+  SkIRect bounds = device_bounds.roundOut();
+  if (!bounds.intersect(SkIRect::MakeWH(surface->width(), surface->height()))) {
+    return false;
+  }
+
+  sk_sp<SkImage> snapshot = surface->makeImageSnapshot();
+  if (!snapshot) {
+    return false;
+  }
+
+  // The snapshot is unaffected by the matrix of the canvas, so the sigmas
+  // are scaled here instead of by Skia.
+  const SkScalar sigma_scale = GetSigmaScale(matrix);
+  const SkVector device_sigma = SkVector::Make(blur_sigma_.x() * sigma_scale,
+                                               blur_sigma_.y() * sigma_scale);
+  sk_sp<SkImageFilter> filter = MakeBlurFilter(
+      device_sigma, std::min(device_sigma.x(), device_sigma.y()));
+
+  SkIRect filtered_subset;
+  SkIPoint offset;
+  sk_sp<SkImage> filtered = snapshot->makeWithFilter(
+      filter.get(), bounds, bounds, &filtered_subset, &offset);
+  if (!filtered) {
+    return false;
+  }
+
+  cached_backdrop_ = filtered->makeSubset(filtered_subset);
+  cached_backdrop_bounds_ =
+      SkIRect::MakeXYWH(offset.x(), offset.y(), filtered_subset.width(),
+                        filtered_subset.height());
+  return static_cast<bool>(cached_backdrop_);
+}
+
+void BackdropFilterLayer::PaintCachedBackdrop(PaintContext& context) const {
+  SkAutoCanvasRestore save(&context.canvas, true);
+  context.canvas.resetMatrix();
+  context.canvas.drawImage(cached_backdrop_, cached_backdrop_bounds_.left(),
+                           cached_backdrop_bounds_.top());
+}
+
 void BackdropFilterLayer::Paint(PaintContext& context) const {
   TRACE_EVENT0("flutter", "BackdropFilterLayer::Paint");
   FXL_DCHECK(needs_painting());
 
-  Layer::AutoSaveLayer(context, SkCanvas::SaveLayerRec{&paint_bounds(), nullptr,
-                                                       filter_.get(), 0});
+  if (backdrop_unchanged_ && !cached_backdrop_ && CanCacheBackdrop(context)) {
+    CacheBackdrop(context);
+  }
+
+  if (backdrop_unchanged_ && cached_backdrop_) {
+    // Equivalent to the offscreen layer since it is composited with
+    // source-over.
+    PaintCachedBackdrop(context);
+    PaintChildren(context);
+    return;
+  }
+
+  Layer::AutoSaveLayer save(
+      context,
+      SkCanvas::SaveLayerRec{&paint_bounds(), nullptr, layer_filter_.get(), 0});
   PaintChildren(context);
 }
 
+void BackdropFilterLayer::Serialize(LayerTreeWriter* writer) const {
+  writer->WriteOp(LayerTreeWriter::Op::kPushBackdropFilter);
+  writer->WriteFlattenable(filter_.get());
+  writer->WritePoint(blur_sigma_);
+  SerializeChildren(writer);
+}
+
+uint64_t BackdropFilterLayer::PropertiesFingerprint() const {
+  // Never cached since the layer reads back whatever was painted beneath it.
+  return 0;
+}
+
 }  // namespace flow
@@ -6,6 +6,7 @@
 #define FLUTTER_FLOW_LAYERS_BACKDROP_FILTER_LAYER_H_
 
 #include "flutter/flow/layers/container_layer.h"
+#include "third_party/skia/include/core/SkImage.h"
 
 namespace flow {
 
@@ -16,10 +17,52 @@ class BackdropFilterLayer : public ContainerLayer {
 
   void set_filter(sk_sp<SkImageFilter> filter) { filter_ = std::move(filter); }
 
+  // The sigmas of |filter| if it is a Gaussian blur. Blurs with large sigmas
+  // are computed at a reduced resolution and, when layer trees are diffed,
+  // the blurred backdrop is reused while the content beneath is unchanged.
+  void set_blur_sigma(const SkVector& blur_sigma) { blur_sigma_ = blur_sigma; }
+
+  void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
+
+  void Diff(const Layer* old_layer, SkRect* damage) const override;
+
+  const BackdropFilterLayer* as_backdrop_filter_layer() const override {
+    return this;
+  }
+
   void Paint(PaintContext& context) const override;
 
+  void Serialize(LayerTreeWriter* writer) const override;
+
+  const char* type_name() const override { return "BackdropFilterLayer"; }
+
+  bool MayPaintChildrenOffscreen() const override { return true; }
+
+ protected:
+  uint64_t PropertiesFingerprint() const override;
+
  private:
   sk_sp<SkImageFilter> filter_;
+  SkVector blur_sigma_ = SkVector::Make(0, 0);
+  // The filter used for the offscreen layer. Downsampled for large blurs.
+  sk_sp<SkImageFilter> layer_filter_;
+  // Whether the content beneath the layer is the same as in the previously
+  // rasterized frame. Set by |Diff|.
+  mutable bool backdrop_unchanged_ = false;
+  // The filtered backdrop and its device space bounds. Handed over from the
+  // layer in the previous frame while the backdrop is unchanged.
+  mutable sk_sp<SkImage> cached_backdrop_;
+  mutable SkIRect cached_backdrop_bounds_ = SkIRect::MakeEmpty();
+
+  bool is_blur() const { return !blur_sigma_.isZero(); }
+
+  // Whether the backdrop can be read from the surface of the canvas, which is
+  // only the case if no ancestor paints into an offscreen layer.
+  bool CanCacheBackdrop(const PaintContext& context) const;
+
+  bool CacheBackdrop(const PaintContext& context) const;
+
+  void PaintCachedBackdrop(PaintContext& context) const;
 
   FXL_DISALLOW_COPY_AND_ASSIGN(BackdropFilterLayer);
 };
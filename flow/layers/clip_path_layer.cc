@@ -4,6 +4,8 @@
 
 #include "flutter/flow/layers/clip_path_layer.h"
 
+#include "flutter/flow/layer_tree_serialization.h"
+
 #if defined(OS_FUCHSIA)
 
 #include "lib/ui/scenic/fidl_helpers.h"  // nogncheck
@@ -16,9 +18,29 @@ ClipPathLayer::ClipPathLayer() = default;
 
 ClipPathLayer::~ClipPathLayer() = default;
 
+uint64_t ClipPathLayer::PropertiesFingerprint() const {
+  uint64_t fingerprint = CombineFingerprint(0, FingerprintTag::kClipPath);
+  return CombineFingerprint(fingerprint, clip_path_.getGenerationID());
+}
+
+bool ClipPathLayer::ShouldRasterCacheChildren() const {
+  return true;
+}
+
 void ClipPathLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
+  SkRect ancestor_clip_rect;
+  const bool has_ancestor_clip =
+      GetAncestorClipRect(*context, matrix, &ancestor_clip_rect);
+
+  const bool is_rect =
+      !clip_path_.isInverseFillType() && clip_path_.isRect(nullptr);
+
   SkRect child_paint_bounds = SkRect::MakeEmpty();
-  PrerollChildren(context, matrix, &child_paint_bounds);
+  PrerollClippedChildren(context, matrix, clip_path_.getBounds(), is_rect,
+                         &child_paint_bounds);
+
+  needs_clip_ = !has_ancestor_clip ||
+                !clip_path_.conservativelyContainsRect(ancestor_clip_rect);
 
   if (child_paint_bounds.intersect(clip_path_.getBounds())) {
     set_paint_bounds(child_paint_bounds);
@@ -33,24 +55,65 @@ void ClipPathLayer::UpdateScene(SceneUpdateContext& context) {
   // TODO(MZ-140): Must be able to specify paths as shapes to nodes.
   //               Treating the shape as a rectangle for now.
   auto bounds = clip_path_.getBounds();
-  scenic_lib::Rectangle shape(context.session(),  // session
-                              bounds.width(),     //  width
-                              bounds.height()     //  height
-  );
-
-  SceneUpdateContext::Clip clip(context, shape, bounds);
+  SceneUpdateContext::Clip clip(
+      context, context.GetRectangle(bounds.width(), bounds.height()), bounds);
   UpdateSceneChildren(context);
 }
 
 #endif  // defined(OS_FUCHSIA)
 
+void ClipPathLayer::ClipCanvas(SkCanvas& canvas) const {
+  // Rounded rect clips are analytic on the GPU while arbitrary paths need
+  // the stencil buffer.
+  SkRRect rrect;
+  SkRect oval;
+  if (clip_path_.isInverseFillType()) {
+    canvas.clipPath(clip_path_, true);
+  } else if (clip_path_.isRRect(&rrect)) {
+    canvas.clipRRect(rrect, true);
+  } else if (clip_path_.isOval(&oval)) {
+    canvas.clipRRect(SkRRect::MakeOval(oval), true);
+  } else {
+    canvas.clipPath(clip_path_, true);
+  }
+}
+
 void ClipPathLayer::Paint(PaintContext& context) const {
   TRACE_EVENT0("flutter", "ClipPathLayer::Paint");
   FXL_DCHECK(needs_painting());
 
+  if (!needs_clip_) {
+    PaintChildren(context);
+    return;
+  }
+
+  SkRect rect;
+  if (!clip_path_.isInverseFillType() && clip_path_.isRect(&rect)) {
+    // Clipped like by a ClipRectLayer, which needs no offscreen layer.
+    SkAutoCanvasRestore save(&context.canvas, true);
+    context.canvas.clipRect(rect);
+    PaintChildren(context);
+    return;
+  }
+
+  if (children_raster_cached()) {
+    // A single image draw cannot exhibit conflation artifacts along the
+    // anti-aliased clip edge. So the offscreen layer is not necessary.
+    SkAutoCanvasRestore save(&context.canvas, true);
+    ClipCanvas(context.canvas);
+    PaintChildren(context);
+    return;
+  }
+
   Layer::AutoSaveLayer save(context, paint_bounds(), nullptr);
-  context.canvas.clipPath(clip_path_, true);
+  ClipCanvas(context.canvas);
   PaintChildren(context);
 }
 
+void ClipPathLayer::Serialize(LayerTreeWriter* writer) const {
+  writer->WriteOp(LayerTreeWriter::Op::kPushClipPath);
+  writer->WritePath(clip_path_);
+  SerializeChildren(writer);
+}
+
 }  // namespace flow
@@ -20,12 +20,25 @@ class ClipPathLayer : public ContainerLayer {
 
   void Paint(PaintContext& context) const override;
 
+  void Serialize(LayerTreeWriter* writer) const override;
+
+  const char* type_name() const override { return "ClipPathLayer"; }
+
+  bool MayPaintChildrenOffscreen() const override { return true; }
+
 #if defined(OS_FUCHSIA)
   void UpdateScene(SceneUpdateContext& context) override;
 #endif  // defined(OS_FUCHSIA)
 
+ protected:
+  uint64_t PropertiesFingerprint() const override;
+  bool ShouldRasterCacheChildren() const override;
+
  private:
   SkPath clip_path_;
+  bool needs_clip_ = true;
+
+  void ClipCanvas(SkCanvas& canvas) const;
 
   FXL_DISALLOW_COPY_AND_ASSIGN(ClipPathLayer);
 };
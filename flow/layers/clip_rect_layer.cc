@@ -4,15 +4,33 @@
 
 #include "flutter/flow/layers/clip_rect_layer.h"
 
+#include "flutter/flow/layer_tree_serialization.h"
+
 namespace flow {
 
 ClipRectLayer::ClipRectLayer() = default;
 
 ClipRectLayer::~ClipRectLayer() = default;
 
+uint64_t ClipRectLayer::PropertiesFingerprint() const {
+  uint64_t fingerprint = CombineFingerprint(0, FingerprintTag::kClipRect);
+  return CombineFingerprint(fingerprint, clip_rect_);
+}
+
 void ClipRectLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
+  SkRect ancestor_clip_rect;
+  const bool has_ancestor_clip =
+      GetAncestorClipRect(*context, matrix, &ancestor_clip_rect);
+
   SkRect child_paint_bounds = SkRect::MakeEmpty();
-  PrerollChildren(context, matrix, &child_paint_bounds);
+  PrerollClippedChildren(context, matrix, clip_rect_, true,
+                         &child_paint_bounds);
+
+  // The clip has no effect if the ancestors already clip to a rect within
+  // it. The paint bounds of the children are not trusted for this since
+  // pictures may draw outside of their cull rects.
+  needs_clip_ =
+      !has_ancestor_clip || !clip_rect_.contains(ancestor_clip_rect);
 
   if (child_paint_bounds.intersect(clip_rect_)) {
     set_paint_bounds(child_paint_bounds);
@@ -24,12 +42,9 @@ void ClipRectLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
 void ClipRectLayer::UpdateScene(SceneUpdateContext& context) {
   FXL_DCHECK(needs_system_composite());
 
-  scenic_lib::Rectangle shape(context.session(),   // session
-                              clip_rect_.width(),  //  width
-                              clip_rect_.height()  //  height
-  );
-
-  SceneUpdateContext::Clip clip(context, shape, clip_rect_);
+  SceneUpdateContext::Clip clip(
+      context, context.GetRectangle(clip_rect_.width(), clip_rect_.height()),
+      clip_rect_);
   UpdateSceneChildren(context);
 }
 
@@ -39,9 +54,20 @@ void ClipRectLayer::Paint(PaintContext& context) const {
   TRACE_EVENT0("flutter", "ClipRectLayer::Paint");
   FXL_DCHECK(needs_painting());
 
+  if (!needs_clip_) {
+    PaintChildren(context);
+    return;
+  }
+
   SkAutoCanvasRestore save(&context.canvas, true);
   context.canvas.clipRect(paint_bounds());
   PaintChildren(context);
 }
 
+void ClipRectLayer::Serialize(LayerTreeWriter* writer) const {
+  writer->WriteOp(LayerTreeWriter::Op::kPushClipRect);
+  writer->WriteRect(clip_rect_);
+  SerializeChildren(writer);
+}
+
 }  // namespace flow
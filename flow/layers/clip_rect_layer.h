@@ -19,12 +19,20 @@ class ClipRectLayer : public ContainerLayer {
   void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
   void Paint(PaintContext& context) const override;
 
+  void Serialize(LayerTreeWriter* writer) const override;
+
+  const char* type_name() const override { return "ClipRectLayer"; }
+
 #if defined(OS_FUCHSIA)
   void UpdateScene(SceneUpdateContext& context) override;
 #endif  // defined(OS_FUCHSIA)
 
+ protected:
+  uint64_t PropertiesFingerprint() const override;
+
  private:
   SkRect clip_rect_;
+  bool needs_clip_ = true;
 
   FXL_DISALLOW_COPY_AND_ASSIGN(ClipRectLayer);
 };
@@ -4,15 +4,35 @@
 
 #include "flutter/flow/layers/clip_rrect_layer.h"
 
+#include "flutter/flow/layer_tree_serialization.h"
+
 namespace flow {
 
 ClipRRectLayer::ClipRRectLayer() = default;
 
 ClipRRectLayer::~ClipRRectLayer() = default;
 
+uint64_t ClipRRectLayer::PropertiesFingerprint() const {
+  uint64_t fingerprint = CombineFingerprint(0, FingerprintTag::kClipRRect);
+  return CombineFingerprint(fingerprint, clip_rrect_);
+}
+
+bool ClipRRectLayer::ShouldRasterCacheChildren() const {
+  return true;
+}
+
 void ClipRRectLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
+  SkRect ancestor_clip_rect;
+  const bool has_ancestor_clip =
+      GetAncestorClipRect(*context, matrix, &ancestor_clip_rect);
+
   SkRect child_paint_bounds = SkRect::MakeEmpty();
-  PrerollChildren(context, matrix, &child_paint_bounds);
+  PrerollClippedChildren(context, matrix, clip_rrect_.getBounds(),
+                         clip_rrect_.isRect(), &child_paint_bounds);
+
+  // Skipping a clip that has no effect also saves the offscreen layer.
+  needs_clip_ =
+      !has_ancestor_clip || !clip_rrect_.contains(ancestor_clip_rect);
 
   if (child_paint_bounds.intersect(clip_rrect_.getBounds())) {
     set_paint_bounds(child_paint_bounds);
@@ -24,19 +44,9 @@ void ClipRRectLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
 void ClipRRectLayer::UpdateScene(SceneUpdateContext& context) {
   FXL_DCHECK(needs_system_composite());
 
-  // TODO(MZ-137): Need to be able to express the radii as vectors.
-  scenic_lib::RoundedRectangle shape(
-      context.session(),                                   // session
-      clip_rrect_.width(),                                 //  width
-      clip_rrect_.height(),                                //  height
-      clip_rrect_.radii(SkRRect::kUpperLeft_Corner).x(),   //  top_left_radius
-      clip_rrect_.radii(SkRRect::kUpperRight_Corner).x(),  //  top_right_radius
-      clip_rrect_.radii(SkRRect::kLowerRight_Corner)
-          .x(),                                          //  bottom_right_radius
-      clip_rrect_.radii(SkRRect::kLowerLeft_Corner).x()  //  bottom_left_radius
-  );
-
-  SceneUpdateContext::Clip clip(context, shape, clip_rrect_.getBounds());
+  SceneUpdateContext::Clip clip(context,
+                                context.GetRoundedRectangle(clip_rrect_),
+                                clip_rrect_.getBounds());
   UpdateSceneChildren(context);
 }
 
@@ -46,9 +56,29 @@ void ClipRRectLayer::Paint(PaintContext& context) const {
   TRACE_EVENT0("flutter", "ClipRRectLayer::Paint");
   FXL_DCHECK(needs_painting());
 
+  if (!needs_clip_) {
+    PaintChildren(context);
+    return;
+  }
+
+  if (children_raster_cached()) {
+    // A single image draw cannot exhibit conflation artifacts along the
+    // anti-aliased clip edge. So the offscreen layer is not necessary.
+    SkAutoCanvasRestore save(&context.canvas, true);
+    context.canvas.clipRRect(clip_rrect_, true);
+    PaintChildren(context);
+    return;
+  }
+
   Layer::AutoSaveLayer save(context, paint_bounds(), nullptr);
   context.canvas.clipRRect(clip_rrect_, true);
   PaintChildren(context);
 }
 
+void ClipRRectLayer::Serialize(LayerTreeWriter* writer) const {
+  writer->WriteOp(LayerTreeWriter::Op::kPushClipRoundedRect);
+  writer->WriteRRect(clip_rrect_);
+  SerializeChildren(writer);
+}
+
 }  // namespace flow
@@ -20,12 +20,23 @@ class ClipRRectLayer : public ContainerLayer {
 
   void Paint(PaintContext& context) const override;
 
+  void Serialize(LayerTreeWriter* writer) const override;
+
+  const char* type_name() const override { return "ClipRRectLayer"; }
+
+  bool MayPaintChildrenOffscreen() const override { return true; }
+
 #if defined(OS_FUCHSIA)
   void UpdateScene(SceneUpdateContext& context) override;
 #endif  // defined(OS_FUCHSIA)
 
+ protected:
+  uint64_t PropertiesFingerprint() const override;
+  bool ShouldRasterCacheChildren() const override;
+
  private:
   SkRRect clip_rrect_;
+  bool needs_clip_ = true;
 
   FXL_DISALLOW_COPY_AND_ASSIGN(ClipRRectLayer);
 };
@@ -4,23 +4,80 @@
 
 #include "flutter/flow/layers/color_filter_layer.h"
 
+#include "flutter/flow/layer_tree_serialization.h"
+#include "flutter/flow/layers/layer_profiler.h"
+
 namespace flow {
 
 ColorFilterLayer::ColorFilterLayer() = default;
 
 ColorFilterLayer::~ColorFilterLayer() = default;
 
+uint64_t ColorFilterLayer::PropertiesFingerprint() const {
+  uint64_t fingerprint = CombineFingerprint(0, FingerprintTag::kColorFilter);
+  fingerprint = CombineFingerprint(fingerprint, color_);
+  return CombineFingerprint(fingerprint, blend_mode_);
+}
+
+bool ColorFilterLayer::ShouldRasterCacheChildren() const {
+  return true;
+}
+
+const Layer* ColorFilterLayer::GetChildToFilter() const {
+  const Layer* child = nullptr;
+  for (auto& layer : layers()) {
+    if (!layer->needs_painting()) {
+      continue;
+    }
+    if (child) {
+      return nullptr;
+    }
+    child = layer.get();
+  }
+  return child && child->CanPaintWithColorFilter() ? child : nullptr;
+}
+
 void ColorFilterLayer::Paint(PaintContext& context) const {
   TRACE_EVENT0("flutter", "ColorFilterLayer::Paint");
   FXL_DCHECK(needs_painting());
 
   sk_sp<SkColorFilter> color_filter =
       SkColorFilter::MakeModeFilter(color_, blend_mode_);
+  if (!color_filter) {
+    // The blend mode leaves the colors unchanged.
+    PaintChildren(context);
+    return;
+  }
+
   SkPaint paint;
-  paint.setColorFilter(std::move(color_filter));
+  paint.setColorFilter(color_filter);
+
+  // A filter that leaves transparent pixels transparent only changes the
+  // pixels the children draw. Applying it to the single image the children
+  // are drawn as is then equivalent to compositing an offscreen layer.
+  if (!color_filter->affectsTransparentBlack()) {
+    if (children_raster_cached()) {
+      PaintCachedChildren(context, &paint);
+      return;
+    }
+    if (const Layer* child = GetChildToFilter()) {
+      if (child->device_paint_bounds().intersects(context.cull_rect)) {
+        LayerProfiler::ScopedLayer profile(context, *child);
+        child->PaintWithColorFilter(context, std::move(color_filter));
+      }
+      return;
+    }
+  }
 
-  Layer::AutoSaveLayer(context, paint_bounds(), nullptr);
+  Layer::AutoSaveLayer save(context, paint_bounds(), &paint);
   PaintChildren(context);
 }
 
+void ColorFilterLayer::Serialize(LayerTreeWriter* writer) const {
+  writer->WriteOp(LayerTreeWriter::Op::kPushColorFilter);
+  writer->WriteUInt32(color_);
+  writer->WriteUInt32(static_cast<uint32_t>(blend_mode_));
+  SerializeChildren(writer);
+}
+
 }  // namespace flow
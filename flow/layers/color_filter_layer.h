@@ -20,10 +20,24 @@ class ColorFilterLayer : public ContainerLayer {
 
   void Paint(PaintContext& context) const override;
 
+  void Serialize(LayerTreeWriter* writer) const override;
+
+  const char* type_name() const override { return "ColorFilterLayer"; }
+
+  bool MayPaintChildrenOffscreen() const override { return true; }
+
+ protected:
+  uint64_t PropertiesFingerprint() const override;
+  bool ShouldRasterCacheChildren() const override;
+
  private:
   SkColor color_;
   SkBlendMode blend_mode_;
 
+  // The only child that needs painting, if it can take |color_filter|
+  // directly. Null otherwise.
+  const Layer* GetChildToFilter() const;
+
   FXL_DISALLOW_COPY_AND_ASSIGN(ColorFilterLayer);
 };
 
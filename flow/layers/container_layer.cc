@@ -4,6 +4,11 @@
 
 #include "flutter/flow/layers/container_layer.h"
 
+#include <algorithm>
+
+#include "flutter/flow/layer_tree_serialization.h"
+#include "flutter/flow/layers/layer_profiler.h"
+
 namespace flow {
 
 ContainerLayer::ContainerLayer() {}
@@ -15,6 +20,14 @@ void ContainerLayer::Add(std::unique_ptr<Layer> layer) {
   layers_.push_back(std::move(layer));
 }
 
+std::unique_ptr<Layer> ContainerLayer::TakeLastLayer() {
+  FXL_DCHECK(!layers_.empty());
+  std::unique_ptr<Layer> layer = std::move(layers_.back());
+  layers_.pop_back();
+  layer->set_parent(nullptr);
+  return layer;
+}
+
 void ContainerLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
   TRACE_EVENT0("flutter", "ContainerLayer::Preroll");
 
@@ -23,27 +36,234 @@ void ContainerLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
   set_paint_bounds(child_paint_bounds);
 }
 
+uint64_t ContainerLayer::Fingerprint() const {
+  const uint64_t children_fingerprint = ChildrenFingerprint();
+  const uint64_t properties_fingerprint = PropertiesFingerprint();
+  if (children_fingerprint == 0 || properties_fingerprint == 0) {
+    return 0;
+  }
+  return CombineFingerprint(children_fingerprint, properties_fingerprint);
+}
+
+uint64_t ContainerLayer::PropertiesFingerprint() const {
+  return CombineFingerprint(0, FingerprintTag::kContainer);
+}
+
+void ContainerLayer::Diff(const Layer* old_layer, SkRect* damage) const {
+  if (IsUnchangedFrom(old_layer)) {
+    return;
+  }
+
+  const ContainerLayer* old_container =
+      old_layer ? old_layer->as_container_layer() : nullptr;
+  const uint64_t properties_fingerprint = PropertiesFingerprint();
+
+  if (old_container == nullptr || properties_fingerprint == 0 ||
+      properties_fingerprint != old_container->PropertiesFingerprint()) {
+    // The properties applied to the children changed (or cannot be compared).
+    // Everything painted by either layer is damaged.
+    Layer::Diff(old_layer, damage);
+    return;
+  }
+
+  // The properties are identical. So only children that changed contribute to
+  // the damage.
+  DiffChildren(old_container, damage);
+}
+
+void ContainerLayer::DiffChildren(const ContainerLayer* old_container,
+                                  SkRect* damage) const {
+  // Children are matched by their position in the container.
+  const auto& old_layers = old_container->layers();
+  const size_t count = std::max(layers_.size(), old_layers.size());
+  for (size_t i = 0; i < count; i++) {
+    const Layer* old_child =
+        i < old_layers.size() ? old_layers[i].get() : nullptr;
+    if (i < layers_.size()) {
+      layers_[i]->Diff(old_child, damage);
+    } else {
+      damage->join(old_child->device_paint_bounds());
+    }
+  }
+}
+
+void ContainerLayer::Serialize(LayerTreeWriter* writer) const {
+  writer->WriteOp(LayerTreeWriter::Op::kPushTransform);
+  writer->WriteMatrix(SkMatrix::I());
+  SerializeChildren(writer);
+}
+
+size_t ContainerLayer::GetMemoryUsage() const {
+  size_t bytes = sizeof(ContainerLayer) +
+                 layers_.capacity() * sizeof(std::unique_ptr<Layer>);
+  for (const auto& layer : layers_) {
+    bytes += layer->GetMemoryUsage();
+  }
+  return bytes;
+}
+
+void ContainerLayer::SerializeChildren(LayerTreeWriter* writer) const {
+  for (const auto& layer : layers_) {
+    layer->Serialize(writer);
+  }
+  writer->WriteOp(LayerTreeWriter::Op::kPop);
+}
+
+uint64_t ContainerLayer::ChildrenFingerprint() const {
+  if (layers_.empty()) {
+    return 0;
+  }
+
+  uint64_t fingerprint = 0;
+  for (auto& layer : layers_) {
+    const uint64_t child_fingerprint = layer->Fingerprint();
+    if (child_fingerprint == 0) {
+      return 0;
+    }
+    fingerprint = CombineFingerprint(fingerprint, child_fingerprint);
+  }
+  return fingerprint;
+}
+
+bool ContainerLayer::ShouldRasterCacheChildren() const {
+  return false;
+}
+
 void ContainerLayer::PrerollChildren(PrerollContext* context,
                                      const SkMatrix& child_matrix,
                                      SkRect* child_paint_bounds) {
+  children_raster_cache_result_ = RasterCacheResult();
+
+  RasterCache* cache = context->raster_cache;
+  const uint64_t children_fingerprint =
+      (cache && ShouldRasterCacheChildren()) ? ChildrenFingerprint() : 0;
+
+  // If the children are already cached as a whole, there is no point in the
+  // children keeping their own raster cache entries alive.
+  RasterCache* child_cache =
+      cache && cache->HasImage(children_fingerprint, child_matrix) ? nullptr
+                                                                   : cache;
+
   for (auto& layer : layers_) {
     PrerollContext child_context = *context;
+    child_context.raster_cache = child_cache;
+    if (ShouldRasterCacheChildren()) {
+      child_context.device_clip_rect = SkRect::MakeLargest();
+    }
     layer->Preroll(&child_context, child_matrix);
 
     if (layer->needs_system_composite()) {
       set_needs_system_composite(true);
     }
     child_paint_bounds->join(layer->paint_bounds());
+
+    SkRect device_paint_bounds;
+    child_matrix.mapRect(&device_paint_bounds, layer->paint_bounds());
+    layer->set_device_paint_bounds(device_paint_bounds);
+  }
+
+  if (children_fingerprint == 0 || needs_system_composite()) {
+    return;
   }
+
+  SkRect device_children_bounds;
+  child_matrix.mapRect(&device_children_bounds, *child_paint_bounds);
+  if (!device_children_bounds.intersects(context->cull_rect)) {
+    return;
+  }
+
+  children_raster_cache_result_ = cache->GetPrerolledImage(
+      context->gr_context, children_fingerprint, *child_paint_bounds,
+      child_matrix, context->dst_color_space, [this, context](SkCanvas* canvas) {
+        PaintContext paint_context = {*canvas,
+                                      SkRect::MakeLargest(),
+                                      context->frame_time,
+                                      context->engine_time,
+                                      context->gpu_time,
+                                      context->memory_usage,
+                                      context->image_memory_usage,
+                                      context->texture_registry,
+                                      nullptr,
+                                      nullptr,
+                                      context->checkerboard_offscreen_layers};
+        for (auto& layer : layers_) {
+          if (layer->needs_painting()) {
+            layer->Paint(paint_context);
+          }
+        }
+      });
+}
+
+void ContainerLayer::PrerollClippedChildren(PrerollContext* context,
+                                            const SkMatrix& child_matrix,
+                                            const SkRect& clip_bounds,
+                                            bool is_rect_clip,
+                                            SkRect* child_paint_bounds) {
+  const SkRect cull_rect = context->cull_rect;
+  const SkRect device_clip_rect = context->device_clip_rect;
+  SkRect device_clip_bounds;
+  child_matrix.mapRect(&device_clip_bounds, clip_bounds);
+  if (!context->cull_rect.intersect(device_clip_bounds)) {
+    context->cull_rect.setEmpty();
+  }
+  if (is_rect_clip && child_matrix.rectStaysRect() &&
+      !context->device_clip_rect.intersect(device_clip_bounds)) {
+    context->device_clip_rect.setEmpty();
+  }
+  PrerollChildren(context, child_matrix, child_paint_bounds);
+  context->cull_rect = cull_rect;
+  context->device_clip_rect = device_clip_rect;
+}
+
+bool ContainerLayer::GetAncestorClipRect(const PrerollContext& context,
+                                         const SkMatrix& matrix,
+                                         SkRect* local_clip_rect) {
+  if (context.device_clip_rect == SkRect::MakeLargest() ||
+      !matrix.rectStaysRect()) {
+    return false;
+  }
+
+  SkMatrix inverse;
+  if (!matrix.invert(&inverse)) {
+    return false;
+  }
+
+  inverse.mapRect(local_clip_rect, context.device_clip_rect);
+  return true;
+}
+
+void ContainerLayer::PaintCachedChildren(PaintContext& context,
+                                         const SkPaint* paint) const {
+  FXL_DCHECK(children_raster_cached());
+
+  SkPaint image_paint;
+  if (paint) {
+    image_paint = *paint;
+  }
+  image_paint.setFilterQuality(kLow_SkFilterQuality);
+  context.canvas.drawImageRect(
+      children_raster_cache_result_.image(),             // image
+      children_raster_cache_result_.source_rect(),       // source
+      children_raster_cache_result_.destination_rect(),  // destination
+      &image_paint,                                      // paint
+      SkCanvas::kStrict_SrcRectConstraint                // source constraint
+  );
 }
 
 void ContainerLayer::PaintChildren(PaintContext& context) const {
   FXL_DCHECK(needs_painting());
 
+  if (children_raster_cached()) {
+    PaintCachedChildren(context, nullptr);
+    return;
+  }
+
   // Intentionally not tracing here as there should be no self-time
   // and the trace event on this common function has a small overhead.
   for (auto& layer : layers_) {
-    if (layer->needs_painting()) {
+    if (layer->needs_painting() &&
+        layer->device_paint_bounds().intersects(context.cull_rect)) {
+      LayerProfiler::ScopedLayer profile(context, *layer);
       layer->Paint(context);
     }
   }
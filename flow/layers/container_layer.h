@@ -17,26 +17,100 @@ class ContainerLayer : public Layer {
 
   void Add(std::unique_ptr<Layer> layer);
 
+  // Removes the most recently added child and returns it.
+  std::unique_ptr<Layer> TakeLastLayer();
+
   void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
 
+  // Combines the fingerprints of the children with |PropertiesFingerprint|.
+  uint64_t Fingerprint() const override;
+
+  void Diff(const Layer* old_layer, SkRect* damage) const override;
+
+  // Plain containers are rebuilt as identity transforms.
+  void Serialize(LayerTreeWriter* writer) const override;
+
+  size_t GetMemoryUsage() const override;
+
+  const ContainerLayer* as_container_layer() const override { return this; }
+
+  const char* type_name() const override { return "ContainerLayer"; }
+
 #if defined(OS_FUCHSIA)
   void UpdateScene(SceneUpdateContext& context) override;
 #endif  // defined(OS_FUCHSIA)
 
   const std::vector<std::unique_ptr<Layer>>& layers() const { return layers_; }
 
+  // Whether the children may be painted into an offscreen layer instead of
+  // directly into the canvas of the frame.
+  virtual bool MayPaintChildrenOffscreen() const { return false; }
+
  protected:
+  // Prerolls the children and, if |ShouldRasterCacheChildren| allows it,
+  // attempts to replace the children with a single raster cached image.
   void PrerollChildren(PrerollContext* context,
                        const SkMatrix& child_matrix,
                        SkRect* child_paint_bounds);
+
+  // Like |PrerollChildren| but narrows the cull rect of |context| to
+  // |clip_bounds| (in the coordinate space of |child_matrix|) for the
+  // children. |is_rect_clip| indicates that the clip is exactly
+  // |clip_bounds|, which also narrows the device clip rect.
+  void PrerollClippedChildren(PrerollContext* context,
+                              const SkMatrix& child_matrix,
+                              const SkRect& clip_bounds,
+                              bool is_rect_clip,
+                              SkRect* child_paint_bounds);
+
+  // Sets |local_clip_rect| to the device clip rect of |context| in the
+  // coordinate space of |matrix|. Returns false if there is no known clip
+  // rect or it is not a rect in that space. A clip that contains the rect
+  // is redundant.
+  static bool GetAncestorClipRect(const PrerollContext& context,
+                                  const SkMatrix& matrix,
+                                  SkRect* local_clip_rect);
+
+  // Paints the children or their raster cached image if one is available.
+  // Children outside of the cull rect of |context| are skipped.
   void PaintChildren(PaintContext& context) const;
 
+  // Accumulates the damage of the children compared to the children of
+  // |old_container| at the same positions.
+  void DiffChildren(const ContainerLayer* old_container, SkRect* damage) const;
+
+  // Writes the children followed by the |Pop| that ends this layer.
+  void SerializeChildren(LayerTreeWriter* writer) const;
+
+  // The combined fingerprint of all children. Zero if any of the children
+  // cannot be fingerprinted.
+  uint64_t ChildrenFingerprint() const;
+
+  // Identifies the properties this layer applies to its children (a
+  // transform, clip, alpha, etc.) independently of the children themselves.
+  // Zero if the effect of the properties cannot be identified.
+  virtual uint64_t PropertiesFingerprint() const;
+
+  // Subclasses that pay for an offscreen layer or an anti-aliased clip every
+  // frame may opt into caching their children as a single image. The raster
+  // cache then decides whether the children are stable enough to do so.
+  virtual bool ShouldRasterCacheChildren() const;
+
+  bool children_raster_cached() const {
+    return children_raster_cache_result_.is_valid();
+  }
+
+  // Draws the raster cached image of the children with the given |paint|.
+  // Only valid if |children_raster_cached| is true.
+  void PaintCachedChildren(PaintContext& context, const SkPaint* paint) const;
+
 #if defined(OS_FUCHSIA)
   void UpdateSceneChildren(SceneUpdateContext& context);
 #endif  // defined(OS_FUCHSIA)
 
  private:
   std::vector<std::unique_ptr<Layer>> layers_;
+  RasterCacheResult children_raster_cache_result_;
 
   FXL_DISALLOW_COPY_AND_ASSIGN(ContainerLayer);
 };
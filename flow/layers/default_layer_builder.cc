@@ -16,7 +16,9 @@
 #include "flutter/flow/layers/performance_overlay_layer.h"
 #include "flutter/flow/layers/physical_model_layer.h"
 #include "flutter/flow/layers/picture_layer.h"
+#include "flutter/flow/layers/retained_layer.h"
 #include "flutter/flow/layers/shader_mask_layer.h"
+#include "flutter/flow/layers/texture_layer.h"
 #include "flutter/flow/layers/transform_layer.h"
 
 #if defined(OS_FUCHSIA)
@@ -25,7 +27,8 @@
 
 namespace flow {
 
-DefaultLayerBuilder::DefaultLayerBuilder() {
+DefaultLayerBuilder::DefaultLayerBuilder()
+    : arena_(fxl::MakeRefCounted<LayerArena>()) {
   cull_rects_.push(SkRect::MakeLargest());
 }
 
@@ -40,7 +43,7 @@ void DefaultLayerBuilder::PushTransform(const SkMatrix& sk_matrix) {
     cullRect = SkRect::MakeLargest();
   }
 
-  auto layer = std::make_unique<flow::TransformLayer>();
+  auto layer = MakeLayer<flow::TransformLayer>();
   layer->set_transform(sk_matrix);
   PushLayer(std::move(layer), cullRect);
 }
@@ -50,7 +53,7 @@ void DefaultLayerBuilder::PushClipRect(const SkRect& clipRect) {
   if (!cullRect.intersect(clipRect, cull_rects_.top())) {
     cullRect = SkRect::MakeEmpty();
   }
-  auto layer = std::make_unique<flow::ClipRectLayer>();
+  auto layer = MakeLayer<flow::ClipRectLayer>();
   layer->set_clip_rect(clipRect);
   PushLayer(std::move(layer), cullRect);
 }
@@ -60,7 +63,7 @@ void DefaultLayerBuilder::PushClipRoundedRect(const SkRRect& rrect) {
   if (!cullRect.intersect(rrect.rect(), cull_rects_.top())) {
     cullRect = SkRect::MakeEmpty();
   }
-  auto layer = std::make_unique<flow::ClipRRectLayer>();
+  auto layer = MakeLayer<flow::ClipRRectLayer>();
   layer->set_clip_rrect(rrect);
   PushLayer(std::move(layer), cullRect);
 }
@@ -70,35 +73,37 @@ void DefaultLayerBuilder::PushClipPath(const SkPath& path) {
   if (!cullRect.intersect(path.getBounds(), cull_rects_.top())) {
     cullRect = SkRect::MakeEmpty();
   }
-  auto layer = std::make_unique<flow::ClipPathLayer>();
+  auto layer = MakeLayer<flow::ClipPathLayer>();
   layer->set_clip_path(path);
   PushLayer(std::move(layer), cullRect);
 }
 
 void DefaultLayerBuilder::PushOpacity(int alpha) {
-  auto layer = std::make_unique<flow::OpacityLayer>();
+  auto layer = MakeLayer<flow::OpacityLayer>();
   layer->set_alpha(alpha);
   PushLayer(std::move(layer), cull_rects_.top());
 }
 
 void DefaultLayerBuilder::PushColorFilter(SkColor color,
                                           SkBlendMode blend_mode) {
-  auto layer = std::make_unique<flow::ColorFilterLayer>();
+  auto layer = MakeLayer<flow::ColorFilterLayer>();
   layer->set_color(color);
   layer->set_blend_mode(blend_mode);
   PushLayer(std::move(layer), cull_rects_.top());
 }
 
-void DefaultLayerBuilder::PushBackdropFilter(sk_sp<SkImageFilter> filter) {
-  auto layer = std::make_unique<flow::BackdropFilterLayer>();
+void DefaultLayerBuilder::PushBackdropFilter(sk_sp<SkImageFilter> filter,
+                                             const SkVector& blur_sigma) {
+  auto layer = MakeLayer<flow::BackdropFilterLayer>();
   layer->set_filter(filter);
+  layer->set_blur_sigma(blur_sigma);
   PushLayer(std::move(layer), cull_rects_.top());
 }
 
 void DefaultLayerBuilder::PushShaderMask(sk_sp<SkShader> shader,
                                          const SkRect& rect,
                                          SkBlendMode blend_mode) {
-  auto layer = std::make_unique<flow::ShaderMaskLayer>();
+  auto layer = MakeLayer<flow::ShaderMaskLayer>();
   layer->set_shader(shader);
   layer->set_mask_rect(rect);
   layer->set_blend_mode(blend_mode);
@@ -113,7 +118,7 @@ void DefaultLayerBuilder::PushPhysicalModel(const SkRRect& sk_rrect,
   if (!cullRect.intersect(sk_rrect.rect(), cull_rects_.top())) {
     cullRect = SkRect::MakeEmpty();
   }
-  auto layer = std::make_unique<flow::PhysicalModelLayer>();
+  auto layer = MakeLayer<flow::PhysicalModelLayer>();
   layer->set_rrect(sk_rrect);
   layer->set_elevation(elevation);
   layer->set_color(color);
@@ -126,7 +131,7 @@ void DefaultLayerBuilder::PushPerformanceOverlay(uint64_t enabled_options,
   if (!current_layer_) {
     return;
   }
-  auto layer = std::make_unique<flow::PerformanceOverlayLayer>(enabled_options);
+  auto layer = MakeLayer<flow::PerformanceOverlayLayer>(enabled_options);
   layer->set_paint_bounds(rect);
   current_layer_->Add(std::move(layer));
 }
@@ -143,11 +148,36 @@ void DefaultLayerBuilder::PushPicture(const SkPoint& offset,
   if (!SkRect::Intersects(pictureRect, cull_rects_.top())) {
     return;
   }
-  auto layer = std::make_unique<flow::PictureLayer>();
+  auto layer = MakeLayer<flow::PictureLayer>();
   layer->set_offset(offset);
   layer->set_picture(picture);
   layer->set_is_complex(picture_is_complex);
   layer->set_will_change(picture_will_change);
+
+  auto inserted = picture_uses_.insert({picture.get(), {layer.get(), nullptr}});
+  if (!inserted.second) {
+    PictureUse& use = inserted.first->second;
+    if (!use.shared_result) {
+      use.shared_result =
+          std::make_shared<flow::PictureLayer::SharedPrerollResult>();
+      use.first_layer->set_shared_preroll_result(use.shared_result);
+    }
+    layer->set_shared_preroll_result(use.shared_result);
+  }
+
+  current_layer_->Add(std::move(layer));
+}
+
+void DefaultLayerBuilder::PushTexture(const SkPoint& offset,
+                                      const SkSize& size,
+                                      int64_t texture_id) {
+  if (!current_layer_) {
+    return;
+  }
+  auto layer = MakeLayer<flow::TextureLayer>();
+  layer->set_offset(offset);
+  layer->set_size(size);
+  layer->set_texture_id(texture_id);
   current_layer_->Add(std::move(layer));
 }
 
@@ -165,7 +195,7 @@ void DefaultLayerBuilder::PushChildScene(
   if (!SkRect::Intersects(sceneRect, cull_rects_.top())) {
     return;
   }
-  auto layer = std::make_unique<flow::ChildSceneLayer>();
+  auto layer = MakeLayer<flow::ChildSceneLayer>();
   layer->set_offset(offset);
   layer->set_size(size);
   layer->set_export_node_holder(std::move(export_token_holder));
@@ -182,7 +212,32 @@ void DefaultLayerBuilder::Pop() {
   current_layer_ = current_layer_->parent();
 }
 
+std::shared_ptr<flow::Layer> DefaultLayerBuilder::PopRetained() {
+  if (!current_layer_) {
+    return nullptr;
+  }
+  flow::ContainerLayer* parent = current_layer_->parent();
+  Pop();
+  if (!parent) {
+    return nullptr;
+  }
+
+  // The popped layer is the most recently added child of its parent. It is
+  // moved into shared ownership and replaced with a layer standing in for it.
+  std::shared_ptr<flow::Layer> layer = parent->TakeLastLayer();
+  parent->Add(MakeLayer<flow::RetainedLayer>(layer));
+  return layer;
+}
+
+void DefaultLayerBuilder::PushRetained(std::shared_ptr<flow::Layer> layer) {
+  if (!current_layer_ || !layer) {
+    return;
+  }
+  current_layer_->Add(MakeLayer<flow::RetainedLayer>(std::move(layer)));
+}
+
 std::unique_ptr<flow::Layer> DefaultLayerBuilder::TakeLayer() {
+  picture_uses_.clear();
   return std::move(root_layer_);
 }
 
@@ -6,9 +6,13 @@
 #define FLUTTER_FLOW_LAYERS_DEFAULT_LAYER_BUILDER_H_
 
 #include <stack>
+#include <unordered_map>
+#include <utility>
 
 #include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/layer_arena.h"
 #include "flutter/flow/layers/layer_builder.h"
+#include "flutter/flow/layers/picture_layer.h"
 #include "garnet/public/lib/fxl/macros.h"
 
 namespace flow {
@@ -39,7 +43,8 @@ class DefaultLayerBuilder final : public LayerBuilder {
   void PushColorFilter(SkColor color, SkBlendMode blend_mode) override;
 
   // |flow::LayerBuilder|
-  void PushBackdropFilter(sk_sp<SkImageFilter> filter) override;
+  void PushBackdropFilter(sk_sp<SkImageFilter> filter,
+                          const SkVector& blur_sigma) override;
 
   // |flow::LayerBuilder|
   void PushShaderMask(sk_sp<SkShader> shader,
@@ -62,6 +67,11 @@ class DefaultLayerBuilder final : public LayerBuilder {
                    bool picture_is_complex,
                    bool picture_will_change) override;
 
+  // |flow::LayerBuilder|
+  void PushTexture(const SkPoint& offset,
+                   const SkSize& size,
+                   int64_t texture_id) override;
+
 #if defined(OS_FUCHSIA)
   // |flow::LayerBuilder|
   void PushChildScene(const SkPoint& offset,
@@ -73,15 +83,36 @@ class DefaultLayerBuilder final : public LayerBuilder {
   // |flow::LayerBuilder|
   void Pop() override;
 
+  // |flow::LayerBuilder|
+  std::shared_ptr<flow::Layer> PopRetained() override;
+
+  // |flow::LayerBuilder|
+  void PushRetained(std::shared_ptr<flow::Layer> layer) override;
+
   // |flow::LayerBuilder|
   std::unique_ptr<flow::Layer> TakeLayer() override;
 
  private:
+  // The layers of the tree are allocated from it.
+  fxl::RefPtr<LayerArena> arena_;
   std::unique_ptr<flow::ContainerLayer> root_layer_;
   flow::ContainerLayer* current_layer_ = nullptr;
 
   std::stack<SkRect> cull_rects_;
 
+  // The layers of pictures added more than once share their preroll result.
+  struct PictureUse {
+    flow::PictureLayer* first_layer;
+    std::shared_ptr<flow::PictureLayer::SharedPrerollResult> shared_result;
+  };
+  std::unordered_map<const SkPicture*, PictureUse> picture_uses_;
+
+  template <typename T, typename... Args>
+  std::unique_ptr<T> MakeLayer(Args&&... args) {
+    return std::unique_ptr<T>(new (arena_.get())
+                                  T(std::forward<Args>(args)...));
+  }
+
   void PushLayer(std::unique_ptr<flow::ContainerLayer> layer,
                  const SkRect& cullRect);
 
@@ -4,6 +4,7 @@
 
 #include "flutter/flow/layers/layer.h"
 
+#include "flutter/flow/layer_tree_serialization.h"
 #include "flutter/flow/paint_utils.h"
 #include "third_party/skia/include/core/SkColorFilter.h"
 
@@ -12,12 +13,126 @@ namespace flow {
 Layer::Layer()
     : parent_(nullptr),
       needs_system_composite_(false),
-      paint_bounds_(SkRect::MakeEmpty()) {}
+      paint_bounds_(SkRect::MakeEmpty()),
+      device_paint_bounds_(SkRect::MakeEmpty()) {}
 
 Layer::~Layer() = default;
 
+namespace {
+
+// Precedes the memory of every layer and records the arena it was allocated
+// from, if any.
+struct alignas(LayerArena::kAlignment) AllocationHeader {
+  LayerArena* arena;
+};
+
+void* InitializeHeader(void* memory, LayerArena* arena) {
+  AllocationHeader* header = static_cast<AllocationHeader*>(memory);
+  header->arena = arena;
+  return header + 1;
+}
+
+}  // namespace
+
+void* Layer::operator new(size_t size) {
+  return InitializeHeader(::operator new(sizeof(AllocationHeader) + size),
+                          nullptr);
+}
+
+void* Layer::operator new(size_t size, LayerArena* arena) {
+  if (!arena) {
+    return Layer::operator new(size);
+  }
+  return InitializeHeader(arena->Allocate(sizeof(AllocationHeader) + size),
+                          arena);
+}
+
+void Layer::operator delete(void* ptr) {
+  if (!ptr) {
+    return;
+  }
+  AllocationHeader* header = static_cast<AllocationHeader*>(ptr) - 1;
+  if (header->arena) {
+    header->arena->Free(header);
+  } else {
+    ::operator delete(header);
+  }
+}
+
+void Layer::operator delete(void* ptr, LayerArena* arena) {
+  Layer::operator delete(ptr);
+}
+
 void Layer::Preroll(PrerollContext* context, const SkMatrix& matrix) {}
 
+uint64_t Layer::Fingerprint() const {
+  return 0;
+}
+
+void Layer::Diff(const Layer* old_layer, SkRect* damage) const {
+  if (IsUnchangedFrom(old_layer)) {
+    return;
+  }
+
+  if (old_layer) {
+    damage->join(old_layer->device_paint_bounds());
+  }
+  damage->join(device_paint_bounds_);
+}
+
+void Layer::Serialize(LayerTreeWriter* writer) const {}
+
+size_t Layer::GetMemoryUsage() const {
+  // The properties of most layers are small next to the pictures they hold.
+  return sizeof(Layer);
+}
+
+bool Layer::IsUnchangedFrom(const Layer* old_layer) const {
+  if (old_layer == nullptr) {
+    return false;
+  }
+  const uint64_t fingerprint = Fingerprint();
+  return fingerprint != 0 && fingerprint == old_layer->Fingerprint() &&
+         device_paint_bounds_ == old_layer->device_paint_bounds();
+}
+
+uint64_t Layer::CombineFingerprint(uint64_t seed,
+                                   const void* data,
+                                   size_t length) {
+  // 64-bit FNV-1a.
+  static const uint64_t kPrime = 1099511628211ull;
+  uint64_t hash = seed == 0 ? 14695981039346656037ull : seed;
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < length; i++) {
+    hash ^= bytes[i];
+    hash *= kPrime;
+  }
+  return hash == 0 ? 1 : hash;
+}
+
+bool Layer::CanPaintWithAlpha() const {
+  return false;
+}
+
+void Layer::PaintWithAlpha(PaintContext& context, int alpha) const {
+  SkPaint paint;
+  paint.setAlpha(alpha);
+  Layer::AutoSaveLayer save(context, paint_bounds(), &paint);
+  Paint(context);
+}
+
+bool Layer::CanPaintWithColorFilter() const {
+  return false;
+}
+
+void Layer::PaintWithColorFilter(PaintContext& context,
+                                 sk_sp<SkColorFilter> color_filter) const {
+  SkPaint paint;
+  paint.setColorFilter(std::move(color_filter));
+  Layer::AutoSaveLayer save(context, paint_bounds(), &paint);
+  Paint(context);
+}
+
 #if defined(OS_FUCHSIA)
 void Layer::UpdateScene(SceneUpdateContext& context) {}
 #endif  // defined(OS_FUCHSIA)
@@ -26,12 +141,18 @@ Layer::AutoSaveLayer::AutoSaveLayer(const PaintContext& paint_context,
                                     const SkRect& bounds,
                                     const SkPaint* paint)
     : paint_context_(paint_context), bounds_(bounds) {
+  if (paint_context_.work_counts) {
+    paint_context_.work_counts->save_layers++;
+  }
   paint_context_.canvas.saveLayer(bounds_, paint);
 }
 
 Layer::AutoSaveLayer::AutoSaveLayer(const PaintContext& paint_context,
                                     const SkCanvas::SaveLayerRec& layer_rec)
     : paint_context_(paint_context), bounds_(*layer_rec.fBounds) {
+  if (paint_context_.work_counts) {
+    paint_context_.work_counts->save_layers++;
+  }
   paint_context_.canvas.saveLayer(layer_rec);
 }
 
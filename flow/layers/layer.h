@@ -9,7 +9,9 @@
 #include <vector>
 
 #include "flutter/flow/instrumentation.h"
+#include "flutter/flow/layers/layer_arena.h"
 #include "flutter/flow/raster_cache.h"
+#include "flutter/flow/texture.h"
 #include "flutter/glue/trace_event.h"
 #include "lib/fxl/build_config.h"
 #include "lib/fxl/logging.h"
@@ -33,7 +35,10 @@
 
 namespace flow {
 
+class BackdropFilterLayer;
 class ContainerLayer;
+class LayerProfiler;
+class LayerTreeWriter;
 
 // Represents a single composited layer. Created on the UI thread but then
 // subquently used on the Rasterizer thread.
@@ -42,20 +47,85 @@ class Layer {
   Layer();
   virtual ~Layer();
 
+  // Layers are allocated from the heap unless an arena is specified with
+  // |new (arena) LayerType(...)|. Either way, they are destroyed with delete,
+  // typically by the |std::unique_ptr| that owns them.
+  static void* operator new(size_t size);
+  static void* operator new(size_t size, LayerArena* arena);
+  static void operator delete(void* ptr);
+  static void operator delete(void* ptr, LayerArena* arena);
+
   struct PrerollContext {
     RasterCache* raster_cache;
     GrContext* gr_context;
     SkColorSpace* dst_color_space;
     SkRect child_paint_bounds;
+    // The device space bounds outside of which nothing is visible. Clipping
+    // layers narrow it for their children. Layers entirely outside of it skip
+    // raster cache work.
+    SkRect cull_rect;
+    // A device space rect that ancestor clip layers are known to clip all
+    // painting to. Unlike |cull_rect|, it is only narrowed by the exact rects
+    // of axis aligned clips. It is reset to |SkRect::MakeLargest()| for
+    // subtrees that may be raster cached, since the clips of their ancestors
+    // are not applied when they are rasterized.
+    SkRect device_clip_rect;
+    // Used to construct a paint context when a layer subtree is rasterized
+    // into the raster cache during preroll.
+    const Stopwatch& frame_time;
+    const Stopwatch& engine_time;
+    const Stopwatch& gpu_time;
+    const CounterValues& memory_usage;
+    const CounterValues& image_memory_usage;
+    TextureRegistry& texture_registry;
+    const bool checkerboard_offscreen_layers;
   };
 
   virtual void Preroll(PrerollContext* context, const SkMatrix& matrix);
 
+  // A value identifying the contents painted by this layer (including its
+  // children) across frames. Layers with equal non-zero fingerprints paint
+  // identical contents. Zero indicates that the contents cannot be identified
+  // and must not be cached.
+  virtual uint64_t Fingerprint() const;
+
+  // Accumulates into |damage| the device space bounds of the regions in which
+  // this layer paints differently than |old_layer|, the layer at the same
+  // position in the previously rasterized tree (if there was one). Both layers
+  // must have been prerolled.
+  virtual void Diff(const Layer* old_layer, SkRect* damage) const;
+
+  // Writes the |LayerBuilder| calls that rebuild this layer and its children.
+  // Layers that cannot be rebuilt write nothing.
+  virtual void Serialize(LayerTreeWriter* writer) const;
+
+  // The approximate native memory held by this layer and its children,
+  // including the pictures they draw.
+  virtual size_t GetMemoryUsage() const;
+
+  virtual const ContainerLayer* as_container_layer() const { return nullptr; }
+
+  virtual const BackdropFilterLayer* as_backdrop_filter_layer() const {
+    return nullptr;
+  }
+
   struct PaintContext {
     SkCanvas& canvas;
+    // Children whose device paint bounds do not intersect this rect are not
+    // painted. |SkRect::MakeLargest()| disables culling, which is needed when
+    // the canvas is not in the coordinate space of the frame.
+    SkRect cull_rect;
     const Stopwatch& frame_time;
     const Stopwatch& engine_time;
+    const Stopwatch& gpu_time;
     const CounterValues& memory_usage;
+    const CounterValues& image_memory_usage;
+    TextureRegistry& texture_registry;
+    // Accumulates the work done to paint the frame. Null when the canvas is
+    // not that of the frame, such as when rasterizing into the raster cache.
+    FrameWorkCounts* work_counts;
+    // Measures the time spent on each layer when profiling. Usually null.
+    LayerProfiler* profiler;
     const bool checkerboard_offscreen_layers;
   };
 
@@ -79,6 +149,26 @@ class Layer {
 
   virtual void Paint(PaintContext& context) const = 0;
 
+  // The name of the class of the layer, for profiling.
+  virtual const char* type_name() const { return "Layer"; }
+
+  // Whether |PaintWithAlpha| can apply an alpha without an offscreen layer.
+  // Only valid after preroll.
+  virtual bool CanPaintWithAlpha() const;
+
+  // Paints the layer as if it were composited through an offscreen layer
+  // with |alpha|. By default, that is what is done.
+  virtual void PaintWithAlpha(PaintContext& context, int alpha) const;
+
+  // Whether |PaintWithColorFilter| can apply a color filter without an
+  // offscreen layer. Only valid after preroll.
+  virtual bool CanPaintWithColorFilter() const;
+
+  // Paints the layer as if it were composited through an offscreen layer
+  // with |color_filter|. By default, that is what is done.
+  virtual void PaintWithColorFilter(PaintContext& context,
+                                    sk_sp<SkColorFilter> color_filter) const;
+
 #if defined(OS_FUCHSIA)
   // Updates the system composited scene.
   virtual void UpdateScene(SceneUpdateContext& context);
@@ -103,10 +193,50 @@ class Layer {
 
   bool needs_painting() const { return !paint_bounds_.isEmpty(); }
 
+  // The paint bounds transformed into the coordinate space of the frame. Set
+  // by the parent during preroll.
+  const SkRect& device_paint_bounds() const { return device_paint_bounds_; }
+
+  void set_device_paint_bounds(const SkRect& device_paint_bounds) {
+    device_paint_bounds_ = device_paint_bounds;
+  }
+
+ protected:
+  // Distinguishes layers of different types whose fingerprints would otherwise
+  // be computed from identical values.
+  enum class FingerprintTag : uint32_t {
+    kPicture = 1,
+    kOpacity,
+    kClipRect,
+    kClipRRect,
+    kClipPath,
+    kColorFilter,
+    kPhysicalModel,
+    kTransform,
+    kContainer,
+    kShadow,
+  };
+
+  // Mixes |length| bytes at |data| into the fingerprint |seed|. Zero is never
+  // returned so that combined fingerprints are always valid.
+  static uint64_t CombineFingerprint(uint64_t seed,
+                                     const void* data,
+                                     size_t length);
+
+  template <typename T>
+  static uint64_t CombineFingerprint(uint64_t seed, const T& value) {
+    return CombineFingerprint(seed, &value, sizeof(T));
+  }
+
+  // Whether this layer is known to paint exactly what |old_layer| painted at
+  // the same location.
+  bool IsUnchangedFrom(const Layer* old_layer) const;
+
  private:
   ContainerLayer* parent_;
   bool needs_system_composite_;
   SkRect paint_bounds_;
+  SkRect device_paint_bounds_;
 
   FXL_DISALLOW_COPY_AND_ASSIGN(Layer);
 };
@@ -0,0 +1,49 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layers/layer_arena.h"
+
+#include <stdint.h>
+
+#include "lib/fxl/logging.h"
+
+namespace flow {
+
+// Large enough for the layers of most frames.
+static const size_t kBlockSize = 16 * 1024;
+
+// Allocations larger than this get a block of their own so that they do not
+// waste the remainder of the current one.
+static const size_t kMaxSharedAllocationSize = kBlockSize / 4;
+
+static size_t AlignSize(size_t size) {
+  return (size + LayerArena::kAlignment - 1) & ~(LayerArena::kAlignment - 1);
+}
+
+LayerArena::LayerArena() : cursor_(nullptr), end_(nullptr) {}
+
+LayerArena::~LayerArena() = default;
+
+void* LayerArena::Allocate(size_t size) {
+  size = AlignSize(size);
+  AddRef();
+
+  if (size > kMaxSharedAllocationSize) {
+    blocks_.emplace_back(new char[size]);
+    return blocks_.back().get();
+  }
+
+  if (static_cast<size_t>(end_ - cursor_) < size) {
+    blocks_.emplace_back(new char[kBlockSize]);
+    cursor_ = blocks_.back().get();
+    end_ = cursor_ + kBlockSize;
+  }
+
+  char* memory = cursor_;
+  cursor_ += size;
+  FXL_DCHECK(reinterpret_cast<uintptr_t>(memory) % kAlignment == 0);
+  return memory;
+}
+
+}  // namespace flow
@@ -0,0 +1,54 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_LAYERS_LAYER_ARENA_H_
+#define FLUTTER_FLOW_LAYERS_LAYER_ARENA_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <vector>
+
+#include "lib/fxl/macros.h"
+#include "lib/fxl/memory/ref_counted.h"
+
+namespace flow {
+
+// Hands out the memory of the layers of a frame from a few large blocks, so
+// that building a layer tree on the UI thread and destroying it on the GPU
+// thread do not allocate and free each layer individually. Each allocation
+// holds a reference to the arena, and the blocks are freed once the last
+// layer has been destroyed and the builder has dropped its reference.
+//
+// Allocation is not thread safe and is done by the thread building the tree.
+// Layers may be destroyed on any thread.
+class LayerArena : public fxl::RefCountedThreadSafe<LayerArena> {
+ public:
+  // The alignment of every allocation.
+  static constexpr size_t kAlignment = alignof(std::max_align_t);
+
+  void* Allocate(size_t size);
+
+  // Called when an allocation is no longer used. The memory is only reclaimed
+  // when the arena is destroyed.
+  void Free(void* ptr) { Release(); }
+
+  size_t block_count() const { return blocks_.size(); }
+
+ private:
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  char* cursor_;
+  char* end_;
+
+  LayerArena();
+  ~LayerArena();
+
+  FRIEND_MAKE_REF_COUNTED(LayerArena);
+  FRIEND_REF_COUNTED_THREAD_SAFE(LayerArena);
+  FXL_DISALLOW_COPY_AND_ASSIGN(LayerArena);
+};
+
+}  // namespace flow
+
+#endif  // FLUTTER_FLOW_LAYERS_LAYER_ARENA_H_
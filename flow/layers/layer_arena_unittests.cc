@@ -0,0 +1,55 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layers/layer_arena.h"
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "flutter/flow/layers/opacity_layer.h"
+#include "flutter/flow/layers/transform_layer.h"
+#include "third_party/gtest/include/gtest/gtest.h"
+
+TEST(LayerArena, LayersShareBlocks) {
+  auto arena = fxl::MakeRefCounted<flow::LayerArena>();
+  std::vector<std::unique_ptr<flow::Layer>> layers;
+  for (int i = 0; i < 100; i++) {
+    layers.emplace_back(new (arena.get()) flow::OpacityLayer());
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(layers.back().get()) %
+                  flow::LayerArena::kAlignment,
+              0u);
+  }
+  ASSERT_LT(arena->block_count(), 10u);
+  ASSERT_FALSE(arena->HasOneRef());
+
+  layers.clear();
+  ASSERT_TRUE(arena->HasOneRef());
+}
+
+TEST(LayerArena, LayersOutliveTheBuilderReference) {
+  auto arena = fxl::MakeRefCounted<flow::LayerArena>();
+  auto root = std::unique_ptr<flow::TransformLayer>(
+      new (arena.get()) flow::TransformLayer());
+  root->Add(std::unique_ptr<flow::Layer>(new (arena.get())
+                                             flow::OpacityLayer()));
+  arena = nullptr;
+
+  ASSERT_EQ(root->layers().size(), 1u);
+  root = nullptr;
+}
+
+TEST(LayerArena, HeapAndArenaLayersMix) {
+  auto arena = fxl::MakeRefCounted<flow::LayerArena>();
+  auto root = std::make_unique<flow::TransformLayer>();
+  root->Add(std::unique_ptr<flow::Layer>(new (arena.get())
+                                             flow::OpacityLayer()));
+  root->Add(std::make_unique<flow::OpacityLayer>());
+  root->Add(std::unique_ptr<flow::Layer>(new (nullptr) flow::OpacityLayer()));
+  ASSERT_EQ(arena->block_count(), 1u);
+
+  root = nullptr;
+  ASSERT_TRUE(arena->HasOneRef());
+}
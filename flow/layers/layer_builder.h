@@ -41,7 +41,10 @@ class LayerBuilder {
 
   virtual void PushColorFilter(SkColor color, SkBlendMode blend_mode) = 0;
 
-  virtual void PushBackdropFilter(sk_sp<SkImageFilter> filter) = 0;
+  // |blur_sigma| holds the sigmas of |filter| if it is a Gaussian blur and is
+  // zero otherwise. Blurs can be drawn at a reduced resolution.
+  virtual void PushBackdropFilter(sk_sp<SkImageFilter> filter,
+                                  const SkVector& blur_sigma) = 0;
 
   virtual void PushShaderMask(sk_sp<SkShader> shader,
                               const SkRect& rect,
@@ -60,6 +63,10 @@ class LayerBuilder {
                            bool picture_is_complex,
                            bool picture_will_change) = 0;
 
+  virtual void PushTexture(const SkPoint& offset,
+                           const SkSize& size,
+                           int64_t texture_id) = 0;
+
 #if defined(OS_FUCHSIA)
   virtual void PushChildScene(
       const SkPoint& offset,
@@ -70,6 +77,15 @@ class LayerBuilder {
 
   virtual void Pop() = 0;
 
+  // Like |Pop|, but also returns the subtree that it ends, so that it can be
+  // added to the trees of later frames with |PushRetained|. The subtree must
+  // not be modified afterwards. Returns null when the root is popped.
+  virtual std::shared_ptr<flow::Layer> PopRetained() = 0;
+
+  // Adds a subtree returned by |PopRetained| without building it again. A
+  // subtree may only be added once per tree.
+  virtual void PushRetained(std::shared_ptr<flow::Layer> layer) = 0;
+
   virtual std::unique_ptr<flow::Layer> TakeLayer() = 0;
 
   int GetRasterizerTracingThreshold() const;
@@ -0,0 +1,88 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layers/layer_profiler.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+
+namespace flow {
+
+static size_t CurrentOpCount(const Layer::PaintContext& context) {
+  return context.work_counts ? context.work_counts->picture_ops : 0;
+}
+
+LayerProfiler::ScopedLayer::ScopedLayer(const Layer::PaintContext& context,
+                                        const Layer& layer)
+    : context_(context), layer_(layer) {
+  if (context_.profiler) {
+    context_.profiler->BeginLayer(context_);
+  }
+}
+
+LayerProfiler::ScopedLayer::~ScopedLayer() {
+  if (context_.profiler) {
+    context_.profiler->EndLayer(context_, layer_);
+  }
+}
+
+LayerProfiler::LayerProfiler(SkCanvas* canvas, bool synchronize)
+    : canvas_(canvas), synchronize_(synchronize) {}
+
+LayerProfiler::~LayerProfiler() = default;
+
+std::vector<LayerProfiler::Entry> LayerProfiler::GetMostExpensiveLayers(
+    size_t count) const {
+  std::vector<Entry> ranked(entries_);
+  std::stable_sort(ranked.begin(), ranked.end(),
+                   [](const Entry& lhs, const Entry& rhs) {
+                     return lhs.self_time > rhs.self_time;
+                   });
+  if (ranked.size() > count) {
+    ranked.resize(count);
+  }
+  return ranked;
+}
+
+void LayerProfiler::BeginLayer(const Layer::PaintContext& context) {
+  Synchronize();
+  active_layers_.push_back({fxl::TimePoint::Now(), CurrentOpCount(context),
+                            fxl::TimeDelta::Zero(), 0});
+}
+
+void LayerProfiler::EndLayer(const Layer::PaintContext& context,
+                             const Layer& layer) {
+  FXL_DCHECK(!active_layers_.empty());
+  Synchronize();
+
+  const ActiveLayer active = active_layers_.back();
+  active_layers_.pop_back();
+
+  const fxl::TimeDelta total_time = fxl::TimePoint::Now() - active.start;
+  const size_t total_op_count = CurrentOpCount(context) - active.start_op_count;
+  entries_.push_back({layer.type_name(), layer.device_paint_bounds(),
+                      total_time, total_time - active.child_time,
+                      total_op_count - active.child_op_count});
+
+  if (!active_layers_.empty()) {
+    ActiveLayer& parent = active_layers_.back();
+    parent.child_time = parent.child_time + total_time;
+    parent.child_op_count += total_op_count;
+  }
+}
+
+void LayerProfiler::Synchronize() {
+  if (!synchronize_) {
+    return;
+  }
+  canvas_->flush();
+  // Reading back a pixel blocks until the GPU has completed all the work
+  // submitted so far.
+  uint32_t pixel;
+  canvas_->readPixels(SkImageInfo::MakeN32Premul(1, 1), &pixel, sizeof(pixel),
+                      0, 0);
+}
+
+}  // namespace flow
@@ -0,0 +1,93 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_LAYERS_LAYER_PROFILER_H_
+#define FLUTTER_FLOW_LAYERS_LAYER_PROFILER_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "flutter/flow/layers/layer.h"
+#include "lib/fxl/macros.h"
+#include "lib/fxl/time/time_delta.h"
+#include "lib/fxl/time/time_point.h"
+#include "third_party/skia/include/core/SkRect.h"
+
+namespace flow {
+
+// Measures the time spent painting each layer of a layer tree. Set it as the
+// |profiler| of the paint context passed to |LayerTree::Paint|.
+//
+// Without synchronization, the times only include recording the draw calls
+// of a layer. With it, the canvas is flushed and the GPU is waited on before
+// and after each layer so that the GPU time of each layer is included, at the
+// cost of a frame that takes much longer to paint.
+class LayerProfiler {
+ public:
+  struct Entry {
+    const char* type_name;
+    // In the coordinate space of the frame.
+    SkRect paint_bounds;
+    // The time spent on the layer itself and on its children.
+    fxl::TimeDelta total_time;
+    // The time spent on the layer, excluding that spent on its children.
+    fxl::TimeDelta self_time;
+    // The approximate number of picture ops drawn by the layer itself.
+    size_t op_count;
+  };
+
+  // Starts measuring a layer on construction and records its entry on
+  // destruction. Does nothing if the context has no profiler.
+  class ScopedLayer {
+   public:
+    ScopedLayer(const Layer::PaintContext& context, const Layer& layer);
+    ~ScopedLayer();
+
+   private:
+    const Layer::PaintContext& context_;
+    const Layer& layer_;
+
+    FXL_DISALLOW_COPY_AND_ASSIGN(ScopedLayer);
+  };
+
+  // If |synchronize| is true, |canvas| is flushed and waited on around each
+  // layer.
+  LayerProfiler(SkCanvas* canvas, bool synchronize);
+
+  ~LayerProfiler();
+
+  // The entries of the layers painted so far, in the order their painting
+  // completed.
+  const std::vector<Entry>& entries() const { return entries_; }
+
+  // Returns up to |count| entries with the longest self times, longest first.
+  std::vector<Entry> GetMostExpensiveLayers(size_t count) const;
+
+ private:
+  struct ActiveLayer {
+    fxl::TimePoint start;
+    size_t start_op_count;
+    fxl::TimeDelta child_time;
+    size_t child_op_count;
+  };
+
+  SkCanvas* const canvas_;
+  const bool synchronize_;
+  std::vector<ActiveLayer> active_layers_;
+  std::vector<Entry> entries_;
+
+  void BeginLayer(const Layer::PaintContext& context);
+
+  void EndLayer(const Layer::PaintContext& context, const Layer& layer);
+
+  // Waits for the GPU to complete the work submitted for the canvas so far.
+  void Synchronize();
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(LayerProfiler);
+};
+
+}  // namespace flow
+
+#endif  // FLUTTER_FLOW_LAYERS_LAYER_PROFILER_H_
@@ -0,0 +1,83 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layers/layer_profiler.h"
+
+#include <memory>
+
+#include "flutter/flow/layers/container_layer.h"
+#include "third_party/gtest/include/gtest/gtest.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace {
+
+class MockLeafLayer : public flow::Layer {
+ public:
+  explicit MockLeafLayer(size_t op_count) : op_count_(op_count) {
+    set_paint_bounds(SkRect::MakeWH(10, 10));
+    set_device_paint_bounds(SkRect::MakeWH(10, 10));
+  }
+
+  void Paint(PaintContext& context) const override {
+    context.work_counts->picture_ops += op_count_;
+  }
+
+  const char* type_name() const override { return "MockLeafLayer"; }
+
+ private:
+  size_t op_count_;
+};
+
+class MockContainerLayer : public flow::ContainerLayer {
+ public:
+  MockContainerLayer() {
+    set_paint_bounds(SkRect::MakeWH(10, 10));
+    set_device_paint_bounds(SkRect::MakeWH(10, 10));
+  }
+
+  void Paint(PaintContext& context) const override { PaintChildren(context); }
+};
+
+}  // namespace
+
+TEST(LayerProfiler, ChildrenAreExcludedFromSelfCounts) {
+  sk_sp<SkSurface> surface = SkSurface::MakeRasterN32Premul(10, 10);
+  flow::Stopwatch stopwatch;
+  flow::CounterValues counter_values;
+  flow::TextureRegistry texture_registry;
+  flow::FrameWorkCounts work_counts;
+  flow::LayerProfiler profiler(surface->getCanvas(), true);
+  flow::Layer::PaintContext context = {*surface->getCanvas(),
+                                       SkRect::MakeLargest(),
+                                       stopwatch,
+                                       stopwatch,
+                                       stopwatch,
+                                       counter_values,
+                                       counter_values,
+                                       texture_registry,
+                                       &work_counts,
+                                       &profiler,
+                                       false};
+
+  MockContainerLayer root;
+  root.Add(std::make_unique<MockLeafLayer>(3));
+  root.Add(std::make_unique<MockLeafLayer>(5));
+  {
+    flow::LayerProfiler::ScopedLayer profile(context, root);
+    root.Paint(context);
+  }
+
+  const auto& entries = profiler.entries();
+  ASSERT_EQ(entries.size(), 3u);
+  ASSERT_STREQ(entries[0].type_name, "MockLeafLayer");
+  ASSERT_EQ(entries[0].op_count, 3u);
+  ASSERT_EQ(entries[1].op_count, 5u);
+  ASSERT_STREQ(entries[2].type_name, "ContainerLayer");
+  ASSERT_EQ(entries[2].op_count, 0u);
+  ASSERT_EQ(entries[2].paint_bounds, SkRect::MakeWH(10, 10));
+  ASSERT_GE(entries[2].total_time,
+            entries[0].total_time + entries[1].total_time);
+
+  ASSERT_EQ(profiler.GetMostExpensiveLayers(2).size(), 2u);
+}
@@ -5,6 +5,8 @@
 #include "flutter/flow/layers/layer_tree.h"
 
 #include "flutter/flow/layers/layer.h"
+#include "flutter/flow/layers/layer_profiler.h"
+#include "flutter/flow/layers/picture_layer.h"
 #include "flutter/glue/trace_event.h"
 
 namespace flow {
@@ -15,7 +17,10 @@ LayerTree::LayerTree()
       checkerboard_raster_cache_images_(false),
       checkerboard_offscreen_layers_(false) {}
 
-LayerTree::~LayerTree() = default;
+LayerTree::~LayerTree() {
+  PictureLayer::ScopedReleaseBatch release_batch;
+  root_layer_.reset();
+}
 
 void LayerTree::Raster(CompositorContext::ScopedFrame& frame,
                        bool ignore_raster_cache) {
@@ -35,9 +40,44 @@ void LayerTree::Preroll(CompositorContext::ScopedFrame& frame,
       frame.gr_context(),
       color_space,
       SkRect::MakeEmpty(),
+      SkRect::Make(frame_size_),
+      SkRect::MakeLargest(),
+      frame.context().frame_time(),
+      frame.context().engine_time(),
+      frame.context().gpu_time(),
+      frame.context().memory_usage(),
+      frame.context().image_memory_usage(),
+      frame.context().texture_registry(),
+      checkerboard_offscreen_layers_,
   };
 
   root_layer_->Preroll(&context, SkMatrix::I());
+  root_layer_->set_device_paint_bounds(root_layer_->paint_bounds());
+}
+
+size_t LayerTree::GetMemoryUsage() const {
+  return sizeof(LayerTree) + (root_layer_ ? root_layer_->GetMemoryUsage() : 0);
+}
+
+SkRect LayerTree::ComputeDamage(const LayerTree* previous) const {
+  TRACE_EVENT0("flutter", "LayerTree::ComputeDamage");
+  const SkRect frame_rect = SkRect::Make(frame_size_);
+
+  if (previous == nullptr || previous->frame_size_ != frame_size_ ||
+      previous->checkerboard_raster_cache_images_ !=
+          checkerboard_raster_cache_images_ ||
+      previous->checkerboard_offscreen_layers_ !=
+          checkerboard_offscreen_layers_ ||
+      !previous->root_layer_ || !root_layer_) {
+    return frame_rect;
+  }
+
+  SkRect damage = SkRect::MakeEmpty();
+  root_layer_->Diff(previous->root_layer_.get(), &damage);
+  if (!damage.intersect(frame_rect)) {
+    return SkRect::MakeEmpty();
+  }
+  return damage;
 }
 
 #if defined(OS_FUCHSIA)
@@ -62,15 +102,32 @@ void LayerTree::UpdateScene(SceneUpdateContext& context,
 }
 #endif
 
-void LayerTree::Paint(CompositorContext::ScopedFrame& frame) const {
-  Layer::PaintContext context = {*frame.canvas(), frame.context().frame_time(),
+void LayerTree::Paint(CompositorContext::ScopedFrame& frame,
+                      LayerProfiler* profiler) const {
+  Layer::PaintContext context = {*frame.canvas(),
+                                 SkRect::Make(
+                                     frame.canvas()->getDeviceClipBounds()),
+                                 frame.context().frame_time(),
                                  frame.context().engine_time(),
+                                 frame.context().gpu_time(),
                                  frame.context().memory_usage(),
+                                 frame.context().image_memory_usage(),
+                                 frame.context().texture_registry(),
+                                 &frame.context().frame_work_counts(),
+                                 profiler,
                                  checkerboard_offscreen_layers_};
   TRACE_EVENT0("flutter", "LayerTree::Paint");
 
-  if (root_layer_->needs_painting())
+  // All raster cache lookups of the frame happen during preroll.
+  const RasterCache& raster_cache = frame.context().raster_cache();
+  context.work_counts->raster_cache_hits = raster_cache.frame_hit_count();
+  context.work_counts->raster_cache_misses = raster_cache.frame_miss_count();
+  context.work_counts->raster_cache_bytes = raster_cache.resident_bytes();
+
+  if (root_layer_->needs_painting()) {
+    LayerProfiler::ScopedLayer profile(context, *root_layer_);
     root_layer_->Paint(context);
+  }
 }
 
 }  // namespace flow
@@ -10,6 +10,7 @@
 #include <memory>
 
 #include "flutter/flow/compositor_context.h"
+#include "flutter/flow/frame_timing.h"
 #include "flutter/flow/layers/layer.h"
 #include "lib/fxl/macros.h"
 #include "lib/fxl/time/time_delta.h"
@@ -39,10 +40,21 @@ class LayerTree {
                    scenic_lib::ContainerNode& container);
 #endif
 
-  void Paint(CompositorContext::ScopedFrame& frame) const;
+  // Measures the time spent on each layer if a |profiler| is specified.
+  void Paint(CompositorContext::ScopedFrame& frame,
+             LayerProfiler* profiler = nullptr) const;
+
+  // Returns the region of the frame (in physical pixels) whose contents differ
+  // from the ones painted by |previous|. Both trees must have been prerolled.
+  // The entire frame is damaged if there is no previous tree or if the trees
+  // cannot be compared.
+  SkRect ComputeDamage(const LayerTree* previous) const;
 
   Layer* root_layer() const { return root_layer_.get(); }
 
+  // The approximate native memory held by the tree and its layers.
+  size_t GetMemoryUsage() const;
+
   void set_root_layer(std::unique_ptr<Layer> root_layer) {
     root_layer_ = std::move(root_layer);
   }
@@ -57,9 +69,15 @@ class LayerTree {
 
   const fxl::TimeDelta& construction_time() const { return construction_time_; }
 
-  // The number of frame intervals missed after which the compositor must
-  // trace the rasterized picture to a trace file. Specify 0 to disable all
-  // tracing
+  // The timing record of the frame this tree was built for. The rasterizer
+  // completes it.
+  FrameTiming& frame_timing() { return frame_timing_; }
+
+  void set_frame_timing(const FrameTiming& timing) { frame_timing_ = timing; }
+
+  // The number of frame intervals rasterization may take after which the
+  // rasterizer records the frame into a picture file. Specify 0 to disable all
+  // tracing.
   void set_rasterizer_tracing_threshold(uint32_t interval) {
     rasterizer_tracing_threshold_ = interval;
   }
@@ -80,6 +98,7 @@ class LayerTree {
   SkISize frame_size_;  // Physical pixels.
   std::unique_ptr<Layer> root_layer_;
   fxl::TimeDelta construction_time_;
+  FrameTiming frame_timing_;
   uint32_t rasterizer_tracing_threshold_;
   bool checkerboard_raster_cache_images_;
   bool checkerboard_offscreen_layers_;
@@ -4,18 +4,96 @@
 
 #include "flutter/flow/layers/opacity_layer.h"
 
+#include <vector>
+
+#include "flutter/flow/layer_tree_serialization.h"
+#include "flutter/flow/layers/layer_profiler.h"
+#include "third_party/skia/include/core/SkMath.h"
+
 namespace flow {
 
+// Checking more children for overlaps than this costs more than the offscreen
+// layer it could save.
+static constexpr size_t kMaxFoldedChildren = 4;
+
 OpacityLayer::OpacityLayer() = default;
 
 OpacityLayer::~OpacityLayer() = default;
 
+uint64_t OpacityLayer::PropertiesFingerprint() const {
+  uint64_t fingerprint = CombineFingerprint(0, FingerprintTag::kOpacity);
+  return CombineFingerprint(fingerprint, alpha_);
+}
+
+bool OpacityLayer::ShouldRasterCacheChildren() const {
+  return true;
+}
+
+bool OpacityLayer::CanPaintWithAlpha() const {
+  return true;
+}
+
 void OpacityLayer::Paint(PaintContext& context) const {
   TRACE_EVENT0("flutter", "OpacityLayer::Paint");
   FXL_DCHECK(needs_painting());
 
+  PaintWithCombinedAlpha(context, alpha_);
+}
+
+void OpacityLayer::Serialize(LayerTreeWriter* writer) const {
+  writer->WriteOp(LayerTreeWriter::Op::kPushOpacity);
+  writer->WriteUInt32(alpha_);
+  SerializeChildren(writer);
+}
+
+void OpacityLayer::PaintWithAlpha(PaintContext& context, int alpha) const {
+  TRACE_EVENT0("flutter", "OpacityLayer::PaintWithAlpha");
+  FXL_DCHECK(needs_painting());
+
+  PaintWithCombinedAlpha(context, SkMulDiv255Round(alpha_, alpha));
+}
+
+bool OpacityLayer::CanFoldAlphaIntoChildren() const {
+  std::vector<const Layer*> children;
+  for (auto& layer : layers()) {
+    if (!layer->needs_painting()) {
+      continue;
+    }
+    if (children.size() == kMaxFoldedChildren || !layer->CanPaintWithAlpha()) {
+      return false;
+    }
+    for (const Layer* other : children) {
+      if (other->paint_bounds().intersects(layer->paint_bounds())) {
+        return false;
+      }
+    }
+    children.push_back(layer.get());
+  }
+  return true;
+}
+
+void OpacityLayer::PaintWithCombinedAlpha(PaintContext& context,
+                                          int alpha) const {
   SkPaint paint;
-  paint.setAlpha(alpha_);
+  paint.setAlpha(alpha);
+
+  if (children_raster_cached()) {
+    // The children are a single image. Applying the alpha while drawing it
+    // is equivalent to compositing an offscreen layer.
+    PaintCachedChildren(context, &paint);
+    return;
+  }
+
+  if (CanFoldAlphaIntoChildren()) {
+    for (auto& layer : layers()) {
+      if (layer->needs_painting() &&
+          layer->device_paint_bounds().intersects(context.cull_rect)) {
+        LayerProfiler::ScopedLayer profile(context, *layer);
+        layer->PaintWithAlpha(context, alpha);
+      }
+    }
+    return;
+  }
 
   Layer::AutoSaveLayer save(context, paint_bounds(), &paint);
   PaintChildren(context);
@@ -18,12 +18,34 @@ class OpacityLayer : public ContainerLayer {
 
   void Paint(PaintContext& context) const override;
 
+  void Serialize(LayerTreeWriter* writer) const override;
+
+  const char* type_name() const override { return "OpacityLayer"; }
+
+  bool MayPaintChildrenOffscreen() const override { return true; }
+
+  // Nested opacities combine into one.
+  bool CanPaintWithAlpha() const override;
+
+  void PaintWithAlpha(PaintContext& context, int alpha) const override;
+
   // TODO(chinmaygarde): Once MZ-139 is addressed, introduce a new node in the
   // session scene hierarchy.
 
+ protected:
+  uint64_t PropertiesFingerprint() const override;
+  bool ShouldRasterCacheChildren() const override;
+
  private:
   int alpha_;
 
+  void PaintWithCombinedAlpha(PaintContext& context, int alpha) const;
+
+  // Whether applying the alpha to each child is equivalent to compositing
+  // them through an offscreen layer. That is the case if every child can
+  // paint with an alpha and no two children overlap.
+  bool CanFoldAlphaIntoChildren() const;
+
   FXL_DISALLOW_COPY_AND_ASSIGN(OpacityLayer);
 };
 
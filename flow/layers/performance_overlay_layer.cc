@@ -8,9 +8,14 @@
 
 #include "flutter/flow/layers/performance_overlay_layer.h"
 
+#include "flutter/flow/layer_tree_serialization.h"
+
 namespace flow {
 namespace {
 
+// The distance between the baselines of consecutive lines of text.
+const int kLineHeight = 16;
+
 void DrawStatisticsText(SkCanvas& canvas,
                         const std::string& string,
                         int x,
@@ -41,9 +46,10 @@ void VisualizeStopWatch(SkCanvas& canvas,
 
   if (show_labels) {
     double ms_per_frame = stopwatch.MaxDelta().ToMillisecondsF();
+    const double frame_budget_ms = FrameBudgetMS();
     double fps;
-    if (ms_per_frame < kOneFrameMS) {
-      fps = 1e3 / kOneFrameMS;
+    if (ms_per_frame < frame_budget_ms) {
+      fps = 1e3 / frame_budget_ms;
     } else {
       fps = 1e3 / ms_per_frame;
     }
@@ -54,9 +60,39 @@ void VisualizeStopWatch(SkCanvas& canvas,
     stream << label_prefix << "  " << fps << " fps  " << ms_per_frame
            << "ms/frame";
     DrawStatisticsText(canvas, stream.str(), x + label_x, y + height + label_y);
+
+    std::stringstream percentiles;
+    percentiles.setf(std::ios::fixed | std::ios::showpoint);
+    percentiles << std::setprecision(1);
+    percentiles << "p50 " << stopwatch.Percentile(50).ToMillisecondsF()
+                << "ms  p90 " << stopwatch.Percentile(90).ToMillisecondsF()
+                << "ms  p99 " << stopwatch.Percentile(99).ToMillisecondsF()
+                << "ms  " << stopwatch.OverBudgetCount() << " over budget";
+    DrawStatisticsText(canvas, percentiles.str(), x + label_x,
+                       y + height + label_y - kLineHeight);
   }
 }
 
+void DisplayFrameWorkCounts(SkCanvas& canvas,
+                            const FrameWorkCounts& counts,
+                            SkScalar x,
+                            SkScalar y) {
+  const int label_x = 8;  // distance from x
+
+  std::stringstream raster_cache;
+  raster_cache.setf(std::ios::fixed | std::ios::showpoint);
+  raster_cache << std::setprecision(2);
+  raster_cache << "Raster cache  " << counts.raster_cache_hits << " hits  "
+               << counts.raster_cache_misses << " misses  "
+               << counts.raster_cache_bytes * 1e-6 << " MB";
+  DrawStatisticsText(canvas, raster_cache.str(), x + label_x, y + kLineHeight);
+
+  std::stringstream paint;
+  paint << "Layers  " << counts.save_layers << " saveLayers  "
+        << counts.picture_ops << " picture ops";
+  DrawStatisticsText(canvas, paint.str(), x + label_x, y + 2 * kLineHeight);
+}
+
 void VisualizeCounterValuesBytes(SkCanvas& canvas,
                                  const CounterValues& counter_values,
                                  SkScalar x,
@@ -105,6 +141,10 @@ void PerformanceOverlayLayer::Paint(PaintContext& context) const {
                      options_ & kVisualizeRasterizerStatistics,
                      options_ & kDisplayRasterizerStatistics, "Rasterizer");
 
+  if ((options_ & kDisplayRasterizerStatistics) && context.work_counts) {
+    DisplayFrameWorkCounts(context.canvas, *context.work_counts, x, y);
+  }
+
   VisualizeStopWatch(context.canvas, context.engine_time, x, y + height, width,
                      height, options_ & kVisualizeEngineStatistics,
                      options_ & kDisplayEngineStatistics, "Engine");
@@ -113,6 +153,21 @@ void PerformanceOverlayLayer::Paint(PaintContext& context) const {
       context.canvas, context.memory_usage, x, y + (2 * height), width, height,
       options_ & kVisualizeMemoryStatistics,
       options_ & kDisplayMemoryStatistics, "Memory (Resident)");
+
+  VisualizeCounterValuesBytes(
+      context.canvas, context.image_memory_usage, x, y + (3 * height), width,
+      height, options_ & kVisualizeImageMemoryStatistics,
+      options_ & kDisplayImageMemoryStatistics, "Memory (Images)");
+
+  VisualizeStopWatch(context.canvas, context.gpu_time, x, y + (4 * height),
+                     width, height, options_ & kVisualizeGpuStatistics,
+                     options_ & kDisplayGpuStatistics, "GPU");
+}
+
+void PerformanceOverlayLayer::Serialize(LayerTreeWriter* writer) const {
+  writer->WriteOp(LayerTreeWriter::Op::kPushPerformanceOverlay);
+  writer->WriteUInt64(options_);
+  writer->WriteRect(paint_bounds());
 }
 
 }  // namespace flow
@@ -16,6 +16,10 @@ const int kDisplayEngineStatistics = 1 << 2;
 const int kVisualizeEngineStatistics = 1 << 3;
 const int kDisplayMemoryStatistics = 1 << 4;
 const int kVisualizeMemoryStatistics = 1 << 5;
+const int kDisplayImageMemoryStatistics = 1 << 6;
+const int kVisualizeImageMemoryStatistics = 1 << 7;
+const int kDisplayGpuStatistics = 1 << 8;
+const int kVisualizeGpuStatistics = 1 << 9;
 
 class PerformanceOverlayLayer : public Layer {
  public:
@@ -23,6 +27,10 @@ class PerformanceOverlayLayer : public Layer {
 
   void Paint(PaintContext& context) const override;
 
+  void Serialize(LayerTreeWriter* writer) const override;
+
+  const char* type_name() const override { return "PerformanceOverlayLayer"; }
+
  private:
   int options_;
 
@@ -4,19 +4,40 @@
 
 #include "flutter/flow/layers/physical_model_layer.h"
 
+#include <algorithm>
+
+#include "flutter/flow/layer_tree_serialization.h"
 #include "flutter/flow/paint_utils.h"
 #include "third_party/skia/include/utils/SkShadowUtils.h"
 
 namespace flow {
 
+// The light that casts the shadows, in logical pixels above and at the
+// horizontal center of the top edge of the shape.
+static constexpr SkScalar kLightHeight = 600;
+static constexpr SkScalar kLightRadius = 800;
+
 PhysicalModelLayer::PhysicalModelLayer() = default;
 
 PhysicalModelLayer::~PhysicalModelLayer() = default;
 
+uint64_t PhysicalModelLayer::PropertiesFingerprint() const {
+  uint64_t fingerprint = CombineFingerprint(0, FingerprintTag::kPhysicalModel);
+  fingerprint = CombineFingerprint(fingerprint, rrect_);
+  fingerprint = CombineFingerprint(fingerprint, elevation_);
+  fingerprint = CombineFingerprint(fingerprint, color_);
+  return CombineFingerprint(fingerprint, device_pixel_ratio_);
+}
+
+bool PhysicalModelLayer::ShouldRasterCacheChildren() const {
+  return true;
+}
+
 void PhysicalModelLayer::Preroll(PrerollContext* context,
                                  const SkMatrix& matrix) {
   SkRect child_paint_bounds;
-  PrerollChildren(context, matrix, &child_paint_bounds);
+  PrerollClippedChildren(context, matrix, rrect_.getBounds(), rrect_.isRect(),
+                         &child_paint_bounds);
 
   if (elevation_ == 0) {
     set_paint_bounds(rrect_.getBounds());
@@ -25,17 +46,86 @@ void PhysicalModelLayer::Preroll(PrerollContext* context,
     // Let the system compositor draw all shadows for us.
     set_needs_system_composite(true);
 #else
-    // Add some margin to the paint bounds to leave space for the shadow.
-    // The margin is hardcoded to an arbitrary maximum for now because Skia
-    // doesn't provide a way to calculate it.  We fill this whole region
-    // and clip children to it so we don't need to join the child paint bounds.
-    SkRect bounds(rrect_.getBounds());
-    bounds.outset(20.0, 20.0);
-    set_paint_bounds(bounds);
+    // We fill this whole region and clip children to the shape so we don't
+    // need to join the child paint bounds.
+    set_paint_bounds(ComputeShadowBounds(rrect_.getBounds(), elevation_));
+    PrerollShadow(context, matrix);
 #endif  // defined(OS_FUCHSIA)
   }
 }
 
+uint64_t PhysicalModelLayer::ShadowFingerprint() const {
+  SkRRect rrect = rrect_;
+  rrect.offset(-rrect_.rect().left(), -rrect_.rect().top());
+  const bool transparent_occluder = SkColorGetA(color_) != 0xff;
+  uint64_t fingerprint = CombineFingerprint(0, FingerprintTag::kShadow);
+  fingerprint = CombineFingerprint(fingerprint, rrect);
+  fingerprint = CombineFingerprint(fingerprint, elevation_);
+  fingerprint = CombineFingerprint(fingerprint, transparent_occluder);
+  return CombineFingerprint(fingerprint, device_pixel_ratio_);
+}
+
+void PhysicalModelLayer::PrerollShadow(PrerollContext* context,
+                                       const SkMatrix& matrix) {
+  shadow_cache_result_ = RasterCacheResult();
+
+  RasterCache* cache = context->raster_cache;
+  if (cache == nullptr || !matrix.isScaleTranslate()) {
+    return;
+  }
+
+  SkRect device_bounds;
+  matrix.mapRect(&device_bounds, paint_bounds());
+  if (!device_bounds.intersects(context->cull_rect)) {
+    return;
+  }
+
+  // The light is positioned relative to the shape. So the shadow is the same
+  // wherever the shape is and is rasterized for the shape at the origin.
+  const SkPoint origin = SkPoint::Make(rrect_.rect().left(),
+                                       rrect_.rect().top());
+  SkRRect rrect = rrect_;
+  rrect.offset(-origin.x(), -origin.y());
+  const SkRect bounds = paint_bounds().makeOffset(-origin.x(), -origin.y());
+  SkMatrix shadow_matrix = matrix;
+  shadow_matrix.preTranslate(origin.x(), origin.y());
+
+  shadow_cache_result_ = cache->GetPrerolledImage(
+      context->gr_context, ShadowFingerprint(), bounds, shadow_matrix,
+      context->dst_color_space, [this, rrect](SkCanvas* canvas) {
+        SkPath path;
+        path.addRRect(rrect);
+        DrawShadow(canvas, path, SK_ColorBLACK, elevation_,
+                   SkColorGetA(color_) != 0xff, device_pixel_ratio_);
+      });
+}
+
+SkRect PhysicalModelLayer::ComputeShadowBounds(const SkRect& bounds,
+                                               float elevation) {
+  // The spot shadow is the shape projected away from the light and blurred
+  // in proportion to the size of the light. The ambient shadow is blurred by
+  // half the elevation. See SkShadowUtils.
+  const SkScalar height = std::min<SkScalar>(elevation, kLightHeight - 1);
+  const SkScalar ratio = height / (kLightHeight - height);
+  const SkScalar light_x = bounds.centerX();
+  const SkScalar light_y = bounds.top() - kLightHeight;
+
+  SkRect shadow_bounds = SkRect::MakeLTRB(
+      bounds.left() + (bounds.left() - light_x) * ratio,
+      bounds.top() + (bounds.top() - light_y) * ratio,
+      bounds.right() + (bounds.right() - light_x) * ratio,
+      bounds.bottom() + (bounds.bottom() - light_y) * ratio);
+  shadow_bounds.outset(kLightRadius * ratio, kLightRadius * ratio);
+
+  SkRect ambient_bounds = bounds;
+  ambient_bounds.outset(elevation / 2, elevation / 2);
+  shadow_bounds.join(ambient_bounds);
+
+  // Leave room for anti-aliasing.
+  shadow_bounds.outset(1, 1);
+  return shadow_bounds;
+}
+
 #if defined(OS_FUCHSIA)
 
 void PhysicalModelLayer::UpdateScene(SceneUpdateContext& context) {
@@ -61,8 +151,7 @@ void PhysicalModelLayer::Paint(PaintContext& context) const {
   path.addRRect(rrect_);
 
   if (elevation_ != 0) {
-    DrawShadow(&context.canvas, path, SK_ColorBLACK, elevation_,
-               SkColorGetA(color_) != 0xff, device_pixel_ratio_);
+    PaintShadow(context, path);
   }
 
   SkPaint paint;
@@ -70,17 +159,54 @@ void PhysicalModelLayer::Paint(PaintContext& context) const {
   context.canvas.drawPath(path, paint);
 
   SkAutoCanvasRestore save(&context.canvas, false);
-  if (rrect_.isRect()) {
+  if (rrect_.isRect() || children_raster_cached()) {
+    // Cached children are a single image and cannot exhibit conflation
+    // artifacts along the anti-aliased clip edge.
     context.canvas.save();
   } else {
+    if (context.work_counts) {
+      context.work_counts->save_layers++;
+    }
     context.canvas.saveLayer(&rrect_.getBounds(), nullptr);
   }
   context.canvas.clipRRect(rrect_, true);
   PaintChildren(context);
-  if (context.checkerboard_offscreen_layers && !rrect_.isRect())
+  if (context.checkerboard_offscreen_layers && !rrect_.isRect() &&
+      !children_raster_cached())
     DrawCheckerboard(&context.canvas, rrect_.getBounds());
 }
 
+void PhysicalModelLayer::Serialize(LayerTreeWriter* writer) const {
+  writer->WriteOp(LayerTreeWriter::Op::kPushPhysicalModel);
+  writer->WriteRRect(rrect_);
+  writer->WriteScalar(elevation_);
+  writer->WriteUInt32(color_);
+  writer->WriteScalar(device_pixel_ratio_);
+  SerializeChildren(writer);
+}
+
+void PhysicalModelLayer::PaintShadow(PaintContext& context,
+                                     const SkPath& path) const {
+  if (!shadow_cache_result_.is_valid()) {
+    DrawShadow(&context.canvas, path, SK_ColorBLACK, elevation_,
+               SkColorGetA(color_) != 0xff, device_pixel_ratio_);
+    return;
+  }
+
+  // The shadow was rasterized for the shape at the origin.
+  const SkRect destination = shadow_cache_result_.destination_rect().makeOffset(
+      rrect_.rect().left(), rrect_.rect().top());
+  SkPaint paint;
+  paint.setFilterQuality(kLow_SkFilterQuality);
+  context.canvas.drawImageRect(
+      shadow_cache_result_.image(),        // image
+      shadow_cache_result_.source_rect(),  // source
+      destination,                         // destination
+      &paint,                              // paint
+      SkCanvas::kStrict_SrcRectConstraint  // source constraint
+  );
+}
+
 void PhysicalModelLayer::DrawShadow(SkCanvas* canvas,
                                     const SkPath& path,
                                     SkColor color,
@@ -92,10 +218,11 @@ void PhysicalModelLayer::DrawShadow(SkCanvas* canvas,
                             : SkShadowFlags::kNone_ShadowFlag;
   const SkRect& bounds = path.getBounds();
   SkScalar shadow_x = (bounds.left() + bounds.right()) / 2;
-  SkScalar shadow_y = bounds.top() - 600.0f;
-  SkShadowUtils::DrawShadow(canvas, path, dpr * elevation,
-                            SkPoint3::Make(shadow_x, shadow_y, dpr * 600.0f),
-                            dpr * 800.0f, 0.039f, 0.25f, color, flags);
+  SkScalar shadow_y = bounds.top() - kLightHeight;
+  SkShadowUtils::DrawShadow(
+      canvas, path, dpr * elevation,
+      SkPoint3::Make(shadow_x, shadow_y, dpr * kLightHeight),
+      dpr * kLightRadius, 0.039f, 0.25f, color, flags);
 }
 
 }  // namespace flow
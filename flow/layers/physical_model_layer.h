@@ -26,19 +26,44 @@ class PhysicalModelLayer : public ContainerLayer {
                          bool transparentOccluder,
                          SkScalar dpr);
 
+  // The bounds of the shadow |DrawShadow| draws for a shape with |bounds|.
+  static SkRect ComputeShadowBounds(const SkRect& bounds, float elevation);
+
   void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
 
   void Paint(PaintContext& context) const override;
 
+  void Serialize(LayerTreeWriter* writer) const override;
+
+  const char* type_name() const override { return "PhysicalModelLayer"; }
+
+  bool MayPaintChildrenOffscreen() const override { return true; }
+
 #if defined(OS_FUCHSIA)
   void UpdateScene(SceneUpdateContext& context) override;
 #endif  // defined(OS_FUCHSIA)
 
+ protected:
+  uint64_t PropertiesFingerprint() const override;
+  bool ShouldRasterCacheChildren() const override;
+
  private:
   SkRRect rrect_;
   float elevation_;
   SkColor color_;
   SkScalar device_pixel_ratio_;
+  RasterCacheResult shadow_cache_result_;
+
+  // Identifies the shadow independently of where the shape is.
+  uint64_t ShadowFingerprint() const;
+
+  // Rasterizes the shadow into the raster cache, where identical shadows
+  // share an entry.
+  void PrerollShadow(PrerollContext* context, const SkMatrix& matrix);
+
+  void PaintShadow(PaintContext& context, const SkPath& path) const;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(PhysicalModelLayer);
 };
 
 }  // namespace flow
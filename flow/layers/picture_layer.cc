@@ -5,30 +5,107 @@
 #include "flutter/flow/layers/picture_layer.h"
 
 #include "flutter/common/threads.h"
+#include "flutter/flow/layer_tree_serialization.h"
+#include "flutter/fml/thread_local.h"
+#include "lib/fxl/functional/make_copyable.h"
 #include "lib/fxl/logging.h"
 
 namespace flow {
 
+// The innermost |PictureLayer::ScopedReleaseBatch| of the current thread.
+FML_THREAD_LOCAL fml::ThreadLocal tls_release_batch;
+
+PictureLayer::ScopedReleaseBatch::ScopedReleaseBatch() {
+  previous_ = reinterpret_cast<ScopedReleaseBatch*>(tls_release_batch.Get());
+  tls_release_batch.Set(reinterpret_cast<intptr_t>(this));
+}
+
+PictureLayer::ScopedReleaseBatch::~ScopedReleaseBatch() {
+  tls_release_batch.Set(reinterpret_cast<intptr_t>(previous_));
+  if (pictures_.empty()) {
+    return;
+  }
+  blink::Threads::IO()->PostTask(fxl::MakeCopyable(
+      [pictures = std::move(pictures_)]() mutable { pictures.clear(); }));
+}
+
 PictureLayer::PictureLayer() = default;
 
 PictureLayer::~PictureLayer() {
+  if (!picture_) {
+    return;
+  }
+
   // The picture may contain references to textures that are associated
   // with the IO thread's context.
+  auto* batch = reinterpret_cast<ScopedReleaseBatch*>(tls_release_batch.Get());
+  if (batch) {
+    batch->pictures_.push_back(std::move(picture_));
+    return;
+  }
   SkPicture* picture = picture_.release();
-  if (picture) {
-    blink::Threads::IO()->PostTask([picture]() { picture->unref(); });
+  blink::Threads::IO()->PostTask([picture]() { picture->unref(); });
+}
+
+uint64_t PictureLayer::Fingerprint() const {
+  if (!picture_ || will_change_) {
+    return 0;
   }
+  uint64_t fingerprint = CombineFingerprint(0, FingerprintTag::kPicture);
+  fingerprint = CombineFingerprint(fingerprint, picture_->uniqueID());
+  fingerprint = CombineFingerprint(fingerprint, offset_);
+  return fingerprint;
 }
 
 void PictureLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
+  SkRect bounds = picture_->cullRect().makeOffset(offset_.x(), offset_.y());
+  set_paint_bounds(bounds);
+
+  SkRect device_bounds;
+  matrix.mapRect(&device_bounds, bounds);
+  if (!device_bounds.intersects(context->cull_rect)) {
+    // Not visible. Neither rasterize nor keep alive a cache entry for it.
+    raster_cache_result_ = RasterCacheResult();
+    raster_cache_tiles_ = RasterCacheTiles();
+    return;
+  }
+
+  raster_cache_tiles_ = RasterCacheTiles();
   if (auto cache = context->raster_cache) {
+    if (cache->ShouldTilePicture(picture_.get(), matrix)) {
+      // Which tiles are needed depends on where the picture is.
+      raster_cache_result_ = RasterCacheResult();
+      SkMatrix picture_matrix = matrix;
+      picture_matrix.preTranslate(offset_.x(), offset_.y());
+      raster_cache_tiles_ = cache->GetPrerolledTiles(
+          context->gr_context, picture_.get(), picture_matrix,
+          context->cull_rect, context->dst_color_space, is_complex_,
+          will_change_);
+      return;
+    }
+
+    SkMatrix scale_matrix = matrix;
+    scale_matrix.setTranslateX(0);
+    scale_matrix.setTranslateY(0);
+    SharedPrerollResult* shared = shared_preroll_result_.get();
+    if (shared && !will_change_ && shared->raster_cache == cache &&
+        shared->frame_number == cache->frame_number() &&
+        shared->matrix == scale_matrix && shared->is_complex == is_complex_) {
+      raster_cache_result_ = shared->result;
+      return;
+    }
+
     raster_cache_result_ = cache->GetPrerolledImage(
         context->gr_context, picture_.get(), matrix, context->dst_color_space,
         is_complex_, will_change_);
+    if (shared && !will_change_) {
+      shared->raster_cache = cache;
+      shared->frame_number = cache->frame_number();
+      shared->matrix = scale_matrix;
+      shared->is_complex = is_complex_;
+      shared->result = raster_cache_result_;
+    }
   }
-
-  SkRect bounds = picture_->cullRect().makeOffset(offset_.x(), offset_.y());
-  set_paint_bounds(bounds);
 }
 
 void PictureLayer::Paint(PaintContext& context) const {
@@ -36,22 +113,97 @@ void PictureLayer::Paint(PaintContext& context) const {
   FXL_DCHECK(picture_);
   FXL_DCHECK(needs_painting());
 
+  if (raster_cache_result_.is_valid()) {
+    PaintCachedImage(context, SkPaint());
+    return;
+  }
+
   SkAutoCanvasRestore save(&context.canvas, true);
   context.canvas.translate(offset_.x(), offset_.y());
 
-  if (raster_cache_result_.is_valid()) {
-    SkPaint paint;
-    paint.setFilterQuality(kLow_SkFilterQuality);
-    context.canvas.drawImageRect(
-        raster_cache_result_.image(),             // image
-        raster_cache_result_.source_rect(),       // source
-        raster_cache_result_.destination_rect(),  // destination
-        &paint,                                   // paint
-        SkCanvas::kStrict_SrcRectConstraint       // source constraint
-    );
-  } else {
-    context.canvas.drawPicture(picture_.get());
+  if (!raster_cache_tiles_.empty()) {
+    // Tiles are only kept near the visible part of the picture, so canvases
+    // that see more of it, such as those of raster cached ancestors, get the
+    // picture itself.
+    const SkRect visible_rect = context.canvas.getLocalClipBounds();
+    if (raster_cache_tiles_.Covers(visible_rect)) {
+      SkPaint paint;
+      paint.setFilterQuality(kLow_SkFilterQuality);
+      raster_cache_tiles_.Draw(context.canvas, visible_rect, &paint);
+      return;
+    }
   }
+
+  if (context.work_counts) {
+    context.work_counts->picture_ops += picture_->approximateOpCount();
+  }
+  context.canvas.drawPicture(picture_.get());
+}
+
+void PictureLayer::Serialize(LayerTreeWriter* writer) const {
+  writer->WriteOp(LayerTreeWriter::Op::kPushPicture);
+  writer->WritePoint(offset_);
+  writer->WriteBool(is_complex_);
+  writer->WriteBool(will_change_);
+  writer->WritePicture(picture_.get());
+}
+
+size_t PictureLayer::GetMemoryUsage() const {
+  return sizeof(PictureLayer) +
+         (picture_ ? picture_->approximateBytesUsed() : 0);
+}
+
+bool PictureLayer::CanPaintWithAlpha() const {
+  return raster_cache_result_.is_valid();
+}
+
+void PictureLayer::PaintWithAlpha(PaintContext& context, int alpha) const {
+  if (!raster_cache_result_.is_valid()) {
+    Layer::PaintWithAlpha(context, alpha);
+    return;
+  }
+
+  TRACE_EVENT0("flutter", "PictureLayer::PaintWithAlpha");
+  FXL_DCHECK(needs_painting());
+  // The cached image is a single draw. So applying the alpha to it is
+  // equivalent to compositing an offscreen layer.
+  SkPaint paint;
+  paint.setAlpha(alpha);
+  PaintCachedImage(context, paint);
+}
+
+bool PictureLayer::CanPaintWithColorFilter() const {
+  return raster_cache_result_.is_valid();
+}
+
+void PictureLayer::PaintWithColorFilter(
+    PaintContext& context,
+    sk_sp<SkColorFilter> color_filter) const {
+  if (!raster_cache_result_.is_valid()) {
+    Layer::PaintWithColorFilter(context, std::move(color_filter));
+    return;
+  }
+
+  TRACE_EVENT0("flutter", "PictureLayer::PaintWithColorFilter");
+  FXL_DCHECK(needs_painting());
+  SkPaint paint;
+  paint.setColorFilter(std::move(color_filter));
+  PaintCachedImage(context, paint);
+}
+
+void PictureLayer::PaintCachedImage(PaintContext& context,
+                                    SkPaint paint) const {
+  SkAutoCanvasRestore save(&context.canvas, true);
+  context.canvas.translate(offset_.x(), offset_.y());
+
+  paint.setFilterQuality(kLow_SkFilterQuality);
+  context.canvas.drawImageRect(
+      raster_cache_result_.image(),             // image
+      raster_cache_result_.source_rect(),       // source
+      raster_cache_result_.destination_rect(),  // destination
+      &paint,                                   // paint
+      SkCanvas::kStrict_SrcRectConstraint       // source constraint
+  );
 }
 
 }  // namespace flow
@@ -5,6 +5,9 @@
 #ifndef FLUTTER_FLOW_LAYERS_PICTURE_LAYER_H_
 #define FLUTTER_FLOW_LAYERS_PICTURE_LAYER_H_
 
+#include <memory>
+#include <vector>
+
 #include "flutter/flow/layers/layer.h"
 #include "flutter/flow/raster_cache.h"
 
@@ -15,11 +18,46 @@ class PictureLayer : public Layer {
   PictureLayer();
   ~PictureLayer() override;
 
+  // The pictures of destroyed layers are released on the IO thread since
+  // they may reference textures of its context. While an instance of this
+  // class is alive, the pictures of the layers destroyed on the current
+  // thread are collected and released in a single IO thread task once it
+  // goes away, instead of in a task per layer.
+  class ScopedReleaseBatch {
+   public:
+    ScopedReleaseBatch();
+    ~ScopedReleaseBatch();
+
+   private:
+    friend class PictureLayer;
+
+    ScopedReleaseBatch* previous_;
+    std::vector<sk_sp<SkPicture>> pictures_;
+
+    FXL_DISALLOW_COPY_AND_ASSIGN(ScopedReleaseBatch);
+  };
+
+  // The raster cache result of a picture that several layers of a layer tree
+  // draw. The first of them prerolled in a frame looks the picture up, the
+  // others drawing it at the same scale reuse its result.
+  struct SharedPrerollResult {
+    const RasterCache* raster_cache = nullptr;
+    size_t frame_number = 0;
+    // The preroll matrix without its translation, which the cached image does
+    // not depend on.
+    SkMatrix matrix;
+    bool is_complex = false;
+    RasterCacheResult result;
+  };
+
   void set_offset(const SkPoint& offset) { offset_ = offset; }
   void set_picture(sk_sp<SkPicture> picture) { picture_ = std::move(picture); }
 
   void set_is_complex(bool value) { is_complex_ = value; }
   void set_will_change(bool value) { will_change_ = value; }
+  void set_shared_preroll_result(std::shared_ptr<SharedPrerollResult> result) {
+    shared_preroll_result_ = std::move(result);
+  }
 
   SkPicture* picture() const { return picture_.get(); }
 
@@ -27,12 +65,38 @@ class PictureLayer : public Layer {
 
   void Paint(PaintContext& context) const override;
 
+  void Serialize(LayerTreeWriter* writer) const override;
+
+  size_t GetMemoryUsage() const override;
+
+  const char* type_name() const override { return "PictureLayer"; }
+
+  // Only a raster cached picture can be painted with an alpha directly.
+  bool CanPaintWithAlpha() const override;
+
+  void PaintWithAlpha(PaintContext& context, int alpha) const override;
+
+  // Likewise for color filters.
+  bool CanPaintWithColorFilter() const override;
+
+  void PaintWithColorFilter(PaintContext& context,
+                            sk_sp<SkColorFilter> color_filter) const override;
+
+  uint64_t Fingerprint() const override;
+
  private:
   SkPoint offset_;
   sk_sp<SkPicture> picture_;
   bool is_complex_ = false;
   bool will_change_ = false;
   RasterCacheResult raster_cache_result_;
+  // Set instead of |raster_cache_result_| for pictures too large to be
+  // raster cached as a single image.
+  RasterCacheTiles raster_cache_tiles_;
+  std::shared_ptr<SharedPrerollResult> shared_preroll_result_;
+
+  // Draws the raster cached image with the alpha and color filter of |paint|.
+  void PaintCachedImage(PaintContext& context, SkPaint paint) const;
 
   FXL_DISALLOW_COPY_AND_ASSIGN(PictureLayer);
 };
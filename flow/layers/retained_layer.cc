@@ -0,0 +1,78 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layers/retained_layer.h"
+
+#include "flutter/flow/layer_tree_serialization.h"
+
+namespace flow {
+
+RetainedLayer::RetainedLayer(std::shared_ptr<Layer> layer)
+    : layer_(std::move(layer)) {
+  FXL_DCHECK(layer_);
+}
+
+RetainedLayer::~RetainedLayer() = default;
+
+void RetainedLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
+  // The subtree was last prerolled as part of another tree, possibly under a
+  // different parent. Ancestors are only walked by the layers of the tree
+  // being rasterized, so the parent is updated here rather than when the
+  // subtree is added.
+  layer_->set_parent(parent());
+  layer_->Preroll(context, matrix);
+
+  set_needs_system_composite(layer_->needs_system_composite());
+  set_paint_bounds(layer_->paint_bounds());
+  SkRect device_paint_bounds;
+  matrix.mapRect(&device_paint_bounds, layer_->paint_bounds());
+  layer_->set_device_paint_bounds(device_paint_bounds);
+}
+
+uint64_t RetainedLayer::Fingerprint() const {
+  return layer_->Fingerprint();
+}
+
+void RetainedLayer::Paint(PaintContext& context) const {
+  layer_->Paint(context);
+}
+
+void RetainedLayer::Serialize(LayerTreeWriter* writer) const {
+  // The subtree is written out in full, it is not shared when rebuilt.
+  layer_->Serialize(writer);
+}
+
+size_t RetainedLayer::GetMemoryUsage() const {
+  // The subtree is counted by every tree that shares it, since any of them
+  // keeps it alive.
+  return sizeof(RetainedLayer) + layer_->GetMemoryUsage();
+}
+
+bool RetainedLayer::CanPaintWithAlpha() const {
+  return layer_->CanPaintWithAlpha();
+}
+
+void RetainedLayer::PaintWithAlpha(PaintContext& context, int alpha) const {
+  layer_->PaintWithAlpha(context, alpha);
+}
+
+bool RetainedLayer::CanPaintWithColorFilter() const {
+  return layer_->CanPaintWithColorFilter();
+}
+
+void RetainedLayer::PaintWithColorFilter(
+    PaintContext& context,
+    sk_sp<SkColorFilter> color_filter) const {
+  layer_->PaintWithColorFilter(context, std::move(color_filter));
+}
+
+#if defined(OS_FUCHSIA)
+
+void RetainedLayer::UpdateScene(SceneUpdateContext& context) {
+  layer_->UpdateScene(context);
+}
+
+#endif  // defined(OS_FUCHSIA)
+
+}  // namespace flow
@@ -0,0 +1,58 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_LAYERS_RETAINED_LAYER_H_
+#define FLUTTER_FLOW_LAYERS_RETAINED_LAYER_H_
+
+#include <memory>
+
+#include "flutter/flow/layers/layer.h"
+
+namespace flow {
+
+// Stands in for a subtree that was built for an earlier frame and is shared
+// with the trees of later frames instead of being built again. The subtree is
+// not modified once it is shared, other than by the preroll of the frame being
+// rasterized, which happens on the GPU thread like all other uses of it.
+class RetainedLayer : public Layer {
+ public:
+  explicit RetainedLayer(std::shared_ptr<Layer> layer);
+  ~RetainedLayer() override;
+
+  const std::shared_ptr<Layer>& layer() const { return layer_; }
+
+  void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
+
+  uint64_t Fingerprint() const override;
+
+  void Paint(PaintContext& context) const override;
+
+  void Serialize(LayerTreeWriter* writer) const override;
+
+  size_t GetMemoryUsage() const override;
+
+  bool CanPaintWithAlpha() const override;
+
+  void PaintWithAlpha(PaintContext& context, int alpha) const override;
+
+  bool CanPaintWithColorFilter() const override;
+
+  void PaintWithColorFilter(PaintContext& context,
+                            sk_sp<SkColorFilter> color_filter) const override;
+
+  const char* type_name() const override { return "RetainedLayer"; }
+
+#if defined(OS_FUCHSIA)
+  void UpdateScene(SceneUpdateContext& context) override;
+#endif  // defined(OS_FUCHSIA)
+
+ private:
+  std::shared_ptr<Layer> layer_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(RetainedLayer);
+};
+
+}  // namespace flow
+
+#endif  // FLUTTER_FLOW_LAYERS_RETAINED_LAYER_H_
@@ -0,0 +1,92 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layers/retained_layer.h"
+
+#include <string.h>
+
+#include <memory>
+
+#include "flutter/flow/layers/container_layer.h"
+#include "flutter/flow/layers/default_layer_builder.h"
+#include "third_party/gtest/include/gtest/gtest.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+
+namespace {
+
+const flow::RetainedLayer* GetOnlyRetainedChild(flow::Layer* root) {
+  const flow::ContainerLayer* container = root->as_container_layer();
+  if (!container || container->layers().size() != 1 ||
+      strcmp(container->layers()[0]->type_name(), "RetainedLayer") != 0) {
+    return nullptr;
+  }
+  return static_cast<const flow::RetainedLayer*>(
+      container->layers()[0].get());
+}
+
+}  // namespace
+
+TEST(RetainedLayer, SubtreeIsSharedWithLaterTrees) {
+  flow::DefaultLayerBuilder first_builder;
+  first_builder.PushTransform(SkMatrix::I());
+  first_builder.PushOpacity(128);
+  std::shared_ptr<flow::Layer> retained = first_builder.PopRetained();
+  first_builder.Pop();
+  std::unique_ptr<flow::Layer> first_tree = first_builder.TakeLayer();
+
+  ASSERT_TRUE(retained);
+  ASSERT_STREQ(retained->type_name(), "OpacityLayer");
+  ASSERT_EQ(retained->parent(), nullptr);
+  const flow::RetainedLayer* first_child =
+      GetOnlyRetainedChild(first_tree.get());
+  ASSERT_NE(first_child, nullptr);
+  ASSERT_EQ(first_child->layer(), retained);
+
+  flow::DefaultLayerBuilder second_builder;
+  second_builder.PushTransform(SkMatrix::I());
+  second_builder.PushRetained(retained);
+  second_builder.Pop();
+  std::unique_ptr<flow::Layer> second_tree = second_builder.TakeLayer();
+
+  const flow::RetainedLayer* second_child =
+      GetOnlyRetainedChild(second_tree.get());
+  ASSERT_NE(second_child, nullptr);
+  ASSERT_EQ(second_child->layer(), retained);
+  ASSERT_EQ(retained.use_count(), 3);
+
+  first_tree = nullptr;
+  second_tree = nullptr;
+  ASSERT_EQ(retained.use_count(), 1);
+}
+
+TEST(RetainedLayer, RootCannotBeRetained) {
+  flow::DefaultLayerBuilder builder;
+  builder.PushTransform(SkMatrix::I());
+  ASSERT_FALSE(builder.PopRetained());
+  ASSERT_TRUE(builder.TakeLayer());
+}
+
+TEST(RetainedLayer, MemoryUsageIncludesSharedSubtree) {
+  SkPictureRecorder recorder;
+  recorder.beginRecording(SkRect::MakeWH(100, 100));
+  recorder.getRecordingCanvas()->drawRect(SkRect::MakeWH(50, 50), SkPaint());
+  sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+  flow::DefaultLayerBuilder first_builder;
+  first_builder.PushTransform(SkMatrix::I());
+  first_builder.PushOpacity(128);
+  first_builder.PushPicture(SkPoint::Make(0, 0), picture, false, false);
+  std::shared_ptr<flow::Layer> retained = first_builder.PopRetained();
+  first_builder.Pop();
+  std::unique_ptr<flow::Layer> first_tree = first_builder.TakeLayer();
+  ASSERT_GT(retained->GetMemoryUsage(), picture->approximateBytesUsed());
+  ASSERT_GT(first_tree->GetMemoryUsage(), retained->GetMemoryUsage());
+
+  flow::DefaultLayerBuilder second_builder;
+  second_builder.PushTransform(SkMatrix::I());
+  second_builder.PushRetained(retained);
+  second_builder.Pop();
+  std::unique_ptr<flow::Layer> second_tree = second_builder.TakeLayer();
+  ASSERT_EQ(second_tree->GetMemoryUsage(), first_tree->GetMemoryUsage());
+}
@@ -4,6 +4,8 @@
 
 #include "flutter/flow/layers/shader_mask_layer.h"
 
+#include "flutter/flow/layer_tree_serialization.h"
+
 namespace flow {
 
 ShaderMaskLayer::ShaderMaskLayer() = default;
@@ -14,7 +16,9 @@ void ShaderMaskLayer::Paint(PaintContext& context) const {
   TRACE_EVENT0("flutter", "ShaderMaskLayer::Paint");
   FXL_DCHECK(needs_painting());
 
-  Layer::AutoSaveLayer(context, paint_bounds(), nullptr);
+  // The mask blends with the children only, so they are composited through
+  // an offscreen layer.
+  Layer::AutoSaveLayer save(context, paint_bounds(), nullptr);
   PaintChildren(context);
 
   SkPaint paint;
@@ -25,4 +29,17 @@ void ShaderMaskLayer::Paint(PaintContext& context) const {
       SkRect::MakeWH(mask_rect_.width(), mask_rect_.height()), paint);
 }
 
+void ShaderMaskLayer::Serialize(LayerTreeWriter* writer) const {
+  writer->WriteOp(LayerTreeWriter::Op::kPushShaderMask);
+  writer->WriteFlattenable(shader_.get());
+  writer->WriteRect(mask_rect_);
+  writer->WriteUInt32(static_cast<uint32_t>(blend_mode_));
+  SerializeChildren(writer);
+}
+
+uint64_t ShaderMaskLayer::PropertiesFingerprint() const {
+  // Never cached since shaders have no stable identity.
+  return 0;
+}
+
 }  // namespace flow
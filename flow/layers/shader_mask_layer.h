@@ -24,6 +24,15 @@ class ShaderMaskLayer : public ContainerLayer {
 
   void Paint(PaintContext& context) const override;
 
+  void Serialize(LayerTreeWriter* writer) const override;
+
+  const char* type_name() const override { return "ShaderMaskLayer"; }
+
+  bool MayPaintChildrenOffscreen() const override { return true; }
+
+ protected:
+  uint64_t PropertiesFingerprint() const override;
+
  private:
   sk_sp<SkShader> shader_;
   SkRect mask_rect_;
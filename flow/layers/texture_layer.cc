@@ -0,0 +1,38 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/layers/texture_layer.h"
+
+#include "flutter/flow/layer_tree_serialization.h"
+#include "flutter/flow/texture.h"
+
+namespace flow {
+
+TextureLayer::TextureLayer() : texture_id_(0) {}
+
+TextureLayer::~TextureLayer() = default;
+
+void TextureLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
+  set_paint_bounds(SkRect::MakeXYWH(offset_.x(), offset_.y(), size_.width(),
+                                    size_.height()));
+}
+
+void TextureLayer::Paint(PaintContext& context) const {
+  TRACE_EVENT0("flutter", "TextureLayer::Paint");
+  std::shared_ptr<Texture> texture =
+      context.texture_registry.GetTexture(texture_id_);
+  if (!texture) {
+    return;
+  }
+  texture->Paint(context.canvas, paint_bounds());
+}
+
+void TextureLayer::Serialize(LayerTreeWriter* writer) const {
+  writer->WriteOp(LayerTreeWriter::Op::kPushTexture);
+  writer->WritePoint(offset_);
+  writer->WriteSize(size_);
+  writer->WriteInt64(texture_id_);
+}
+
+}  // namespace flow
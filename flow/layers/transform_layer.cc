@@ -4,12 +4,21 @@
 
 #include "flutter/flow/layers/transform_layer.h"
 
+#include "flutter/flow/layer_tree_serialization.h"
+
 namespace flow {
 
 TransformLayer::TransformLayer() = default;
 
 TransformLayer::~TransformLayer() = default;
 
+uint64_t TransformLayer::PropertiesFingerprint() const {
+  uint64_t fingerprint = CombineFingerprint(0, FingerprintTag::kTransform);
+  SkScalar values[9];
+  transform_.get9(values);
+  return CombineFingerprint(fingerprint, values);
+}
+
 void TransformLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
   SkMatrix child_matrix;
   child_matrix.setConcat(matrix, transform_);
@@ -41,4 +50,10 @@ void TransformLayer::Paint(PaintContext& context) const {
   PaintChildren(context);
 }
 
+void TransformLayer::Serialize(LayerTreeWriter* writer) const {
+  writer->WriteOp(LayerTreeWriter::Op::kPushTransform);
+  writer->WriteMatrix(transform_);
+  SerializeChildren(writer);
+}
+
 }  // namespace flow
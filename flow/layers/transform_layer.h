@@ -20,10 +20,17 @@ class TransformLayer : public ContainerLayer {
 
   void Paint(PaintContext& context) const override;
 
+  void Serialize(LayerTreeWriter* writer) const override;
+
+  const char* type_name() const override { return "TransformLayer"; }
+
 #if defined(OS_FUCHSIA)
   void UpdateScene(SceneUpdateContext& context) override;
 #endif  // defined(OS_FUCHSIA)
 
+ protected:
+  uint64_t PropertiesFingerprint() const override;
+
  private:
   SkMatrix transform_;
 
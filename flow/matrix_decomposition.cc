@@ -25,10 +25,34 @@ static inline SkVector3 SkVector3Cross(const SkVector3& a, const SkVector3& b) {
   };
 }
 
+// Most matrices only scale up or down and translate, the decomposition of
+// which needs no arithmetic. Flips go through the general path, which folds
+// them into the signs of the scale and the rotation.
+static bool IsPositiveScaleTranslate(const SkMatrix& matrix) {
+  return matrix.isScaleTranslate() && matrix.getScaleX() > 0 &&
+         matrix.getScaleY() > 0;
+}
+
 MatrixDecomposition::MatrixDecomposition(const SkMatrix& matrix)
-    : MatrixDecomposition(SkMatrix44{matrix}) {}
+    : valid_(false) {
+  if (!IsPositiveScaleTranslate(matrix)) {
+    Decompose(SkMatrix44{matrix});
+    return;
+  }
+
+  translation_ = {matrix.getTranslateX(), matrix.getTranslateY(), 0};
+  scale_ = {matrix.getScaleX(), matrix.getScaleY(), 1};
+  shear_ = {0, 0, 0};
+  perspective_.set(0, 0, 0, 1);
+  rotation_.set(0, 0, 0, 1);
+  valid_ = true;
+}
 
 MatrixDecomposition::MatrixDecomposition(SkMatrix44 matrix) : valid_(false) {
+  Decompose(matrix);
+}
+
+void MatrixDecomposition::Decompose(SkMatrix44 matrix) {
   if (matrix.get(3, 3) == 0) {
     return;
   }
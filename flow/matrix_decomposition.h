@@ -43,6 +43,8 @@ class MatrixDecomposition {
   SkVector4 perspective_;
   SkVector4 rotation_;
 
+  void Decompose(SkMatrix44 matrix);
+
   FXL_DISALLOW_COPY_AND_ASSIGN(MatrixDecomposition);
 };
 
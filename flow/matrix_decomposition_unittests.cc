@@ -86,3 +86,28 @@ TEST(MatrixDecomposition, Combination) {
   ASSERT_FLOAT_EQ(sine, decomposition.rotation().fData[2]);
   ASSERT_FLOAT_EQ(cos(rotation * 0.5), decomposition.rotation().fData[3]);
 }
+
+TEST(MatrixDecomposition, ScaleTranslateMatchesGeneralDecomposition) {
+  SkMatrix matrix = SkMatrix::MakeScale(2.5, 0.75);
+  matrix.postTranslate(-12.5, 300);
+  ASSERT_TRUE(matrix.isScaleTranslate());
+
+  flow::MatrixDecomposition fast(matrix);
+  flow::MatrixDecomposition general{SkMatrix44(matrix)};
+  ASSERT_TRUE(fast.IsValid());
+  ASSERT_TRUE(general.IsValid());
+
+  auto expect_equal = [](const SkVector3& expected, const SkVector3& actual) {
+    ASSERT_FLOAT_EQ(expected.fX, actual.fX);
+    ASSERT_FLOAT_EQ(expected.fY, actual.fY);
+    ASSERT_FLOAT_EQ(expected.fZ, actual.fZ);
+  };
+  expect_equal(general.translation(), fast.translation());
+  expect_equal(general.scale(), fast.scale());
+  expect_equal(general.shear(), fast.shear());
+  for (int i = 0; i < 4; i++) {
+    ASSERT_FLOAT_EQ(general.perspective().fData[i],
+                    fast.perspective().fData[i]);
+    ASSERT_FLOAT_EQ(general.rotation().fData[i], fast.rotation().fData[i]);
+  }
+}
@@ -4,21 +4,57 @@
 
 #include "flutter/flow/raster_cache.h"
 
-#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 
 #include "flutter/common/threads.h"
 #include "flutter/flow/paint_utils.h"
 #include "flutter/glue/trace_event.h"
 #include "lib/fxl/logging.h"
+#include "lib/fxl/synchronization/waitable_event.h"
+#include "lib/fxl/time/time_point.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkImage.h"
 #include "third_party/skia/include/core/SkPicture.h"
+#include "third_party/skia/include/core/SkShader.h"
 #include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/utils/SkNoDrawCanvas.h"
+#include "third_party/skia/include/utils/SkPaintFilterCanvas.h"
 
 namespace flow {
 
+// The number of pending entries handed to the worker task runner at once.
+static constexpr size_t kConcurrentBatchSize = 8;
+
+// Pictures are rasterized in tiles of this many pixels square once either of
+// their dimensions at their raster scale exceeds |kMaxImageDimension|, which
+// GPUs commonly support as the size of textures.
+static constexpr int kTileDimension = 512;
+static constexpr float kMaxImageDimension = 2048;
+
+// The tiles within this many tiles of the visible part of a tiled picture
+// are kept and rasterized too.
+static constexpr float kTileMargin = 1;
+
+// Scales within this many buckets above a bucket are rasterized at that
+// bucket, so that rounding errors do not push a scale into the next one.
+static constexpr double kScaleBucketTolerance = 1e-3;
+
 RasterCache::RasterCache(size_t threshold)
-    : threshold_(threshold), checkerboard_images_(false), weak_factory_(this) {}
+    : threshold_(threshold),
+      max_bytes_(0),
+      resident_bytes_(0),
+      frame_number_(0),
+      frame_hit_count_(0),
+      frame_miss_count_(0),
+      total_hit_count_(0),
+      total_miss_count_(0),
+      deferred_population_(false),
+      allow_rgb565_(false),
+      scale_buckets_per_octave_(0),
+      checkerboard_images_(false),
+      weak_factory_(this) {}
 
 RasterCache::~RasterCache() = default;
 
@@ -42,56 +78,312 @@ static bool CanRasterizePicture(SkPicture* picture) {
   return true;
 }
 
-static bool IsPictureWorthRasterizing(SkPicture* picture,
-                                      bool will_change,
-                                      bool is_complex) {
-  if (will_change) {
-    // If the picture is going to change in the future, there is no point in
-    // doing to extra work to rasterize.
+// The estimated cost above which pictures are worth rasterizing before their
+// cost has been measured. Ten ordinary draws.
+static const int kMinEstimatedCost = 20;
+
+// Rasterized pictures must have taken at least this many microseconds to
+// draw per megabyte of their image to stay cached once their cost has been
+// measured.
+static const double kMinRasterizeMicrosecondsPerMegabyte = 10.0;
+
+// Pictures whose matrix changes in more than one in this many of the frames
+// they are drawn in are not rasterized, since their entries go unused.
+static const size_t kMinFramesPerMatrixChange = 4;
+
+// The statistics of pictures that have not been drawn for this many frames
+// are discarded.
+static const size_t kPictureStatsMaxAge = 120;
+
+// Plays back a picture to estimate how expensive it is to draw, in units of
+// half an ordinary draw. Simple shapes filled with a color are cheap, blurs
+// and other filters are expensive regardless of how few ops use them.
+class CostAnalyzer : public SkPaintFilterCanvas {
+ public:
+  explicit CostAnalyzer(SkCanvas* canvas) : SkPaintFilterCanvas(canvas) {}
+
+  int cost() const { return cost_; }
+
+ protected:
+  bool onFilter(SkTCopyOnFirstWrite<SkPaint>* paint, Type type) const override {
+    switch (type) {
+      case kPaint_Type:
+      case kPoint_Type:
+      case kRect_Type:
+      case kRRect_Type:
+      case kDRRect_Type:
+      case kOval_Type:
+        cost_ += 1;
+        break;
+      default:
+        cost_ += 2;
+        break;
+    }
+    cost_ += GetPaintCost(**paint);
+    // Nothing needs to be drawn.
     return false;
   }
 
-  if (!CanRasterizePicture(picture)) {
-    // No point in deciding whether the picture is worth rasterizing if it
-    // cannot be rasterized at all.
+  SaveLayerStrategy getSaveLayerStrategy(const SaveLayerRec& rec) override {
+    cost_ += 8;
+    if (rec.fPaint != nullptr) {
+      cost_ += GetPaintCost(*rec.fPaint);
+    }
+    if (rec.fBackdrop != nullptr) {
+      cost_ += 40;
+    }
+    SkPaintFilterCanvas::getSaveLayerStrategy(rec);
+    return kNoLayer_SaveLayerStrategy;
+  }
+
+ private:
+  mutable int cost_ = 0;
+
+  static int GetPaintCost(const SkPaint& paint) {
+    int cost = 0;
+    if (paint.getShader() != nullptr) {
+      cost += 2;
+    }
+    if (paint.getPathEffect() != nullptr) {
+      cost += 4;
+    }
+    if (paint.getMaskFilter() != nullptr || paint.getImageFilter() != nullptr) {
+      cost += 40;
+    }
+    return cost;
+  }
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(CostAnalyzer);
+};
+
+static int EstimatePictureCost(SkPicture* picture) {
+  const SkRect cull_rect = picture->cullRect();
+  SkNoDrawCanvas canvas(std::ceil(cull_rect.width()),
+                        std::ceil(cull_rect.height()));
+  CostAnalyzer analyzer(&canvas);
+  picture->playback(&analyzer);
+  return analyzer.cost();
+}
+
+// Whether drawing with |mode| over opaque pixels leaves them opaque.
+static bool PreservesOpacity(SkBlendMode mode) {
+  switch (mode) {
+    case SkBlendMode::kSrcOver:
+    case SkBlendMode::kDstOver:
+    case SkBlendMode::kSrcATop:
+    case SkBlendMode::kDst:
+    case SkBlendMode::kPlus:
+    case SkBlendMode::kScreen:
+      return true;
+    default:
+      // The separable and non-separable modes all compute the alpha like
+      // source-over does.
+      return mode > SkBlendMode::kLastCoeffMode;
+  }
+}
+
+static bool IsOpaquePaint(const SkPaint& paint) {
+  if (paint.getAlpha() != 0xFF || paint.getStyle() != SkPaint::kFill_Style) {
     return false;
   }
 
-  if (is_complex) {
-    // The caller seems to have extra information about the picture and thinks
-    // the picture is always worth rasterizing.
-    return true;
+  if (paint.getBlendMode() != SkBlendMode::kSrcOver &&
+      paint.getBlendMode() != SkBlendMode::kSrc) {
+    return false;
   }
 
-  // TODO(abarth): We should find a better heuristic here that lets us avoid
-  // wasting memory on trivial layers that are easy to re-rasterize every frame.
-  return picture->approximateOpCount() > 10;
+  if (paint.getShader() != nullptr && !paint.getShader()->isOpaque()) {
+    return false;
+  }
+
+  return paint.getColorFilter() == nullptr &&
+         paint.getMaskFilter() == nullptr &&
+         paint.getImageFilter() == nullptr && paint.getPathEffect() == nullptr;
 }
 
-RasterCacheResult RasterizePicture(SkPicture* picture,
-                                   GrContext* context,
-                                   const MatrixDecomposition& matrix,
-                                   SkColorSpace* dst_color_space,
-                                   bool checkerboard) {
-  TRACE_EVENT0("flutter", "RasterCachePopulate");
+// Plays back a picture to find out whether it fills its cull rect with opaque
+// pixels. That is the case when an unclipped rect or paint covers the cull
+// rect with an opaque paint and nothing drawn afterwards can lower the alpha.
+// Anything else is conservatively reported as translucent.
+class OpacityAnalyzer : public SkPaintFilterCanvas {
+ public:
+  OpacityAnalyzer(SkCanvas* canvas, const SkRect& bounds)
+      : SkPaintFilterCanvas(canvas), bounds_(bounds) {
+    clipped_.push_back(false);
+  }
 
-  const SkVector3& scale = matrix.scale();
+  bool is_opaque() const { return opaque_; }
+
+ protected:
+  bool onFilter(SkTCopyOnFirstWrite<SkPaint>* paint, Type) const override {
+    if (opaque_ && !PreservesOpacity((*paint)->getBlendMode())) {
+      opaque_ = false;
+    }
+    return false;
+  }
+
+  void onDrawPaint(const SkPaint& paint) override { OnDraw(bounds_, paint); }
+
+  void onDrawRect(const SkRect& rect, const SkPaint& paint) override {
+    if (!getTotalMatrix().rectStaysRect()) {
+      OnDraw(SkRect::MakeEmpty(), paint);
+      return;
+    }
+    SkRect device_rect;
+    getTotalMatrix().mapRect(&device_rect, rect);
+    OnDraw(device_rect, paint);
+  }
+
+  void willSave() override {
+    clipped_.push_back(clipped_.back());
+    SkPaintFilterCanvas::willSave();
+  }
+
+  SaveLayerStrategy getSaveLayerStrategy(const SaveLayerRec& rec) override {
+    // Draws into the layer do not count as covering the picture but the layer
+    // is composited with its paint on restore.
+    clipped_.push_back(true);
+    if (opaque_ && rec.fPaint != nullptr &&
+        !PreservesOpacity(rec.fPaint->getBlendMode())) {
+      opaque_ = false;
+    }
+    SkPaintFilterCanvas::getSaveLayerStrategy(rec);
+    return kNoLayer_SaveLayerStrategy;
+  }
+
+  void willRestore() override {
+    if (clipped_.size() > 1) {
+      clipped_.pop_back();
+    }
+    SkPaintFilterCanvas::willRestore();
+  }
+
+  void onClipRect(const SkRect& rect,
+                  SkClipOp op,
+                  ClipEdgeStyle edge_style) override {
+    SkRect device_rect;
+    getTotalMatrix().mapRect(&device_rect, rect);
+    if (op != SkClipOp::kIntersect || !getTotalMatrix().rectStaysRect() ||
+        !device_rect.contains(bounds_)) {
+      clipped_.back() = true;
+    }
+    SkPaintFilterCanvas::onClipRect(rect, op, edge_style);
+  }
+
+  void onClipRRect(const SkRRect& rrect,
+                   SkClipOp op,
+                   ClipEdgeStyle edge_style) override {
+    clipped_.back() = true;
+    SkPaintFilterCanvas::onClipRRect(rrect, op, edge_style);
+  }
+
+  void onClipPath(const SkPath& path,
+                  SkClipOp op,
+                  ClipEdgeStyle edge_style) override {
+    clipped_.back() = true;
+    SkPaintFilterCanvas::onClipPath(path, op, edge_style);
+  }
+
+  void onClipRegion(const SkRegion& region, SkClipOp op) override {
+    clipped_.back() = true;
+    SkPaintFilterCanvas::onClipRegion(region, op);
+  }
+
+ private:
+  const SkRect bounds_;
+  std::vector<bool> clipped_;
+  mutable bool opaque_ = false;
+
+  void OnDraw(const SkRect& device_rect, const SkPaint& paint) {
+    if (!clipped_.back() && device_rect.contains(bounds_) &&
+        IsOpaquePaint(paint)) {
+      opaque_ = true;
+      return;
+    }
+    SkTCopyOnFirstWrite<SkPaint> filtered(paint);
+    onFilter(&filtered, kRect_Type);
+  }
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(OpacityAnalyzer);
+};
+
+static bool AnalyzePictureOpacity(SkPicture* picture) {
+  const SkRect cull_rect = picture->cullRect();
+  SkNoDrawCanvas canvas(std::ceil(cull_rect.width()),
+                        std::ceil(cull_rect.height()));
+  OpacityAnalyzer analyzer(
+      &canvas, SkRect::MakeWH(cull_rect.width(), cull_rect.height()));
+  analyzer.translate(-cull_rect.left(), -cull_rect.top());
+  picture->playback(&analyzer);
+  return analyzer.is_opaque();
+}
+
+// Picks the smallest format that holds the contents without a visible loss
+// of precision in the destination. Sixteen bit formats are only used when
+// explicitly allowed since they band gradients.
+static SkImageInfo GetCacheImageInfo(int width,
+                                     int height,
+                                     SkColorSpace* dst_color_space,
+                                     bool opaque,
+                                     bool allow_rgb565) {
+  const SkAlphaType alpha_type =
+      opaque ? kOpaque_SkAlphaType : kPremul_SkAlphaType;
+
+  if (dst_color_space != nullptr && dst_color_space->gammaIsLinear()) {
+    // Eight bit formats cannot hold linear colors without banding.
+    return SkImageInfo::Make(width, height, kRGBA_F16_SkColorType, alpha_type,
+                             sk_ref_sp(dst_color_space));
+  }
+
+  if (opaque && allow_rgb565 && dst_color_space == nullptr) {
+    // 565 surfaces are only supported without a color space.
+    return SkImageInfo::Make(width, height, kRGB_565_SkColorType,
+                             kOpaque_SkAlphaType, nullptr);
+  }
+
+  return SkImageInfo::MakeN32(width, height, alpha_type,
+                              sk_ref_sp(dst_color_space));
+}
+
+static sk_sp<SkSurface> MakeSurface(GrContext* context,
+                                    const SkImageInfo& image_info) {
+  return context
+             ? SkSurface::MakeRenderTarget(context, SkBudgeted::kYes,
+                                           image_info)
+             : SkSurface::MakeRaster(image_info);
+}
 
-  const SkRect logical_rect = picture->cullRect();
+static RasterCacheResult Rasterize(
+    GrContext* context,
+    const SkRect& logical_rect,
+    const SkSize& scale,
+    SkColorSpace* dst_color_space,
+    bool checkerboard,
+    bool opaque,
+    bool allow_rgb565,
+    const std::function<void(SkCanvas*)>& draw_callback) {
   const SkRect physical_rect =
-      SkRect::MakeWH(std::fabs(logical_rect.width() * scale.x()),
-                     std::fabs(logical_rect.height() * scale.y()));
+      SkRect::MakeWH(std::fabs(logical_rect.width() * scale.width()),
+                     std::fabs(logical_rect.height() * scale.height()));
+
+  const int width = std::ceil(physical_rect.width());
+  const int height = std::ceil(physical_rect.height());
+
+  // Contents that do not cover whole pixels leave translucent edges.
+  opaque = opaque && width == physical_rect.width() &&
+           height == physical_rect.height();
+
+  SkImageInfo image_info = GetCacheImageInfo(width, height, dst_color_space,
+                                             opaque, allow_rgb565);
 
-  const SkImageInfo image_info = SkImageInfo::MakeN32Premul(
-      std::ceil(physical_rect.width()),   // physical width
-      std::ceil(physical_rect.height()),  // physical height
-      sk_ref_sp(dst_color_space)          // colorspace
-  );
+  sk_sp<SkSurface> surface = MakeSurface(context, image_info);
 
-  sk_sp<SkSurface> surface =
-      context
-          ? SkSurface::MakeRenderTarget(context, SkBudgeted::kYes, image_info)
-          : SkSurface::MakeRaster(image_info);
+  if (!surface && image_info.colorType() != kN32_SkColorType) {
+    // Not all GPUs can render to the smaller formats.
+    image_info = SkImageInfo::MakeN32(width, height, image_info.alphaType(),
+                                      sk_ref_sp(dst_color_space));
+    surface = MakeSurface(context, image_info);
+  }
 
   if (!surface) {
     return {};
@@ -100,9 +392,9 @@ RasterCacheResult RasterizePicture(SkPicture* picture,
   SkCanvas* canvas = surface->getCanvas();
 
   canvas->clear(SK_ColorTRANSPARENT);
-  canvas->scale(std::abs(scale.x()), std::abs(scale.y()));
+  canvas->scale(std::abs(scale.width()), std::abs(scale.height()));
   canvas->translate(-logical_rect.left(), -logical_rect.top());
-  canvas->drawPicture(picture);
+  draw_callback(canvas);
 
   if (checkerboard) {
     DrawCheckerboard(canvas, logical_rect);
@@ -115,6 +407,23 @@ RasterCacheResult RasterizePicture(SkPicture* picture,
   };
 }
 
+// Rasterizes the part of the picture within |bounds|. Parts of opaque
+// pictures are opaque too.
+static RasterCacheResult RasterizePicture(SkPicture* picture,
+                                          GrContext* context,
+                                          const SkRect& bounds,
+                                          const SkSize& scale,
+                                          SkColorSpace* dst_color_space,
+                                          bool checkerboard,
+                                          bool opaque,
+                                          bool allow_rgb565) {
+  TRACE_EVENT0("flutter", "RasterCachePopulate");
+
+  return Rasterize(context, bounds, scale, dst_color_space, checkerboard,
+                   opaque, allow_rgb565,
+                   [picture](SkCanvas* canvas) { canvas->drawPicture(picture); });
+}
+
 static inline size_t ClampSize(size_t value, size_t min, size_t max) {
   if (value > max) {
     return max;
@@ -127,6 +436,14 @@ static inline size_t ClampSize(size_t value, size_t min, size_t max) {
   return value;
 }
 
+static size_t GetImageByteSize(const sk_sp<SkImage>& image) {
+  if (!image) {
+    return 0;
+  }
+  return static_cast<size_t>(image->width()) * image->height() *
+         SkColorTypeBytesPerPixel(image->colorType());
+}
+
 RasterCacheResult RasterCache::GetPrerolledImage(
     GrContext* context,
     SkPicture* picture,
@@ -134,57 +451,645 @@ RasterCacheResult RasterCache::GetPrerolledImage(
     SkColorSpace* dst_color_space,
     bool is_complex,
     bool will_change) {
-  if (!IsPictureWorthRasterizing(picture, will_change, is_complex)) {
-    // We only deal with pictures that are worthy of rasterization.
+  if (will_change) {
+    // If the picture is going to change in the future, there is no point in
+    // doing to extra work to rasterize.
+    return {};
+  }
+
+  if (!CanRasterizePicture(picture) ||
+      ShouldTilePicture(picture, transformation_matrix)) {
     return {};
   }
 
   // Decompose the matrix (once) for all subsequent operations. We want to make
   // sure to avoid volumetric distortions while accounting for scaling.
-  const MatrixDecomposition matrix(transformation_matrix);
+  const MatrixDecomposition& matrix = Decompose(transformation_matrix);
 
   if (!matrix.IsValid()) {
     // The matrix was singular. No point in going further.
     return {};
   }
 
-  RasterCacheKey cache_key(*picture, matrix);
+  const SkSize scale = GetRasterScale(matrix);
+  RasterCacheKey cache_key(*picture, scale);
+
+  // The caller may have extra information about the picture and think that
+  // it is always worth rasterizing.
+  if (!IsPictureWorthRasterizing(picture, cache_key) && !is_complex) {
+    return {};
+  }
 
   Entry& entry = cache_[cache_key];
-  entry.access_count = ClampSize(entry.access_count + 1, 0, threshold_);
-  entry.used_this_frame = true;
 
-  if (entry.access_count < threshold_ || threshold_ == 0) {
+  if (entry.image.is_valid()) {
+    frame_hit_count_++;
+  } else {
+    frame_miss_count_++;
+  }
+
+  if (!MarkAccessed(entry)) {
     // Frame threshold has not yet been reached.
     return {};
   }
 
   if (!entry.image.is_valid()) {
-    entry.image = RasterizePicture(picture, context, matrix, dst_color_space,
-                                   checkerboard_images_);
+    PopulateEntry(context, cache_key, entry, picture, picture->cullRect(),
+                  scale, dst_color_space);
+  }
+
+  return entry.image;
+}
+
+void RasterCache::PopulateEntry(GrContext* context,
+                                const RasterCacheKey& key,
+                                Entry& entry,
+                                SkPicture* picture,
+                                const SkRect& bounds,
+                                const SkSize& scale,
+                                SkColorSpace* dst_color_space) {
+  if (deferred_population_) {
+    if (!entry.pending_picture) {
+      entry.pending_picture = sk_ref_sp(picture);
+      entry.pending_scale = scale;
+      entry.pending_bounds = bounds;
+      entry.pending_color_space = sk_ref_sp(dst_color_space);
+      entry.pending_opaque = IsPictureOpaque(picture);
+      pending_.push_back(key);
+    }
+    return;
+  }
+  const fxl::TimePoint start = fxl::TimePoint::Now();
+  RasterCacheResult image = RasterizePicture(
+      picture, context, bounds, scale, dst_color_space, checkerboard_images_,
+      IsPictureOpaque(picture), allow_rgb565_);
+  RecordRasterizeTime(*picture, image, fxl::TimePoint::Now() - start);
+  AddRasterizedImage(entry, std::move(image));
+}
+
+RasterCacheTiles::RasterCacheTiles()
+    : bounds_(SkRect::MakeEmpty()), tile_size_(SkSize::MakeEmpty()) {}
+
+RasterCacheTiles::~RasterCacheTiles() = default;
+
+SkIRect RasterCacheTiles::GetTileRange(const SkRect& rect) const {
+  SkRect tiled_rect;
+  if (tile_size_.isEmpty() || !tiled_rect.intersect(rect, bounds_)) {
+    return SkIRect::MakeEmpty();
+  }
+  tiled_rect.offset(-bounds_.left(), -bounds_.top());
+  // Rects that merely touch a tile do not intersect it.
+  return SkIRect::MakeLTRB(
+      static_cast<int32_t>(std::floor(tiled_rect.left() / tile_size_.width())),
+      static_cast<int32_t>(std::floor(tiled_rect.top() / tile_size_.height())),
+      static_cast<int32_t>(std::ceil(tiled_rect.right() / tile_size_.width())),
+      static_cast<int32_t>(
+          std::ceil(tiled_rect.bottom() / tile_size_.height())));
+}
+
+bool RasterCacheTiles::Covers(const SkRect& rect) const {
+  const SkIRect range = GetTileRange(rect);
+  if (range.isEmpty()) {
+    // Nothing of the picture is within the rect.
+    return true;
+  }
+  const size_t needed = static_cast<size_t>(range.width()) * range.height();
+  size_t found = 0;
+  for (const auto& tile : tiles_) {
+    if (range.contains(tile.first.x(), tile.first.y())) {
+      found++;
+    }
+  }
+  return found == needed;
+}
+
+void RasterCacheTiles::Draw(SkCanvas& canvas,
+                            const SkRect& rect,
+                            const SkPaint* paint) const {
+  const SkIRect range = GetTileRange(rect);
+  for (const auto& tile : tiles_) {
+    if (!range.contains(tile.first.x(), tile.first.y())) {
+      continue;
+    }
+    const RasterCacheResult& image = tile.second;
+    canvas.drawImageRect(image.image(),                      // image
+                         image.source_rect(),                // source
+                         image.destination_rect(),           // destination
+                         paint,                              // paint
+                         SkCanvas::kStrict_SrcRectConstraint  // constraint
+                         );
+  }
+}
+
+bool RasterCache::ShouldTilePicture(
+    SkPicture* picture,
+    const SkMatrix& transformation_matrix) const {
+  if (!CanRasterizePicture(picture)) {
+    return false;
+  }
+  const MatrixDecomposition& matrix = Decompose(transformation_matrix);
+  if (!matrix.IsValid()) {
+    return false;
+  }
+  const SkSize scale = GetRasterScale(matrix);
+  const SkRect cull_rect = picture->cullRect();
+  return std::fabs(cull_rect.width() * scale.width()) > kMaxImageDimension ||
+         std::fabs(cull_rect.height() * scale.height()) > kMaxImageDimension;
+}
+
+RasterCacheTiles RasterCache::GetPrerolledTiles(
+    GrContext* context,
+    SkPicture* picture,
+    const SkMatrix& transformation_matrix,
+    const SkRect& cull_rect,
+    SkColorSpace* dst_color_space,
+    bool is_complex,
+    bool will_change) {
+  if (will_change || !CanRasterizePicture(picture)) {
+    return {};
+  }
+
+  const MatrixDecomposition& matrix = Decompose(transformation_matrix);
+  SkMatrix inverse;
+  if (!matrix.IsValid() || !transformation_matrix.invert(&inverse)) {
+    return {};
+  }
+
+  const SkSize scale = GetRasterScale(matrix);
+  if (!IsPictureWorthRasterizing(picture, RasterCacheKey(*picture, scale)) &&
+      !is_complex) {
+    return {};
+  }
+
+  RasterCacheTiles tiles;
+  tiles.bounds_ = picture->cullRect();
+  tiles.tile_size_ = SkSize::Make(kTileDimension / std::fabs(scale.width()),
+                                  kTileDimension / std::fabs(scale.height()));
+
+  // The tiles within the margin are rasterized before they scroll into view.
+  SkRect visible_rect;
+  inverse.mapRect(&visible_rect, cull_rect);
+  const SkRect kept_rect =
+      visible_rect.makeOutset(tiles.tile_size_.width() * kTileMargin,
+                              tiles.tile_size_.height() * kTileMargin);
+  const SkIRect visible_range = tiles.GetTileRange(visible_rect);
+  const SkIRect kept_range = tiles.GetTileRange(kept_rect);
+
+  for (int row = kept_range.top(); row < kept_range.bottom(); row++) {
+    for (int column = kept_range.left(); column < kept_range.right();
+         column++) {
+      const SkIPoint index = SkIPoint::Make(column, row);
+      const RasterCacheKey key(*picture, scale, index);
+      Entry& entry = cache_[key];
+      const bool visible = visible_range.contains(column, row);
+
+      if (visible) {
+        if (entry.image.is_valid()) {
+          frame_hit_count_++;
+        } else {
+          frame_miss_count_++;
+        }
+      }
+
+      if (!MarkAccessed(entry)) {
+        continue;
+      }
+
+      if (!entry.image.is_valid()) {
+        SkRect tile_bounds = SkRect::MakeXYWH(
+            tiles.bounds_.left() + column * tiles.tile_size_.width(),
+            tiles.bounds_.top() + row * tiles.tile_size_.height(),
+            tiles.tile_size_.width(), tiles.tile_size_.height());
+        if (!tile_bounds.intersect(tiles.bounds_)) {
+          continue;
+        }
+        PopulateEntry(context, key, entry, picture, tile_bounds, scale,
+                      dst_color_space);
+      }
+
+      if (visible && entry.image.is_valid()) {
+        tiles.tiles_.emplace_back(index, entry.image);
+      }
+    }
+  }
+
+  return tiles;
+}
+
+RasterCacheResult RasterCache::GetPrerolledImage(
+    GrContext* context,
+    uint64_t layer_fingerprint,
+    const SkRect& bounds,
+    const SkMatrix& transformation_matrix,
+    SkColorSpace* dst_color_space,
+    const std::function<void(SkCanvas*)>& draw_callback) {
+  if (layer_fingerprint == 0 || bounds.isEmpty() || !bounds.isFinite()) {
+    return {};
+  }
+
+  const MatrixDecomposition& matrix = Decompose(transformation_matrix);
+
+  if (!matrix.IsValid()) {
+    return {};
+  }
+
+  const SkSize scale = GetRasterScale(matrix);
+  Entry& entry = cache_[RasterCacheKey(layer_fingerprint, scale)];
+
+  if (entry.image.is_valid()) {
+    frame_hit_count_++;
+  } else {
+    frame_miss_count_++;
+  }
+
+  if (!MarkAccessed(entry)) {
+    return {};
+  }
+
+  if (!entry.image.is_valid()) {
+    TRACE_EVENT0("flutter", "RasterCachePopulateLayer");
+    AddRasterizedImage(entry,
+                       Rasterize(context, bounds, scale, dst_color_space,
+                                 checkerboard_images_, false, allow_rgb565_,
+                                 draw_callback));
   }
 
   return entry.image;
 }
 
+bool RasterCache::HasImage(uint64_t layer_fingerprint,
+                           const SkMatrix& transformation_matrix) const {
+  if (layer_fingerprint == 0) {
+    return false;
+  }
+
+  const MatrixDecomposition& matrix = Decompose(transformation_matrix);
+
+  if (!matrix.IsValid()) {
+    return false;
+  }
+
+  auto found = cache_.find(
+      RasterCacheKey(layer_fingerprint, GetRasterScale(matrix)));
+  return found != cache_.end() && found->second.image.is_valid();
+}
+
+const MatrixDecomposition& RasterCache::Decompose(
+    const SkMatrix& matrix) const {
+  if (!decomposition_ || matrix != decomposed_matrix_) {
+    decomposition_ = std::make_unique<MatrixDecomposition>(matrix);
+    decomposed_matrix_ = matrix;
+  }
+  return *decomposition_;
+}
+
+static float QuantizeScale(float scale, size_t buckets_per_octave) {
+  const double magnitude = std::fabs(scale);
+  if (magnitude == 0) {
+    return scale;
+  }
+  const double bucket = std::ceil(std::log2(magnitude) * buckets_per_octave -
+                                  kScaleBucketTolerance);
+  return std::copysign(std::exp2(bucket / buckets_per_octave), scale);
+}
+
+SkSize RasterCache::GetRasterScale(const MatrixDecomposition& matrix) const {
+  const SkVector3& scale = matrix.scale();
+  if (scale_buckets_per_octave_ == 0) {
+    return SkSize::Make(scale.x(), scale.y());
+  }
+  return SkSize::Make(QuantizeScale(scale.x(), scale_buckets_per_octave_),
+                      QuantizeScale(scale.y(), scale_buckets_per_octave_));
+}
+
+bool RasterCache::IsPictureWorthRasterizing(SkPicture* picture,
+                                            const RasterCacheKey& key) {
+  PictureStats& stats = picture_stats_[picture->uniqueID()];
+  if (stats.frames_seen == 0 || stats.last_seen_frame != frame_number_) {
+    if (stats.frames_seen != 0 && stats.last_seen_frame + 1 == frame_number_ &&
+        stats.last_scale_key != key.scale_key()) {
+      stats.matrix_changes++;
+    }
+    stats.frames_seen++;
+    stats.last_seen_frame = frame_number_;
+    stats.last_scale_key = key.scale_key();
+  }
+
+  if (stats.matrix_changes * kMinFramesPerMatrixChange > stats.frames_seen) {
+    // The picture is animating. Entries for its scales would go unused.
+    return false;
+  }
+
+  if (stats.rasterize_byte_size > 0) {
+    // Keep the picture cached only if drawing it directly takes long enough
+    // to justify the memory of its image.
+    const double megabytes = stats.rasterize_byte_size / (1024.0 * 1024.0);
+    return stats.rasterize_time.ToMicroseconds() >=
+           kMinRasterizeMicrosecondsPerMegabyte * megabytes;
+  }
+
+  if (stats.estimated_cost < 0) {
+    stats.estimated_cost = EstimatePictureCost(picture);
+  }
+  return stats.estimated_cost > kMinEstimatedCost;
+}
+
+bool RasterCache::IsPictureOpaque(SkPicture* picture) {
+  PictureStats& stats = picture_stats_[picture->uniqueID()];
+  if (stats.opaque < 0) {
+    stats.opaque = AnalyzePictureOpacity(picture) ? 1 : 0;
+  }
+  return stats.opaque == 1;
+}
+
+void RasterCache::RecordRasterizeTime(const SkPicture& picture,
+                                      const RasterCacheResult& image,
+                                      fxl::TimeDelta time) {
+  if (!image.is_valid()) {
+    return;
+  }
+  auto found = picture_stats_.find(picture.uniqueID());
+  if (found == picture_stats_.end()) {
+    return;
+  }
+  found->second.rasterize_time = time;
+  found->second.rasterize_byte_size = GetImageByteSize(image.image());
+}
+
+bool RasterCache::MarkAccessed(Entry& entry) {
+  if (!entry.accessed) {
+    entry.accessed = true;
+    entry.first_used_frame = frame_number_;
+  }
+  entry.access_count = ClampSize(entry.access_count + 1, 0, threshold_);
+  entry.used_this_frame = true;
+  entry.last_used_frame = frame_number_;
+  return entry.access_count >= threshold_ && threshold_ != 0;
+}
+
+void RasterCache::AddRasterizedImage(Entry& entry, RasterCacheResult image) {
+  entry.image = std::move(image);
+  entry.byte_size = GetImageByteSize(entry.image.image());
+  resident_bytes_ += entry.byte_size;
+}
+
+size_t RasterCache::PopulatePendingEntries(GrContext* context,
+                                           fxl::TimeDelta budget) {
+  if (pending_.empty()) {
+    return 0;
+  }
+
+  TRACE_EVENT0("flutter", "RasterCache::PopulatePendingEntries");
+
+  const fxl::TimePoint deadline = fxl::TimePoint::Now() + budget;
+  bool populated_any = false;
+
+  // Concurrent population proceeds in batches so that the time budget is still
+  // checked periodically.
+  const size_t batch_size = worker_task_runner_ ? kConcurrentBatchSize : 1;
+
+  while (!pending_.empty()) {
+    if (populated_any && fxl::TimePoint::Now() >= deadline) {
+      break;
+    }
+
+    std::vector<Entry*> entries = TakePendingEntries(batch_size);
+
+    if (worker_task_runner_) {
+      PopulateEntriesConcurrently(context, entries);
+    } else {
+      for (Entry* entry : entries) {
+        const fxl::TimePoint start = fxl::TimePoint::Now();
+        RasterCacheResult image = RasterizePicture(
+            entry->pending_picture.get(), context, entry->pending_bounds,
+            entry->pending_scale, entry->pending_color_space.get(),
+            checkerboard_images_, entry->pending_opaque, allow_rgb565_);
+        RecordRasterizeTime(*entry->pending_picture, image,
+                            fxl::TimePoint::Now() - start);
+        AddRasterizedImage(*entry, std::move(image));
+      }
+    }
+
+    for (Entry* entry : entries) {
+      entry->pending_picture = nullptr;
+      entry->pending_color_space = nullptr;
+    }
+
+    populated_any = populated_any || !entries.empty();
+  }
+
+  return pending_.size();
+}
+
+std::vector<RasterCache::Entry*> RasterCache::TakePendingEntries(
+    size_t max_count) {
+  std::vector<Entry*> entries;
+
+  while (!pending_.empty() && entries.size() < max_count) {
+    RasterCacheKey key = pending_.front();
+    pending_.pop_front();
+
+    auto found = cache_.find(key);
+    if (found == cache_.end()) {
+      // The entry was swept since it was queued.
+      continue;
+    }
+
+    Entry& entry = found->second;
+    if (!entry.pending_picture || entry.image.is_valid()) {
+      continue;
+    }
+
+    entries.push_back(&entry);
+  }
+
+  return entries;
+}
+
+void RasterCache::PopulateEntriesConcurrently(
+    GrContext* context,
+    const std::vector<Entry*>& entries) {
+  if (entries.empty()) {
+    return;
+  }
+
+  TRACE_EVENT0("flutter", "RasterCache::PopulateEntriesConcurrently");
+
+  // The GrContext may only be used on this thread. So the workers rasterize
+  // into CPU backed surfaces and the results are uploaded here.
+  std::vector<RasterCacheResult> results(entries.size());
+  std::vector<fxl::TimeDelta> times(entries.size());
+  std::atomic<size_t> remaining(entries.size());
+  fxl::AutoResetWaitableEvent latch;
+  const bool checkerboard = checkerboard_images_;
+  const bool allow_rgb565 = allow_rgb565_;
+
+  for (size_t i = 0; i < entries.size(); i++) {
+    Entry* entry = entries[i];
+    RasterCacheResult* result = &results[i];
+    fxl::TimeDelta* time = &times[i];
+    worker_task_runner_->PostTask([entry, result, time, checkerboard,
+                                   allow_rgb565, &remaining, &latch]() {
+      const fxl::TimePoint start = fxl::TimePoint::Now();
+      *result = RasterizePicture(
+          entry->pending_picture.get(), nullptr, entry->pending_bounds,
+          entry->pending_scale, entry->pending_color_space.get(), checkerboard,
+          entry->pending_opaque, allow_rgb565);
+      *time = fxl::TimePoint::Now() - start;
+      if (--remaining == 0) {
+        latch.Signal();
+      }
+    });
+  }
+
+  latch.Wait();
+
+  for (size_t i = 0; i < entries.size(); i++) {
+    RasterCacheResult& result = results[i];
+    if (context != nullptr && result.is_valid()) {
+      TRACE_EVENT0("flutter", "RasterCacheUpload");
+      sk_sp<SkImage> texture = result.image()->makeTextureImage(
+          context, entries[i]->pending_color_space.get());
+      if (texture) {
+        result = {std::move(texture), result.source_rect(),
+                  result.destination_rect()};
+      }
+    }
+    RecordRasterizeTime(*entries[i]->pending_picture, result, times[i]);
+    AddRasterizedImage(*entries[i], std::move(result));
+  }
+}
+
 void RasterCache::SweepAfterFrame() {
   std::vector<RasterCacheKey::Map<Entry>::iterator> dead;
+  std::vector<RasterCacheKey::Map<Entry>::iterator> evictable;
 
   for (auto it = cache_.begin(); it != cache_.end(); ++it) {
     Entry& entry = it->second;
     if (!entry.used_this_frame) {
-      dead.push_back(it);
+      // Entries that have not been rasterized yet hold no memory but must be
+      // accessed on consecutive frames to reach the threshold. Rasterized
+      // entries may be retained if there is a memory budget to hold them.
+      if (max_bytes_ == 0 || !entry.image.is_valid()) {
+        dead.push_back(it);
+      } else {
+        evictable.push_back(it);
+      }
     }
     entry.used_this_frame = false;
   }
 
   for (auto it : dead) {
+    resident_bytes_ -= it->second.byte_size;
     cache_.erase(it);
   }
+
+  if (resident_bytes_ > max_bytes_ && !evictable.empty()) {
+    // Evict the least recently used entries first. Entries used in this frame
+    // are never evicted since they are still on screen.
+    std::sort(evictable.begin(), evictable.end(),
+              [](const RasterCacheKey::Map<Entry>::iterator& lhs,
+                 const RasterCacheKey::Map<Entry>::iterator& rhs) {
+                return lhs->second.last_used_frame <
+                       rhs->second.last_used_frame;
+              });
+    for (auto it : evictable) {
+      if (resident_bytes_ <= max_bytes_) {
+        break;
+      }
+      resident_bytes_ -= it->second.byte_size;
+      cache_.erase(it);
+    }
+  }
+
+  for (auto it = picture_stats_.begin(); it != picture_stats_.end();) {
+    if (frame_number_ - it->second.last_seen_frame > kPictureStatsMaxAge) {
+      it = picture_stats_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  frame_number_++;
+  total_hit_count_ += frame_hit_count_;
+  total_miss_count_ += frame_miss_count_;
+  frame_hit_count_ = 0;
+  frame_miss_count_ = 0;
+}
+
+void RasterCache::SetThreshold(size_t threshold) {
+  threshold_ = threshold;
+}
+
+std::vector<RasterCache::EntryInfo> RasterCache::GetEntries() const {
+  std::vector<EntryInfo> entries;
+  entries.reserve(cache_.size());
+  for (const auto& item : cache_) {
+    const Entry& entry = item.second;
+    EntryInfo info;
+    info.kind = item.first.kind();
+    info.id = item.first.id();
+    info.scale_key = item.first.scale_key();
+    info.tile = item.first.tile();
+    info.image_size = entry.image.is_valid()
+                          ? SkISize::Make(entry.image.image()->width(),
+                                          entry.image.image()->height())
+                          : SkISize::MakeEmpty();
+    info.byte_size = entry.byte_size;
+    info.access_count = entry.access_count;
+    info.age = frame_number_ - entry.first_used_frame;
+    info.pending = static_cast<bool>(entry.pending_picture);
+    entries.push_back(info);
+  }
+  return entries;
 }
 
 void RasterCache::Clear() {
   cache_.clear();
+  pending_.clear();
+  resident_bytes_ = 0;
+}
+
+void RasterCache::SetDeferredPopulation(bool deferred) {
+  deferred_population_ = deferred;
+  if (!deferred_population_) {
+    pending_.clear();
+    for (auto& item : cache_) {
+      item.second.pending_picture = nullptr;
+      item.second.pending_color_space = nullptr;
+    }
+  }
+}
+
+void RasterCache::SetWorkerTaskRunner(
+    fxl::RefPtr<fxl::TaskRunner> worker_task_runner) {
+  worker_task_runner_ = std::move(worker_task_runner);
+}
+
+void RasterCache::SetAllowRGB565(bool allow) {
+  if (allow_rgb565_ == allow) {
+    return;
+  }
+
+  allow_rgb565_ = allow;
+
+  // Rasterize the existing entries again in the new format.
+  Clear();
+}
+
+void RasterCache::SetScaleBucketsPerOctave(size_t buckets) {
+  if (scale_buckets_per_octave_ == buckets) {
+    return;
+  }
+
+  scale_buckets_per_octave_ = buckets;
+
+  // The existing entries are keyed by the old scales.
+  Clear();
+}
+
+void RasterCache::SetMaxBytes(size_t max_bytes) {
+  max_bytes_ = max_bytes;
 }
 
 void RasterCache::SetCheckboardCacheImages(bool checkerboard) {
@@ -5,13 +5,21 @@
 #ifndef FLUTTER_FLOW_RASTER_CACHE_H_
 #define FLUTTER_FLOW_RASTER_CACHE_H_
 
+#include <deque>
+#include <functional>
 #include <memory>
+#include <utility>
 #include <unordered_map>
+#include <vector>
 
 #include "flutter/flow/instrumentation.h"
+#include "flutter/flow/matrix_decomposition.h"
 #include "flutter/flow/raster_cache_key.h"
 #include "lib/fxl/macros.h"
 #include "lib/fxl/memory/weak_ptr.h"
+#include "lib/fxl/tasks/task_runner.h"
+#include "lib/fxl/time/time_delta.h"
+#include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkImage.h"
 #include "third_party/skia/include/core/SkSize.h"
 
@@ -44,8 +52,57 @@ class RasterCacheResult {
   SkRect destination_rect_;
 };
 
+// The rasterized tiles of a picture too large to be rasterized into a single
+// image. Only the tiles near the visible part of the picture are rasterized.
+class RasterCacheTiles {
+ public:
+  RasterCacheTiles();
+
+  ~RasterCacheTiles();
+
+  bool empty() const { return tiles_.empty(); }
+
+  // Whether the rasterized tiles cover all of |rect|, in the coordinates of
+  // the picture. The picture has to be drawn directly where they do not.
+  bool Covers(const SkRect& rect) const;
+
+  // Draws the tiles that intersect |rect| with |paint|.
+  void Draw(SkCanvas& canvas, const SkRect& rect, const SkPaint* paint) const;
+
+ private:
+  friend class RasterCache;
+
+  // The cull rect of the picture and the size of the tiles it is split into,
+  // both in the coordinates of the picture.
+  SkRect bounds_;
+  SkSize tile_size_;
+  std::vector<std::pair<SkIPoint, RasterCacheResult>> tiles_;
+
+  // The columns and rows of the tiles that intersect |rect|. Empty if none
+  // do.
+  SkIRect GetTileRange(const SkRect& rect) const;
+};
+
 class RasterCache {
  public:
+  // What is known about an entry, for inspecting the cache.
+  struct EntryInfo {
+    RasterCacheKey::Kind kind;
+    // The unique ID of the picture or the fingerprint of the layer subtree.
+    uint64_t id;
+    // The scale the entry is rasterized at, in thousandths.
+    SkISize scale_key;
+    // The column and row of picture tiles.
+    SkIPoint tile;
+    // Empty until the entry is rasterized.
+    SkISize image_size;
+    size_t byte_size;
+    size_t access_count;
+    // The number of frames since the entry was first accessed.
+    size_t age;
+    bool pending;
+  };
+
   explicit RasterCache(size_t threshold = 3);
 
   ~RasterCache();
@@ -57,21 +114,226 @@ class RasterCache {
                                       bool is_complex,
                                       bool will_change);
 
+  // Whether the picture is too large to be rasterized into a single image at
+  // the scale of |transformation_matrix|. Such pictures are cached in tiles
+  // with |GetPrerolledTiles| instead of |GetPrerolledImage|.
+  bool ShouldTilePicture(SkPicture* picture,
+                         const SkMatrix& transformation_matrix) const;
+
+  // Returns the rasterized tiles of a picture that intersect |cull_rect|, in
+  // device space, and keeps the tiles within a margin around it alive. Each
+  // tile crosses the access threshold on its own, so tiles scrolled into view
+  // are rasterized as they come near it.
+  RasterCacheTiles GetPrerolledTiles(GrContext* context,
+                                     SkPicture* picture,
+                                     const SkMatrix& transformation_matrix,
+                                     const SkRect& cull_rect,
+                                     SkColorSpace* dst_color_space,
+                                     bool is_complex,
+                                     bool will_change);
+
+  // Returns the rasterized image of a layer subtree identified by
+  // |layer_fingerprint| once it has been accessed on |threshold_| consecutive
+  // frames. |draw_callback| paints the subtree in its own coordinate space and
+  // is only invoked (synchronously) when the subtree needs to be rasterized.
+  // |bounds| are the paint bounds of the subtree in that coordinate space.
+  // Layer subtrees are never deferred since the callback cannot outlive the
+  // frame.
+  RasterCacheResult GetPrerolledImage(
+      GrContext* context,
+      uint64_t layer_fingerprint,
+      const SkRect& bounds,
+      const SkMatrix& transformation_matrix,
+      SkColorSpace* dst_color_space,
+      const std::function<void(SkCanvas*)>& draw_callback);
+
+  // Whether a rasterized image of the layer subtree is already available. Does
+  // not count as an access of the entry.
+  bool HasImage(uint64_t layer_fingerprint,
+                const SkMatrix& transformation_matrix) const;
+
   void SweepAfterFrame();
 
+  // Incremented by each |SweepAfterFrame|.
+  size_t frame_number() const { return frame_number_; }
+
   void Clear();
 
   void SetCheckboardCacheImages(bool checkerboard);
 
+  // Sets the number of consecutive frames an entry must be accessed on before
+  // it is rasterized. Zero disables rasterization.
+  void SetThreshold(size_t threshold);
+
+  size_t threshold() const { return threshold_; }
+
+  std::vector<EntryInfo> GetEntries() const;
+
+  size_t entry_count() const { return cache_.size(); }
+
+  // Sets the number of bytes rasterized entries may occupy before the least
+  // recently used ones are evicted. A budget of zero (the default) evicts every
+  // entry that was not used in the frame being swept.
+  void SetMaxBytes(size_t max_bytes);
+
+  size_t max_bytes() const { return max_bytes_; }
+
+  // Allows pictures found to be opaque to be rasterized into 565 images when
+  // the destination has no color space. This halves their memory and the
+  // bandwidth to draw them at the cost of banding in gradients. Opaque
+  // pictures are otherwise rasterized without alpha so that drawing them
+  // needs no blending.
+  void SetAllowRGB565(bool allow);
+
+  bool allow_rgb565() const { return allow_rgb565_; }
+
+  // Rasterizes entries at the next of |buckets| scales per power of two at or
+  // above the scale they are drawn at, which then draw the image slightly
+  // downsampled. During zoom animations most frames then reuse the entries of
+  // the previous ones. Zero (the default) rasterizes at the exact scale.
+  void SetScaleBucketsPerOctave(size_t buckets);
+
+  size_t scale_buckets_per_octave() const { return scale_buckets_per_octave_; }
+
+  // The number of bytes currently occupied by rasterized entries.
+  size_t resident_bytes() const { return resident_bytes_; }
+
+  // The number of lookups of pictures and layer subtrees worth caching since
+  // the last |SweepAfterFrame| that found a rasterized image, and that did
+  // not.
+  size_t frame_hit_count() const { return frame_hit_count_; }
+
+  size_t frame_miss_count() const { return frame_miss_count_; }
+
+  // The hits and misses of all frames swept so far.
+  size_t total_hit_count() const { return total_hit_count_; }
+
+  size_t total_miss_count() const { return total_miss_count_; }
+
+  // When enabled, pictures that cross the access threshold are queued instead
+  // of being rasterized during preroll. Callers must drain the queue using
+  // |PopulatePendingEntries|. Until an entry is populated, the caller is
+  // expected to draw the picture directly.
+  void SetDeferredPopulation(bool deferred);
+
+  bool deferred_population() const { return deferred_population_; }
+
+  // Rasterizes queued entries in the order they crossed the threshold until
+  // the time budget is exhausted. At least one entry is rasterized per call so
+  // that the queue always makes progress. Returns the number of entries still
+  // waiting to be rasterized.
+  size_t PopulatePendingEntries(GrContext* context, fxl::TimeDelta budget);
+
+  size_t pending_entry_count() const { return pending_.size(); }
+
+  // When a runner is set, |PopulatePendingEntries| rasterizes queued pictures
+  // concurrently into CPU backed surfaces on the runner and uploads the
+  // results to |context| on the calling thread. Tasks posted to the runner
+  // must be allowed to run concurrently. Pass null to rasterize serially.
+  void SetWorkerTaskRunner(fxl::RefPtr<fxl::TaskRunner> worker_task_runner);
+
  private:
   struct Entry {
     bool used_this_frame = false;
     size_t access_count = 0;
+    size_t last_used_frame = 0;
+    // Whether |first_used_frame| is set.
+    bool accessed = false;
+    size_t first_used_frame = 0;
+    size_t byte_size = 0;
     RasterCacheResult image;
+    // Only set while the entry is waiting for deferred population.
+    sk_sp<SkPicture> pending_picture;
+    SkSize pending_scale = SkSize::Make(1, 1);
+    // The part of the picture to rasterize, its cull rect unless the entry
+    // is a tile.
+    SkRect pending_bounds = SkRect::MakeEmpty();
+    sk_sp<SkColorSpace> pending_color_space;
+    bool pending_opaque = false;
   };
 
-  const size_t threshold_;
+  // What is known about a picture across the entries for its scales.
+  struct PictureStats {
+    // The cost estimated from the contents of the picture. Negative until it
+    // is first needed.
+    int estimated_cost = -1;
+    // Whether the picture fills its cull rect with opaque pixels. Negative
+    // until it is first needed.
+    int opaque = -1;
+    // How long it took to rasterize the picture, and the size of the image,
+    // the last time it was rasterized. Zero if it never was.
+    fxl::TimeDelta rasterize_time;
+    size_t rasterize_byte_size = 0;
+    size_t frames_seen = 0;
+    // The number of frames in which the picture was drawn at a different
+    // scale than in the frame before.
+    size_t matrix_changes = 0;
+    size_t last_seen_frame = 0;
+    SkISize last_scale_key = SkISize::MakeEmpty();
+  };
+
+  // Whether caching the picture pays off. The rasterization time measured
+  // the last time the picture was rasterized is weighed against the memory
+  // of its image. Until it has been measured, the cost is estimated from the
+  // contents. Pictures whose scale keeps changing are never worth it.
+  bool IsPictureWorthRasterizing(SkPicture* picture, const RasterCacheKey& key);
+
+  // Whether the picture fills its cull rect with opaque pixels. Kept in the
+  // statistics of the picture so that its tiles only analyze it once.
+  bool IsPictureOpaque(SkPicture* picture);
+
+  // The pictures under a transform layer share its matrix, so the
+  // decomposition of the last matrix is kept for the next lookup.
+  const MatrixDecomposition& Decompose(const SkMatrix& matrix) const;
+
+  // The scale of the matrix the entries drawn with it are rasterized at.
+  SkSize GetRasterScale(const MatrixDecomposition& matrix) const;
+
+  void RecordRasterizeTime(const SkPicture& picture,
+                           const RasterCacheResult& image,
+                           fxl::TimeDelta time);
+
+  // Updates the access bookkeeping of the entry and returns whether it has
+  // crossed the threshold.
+  bool MarkAccessed(Entry& entry);
+
+  void AddRasterizedImage(Entry& entry, RasterCacheResult image);
+
+  // Rasterizes the part of the picture within |bounds| into the entry now,
+  // or queues it if population is deferred.
+  void PopulateEntry(GrContext* context,
+                     const RasterCacheKey& key,
+                     Entry& entry,
+                     SkPicture* picture,
+                     const SkRect& bounds,
+                     const SkSize& scale,
+                     SkColorSpace* dst_color_space);
+
+  // Removes up to |max_count| valid entries from the front of the pending
+  // queue.
+  std::vector<Entry*> TakePendingEntries(size_t max_count);
+
+  void PopulateEntriesConcurrently(GrContext* context,
+                                   const std::vector<Entry*>& entries);
+
+  size_t threshold_;
+  size_t max_bytes_;
+  size_t resident_bytes_;
+  size_t frame_number_;
+  size_t frame_hit_count_;
+  size_t frame_miss_count_;
+  size_t total_hit_count_;
+  size_t total_miss_count_;
+  bool deferred_population_;
+  bool allow_rgb565_;
+  size_t scale_buckets_per_octave_;
   RasterCacheKey::Map<Entry> cache_;
+  // Keyed by the unique ID of the pictures.
+  std::unordered_map<uint32_t, PictureStats> picture_stats_;
+  std::deque<RasterCacheKey> pending_;
+  fxl::RefPtr<fxl::TaskRunner> worker_task_runner_;
+  mutable SkMatrix decomposed_matrix_;
+  mutable std::unique_ptr<MatrixDecomposition> decomposition_;
   bool checkerboard_images_;
   fxl::WeakPtrFactory<RasterCache> weak_factory_;
 
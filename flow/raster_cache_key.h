@@ -5,36 +5,77 @@
 #ifndef FLUTTER_FLOW_RASTER_CACHE_KEY_H_
 #define FLUTTER_FLOW_RASTER_CACHE_KEY_H_
 
+#include <stdint.h>
+
+#include <functional>
 #include <unordered_map>
-#include "flutter/flow/matrix_decomposition.h"
 #include "lib/fxl/macros.h"
 #include "third_party/skia/include/core/SkImage.h"
 #include "third_party/skia/include/core/SkPicture.h"
+#include "third_party/skia/include/core/SkPoint.h"
+#include "third_party/skia/include/core/SkSize.h"
 
 namespace flow {
 
 class RasterCacheKey {
  public:
-  RasterCacheKey(const SkPicture& picture, const MatrixDecomposition& matrix)
-      : picture_id_(picture.uniqueID()),
-        scale_key_(SkISize::Make(matrix.scale().x() * 1e3,
-                                 matrix.scale().y() * 1e3)) {}
+  enum class Kind {
+    kPicture,
+    kPictureTile,
+    kLayer,
+  };
+
+  // |scale| is the scale the entry is rasterized at.
+  RasterCacheKey(const SkPicture& picture, const SkSize& scale)
+      : id_(picture.uniqueID()),
+        kind_(Kind::kPicture),
+        scale_key_(SkISize::Make(scale.width() * 1e3, scale.height() * 1e3)) {}
+
+  // Identifies the tile in column |tile.x()| and row |tile.y()| of a picture
+  // too large to be rasterized into one image.
+  RasterCacheKey(const SkPicture& picture,
+                 const SkSize& scale,
+                 const SkIPoint& tile)
+      : id_(picture.uniqueID()),
+        kind_(Kind::kPictureTile),
+        scale_key_(SkISize::Make(scale.width() * 1e3, scale.height() * 1e3)),
+        tile_(tile) {}
 
-  uint32_t picture_id() const { return picture_id_; }
+  // Identifies the contents of a layer subtree by its fingerprint. See
+  // |Layer::Fingerprint|.
+  RasterCacheKey(uint64_t layer_fingerprint, const SkSize& scale)
+      : id_(layer_fingerprint),
+        kind_(Kind::kLayer),
+        scale_key_(SkISize::Make(scale.width() * 1e3, scale.height() * 1e3)) {}
+
+  uint64_t id() const { return id_; }
+
+  Kind kind() const { return kind_; }
 
   const SkISize& scale_key() const { return scale_key_; }
 
+  // Zero unless the kind is |Kind::kPictureTile|.
+  const SkIPoint& tile() const { return tile_; }
+
   struct Hash {
+    // The scales of a picture are hashed too, so that its entries do not
+    // all fall into one bucket.
     std::size_t operator()(RasterCacheKey const& key) const {
-      return key.picture_id_;
+      size_t hash = std::hash<uint64_t>()(key.id_);
+      hash = hash * 31 + static_cast<size_t>(key.kind_);
+      hash = hash * 31 + std::hash<int32_t>()(key.scale_key_.width());
+      hash = hash * 31 + std::hash<int32_t>()(key.scale_key_.height());
+      hash = hash * 31 + std::hash<int32_t>()(key.tile_.x());
+      hash = hash * 31 + std::hash<int32_t>()(key.tile_.y());
+      return hash;
     }
   };
 
   struct Equal {
     constexpr bool operator()(const RasterCacheKey& lhs,
                               const RasterCacheKey& rhs) const {
-      return lhs.picture_id_ == rhs.picture_id_ &&
-             lhs.scale_key_ == rhs.scale_key_;
+      return lhs.id_ == rhs.id_ && lhs.kind_ == rhs.kind_ &&
+             lhs.scale_key_ == rhs.scale_key_ && lhs.tile_ == rhs.tile_;
     }
   };
 
@@ -42,8 +83,10 @@ class RasterCacheKey {
   using Map = std::unordered_map<RasterCacheKey, Value, Hash, Equal>;
 
  private:
-  uint32_t picture_id_;
+  uint64_t id_;
+  Kind kind_;
   SkISize scale_key_;
+  SkIPoint tile_ = SkIPoint::Make(0, 0);
 };
 
 }  // namespace flow
@@ -3,9 +3,11 @@
 // found in the LICENSE file.
 
 #include "flutter/flow/raster_cache.h"
+#include "flutter/fml/worker_pool.h"
 #include "third_party/gtest/include/gtest/gtest.h"
 #include "third_party/skia/include/core/SkPicture.h"
 #include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/effects/SkBlurMaskFilter.h"
 
 sk_sp<SkPicture> GetSamplePicture() {
   SkPictureRecorder recorder;
@@ -17,6 +19,17 @@ sk_sp<SkPicture> GetSamplePicture() {
   return recorder.finishRecordingAsPicture();
 }
 
+sk_sp<SkPicture> GetOpaquePicture() {
+  SkPictureRecorder recorder;
+  recorder.beginRecording(SkRect::MakeWH(150, 100));
+  recorder.getRecordingCanvas()->drawColor(SK_ColorWHITE);
+  SkPaint paint;
+  paint.setColor(SK_ColorRED);
+  recorder.getRecordingCanvas()->drawRect(SkRect::MakeXYWH(10, 10, 80, 80),
+                                          paint);
+  return recorder.finishRecordingAsPicture();
+}
+
 TEST(RasterCache, SimpleInitialization) {
   flow::RasterCache cache;
   ASSERT_TRUE(true);
@@ -93,3 +106,340 @@ TEST(RasterCache, SweepsRemoveUnusedFrames) {
   ASSERT_FALSE(cache.GetPrerolledImage(NULL, picture.get(), matrix, srgb.get(),
                                        true, false));  // 5
 }
+
+TEST(RasterCache, BudgetRetainsUnusedEntries) {
+  size_t threshold = 1;
+  flow::RasterCache cache(threshold);
+  cache.SetMaxBytes(1 << 20);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture = GetSamplePicture();
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_TRUE(cache.GetPrerolledImage(NULL, picture.get(), matrix, srgb.get(),
+                                      true, false));  // 1
+  ASSERT_EQ(cache.resident_bytes(), 150u * 100u * 4u);
+  cache.SweepAfterFrame();
+  cache.SweepAfterFrame();  // Extra frame without a preroll image access.
+  ASSERT_EQ(cache.resident_bytes(), 150u * 100u * 4u);
+  ASSERT_TRUE(cache.GetPrerolledImage(NULL, picture.get(), matrix, srgb.get(),
+                                      true, false));  // 2
+}
+
+TEST(RasterCache, LeastRecentlyUsedEntriesAreEvictedOverBudget) {
+  size_t threshold = 1;
+  flow::RasterCache cache(threshold);
+  // Enough room for exactly one sample picture.
+  cache.SetMaxBytes(150 * 100 * 4);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto first = GetSamplePicture();
+  auto second = GetSamplePicture();
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_TRUE(cache.GetPrerolledImage(NULL, first.get(), matrix, srgb.get(),
+                                      true, false));
+  cache.SweepAfterFrame();
+  ASSERT_TRUE(cache.GetPrerolledImage(NULL, second.get(), matrix, srgb.get(),
+                                      true, false));
+  cache.SweepAfterFrame();
+  ASSERT_EQ(cache.resident_bytes(), 150u * 100u * 4u);
+}
+
+TEST(RasterCache, DeferredPopulationQueuesPictures) {
+  size_t threshold = 1;
+  flow::RasterCache cache(threshold);
+  cache.SetDeferredPopulation(true);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture = GetSamplePicture();
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(cache.GetPrerolledImage(NULL, picture.get(), matrix, srgb.get(),
+                                       true, false));  // 1
+  ASSERT_EQ(cache.pending_entry_count(), 1u);
+  ASSERT_EQ(cache.PopulatePendingEntries(NULL, fxl::TimeDelta::Zero()), 0u);
+  cache.SweepAfterFrame();
+  ASSERT_TRUE(cache.GetPrerolledImage(NULL, picture.get(), matrix, srgb.get(),
+                                      true, false));  // 2
+}
+
+TEST(RasterCache, ConcurrentPopulationRasterizesOnWorkers) {
+  size_t threshold = 1;
+  flow::RasterCache cache(threshold);
+  fml::WorkerPool pool("raster_cache_test", 2);
+  cache.SetDeferredPopulation(true);
+  cache.SetWorkerTaskRunner(pool.GetTaskRunner());
+
+  SkMatrix matrix = SkMatrix::I();
+  SkMatrix scaled = SkMatrix::MakeScale(2, 2);
+
+  auto picture = GetSamplePicture();
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(cache.GetPrerolledImage(NULL, picture.get(), matrix, srgb.get(),
+                                       true, false));  // 1
+  ASSERT_FALSE(cache.GetPrerolledImage(NULL, picture.get(), scaled, srgb.get(),
+                                       true, false));  // 1
+  ASSERT_EQ(cache.pending_entry_count(), 2u);
+  ASSERT_EQ(cache.PopulatePendingEntries(NULL, fxl::TimeDelta::Zero()), 0u);
+  ASSERT_GT(cache.resident_bytes(), 0u);
+  cache.SweepAfterFrame();
+  ASSERT_TRUE(cache.GetPrerolledImage(NULL, picture.get(), matrix, srgb.get(),
+                                      true, false));  // 2
+  ASSERT_TRUE(cache.GetPrerolledImage(NULL, picture.get(), scaled, srgb.get(),
+                                      true, false));  // 2
+}
+
+TEST(RasterCache, LayerSubtreesAreCachedByFingerprint) {
+  size_t threshold = 2;
+  flow::RasterCache cache(threshold);
+
+  SkMatrix matrix = SkMatrix::I();
+  const uint64_t fingerprint = 42;
+  const SkRect bounds = SkRect::MakeWH(100, 100);
+
+  size_t draw_count = 0;
+  auto draw = [&draw_count](SkCanvas* canvas) { draw_count++; };
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(cache.GetPrerolledImage(NULL, fingerprint, bounds, matrix,
+                                       srgb.get(), draw));  // 1
+  ASSERT_FALSE(cache.HasImage(fingerprint, matrix));
+  cache.SweepAfterFrame();
+  ASSERT_TRUE(cache.GetPrerolledImage(NULL, fingerprint, bounds, matrix,
+                                      srgb.get(), draw));  // 2
+  ASSERT_TRUE(cache.HasImage(fingerprint, matrix));
+  cache.SweepAfterFrame();
+  ASSERT_TRUE(cache.GetPrerolledImage(NULL, fingerprint, bounds, matrix,
+                                      srgb.get(), draw));  // 3
+  ASSERT_EQ(draw_count, 1u);
+}
+
+TEST(RasterCache, OpaquePicturesAreRasterizedWithoutAlpha) {
+  size_t threshold = 1;
+  flow::RasterCache cache(threshold);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto opaque = GetOpaquePicture();
+  auto translucent = GetSamplePicture();
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  auto opaque_result = cache.GetPrerolledImage(NULL, opaque.get(), matrix,
+                                               srgb.get(), true, false);
+  ASSERT_TRUE(opaque_result);
+  ASSERT_TRUE(opaque_result.image()->isOpaque());
+  auto translucent_result = cache.GetPrerolledImage(
+      NULL, translucent.get(), matrix, srgb.get(), true, false);
+  ASSERT_TRUE(translucent_result);
+  ASSERT_FALSE(translucent_result.image()->isOpaque());
+}
+
+TEST(RasterCache, OpaquePicturesUseRGB565WhenAllowed) {
+  size_t threshold = 1;
+  flow::RasterCache cache(threshold);
+  cache.SetAllowRGB565(true);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto opaque = GetOpaquePicture();
+  auto translucent = GetSamplePicture();
+
+  ASSERT_TRUE(cache.GetPrerolledImage(NULL, opaque.get(), matrix, nullptr,
+                                      true, false));
+  ASSERT_EQ(cache.resident_bytes(), 150u * 100u * 2u);
+  ASSERT_TRUE(cache.GetPrerolledImage(NULL, translucent.get(), matrix, nullptr,
+                                      true, false));
+  ASSERT_EQ(cache.resident_bytes(), 150u * 100u * 6u);
+}
+
+TEST(RasterCache, HitsAndMissesAreCountedPerFrame) {
+  size_t threshold = 2;
+  flow::RasterCache cache(threshold);
+
+  SkMatrix matrix = SkMatrix::I();
+  auto picture = GetSamplePicture();
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+
+  ASSERT_FALSE(cache.GetPrerolledImage(NULL, picture.get(), matrix, srgb.get(),
+                                       true, false));
+  ASSERT_EQ(cache.frame_hit_count(), 0u);
+  ASSERT_EQ(cache.frame_miss_count(), 1u);
+  cache.SweepAfterFrame();
+  ASSERT_EQ(cache.frame_miss_count(), 0u);
+
+  // Rasterized during this lookup, which is still a miss.
+  ASSERT_TRUE(cache.GetPrerolledImage(NULL, picture.get(), matrix, srgb.get(),
+                                      true, false));
+  ASSERT_EQ(cache.frame_hit_count(), 0u);
+  ASSERT_EQ(cache.frame_miss_count(), 1u);
+  cache.SweepAfterFrame();
+
+  ASSERT_TRUE(cache.GetPrerolledImage(NULL, picture.get(), matrix, srgb.get(),
+                                      true, false));
+  ASSERT_EQ(cache.frame_hit_count(), 1u);
+  ASSERT_EQ(cache.frame_miss_count(), 0u);
+  cache.SweepAfterFrame();
+}
+
+TEST(RasterCache, CheapPicturesAreNotAdmitted) {
+  flow::RasterCache cache(1);
+
+  SkPictureRecorder recorder;
+  recorder.beginRecording(SkRect::MakeWH(150, 100));
+  SkPaint paint;
+  paint.setColor(SK_ColorRED);
+  for (int i = 0; i < 12; i++) {
+    recorder.getRecordingCanvas()->drawRect(SkRect::MakeXYWH(i, i, 80, 80),
+                                            paint);
+  }
+  auto picture = recorder.finishRecordingAsPicture();
+
+  SkMatrix matrix = SkMatrix::I();
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(cache.GetPrerolledImage(NULL, picture.get(), matrix, srgb.get(),
+                                       false, false));
+  ASSERT_EQ(cache.frame_miss_count(), 0u);
+}
+
+TEST(RasterCache, PicturesWithFewExpensiveOpsAreAdmitted) {
+  flow::RasterCache cache(1);
+
+  SkPictureRecorder recorder;
+  recorder.beginRecording(SkRect::MakeWH(150, 100));
+  SkPaint paint;
+  paint.setColor(SK_ColorRED);
+  paint.setMaskFilter(SkBlurMaskFilter::Make(kNormal_SkBlurStyle, 10));
+  recorder.getRecordingCanvas()->drawRect(SkRect::MakeXYWH(10, 10, 80, 80),
+                                          paint);
+  auto picture = recorder.finishRecordingAsPicture();
+
+  SkMatrix matrix = SkMatrix::I();
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_TRUE(cache.GetPrerolledImage(NULL, picture.get(), matrix, srgb.get(),
+                                      false, false));
+}
+
+TEST(RasterCache, HitsAndMissesAreTotaledAcrossFrames) {
+  flow::RasterCache cache(1);
+
+  SkMatrix matrix = SkMatrix::I();
+  auto picture = GetSamplePicture();
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+
+  for (size_t i = 0; i < 3; i++) {
+    ASSERT_TRUE(cache.GetPrerolledImage(NULL, picture.get(), matrix,
+                                        srgb.get(), true, false));
+    cache.SweepAfterFrame();
+  }
+  ASSERT_EQ(cache.total_hit_count(), 2u);
+  ASSERT_EQ(cache.total_miss_count(), 1u);
+}
+
+TEST(RasterCache, EntriesDescribeTheirImages) {
+  flow::RasterCache cache(2);
+
+  SkMatrix matrix = SkMatrix::I();
+  auto picture = GetSamplePicture();
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+
+  ASSERT_FALSE(cache.GetPrerolledImage(NULL, picture.get(), matrix, srgb.get(),
+                                       true, false));
+  auto entries = cache.GetEntries();
+  ASSERT_EQ(entries.size(), 1u);
+  ASSERT_EQ(entries[0].kind, flow::RasterCacheKey::Kind::kPicture);
+  ASSERT_EQ(entries[0].id, picture->uniqueID());
+  ASSERT_TRUE(entries[0].image_size.isEmpty());
+  ASSERT_EQ(entries[0].byte_size, 0u);
+  ASSERT_EQ(entries[0].access_count, 1u);
+  cache.SweepAfterFrame();
+
+  ASSERT_TRUE(cache.GetPrerolledImage(NULL, picture.get(), matrix, srgb.get(),
+                                      true, false));
+  cache.SweepAfterFrame();
+  entries = cache.GetEntries();
+  ASSERT_EQ(entries.size(), 1u);
+  ASSERT_EQ(entries[0].image_size, SkISize::Make(150, 100));
+  ASSERT_EQ(entries[0].byte_size, cache.resident_bytes());
+  ASSERT_EQ(entries[0].access_count, 2u);
+  ASSERT_EQ(entries[0].age, 2u);
+  ASSERT_FALSE(entries[0].pending);
+}
+
+TEST(RasterCache, ThresholdCanBeChanged) {
+  flow::RasterCache cache(3);
+  cache.SetThreshold(1);
+  ASSERT_EQ(cache.threshold(), 1u);
+
+  SkMatrix matrix = SkMatrix::I();
+  auto picture = GetSamplePicture();
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_TRUE(cache.GetPrerolledImage(NULL, picture.get(), matrix, srgb.get(),
+                                      true, false));
+  cache.SweepAfterFrame();
+}
+
+TEST(RasterCache, NearbyScalesShareABucket) {
+  flow::RasterCache cache(1);
+  cache.SetScaleBucketsPerOctave(2);
+
+  auto picture = GetSamplePicture();
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_TRUE(cache.GetPrerolledImage(NULL, picture.get(),
+                                      SkMatrix::MakeScale(1.1, 1.1),
+                                      srgb.get(), true, false));
+  ASSERT_TRUE(cache.GetPrerolledImage(NULL, picture.get(),
+                                      SkMatrix::MakeScale(1.3, 1.3),
+                                      srgb.get(), true, false));
+  auto entries = cache.GetEntries();
+  ASSERT_EQ(entries.size(), 1u);
+  ASSERT_EQ(entries[0].scale_key, SkISize::Make(1414, 1414));
+  ASSERT_EQ(entries[0].image_size, SkISize::Make(213, 142));
+
+  // Scales at a bucket are rasterized exactly.
+  ASSERT_TRUE(cache.GetPrerolledImage(NULL, picture.get(),
+                                      SkMatrix::MakeScale(2, 2), srgb.get(),
+                                      true, false));
+  ASSERT_EQ(cache.entry_count(), 2u);
+  cache.SweepAfterFrame();
+}
+
+TEST(RasterCache, LargePicturesAreTiledNearTheCullRect) {
+  flow::RasterCache cache(1);
+
+  SkPictureRecorder recorder;
+  recorder.beginRecording(SkRect::MakeWH(200, 10000));
+  SkPaint paint;
+  paint.setColor(SK_ColorRED);
+  recorder.getRecordingCanvas()->drawRect(SkRect::MakeWH(200, 10000), paint);
+  auto picture = recorder.finishRecordingAsPicture();
+
+  SkMatrix matrix = SkMatrix::I();
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_TRUE(cache.ShouldTilePicture(picture.get(), matrix));
+  ASSERT_FALSE(cache.GetPrerolledImage(NULL, picture.get(), matrix,
+                                       srgb.get(), true, false));
+
+  // The two tiles within the cull rect are returned, the one below it is
+  // rasterized ahead of scrolling.
+  flow::RasterCacheTiles tiles =
+      cache.GetPrerolledTiles(NULL, picture.get(), matrix,
+                              SkRect::MakeWH(200, 600), srgb.get(), true,
+                              false);
+  ASSERT_FALSE(tiles.empty());
+  ASSERT_TRUE(tiles.Covers(SkRect::MakeWH(200, 600)));
+  ASSERT_FALSE(tiles.Covers(SkRect::MakeWH(200, 2000)));
+
+  auto entries = cache.GetEntries();
+  ASSERT_EQ(entries.size(), 3u);
+  for (const auto& entry : entries) {
+    ASSERT_EQ(entry.kind, flow::RasterCacheKey::Kind::kPictureTile);
+    ASSERT_EQ(entry.tile.x(), 0);
+    ASSERT_EQ(entry.image_size, SkISize::Make(200, 512));
+  }
+  cache.SweepAfterFrame();
+}
@@ -4,13 +4,46 @@
 
 #include "flutter/flow/scene_update_context.h"
 
+#include <atomic>
+
 #include "flutter/common/threads.h"
 #include "flutter/flow/export_node.h"
 #include "flutter/flow/layers/layer.h"
 #include "flutter/flow/matrix_decomposition.h"
 #include "flutter/glue/trace_event.h"
+#include "lib/fxl/synchronization/waitable_event.h"
+#include "lib/ui/scenic/fidl_helpers.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
 
 namespace flow {
+namespace {
+
+template <typename Cache, typename Create>
+auto& FindOrCreate(Cache& cache,
+                   const typename Cache::key_type& key,
+                   size_t frame,
+                   Create create) {
+  auto found = cache.find(key);
+  if (found == cache.end()) {
+    found =
+        cache.emplace(key, typename Cache::mapped_type{create(), frame}).first;
+  }
+  found->second.last_used_frame = frame;
+  return *found->second.resource;
+}
+
+template <typename Cache>
+void CollectUnused(Cache& cache, size_t frame) {
+  for (auto it = cache.begin(); it != cache.end();) {
+    if (it->second.last_used_frame == frame) {
+      ++it;
+    } else {
+      it = cache.erase(it);
+    }
+  }
+}
+
+}  // namespace
 
 SceneUpdateContext::SceneUpdateContext(scenic_lib::Session* session,
                                        SurfaceProducer* surface_producer)
@@ -48,13 +81,13 @@ void SceneUpdateContext::RemoveExportNode(ExportNode* export_node) {
   export_nodes_.erase(export_node);
 }
 
-void SceneUpdateContext::CreateFrame(scenic_lib::EntityNode& entity_node,
+void SceneUpdateContext::CreateFrame(Entity& entity,
                                      const SkRRect& rrect,
                                      SkColor color,
                                      const SkRect& paint_bounds,
                                      std::vector<Layer*> paint_layers) {
   // Frames always clip their children.
-  entity_node.SetClip(0u, true /* clip to self */);
+  entity.SetClipToSelf();
 
   // We don't need a shape if the frame is zero size.
   if (rrect.isEmpty())
@@ -62,23 +95,12 @@ void SceneUpdateContext::CreateFrame(scenic_lib::EntityNode& entity_node,
 
   // Add a part which represents the frame's geometry for clipping purposes
   // and possibly for its texture.
-  // TODO(MZ-137): Need to be able to express the radii as vectors.
   SkRect shape_bounds = rrect.getBounds();
-  scenic_lib::RoundedRectangle shape(
-      session_,                                      // session
-      rrect.width(),                                 // width
-      rrect.height(),                                // height
-      rrect.radii(SkRRect::kUpperLeft_Corner).x(),   // top_left_radius
-      rrect.radii(SkRRect::kUpperRight_Corner).x(),  // top_right_radius
-      rrect.radii(SkRRect::kLowerRight_Corner).x(),  // bottom_right_radius
-      rrect.radii(SkRRect::kLowerLeft_Corner).x()    // bottom_left_radius
-  );
-  scenic_lib::ShapeNode shape_node(session_);
-  shape_node.SetShape(shape);
-  shape_node.SetTranslation(shape_bounds.width() * 0.5f + shape_bounds.left(),
+  RetainedPart& shape_part = entity.AcquirePart();
+  shape_part.SetShape(GetRoundedRectangle(rrect));
+  shape_part.SetTranslation(shape_bounds.width() * 0.5f + shape_bounds.left(),
                             shape_bounds.height() * 0.5f + shape_bounds.top(),
                             0.f);
-  entity_node.AddPart(shape_node);
 
   // Check whether the painted layers will be visible.
   if (paint_bounds.isEmpty() || !paint_bounds.intersects(shape_bounds))
@@ -86,7 +108,7 @@ void SceneUpdateContext::CreateFrame(scenic_lib::EntityNode& entity_node,
 
   // Check whether a solid color will suffice.
   if (paint_layers.empty()) {
-    SetShapeColor(shape_node, color);
+    SetShapeColor(shape_part, color);
     return;
   }
 
@@ -99,28 +121,26 @@ void SceneUpdateContext::CreateFrame(scenic_lib::EntityNode& entity_node,
   SkRect inner_bounds = shape_bounds;
   inner_bounds.intersect(paint_bounds);
   if (inner_bounds != shape_bounds && rrect.contains(inner_bounds)) {
-    SetShapeColor(shape_node, color);
+    SetShapeColor(shape_part, color);
 
-    scenic_lib::Rectangle inner_shape(session_, inner_bounds.width(),
-                                      inner_bounds.height());
-    scenic_lib::ShapeNode inner_node(session_);
-    inner_node.SetShape(inner_shape);
-    inner_node.SetTranslation(inner_bounds.width() * 0.5f + inner_bounds.left(),
+    RetainedPart& inner_part = entity.AcquirePart();
+    inner_part.SetShape(
+        GetRectangle(inner_bounds.width(), inner_bounds.height()));
+    inner_part.SetTranslation(inner_bounds.width() * 0.5f + inner_bounds.left(),
                               inner_bounds.height() * 0.5f + inner_bounds.top(),
                               0.f);
-    entity_node.AddPart(inner_node);
-    SetShapeTextureOrColor(inner_node, color, scale_x, scale_y, inner_bounds,
+    SetShapeTextureOrColor(inner_part, color, scale_x, scale_y, inner_bounds,
                            std::move(paint_layers));
     return;
   }
 
   // Apply a texture to the whole shape.
-  SetShapeTextureOrColor(shape_node, color, scale_x, scale_y, shape_bounds,
+  SetShapeTextureOrColor(shape_part, color, scale_x, scale_y, shape_bounds,
                          std::move(paint_layers));
 }
 
 void SceneUpdateContext::SetShapeTextureOrColor(
-    scenic_lib::ShapeNode& shape_node,
+    RetainedPart& part,
     SkColor color,
     SkScalar scale_x,
     SkScalar scale_y,
@@ -129,24 +149,93 @@ void SceneUpdateContext::SetShapeTextureOrColor(
   scenic_lib::Image* image = GenerateImageIfNeeded(
       color, scale_x, scale_y, paint_bounds, std::move(paint_layers));
   if (image != nullptr) {
-    scenic_lib::Material material(session_);
-    material.SetTexture(*image);
-    shape_node.SetMaterial(material);
+    part.SetMaterial(GetTextureMaterial(*image));
     return;
   }
 
-  SetShapeColor(shape_node, color);
+  SetShapeColor(part, color);
 }
 
-void SceneUpdateContext::SetShapeColor(scenic_lib::ShapeNode& shape_node,
-                                       SkColor color) {
-  if (SkColorGetA(color) == 0)
+void SceneUpdateContext::SetShapeColor(RetainedPart& part, SkColor color) {
+  if (SkColorGetA(color) == 0) {
+    part.ClearMaterial();
     return;
+  }
+
+  part.SetMaterial(GetColorMaterial(color));
+}
+
+scenic_lib::Rectangle& SceneUpdateContext::GetRectangle(float width,
+                                                        float height) {
+  return FindOrCreate(rectangles_, std::array<float, 2>{{width, height}},
+                      frame_count_, [this, width, height]() {
+                        return std::make_unique<scenic_lib::Rectangle>(
+                            session_, width, height);
+                      });
+}
+
+scenic_lib::RoundedRectangle& SceneUpdateContext::GetRoundedRectangle(
+    const SkRRect& rrect) {
+  // TODO(MZ-137): Need to be able to express the radii as vectors.
+  const std::array<float, 6> key = {{
+      rrect.width(),                                 // width
+      rrect.height(),                                // height
+      rrect.radii(SkRRect::kUpperLeft_Corner).x(),   // top_left_radius
+      rrect.radii(SkRRect::kUpperRight_Corner).x(),  // top_right_radius
+      rrect.radii(SkRRect::kLowerRight_Corner).x(),  // bottom_right_radius
+      rrect.radii(SkRRect::kLowerLeft_Corner).x(),   // bottom_left_radius
+  }};
+  return FindOrCreate(rounded_rectangles_, key, frame_count_, [this, &key]() {
+    return std::make_unique<scenic_lib::RoundedRectangle>(
+        session_, key[0], key[1], key[2], key[3], key[4], key[5]);
+  });
+}
+
+scenic_lib::Material& SceneUpdateContext::GetColorMaterial(SkColor color) {
+  return FindOrCreate(color_materials_, color, frame_count_, [this, color]() {
+    auto material = std::make_unique<scenic_lib::Material>(session_);
+    material->SetColor(SkColorGetR(color), SkColorGetG(color),
+                       SkColorGetB(color), SkColorGetA(color));
+    return material;
+  });
+}
+
+scenic_lib::Material& SceneUpdateContext::GetTextureMaterial(
+    const scenic_lib::Image& image) {
+  return FindOrCreate(texture_materials_, image.id(), frame_count_,
+                      [this, &image]() {
+                        auto material =
+                            std::make_unique<scenic_lib::Material>(session_);
+                        material->SetTexture(image);
+                        return material;
+                      });
+}
+
+SceneUpdateContext::RetainedEntity&
+SceneUpdateContext::AcquireRetainedEntity() {
+  if (retained_entities_used_ < retained_entities_.size()) {
+    RetainedEntity& entity = *retained_entities_[retained_entities_used_++];
+    // The children are added again as the traversal reaches them.
+    session_->Enqueue(scenic_lib::NewDetachChildrenOp(entity.node.id()));
+    return entity;
+  }
+  retained_entities_.push_back(std::make_unique<RetainedEntity>(session_));
+  retained_entities_used_++;
+  return *retained_entities_.back();
+}
+
+void SceneUpdateContext::EndFrame() {
+  ASSERT_IS_GPU_THREAD;
+  FXL_DCHECK(top_entity_ == nullptr);
 
-  scenic_lib::Material material(session_);
-  material.SetColor(SkColorGetR(color), SkColorGetG(color), SkColorGetB(color),
-                    SkColorGetA(color));
-  shape_node.SetMaterial(material);
+  retained_entities_.resize(retained_entities_used_);
+  retained_entities_used_ = 0;
+
+  CollectUnused(rectangles_, frame_count_);
+  CollectUnused(rounded_rectangles_, frame_count_);
+  CollectUnused(color_materials_, frame_count_);
+  CollectUnused(texture_materials_, frame_count_);
+  frame_count_++;
 }
 
 scenic_lib::Image* SceneUpdateContext::GenerateImageIfNeeded(
@@ -188,23 +277,51 @@ scenic_lib::Image* SceneUpdateContext::GenerateImageIfNeeded(
   return image;
 }
 
+void SceneUpdateContext::PaintLayers(const PaintTask& task,
+                                     SkCanvas& canvas,
+                                     CompositorContext::ScopedFrame& frame,
+                                     FrameWorkCounts* work_counts) {
+  Layer::PaintContext context = {canvas,
+                                 SkRect::MakeLargest(),
+                                 frame.context().frame_time(),
+                                 frame.context().engine_time(),
+                                 frame.context().gpu_time(),
+                                 frame.context().memory_usage(),
+                                 frame.context().image_memory_usage(),
+                                 frame.context().texture_registry(),
+                                 work_counts,
+                                 nullptr,
+                                 false};
+  canvas.scale(task.scale_x, task.scale_y);
+  canvas.translate(-task.left, -task.top);
+  for (Layer* layer : task.layers) {
+    layer->Paint(context);
+  }
+}
+
 std::vector<std::unique_ptr<flow::SceneUpdateContext::SurfaceProducerSurface>>
 SceneUpdateContext::ExecutePaintTasks(CompositorContext::ScopedFrame& frame) {
   TRACE_EVENT0("flutter", "SceneUpdateContext::ExecutePaintTasks");
+  // The layers of the tasks are recorded into pictures on the worker threads
+  // and only the pictures are drawn here, as the context of the surfaces can
+  // only be used on this thread.
+  std::vector<sk_sp<SkPicture>> pictures;
+  if (paint_tasks_.size() > 1 && blink::Threads::Worker()) {
+    pictures = RecordPaintTasks(frame);
+  }
+
   std::vector<std::unique_ptr<SurfaceProducerSurface>> surfaces_to_submit;
-  for (auto& task : paint_tasks_) {
+  for (size_t i = 0; i < paint_tasks_.size(); i++) {
+    PaintTask& task = paint_tasks_[i];
     FXL_DCHECK(task.surface);
     SkCanvas* canvas = task.surface->GetSkiaSurface()->getCanvas();
-    Layer::PaintContext context = {*canvas, frame.context().frame_time(),
-                                   frame.context().engine_time(),
-                                   frame.context().memory_usage(), false};
     canvas->restoreToCount(1);
     canvas->save();
     canvas->clear(task.background_color);
-    canvas->scale(task.scale_x, task.scale_y);
-    canvas->translate(-task.left, -task.top);
-    for (Layer* layer : task.layers) {
-      layer->Paint(context);
+    if (pictures.empty()) {
+      PaintLayers(task, *canvas, frame, &frame.context().frame_work_counts());
+    } else {
+      canvas->drawPicture(pictures[i]);
     }
     surfaces_to_submit.emplace_back(std::move(task.surface));
   }
@@ -212,32 +329,183 @@ SceneUpdateContext::ExecutePaintTasks(CompositorContext::ScopedFrame& frame) {
   return surfaces_to_submit;
 }
 
+std::vector<sk_sp<SkPicture>> SceneUpdateContext::RecordPaintTasks(
+    CompositorContext::ScopedFrame& frame) {
+  TRACE_EVENT1("flutter", "SceneUpdateContext::RecordPaintTasks", "count",
+               paint_tasks_.size());
+  const size_t count = paint_tasks_.size();
+  std::vector<sk_sp<SkPicture>> pictures(count);
+  std::vector<FrameWorkCounts> work_counts(count);
+  std::vector<SkRect> bounds(count);
+  for (size_t i = 0; i < count; i++) {
+    sk_sp<SkSurface> surface = paint_tasks_[i].surface->GetSkiaSurface();
+    bounds[i] = SkRect::MakeIWH(surface->width(), surface->height());
+  }
+
+  std::atomic<size_t> remaining(count);
+  fxl::AutoResetWaitableEvent latch;
+  for (size_t i = 0; i < count; i++) {
+    blink::Threads::Worker()->PostTask([this, i, &frame, &pictures,
+                                        &work_counts, &bounds, &remaining,
+                                        &latch]() {
+      TRACE_EVENT0("flutter", "SceneUpdateContext::RecordPaintTask");
+      SkPictureRecorder recorder;
+      PaintLayers(paint_tasks_[i], *recorder.beginRecording(bounds[i]), frame,
+                  &work_counts[i]);
+      pictures[i] = recorder.finishRecordingAsPicture();
+      if (--remaining == 0) {
+        latch.Signal();
+      }
+    });
+  }
+  latch.Wait();
+
+  FrameWorkCounts& frame_work_counts = frame.context().frame_work_counts();
+  for (const FrameWorkCounts& task_work_counts : work_counts) {
+    frame_work_counts.raster_cache_hits += task_work_counts.raster_cache_hits;
+    frame_work_counts.raster_cache_misses +=
+        task_work_counts.raster_cache_misses;
+    frame_work_counts.raster_cache_bytes += task_work_counts.raster_cache_bytes;
+    frame_work_counts.save_layers += task_work_counts.save_layers;
+    frame_work_counts.picture_ops += task_work_counts.picture_ops;
+  }
+  return pictures;
+}
+
 SceneUpdateContext::Entity::Entity(SceneUpdateContext& context)
     : context_(context),
       previous_entity_(context.top_entity_),
-      entity_node_(context.session()) {
+      retained_(context.AcquireRetainedEntity()) {
   if (previous_entity_)
-    previous_entity_->entity_node_.AddChild(entity_node_);
+    previous_entity_->entity_node().AddChild(entity_node());
   context.top_entity_ = this;
 }
 
 SceneUpdateContext::Entity::~Entity() {
   FXL_DCHECK(context_.top_entity_ == this);
+
+  scenic_lib::EntityNode& node = retained_.node;
+  if (translation_ != retained_.translation) {
+    node.SetTranslation(translation_[0], translation_[1], translation_[2]);
+    retained_.translation = translation_;
+  }
+  if (scale_ != retained_.scale) {
+    node.SetScale(scale_[0], scale_[1], scale_[2]);
+    retained_.scale = scale_;
+  }
+  if (rotation_ != retained_.rotation) {
+    node.SetRotation(rotation_[0], rotation_[1], rotation_[2], rotation_[3]);
+    retained_.rotation = rotation_;
+  }
+  if (clip_to_self_ != retained_.clip_to_self) {
+    node.SetClip(0u, clip_to_self_);
+    retained_.clip_to_self = clip_to_self_;
+  }
+
+  // Detach the parts of the previous frame this one did not use.
+  auto& parts = retained_.parts;
+  while (parts.size() > parts_used_) {
+    context_.session()->Enqueue(
+        scenic_lib::NewDetachOp(parts.back()->node->id()));
+    parts.pop_back();
+  }
+
   context_.top_entity_ = previous_entity_;
 }
 
+scenic_lib::EntityNode& SceneUpdateContext::Entity::entity_node() {
+  return retained_.node;
+}
+
+void SceneUpdateContext::Entity::SetTranslation(float x, float y, float z) {
+  translation_ = {{x, y, z}};
+}
+
+void SceneUpdateContext::Entity::SetScale(float x, float y, float z) {
+  scale_ = {{x, y, z}};
+}
+
+void SceneUpdateContext::Entity::SetRotation(float x,
+                                             float y,
+                                             float z,
+                                             float w) {
+  rotation_ = {{x, y, z, w}};
+}
+
+void SceneUpdateContext::Entity::SetClipToSelf() {
+  clip_to_self_ = true;
+}
+
+SceneUpdateContext::RetainedPart& SceneUpdateContext::Entity::AcquirePart() {
+  auto& parts = retained_.parts;
+  if (parts_used_ == parts.size()) {
+    parts.push_back(
+        std::make_unique<RetainedPart>(context_.session(), retained_.node));
+  }
+  return *parts[parts_used_++];
+}
+
+SceneUpdateContext::RetainedPart::RetainedPart(scenic_lib::Session* p_session,
+                                               scenic_lib::EntityNode& p_parent)
+    : session(p_session),
+      parent(p_parent),
+      node(std::make_unique<scenic_lib::ShapeNode>(session)) {
+  parent.AddPart(*node);
+}
+
+void SceneUpdateContext::RetainedPart::SetShape(
+    const scenic_lib::Shape& p_shape) {
+  // Shapes are only kept while frames use them, so |shape| is only valid
+  // within the frame that set it.
+  shape = &p_shape;
+  if (p_shape.id() == shape_id)
+    return;
+  node->SetShape(p_shape);
+  shape_id = p_shape.id();
+}
+
+void SceneUpdateContext::RetainedPart::SetTranslation(float x,
+                                                      float y,
+                                                      float z) {
+  const std::array<float, 3> p_translation = {{x, y, z}};
+  if (p_translation == translation)
+    return;
+  node->SetTranslation(x, y, z);
+  translation = p_translation;
+}
+
+void SceneUpdateContext::RetainedPart::SetMaterial(
+    const scenic_lib::Material& material) {
+  if (material.id() == material_id)
+    return;
+  node->SetMaterial(material);
+  material_id = material.id();
+}
+
+void SceneUpdateContext::RetainedPart::ClearMaterial() {
+  if (material_id == 0)
+    return;
+
+  // A node cannot go back to having no material, so it is replaced.
+  session->Enqueue(scenic_lib::NewDetachOp(node->id()));
+  node = std::make_unique<scenic_lib::ShapeNode>(session);
+  parent.AddPart(*node);
+  material_id = 0;
+  if (shape_id != 0)
+    node->SetShape(*shape);
+  if (translation != std::array<float, 3>{{0.f, 0.f, 0.f}})
+    node->SetTranslation(translation[0], translation[1], translation[2]);
+}
+
 SceneUpdateContext::Clip::Clip(SceneUpdateContext& context,
                                scenic_lib::Shape& shape,
                                const SkRect& shape_bounds)
     : Entity(context) {
-  scenic_lib::ShapeNode shape_node(context.session());
-  shape_node.SetShape(shape);
-  shape_node.SetTranslation(shape_bounds.width() * 0.5f + shape_bounds.left(),
-                            shape_bounds.height() * 0.5f + shape_bounds.top(),
-                            0.f);
-
-  entity_node().AddPart(shape_node);
-  entity_node().SetClip(0u, true /* clip to self */);
+  RetainedPart& part = AcquirePart();
+  part.SetShape(shape);
+  part.SetTranslation(shape_bounds.width() * 0.5f + shape_bounds.left(),
+                      shape_bounds.height() * 0.5f + shape_bounds.top(), 0.f);
+  SetClipToSelf();
 }
 
 SceneUpdateContext::Clip::~Clip() = default;
@@ -252,22 +520,22 @@ SceneUpdateContext::Transform::Transform(SceneUpdateContext& context,
     // are not handled correctly.
     MatrixDecomposition decomposition(transform);
     if (decomposition.IsValid()) {
-      entity_node().SetTranslation(decomposition.translation().x(),  //
-                                   decomposition.translation().y(),  //
-                                   decomposition.translation().z()   //
+      SetTranslation(decomposition.translation().x(),  //
+                     decomposition.translation().y(),  //
+                     decomposition.translation().z()   //
       );
 
-      entity_node().SetScale(decomposition.scale().x(),  //
-                             decomposition.scale().y(),  //
-                             decomposition.scale().z()   //
+      SetScale(decomposition.scale().x(),  //
+               decomposition.scale().y(),  //
+               decomposition.scale().z()   //
       );
       context.top_scale_x_ *= decomposition.scale().x();
       context.top_scale_y_ *= decomposition.scale().y();
 
-      entity_node().SetRotation(decomposition.rotation().fData[0],  //
-                                decomposition.rotation().fData[1],  //
-                                decomposition.rotation().fData[2],  //
-                                decomposition.rotation().fData[3]   //
+      SetRotation(decomposition.rotation().fData[0],  //
+                  decomposition.rotation().fData[1],  //
+                  decomposition.rotation().fData[2],  //
+                  decomposition.rotation().fData[3]   //
       );
     }
   }
@@ -281,7 +549,7 @@ SceneUpdateContext::Transform::Transform(SceneUpdateContext& context,
       previous_scale_x_(context.top_scale_x_),
       previous_scale_y_(context.top_scale_y_) {
   if (scale_x != 1.f || scale_y != 1.f || scale_z != 1.f) {
-    entity_node().SetScale(scale_x, scale_y, scale_z);
+    SetScale(scale_x, scale_y, scale_z);
     context.top_scale_x_ *= scale_x;
     context.top_scale_y_ *= scale_y;
   }
@@ -301,11 +569,11 @@ SceneUpdateContext::Frame::Frame(SceneUpdateContext& context,
       color_(color),
       paint_bounds_(SkRect::MakeEmpty()) {
   if (elevation != 0.0)
-    entity_node().SetTranslation(0.f, 0.f, elevation);
+    SetTranslation(0.f, 0.f, elevation);
 }
 
 SceneUpdateContext::Frame::~Frame() {
-  context().CreateFrame(entity_node(), rrect_, color_, paint_bounds_,
+  context().CreateFrame(*this, rrect_, color_, paint_bounds_,
                         std::move(paint_layers_));
 }
 
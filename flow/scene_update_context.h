@@ -5,6 +5,8 @@
 #ifndef FLUTTER_FLOW_SCENE_UPDATE_CONTEXT_H_
 #define FLUTTER_FLOW_SCENE_UPDATE_CONTEXT_H_
 
+#include <array>
+#include <map>
 #include <memory>
 #include <vector>
 
@@ -13,6 +15,7 @@
 #include "lib/fxl/logging.h"
 #include "lib/fxl/macros.h"
 #include "lib/ui/scenic/client/resources.h"
+#include "third_party/skia/include/core/SkPicture.h"
 #include "third_party/skia/include/core/SkRect.h"
 #include "third_party/skia/include/core/SkSurface.h"
 
@@ -23,6 +26,10 @@ class ExportNodeHolder;
 class ExportNode;
 
 class SceneUpdateContext {
+ private:
+  struct RetainedEntity;
+  struct RetainedPart;
+
  public:
   class SurfaceProducerSurface {
    public:
@@ -55,19 +62,36 @@ class SceneUpdateContext {
         std::unique_ptr<SurfaceProducerSurface> surface) = 0;
   };
 
+  // The node of an entity is the one in the same position of the traversal
+  // in the previous frame, if there was one. Its properties are sent to the
+  // session when the entity ends, and only if they changed.
   class Entity {
    public:
     Entity(SceneUpdateContext& context);
     ~Entity();
 
     SceneUpdateContext& context() { return context_; }
-    scenic_lib::EntityNode& entity_node() { return entity_node_; }
+    scenic_lib::EntityNode& entity_node();
+
+    void SetTranslation(float x, float y, float z);
+    void SetScale(float x, float y, float z);
+    void SetRotation(float x, float y, float z, float w);
+    void SetClipToSelf();
+
+    // Returns the next part of the entity. Parts of the previous frame keep
+    // their shape, material and translation.
+    RetainedPart& AcquirePart();
 
    private:
     SceneUpdateContext& context_;
     Entity* const previous_entity_;
+    RetainedEntity& retained_;
 
-    scenic_lib::EntityNode entity_node_;
+    std::array<float, 3> translation_ = {{0.f, 0.f, 0.f}};
+    std::array<float, 3> scale_ = {{1.f, 1.f, 1.f}};
+    std::array<float, 4> rotation_ = {{0.f, 0.f, 0.f, 1.f}};
+    bool clip_to_self_ = false;
+    size_t parts_used_ = 0;
   };
 
   class Clip : public Entity {
@@ -117,6 +141,16 @@ class SceneUpdateContext {
 
   scenic_lib::Session* session() { return session_; }
 
+  // Shapes and materials are shared by the frames that use the same ones.
+  scenic_lib::Rectangle& GetRectangle(float width, float height);
+  scenic_lib::RoundedRectangle& GetRoundedRectangle(const SkRRect& rrect);
+  scenic_lib::Material& GetColorMaterial(SkColor color);
+  scenic_lib::Material& GetTextureMaterial(const scenic_lib::Image& image);
+
+  // Releases the nodes, shapes and materials the frame did not use. Called
+  // once the frame was presented.
+  void EndFrame();
+
   bool has_metrics() const { return !!metrics_; }
   void set_metrics(scenic::MetricsPtr metrics) {
     metrics_ = std::move(metrics);
@@ -145,6 +179,44 @@ class SceneUpdateContext {
       CompositorContext::ScopedFrame& frame);
 
  private:
+  struct RetainedPart {
+    RetainedPart(scenic_lib::Session* session,
+                 scenic_lib::EntityNode& parent);
+
+    void SetShape(const scenic_lib::Shape& shape);
+    void SetTranslation(float x, float y, float z);
+    void SetMaterial(const scenic_lib::Material& material);
+    void ClearMaterial();
+
+    scenic_lib::Session* const session;
+    scenic_lib::EntityNode& parent;
+    std::unique_ptr<scenic_lib::ShapeNode> node;
+    const scenic_lib::Shape* shape = nullptr;
+    uint32_t shape_id = 0;
+    uint32_t material_id = 0;
+    std::array<float, 3> translation = {{0.f, 0.f, 0.f}};
+  };
+
+  struct RetainedEntity {
+    explicit RetainedEntity(scenic_lib::Session* session) : node(session) {}
+
+    scenic_lib::EntityNode node;
+    std::array<float, 3> translation = {{0.f, 0.f, 0.f}};
+    std::array<float, 3> scale = {{1.f, 1.f, 1.f}};
+    std::array<float, 4> rotation = {{0.f, 0.f, 0.f, 1.f}};
+    bool clip_to_self = false;
+    std::vector<std::unique_ptr<RetainedPart>> parts;
+  };
+
+  template <typename Resource>
+  struct CachedResource {
+    std::unique_ptr<Resource> resource;
+    size_t last_used_frame;
+  };
+
+  template <typename Key, typename Resource>
+  using ResourceCache = std::map<Key, CachedResource<Resource>>;
+
   struct PaintTask {
     std::unique_ptr<SurfaceProducerSurface> surface;
     SkScalar left;
@@ -155,18 +227,30 @@ class SceneUpdateContext {
     std::vector<Layer*> layers;
   };
 
-  void CreateFrame(scenic_lib::EntityNode& entity_node,
+  RetainedEntity& AcquireRetainedEntity();
+
+  static void PaintLayers(const PaintTask& task,
+                          SkCanvas& canvas,
+                          CompositorContext::ScopedFrame& frame,
+                          FrameWorkCounts* work_counts);
+
+  // Records the layers of each paint task into a picture, concurrently on the
+  // worker threads, and waits for all of them.
+  std::vector<sk_sp<SkPicture>> RecordPaintTasks(
+      CompositorContext::ScopedFrame& frame);
+
+  void CreateFrame(Entity& entity,
                    const SkRRect& rrect,
                    SkColor color,
                    const SkRect& paint_bounds,
                    std::vector<Layer*> paint_layers);
-  void SetShapeTextureOrColor(scenic_lib::ShapeNode& shape_node,
+  void SetShapeTextureOrColor(RetainedPart& part,
                               SkColor color,
                               SkScalar scale_x,
                               SkScalar scale_y,
                               const SkRect& paint_bounds,
                               std::vector<Layer*> paint_layers);
-  void SetShapeColor(scenic_lib::ShapeNode& shape_node, SkColor color);
+  void SetShapeColor(RetainedPart& part, SkColor color);
   scenic_lib::Image* GenerateImageIfNeeded(SkColor color,
                                            SkScalar scale_x,
                                            SkScalar scale_y,
@@ -184,6 +268,19 @@ class SceneUpdateContext {
 
   std::vector<PaintTask> paint_tasks_;
 
+  // Nodes in the order of the traversal of the layer tree. Layers are rebuilt
+  // every frame, so this is how entities find their node of the previous
+  // frame.
+  std::vector<std::unique_ptr<RetainedEntity>> retained_entities_;
+  size_t retained_entities_used_ = 0;
+
+  size_t frame_count_ = 0;
+  ResourceCache<std::array<float, 2>, scenic_lib::Rectangle> rectangles_;
+  ResourceCache<std::array<float, 6>, scenic_lib::RoundedRectangle>
+      rounded_rectangles_;
+  ResourceCache<SkColor, scenic_lib::Material> color_materials_;
+  ResourceCache<uint32_t, scenic_lib::Material> texture_materials_;
+
   // Save ExportNodes so we can dispose them in our destructor.
   std::set<ExportNode*> export_nodes_;
 
@@ -0,0 +1,42 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/texture.h"
+
+namespace flow {
+
+Texture::Texture(int64_t id) : id_(id) {}
+
+Texture::~Texture() = default;
+
+TextureRegistry::TextureRegistry() = default;
+
+TextureRegistry::~TextureRegistry() = default;
+
+void TextureRegistry::RegisterTexture(std::shared_ptr<Texture> texture) {
+  mapping_[texture->Id()] = std::move(texture);
+}
+
+void TextureRegistry::UnregisterTexture(int64_t id) {
+  mapping_.erase(id);
+}
+
+std::shared_ptr<Texture> TextureRegistry::GetTexture(int64_t id) const {
+  auto found = mapping_.find(id);
+  return found != mapping_.end() ? found->second : nullptr;
+}
+
+void TextureRegistry::OnGrContextCreated() {
+  for (auto& it : mapping_) {
+    it.second->OnGrContextCreated();
+  }
+}
+
+void TextureRegistry::OnGrContextDestroyed() {
+  for (auto& it : mapping_) {
+    it.second->OnGrContextDestroyed();
+  }
+}
+
+}  // namespace flow
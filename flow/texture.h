@@ -0,0 +1,73 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLOW_TEXTURE_H_
+#define FLUTTER_FLOW_TEXTURE_H_
+
+#include <map>
+#include <memory>
+
+#include "lib/fxl/macros.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/gpu/GrContext.h"
+
+namespace flow {
+
+// A texture whose contents are produced outside of Flutter, for example by a
+// video decoder or a camera. All methods are called on the GPU thread.
+class Texture {
+ public:
+  explicit Texture(int64_t id);
+
+  virtual ~Texture();
+
+  // Draws the most recent frame into |bounds|. Draws nothing if no frame has
+  // been produced yet.
+  virtual void Paint(SkCanvas& canvas, const SkRect& bounds) = 0;
+
+  virtual void OnGrContextCreated() = 0;
+
+  // Releases the GPU objects associated with the rasterizer's context.
+  virtual void OnGrContextDestroyed() = 0;
+
+  // Called when the producer has queued a frame that has not been painted
+  // yet.
+  virtual void MarkNewFrameAvailable() = 0;
+
+  int64_t Id() const { return id_; }
+
+ private:
+  const int64_t id_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(Texture);
+};
+
+// The textures that can be composited by a |TextureLayer|, keyed by the id the
+// platform handed out when it registered them. Lives on the GPU thread.
+class TextureRegistry {
+ public:
+  TextureRegistry();
+
+  ~TextureRegistry();
+
+  void RegisterTexture(std::shared_ptr<Texture> texture);
+
+  void UnregisterTexture(int64_t id);
+
+  // Returns null if there is no texture with the id.
+  std::shared_ptr<Texture> GetTexture(int64_t id) const;
+
+  void OnGrContextCreated();
+
+  void OnGrContextDestroyed();
+
+ private:
+  std::map<int64_t, std::shared_ptr<Texture>> mapping_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(TextureRegistry);
+};
+
+}  // namespace flow
+
+#endif  // FLUTTER_FLOW_TEXTURE_H_
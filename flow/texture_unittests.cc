@@ -0,0 +1,54 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/flow/texture.h"
+#include "third_party/gtest/include/gtest/gtest.h"
+
+namespace {
+
+class MockTexture : public flow::Texture {
+ public:
+  explicit MockTexture(int64_t id) : Texture(id) {}
+
+  void Paint(SkCanvas& canvas, const SkRect& bounds) override {}
+
+  void OnGrContextCreated() override { created_count++; }
+
+  void OnGrContextDestroyed() override { destroyed_count++; }
+
+  void MarkNewFrameAvailable() override {}
+
+  int created_count = 0;
+  int destroyed_count = 0;
+};
+
+}  // namespace
+
+TEST(TextureRegistry, TexturesAreFoundById) {
+  flow::TextureRegistry registry;
+  auto texture = std::make_shared<MockTexture>(7);
+  registry.RegisterTexture(texture);
+
+  ASSERT_EQ(registry.GetTexture(7), texture);
+  ASSERT_EQ(registry.GetTexture(8), nullptr);
+
+  registry.UnregisterTexture(7);
+  ASSERT_EQ(registry.GetTexture(7), nullptr);
+}
+
+TEST(TextureRegistry, ContextChangesReachAllTextures) {
+  flow::TextureRegistry registry;
+  auto first = std::make_shared<MockTexture>(1);
+  auto second = std::make_shared<MockTexture>(2);
+  registry.RegisterTexture(first);
+  registry.RegisterTexture(second);
+
+  registry.OnGrContextDestroyed();
+  registry.OnGrContextCreated();
+
+  ASSERT_EQ(first->destroyed_count, 1);
+  ASSERT_EQ(second->destroyed_count, 1);
+  ASSERT_EQ(first->created_count, 1);
+  ASSERT_EQ(second->created_count, 1);
+}
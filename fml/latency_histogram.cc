@@ -0,0 +1,52 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/latency_histogram.h"
+
+#include <limits>
+
+namespace fml {
+
+// Roughly doubling from 100us to 128ms. Anything slower lands in the last
+// bucket.
+static constexpr int64_t kBucketLimitsMicros[LatencyHistogram::kBucketCount] = {
+    100,   250,   500,    1000,   2000,   4000,
+    8000,  16000, 32000,  64000,  128000, std::numeric_limits<int64_t>::max(),
+};
+
+LatencyHistogram::LatencyHistogram() {
+  for (auto& count : counts_) {
+    count.store(0, std::memory_order_relaxed);
+  }
+}
+
+LatencyHistogram::~LatencyHistogram() = default;
+
+int64_t LatencyHistogram::GetBucketLimitMicros(size_t index) {
+  return index < kBucketCount ? kBucketLimitsMicros[index]
+                              : std::numeric_limits<int64_t>::max();
+}
+
+size_t LatencyHistogram::GetBucketIndex(fxl::TimeDelta duration) {
+  const int64_t micros = duration.ToMicroseconds();
+  size_t index = 0;
+  while (index < kBucketCount - 1 && micros >= kBucketLimitsMicros[index]) {
+    index++;
+  }
+  return index;
+}
+
+void LatencyHistogram::Add(fxl::TimeDelta duration) {
+  counts_[GetBucketIndex(duration)].fetch_add(1, std::memory_order_relaxed);
+}
+
+LatencyHistogram::Counts LatencyHistogram::GetCounts() const {
+  Counts counts;
+  for (size_t i = 0; i < kBucketCount; i++) {
+    counts[i] = counts_[i].load(std::memory_order_relaxed);
+  }
+  return counts;
+}
+
+}  // namespace fml
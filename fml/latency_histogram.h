@@ -0,0 +1,51 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_LATENCY_HISTOGRAM_H_
+#define FLUTTER_FML_LATENCY_HISTOGRAM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <array>
+#include <atomic>
+
+#include "lib/fxl/macros.h"
+#include "lib/fxl/time/time_delta.h"
+
+namespace fml {
+
+/// Counts durations in a fixed set of buckets. Recording is a single relaxed
+/// atomic increment, so samples may be added on one thread while another reads
+/// the counts.
+class LatencyHistogram {
+ public:
+  static constexpr size_t kBucketCount = 12;
+
+  using Counts = std::array<uint64_t, kBucketCount>;
+
+  LatencyHistogram();
+
+  ~LatencyHistogram();
+
+  /// The exclusive upper bound in microseconds of bucket |index|. The last
+  /// bucket is unbounded.
+  static int64_t GetBucketLimitMicros(size_t index);
+
+  /// The bucket |duration| is counted in.
+  static size_t GetBucketIndex(fxl::TimeDelta duration);
+
+  void Add(fxl::TimeDelta duration);
+
+  Counts GetCounts() const;
+
+ private:
+  std::array<std::atomic<uint64_t>, kBucketCount> counts_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(LatencyHistogram);
+};
+
+}  // namespace fml
+
+#endif  // FLUTTER_FML_LATENCY_HISTOGRAM_H_
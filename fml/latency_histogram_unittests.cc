@@ -0,0 +1,35 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gtest/gtest.h"
+
+#include "flutter/fml/latency_histogram.h"
+
+TEST(LatencyHistogram, StartsEmpty) {
+  fml::LatencyHistogram histogram;
+  for (auto count : histogram.GetCounts()) {
+    ASSERT_EQ(count, 0u);
+  }
+}
+
+TEST(LatencyHistogram, AddsToTheMatchingBucket) {
+  fml::LatencyHistogram histogram;
+  histogram.Add(fxl::TimeDelta::FromMicroseconds(0));
+  histogram.Add(fxl::TimeDelta::FromMicroseconds(99));
+  histogram.Add(fxl::TimeDelta::FromMicroseconds(100));
+  histogram.Add(fxl::TimeDelta::FromMilliseconds(17));
+  histogram.Add(fxl::TimeDelta::FromSeconds(10));
+  auto counts = histogram.GetCounts();
+  ASSERT_EQ(counts[0], 2u);
+  ASSERT_EQ(counts[1], 1u);
+  // 17ms lands in [16ms, 32ms).
+  ASSERT_EQ(counts[8], 1u);
+  ASSERT_EQ(counts[fml::LatencyHistogram::kBucketCount - 1], 1u);
+}
+
+TEST(LatencyHistogram, NegativeDurationsLandInTheFirstBucket) {
+  fml::LatencyHistogram histogram;
+  histogram.Add(fxl::TimeDelta::FromMicroseconds(-5));
+  ASSERT_EQ(histogram.GetCounts()[0], 1u);
+}
@@ -59,6 +59,10 @@ fxl::RefPtr<fxl::TaskRunner> MessageLoop::GetTaskRunner() const {
   return task_runner_;
 }
 
+void MessageLoop::RunIdleTasks(fxl::TimePoint deadline) {
+  loop_->RunIdleTasks(deadline);
+}
+
 fxl::RefPtr<MessageLoopImpl> MessageLoop::GetLoopImpl() const {
   return loop_;
 }
@@ -8,6 +8,7 @@
 #include "flutter/fml/task_observer.h"
 #include "lib/fxl/macros.h"
 #include "lib/fxl/tasks/task_runner.h"
+#include "lib/fxl/time/time_point.h"
 
 namespace fml {
 
@@ -30,6 +31,11 @@ class MessageLoop {
 
   fxl::RefPtr<fxl::TaskRunner> GetTaskRunner() const;
 
+  // Runs tasks posted via |TaskRunner::PostIdleTask| until |deadline|. Called
+  // by the owner of the loop when it knows the thread has slack, like the time
+  // between a finished frame and the next vsync.
+  void RunIdleTasks(fxl::TimePoint deadline);
+
   static void EnsureInitializedForCurrentThread();
 
   static bool IsInitializedForCurrentThread();
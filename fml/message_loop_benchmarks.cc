@@ -0,0 +1,192 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Benchmarks of posting tasks to and running them on the message loop of the
+// platform the benchmarks are built for: epoll and timerfd on Linux, ALooper
+// on Android, CFRunLoop on Darwin and the Windows message loop. Pass
+//
+//   --benchmark_out=<file> --benchmark_out_format=json
+//
+// to record the results for comparison with later scheduling changes.
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "flutter/fml/message_loop.h"
+#include "flutter/fml/task_priority.h"
+#include "flutter/fml/task_runner.h"
+#include "flutter/fml/thread.h"
+#include "lib/fxl/synchronization/waitable_event.h"
+#include "lib/fxl/time/time_delta.h"
+#include "lib/fxl/time/time_point.h"
+#include "third_party/benchmark/include/benchmark/benchmark_api.h"
+
+namespace fml {
+namespace {
+
+fml::TaskRunner* GetFmlTaskRunner(const fml::Thread& thread) {
+  return static_cast<fml::TaskRunner*>(thread.GetTaskRunner().get());
+}
+
+// Posts |count| empty tasks and then one that signals |done|, so that the
+// iteration covers posting all tasks and the loop draining them.
+void PostTasksAndWait(fxl::TaskRunner* runner,
+                      int count,
+                      fxl::AutoResetWaitableEvent* done) {
+  for (int i = 0; i < count; i++)
+    runner->PostTask([]() {});
+  runner->PostTask([done]() { done->Signal(); });
+  done->Wait();
+}
+
+// Tasks posted in a burst from another thread.
+void BM_PostTaskThroughput(benchmark::State& state) {
+  fml::Thread thread("benchmark");
+  fxl::RefPtr<fxl::TaskRunner> runner = thread.GetTaskRunner();
+  fxl::AutoResetWaitableEvent done;
+  const int count = state.range(0);
+  while (state.KeepRunning())
+    PostTasksAndWait(runner.get(), count, &done);
+  state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_PostTaskThroughput)->Arg(1)->Arg(64)->Arg(1024)->UseRealTime();
+
+// The same burst posted with a single lock acquisition and wake-up.
+void BM_PostTasksBatched(benchmark::State& state) {
+  fml::Thread thread("benchmark");
+  fml::TaskRunner* runner = GetFmlTaskRunner(thread);
+  fxl::AutoResetWaitableEvent done;
+  const int count = state.range(0);
+  while (state.KeepRunning()) {
+    std::vector<fxl::Closure> tasks(count, []() {});
+    tasks.push_back([&done]() { done.Signal(); });
+    runner->PostTasks(std::move(tasks));
+    done.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_PostTasksBatched)->Arg(1)->Arg(64)->Arg(1024)->UseRealTime();
+
+// Tasks posted by the loop to itself, which need no wake-up.
+void BM_PostTaskSameThread(benchmark::State& state) {
+  fml::Thread thread("benchmark");
+  fxl::RefPtr<fxl::TaskRunner> runner = thread.GetTaskRunner();
+  fxl::AutoResetWaitableEvent done;
+  const int count = state.range(0);
+  while (state.KeepRunning()) {
+    runner->PostTask([runner, count, &done]() {
+      for (int i = 0; i < count; i++)
+        runner->PostTask([]() {});
+      runner->PostTask([&done]() { done.Signal(); });
+    });
+    done.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_PostTaskSameThread)->Arg(64)->Arg(1024)->UseRealTime();
+
+// The round trip from posting a task to an idle loop on another thread to
+// being signaled by it. Covers waking the loop up and the benchmark thread
+// waking up in turn.
+void BM_CrossThreadWakeUp(benchmark::State& state) {
+  fml::Thread thread("benchmark");
+  fxl::RefPtr<fxl::TaskRunner> runner = thread.GetTaskRunner();
+  fxl::AutoResetWaitableEvent done;
+  while (state.KeepRunning()) {
+    runner->PostTask([&done]() { done.Signal(); });
+    done.Wait();
+  }
+}
+BENCHMARK(BM_CrossThreadWakeUp)->UseRealTime();
+
+// A task bounced between the loops of two threads, as the UI and GPU
+// threads do every frame. Each item is one hop.
+void BM_CrossThreadPingPong(benchmark::State& state) {
+  fml::Thread ping("ping");
+  fml::Thread pong("pong");
+  fxl::RefPtr<fxl::TaskRunner> ping_runner = ping.GetTaskRunner();
+  fxl::RefPtr<fxl::TaskRunner> pong_runner = pong.GetTaskRunner();
+  fxl::AutoResetWaitableEvent done;
+  const int hops = state.range(0);
+
+  std::function<void(int)> hop;
+  hop = [&](int remaining) {
+    if (remaining == 0) {
+      done.Signal();
+      return;
+    }
+    fxl::TaskRunner* next =
+        remaining % 2 ? pong_runner.get() : ping_runner.get();
+    next->PostTask([&hop, remaining]() { hop(remaining - 1); });
+  };
+
+  while (state.KeepRunning()) {
+    ping_runner->PostTask([&hop, hops]() { hop(hops); });
+    done.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * hops);
+}
+BENCHMARK(BM_CrossThreadPingPong)->Arg(16)->Arg(256)->UseRealTime();
+
+// Delayed tasks posted with decreasing target times, so that every post
+// moves the wake-up of the loop earlier. The loop still runs them in order
+// of their target times.
+void BM_DelayedTasksInReverseOrder(benchmark::State& state) {
+  fml::Thread thread("benchmark");
+  fxl::RefPtr<fxl::TaskRunner> runner = thread.GetTaskRunner();
+  fxl::AutoResetWaitableEvent done;
+  const int count = state.range(0);
+  while (state.KeepRunning()) {
+    const fxl::TimePoint base = fxl::TimePoint::Now();
+    int ran = 0;
+    for (int i = count; i > 0; i--) {
+      runner->PostTaskForTime(
+          [&ran, &done, count]() {
+            if (++ran == count)
+              done.Signal();
+          },
+          base + fxl::TimeDelta::FromMicroseconds(i));
+    }
+    done.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_DelayedTasksInReverseOrder)->Arg(64)->Arg(1024)->UseRealTime();
+
+// Expired tasks spread over the priority lanes. The loop runs the frame
+// critical ones first, then the normal and then the idle ones.
+void BM_PriorityLanes(benchmark::State& state) {
+  fml::Thread thread("benchmark");
+  fml::TaskRunner* runner = GetFmlTaskRunner(thread);
+  fxl::AutoResetWaitableEvent posted;
+  fxl::AutoResetWaitableEvent done;
+  const int count = state.range(0);
+  const TaskPriority kPriorities[] = {TaskPriority::kIdle,
+                                      TaskPriority::kNormal,
+                                      TaskPriority::kFrameCritical};
+  while (state.KeepRunning()) {
+    // Hold the loop until all tasks are posted, so that they are all expired
+    // by the time it picks one.
+    runner->PostTask([&posted]() { posted.Wait(); });
+    int ran = 0;
+    for (int i = 0; i < count; i++) {
+      runner->PostTask(
+          [&ran, &done, count]() {
+            if (++ran == count)
+              done.Signal();
+          },
+          kPriorities[i % 3]);
+    }
+    posted.Signal();
+    done.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_PriorityLanes)->Arg(64)->Arg(1024)->UseRealTime();
+
+}  // namespace
+}  // namespace fml
+
+BENCHMARK_MAIN();
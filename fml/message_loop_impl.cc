@@ -42,13 +42,118 @@ fxl::RefPtr<MessageLoopImpl> MessageLoopImpl::Create() {
   return fxl::MakeRefCounted<::PlatformMessageLoopImpl>();
 }
 
-MessageLoopImpl::MessageLoopImpl() : order_(0), terminated_(false) {}
+MessageLoopImpl::MessageLoopImpl()
+    : order_(0),
+      armed_wake_time_(fxl::TimePoint::Max()),
+      terminated_(false) {}
 
 MessageLoopImpl::~MessageLoopImpl() = default;
 
-void MessageLoopImpl::PostTask(fxl::Closure task, fxl::TimePoint target_time) {
+constexpr size_t MessageLoopImpl::kLaneCount;
+
+size_t MessageLoopImpl::LaneForPriority(TaskPriority priority) {
+  switch (priority) {
+    case TaskPriority::kFrameCritical:
+      return 0;
+    case TaskPriority::kNormal:
+      return 1;
+    case TaskPriority::kIdle:
+      return 2;
+  }
+  return 1;
+}
+
+void MessageLoopImpl::PostTask(fxl::Closure task,
+                               fxl::TimePoint target_time,
+                               TaskPriority priority) {
   FXL_DCHECK(task != nullptr);
-  RegisterTask(task, target_time);
+  RegisterTask(std::move(task), target_time, priority);
+}
+
+void MessageLoopImpl::PostTasks(std::vector<fxl::Closure> tasks,
+                                fxl::TimePoint target_time,
+                                TaskPriority priority) {
+  if (tasks.empty() || terminated_) {
+    return;
+  }
+  fxl::MutexLocker lock(&delayed_tasks_mutex_);
+  auto& queue = delayed_tasks_[LaneForPriority(priority)];
+  for (auto& task : tasks) {
+    FXL_DCHECK(task != nullptr);
+    queue.push({++order_, std::move(task), target_time});
+  }
+  WakeUpIfEarlierLocked(target_time);
+}
+
+void MessageLoopImpl::PostIdleTask(fxl::Closure task,
+                                   fxl::TimePoint deadline) {
+  FXL_DCHECK(task != nullptr);
+  if (terminated_) {
+    return;
+  }
+  fxl::MutexLocker lock(&delayed_tasks_mutex_);
+  idle_tasks_.emplace_back(std::move(task), deadline);
+  if (deadline == fxl::TimePoint::Max()) {
+    return;
+  }
+  // Tasks on the loop are only destroyed on the thread of the loop and while
+  // it is still alive.
+  delayed_tasks_[LaneForPriority(TaskPriority::kIdle)].push(
+      {++order_, [this]() { RunOverdueIdleTasks(); }, deadline});
+  WakeUpIfEarlierLocked(deadline);
+}
+
+void MessageLoopImpl::RunIdleTasks(fxl::TimePoint deadline) {
+  FXL_DCHECK(MessageLoop::GetCurrent().GetLoopImpl().get() == this);
+  TRACE_EVENT0("fml", "MessageLoop::RunIdleTasks");
+  while (fxl::TimePoint::Now() < deadline) {
+    fxl::Closure task;
+    {
+      fxl::MutexLocker lock(&delayed_tasks_mutex_);
+      if (idle_tasks_.empty()) {
+        return;
+      }
+      task = std::move(idle_tasks_.front().task);
+      idle_tasks_.pop_front();
+    }
+    RunTask(task);
+  }
+}
+
+void MessageLoopImpl::RunOverdueIdleTasks() {
+  std::vector<fxl::Closure> invocations;
+  {
+    fxl::MutexLocker lock(&delayed_tasks_mutex_);
+    const auto now = fxl::TimePoint::Now();
+    auto pending = idle_tasks_.begin();
+    for (auto& idle_task : idle_tasks_) {
+      if (idle_task.deadline <= now) {
+        invocations.emplace_back(std::move(idle_task.task));
+      } else {
+        if (&*pending != &idle_task) {
+          *pending = std::move(idle_task);
+        }
+        ++pending;
+      }
+    }
+    idle_tasks_.erase(pending, idle_tasks_.end());
+  }
+  for (const auto& invocation : invocations) {
+    invocation();
+  }
+}
+
+void MessageLoopImpl::RunTask(const fxl::Closure& task,
+                              fxl::TimePoint target_time) {
+  const auto start = fxl::TimePoint::Now();
+  if (target_time != fxl::TimePoint()) {
+    task_queue_delays_.Add(start - target_time);
+  }
+  task();
+  task_durations_.Add(fxl::TimePoint::Now() - start);
+  for (const auto& observer : task_observers_) {
+    observer->DidProcessTask();
+  }
 }
 
 void MessageLoopImpl::RunExpiredTasksNow() {
@@ -95,7 +200,10 @@ void MessageLoopImpl::DoRun() {
   // from the implementations |Run| method which we know is on the correct
   // thread. Drop all pending tasks on the floor.
   fxl::MutexLocker lock(&delayed_tasks_mutex_);
-  delayed_tasks_ = {};
+  for (auto& lane : delayed_tasks_) {
+    lane = {};
+  }
+  idle_tasks_.clear();
 }
 
 void MessageLoopImpl::DoTerminate() {
@@ -104,7 +212,8 @@ void MessageLoopImpl::DoTerminate() {
 }
 
 void MessageLoopImpl::RegisterTask(fxl::Closure task,
-                                   fxl::TimePoint target_time) {
+                                   fxl::TimePoint target_time,
+                                   TaskPriority priority) {
   FXL_DCHECK(task != nullptr);
   if (terminated_) {
     // If the message loop has already been terminated, PostTask should destruct
@@ -112,39 +221,72 @@ void MessageLoopImpl::RegisterTask(fxl::Closure task,
     return;
   }
   fxl::MutexLocker lock(&delayed_tasks_mutex_);
-  delayed_tasks_.push({++order_, std::move(task), target_time});
-  WakeUp(delayed_tasks_.top().target_time);
+  delayed_tasks_[LaneForPriority(priority)].push(
+      {++order_, std::move(task), target_time});
+  WakeUpIfEarlierLocked(target_time);
 }
 
-void MessageLoopImpl::RunExpiredTasks() {
-  TRACE_EVENT0("fml", "MessageLoop::RunExpiredTasks");
-  std::vector<fxl::Closure> invocations;
+void MessageLoopImpl::WakeUpIfEarlierLocked(fxl::TimePoint time_point) {
+  if (time_point >= armed_wake_time_) {
+    // The loop will wake up no later than this already. Avoid the syscall.
+    return;
+  }
+  armed_wake_time_ = time_point;
+  WakeUp(time_point);
+}
 
-  {
-    fxl::MutexLocker lock(&delayed_tasks_mutex_);
+void MessageLoopImpl::RearmLocked() {
+  armed_wake_time_ = GetNextWakeTimeLocked();
+  WakeUp(armed_wake_time_);
+}
 
-    if (delayed_tasks_.empty()) {
-      return;
+fxl::TimePoint MessageLoopImpl::GetNextWakeTimeLocked() const {
+  fxl::TimePoint wake_time = fxl::TimePoint::Max();
+  for (const auto& lane : delayed_tasks_) {
+    if (!lane.empty() && lane.top().target_time < wake_time) {
+      wake_time = lane.top().target_time;
     }
+  }
+  return wake_time;
+}
+
+void MessageLoopImpl::RunExpiredTasks() {
+  TRACE_EVENT0("fml", "MessageLoop::RunExpiredTasks");
 
-    auto now = fxl::TimePoint::Now();
-    while (!delayed_tasks_.empty()) {
-      const auto& top = delayed_tasks_.top();
-      if (top.target_time > now) {
-        break;
+  // Lanes are drained in priority order. Expired tasks of a lane are collected
+  // only once the tasks of the lanes above it have run. Tasks posted to a lane
+  // that was already drained run on the next wake. The platform loop is
+  // re-armed once, after the last lane is collected. Until then, posts from
+  // the running tasks need no wakeup of their own.
+  for (size_t lane = 0; lane < kLaneCount; lane++) {
+    std::vector<DelayedTask> invocations;
+
+    {
+      fxl::MutexLocker lock(&delayed_tasks_mutex_);
+
+      auto now = fxl::TimePoint::Now();
+      auto& queue = delayed_tasks_[lane];
+      while (!queue.empty()) {
+        const auto& top = queue.top();
+        if (top.target_time > now) {
+          break;
+        }
+        invocations.emplace_back(top.order, std::move(top.task),
+                                 top.target_time);
+        queue.pop();
       }
-      invocations.emplace_back(std::move(top.task));
-      delayed_tasks_.pop();
-    }
 
-    WakeUp(delayed_tasks_.empty() ? fxl::TimePoint::Max()
-                                  : delayed_tasks_.top().target_time);
-  }
+      if (lane == 0) {
+        // The loop is awake and will be re-armed below.
+        armed_wake_time_ = fxl::TimePoint();
+      }
+      if (lane == kLaneCount - 1) {
+        RearmLocked();
+      }
+    }
 
-  for (const auto& invocation : invocations) {
-    invocation();
-    for (const auto& observer : task_observers_) {
-      observer->DidProcessTask();
+    for (const auto& invocation : invocations) {
+      RunTask(invocation.task, invocation.target_time);
     }
   }
 }
@@ -10,8 +10,11 @@
 #include <queue>
 #include <set>
 #include <utility>
+#include <vector>
 
+#include "flutter/fml/latency_histogram.h"
 #include "flutter/fml/message_loop.h"
+#include "flutter/fml/task_priority.h"
 #include "lib/fxl/functional/closure.h"
 #include "lib/fxl/macros.h"
 #include "lib/fxl/memory/ref_counted.h"
@@ -33,7 +36,32 @@ class MessageLoopImpl : public fxl::RefCountedThreadSafe<MessageLoopImpl> {
 
   virtual void WakeUp(fxl::TimePoint time_point) = 0;
 
-  void PostTask(fxl::Closure task, fxl::TimePoint target_time);
+  void PostTask(fxl::Closure task,
+                fxl::TimePoint target_time,
+                TaskPriority priority = TaskPriority::kNormal);
+
+  // Enqueues all tasks with a single acquisition of the task queue lock and
+  // at most one wakeup. The tasks run in the order given.
+  void PostTasks(std::vector<fxl::Closure> tasks,
+                 fxl::TimePoint target_time,
+                 TaskPriority priority = TaskPriority::kNormal);
+
+  // Queues |task| to run when the owner of the loop reports slack via
+  // |RunIdleTasks|. If that does not happen before |deadline|, the task runs
+  // as an idle priority task at |deadline| instead.
+  void PostIdleTask(fxl::Closure task, fxl::TimePoint deadline);
+
+  // Runs queued idle tasks in the order they were posted for as long as
+  // |deadline| has not passed. Must be called on the thread of the loop.
+  void RunIdleTasks(fxl::TimePoint deadline);
+
+  // How long expired tasks waited past their target time before they ran.
+  const LatencyHistogram& task_queue_delays() const {
+    return task_queue_delays_;
+  }
+
+  // How long tasks ran, including idle tasks.
+  const LatencyHistogram& task_durations() const { return task_durations_; }
 
   void AddTaskObserver(TaskObserver* observer);
 
@@ -70,16 +98,59 @@ class MessageLoopImpl : public fxl::RefCountedThreadSafe<MessageLoopImpl> {
   using DelayedTaskQueue = std::
       priority_queue<DelayedTask, std::deque<DelayedTask>, DelayedTaskCompare>;
 
+  struct IdleTask {
+    fxl::Closure task;
+    fxl::TimePoint deadline;
+
+    IdleTask(fxl::Closure p_task, fxl::TimePoint p_deadline)
+        : task(std::move(p_task)), deadline(p_deadline) {}
+  };
+
+  // One queue per |TaskPriority|, ordered from the highest priority lane to the
+  // lowest.
+  static constexpr size_t kLaneCount = 3;
+
+  static size_t LaneForPriority(TaskPriority priority);
+
   std::set<TaskObserver*> task_observers_;
   fxl::Mutex delayed_tasks_mutex_;
-  DelayedTaskQueue delayed_tasks_ FXL_GUARDED_BY(delayed_tasks_mutex_);
+  DelayedTaskQueue delayed_tasks_[kLaneCount] FXL_GUARDED_BY(
+      delayed_tasks_mutex_);
+  std::deque<IdleTask> idle_tasks_ FXL_GUARDED_BY(delayed_tasks_mutex_);
   size_t order_ FXL_GUARDED_BY(delayed_tasks_mutex_);
+  // The time the platform loop was last asked to wake up at. The platform
+  // loop is only re-armed when the earliest pending deadline moves earlier
+  // than this or once the loop has serviced its tasks.
+  fxl::TimePoint armed_wake_time_ FXL_GUARDED_BY(delayed_tasks_mutex_);
   std::atomic_bool terminated_;
+  LatencyHistogram task_queue_delays_;
+  LatencyHistogram task_durations_;
 
-  void RegisterTask(fxl::Closure task, fxl::TimePoint target_time);
+  void RegisterTask(fxl::Closure task,
+                    fxl::TimePoint target_time,
+                    TaskPriority priority);
 
   void RunExpiredTasks();
 
+  // Runs the idle tasks whose deadline has passed without the loop reporting
+  // enough slack to run them.
+  void RunOverdueIdleTasks();
+
+  // Runs |task| and records its timing. Tasks without a |target_time|, like
+  // idle tasks, record no queue delay.
+  void RunTask(const fxl::Closure& task,
+               fxl::TimePoint target_time = fxl::TimePoint());
+
+  fxl::TimePoint GetNextWakeTimeLocked() const
+      FXL_EXCLUSIVE_LOCKS_REQUIRED(delayed_tasks_mutex_);
+
+  // Wakes the platform loop at |time_point| if it is earlier than the time the
+  // loop is already armed for.
+  void WakeUpIfEarlierLocked(fxl::TimePoint time_point)
+      FXL_EXCLUSIVE_LOCKS_REQUIRED(delayed_tasks_mutex_);
+
+  void RearmLocked() FXL_EXCLUSIVE_LOCKS_REQUIRED(delayed_tasks_mutex_);
+
   FXL_DISALLOW_COPY_AND_ASSIGN(MessageLoopImpl);
 };
 
@@ -3,8 +3,11 @@
 // found in the LICENSE file.
 
 #include <thread>
+#include <vector>
 
 #include "flutter/fml/message_loop.h"
+#include "flutter/fml/task_priority.h"
+#include "flutter/fml/task_runner.h"
 #include "gtest/gtest.h"
 #include "lib/fxl/synchronization/waitable_event.h"
 
@@ -284,3 +287,128 @@ TEST(MessageLoop, TaskObserverFire) {
   ASSERT_TRUE(started);
   ASSERT_TRUE(terminated);
 }
+
+TEST(MessageLoop, HigherPriorityTasksRunFirst) {
+  bool terminated = false;
+  std::thread thread([&terminated]() {
+    fml::MessageLoop::EnsureInitializedForCurrentThread();
+    auto& loop = fml::MessageLoop::GetCurrent();
+    auto runner = loop.GetTaskRunner();
+    std::vector<int> order;
+    {
+      fml::ScopedTaskPriority priority(fml::TaskPriority::kIdle);
+      runner->PostTask([&terminated, &order]() {
+        order.push_back(3);
+        fml::MessageLoop::GetCurrent().Terminate();
+        terminated = true;
+      });
+    }
+    runner->PostTask([&order]() { order.push_back(2); });
+    {
+      fml::ScopedTaskPriority priority(fml::TaskPriority::kFrameCritical);
+      runner->PostTask([&order]() { order.push_back(1); });
+    }
+    ASSERT_EQ(fml::GetCurrentTaskPriority(), fml::TaskPriority::kNormal);
+    loop.Run();
+    ASSERT_EQ(order, std::vector<int>({1, 2, 3}));
+  });
+  thread.join();
+  ASSERT_TRUE(terminated);
+}
+
+TEST(MessageLoop, BulkPostedTasksRunInOrder) {
+  bool terminated = false;
+  std::thread thread([&terminated]() {
+    fml::MessageLoop::EnsureInitializedForCurrentThread();
+    auto& loop = fml::MessageLoop::GetCurrent();
+    auto runner = static_cast<fml::TaskRunner*>(loop.GetTaskRunner().get());
+    std::vector<int> order;
+    std::vector<fxl::Closure> tasks;
+    for (int i = 0; i < 10; i++) {
+      tasks.emplace_back([&order, i]() { order.push_back(i); });
+    }
+    tasks.emplace_back([&terminated]() {
+      fml::MessageLoop::GetCurrent().Terminate();
+      terminated = true;
+    });
+    runner->PostTasks(std::move(tasks));
+    loop.Run();
+    ASSERT_EQ(order, std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+  });
+  thread.join();
+  ASSERT_TRUE(terminated);
+}
+
+TEST(MessageLoop, IdleTasksRunOnlyInSlackTime) {
+  bool terminated = false;
+  std::thread thread([&terminated]() {
+    fml::MessageLoop::EnsureInitializedForCurrentThread();
+    auto& loop = fml::MessageLoop::GetCurrent();
+    auto runner = static_cast<fml::TaskRunner*>(loop.GetTaskRunner().get());
+    bool idle_task_ran = false;
+    runner->PostIdleTask([&idle_task_ran]() { idle_task_ran = true; },
+                         fxl::TimePoint::Max());
+    runner->PostTask([&terminated, &idle_task_ran]() {
+      ASSERT_FALSE(idle_task_ran);
+      auto& loop = fml::MessageLoop::GetCurrent();
+      // No slack left. The task must stay queued.
+      loop.RunIdleTasks(fxl::TimePoint::Now());
+      ASSERT_FALSE(idle_task_ran);
+      loop.RunIdleTasks(fxl::TimePoint::Now() +
+                        fxl::TimeDelta::FromSeconds(10));
+      ASSERT_TRUE(idle_task_ran);
+      loop.Terminate();
+      terminated = true;
+    });
+    loop.Run();
+  });
+  thread.join();
+  ASSERT_TRUE(terminated);
+}
+
+TEST(MessageLoop, TIME_SENSITIVE(IdleTasksRunAtDeadlineWithoutSlack)) {
+  bool checked = false;
+  std::thread thread([&checked]() {
+    fml::MessageLoop::EnsureInitializedForCurrentThread();
+    auto& loop = fml::MessageLoop::GetCurrent();
+    auto runner = static_cast<fml::TaskRunner*>(loop.GetTaskRunner().get());
+    auto begin = fxl::TimePoint::Now();
+    runner->PostIdleTask(
+        [&checked, begin]() {
+          auto delta = fxl::TimePoint::Now() - begin;
+          ASSERT_GE(delta.ToMilliseconds(), 5);
+          fml::MessageLoop::GetCurrent().Terminate();
+          checked = true;
+        },
+        begin + fxl::TimeDelta::FromMilliseconds(5));
+    loop.Run();
+  });
+  thread.join();
+  ASSERT_TRUE(checked);
+}
+
+TEST(MessageLoop, RecordsTaskLatencies) {
+  fxl::RefPtr<fxl::TaskRunner> runner;
+  std::thread thread([&runner]() {
+    fml::MessageLoop::EnsureInitializedForCurrentThread();
+    auto& loop = fml::MessageLoop::GetCurrent();
+    runner = loop.GetTaskRunner();
+    for (int i = 0; i < 3; i++) {
+      runner->PostTask([]() {});
+    }
+    runner->PostTask([]() { fml::MessageLoop::GetCurrent().Terminate(); });
+    loop.Run();
+  });
+  thread.join();
+  auto* fml_runner = static_cast<fml::TaskRunner*>(runner.get());
+  uint64_t delays = 0;
+  for (auto count : fml_runner->GetTaskQueueDelays().GetCounts()) {
+    delays += count;
+  }
+  uint64_t durations = 0;
+  for (auto count : fml_runner->GetTaskDurations().GetCounts()) {
+    durations += count;
+  }
+  ASSERT_EQ(delays, 4u);
+  ASSERT_EQ(durations, 4u);
+}
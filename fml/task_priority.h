@@ -0,0 +1,48 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_TASK_PRIORITY_H_
+#define FLUTTER_FML_TASK_PRIORITY_H_
+
+#include "lib/fxl/macros.h"
+
+namespace fml {
+
+/// Message loops service expired tasks in separate lanes per priority. All
+/// expired frame critical tasks run before expired normal tasks, which in turn
+/// run before expired idle tasks. Tasks within a lane run in the order of their
+/// target times and then in the order in which they were posted.
+enum class TaskPriority {
+  kNormal = 0,
+  /// Work that a frame in flight is waiting on, like beginning a frame on the
+  /// UI thread or rasterizing one on the GPU thread.
+  kFrameCritical,
+  /// Work that may be delayed indefinitely behind other work.
+  kIdle,
+};
+
+/// The priority that applies to tasks posted on the current thread through
+/// the |fxl::TaskRunner| interface of an |fml::TaskRunner|.
+TaskPriority GetCurrentTaskPriority();
+
+/// Sets the priority of tasks posted on the current thread through the
+/// |fxl::TaskRunner| interface for the lifetime of the scope. This allows
+/// callers that only have an |fxl::TaskRunner| (like the runners vended by
+/// |blink::Threads|) to prioritize their tasks. Runners that are not backed by
+/// an |fml::MessageLoop| ignore the priority.
+class ScopedTaskPriority {
+ public:
+  explicit ScopedTaskPriority(TaskPriority priority);
+
+  ~ScopedTaskPriority();
+
+ private:
+  const TaskPriority previous_priority_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(ScopedTaskPriority);
+};
+
+}  // namespace fml
+
+#endif  // FLUTTER_FML_TASK_PRIORITY_H_
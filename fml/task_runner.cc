@@ -8,9 +8,25 @@
 
 #include "flutter/fml/message_loop.h"
 #include "flutter/fml/message_loop_impl.h"
+#include "flutter/fml/thread_local.h"
 
 namespace fml {
 
+FML_THREAD_LOCAL ThreadLocal tls_task_priority;
+
+TaskPriority GetCurrentTaskPriority() {
+  return static_cast<TaskPriority>(tls_task_priority.Get());
+}
+
+ScopedTaskPriority::ScopedTaskPriority(TaskPriority priority)
+    : previous_priority_(GetCurrentTaskPriority()) {
+  tls_task_priority.Set(static_cast<intptr_t>(priority));
+}
+
+ScopedTaskPriority::~ScopedTaskPriority() {
+  tls_task_priority.Set(static_cast<intptr_t>(previous_priority_));
+}
+
 TaskRunner::TaskRunner(fxl::RefPtr<MessageLoopImpl> loop)
     : loop_(std::move(loop)) {
   FXL_CHECK(loop_);
@@ -19,16 +35,42 @@ TaskRunner::TaskRunner(fxl::RefPtr<MessageLoopImpl> loop)
 TaskRunner::~TaskRunner() = default;
 
 void TaskRunner::PostTask(fxl::Closure task) {
-  loop_->PostTask(std::move(task), fxl::TimePoint::Now());
+  loop_->PostTask(std::move(task), fxl::TimePoint::Now(),
+                  GetCurrentTaskPriority());
 }
 
 void TaskRunner::PostTaskForTime(fxl::Closure task,
                                  fxl::TimePoint target_time) {
-  loop_->PostTask(std::move(task), target_time);
+  loop_->PostTask(std::move(task), target_time, GetCurrentTaskPriority());
 }
 
 void TaskRunner::PostDelayedTask(fxl::Closure task, fxl::TimeDelta delay) {
-  loop_->PostTask(std::move(task), fxl::TimePoint::Now() + delay);
+  loop_->PostTask(std::move(task), fxl::TimePoint::Now() + delay,
+                  GetCurrentTaskPriority());
+}
+
+void TaskRunner::PostTask(fxl::Closure task, TaskPriority priority) {
+  loop_->PostTask(std::move(task), fxl::TimePoint::Now(), priority);
+}
+
+void TaskRunner::PostTaskForTime(fxl::Closure task,
+                                 fxl::TimePoint target_time,
+                                 TaskPriority priority) {
+  loop_->PostTask(std::move(task), target_time, priority);
+}
+
+void TaskRunner::PostTasks(std::vector<fxl::Closure> tasks) {
+  loop_->PostTasks(std::move(tasks), fxl::TimePoint::Now(),
+                   GetCurrentTaskPriority());
+}
+
+void TaskRunner::PostTasks(std::vector<fxl::Closure> tasks,
+                           TaskPriority priority) {
+  loop_->PostTasks(std::move(tasks), fxl::TimePoint::Now(), priority);
+}
+
+void TaskRunner::PostIdleTask(fxl::Closure task, fxl::TimePoint deadline) {
+  loop_->PostIdleTask(std::move(task), deadline);
 }
 
 bool TaskRunner::RunsTasksOnCurrentThread() {
@@ -38,4 +80,12 @@ bool TaskRunner::RunsTasksOnCurrentThread() {
   return MessageLoop::GetCurrent().GetLoopImpl() == loop_;
 }
 
+const LatencyHistogram& TaskRunner::GetTaskQueueDelays() const {
+  return loop_->task_queue_delays();
+}
+
+const LatencyHistogram& TaskRunner::GetTaskDurations() const {
+  return loop_->task_durations();
+}
+
 }  // namespace fml
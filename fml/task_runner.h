@@ -5,6 +5,10 @@
 #ifndef FLUTTER_FML_TASK_RUNNER_H_
 #define FLUTTER_FML_TASK_RUNNER_H_
 
+#include <vector>
+
+#include "flutter/fml/latency_histogram.h"
+#include "flutter/fml/task_priority.h"
 #include "lib/fxl/macros.h"
 #include "lib/fxl/memory/ref_counted.h"
 #include "lib/fxl/tasks/task_runner.h"
@@ -23,6 +27,30 @@ class TaskRunner : public fxl::TaskRunner {
 
   bool RunsTasksOnCurrentThread() override;
 
+  // Histograms of how late tasks on the loop started past their target time
+  // and how long they ran. Safe to read from any thread.
+  const LatencyHistogram& GetTaskQueueDelays() const;
+
+  const LatencyHistogram& GetTaskDurations() const;
+
+  void PostTask(fxl::Closure task, TaskPriority priority);
+
+  void PostTaskForTime(fxl::Closure task,
+                       fxl::TimePoint target_time,
+                       TaskPriority priority);
+
+  // Posts all |tasks| to run in order with a single lock acquisition and at
+  // most one wakeup of the target loop.
+  void PostTasks(std::vector<fxl::Closure> tasks);
+
+  void PostTasks(std::vector<fxl::Closure> tasks, TaskPriority priority);
+
+  // Posts |task| to run when the thread of the loop has slack, see
+  // |MessageLoop::RunIdleTasks|. Tasks that find no slack before |deadline|
+  // run at |deadline| as |TaskPriority::kIdle| tasks. Pass
+  // |fxl::TimePoint::Max()| to only ever run the task in slack time.
+  void PostIdleTask(fxl::Closure task, fxl::TimePoint deadline);
+
  private:
   fxl::RefPtr<MessageLoopImpl> loop_;
 
@@ -12,19 +12,36 @@
 #include <pthread.h>
 #endif
 
+#if OS_MACOSX
+#include <sys/qos.h>
+#elif OS_LINUX || OS_ANDROID
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <fstream>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "flutter/fml/message_loop.h"
 #include "lib/fxl/synchronization/waitable_event.h"
 
 namespace fml {
 
-Thread::Thread(const std::string& name) : joined_(false) {
+Thread::Thread(const std::string& name, ThreadPriority priority)
+    : joined_(false) {
   fxl::AutoResetWaitableEvent latch;
   fxl::RefPtr<fxl::TaskRunner> runner;
-  thread_ = std::make_unique<std::thread>([&latch, &runner, name]() -> void {
+  thread_ = std::make_unique<std::thread>([&latch, &runner, name,
+                                           priority]() -> void {
     SetCurrentThreadName(name);
+    if (priority != ThreadPriority::kNormal) {
+      SetCurrentThreadPriority(priority);
+    }
     fml::MessageLoop::EnsureInitializedForCurrentThread();
     auto& loop = MessageLoop::GetCurrent();
     runner = loop.GetTaskRunner();
@@ -88,4 +105,104 @@ void Thread::SetCurrentThreadName(const std::string& name) {
 #endif
 }
 
+#if OS_LINUX || OS_ANDROID
+// Returns the processors with the highest maximum frequency. Empty if they
+// cannot be determined or if all processors are alike.
+static std::vector<int> GetFastestProcessors() {
+  std::vector<std::pair<int, long>> frequencies;
+  const int processors = std::thread::hardware_concurrency();
+  for (int i = 0; i < processors; i++) {
+    std::ifstream file("/sys/devices/system/cpu/cpu" + std::to_string(i) +
+                       "/cpufreq/cpuinfo_max_freq");
+    long frequency = 0;
+    if (!(file >> frequency)) {
+      return {};
+    }
+    frequencies.emplace_back(i, frequency);
+  }
+
+  long fastest = 0;
+  long slowest = 0;
+  for (const auto& frequency : frequencies) {
+    fastest = std::max(fastest, frequency.second);
+    slowest = slowest == 0 ? frequency.second
+                           : std::min(slowest, frequency.second);
+  }
+
+  std::vector<int> result;
+  if (fastest == slowest) {
+    return result;
+  }
+  for (const auto& frequency : frequencies) {
+    if (frequency.second == fastest) {
+      result.push_back(frequency.first);
+    }
+  }
+  return result;
+}
+#endif
+
+bool Thread::SetCurrentThreadPriority(ThreadPriority priority) {
+#if OS_MACOSX
+  qos_class_t qos_class = QOS_CLASS_DEFAULT;
+  switch (priority) {
+    case ThreadPriority::kBackground:
+      qos_class = QOS_CLASS_UTILITY;
+      break;
+    case ThreadPriority::kNormal:
+      qos_class = QOS_CLASS_DEFAULT;
+      break;
+    case ThreadPriority::kDisplay:
+      qos_class = QOS_CLASS_USER_INTERACTIVE;
+      break;
+  }
+  return pthread_set_qos_class_self_np(qos_class, 0) == 0;
+#elif OS_LINUX || OS_ANDROID
+  // Nice values match the Android THREAD_PRIORITY_* constants.
+  int nice_value = 0;
+  switch (priority) {
+    case ThreadPriority::kBackground:
+      nice_value = 10;
+      break;
+    case ThreadPriority::kNormal:
+      nice_value = 0;
+      break;
+    case ThreadPriority::kDisplay:
+      nice_value = -4;
+      break;
+  }
+  const pid_t tid = static_cast<pid_t>(syscall(SYS_gettid));
+  bool success = setpriority(PRIO_PROCESS, tid, nice_value) == 0;
+
+  if (priority == ThreadPriority::kDisplay) {
+    const auto processors = GetFastestProcessors();
+    if (!processors.empty()) {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      for (int processor : processors) {
+        CPU_SET(processor, &set);
+      }
+      success = sched_setaffinity(tid, sizeof(set), &set) == 0 && success;
+    }
+  }
+  return success;
+#elif OS_WIN
+  int thread_priority = THREAD_PRIORITY_NORMAL;
+  switch (priority) {
+    case ThreadPriority::kBackground:
+      thread_priority = THREAD_PRIORITY_BELOW_NORMAL;
+      break;
+    case ThreadPriority::kNormal:
+      thread_priority = THREAD_PRIORITY_NORMAL;
+      break;
+    case ThreadPriority::kDisplay:
+      thread_priority = THREAD_PRIORITY_ABOVE_NORMAL;
+      break;
+  }
+  return ::SetThreadPriority(GetCurrentThread(), thread_priority) != 0;
+#else
+#error Unsupported Platform
+#endif
+}
+
 }  // namespace fml
@@ -14,9 +14,22 @@
 
 namespace fml {
 
+/// Scheduling hints for threads. How each maps to the scheduler is platform
+/// specific. Raising the priority of a thread may require privileges the
+/// process lacks, in which case the thread keeps its current priority.
+enum class ThreadPriority {
+  /// Work no frame is waiting on, like IO.
+  kBackground,
+  kNormal,
+  /// Threads that produce frames, like the UI and GPU threads. On big.LITTLE
+  /// systems these are also kept on the fastest cores.
+  kDisplay,
+};
+
 class Thread {
  public:
-  explicit Thread(const std::string& name = "");
+  explicit Thread(const std::string& name = "",
+                  ThreadPriority priority = ThreadPriority::kNormal);
 
   ~Thread();
 
@@ -24,13 +37,16 @@ class Thread {
 
   void Join();
 
+  static void SetCurrentThreadName(const std::string& name);
+
+  /// Returns false if the platform refused to apply |priority|.
+  static bool SetCurrentThreadPriority(ThreadPriority priority);
+
  private:
   std::unique_ptr<std::thread> thread_;
   fxl::RefPtr<fxl::TaskRunner> task_runner_;
   std::atomic_bool joined_;
 
-  static void SetCurrentThreadName(const std::string& name);
-
   FXL_DISALLOW_COPY_AND_ASSIGN(Thread);
 };
 
@@ -24,3 +24,15 @@ TEST(Thread, HasARunningMessageLoop) {
   thread.Join();
   ASSERT_TRUE(done);
 }
+
+TEST(Thread, CanStartWithPriority) {
+  fml::Thread thread("test", fml::ThreadPriority::kBackground);
+  bool done = false;
+  thread.GetTaskRunner()->PostTask([&done]() {
+    // Lowering the priority needs no privileges.
+    done = fml::Thread::SetCurrentThreadPriority(
+        fml::ThreadPriority::kBackground);
+  });
+  thread.Join();
+  ASSERT_TRUE(done);
+}
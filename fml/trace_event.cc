@@ -4,12 +4,14 @@
 
 #include "flutter/fml/trace_event.h"
 
+#include "flutter/fml/trace_recorder.h"
 #include "third_party/dart/runtime/include/dart_tools_api.h"
 
 namespace fml {
 namespace tracing {
 
 void TraceEvent0(TraceArg category_group, TraceArg name) {
+  TraceRecorder::Record(TraceRecord::Type::kBegin, name, 0);
   Dart_TimelineEvent(name,                       // label
                      Dart_TimelineGetMicros(),   // timestamp0
                      0,                          // timestamp1_or_async_id
@@ -24,6 +26,7 @@ void TraceEvent1(TraceArg category_group,
                  TraceArg name,
                  TraceArg arg1_name,
                  TraceArg arg1_val) {
+  TraceRecorder::Record(TraceRecord::Type::kBegin, name, 0);
   const char* arg_names[] = {arg1_name};
   const char* arg_values[] = {arg1_val};
   Dart_TimelineEvent(name,                       // label
@@ -42,6 +45,7 @@ void TraceEvent2(TraceArg category_group,
                  TraceArg arg1_val,
                  TraceArg arg2_name,
                  TraceArg arg2_val) {
+  TraceRecorder::Record(TraceRecord::Type::kBegin, name, 0);
   const char* arg_names[] = {arg1_name, arg2_name};
   const char* arg_values[] = {arg1_val, arg2_val};
   Dart_TimelineEvent(name,                       // label
@@ -55,6 +59,7 @@ void TraceEvent2(TraceArg category_group,
 }
 
 void TraceEventEnd(TraceArg name) {
+  TraceRecorder::Record(TraceRecord::Type::kEnd, name, 0);
   Dart_TimelineEvent(name,                      // label
                      Dart_TimelineGetMicros(),  // timestamp0
                      0,                         // timestamp1_or_async_id
@@ -68,6 +73,7 @@ void TraceEventEnd(TraceArg name) {
 void TraceEventAsyncBegin0(TraceArg category_group,
                            TraceArg name,
                            TraceIDArg id) {
+  TraceRecorder::Record(TraceRecord::Type::kAsyncBegin, name, id);
   Dart_TimelineEvent(name,                             // label
                      Dart_TimelineGetMicros(),         // timestamp0
                      id,                               // timestamp1_or_async_id
@@ -81,6 +87,7 @@ void TraceEventAsyncBegin0(TraceArg category_group,
 void TraceEventAsyncEnd0(TraceArg category_group,
                          TraceArg name,
                          TraceIDArg id) {
+  TraceRecorder::Record(TraceRecord::Type::kAsyncEnd, name, id);
   Dart_TimelineEvent(name,                           // label
                      Dart_TimelineGetMicros(),       // timestamp0
                      id,                             // timestamp1_or_async_id
@@ -96,6 +103,7 @@ void TraceEventAsyncBegin1(TraceArg category_group,
                            TraceIDArg id,
                            TraceArg arg1_name,
                            TraceArg arg1_val) {
+  TraceRecorder::Record(TraceRecord::Type::kAsyncBegin, name, id);
   const char* arg_names[] = {arg1_name};
   const char* arg_values[] = {arg1_val};
   Dart_TimelineEvent(name,                             // label
@@ -113,6 +121,7 @@ void TraceEventAsyncEnd1(TraceArg category_group,
                          TraceIDArg id,
                          TraceArg arg1_name,
                          TraceArg arg1_val) {
+  TraceRecorder::Record(TraceRecord::Type::kAsyncEnd, name, id);
   const char* arg_names[] = {arg1_name};
   const char* arg_values[] = {arg1_val};
   Dart_TimelineEvent(name,                           // label
@@ -126,6 +135,7 @@ void TraceEventAsyncEnd1(TraceArg category_group,
 }
 
 void TraceEventInstant0(TraceArg category_group, TraceArg name) {
+  TraceRecorder::Record(TraceRecord::Type::kInstant, name, 0);
   Dart_TimelineEvent(name,                         // label
                      Dart_TimelineGetMicros(),     // timestamp0
                      0,                            // timestamp1_or_async_id
@@ -136,9 +146,25 @@ void TraceEventInstant0(TraceArg category_group, TraceArg name) {
   );
 }
 
+void TraceCounter(TraceArg category_group, TraceArg name, int64_t value) {
+  TraceRecorder::Record(TraceRecord::Type::kCounter, name, value);
+  const std::string value_string = std::to_string(value);
+  const char* arg_names[] = {name};
+  const char* arg_values[] = {value_string.c_str()};
+  Dart_TimelineEvent(name,                         // label
+                     Dart_TimelineGetMicros(),     // timestamp0
+                     0,                            // timestamp1_or_async_id
+                     Dart_Timeline_Event_Counter,  // event type
+                     1,                            // argument_count
+                     arg_names,                    // argument_names
+                     arg_values                    // argument_values
+  );
+}
+
 void TraceEventFlowBegin0(TraceArg category_group,
                           TraceArg name,
                           TraceIDArg id) {
+  TraceRecorder::Record(TraceRecord::Type::kFlowBegin, name, id);
   Dart_TimelineEvent(name,                            // label
                      Dart_TimelineGetMicros(),        // timestamp0
                      id,                              // timestamp1_or_async_id
@@ -152,6 +178,7 @@ void TraceEventFlowBegin0(TraceArg category_group,
 void TraceEventFlowStep0(TraceArg category_group,
                          TraceArg name,
                          TraceIDArg id) {
+  TraceRecorder::Record(TraceRecord::Type::kFlowStep, name, id);
   Dart_TimelineEvent(name,                           // label
                      Dart_TimelineGetMicros(),       // timestamp0
                      id,                             // timestamp1_or_async_id
@@ -163,6 +190,7 @@ void TraceEventFlowStep0(TraceArg category_group,
 }
 
 void TraceEventFlowEnd0(TraceArg category_group, TraceArg name, TraceIDArg id) {
+  TraceRecorder::Record(TraceRecord::Type::kFlowEnd, name, id);
   Dart_TimelineEvent(name,                          // label
                      Dart_TimelineGetMicros(),      // timestamp0
                      id,                            // timestamp1_or_async_id
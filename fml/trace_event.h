@@ -45,6 +45,9 @@
 #define TRACE_EVENT_INSTANT0(category_group, name) \
   ::fml::tracing::TraceEventInstant0(category_group, name);
 
+#define TRACE_COUNTER1(category_group, name, value) \
+  ::fml::tracing::TraceCounter(category_group, name, value);
+
 #define TRACE_FLOW_BEGIN(category, name, id, args...) \
   ::fml::tracing::TraceEventFlowBegin0(category, name, id);
 
@@ -98,6 +101,8 @@ void TraceEventAsyncEnd1(TraceArg category_group,
 
 void TraceEventInstant0(TraceArg category_group, TraceArg name);
 
+void TraceCounter(TraceArg category_group, TraceArg name, int64_t value);
+
 void TraceEventFlowBegin0(TraceArg category_group,
                           TraceArg name,
                           TraceIDArg id);
@@ -0,0 +1,225 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/trace_recorder.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include "flutter/fml/thread_local.h"
+#include "lib/fxl/time/time_point.h"
+
+namespace fml {
+namespace tracing {
+namespace {
+
+// The records of a single thread. Only that thread writes to it. Buffers are
+// never freed so that the events of threads that have exited can still be
+// dumped.
+class ThreadBuffer {
+ public:
+  explicit ThreadBuffer(size_t thread_id)
+      : thread_id_(thread_id),
+        records_(new TraceRecord[TraceRecorder::kRecordsPerThread]) {}
+
+  size_t thread_id() const { return thread_id_; }
+
+  void Append(TraceRecord::Type type,
+              const char* name,
+              int64_t value,
+              int64_t timestamp_micros) {
+    const uint64_t index = next_index_.load(std::memory_order_relaxed);
+    TraceRecord& record =
+        records_[index % TraceRecorder::kRecordsPerThread];
+    record.timestamp_micros = timestamp_micros;
+    record.value = value;
+    record.type = type;
+    strncpy(record.name, name ? name : "", TraceRecord::kMaxNameLength);
+    record.name[TraceRecord::kMaxNameLength] = '\0';
+    next_index_.store(index + 1, std::memory_order_release);
+  }
+
+  // Copies the records that were not being overwritten while they were read,
+  // oldest first.
+  std::vector<TraceRecord> Snapshot() const {
+    const uint64_t capacity = TraceRecorder::kRecordsPerThread;
+    const uint64_t end = next_index_.load(std::memory_order_acquire);
+    uint64_t begin = end > capacity ? end - capacity : 0;
+
+    std::vector<TraceRecord> records;
+    records.reserve(end - begin);
+    for (uint64_t index = begin; index < end; index++) {
+      records.push_back(records_[index % capacity]);
+    }
+
+    // The writer may have wrapped around onto the oldest records, including
+    // the one it is writing now.
+    const uint64_t last = next_index_.load(std::memory_order_acquire);
+    if (last + 1 > begin + capacity) {
+      const uint64_t overwritten =
+          std::min<uint64_t>(last + 1 - capacity - begin, records.size());
+      records.erase(records.begin(), records.begin() + overwritten);
+    }
+    return records;
+  }
+
+ private:
+  const size_t thread_id_;
+  std::unique_ptr<TraceRecord[]> records_;
+  // The total number of records appended so far.
+  std::atomic<uint64_t> next_index_{0};
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(ThreadBuffer);
+};
+
+std::atomic<bool> g_enabled{false};
+
+// Slots are claimed once per thread and published after the buffer is
+// created.
+std::atomic<size_t> g_claimed_slots{0};
+std::atomic<ThreadBuffer*> g_buffers[TraceRecorder::kMaxThreads];
+
+// The buffer of the current thread, or -1 if there were no slots left.
+FML_THREAD_LOCAL ThreadLocal tls_buffer;
+
+ThreadBuffer* GetCurrentThreadBuffer() {
+  intptr_t value = tls_buffer.Get();
+  if (value == 0) {
+    const size_t slot = g_claimed_slots.fetch_add(1);
+    if (slot < TraceRecorder::kMaxThreads) {
+      auto* buffer = new ThreadBuffer(slot + 1);
+      g_buffers[slot].store(buffer, std::memory_order_release);
+      value = reinterpret_cast<intptr_t>(buffer);
+    } else {
+      value = -1;
+    }
+    tls_buffer.Set(value);
+  }
+  return value == -1 ? nullptr : reinterpret_cast<ThreadBuffer*>(value);
+}
+
+int64_t NowMicros() {
+  return fxl::TimePoint::Now().ToEpochDelta().ToMicroseconds();
+}
+
+const char* GetPhase(TraceRecord::Type type) {
+  switch (type) {
+    case TraceRecord::Type::kBegin:
+      return "B";
+    case TraceRecord::Type::kEnd:
+      return "E";
+    case TraceRecord::Type::kAsyncBegin:
+      return "b";
+    case TraceRecord::Type::kAsyncEnd:
+      return "e";
+    case TraceRecord::Type::kInstant:
+      return "i";
+    case TraceRecord::Type::kCounter:
+      return "C";
+    case TraceRecord::Type::kFlowBegin:
+      return "s";
+    case TraceRecord::Type::kFlowStep:
+      return "t";
+    case TraceRecord::Type::kFlowEnd:
+      return "f";
+  }
+  return "i";
+}
+
+void AppendEscaped(std::ostringstream* stream, const char* string) {
+  for (const char* c = string; *c != '\0'; c++) {
+    if (*c == '"' || *c == '\\') {
+      *stream << '\\' << *c;
+    } else if (static_cast<unsigned char>(*c) >= 0x20) {
+      *stream << *c;
+    }
+  }
+}
+
+void AppendRecord(std::ostringstream* stream,
+                  size_t thread_id,
+                  const TraceRecord& record) {
+  *stream << "{\"name\":\"";
+  AppendEscaped(stream, record.name);
+  *stream << "\",\"cat\":\"flutter\",\"ph\":\"" << GetPhase(record.type)
+          << "\",\"ts\":" << record.timestamp_micros
+          << ",\"pid\":0,\"tid\":" << thread_id;
+  switch (record.type) {
+    case TraceRecord::Type::kAsyncBegin:
+    case TraceRecord::Type::kAsyncEnd:
+    case TraceRecord::Type::kFlowBegin:
+    case TraceRecord::Type::kFlowStep:
+    case TraceRecord::Type::kFlowEnd:
+      *stream << ",\"id\":" << record.value;
+      break;
+    case TraceRecord::Type::kCounter:
+      *stream << ",\"args\":{\"value\":" << record.value << "}";
+      break;
+    default:
+      break;
+  }
+  *stream << "}";
+}
+
+}  // namespace
+
+constexpr size_t TraceRecorder::kRecordsPerThread;
+constexpr size_t TraceRecorder::kMaxThreads;
+
+void TraceRecorder::SetEnabled(bool enabled) {
+  g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool TraceRecorder::IsEnabled() {
+  return g_enabled.load(std::memory_order_relaxed);
+}
+
+void TraceRecorder::Record(TraceRecord::Type type,
+                           const char* name,
+                           int64_t value) {
+  if (!IsEnabled()) {
+    return;
+  }
+  ThreadBuffer* buffer = GetCurrentThreadBuffer();
+  if (buffer == nullptr) {
+    return;
+  }
+  buffer->Append(type, name, value, NowMicros());
+}
+
+std::string TraceRecorder::DumpRecentEvents(fxl::TimeDelta duration) {
+  const int64_t start_micros = NowMicros() - duration.ToMicroseconds();
+  const size_t slots = std::min(g_claimed_slots.load(), kMaxThreads);
+
+  std::ostringstream stream;
+  stream << "{\"traceEvents\":[";
+  bool first = true;
+  for (size_t slot = 0; slot < slots; slot++) {
+    const ThreadBuffer* buffer =
+        g_buffers[slot].load(std::memory_order_acquire);
+    if (buffer == nullptr) {
+      continue;
+    }
+    for (const TraceRecord& record : buffer->Snapshot()) {
+      if (record.timestamp_micros < start_micros) {
+        continue;
+      }
+      if (!first) {
+        stream << ",";
+      }
+      first = false;
+      AppendRecord(&stream, buffer->thread_id(), record);
+    }
+  }
+  stream << "]}";
+  return stream.str();
+}
+
+}  // namespace tracing
+}  // namespace fml
@@ -0,0 +1,74 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_TRACE_RECORDER_H_
+#define FLUTTER_FML_TRACE_RECORDER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+
+#include "lib/fxl/macros.h"
+#include "lib/fxl/time/time_delta.h"
+
+namespace fml {
+namespace tracing {
+
+// A trace event as kept by the |TraceRecorder|. Names longer than the record
+// allows are truncated.
+struct TraceRecord {
+  enum class Type : uint8_t {
+    kBegin,
+    kEnd,
+    kAsyncBegin,
+    kAsyncEnd,
+    kInstant,
+    kCounter,
+    kFlowBegin,
+    kFlowStep,
+    kFlowEnd,
+  };
+
+  static constexpr size_t kMaxNameLength = 46;
+
+  int64_t timestamp_micros;
+  // The async or flow id, or the counter value.
+  int64_t value;
+  Type type;
+  char name[kMaxNameLength + 1];
+};
+
+static_assert(sizeof(TraceRecord) == 64, "Trace records should stay compact.");
+
+// Keeps the most recent trace events of each thread in a ring buffer of the
+// thread, independently of the Dart timeline, so that they can be written out
+// after a slow frame or a crash. Recording takes no locks and allocates only
+// the first time a thread records, which makes it cheap enough to leave on in
+// release builds. Threads beyond the first |kMaxThreads| do not record.
+class TraceRecorder {
+ public:
+  static constexpr size_t kRecordsPerThread = 4096;
+  static constexpr size_t kMaxThreads = 64;
+
+  static void SetEnabled(bool enabled);
+
+  static bool IsEnabled();
+
+  // Does nothing unless the recorder is enabled.
+  static void Record(TraceRecord::Type type, const char* name, int64_t value);
+
+  // Returns the events of every thread that were recorded in the last
+  // |duration| in the Chrome trace event format (see chrome://tracing). Events
+  // recorded while this runs may be missing.
+  static std::string DumpRecentEvents(fxl::TimeDelta duration);
+
+ private:
+  FXL_DISALLOW_IMPLICIT_CONSTRUCTORS(TraceRecorder);
+};
+
+}  // namespace tracing
+}  // namespace fml
+
+#endif  // FLUTTER_FML_TRACE_RECORDER_H_
@@ -0,0 +1,79 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "gtest/gtest.h"
+
+#include <string>
+
+#include "flutter/fml/thread.h"
+#include "flutter/fml/trace_recorder.h"
+
+using fml::tracing::TraceRecord;
+using fml::tracing::TraceRecorder;
+
+namespace {
+
+const fxl::TimeDelta kDumpDuration = fxl::TimeDelta::FromSeconds(60);
+
+bool Contains(const std::string& dump, const std::string& name) {
+  return dump.find("\"name\":\"" + name + "\"") != std::string::npos;
+}
+
+}  // namespace
+
+TEST(TraceRecorder, RecordsNothingWhileDisabled) {
+  TraceRecorder::SetEnabled(false);
+  TraceRecorder::Record(TraceRecord::Type::kInstant, "disabled", 0);
+  ASSERT_FALSE(Contains(TraceRecorder::DumpRecentEvents(kDumpDuration),
+                        "disabled"));
+}
+
+TEST(TraceRecorder, DumpsEventsOfAllThreads) {
+  TraceRecorder::SetEnabled(true);
+  TraceRecorder::Record(TraceRecord::Type::kBegin, "main_thread", 0);
+  TraceRecorder::Record(TraceRecord::Type::kEnd, "main_thread", 0);
+  {
+    fml::Thread thread;
+    thread.GetTaskRunner()->PostTask([]() {
+      TraceRecorder::Record(TraceRecord::Type::kCounter, "other_thread", 42);
+    });
+  }
+  TraceRecorder::SetEnabled(false);
+
+  const std::string dump = TraceRecorder::DumpRecentEvents(kDumpDuration);
+  ASSERT_TRUE(Contains(dump, "main_thread"));
+  ASSERT_TRUE(Contains(dump, "other_thread"));
+  ASSERT_NE(dump.find("\"args\":{\"value\":42}"), std::string::npos);
+}
+
+TEST(TraceRecorder, KeepsOnlyTheMostRecentEventsOfAThread) {
+  TraceRecorder::SetEnabled(true);
+  {
+    fml::Thread thread;
+    thread.GetTaskRunner()->PostTask([]() {
+      TraceRecorder::Record(TraceRecord::Type::kInstant, "oldest", 0);
+      for (size_t i = 0; i < TraceRecorder::kRecordsPerThread; i++) {
+        TraceRecorder::Record(TraceRecord::Type::kInstant, "filler", 0);
+      }
+      TraceRecorder::Record(TraceRecord::Type::kInstant, "newest", 0);
+    });
+  }
+  TraceRecorder::SetEnabled(false);
+
+  const std::string dump = TraceRecorder::DumpRecentEvents(kDumpDuration);
+  ASSERT_FALSE(Contains(dump, "oldest"));
+  ASSERT_TRUE(Contains(dump, "newest"));
+}
+
+TEST(TraceRecorder, TruncatesLongNames) {
+  TraceRecorder::SetEnabled(true);
+  const std::string name(TraceRecord::kMaxNameLength + 10, 'x');
+  TraceRecorder::Record(TraceRecord::Type::kInstant, name.c_str(), 0);
+  TraceRecorder::SetEnabled(false);
+
+  const std::string dump = TraceRecorder::DumpRecentEvents(kDumpDuration);
+  ASSERT_TRUE(
+      Contains(dump, std::string(TraceRecord::kMaxNameLength, 'x')));
+  ASSERT_FALSE(Contains(dump, name));
+}
@@ -0,0 +1,239 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/worker_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+
+#include "flutter/fml/thread.h"
+#include "flutter/fml/thread_local.h"
+#include "lib/fxl/logging.h"
+
+namespace fml {
+
+// The work queue of the worker the current thread is, if any.
+FML_THREAD_LOCAL ThreadLocal tls_work_queue;
+
+/// A task runner that services tasks from a set of workers. Each worker owns
+/// a queue. Tasks posted from a worker go to its own queue and are taken from
+/// its back, which keeps related work on the same core. Tasks posted from any
+/// other thread are spread over the queues. Workers that run out of work steal
+/// from the front of the queues of the other workers.
+class ConcurrentTaskRunner : public fxl::TaskRunner {
+ public:
+  void PostTask(fxl::Closure task) override {
+    if (terminated_) {
+      return;
+    }
+    auto* local = CurrentWorkQueue();
+    auto* queue = local != nullptr
+                      ? local
+                      : queues_[next_queue_++ % queues_.size()].get();
+    {
+      std::lock_guard<std::mutex> lock(queue->mutex);
+      queue->tasks.emplace_back(std::move(task));
+    }
+    ++pending_count_;
+    WakeOneWorker();
+  }
+
+  void PostTaskForTime(fxl::Closure task, fxl::TimePoint target_time) override {
+    if (target_time <= fxl::TimePoint::Now()) {
+      PostTask(std::move(task));
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (terminated_) {
+        return;
+      }
+      delayed_tasks_.emplace(target_time, std::move(task));
+    }
+    condition_.notify_one();
+  }
+
+  void PostDelayedTask(fxl::Closure task, fxl::TimeDelta delay) override {
+    PostTaskForTime(std::move(task), fxl::TimePoint::Now() + delay);
+  }
+
+  bool RunsTasksOnCurrentThread() override {
+    return CurrentWorkQueue() != nullptr;
+  }
+
+  void Terminate() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      terminated_ = true;
+      delayed_tasks_.clear();
+    }
+    condition_.notify_all();
+  }
+
+  void WorkerMain(size_t index) {
+    auto* queue = queues_[index].get();
+    tls_work_queue.Set(reinterpret_cast<intptr_t>(queue));
+    while (!terminated_) {
+      fxl::Closure task;
+      if (TakeTask(index, &task)) {
+        task();
+        continue;
+      }
+      WaitForWork(queue);
+    }
+    // Drop the tasks that never ran on this thread.
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    queue->tasks.clear();
+  }
+
+ private:
+  struct WorkQueue {
+    const ConcurrentTaskRunner* owner;
+    std::mutex mutex;
+    std::deque<fxl::Closure> tasks;
+
+    explicit WorkQueue(const ConcurrentTaskRunner* p_owner) : owner(p_owner) {}
+  };
+
+  std::vector<std::unique_ptr<WorkQueue>> queues_;
+  std::atomic_size_t next_queue_;
+  // The number of tasks in all work queues.
+  std::atomic_size_t pending_count_;
+  std::atomic_bool terminated_;
+  // Guards |delayed_tasks_| and the sleep of idle workers.
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  // Ordered by target time. Tasks with the same target time are moved to the
+  // work queues in the order they were posted.
+  std::multimap<fxl::TimePoint, fxl::Closure> delayed_tasks_;
+
+  explicit ConcurrentTaskRunner(size_t worker_count)
+      : next_queue_(0), pending_count_(0), terminated_(false) {
+    for (size_t i = 0; i < worker_count; i++) {
+      queues_.emplace_back(std::make_unique<WorkQueue>(this));
+    }
+  }
+
+  ~ConcurrentTaskRunner() override = default;
+
+  WorkQueue* CurrentWorkQueue() const {
+    auto* queue = reinterpret_cast<WorkQueue*>(tls_work_queue.Get());
+    return queue != nullptr && queue->owner == this ? queue : nullptr;
+  }
+
+  void WakeOneWorker() {
+    // Taking the lock orders this wakeup after the check of |pending_count_|
+    // by a worker that is about to sleep.
+    { std::lock_guard<std::mutex> lock(mutex_); }
+    condition_.notify_one();
+  }
+
+  bool TakeTask(size_t index, fxl::Closure* task) {
+    // Newest local work first, while its data is still warm.
+    {
+      auto* own = queues_[index].get();
+      std::lock_guard<std::mutex> lock(own->mutex);
+      if (!own->tasks.empty()) {
+        *task = std::move(own->tasks.back());
+        own->tasks.pop_back();
+        --pending_count_;
+        return true;
+      }
+    }
+    // Then the oldest work of the other workers.
+    for (size_t i = 1; i < queues_.size(); i++) {
+      auto* victim = queues_[(index + i) % queues_.size()].get();
+      std::lock_guard<std::mutex> lock(victim->mutex);
+      if (!victim->tasks.empty()) {
+        *task = std::move(victim->tasks.front());
+        victim->tasks.pop_front();
+        --pending_count_;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void WaitForWork(WorkQueue* queue) {
+    std::vector<fxl::Closure> expired;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      const auto now = fxl::TimePoint::Now();
+      while (!delayed_tasks_.empty() && delayed_tasks_.begin()->first <= now) {
+        expired.emplace_back(std::move(delayed_tasks_.begin()->second));
+        delayed_tasks_.erase(delayed_tasks_.begin());
+      }
+      if (expired.empty()) {
+        if (terminated_ || pending_count_ > 0) {
+          return;
+        }
+        if (delayed_tasks_.empty()) {
+          condition_.wait(lock);
+        } else {
+          condition_.wait_for(
+              lock, std::chrono::nanoseconds(
+                        (delayed_tasks_.begin()->first - now).ToNanoseconds()));
+        }
+        return;
+      }
+    }
+    // Expired delayed tasks become local work of this worker so that other
+    // workers may steal them.
+    {
+      std::lock_guard<std::mutex> lock(queue->mutex);
+      for (auto& task : expired) {
+        queue->tasks.emplace_front(std::move(task));
+      }
+    }
+    pending_count_ += expired.size();
+    if (expired.size() > 1) {
+      condition_.notify_all();
+    }
+  }
+
+  FRIEND_MAKE_REF_COUNTED(ConcurrentTaskRunner);
+  FRIEND_REF_COUNTED_THREAD_SAFE(ConcurrentTaskRunner);
+  FXL_DISALLOW_COPY_AND_ASSIGN(ConcurrentTaskRunner);
+};
+
+static size_t DefaultWorkerCount() {
+  // Leave room for the platform, UI, GPU and IO threads.
+  const size_t processors = std::thread::hardware_concurrency();
+  return std::max<size_t>(processors > 4 ? processors - 4 : 1, 1);
+}
+
+WorkerPool::WorkerPool(const std::string& name, size_t worker_count) {
+  if (worker_count == 0) {
+    worker_count = DefaultWorkerCount();
+  }
+  task_runner_ = fxl::MakeRefCounted<ConcurrentTaskRunner>(worker_count);
+
+  for (size_t i = 0; i < worker_count; i++) {
+    auto runner = task_runner_;
+    const std::string worker_name =
+        name.empty() ? name : name + "." + std::to_string(i + 1);
+    workers_.emplace_back(
+        std::make_unique<std::thread>([runner, worker_name, i]() {
+          Thread::SetCurrentThreadName(worker_name);
+          runner->WorkerMain(i);
+        }));
+  }
+}
+
+WorkerPool::~WorkerPool() {
+  task_runner_->Terminate();
+  for (auto& worker : workers_) {
+    worker->join();
+  }
+}
+
+fxl::RefPtr<fxl::TaskRunner> WorkerPool::GetTaskRunner() const {
+  return task_runner_;
+}
+
+}  // namespace fml
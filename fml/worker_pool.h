@@ -0,0 +1,48 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_WORKER_POOL_H_
+#define FLUTTER_FML_WORKER_POOL_H_
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "lib/fxl/macros.h"
+#include "lib/fxl/tasks/task_runner.h"
+
+namespace fml {
+
+class ConcurrentTaskRunner;
+
+/// A fixed set of threads that service a single task runner. Tasks posted to
+/// the runner may execute concurrently and in any order on any of the
+/// threads. Each worker has its own queue and steals work from the others
+/// once it runs dry, so bursts of tasks posted from one worker still spread
+/// over all of them. Unlike |fml::Thread|, the workers do not have message
+/// loops.
+class WorkerPool {
+ public:
+  /// Creates a pool with |worker_count| threads. A count of zero picks a count
+  /// based on the number of processors.
+  explicit WorkerPool(const std::string& name = "", size_t worker_count = 0);
+
+  /// Joins all workers. Tasks that have not started executing are dropped.
+  ~WorkerPool();
+
+  fxl::RefPtr<fxl::TaskRunner> GetTaskRunner() const;
+
+  size_t worker_count() const { return workers_.size(); }
+
+ private:
+  fxl::RefPtr<ConcurrentTaskRunner> task_runner_;
+  std::vector<std::unique_ptr<std::thread>> workers_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(WorkerPool);
+};
+
+}  // namespace fml
+
+#endif  // FLUTTER_FML_WORKER_POOL_H_
@@ -0,0 +1,99 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "flutter/fml/worker_pool.h"
+#include "lib/fxl/synchronization/waitable_event.h"
+
+TEST(WorkerPool, CanStartAndEnd) {
+  fml::WorkerPool pool("test", 2);
+  ASSERT_TRUE(pool.GetTaskRunner());
+  ASSERT_EQ(pool.worker_count(), 2u);
+}
+
+TEST(WorkerPool, DefaultsToAtLeastOneWorker) {
+  fml::WorkerPool pool;
+  ASSERT_GE(pool.worker_count(), 1u);
+}
+
+TEST(WorkerPool, RunsAllPostedTasks) {
+  fml::WorkerPool pool("test", 4);
+  constexpr int kTaskCount = 100;
+  std::atomic_int count(0);
+  fxl::AutoResetWaitableEvent latch;
+  auto runner = pool.GetTaskRunner();
+  for (int i = 0; i < kTaskCount; i++) {
+    runner->PostTask([&count, &latch]() {
+      if (++count == kTaskCount) {
+        latch.Signal();
+      }
+    });
+  }
+  latch.Wait();
+  ASSERT_EQ(count.load(), kTaskCount);
+}
+
+TEST(WorkerPool, RunsTasksOnCurrentThreadOnlyOnWorkers) {
+  fml::WorkerPool pool("test", 1);
+  auto runner = pool.GetTaskRunner();
+  ASSERT_FALSE(runner->RunsTasksOnCurrentThread());
+  bool on_worker = false;
+  fxl::AutoResetWaitableEvent latch;
+  runner->PostTask([&]() {
+    on_worker = runner->RunsTasksOnCurrentThread();
+    latch.Signal();
+  });
+  latch.Wait();
+  ASSERT_TRUE(on_worker);
+}
+
+TEST(WorkerPool, DelayedTasksRunAfterTheirDelay) {
+  fml::WorkerPool pool("test", 1);
+  fxl::AutoResetWaitableEvent latch;
+  const auto begin = fxl::TimePoint::Now();
+  fxl::TimePoint ran;
+  pool.GetTaskRunner()->PostDelayedTask(
+      [&]() {
+        ran = fxl::TimePoint::Now();
+        latch.Signal();
+      },
+      fxl::TimeDelta::FromMilliseconds(5));
+  latch.Wait();
+  ASSERT_GE((ran - begin).ToMilliseconds(), 5);
+}
+
+TEST(WorkerPool, IdleWorkersStealTasksPostedFromAWorker) {
+  fml::WorkerPool pool("test", 4);
+  auto runner = pool.GetTaskRunner();
+  constexpr int kTaskCount = 4;
+  std::atomic_int running(0);
+  std::atomic_int max_running(0);
+  std::atomic_int done(0);
+  fxl::AutoResetWaitableEvent latch;
+  // All tasks land in the queue of a single worker. They only run
+  // concurrently if the other workers steal them.
+  runner->PostTask([&]() {
+    for (int i = 0; i < kTaskCount; i++) {
+      runner->PostTask([&]() {
+        int now_running = ++running;
+        int expected = max_running.load();
+        while (now_running > expected &&
+               !max_running.compare_exchange_weak(expected, now_running)) {
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        --running;
+        if (++done == kTaskCount) {
+          latch.Signal();
+        }
+      });
+    }
+  });
+  latch.Wait();
+  ASSERT_GT(max_running.load(), 1);
+}
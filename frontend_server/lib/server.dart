@@ -63,6 +63,10 @@ Output:
 <compiler output>
 <boundary-key> [<output.dill>]
 
+After a delta was accepted, the output of recompile only holds the libraries
+that were invalidated or are new since, which the engine loads on top of the
+program it runs.
+
 Options:
 ${_argParser.usage}
 ''';
@@ -101,11 +105,14 @@ abstract class CompilerInterface {
 
 /// Class that for test mocking purposes encapsulates creation of [BinaryPrinter].
 class BinaryPrinterFactory {
-  /// Creates new [BinaryPrinter] to write to [targetSink].
-  BinaryPrinter newBinaryPrinter(IOSink targetSink) {
+  /// Creates new [BinaryPrinter] to write to [targetSink]. When
+  /// `librarySelector` is given, only the libraries it selects are written.
+  BinaryPrinter newBinaryPrinter(IOSink targetSink, {
+    bool librarySelector(Library library),
+  }) {
     return new LimitedBinaryPrinter(
       targetSink,
-      (_) => true /* predicate */,
+      librarySelector ?? (_) => true /* predicate */,
       false /* excludeUriToSource */);  }
 }
 
@@ -122,6 +129,17 @@ class _FrontendCompiler implements CompilerInterface {
   String _filename;
   String _kernelBinaryFilename;
 
+  /// The program of the last compilation.
+  Program _lastProgram;
+
+  /// The import uris of the libraries of the last accepted program, or null
+  /// if the next recompilation has to write a complete kernel file.
+  Set<Uri> _acceptedLibraries;
+
+  /// The sources invalidated since the last accepted delta, as strings so
+  /// that they compare with the file uris of the kernel nodes.
+  final Set<String> _invalidatedSources = new Set<String>();
+
   @override
   Future<Null> compile(String filename, ArgResults options, {
     IncrementalKernelGenerator generator,
@@ -172,6 +190,9 @@ class _FrontendCompiler implements CompilerInterface {
       }
       program = await kernelForProgram(Uri.base.resolve(_filename), compilerOptions);
     }
+    _lastProgram = program;
+    _acceptedLibraries = null;
+    _invalidatedSources.clear();
     if (program != null) {
       final IOSink sink = new File(_kernelBinaryFilename).openWrite();
       final BinaryPrinter printer = printerFactory.newBinaryPrinter(sink);
@@ -188,8 +209,14 @@ class _FrontendCompiler implements CompilerInterface {
     final String boundaryKey = new Uuid().generateV4();
     _outputStream.writeln("result $boundaryKey");
     final DeltaProgram deltaProgram = await _generator.computeDelta();
+    _lastProgram = deltaProgram.newProgram;
     final IOSink sink = new File(_kernelBinaryFilename).openWrite();
-    final BinaryPrinter printer = printerFactory.newBinaryPrinter(sink);
+    // Libraries the engine already runs and whose sources did not change are
+    // left out, so that the size of the kernel file the engine reads on a
+    // reload grows with the change rather than with the program.
+    final BinaryPrinter printer = printerFactory.newBinaryPrinter(sink,
+      librarySelector: _acceptedLibraries != null ? _isChangedLibrary : null,
+    );
     printer.writeProgramFile(deltaProgram.newProgram);
     await sink.close();
     _outputStream.writeln("$boundaryKey $_kernelBinaryFilename");
@@ -199,21 +226,45 @@ class _FrontendCompiler implements CompilerInterface {
   @override
   void acceptLastDelta() {
     _generator.acceptLastDelta();
+    _acceptedLibraries = new Set<Uri>();
+    if (_lastProgram != null) {
+      for (Library library in _lastProgram.libraries)
+        _acceptedLibraries.add(library.importUri);
+    }
+    _invalidatedSources.clear();
   }
 
   @override
   void rejectLastDelta() {
+    // The invalidated sources are kept, as the next delta has to hold them
+    // again.
     _generator.rejectLastDelta();
   }
 
   @override
   void invalidate(Uri uri) {
     _generator.invalidate(uri);
+    _invalidatedSources.add(uri.toString());
   }
 
   @override
   void resetIncrementalCompiler() {
     _generator.reset();
+    _acceptedLibraries = null;
+    _invalidatedSources.clear();
+  }
+
+  /// Whether `library` is new since the last accepted delta or one of its
+  /// files, including its parts, was invalidated.
+  bool _isChangedLibrary(Library library) {
+    if (!_acceptedLibraries.contains(library.importUri))
+      return true;
+    bool isInvalidated(dynamic fileUri) =>
+      _invalidatedSources.contains('$fileUri');
+    return isInvalidated(library.fileUri) ||
+      library.classes.any((Class node) => isInvalidated(node.fileUri)) ||
+      library.procedures.any((Procedure node) => isInvalidated(node.fileUri)) ||
+      library.fields.any((Field node) => isInvalidated(node.fileUri));
   }
 
   Uri _ensureFolderPath(String path) {
@@ -332,6 +332,8 @@ Future<int> main() async {
         new _MockedBinaryPrinterFactory();
       when(printerFactory.newBinaryPrinter(any))
         .thenReturn(new _MockedBinaryPrinter());
+      when(printerFactory.newBinaryPrinter(any, librarySelector: any))
+        .thenReturn(new _MockedBinaryPrinter());
       final int exitcode = await starter(args, compiler: null,
         input: streamController.stream,
         output: ioSink,
@@ -23,6 +23,19 @@ class Scene extends NativeFieldWrapperClass2 {
   void dispose() native "Scene_dispose";
 }
 
+/// An opaque handle to a subtree of a [Scene] that can be added to the scenes
+/// of later frames without being rebuilt.
+///
+/// To create an EngineLayer object, use [SceneBuilder.popRetained].
+class EngineLayer extends NativeFieldWrapperClass2 {
+  /// Creates an uninitialized EngineLayer object.
+  ///
+  /// Calling the EngineLayer constructor directly will not create a useable
+  /// object. To create an EngineLayer object, use
+  /// [SceneBuilder.popRetained].
+  EngineLayer(); // (this constructor is here just so we can document it)
+}
+
 /// Builds a [Scene] containing the given visuals.
 ///
 /// A [Scene] can then be rendered using [Window.render].
@@ -147,6 +160,26 @@ class SceneBuilder extends NativeFieldWrapperClass2 {
   /// stack.
   void pop() native "SceneBuilder_pop";
 
+  /// Ends the effect of the most recently pushed operation, like [pop], and
+  /// returns a handle to the subtree it built.
+  ///
+  /// The subtree can be added to the scenes of later frames with
+  /// [addRetained] instead of pushing and adding its operations again. Its
+  /// rasterization is then unchanged and, with layer tree diffing, it is not
+  /// repainted unless it moves. Returns null if there is no pushed operation.
+  EngineLayer popRetained() native "SceneBuilder_popRetained";
+
+  /// Adds a subtree returned by [popRetained] while building an earlier scene
+  /// as a child of the current operation.
+  ///
+  /// A retained subtree must not be added to the same scene more than once.
+  void addRetained(EngineLayer retainedLayer) {
+    assert(retainedLayer != null);
+    _addRetained(retainedLayer);
+  }
+  void _addRetained(EngineLayer retainedLayer)
+      native "SceneBuilder_addRetained";
+
   /// Adds an object to the scene that displays performance statistics.
   ///
   /// Useful during development to assess the performance of the application.
@@ -158,7 +191,15 @@ class SceneBuilder extends NativeFieldWrapperClass2 {
   ///  - 0x02: visualizeRasterizerStatistics - graph GPU thread frame times
   ///  - 0x04: displayEngineStatistics - show UI thread frame time
   ///  - 0x08: visualizeEngineStatistics - graph UI thread frame times
-  /// Set enabledOptions to 0x0F to enable all the currently defined features.
+  ///  - 0x10: displayMemoryStatistics - show the resident memory of the process
+  ///  - 0x20: visualizeMemoryStatistics - graph the resident memory
+  ///  - 0x40: displayImageMemoryStatistics - show the bytes held by decoded,
+  ///    GPU resident and raster cached images
+  ///  - 0x80: visualizeImageMemoryStatistics - graph the image bytes
+  ///  - 0x100: displayGpuStatistics - show the time the GPU spent on frames,
+  ///    when the engine runs with --enable-gpu-timer-queries
+  ///  - 0x200: visualizeGpuStatistics - graph the GPU frame times
+  /// Set enabledOptions to 0x3FF to enable all the currently defined features.
   ///
   /// The "UI thread" is the thread that includes all the execution of
   /// the main Dart isolate (the isolate that can call
@@ -197,6 +238,19 @@ class SceneBuilder extends NativeFieldWrapperClass2 {
   }
   void _addPicture(double dx, double dy, Picture picture, int hints) native "SceneBuilder_addPicture";
 
+  /// Adds a backend texture to the scene.
+  ///
+  /// The texture is scaled to the given size and rasterized at the given
+  /// offset. The [textureId] is the one the platform returned when it
+  /// registered the texture. Each frame shows the texture's most recent
+  /// contents.
+  void addTexture(int textureId, { Offset offset: Offset.zero, double width: 0.0, double height: 0.0 }) {
+    if (textureId == null)
+      throw new ArgumentError("[textureId] argument cannot be null");
+    _addTexture(offset.dx, offset.dy, width, height, textureId);
+  }
+  void _addTexture(double dx, double dy, double width, double height, int textureId) native "SceneBuilder_addTexture";
+
   /// (Fuchsia-only) Adds a scene rendered by another application to the scene
   /// for this application.
   void addChildScene({
@@ -222,6 +276,13 @@ class SceneBuilder extends NativeFieldWrapperClass2 {
 
   /// Sets a threshold after which additional debugging information should be recorded.
   ///
+  /// Frames that take longer than `frameInterval` frame intervals to rasterize
+  /// are recorded into SkPicture files in the `flutter_slow_frames` directory
+  /// of the temporary directory. The pictures of the last ten such frames are
+  /// kept. With `--enable-trace-recorder`, the trace events of the two seconds
+  /// before each frame are written next to its picture. Pass zero to disable
+  /// this.
+  ///
   /// Currently this interface is difficult to use by end-developers. If you're
   /// interested in using this feature, please contact [flutter-dev](https://groups.google.com/forum/#!forum/flutter-dev).
   /// We'll hopefully be able to figure out how to make this feature more useful
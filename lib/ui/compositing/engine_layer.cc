@@ -0,0 +1,21 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/compositing/engine_layer.h"
+
+namespace blink {
+
+IMPLEMENT_WRAPPERTYPEINFO(ui, EngineLayer);
+
+fxl::RefPtr<EngineLayer> EngineLayer::Create(
+    std::shared_ptr<flow::Layer> layer) {
+  return fxl::MakeRefCounted<EngineLayer>(std::move(layer));
+}
+
+EngineLayer::EngineLayer(std::shared_ptr<flow::Layer> layer)
+    : layer_(std::move(layer)) {}
+
+EngineLayer::~EngineLayer() = default;
+
+}  // namespace blink
@@ -0,0 +1,36 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_COMPOSITING_ENGINE_LAYER_H_
+#define FLUTTER_LIB_UI_COMPOSITING_ENGINE_LAYER_H_
+
+#include <memory>
+
+#include "flutter/flow/layers/layer.h"
+#include "lib/tonic/dart_wrappable.h"
+
+namespace blink {
+
+// A handle to a layer subtree retained by |SceneBuilder.popRetained| for use
+// in the scenes of later frames.
+class EngineLayer : public fxl::RefCountedThreadSafe<EngineLayer>,
+                    public tonic::DartWrappable {
+  DEFINE_WRAPPERTYPEINFO();
+  FRIEND_MAKE_REF_COUNTED(EngineLayer);
+
+ public:
+  ~EngineLayer() override;
+  static fxl::RefPtr<EngineLayer> Create(std::shared_ptr<flow::Layer> layer);
+
+  const std::shared_ptr<flow::Layer>& layer() const { return layer_; }
+
+ private:
+  explicit EngineLayer(std::shared_ptr<flow::Layer> layer);
+
+  std::shared_ptr<flow::Layer> layer_;
+};
+
+}  // namespace blink
+
+#endif  // FLUTTER_LIB_UI_COMPOSITING_ENGINE_LAYER_H_
@@ -46,6 +46,10 @@ void Scene::dispose() {
   ClearDartWrapper();
 }
 
+size_t Scene::GetAllocationSize() {
+  return sizeof(Scene) + (m_layerTree ? m_layerTree->GetMemoryUsage() : 0);
+}
+
 std::unique_ptr<flow::LayerTree> Scene::takeLayerTree() {
   return std::move(m_layerTree);
 }
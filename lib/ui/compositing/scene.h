@@ -34,6 +34,8 @@ class Scene : public fxl::RefCountedThreadSafe<Scene>,
 
   void dispose();
 
+  virtual size_t GetAllocationSize() override;
+
   static void RegisterNatives(tonic::DartLibraryNatives* natives);
 
  private:
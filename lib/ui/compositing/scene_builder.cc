@@ -34,7 +34,10 @@ IMPLEMENT_WRAPPERTYPEINFO(ui, SceneBuilder);
   V(SceneBuilder, pushShaderMask)                   \
   V(SceneBuilder, pushPhysicalModel)                \
   V(SceneBuilder, pop)                              \
+  V(SceneBuilder, popRetained)                      \
+  V(SceneBuilder, addRetained)                      \
   V(SceneBuilder, addPicture)                       \
+  V(SceneBuilder, addTexture)                       \
   V(SceneBuilder, addChildScene)                    \
   V(SceneBuilder, addPerformanceOverlay)            \
   V(SceneBuilder, setRasterizerTracingThreshold)    \
@@ -83,7 +86,7 @@ void SceneBuilder::pushColorFilter(int color, int blendMode) {
 }
 
 void SceneBuilder::pushBackdropFilter(ImageFilter* filter) {
-  layer_builder_->PushBackdropFilter(filter->filter());
+  layer_builder_->PushBackdropFilter(filter->filter(), filter->blur_sigma());
 }
 
 void SceneBuilder::pushShaderMask(Shader* shader,
@@ -113,6 +116,19 @@ void SceneBuilder::pop() {
   layer_builder_->Pop();
 }
 
+fxl::RefPtr<EngineLayer> SceneBuilder::popRetained() {
+  std::shared_ptr<flow::Layer> layer = layer_builder_->PopRetained();
+  if (!layer)
+    return nullptr;
+  return EngineLayer::Create(std::move(layer));
+}
+
+void SceneBuilder::addRetained(EngineLayer* retainedLayer) {
+  if (!retainedLayer)
+    return;
+  layer_builder_->PushRetained(retainedLayer->layer());
+}
+
 void SceneBuilder::addPicture(double dx,
                               double dy,
                               Picture* picture,
@@ -124,6 +140,15 @@ void SceneBuilder::addPicture(double dx,
   );
 }
 
+void SceneBuilder::addTexture(double dx,
+                              double dy,
+                              double width,
+                              double height,
+                              int64_t textureId) {
+  layer_builder_->PushTexture(SkPoint::Make(dx, dy),
+                              SkSize::Make(width, height), textureId);
+}
+
 void SceneBuilder::addChildScene(double dx,
                                  double dy,
                                  double width,
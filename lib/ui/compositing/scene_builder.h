@@ -10,6 +10,7 @@
 #include <stack>
 
 #include "flutter/flow/layers/layer_builder.h"
+#include "flutter/lib/ui/compositing/engine_layer.h"
 #include "flutter/lib/ui/compositing/scene.h"
 #include "flutter/lib/ui/compositing/scene_host.h"
 #include "flutter/lib/ui/painting/image_filter.h"
@@ -50,6 +51,8 @@ class SceneBuilder : public fxl::RefCountedThreadSafe<SceneBuilder>,
   void pushPhysicalModel(const RRect& rrect, double elevation, int color);
 
   void pop();
+  fxl::RefPtr<EngineLayer> popRetained();
+  void addRetained(EngineLayer* retainedLayer);
 
   void addPerformanceOverlay(uint64_t enabledOptions,
                              double left,
@@ -57,6 +60,11 @@ class SceneBuilder : public fxl::RefCountedThreadSafe<SceneBuilder>,
                              double top,
                              double bottom);
   void addPicture(double dx, double dy, Picture* picture, int hints);
+  void addTexture(double dx,
+                  double dy,
+                  double width,
+                  double height,
+                  int64_t textureId);
   void addChildScene(double dx,
                      double dy,
                      double width,
@@ -4,10 +4,13 @@
 
 #include "flutter/lib/ui/dart_ui.h"
 
+#include <mutex>
+
 #include "flutter/lib/ui/compositing/scene.h"
 #include "flutter/lib/ui/compositing/scene_builder.h"
 #include "flutter/lib/ui/dart_runtime_hooks.h"
 #include "flutter/lib/ui/painting/canvas.h"
+#include "flutter/lib/ui/painting/codec.h"
 #include "flutter/lib/ui/painting/gradient.h"
 #include "flutter/lib/ui/painting/image.h"
 #include "flutter/lib/ui/painting/image_decoding.h"
@@ -34,25 +37,18 @@ namespace {
 
 static tonic::DartLibraryNatives* g_natives;
 
-Dart_NativeFunction GetNativeFunction(Dart_Handle name,
-                                      int argument_count,
-                                      bool* auto_setup_scope) {
-  return g_natives->GetNativeFunction(name, argument_count, auto_setup_scope);
-}
-
-const uint8_t* GetSymbol(Dart_NativeFunction native_function) {
-  return g_natives->GetSymbol(native_function);
-}
-
-}  // namespace
-
-void DartUI::InitForGlobal() {
-  if (!g_natives) {
+// Registering the natives of every dart:ui class takes a while and isolates
+// that never call into dart:ui do not need them, so the table is built by the
+// first lookup. Lookups can come from any isolate's thread.
+tonic::DartLibraryNatives* GetNatives() {
+  static std::once_flag once;
+  std::call_once(once, []() {
     g_natives = new tonic::DartLibraryNatives();
     Canvas::RegisterNatives(g_natives);
     CanvasGradient::RegisterNatives(g_natives);
     CanvasImage::RegisterNatives(g_natives);
     CanvasPath::RegisterNatives(g_natives);
+    Codec::RegisterNatives(g_natives);
     DartRuntimeHooks::RegisterNatives(g_natives);
     ImageDecoding::RegisterNatives(g_natives);
     ImageFilter::RegisterNatives(g_natives);
@@ -69,11 +65,24 @@ void DartUI::InitForGlobal() {
     SemanticsUpdateBuilder::RegisterNatives(g_natives);
     Vertices::RegisterNatives(g_natives);
     Window::RegisterNatives(g_natives);
-  }
+  });
+  return g_natives;
 }
 
+Dart_NativeFunction GetNativeFunction(Dart_Handle name,
+                                      int argument_count,
+                                      bool* auto_setup_scope) {
+  return GetNatives()->GetNativeFunction(name, argument_count,
+                                         auto_setup_scope);
+}
+
+const uint8_t* GetSymbol(Dart_NativeFunction native_function) {
+  return GetNatives()->GetSymbol(native_function);
+}
+
+}  // namespace
+
 void DartUI::InitForIsolate() {
-  FXL_DCHECK(g_natives);
   DART_CHECK_VALID(Dart_SetNativeResolver(Dart_LookupLibrary(ToDart("dart:ui")),
                                           GetNativeFunction, GetSymbol));
 }
@@ -11,7 +11,8 @@ namespace blink {
 
 class DartUI {
  public:
-  static void InitForGlobal();
+  // Installs the resolver of the dart:ui natives. The natives themselves are
+  // registered by the first lookup in the process.
   static void InitForIsolate();
 
  private:
@@ -68,6 +68,54 @@ void _dispatchPlatformMessage(String name, ByteData data, int responseId) {
   }
 }
 
+// Called with [name, responseId, decoded, payload] by the port of
+// Window.onJsonPlatformMessage. See PostJsonPlatformMessage in
+// json_platform_message.cc.
+void _dispatchJsonPlatformMessage(List<dynamic> message) {
+  final String name = message[0];
+  final int responseId = message[1];
+  final bool decoded = message[2];
+  if (!decoded) {
+    final Uint8List bytes = message[3];
+    _dispatchPlatformMessage(
+      name,
+      bytes?.buffer?.asByteData(bytes.offsetInBytes, bytes.lengthInBytes),
+      responseId,
+    );
+    return;
+  }
+  if (window.onJsonPlatformMessage != null) {
+    _invoke3<String, dynamic, PlatformMessageResponseCallback>(
+      window.onJsonPlatformMessage,
+      window._onJsonPlatformMessageZone,
+      name,
+      _unpackJsonValue(message[3]),
+      (ByteData responseData) {
+        window._respondToPlatformMessage(responseId, responseData);
+      },
+    );
+  } else {
+    window._respondToPlatformMessage(responseId, null);
+  }
+}
+
+// JSON objects arrive as lists of their keys and values that start with an
+// empty Uint8List.
+dynamic _unpackJsonValue(dynamic value) {
+  if (value is! List)
+    return value;
+  final List<dynamic> list = value;
+  if (list.isNotEmpty && list[0] is Uint8List) {
+    final Map<String, dynamic> map = <String, dynamic>{};
+    for (int i = 1; i < list.length; i += 2)
+      map[list[i]] = _unpackJsonValue(list[i + 1]);
+    return map;
+  }
+  for (int i = 0; i < list.length; i++)
+    list[i] = _unpackJsonValue(list[i]);
+  return list;
+}
+
 void _dispatchPointerDataPacket(ByteData packet) {
   if (window.onPointerDataPacket != null)
     _invoke1<PointerDataPacket>(window.onPointerDataPacket, window._onPointerDataPacketZone, _unpackPointerDataPacket(packet));
@@ -90,6 +138,11 @@ void _drawFrame() {
   _invoke(window.onDrawFrame, window._onDrawFrameZone);
 }
 
+void _reportTimings(ByteData timings) {
+  if (window.onReportTimings != null)
+    _invoke1<List<FrameTiming>>(window.onReportTimings, window._onReportTimingsZone, _unpackFrameTimings(timings));
+}
+
 /// Invokes [callback] inside the given [zone].
 void _invoke(void callback(), Zone zone) {
   if (callback == null)
@@ -187,3 +240,23 @@ PointerDataPacket _unpackPointerDataPacket(ByteData packet) {
   }
   return new PointerDataPacket(data: data);
 }
+
+// The frame number followed by one timestamp per [FramePhase].
+const int _kFrameTimingFieldCount = 8;
+
+List<FrameTiming> _unpackFrameTimings(ByteData timings) {
+  const int kStride = Int64List.BYTES_PER_ELEMENT;
+  const int kBytesPerFrameTiming = _kFrameTimingFieldCount * kStride;
+  final int length = timings.lengthInBytes ~/ kBytesPerFrameTiming;
+  assert(length * kBytesPerFrameTiming == timings.lengthInBytes);
+  final List<FrameTiming> result = new List<FrameTiming>(length);
+  for (int i = 0; i < length; ++i) {
+    int offset = i * _kFrameTimingFieldCount;
+    final int frameNumber = timings.getInt64(kStride * offset++, _kFakeHostEndian);
+    final List<int> timestamps = new List<int>(_kFrameTimingFieldCount - 1);
+    for (int j = 0; j < timestamps.length; ++j)
+      timestamps[j] = timings.getInt64(kStride * offset++, _kFakeHostEndian);
+    result[i] = new FrameTiming._(frameNumber, timestamps);
+  }
+  return result;
+}
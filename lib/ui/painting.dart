@@ -734,9 +734,82 @@ abstract class Image extends NativeFieldWrapperClass2 {
 typedef void ImageDecoderCallback(Image result);
 
 /// Convert an image file from a byte array into an [Image] object.
-void decodeImageFromList(Uint8List list, ImageDecoderCallback callback)
+///
+/// If [targetWidth] or [targetHeight] are given, the image is decoded at the
+/// smallest size the decoder supports that still covers them, scaled down to
+/// cover them exactly, keeping its aspect ratio. Images are never scaled up.
+///
+/// If [generateMipmaps] is true, the mipmaps of the image are built when it
+/// is uploaded on the IO thread rather than on the GPU thread when it is
+/// first drawn scaled down with [FilterQuality.medium] or higher.
+void decodeImageFromList(Uint8List list, ImageDecoderCallback callback,
+    {int targetWidth, int targetHeight, bool generateMipmaps: false}) {
+  _decodeImageFromList(list, callback, targetWidth ?? 0, targetHeight ?? 0,
+      generateMipmaps ?? false);
+}
+void _decodeImageFromList(Uint8List list, ImageDecoderCallback callback,
+    int targetWidth, int targetHeight, bool generateMipmaps)
     native "decodeImageFromList";
 
+/// One frame of an image decoded by a [Codec].
+class FrameInfo {
+  FrameInfo._(this.image, this.duration);
+
+  /// How long this frame should be shown before the next one.
+  ///
+  /// Zero for images that are not animated.
+  final Duration duration;
+
+  /// The frame's pixels.
+  final Image image;
+}
+
+/// Decodes the frames of a possibly animated image, such as a GIF or WebP,
+/// as they are requested.
+///
+/// Only a frame or so is decoded ahead of the ones requested, so the memory
+/// used does not depend on how many frames the image has.
+///
+/// To obtain a Codec object, use [instantiateImageCodec].
+abstract class Codec extends NativeFieldWrapperClass2 {
+  /// The number of frames in the image.
+  int get frameCount native "Codec_frameCount";
+
+  /// The number of times the animation repeats after it first plays through.
+  ///
+  /// -1 means forever. Zero means the animation plays once.
+  int get repetitionCount native "Codec_repetitionCount";
+
+  /// Decodes the next frame. After the last frame, the first one is decoded
+  /// again.
+  ///
+  /// Frames are returned in the order they were requested. The future
+  /// completes with null if the frame could not be decoded.
+  Future<FrameInfo> getNextFrame() {
+    final Completer<FrameInfo> completer = new Completer<FrameInfo>();
+    _getNextFrame((Image image, int durationMillis) {
+      completer.complete(image == null ? null : new FrameInfo._(
+          image, new Duration(milliseconds: durationMillis)));
+    });
+    return completer.future;
+  }
+  void _getNextFrame(void callback(Image image, int durationMillis)) native "Codec_getNextFrame";
+
+  /// Release the resources used by this object. The object is no longer usable
+  /// after this method is called.
+  void dispose() native "Codec_dispose";
+}
+
+/// Creates a [Codec] for the image file in the given byte array.
+///
+/// The future completes with null if the data is not a supported image.
+Future<Codec> instantiateImageCodec(Uint8List list) {
+  final Completer<Codec> completer = new Completer<Codec>();
+  _instantiateImageCodec(list, (Codec codec) => completer.complete(codec));
+  return completer.future;
+}
+void _instantiateImageCodec(Uint8List list, void callback(Codec codec)) native "instantiateImageCodec";
+
 /// Determines the winding rule that decides how the interior of a [Path] is
 /// calculated.
 ///
@@ -1017,8 +1090,22 @@ class Path extends NativeFieldWrapperClass2 {
   }
   bool _contains(double x, double y) native "Path_contains";
 
+  /// Computes the bounding rectangle for this path.
+  ///
+  /// The bounds are those of the points of the path, including the control
+  /// points of curves, so they may be larger than the area the path covers.
+  /// They are cached by the engine until the path changes.
+  Rect getBounds() {
+    final Float32List rect = _getBounds();
+    return new Rect.fromLTRB(rect[0], rect[1], rect[2], rect[3]);
+  }
+  Float32List _getBounds() native "Path_getBounds";
+
   /// Returns a copy of the path with all the segments of every
   /// subpath translated by the given offset.
+  ///
+  /// Shifting an unchanged path by the same offset again is cheap, and lets
+  /// the engine reuse the work it did to draw the previous copy.
   Path shift(Offset offset) {
     assert(_offsetIsValid(offset));
     return _shift(offset.dx, offset.dy);
@@ -1027,6 +1114,9 @@ class Path extends NativeFieldWrapperClass2 {
 
   /// Returns a copy of the path with all the segments of every
   /// subpath transformed by the given matrix.
+  ///
+  /// Transforming an unchanged path by the same matrix again is cheap, and
+  /// lets the engine reuse the work it did to draw the previous copy.
   Path transform(Float64List matrix4) {
     assert(matrix4 != null);
     if (matrix4.length != 16)
@@ -1394,7 +1484,11 @@ class Vertices extends NativeFieldWrapperClass2 {
     Float32List encodedTextureCoordinates = (textureCoordinates != null) ?
       _encodePointList(textureCoordinates) : null;
     Int32List encodedColors = colors != null ? _encodeColorList(colors) : null;
-    Int32List encodedIndices = indices != null ? new Int32List.fromList(indices) : null;
+    Int32List encodedIndices;
+    if (indices is Int32List)
+      encodedIndices = indices;
+    else if (indices != null)
+      encodedIndices = new Int32List.fromList(indices);
 
     _constructor();
     _init(mode.index, encodedPositions, encodedTextureCoordinates, encodedColors, encodedIndices);
@@ -1508,6 +1602,7 @@ class Canvas extends NativeFieldWrapperClass2 {
       throw new ArgumentError('"recorder" must not already be associated with another Canvas.');
     assert(cullRect != null);
     _constructor(recorder, cullRect.left, cullRect.top, cullRect.right, cullRect.bottom);
+    recorder._canvas = this;
   }
   void _constructor(PictureRecorder recorder,
                     double left,
@@ -1515,6 +1610,74 @@ class Canvas extends NativeFieldWrapperClass2 {
                     double right,
                     double bottom) native "Canvas_constructor";
 
+  // Simple commands whose paints have no objects are batched in _commands and
+  // performed by the engine in a single native call. Every other command
+  // replays the batched ones first, so that the order is kept.
+  //
+  // Each command is an opcode followed by its arguments, one 32 bit word
+  // each, and by the encoded paint data where the command draws. The format
+  // must match the replay code in canvas.cc.
+  ByteData _commands;
+  int _commandsLength = 0;
+  static const int _kSaveOp = 0;
+  static const int _kRestoreOp = 1;
+  static const int _kTranslateOp = 2;
+  static const int _kScaleOp = 3;
+  static const int _kRotateOp = 4;
+  static const int _kClipRectOp = 5;
+  static const int _kDrawColorOp = 6;
+  static const int _kDrawLineOp = 7;
+  static const int _kDrawPaintOp = 8;
+  static const int _kDrawRectOp = 9;
+  static const int _kDrawOvalOp = 10;
+  static const int _kDrawCircleOp = 11;
+  static const int _kPaintWordCount = Paint._kDataByteCount >> 2;
+
+  static const int _kInitialCommandsByteCount = 1024;
+  // Once the buffer has grown to this size, it is replayed when full instead.
+  static const int _kMaxCommandsByteCount = 16384;
+
+  void _beginCommand(int op, int argumentWordCount) {
+    final int byteCount = (argumentWordCount + 1) << 2;
+    if (_commands == null) {
+      _commands = new ByteData(_kInitialCommandsByteCount);
+    } else if (_commandsLength + byteCount > _commands.lengthInBytes) {
+      if (_commands.lengthInBytes >= _kMaxCommandsByteCount) {
+        _flush();
+      } else {
+        final ByteData grown = new ByteData(_commands.lengthInBytes * 2);
+        new Uint8List.view(grown.buffer).setRange(
+            0, _commandsLength, new Uint8List.view(_commands.buffer));
+        _commands = grown;
+      }
+    }
+    _addInt(op);
+  }
+
+  void _addInt(int value) {
+    _commands.setInt32(_commandsLength, value, _kFakeHostEndian);
+    _commandsLength += 4;
+  }
+
+  void _addFloat(double value) {
+    _commands.setFloat32(_commandsLength, value, _kFakeHostEndian);
+    _commandsLength += 4;
+  }
+
+  void _addPaint(Paint paint) {
+    new Uint8List.view(_commands.buffer, _commandsLength, Paint._kDataByteCount)
+        .setAll(0, new Uint8List.view(paint._data.buffer));
+    _commandsLength += Paint._kDataByteCount;
+  }
+
+  void _flush() {
+    if (_commandsLength == 0)
+      return;
+    _replay(new Int32List.view(_commands.buffer, 0, _commandsLength >> 2));
+    _commandsLength = 0;
+  }
+  void _replay(Int32List commands) native "Canvas_replay";
+
   /// Saves a copy of the current transform and clip on the save stack.
   ///
   /// Call [restore] to pop the save stack.
@@ -1523,7 +1686,9 @@ class Canvas extends NativeFieldWrapperClass2 {
   ///
   ///  * [saveLayer], which does the same thing but additionally also groups the
   ///    commands done until the matching [restore].
-  void save() native "Canvas_save";
+  void save() {
+    _beginCommand(_kSaveOp, 0);
+  }
 
   /// Saves a copy of the current transform and clip on the save stack, and then
   /// creates a new group which subsequent calls will become a part of. When the
@@ -1635,6 +1800,7 @@ class Canvas extends NativeFieldWrapperClass2 {
   void saveLayer(Rect bounds, Paint paint) {
     assert(_rectIsValid(bounds));
     assert(paint != null);
+    _flush();
     if (bounds == null) {
       _saveLayerWithoutBounds(paint._objects, paint._data);
     } else {
@@ -1658,7 +1824,9 @@ class Canvas extends NativeFieldWrapperClass2 {
   ///
   /// If the state was pushed with with [saveLayer], then this call will also
   /// cause the new layer to be composited into the previous layer.
-  void restore() native "Canvas_restore";
+  void restore() {
+    _beginCommand(_kRestoreOp, 0);
+  }
 
   /// Returns the number of items on the save stack, including the
   /// initial state. This means it returns 1 for a clean canvas, and
@@ -1666,25 +1834,44 @@ class Canvas extends NativeFieldWrapperClass2 {
   /// each matching call to [restore] decrements it.
   ///
   /// This number cannot go below 1.
-  int getSaveCount() native "Canvas_getSaveCount";
+  int getSaveCount() {
+    _flush();
+    return _getSaveCount();
+  }
+  int _getSaveCount() native "Canvas_getSaveCount";
 
   /// Add a translation to the current transform, shifting the coordinate space
   /// horizontally by the first argument and vertically by the second argument.
-  void translate(double dx, double dy) native "Canvas_translate";
+  void translate(double dx, double dy) {
+    _beginCommand(_kTranslateOp, 2);
+    _addFloat(dx);
+    _addFloat(dy);
+  }
 
   /// Add an axis-aligned scale to the current transform, scaling by the first
   /// argument in the horizontal direction and the second in the vertical
   /// direction.
-  void scale(double sx, double sy) native "Canvas_scale";
+  void scale(double sx, double sy) {
+    _beginCommand(_kScaleOp, 2);
+    _addFloat(sx);
+    _addFloat(sy);
+  }
 
   /// Add a rotation to the current transform. The argument is in radians clockwise.
-  void rotate(double radians) native "Canvas_rotate";
+  void rotate(double radians) {
+    _beginCommand(_kRotateOp, 1);
+    _addFloat(radians);
+  }
 
   /// Add an axis-aligned skew to the current transform, with the first argument
   /// being the horizontal skew in radians clockwise around the origin, and the
   /// second argument being the vertical skew in radians clockwise around the
   /// origin.
-  void skew(double sx, double sy) native "Canvas_skew";
+  void skew(double sx, double sy) {
+    _flush();
+    _skew(sx, sy);
+  }
+  void _skew(double sx, double sy) native "Canvas_skew";
 
   /// Multiply the current transform by the specified 4⨉4 transformation matrix
   /// specified as a list of values in column-major order.
@@ -1692,6 +1879,7 @@ class Canvas extends NativeFieldWrapperClass2 {
     assert(matrix4 != null);
     if (matrix4.length != 16)
       throw new ArgumentError('"matrix4" must have 16 entries.');
+    _flush();
     _transform(matrix4);
   }
   void _transform(Float64List matrix4) native "Canvas_transform";
@@ -1710,13 +1898,13 @@ class Canvas extends NativeFieldWrapperClass2 {
   void clipRect(Rect rect, { ClipOp clipOp: ClipOp.intersect }) {
     assert(_rectIsValid(rect));
     assert(clipOp != null);
-    _clipRect(rect.left, rect.top, rect.right, rect.bottom, clipOp.index);
+    _beginCommand(_kClipRectOp, 5);
+    _addFloat(rect.left);
+    _addFloat(rect.top);
+    _addFloat(rect.right);
+    _addFloat(rect.bottom);
+    _addInt(clipOp.index);
   }
-  void _clipRect(double left,
-                 double top,
-                 double right,
-                 double bottom,
-                 int clipOp) native "Canvas_clipRect";
 
   /// Reduces the clip region to the intersection of the current clip and the
   /// given rounded rectangle.
@@ -1727,6 +1915,7 @@ class Canvas extends NativeFieldWrapperClass2 {
   /// of how to address that and some examples of using [clipRRect].
   void clipRRect(RRect rrect) {
     assert(_rrectIsValid(rrect));
+    _flush();
     _clipRRect(rrect._value);
   }
   void _clipRRect(Float32List rrect) native "Canvas_clipRRect";
@@ -1740,6 +1929,7 @@ class Canvas extends NativeFieldWrapperClass2 {
   /// of how to address that.
   void clipPath(Path path) {
     assert(path != null); // path is checked on the engine side
+    _flush();
     _clipPath(path);
   }
   void _clipPath(Path path) native "Canvas_clipPath";
@@ -1750,9 +1940,11 @@ class Canvas extends NativeFieldWrapperClass2 {
   void drawColor(Color color, BlendMode blendMode) {
     assert(color != null);
     assert(blendMode != null);
-    _drawColor(color.value, blendMode.index);
+    _beginCommand(_kDrawColorOp, 2);
+    _commands.setUint32(_commandsLength, color.value, _kFakeHostEndian);
+    _commandsLength += 4;
+    _addInt(blendMode.index);
   }
-  void _drawColor(int color, int blendMode) native "Canvas_drawColor";
 
   /// Draws a line between the given points using the given paint. The line is
   /// stroked, the value of the [Paint.style] is ignored for this call.
@@ -1762,7 +1954,17 @@ class Canvas extends NativeFieldWrapperClass2 {
     assert(_offsetIsValid(p1));
     assert(_offsetIsValid(p2));
     assert(paint != null);
-    _drawLine(p1.dx, p1.dy, p2.dx, p2.dy, paint._objects, paint._data);
+    if (paint._objects != null) {
+      _flush();
+      _drawLine(p1.dx, p1.dy, p2.dx, p2.dy, paint._objects, paint._data);
+      return;
+    }
+    _beginCommand(_kDrawLineOp, 4 + _kPaintWordCount);
+    _addFloat(p1.dx);
+    _addFloat(p1.dy);
+    _addFloat(p2.dx);
+    _addFloat(p2.dy);
+    _addPaint(paint);
   }
   void _drawLine(double x1,
                  double y1,
@@ -1777,7 +1979,13 @@ class Canvas extends NativeFieldWrapperClass2 {
   /// [drawColor] instead.
   void drawPaint(Paint paint) {
     assert(paint != null);
-    _drawPaint(paint._objects, paint._data);
+    if (paint._objects != null) {
+      _flush();
+      _drawPaint(paint._objects, paint._data);
+      return;
+    }
+    _beginCommand(_kDrawPaintOp, _kPaintWordCount);
+    _addPaint(paint);
   }
   void _drawPaint(List<dynamic> paintObjects, ByteData paintData) native "Canvas_drawPaint";
 
@@ -1786,8 +1994,18 @@ class Canvas extends NativeFieldWrapperClass2 {
   void drawRect(Rect rect, Paint paint) {
     assert(_rectIsValid(rect));
     assert(paint != null);
-    _drawRect(rect.left, rect.top, rect.right, rect.bottom,
-              paint._objects, paint._data);
+    if (paint._objects != null) {
+      _flush();
+      _drawRect(rect.left, rect.top, rect.right, rect.bottom,
+                paint._objects, paint._data);
+      return;
+    }
+    _beginCommand(_kDrawRectOp, 4 + _kPaintWordCount);
+    _addFloat(rect.left);
+    _addFloat(rect.top);
+    _addFloat(rect.right);
+    _addFloat(rect.bottom);
+    _addPaint(paint);
   }
   void _drawRect(double left,
                  double top,
@@ -1801,6 +2019,7 @@ class Canvas extends NativeFieldWrapperClass2 {
   void drawRRect(RRect rrect, Paint paint) {
     assert(_rrectIsValid(rrect));
     assert(paint != null);
+    _flush();
     _drawRRect(rrect._value, paint._objects, paint._data);
   }
   void _drawRRect(Float32List rrect,
@@ -1816,6 +2035,7 @@ class Canvas extends NativeFieldWrapperClass2 {
     assert(_rrectIsValid(outer));
     assert(_rrectIsValid(inner));
     assert(paint != null);
+    _flush();
     _drawDRRect(outer._value, inner._value, paint._objects, paint._data);
   }
   void _drawDRRect(Float32List outer,
@@ -1829,8 +2049,18 @@ class Canvas extends NativeFieldWrapperClass2 {
   void drawOval(Rect rect, Paint paint) {
     assert(_rectIsValid(rect));
     assert(paint != null);
-    _drawOval(rect.left, rect.top, rect.right, rect.bottom,
-              paint._objects, paint._data);
+    if (paint._objects != null) {
+      _flush();
+      _drawOval(rect.left, rect.top, rect.right, rect.bottom,
+                paint._objects, paint._data);
+      return;
+    }
+    _beginCommand(_kDrawOvalOp, 4 + _kPaintWordCount);
+    _addFloat(rect.left);
+    _addFloat(rect.top);
+    _addFloat(rect.right);
+    _addFloat(rect.bottom);
+    _addPaint(paint);
   }
   void _drawOval(double left,
                  double top,
@@ -1846,7 +2076,16 @@ class Canvas extends NativeFieldWrapperClass2 {
   void drawCircle(Offset c, double radius, Paint paint) {
     assert(_offsetIsValid(c));
     assert(paint != null);
-    _drawCircle(c.dx, c.dy, radius, paint._objects, paint._data);
+    if (paint._objects != null) {
+      _flush();
+      _drawCircle(c.dx, c.dy, radius, paint._objects, paint._data);
+      return;
+    }
+    _beginCommand(_kDrawCircleOp, 3 + _kPaintWordCount);
+    _addFloat(c.dx);
+    _addFloat(c.dy);
+    _addFloat(radius);
+    _addPaint(paint);
   }
   void _drawCircle(double x,
                    double y,
@@ -1867,6 +2106,7 @@ class Canvas extends NativeFieldWrapperClass2 {
   void drawArc(Rect rect, double startAngle, double sweepAngle, bool useCenter, Paint paint) {
     assert(_rectIsValid(rect));
     assert(paint != null);
+    _flush();
     _drawArc(rect.left, rect.top, rect.right, rect.bottom, startAngle,
              sweepAngle, useCenter, paint._objects, paint._data);
   }
@@ -1886,6 +2126,7 @@ class Canvas extends NativeFieldWrapperClass2 {
   void drawPath(Path path, Paint paint) {
     assert(path != null); // path is checked on the engine side
     assert(paint != null);
+    _flush();
     _drawPath(path, paint._objects, paint._data);
   }
   void _drawPath(Path path,
@@ -1898,6 +2139,7 @@ class Canvas extends NativeFieldWrapperClass2 {
     assert(image != null); // image is checked on the engine side
     assert(_offsetIsValid(p));
     assert(paint != null);
+    _flush();
     _drawImage(image, p.dx, p.dy, paint._objects, paint._data);
   }
   void _drawImage(Image image,
@@ -1920,6 +2162,7 @@ class Canvas extends NativeFieldWrapperClass2 {
     assert(_rectIsValid(src));
     assert(_rectIsValid(dst));
     assert(paint != null);
+    _flush();
     _drawImageRect(image,
                    src.left,
                    src.top,
@@ -1962,6 +2205,7 @@ class Canvas extends NativeFieldWrapperClass2 {
     assert(_rectIsValid(center));
     assert(_rectIsValid(dst));
     assert(paint != null);
+    _flush();
     _drawImageNine(image,
                    center.left,
                    center.top,
@@ -1990,6 +2234,7 @@ class Canvas extends NativeFieldWrapperClass2 {
   /// [PictureRecorder].
   void drawPicture(Picture picture) {
     assert(picture != null); // picture is checked on the engine side
+    _flush();
     _drawPicture(picture);
   }
   void _drawPicture(Picture picture) native "Canvas_drawPicture";
@@ -2017,6 +2262,7 @@ class Canvas extends NativeFieldWrapperClass2 {
   void drawParagraph(Paragraph paragraph, Offset offset) {
     assert(paragraph != null);
     assert(_offsetIsValid(offset));
+    _flush();
     paragraph._paint(this, offset.dx, offset.dy);
   }
 
@@ -2032,6 +2278,7 @@ class Canvas extends NativeFieldWrapperClass2 {
     assert(pointMode != null);
     assert(points != null);
     assert(paint != null);
+    _flush();
     _drawPoints(paint._objects, paint._data, pointMode.index, _encodePointList(points));
   }
 
@@ -2050,6 +2297,7 @@ class Canvas extends NativeFieldWrapperClass2 {
     assert(paint != null);
     if (points.length % 2 != 0)
       throw new ArgumentError('"points" must have an even number of values.');
+    _flush();
     _drawPoints(paint._objects, paint._data, pointMode.index, points);
   }
 
@@ -2058,10 +2306,84 @@ class Canvas extends NativeFieldWrapperClass2 {
                    int pointMode,
                    Float32List points) native "Canvas_drawPoints";
 
+  /// Draws many axis-aligned rectangles with the given [Paint] in a single
+  /// call.
+  ///
+  /// The `rects` argument is interpreted as a list of four-tuples, with each
+  /// tuple being ([Rect.left], [Rect.top], [Rect.right], [Rect.bottom]).
+  ///
+  /// The `colors` argument, which can be null, is interpreted as a list of
+  /// 32-bit colors, with the same packing as [Color.value]. Each rectangle is
+  /// drawn with its color in place of [Paint.color].
+  void drawRects(Float32List rects, Paint paint, { Int32List colors }) {
+    assert(rects != null);
+    assert(paint != null);
+    if (rects.length % 4 != 0)
+      throw new ArgumentError('"rects" length must be a multiple of four.');
+    if (colors != null && colors.length * 4 != rects.length)
+      throw new ArgumentError('If non-null, "colors" length must be one fourth the length of "rects".');
+    _flush();
+    _drawRects(paint._objects, paint._data, rects, colors);
+  }
+  void _drawRects(List<dynamic> paintObjects,
+                  ByteData paintData,
+                  Float32List rects,
+                  Int32List colors) native "Canvas_drawRects";
+
+  /// Draws many rounded rectangles with the given [Paint] in a single call.
+  ///
+  /// The `rrects` argument is interpreted as a list of twelve-tuples, with
+  /// each tuple being the left, top, right and bottom edges, followed by the
+  /// x and y radii of the top left, top right, bottom right and bottom left
+  /// corners.
+  ///
+  /// The `colors` argument, which can be null, is interpreted as a list of
+  /// 32-bit colors, with the same packing as [Color.value]. Each rounded
+  /// rectangle is drawn with its color in place of [Paint.color].
+  void drawRRects(Float32List rrects, Paint paint, { Int32List colors }) {
+    assert(rrects != null);
+    assert(paint != null);
+    if (rrects.length % 12 != 0)
+      throw new ArgumentError('"rrects" length must be a multiple of twelve.');
+    if (colors != null && colors.length * 12 != rrects.length)
+      throw new ArgumentError('If non-null, "colors" length must be one twelfth the length of "rrects".');
+    _flush();
+    _drawRRects(paint._objects, paint._data, rrects, colors);
+  }
+  void _drawRRects(List<dynamic> paintObjects,
+                   ByteData paintData,
+                   Float32List rrects,
+                   Int32List colors) native "Canvas_drawRRects";
+
+  /// Draws many circles with the given [Paint] in a single call.
+  ///
+  /// The `circles` argument is interpreted as a list of three-tuples, with
+  /// each tuple being the x and y coordinates of the center followed by the
+  /// radius.
+  ///
+  /// The `colors` argument, which can be null, is interpreted as a list of
+  /// 32-bit colors, with the same packing as [Color.value]. Each circle is
+  /// drawn with its color in place of [Paint.color].
+  void drawCircles(Float32List circles, Paint paint, { Int32List colors }) {
+    assert(circles != null);
+    assert(paint != null);
+    if (circles.length % 3 != 0)
+      throw new ArgumentError('"circles" length must be a multiple of three.');
+    if (colors != null && colors.length * 3 != circles.length)
+      throw new ArgumentError('If non-null, "colors" length must be one third the length of "circles".');
+    _flush();
+    _drawCircles(paint._objects, paint._data, circles, colors);
+  }
+  void _drawCircles(List<dynamic> paintObjects,
+                    ByteData paintData,
+                    Float32List circles,
+                    Int32List colors) native "Canvas_drawCircles";
+
   void drawVertices(Vertices vertices, BlendMode blendMode, Paint paint) {
     assert(vertices != null); // vertices is checked on the engine side
     assert(paint != null);
     assert(blendMode != null);
+    _flush();
     _drawVertices(vertices, blendMode.index, paint._objects, paint._data);
   }
   void _drawVertices(Vertices vertices,
@@ -2118,6 +2440,7 @@ class Canvas extends NativeFieldWrapperClass2 {
     final Int32List colorBuffer = colors.isEmpty ? null : _encodeColorList(colors);
     final Float32List cullRectBuffer = cullRect?._value;
 
+    _flush();
     _drawAtlas(
       paint._objects, paint._data, atlas, rstTransformBuffer, rectBuffer,
       colorBuffer, blendMode.index, cullRectBuffer
@@ -2161,6 +2484,7 @@ class Canvas extends NativeFieldWrapperClass2 {
     if (colors != null && colors.length * 4 != rectCount)
       throw new ArgumentError('If non-null, "colors" length must be one fourth the length of "rstTransforms" and "rects".');
 
+    _flush();
     _drawAtlas(
       paint._objects, paint._data, atlas, rstTransforms, rects,
       colors, blendMode.index, cullRect?._value
@@ -2182,6 +2506,7 @@ class Canvas extends NativeFieldWrapperClass2 {
   void drawShadow(Path path, Color color, double elevation, bool transparentOccluder) {
     assert(path != null); // path is checked on the engine side
     assert(color != null);
+    _flush();
     _drawShadow(path, color.value, elevation, transparentOccluder);
   }
   void _drawShadow(Path path,
@@ -2213,6 +2538,23 @@ abstract class Picture extends NativeFieldWrapperClass2 {
   /// rasterized the first time the image is drawn and then cached.
   Image toImage(int width, int height) native "Picture_toImage";
 
+  /// Creates an image from this picture and passes it to `callback`.
+  ///
+  /// Unlike [toImage], the picture is rasterized right away, off the UI
+  /// thread, and the image is uploaded to the GPU before `callback` is
+  /// invoked. Drawing the image then costs no more than drawing any other
+  /// image, which makes this the better choice for large pictures.
+  ///
+  /// The callback is invoked with null if the picture could not be
+  /// rasterized.
+  void toImageAsync(int width, int height, ImageDecoderCallback callback) {
+    assert(width > 0 && height > 0);
+    assert(callback != null);
+    _toImageAsync(width, height, callback);
+  }
+  void _toImageAsync(int width, int height, ImageDecoderCallback callback)
+      native "Picture_toImageAsync";
+
   /// Release the resources used by this object. The object is no longer usable
   /// after this method is called.
   void dispose() native "Picture_dispose";
@@ -2245,5 +2587,12 @@ class PictureRecorder extends NativeFieldWrapperClass2 {
   /// and the canvas objects are invalid and cannot be used further.
   ///
   /// Returns null if the PictureRecorder is not associated with a canvas.
-  Picture endRecording() native "PictureRecorder_endRecording";
+  Picture endRecording() {
+    _canvas?._flush();
+    _canvas = null;
+    return _endRecording();
+  }
+  Picture _endRecording() native "PictureRecorder_endRecording";
+
+  Canvas _canvas;
 }
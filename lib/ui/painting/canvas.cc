@@ -11,6 +11,7 @@
 #include "flutter/lib/ui/painting/matrix.h"
 #include "flutter/lib/ui/ui_dart_state.h"
 #include "flutter/lib/ui/window/window.h"
+#include "lib/fxl/logging.h"
 #include "lib/tonic/converter/dart_converter.h"
 #include "lib/tonic/dart_args.h"
 #include "lib/tonic/dart_binding_macros.h"
@@ -22,6 +23,105 @@
 using tonic::ToDart;
 
 namespace blink {
+namespace {
+
+// The commands batched by painting.dart. Each is an opcode followed by its
+// arguments, one 32 bit word each, and by the encoded paint data where the
+// command draws. Must be kept in sync with painting.dart.
+enum class CanvasOp : int32_t {
+  kSave,
+  kRestore,
+  kTranslate,
+  kScale,
+  kRotate,
+  kClipRect,
+  kDrawColor,
+  kDrawLine,
+  kDrawPaint,
+  kDrawRect,
+  kDrawOval,
+  kDrawCircle,
+};
+
+constexpr int kPaintDataWordCount = Paint::kDataByteCount / 4;
+
+// Returns the number of words that follow the opcode, or -1 if the opcode is
+// unknown and the commands cannot be read further.
+int GetArgumentWordCount(CanvasOp op) {
+  switch (op) {
+    case CanvasOp::kSave:
+    case CanvasOp::kRestore:
+      return 0;
+    case CanvasOp::kRotate:
+      return 1;
+    case CanvasOp::kTranslate:
+    case CanvasOp::kScale:
+    case CanvasOp::kDrawColor:
+      return 2;
+    case CanvasOp::kClipRect:
+      return 5;
+    case CanvasOp::kDrawPaint:
+      return kPaintDataWordCount;
+    case CanvasOp::kDrawCircle:
+      return 3 + kPaintDataWordCount;
+    case CanvasOp::kDrawLine:
+    case CanvasOp::kDrawRect:
+    case CanvasOp::kDrawOval:
+      return 4 + kPaintDataWordCount;
+  }
+  return -1;
+}
+
+// Invokes |draw| with the index and paint of each of |count| shapes. The
+// paint's color is replaced by the shape's color where |colors| is given.
+template <typename DrawShape>
+void DrawShapes(const SkPaint& paint,
+                size_t count,
+                const tonic::Int32List& colors,
+                DrawShape draw) {
+  if (!colors.data()) {
+    for (size_t i = 0; i < count; ++i)
+      draw(i, paint);
+    return;
+  }
+
+  FXL_DCHECK(static_cast<size_t>(colors.num_elements()) >= count);
+  SkPaint shape_paint(paint);
+  for (size_t i = 0; i < count; ++i) {
+    shape_paint.setColor(static_cast<SkColor>(colors.data()[i]));
+    draw(i, shape_paint);
+  }
+}
+
+// Draws |src| of |image| into |dst|. Images packed into an atlas are drawn
+// from their page, with |src| clipped to their region the way Skia clips it
+// to the bounds of an image.
+void DrawImageRect(SkCanvas* canvas,
+                   const CanvasImage& image,
+                   SkRect src,
+                   SkRect dst,
+                   const SkPaint* paint) {
+  const sk_sp<SkImage>& page = image.atlas_page();
+  if (!page) {
+    canvas->drawImageRect(image.image(), src, dst, paint,
+                          SkCanvas::kFast_SrcRectConstraint);
+    return;
+  }
+
+  const SkIRect& region = image.atlas_rect();
+  SkRect clipped = src;
+  if (!clipped.intersect(SkRect::MakeIWH(region.width(), region.height())))
+    return;
+  if (clipped != src) {
+    SkMatrix::MakeRectToRect(src, dst, SkMatrix::kFill_ScaleToFit)
+        .mapRect(&dst, clipped);
+  }
+  clipped.offset(region.x(), region.y());
+  canvas->drawImageRect(page, clipped, dst, paint,
+                        SkCanvas::kFast_SrcRectConstraint);
+}
+
+}  // namespace
 
 static void Canvas_constructor(Dart_NativeArguments args) {
   DartCallConstructor(&Canvas::Create, args);
@@ -30,20 +130,13 @@ static void Canvas_constructor(Dart_NativeArguments args) {
 IMPLEMENT_WRAPPERTYPEINFO(ui, Canvas);
 
 #define FOR_EACH_BINDING(V)         \
-  V(Canvas, save)                   \
   V(Canvas, saveLayerWithoutBounds) \
   V(Canvas, saveLayer)              \
-  V(Canvas, restore)                \
   V(Canvas, getSaveCount)           \
-  V(Canvas, translate)              \
-  V(Canvas, scale)                  \
-  V(Canvas, rotate)                 \
   V(Canvas, skew)                   \
   V(Canvas, transform)              \
-  V(Canvas, clipRect)               \
   V(Canvas, clipRRect)              \
   V(Canvas, clipPath)               \
-  V(Canvas, drawColor)              \
   V(Canvas, drawLine)               \
   V(Canvas, drawPaint)              \
   V(Canvas, drawRect)               \
@@ -58,9 +151,13 @@ IMPLEMENT_WRAPPERTYPEINFO(ui, Canvas);
   V(Canvas, drawImageNine)          \
   V(Canvas, drawPicture)            \
   V(Canvas, drawPoints)             \
+  V(Canvas, drawRects)              \
+  V(Canvas, drawRRects)             \
+  V(Canvas, drawCircles)            \
   V(Canvas, drawVertices)           \
   V(Canvas, drawAtlas)              \
-  V(Canvas, drawShadow)
+  V(Canvas, drawShadow)             \
+  V(Canvas, replay)
 
 FOR_EACH_BINDING(DART_NATIVE_CALLBACK)
 
@@ -88,12 +185,6 @@ Canvas::Canvas(SkCanvas* canvas) : canvas_(canvas) {}
 
 Canvas::~Canvas() {}
 
-void Canvas::save() {
-  if (!canvas_)
-    return;
-  canvas_->save();
-}
-
 void Canvas::saveLayerWithoutBounds(const Paint& paint,
                                     const PaintData& paint_data) {
   if (!canvas_)
@@ -113,36 +204,12 @@ void Canvas::saveLayer(double left,
   canvas_->saveLayer(&bounds, paint.paint());
 }
 
-void Canvas::restore() {
-  if (!canvas_)
-    return;
-  canvas_->restore();
-}
-
 int Canvas::getSaveCount() {
   if (!canvas_)
     return 0;
   return canvas_->getSaveCount();
 }
 
-void Canvas::translate(double dx, double dy) {
-  if (!canvas_)
-    return;
-  canvas_->translate(dx, dy);
-}
-
-void Canvas::scale(double sx, double sy) {
-  if (!canvas_)
-    return;
-  canvas_->scale(sx, sy);
-}
-
-void Canvas::rotate(double radians) {
-  if (!canvas_)
-    return;
-  canvas_->rotate(radians * 180.0 / M_PI);
-}
-
 void Canvas::skew(double sx, double sy) {
   if (!canvas_)
     return;
@@ -155,16 +222,6 @@ void Canvas::transform(const tonic::Float64List& matrix4) {
   canvas_->concat(ToSkMatrix(matrix4));
 }
 
-void Canvas::clipRect(double left,
-                      double top,
-                      double right,
-                      double bottom,
-                      SkClipOp clipOp) {
-  if (!canvas_)
-    return;
-  canvas_->clipRect(SkRect::MakeLTRB(left, top, right, bottom), clipOp, true);
-}
-
 void Canvas::clipRRect(const RRect& rrect) {
   if (!canvas_)
     return;
@@ -180,12 +237,6 @@ void Canvas::clipPath(const CanvasPath* path) {
   canvas_->clipPath(path->path(), true);
 }
 
-void Canvas::drawColor(SkColor color, SkBlendMode blend_mode) {
-  if (!canvas_)
-    return;
-  canvas_->drawColor(color, blend_mode);
-}
-
 void Canvas::drawLine(double x1,
                       double y1,
                       double x2,
@@ -289,6 +340,12 @@ void Canvas::drawImage(const CanvasImage* image,
   if (!image)
     Dart_ThrowException(
         ToDart("Canvas.drawImage called with non-genuine Image."));
+  if (image->atlas_page()) {
+    SkRect src = SkRect::MakeIWH(image->atlas_rect().width(),
+                                 image->atlas_rect().height());
+    DrawImageRect(canvas_, *image, src, src.makeOffset(x, y), paint.paint());
+    return;
+  }
   canvas_->drawImage(image->image(), x, y, paint.paint());
 }
 
@@ -310,8 +367,7 @@ void Canvas::drawImageRect(const CanvasImage* image,
         ToDart("Canvas.drawImageRect called with non-genuine Image."));
   SkRect src = SkRect::MakeLTRB(src_left, src_top, src_right, src_bottom);
   SkRect dst = SkRect::MakeLTRB(dst_left, dst_top, dst_right, dst_bottom);
-  canvas_->drawImageRect(image->image(), src, dst, paint.paint(),
-                         SkCanvas::kFast_SrcRectConstraint);
+  DrawImageRect(canvas_, *image, src, dst, paint.paint());
 }
 
 void Canvas::drawImageNine(const CanvasImage* image,
@@ -345,6 +401,7 @@ void Canvas::drawPicture(Picture* picture) {
     Dart_ThrowException(
         ToDart("Canvas.drawPicture called with non-genuine Picture."));
   canvas_->drawPicture(picture->picture().get());
+  AddReferencedBytes(picture->GetAllocationSize());
 }
 
 void Canvas::drawPoints(const Paint& paint,
@@ -363,6 +420,64 @@ void Canvas::drawPoints(const Paint& paint,
                       *paint.paint());
 }
 
+void Canvas::drawRects(const Paint& paint,
+                       const PaintData& paint_data,
+                       const tonic::Float32List& rects,
+                       const tonic::Int32List& colors) {
+  if (!canvas_)
+    return;
+
+  static_assert(sizeof(SkRect) == sizeof(float) * 4,
+                "SkRect doesn't use floats.");
+
+  const SkRect* sk_rects = reinterpret_cast<const SkRect*>(rects.data());
+  DrawShapes(*paint.paint(), rects.num_elements() / 4, colors,
+             [this, sk_rects](size_t i, const SkPaint& shape_paint) {
+               canvas_->drawRect(sk_rects[i], shape_paint);
+             });
+}
+
+void Canvas::drawRRects(const Paint& paint,
+                        const PaintData& paint_data,
+                        const tonic::Float32List& rrects,
+                        const tonic::Int32List& colors) {
+  if (!canvas_)
+    return;
+
+  // Each rounded rectangle is encoded as in RRect._value.
+  const float* data = rrects.data();
+  DrawShapes(*paint.paint(), rrects.num_elements() / 12, colors,
+             [this, data](size_t i, const SkPaint& shape_paint) {
+               const float* values = data + i * 12;
+               SkVector radii[4] = {{values[4], values[5]},
+                                    {values[6], values[7]},
+                                    {values[8], values[9]},
+                                    {values[10], values[11]}};
+               SkRRect rrect;
+               rrect.setRectRadii(SkRect::MakeLTRB(values[0], values[1],
+                                                   values[2], values[3]),
+                                  radii);
+               canvas_->drawRRect(rrect, shape_paint);
+             });
+}
+
+void Canvas::drawCircles(const Paint& paint,
+                         const PaintData& paint_data,
+                         const tonic::Float32List& circles,
+                         const tonic::Int32List& colors) {
+  if (!canvas_)
+    return;
+
+  // Each circle is encoded as its center followed by its radius.
+  const float* data = circles.data();
+  DrawShapes(*paint.paint(), circles.num_elements() / 3, colors,
+             [this, data](size_t i, const SkPaint& shape_paint) {
+               const float* values = data + i * 3;
+               canvas_->drawCircle(values[0], values[1], values[2],
+                                   shape_paint);
+             });
+}
+
 void Canvas::drawVertices(const Vertices* vertices,
                           SkBlendMode blend_mode,
                           const Paint& paint,
@@ -420,8 +535,85 @@ void Canvas::drawShadow(const CanvasPath* path,
                                        transparentOccluder, dpr);
 }
 
+void Canvas::replay(const tonic::Int32List& commands) {
+  if (!canvas_)
+    return;
+
+  const int32_t* words = commands.data();
+  const float* floats = reinterpret_cast<const float*>(words);
+  const size_t count = commands.num_elements();
+  size_t index = 0;
+  while (index < count) {
+    const CanvasOp op = static_cast<CanvasOp>(words[index]);
+    const int argument_count = GetArgumentWordCount(op);
+    if (argument_count < 0 || index + 1 + argument_count > count) {
+      FXL_DLOG(ERROR) << "Malformed canvas commands.";
+      return;
+    }
+
+    const int32_t* args = words + index + 1;
+    const float* float_args = floats + index + 1;
+    index += 1 + argument_count;
+
+    const SkPaint* paint = nullptr;
+    if (argument_count >= kPaintDataWordCount) {
+      paint = &paint_cache_.Get(args + argument_count - kPaintDataWordCount,
+                                nullptr, nullptr);
+    }
+
+    switch (op) {
+      case CanvasOp::kSave:
+        canvas_->save();
+        break;
+      case CanvasOp::kRestore:
+        canvas_->restore();
+        break;
+      case CanvasOp::kTranslate:
+        canvas_->translate(float_args[0], float_args[1]);
+        break;
+      case CanvasOp::kScale:
+        canvas_->scale(float_args[0], float_args[1]);
+        break;
+      case CanvasOp::kRotate:
+        canvas_->rotate(float_args[0] * 180.0 / M_PI);
+        break;
+      case CanvasOp::kClipRect:
+        canvas_->clipRect(SkRect::MakeLTRB(float_args[0], float_args[1],
+                                           float_args[2], float_args[3]),
+                          static_cast<SkClipOp>(args[4]), true);
+        break;
+      case CanvasOp::kDrawColor:
+        canvas_->drawColor(static_cast<SkColor>(args[0]),
+                           static_cast<SkBlendMode>(args[1]));
+        break;
+      case CanvasOp::kDrawLine:
+        canvas_->drawLine(float_args[0], float_args[1], float_args[2],
+                          float_args[3], *paint);
+        break;
+      case CanvasOp::kDrawPaint:
+        canvas_->drawPaint(*paint);
+        break;
+      case CanvasOp::kDrawRect:
+        canvas_->drawRect(SkRect::MakeLTRB(float_args[0], float_args[1],
+                                           float_args[2], float_args[3]),
+                          *paint);
+        break;
+      case CanvasOp::kDrawOval:
+        canvas_->drawOval(SkRect::MakeLTRB(float_args[0], float_args[1],
+                                           float_args[2], float_args[3]),
+                          *paint);
+        break;
+      case CanvasOp::kDrawCircle:
+        canvas_->drawCircle(float_args[0], float_args[1], float_args[2],
+                            *paint);
+        break;
+    }
+  }
+}
+
 void Canvas::Clear() {
   canvas_ = nullptr;
+  paint_cache_.Clear();
 }
 
 bool Canvas::IsRecording() const {
@@ -39,7 +39,6 @@ class Canvas : public fxl::RefCountedThreadSafe<Canvas>,
 
   ~Canvas() override;
 
-  void save();
   void saveLayerWithoutBounds(const Paint& paint, const PaintData& paint_data);
   void saveLayer(double left,
                  double top,
@@ -47,24 +46,14 @@ class Canvas : public fxl::RefCountedThreadSafe<Canvas>,
                  double bottom,
                  const Paint& paint,
                  const PaintData& paint_data);
-  void restore();
   int getSaveCount();
 
-  void translate(double dx, double dy);
-  void scale(double sx, double sy);
-  void rotate(double radians);
   void skew(double sx, double sy);
   void transform(const tonic::Float64List& matrix4);
 
-  void clipRect(double left,
-                double top,
-                double right,
-                double bottom,
-                SkClipOp clipOp);
   void clipRRect(const RRect& rrect);
   void clipPath(const CanvasPath* path);
 
-  void drawColor(SkColor color, SkBlendMode blend_mode);
   void drawLine(double x1,
                 double y1,
                 double x2,
@@ -147,6 +136,21 @@ class Canvas : public fxl::RefCountedThreadSafe<Canvas>,
                   SkCanvas::PointMode point_mode,
                   const tonic::Float32List& points);
 
+  void drawRects(const Paint& paint,
+                 const PaintData& paint_data,
+                 const tonic::Float32List& rects,
+                 const tonic::Int32List& colors);
+
+  void drawRRects(const Paint& paint,
+                  const PaintData& paint_data,
+                  const tonic::Float32List& rrects,
+                  const tonic::Int32List& colors);
+
+  void drawCircles(const Paint& paint,
+                   const PaintData& paint_data,
+                   const tonic::Float32List& circles,
+                   const tonic::Int32List& colors);
+
   void drawVertices(const Vertices* vertices,
                     SkBlendMode blend_mode,
                     const Paint& paint,
@@ -166,7 +170,17 @@ class Canvas : public fxl::RefCountedThreadSafe<Canvas>,
                   double elevation,
                   bool transparentOccluder);
 
+  // Performs the commands that painting.dart batched into |commands|.
+  void replay(const tonic::Int32List& commands);
+
   SkCanvas* canvas() const { return canvas_; }
+  PaintCache& paint_cache() { return paint_cache_; }
+
+  // Counts |bytes| that the recording keeps alive but that its SkPicture does
+  // not count itself, such as text blobs and nested pictures.
+  void AddReferencedBytes(size_t bytes) { referenced_bytes_ += bytes; }
+  size_t referenced_bytes() const { return referenced_bytes_; }
+
   void Clear();
   bool IsRecording() const;
 
@@ -179,6 +193,8 @@ class Canvas : public fxl::RefCountedThreadSafe<Canvas>,
   // which does not transfer ownership.  For this reason, we hold a raw
   // pointer and manually set to null in Clear.
   SkCanvas* canvas_;
+  PaintCache paint_cache_;
+  size_t referenced_bytes_ = 0;
 };
 
 }  // namespace blink
@@ -0,0 +1,245 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/codec.h"
+
+#include "flutter/common/threads.h"
+#include "flutter/glue/trace_event.h"
+#include "flutter/lib/ui/painting/image.h"
+#include "flutter/lib/ui/painting/image_upload_queue.h"
+#include "flutter/lib/ui/painting/utils.h"
+#include "lib/fxl/functional/make_copyable.h"
+#include "lib/tonic/converter/dart_converter.h"
+#include "lib/tonic/dart_args.h"
+#include "lib/tonic/dart_binding_macros.h"
+#include "lib/tonic/dart_library_natives.h"
+#include "lib/tonic/dart_state.h"
+#include "lib/tonic/logging/dart_invoke.h"
+#include "lib/tonic/typed_data/uint8_list.h"
+
+using tonic::DartInvoke;
+using tonic::DartPersistentValue;
+using tonic::ToDart;
+
+namespace blink {
+namespace {
+
+// The number of frames decoded ahead of the ones requested, so that the next
+// frame of a running animation is usually ready when it is asked for.
+constexpr size_t kFramesToDecodeAhead = 1;
+
+// Decodes run on the worker pool when there is one. Uploads always run on the
+// IO thread, which owns the resource context.
+const fxl::RefPtr<fxl::TaskRunner>& DecodeTaskRunner() {
+  return Threads::Worker() ? Threads::Worker() : Threads::IO();
+}
+
+void InvokeCodecCallback(fxl::RefPtr<Codec> codec,
+                         std::unique_ptr<DartPersistentValue> callback) {
+  tonic::DartState* dart_state = callback->dart_state().get();
+  if (!dart_state) {
+    return;
+  }
+  tonic::DartState::Scope scope(dart_state);
+  if (!codec) {
+    DartInvoke(callback->value(), {Dart_Null()});
+  } else {
+    DartInvoke(callback->value(), {ToDart(codec)});
+  }
+}
+
+void InstantiateImageCodec(Dart_NativeArguments args) {
+  Dart_Handle exception = nullptr;
+
+  tonic::Uint8List list =
+      tonic::DartConverter<tonic::Uint8List>::FromArguments(args, 0, exception);
+  if (exception) {
+    Dart_ThrowException(exception);
+    return;
+  }
+
+  Dart_Handle callback_handle = Dart_GetNativeArgument(args, 1);
+  if (!Dart_IsClosure(callback_handle)) {
+    Dart_ThrowException(ToDart("Callback must be a function"));
+    return;
+  }
+
+  auto buffer = SkData::MakeWithCopy(list.data(), list.num_elements());
+
+  DecodeTaskRunner()->PostTask(fxl::MakeCopyable([
+    callback = std::make_unique<DartPersistentValue>(
+        tonic::DartState::Current(), callback_handle),
+    buffer = std::move(buffer)
+  ]() mutable {
+    TRACE_EVENT0("blink", "InstantiateImageCodec");
+    // Only reads the header. Frames are decoded when they are requested.
+    std::unique_ptr<SkCodec> sk_codec = SkCodec::MakeFromData(buffer);
+    fxl::RefPtr<Codec> codec;
+    if (sk_codec) {
+      codec = fxl::MakeRefCounted<Codec>(std::move(sk_codec));
+    }
+    Threads::UI()->PostTask(fxl::MakeCopyable([
+      codec = std::move(codec), callback = std::move(callback)
+    ]() mutable { InvokeCodecCallback(std::move(codec), std::move(callback)); }));
+  }));
+}
+
+}  // namespace
+
+IMPLEMENT_WRAPPERTYPEINFO(ui, Codec);
+
+#define FOR_EACH_BINDING(V) \
+  V(Codec, frameCount)      \
+  V(Codec, repetitionCount) \
+  V(Codec, getNextFrame)    \
+  V(Codec, dispose)
+
+FOR_EACH_BINDING(DART_NATIVE_CALLBACK)
+
+void Codec::RegisterNatives(tonic::DartLibraryNatives* natives) {
+  natives->Register({
+      {"instantiateImageCodec", InstantiateImageCodec, 2, true},
+  });
+  natives->Register({FOR_EACH_BINDING(DART_REGISTER_NATIVE)});
+}
+
+Codec::Codec(std::unique_ptr<SkCodec> codec)
+    : frame_count_(codec->getFrameCount()),
+      repetition_count_(codec->getRepetitionCount()),
+      codec_(std::move(codec)),
+      frame_info_(codec_->getFrameInfo()) {}
+
+Codec::~Codec() {
+  // Skia objects must be deleted on the IO thread so that any associated GL
+  // objects will be cleaned up through the IO thread's GL context.
+  for (Frame& frame : decoded_frames_) {
+    SkiaUnrefOnIOThread(&frame.image);
+  }
+}
+
+void Codec::getNextFrame(Dart_Handle callback) {
+  pending_callbacks_.push_back(std::make_unique<DartPersistentValue>(
+      tonic::DartState::Current(), callback));
+  // Callbacks are always answered asynchronously, even when the frame is
+  // already decoded.
+  Threads::UI()->PostTask(
+      [codec = fxl::RefPtr<Codec>(this)] { codec->AnswerCallbacks(); });
+}
+
+void Codec::dispose() {
+  ClearDartWrapper();
+}
+
+void Codec::AnswerCallbacks() {
+  while (!pending_callbacks_.empty() && !decoded_frames_.empty()) {
+    std::unique_ptr<DartPersistentValue> callback =
+        std::move(pending_callbacks_.front());
+    pending_callbacks_.pop_front();
+    Frame frame = std::move(decoded_frames_.front());
+    decoded_frames_.pop_front();
+
+    tonic::DartState* dart_state = callback->dart_state().get();
+    if (!dart_state) {
+      SkiaUnrefOnIOThread(&frame.image);
+      continue;
+    }
+    tonic::DartState::Scope scope(dart_state);
+    if (!frame.image) {
+      DartInvoke(callback->value(), {Dart_Null(), ToDart(0)});
+    } else {
+      fxl::RefPtr<CanvasImage> image = CanvasImage::Create();
+      image->set_image(std::move(frame.image));
+      DartInvoke(callback->value(),
+                 {ToDart(image), ToDart(frame.duration_millis)});
+    }
+  }
+  ScheduleDecodeIfNeeded();
+}
+
+void Codec::ScheduleDecodeIfNeeded() {
+  if (decode_in_flight_ || frame_count_ <= 0 ||
+      decoded_frames_.size() >=
+          pending_callbacks_.size() + kFramesToDecodeAhead) {
+    return;
+  }
+
+  decode_in_flight_ = true;
+  const int index = next_frame_to_decode_;
+  next_frame_to_decode_ = (next_frame_to_decode_ + 1) % frame_count_;
+
+  DecodeTaskRunner()->PostTask(fxl::MakeCopyable([
+    codec = fxl::RefPtr<Codec>(this), index
+  ]() mutable {
+    Frame frame = codec->DecodeFrame(index);
+    Threads::IO()->PostTask(fxl::MakeCopyable([
+      codec = std::move(codec), frame = std::move(frame)
+    ]() mutable {
+      sk_sp<SkImage> image = std::move(frame.image);
+      ImageUploadQueue::Get().Upload(
+          std::move(image), ImageUploadQueue::Priority::kHigh,
+          fxl::MakeCopyable([ codec = std::move(codec), frame ](
+              sk_sp<SkImage> uploaded) mutable {
+            frame.image = std::move(uploaded);
+            Threads::UI()->PostTask(fxl::MakeCopyable([
+              codec = std::move(codec), frame = std::move(frame)
+            ]() mutable { codec->DidDecodeFrame(std::move(frame)); }));
+          }));
+    }));
+  }));
+}
+
+void Codec::DidDecodeFrame(Frame frame) {
+  decode_in_flight_ = false;
+  decoded_frames_.push_back(std::move(frame));
+  AnswerCallbacks();
+}
+
+Codec::Frame Codec::DecodeFrame(int index) {
+  TRACE_EVENT1("blink", "Codec::DecodeFrame", "index", index);
+
+  Frame frame;
+  if (static_cast<size_t>(index) < frame_info_.size()) {
+    frame.duration_millis = frame_info_[index].fDuration;
+  }
+
+  if (compositing_bitmap_.isNull()) {
+    const SkImageInfo& info = codec_->getInfo();
+    const SkAlphaType alpha_type = info.alphaType() == kOpaque_SkAlphaType
+                                       ? kOpaque_SkAlphaType
+                                       : kPremul_SkAlphaType;
+    if (!compositing_bitmap_.tryAllocPixels(
+            info.makeColorType(kN32_SkColorType).makeAlphaType(alpha_type))) {
+      return frame;
+    }
+  }
+
+  SkCodec::Options options;
+  options.fFrameIndex = index;
+  const int required_frame =
+      static_cast<size_t>(index) < frame_info_.size()
+          ? frame_info_[index].fRequiredFrame
+          : SkCodec::kNone;
+  if (required_frame != SkCodec::kNone &&
+      required_frame == compositing_bitmap_frame_) {
+    // The frame is drawn on top of the one already in the bitmap.
+    options.fPriorFrame = required_frame;
+  } else {
+    // Lets the codec decode whatever the frame depends on itself.
+    compositing_bitmap_.eraseColor(SK_ColorTRANSPARENT);
+  }
+
+  SkCodec::Result result = codec_->getPixels(
+      compositing_bitmap_.info(), compositing_bitmap_.getPixels(),
+      compositing_bitmap_.rowBytes(), &options);
+  if (result != SkCodec::kSuccess && result != SkCodec::kIncompleteInput) {
+    compositing_bitmap_frame_ = -1;
+    return frame;
+  }
+  compositing_bitmap_frame_ = index;
+
+  frame.image = SkImage::MakeRasterCopy(compositing_bitmap_.pixmap());
+  return frame;
+}
+
+}  // namespace blink
@@ -0,0 +1,84 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_CODEC_H_
+#define FLUTTER_LIB_UI_PAINTING_CODEC_H_
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "lib/tonic/dart_persistent_value.h"
+#include "lib/tonic/dart_wrappable.h"
+#include "third_party/skia/include/codec/SkCodec.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkImage.h"
+
+namespace tonic {
+class DartLibraryNatives;
+}  // namespace tonic
+
+namespace blink {
+
+// Decodes the frames of a possibly animated image on demand. Only a few frames
+// are decoded ahead of the ones requested, so memory use does not depend on
+// the number of frames.
+class Codec final : public fxl::RefCountedThreadSafe<Codec>,
+                    public tonic::DartWrappable {
+  DEFINE_WRAPPERTYPEINFO();
+  FRIEND_MAKE_REF_COUNTED(Codec);
+
+ public:
+  ~Codec() override;
+
+  int frameCount() { return frame_count_; }
+  int repetitionCount() { return repetition_count_; }
+
+  // Invokes |callback| with the next frame's image and duration in
+  // milliseconds. Frames are answered in the order they were requested and
+  // wrap around after the last one.
+  void getNextFrame(Dart_Handle callback);
+
+  void dispose();
+
+  static void RegisterNatives(tonic::DartLibraryNatives* natives);
+
+ private:
+  struct Frame {
+    sk_sp<SkImage> image;
+    int duration_millis = 0;
+  };
+
+  explicit Codec(std::unique_ptr<SkCodec> codec);
+
+  // Called on the UI thread.
+  void ScheduleDecodeIfNeeded();
+  void DidDecodeFrame(Frame frame);
+  void AnswerCallbacks();
+
+  // Called on the decoder threads, one frame at a time.
+  Frame DecodeFrame(int index);
+
+  const int frame_count_;
+  const int repetition_count_;
+
+  // Only accessed by the one decode in flight.
+  std::unique_ptr<SkCodec> codec_;
+  std::vector<SkCodec::FrameInfo> frame_info_;
+  // Holds the last decoded frame. Later frames are often drawn on top of it.
+  SkBitmap compositing_bitmap_;
+  int compositing_bitmap_frame_ = -1;
+
+  // Only accessed on the UI thread.
+  bool decode_in_flight_ = false;
+  int next_frame_to_decode_ = 0;
+  std::deque<Frame> decoded_frames_;
+  std::deque<std::unique_ptr<tonic::DartPersistentValue>> pending_callbacks_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(Codec);
+};
+
+}  // namespace blink
+
+#endif  // FLUTTER_LIB_UI_PAINTING_CODEC_H_
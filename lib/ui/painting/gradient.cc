@@ -4,6 +4,7 @@
 
 #include "flutter/lib/ui/painting/gradient.h"
 
+#include "flutter/lib/ui/painting/shader_cache.h"
 #include "lib/tonic/converter/dart_converter.h"
 #include "lib/tonic/dart_args.h"
 #include "lib/tonic/dart_binding_macros.h"
@@ -14,6 +15,29 @@ namespace blink {
 typedef CanvasGradient
     Gradient;  // Because the C++ name doesn't match the Dart name.
 
+namespace {
+
+enum class GradientType : char { kLinear, kRadial };
+
+// Starts the cache key of a gradient with the parameters all types share.
+std::string GradientKey(GradientType type,
+                        const tonic::Int32List& colors,
+                        const tonic::Float32List& color_stops,
+                        SkShader::TileMode tile_mode) {
+  std::string key(1, static_cast<char>(type));
+  const int32_t count = colors.num_elements();
+  const bool has_stops = color_stops.data() != nullptr;
+  ShaderCache::AppendToKey(&key, &tile_mode, sizeof(tile_mode));
+  ShaderCache::AppendToKey(&key, &count, sizeof(count));
+  ShaderCache::AppendToKey(&key, &has_stops, sizeof(has_stops));
+  ShaderCache::AppendToKey(&key, colors.data(), count * sizeof(int32_t));
+  if (has_stops)
+    ShaderCache::AppendToKey(&key, color_stops.data(), count * sizeof(float));
+  return key;
+}
+
+}  // namespace
+
 static void Gradient_constructor(Dart_NativeArguments args) {
   DartCallConstructor(&CanvasGradient::Create, args);
 }
@@ -48,10 +72,15 @@ void CanvasGradient::initLinear(const tonic::Float32List& end_points,
   static_assert(sizeof(SkColor) == sizeof(int32_t),
                 "SkColor doesn't use int32_t.");
 
-  set_shader(SkGradientShader::MakeLinear(
-      reinterpret_cast<const SkPoint*>(end_points.data()),
-      reinterpret_cast<const SkColor*>(colors.data()), color_stops.data(),
-      colors.num_elements(), tile_mode));
+  std::string key =
+      GradientKey(GradientType::kLinear, colors, color_stops, tile_mode);
+  ShaderCache::AppendToKey(&key, end_points.data(), 4 * sizeof(float));
+  set_shader(ShaderCache::Shared().Get(key, [&] {
+    return SkGradientShader::MakeLinear(
+        reinterpret_cast<const SkPoint*>(end_points.data()),
+        reinterpret_cast<const SkColor*>(colors.data()), color_stops.data(),
+        colors.num_elements(), tile_mode);
+  }));
 }
 
 void CanvasGradient::initRadial(double center_x,
@@ -66,10 +95,18 @@ void CanvasGradient::initRadial(double center_x,
   static_assert(sizeof(SkColor) == sizeof(int32_t),
                 "SkColor doesn't use int32_t.");
 
-  set_shader(SkGradientShader::MakeRadial(
-      SkPoint::Make(center_x, center_y), radius,
-      reinterpret_cast<const SkColor*>(colors.data()), color_stops.data(),
-      colors.num_elements(), tile_mode));
+  const float geometry[] = {static_cast<float>(center_x),
+                            static_cast<float>(center_y),
+                            static_cast<float>(radius)};
+  std::string key =
+      GradientKey(GradientType::kRadial, colors, color_stops, tile_mode);
+  ShaderCache::AppendToKey(&key, geometry, sizeof(geometry));
+  set_shader(ShaderCache::Shared().Get(key, [&] {
+    return SkGradientShader::MakeRadial(
+        SkPoint::Make(geometry[0], geometry[1]), geometry[2],
+        reinterpret_cast<const SkColor*>(colors.data()), color_stops.data(),
+        colors.num_elements(), tile_mode);
+  }));
 }
 
 CanvasGradient::CanvasGradient() : Shader(nullptr) {}
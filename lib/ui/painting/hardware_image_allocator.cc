@@ -0,0 +1,30 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/hardware_image_allocator.h"
+
+#include "lib/fxl/logging.h"
+
+namespace blink {
+namespace {
+
+HardwareImageAllocator* g_allocator = nullptr;
+
+}  // namespace
+
+HardwareImageAllocator::Buffer::~Buffer() = default;
+
+HardwareImageAllocator::~HardwareImageAllocator() = default;
+
+void HardwareImageAllocator::Set(
+    std::unique_ptr<HardwareImageAllocator> allocator) {
+  FXL_DCHECK(!g_allocator);
+  g_allocator = allocator.release();
+}
+
+HardwareImageAllocator* HardwareImageAllocator::Get() {
+  return g_allocator;
+}
+
+}  // namespace blink
@@ -0,0 +1,54 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_HARDWARE_IMAGE_ALLOCATOR_H_
+#define FLUTTER_LIB_UI_PAINTING_HARDWARE_IMAGE_ALLOCATOR_H_
+
+#include <memory>
+
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkImageInfo.h"
+#include "third_party/skia/include/gpu/GrContext.h"
+
+namespace blink {
+
+// Provides pixel memory that both the CPU and the GPU can access, such as an
+// AHardwareBuffer on Android or an IOSurface on iOS. Images decoded into it
+// are sampled by the GPU where they are, without the copy of a texture
+// upload.
+class HardwareImageAllocator {
+ public:
+  class Buffer {
+   public:
+    virtual ~Buffer();
+
+    // The CPU mapping the decoder writes into. Valid until |MakeImage|.
+    virtual void* pixels() = 0;
+    virtual size_t row_bytes() = 0;
+
+    // Unmaps the pixels and wraps the buffer as an image on |context|. Called
+    // once, on the IO thread.
+    virtual sk_sp<SkImage> MakeImage(GrContext* context,
+                                     SkAlphaType alpha_type) = 0;
+  };
+
+  virtual ~HardwareImageAllocator();
+
+  // The color type the buffers hold.
+  virtual SkColorType color_type() = 0;
+
+  // Allocates and maps a buffer. Called on the decoder threads. Returns null if
+  // the buffer could not be allocated.
+  virtual std::unique_ptr<Buffer> Allocate(int width, int height) = 0;
+
+  // May be called once, before images are decoded.
+  static void Set(std::unique_ptr<HardwareImageAllocator> allocator);
+
+  // Null unless the platform provides an allocator.
+  static HardwareImageAllocator* Get();
+};
+
+}  // namespace blink
+
+#endif  // FLUTTER_LIB_UI_PAINTING_HARDWARE_IMAGE_ALLOCATOR_H_
@@ -5,6 +5,7 @@
 #include "flutter/lib/ui/painting/image.h"
 
 #include "flutter/common/threads.h"
+#include "flutter/flow/image_memory_tracker.h"
 #include "flutter/lib/ui/painting/utils.h"
 #include "lib/tonic/converter/dart_converter.h"
 #include "lib/tonic/dart_args.h"
@@ -31,9 +32,38 @@ void CanvasImage::RegisterNatives(tonic::DartLibraryNatives* natives) {
 CanvasImage::CanvasImage() {}
 
 CanvasImage::~CanvasImage() {
+  if (image_) {
+    flow::ImageMemoryTracker::Get().AddImage(*image_, -1);
+  }
   // Skia objects must be deleted on the IO thread so that any associated GL
   // objects will be cleaned up through the IO thread's GL context.
   SkiaUnrefOnIOThread(&image_);
+  SkiaUnrefOnIOThread(&atlas_page_);
+}
+
+void CanvasImage::set_image(sk_sp<SkImage> image) {
+  auto& tracker = flow::ImageMemoryTracker::Get();
+  if (image_) {
+    tracker.AddImage(*image_, -1);
+  }
+  image_ = std::move(image);
+  if (image_) {
+    tracker.AddImage(*image_, 1);
+  }
+}
+
+void CanvasImage::set_atlas_region(sk_sp<SkImage> page, const SkIRect& rect) {
+  if (!page || rect == page->bounds()) {
+    atlas_page_ = nullptr;
+    atlas_rect_ = SkIRect::MakeEmpty();
+    set_image(std::move(page));
+    return;
+  }
+  // Subsets of lazily uploaded images share their generator, so this copies
+  // nothing until the subset itself is drawn.
+  set_image(page->makeSubset(rect));
+  atlas_page_ = std::move(page);
+  atlas_rect_ = rect;
 }
 
 void CanvasImage::dispose() {
@@ -42,7 +72,7 @@ void CanvasImage::dispose() {
 
 size_t CanvasImage::GetAllocationSize() {
   if (image_) {
-    return image_->width() * image_->height() * 4;
+    return flow::ImageMemoryTracker::GetImageBytes(*image_);
   } else {
     return sizeof(CanvasImage);
   }
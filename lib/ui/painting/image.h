@@ -7,6 +7,7 @@
 
 #include "lib/tonic/dart_wrappable.h"
 #include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkRect.h"
 
 namespace tonic {
 class DartLibraryNatives;
@@ -30,7 +31,16 @@ class CanvasImage final : public fxl::RefCountedThreadSafe<CanvasImage>,
   void dispose();
 
   const sk_sp<SkImage>& image() const { return image_; }
-  void set_image(sk_sp<SkImage> image) { image_ = std::move(image); }
+  void set_image(sk_sp<SkImage> image);
+
+  // Sets the image to |rect| of the atlas |page|. Canvas draws the image from
+  // the page so that draws of the images sharing it can be batched. |image()|
+  // still returns a subset of the page for the other uses.
+  void set_atlas_region(sk_sp<SkImage> page, const SkIRect& rect);
+
+  // The page of the atlas the image is packed into, if any.
+  const sk_sp<SkImage>& atlas_page() const { return atlas_page_; }
+  const SkIRect& atlas_rect() const { return atlas_rect_; }
 
   virtual size_t GetAllocationSize() override;
 
@@ -40,6 +50,8 @@ class CanvasImage final : public fxl::RefCountedThreadSafe<CanvasImage>,
   CanvasImage();
 
   sk_sp<SkImage> image_;
+  sk_sp<SkImage> atlas_page_;
+  SkIRect atlas_rect_ = SkIRect::MakeEmpty();
 };
 
 }  // namespace blink
@@ -0,0 +1,183 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/image_atlas.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "flutter/common/settings.h"
+#include "flutter/common/threads.h"
+#include "flutter/glue/trace_event.h"
+#include "flutter/lib/ui/painting/image_upload_queue.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+
+namespace blink {
+namespace {
+
+// Images up to this size in both dimensions are packed.
+constexpr int kMaxPackedDimension = 128;
+
+// The maximum width and height of a page.
+constexpr int kPageDimension = 1024;
+
+// The edge pixels of each image are repeated this far around it, so that
+// filtering near its edges does not sample its neighbours.
+constexpr int kGutter = 2;
+
+// The start and length of the span one side of |dst| extends into the gutter
+// along one axis: before it for a negative |side|, after it for a positive
+// one, and |dst| itself for zero.
+std::pair<float, float> GetGutterSpan(int side, float start, float length) {
+  if (side < 0)
+    return {start - kGutter, kGutter};
+  if (side > 0)
+    return {start + length, kGutter};
+  return {start, length};
+}
+
+void DrawWithGutter(SkCanvas* canvas,
+                    const sk_sp<SkImage>& image,
+                    SkIPoint origin,
+                    const SkPaint& paint) {
+  const int width = image->width();
+  const int height = image->height();
+  canvas->drawImage(image, origin.x(), origin.y(), &paint);
+  for (int dy = -1; dy <= 1; dy++) {
+    for (int dx = -1; dx <= 1; dx++) {
+      if (dx == 0 && dy == 0)
+        continue;
+      // The row or column of edge pixels facing the gutter.
+      SkIRect src = SkIRect::MakeXYWH(
+          dx > 0 ? width - 1 : 0, dy > 0 ? height - 1 : 0,
+          dx != 0 ? 1 : width, dy != 0 ? 1 : height);
+      auto x = GetGutterSpan(dx, origin.x(), width);
+      auto y = GetGutterSpan(dy, origin.y(), height);
+      canvas->drawImageRect(
+          image, src, SkRect::MakeXYWH(x.first, y.first, x.second, y.second),
+          &paint, SkCanvas::kStrict_SrcRectConstraint);
+    }
+  }
+}
+
+}  // namespace
+
+ImageAtlas& ImageAtlas::Get() {
+  static ImageAtlas* atlas = new ImageAtlas();
+  return *atlas;
+}
+
+ImageAtlas::ImageAtlas() : enabled_(Settings::Get().enable_image_atlas) {}
+
+ImageAtlas::~ImageAtlas() = default;
+
+bool ImageAtlas::ShouldPack(const SkImage& image) const {
+  return enabled_ && !image.isTextureBacked() &&
+         image.width() <= kMaxPackedDimension &&
+         image.height() <= kMaxPackedDimension;
+}
+
+void ImageAtlas::Pack(sk_sp<SkImage> image, Callback callback) {
+  pending_.push_back({std::move(image), std::move(callback)});
+  if (flush_scheduled_)
+    return;
+  // Decodes that finish while the IO thread is busy queue up behind this
+  // task and end up on the same pages.
+  flush_scheduled_ = true;
+  Threads::IO()->PostTask([this] { Flush(); });
+}
+
+void ImageAtlas::Flush() {
+  TRACE_EVENT1("flutter", "ImageAtlas::Flush", "images",
+               static_cast<int>(pending_.size()));
+  flush_scheduled_ = false;
+  std::vector<PendingImage> images = std::move(pending_);
+  pending_.clear();
+
+  if (images.size() == 1) {
+    // Nothing to share a page with.
+    Callback callback = std::move(images.front().callback);
+    ImageUploadQueue::Get().Upload(
+        std::move(images.front().image), ImageUploadQueue::Priority::kNormal,
+        [callback](sk_sp<SkImage> uploaded) {
+          SkIRect rect = uploaded ? uploaded->bounds() : SkIRect::MakeEmpty();
+          callback({std::move(uploaded), rect});
+        });
+    return;
+  }
+
+  // Shelves pack tightest with the tallest images first.
+  std::stable_sort(images.begin(), images.end(),
+                   [](const PendingImage& a, const PendingImage& b) {
+                     return a.image->height() > b.image->height();
+                   });
+
+  std::vector<PendingImage> page_images;
+  std::vector<SkIPoint> origins;
+  int shelf_x = 0;
+  int shelf_y = 0;
+  int shelf_height = 0;
+  int page_width = 0;
+  for (PendingImage& pending : images) {
+    const int cell_width = pending.image->width() + 2 * kGutter;
+    const int cell_height = pending.image->height() + 2 * kGutter;
+    if (shelf_x + cell_width > kPageDimension) {
+      shelf_x = 0;
+      shelf_y += shelf_height;
+      shelf_height = 0;
+    }
+    if (shelf_y + cell_height > kPageDimension) {
+      UploadPage(std::move(page_images), std::move(origins),
+                 SkISize::Make(page_width, shelf_y));
+      page_images.clear();
+      origins.clear();
+      shelf_y = 0;
+      page_width = 0;
+    }
+    origins.push_back(SkIPoint::Make(shelf_x + kGutter, shelf_y + kGutter));
+    page_images.push_back(std::move(pending));
+    shelf_x += cell_width;
+    shelf_height = std::max(shelf_height, cell_height);
+    page_width = std::max(page_width, shelf_x);
+  }
+  UploadPage(std::move(page_images), std::move(origins),
+             SkISize::Make(page_width, shelf_y + shelf_height));
+}
+
+void ImageAtlas::UploadPage(std::vector<PendingImage> images,
+                            std::vector<SkIPoint> origins,
+                            SkISize size) {
+  TRACE_EVENT0("flutter", "ImageAtlas::UploadPage");
+  SkBitmap bitmap;
+  if (images.empty() ||
+      !bitmap.tryAllocN32Pixels(size.width(), size.height())) {
+    for (PendingImage& pending : images)
+      pending.callback({nullptr, SkIRect::MakeEmpty()});
+    return;
+  }
+  bitmap.eraseColor(SK_ColorTRANSPARENT);
+  {
+    SkCanvas canvas(bitmap);
+    SkPaint paint;
+    paint.setBlendMode(SkBlendMode::kSrc);
+    for (size_t i = 0; i < images.size(); i++)
+      DrawWithGutter(&canvas, images[i].image, origins[i], paint);
+  }
+  bitmap.setImmutable();
+
+  ImageUploadQueue::Get().Upload(
+      SkImage::MakeFromBitmap(bitmap), ImageUploadQueue::Priority::kNormal,
+      [images = std::move(images),
+       origins = std::move(origins)](sk_sp<SkImage> page) {
+        for (size_t i = 0; i < images.size(); i++) {
+          SkIRect rect = SkIRect::MakeXYWH(
+              origins[i].x(), origins[i].y(), images[i].image->width(),
+              images[i].image->height());
+          images[i].callback({page, page ? rect : SkIRect::MakeEmpty()});
+        }
+      });
+}
+
+}  // namespace blink
@@ -0,0 +1,68 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_IMAGE_ATLAS_H_
+#define FLUTTER_LIB_UI_PAINTING_IMAGE_ATLAS_H_
+
+#include <functional>
+#include <vector>
+
+#include "lib/fxl/macros.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkRect.h"
+
+namespace blink {
+
+// Packs small decoded images into shared pages, so that each page is uploaded
+// as a single texture and Skia can batch the draws of the images on it. The
+// images that arrive while the IO thread is busy are packed together. Only
+// accessed on the IO thread.
+class ImageAtlas {
+ public:
+  // Where a packed image lives on its page. Images packed alone cover their
+  // whole page.
+  struct Region {
+    sk_sp<SkImage> page;
+    SkIRect rect;
+  };
+
+  using Callback = std::function<void(Region)>;
+
+  static ImageAtlas& Get();
+
+  // Whether |image| is to be packed. Always false unless
+  // |Settings::enable_image_atlas| is set.
+  bool ShouldPack(const SkImage& image) const;
+
+  // Packs the raster |image| and invokes |callback| with its region on the IO
+  // thread once its page has been uploaded.
+  void Pack(sk_sp<SkImage> image, Callback callback);
+
+ private:
+  struct PendingImage {
+    sk_sp<SkImage> image;
+    Callback callback;
+  };
+
+  ImageAtlas();
+  ~ImageAtlas();
+
+  // Packs the pending images into pages and uploads them.
+  void Flush();
+
+  // Draws |images| at |origins| onto a new page and uploads it.
+  static void UploadPage(std::vector<PendingImage> images,
+                         std::vector<SkIPoint> origins,
+                         SkISize size);
+
+  const bool enabled_;
+  std::vector<PendingImage> pending_;
+  bool flush_scheduled_ = false;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(ImageAtlas);
+};
+
+}  // namespace blink
+
+#endif  // FLUTTER_LIB_UI_PAINTING_IMAGE_ATLAS_H_
@@ -0,0 +1,131 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/image_cache.h"
+
+#include <string.h>
+
+#include "flutter/lib/ui/painting/utils.h"
+
+namespace blink {
+namespace {
+
+// Enough for a screen of avatars and icons without holding on to full screen
+// photos for long.
+constexpr size_t kDefaultMaxBytes = 32 << 20;
+
+inline uint64_t Mix(uint64_t value) {
+  value ^= value >> 33;
+  value *= 0xff51afd7ed558ccdULL;
+  value ^= value >> 33;
+  return value;
+}
+
+}  // namespace
+
+ImageCache::ImageCache() : max_bytes_(kDefaultMaxBytes) {}
+
+ImageCache::~ImageCache() = default;
+
+uint64_t ImageCache::Hash(const void* data, size_t length) {
+  // Consumes a word at a time. Encoded images are large enough that a byte
+  // at a time hash would show up next to the copy of the bytes.
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  uint64_t hash = 0x9e3779b97f4a7c15ULL ^ length;
+  size_t offset = 0;
+  for (; offset + sizeof(uint64_t) <= length; offset += sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, bytes + offset, sizeof(word));
+    hash = (hash ^ Mix(word)) * 0x100000001b3ULL;
+  }
+  uint64_t tail = 0;
+  memcpy(&tail, bytes + offset, length - offset);
+  return Mix(hash ^ Mix(tail));
+}
+
+sk_sp<SkImage> ImageCache::Get(uint64_t hash,
+                               const void* data,
+                               size_t length,
+                               int target_width,
+                               int target_height) {
+  fxl::MutexLocker lock(&mutex_);
+  auto found = index_.find({hash, target_width, target_height});
+  if (found == index_.end())
+    return nullptr;
+
+  EntryList::iterator entry = found->second;
+  if (entry->encoded->size() != length ||
+      memcmp(entry->encoded->data(), data, length) != 0) {
+    return nullptr;
+  }
+
+  entries_.splice(entries_.begin(), entries_, entry);
+  return entry->image;
+}
+
+void ImageCache::Put(uint64_t hash,
+                     sk_sp<SkData> encoded,
+                     int target_width,
+                     int target_height,
+                     sk_sp<SkImage> image) {
+  if (!encoded || !image)
+    return;
+
+  const size_t byte_size = image->width() * image->height() * 4;
+  fxl::MutexLocker lock(&mutex_);
+  if (byte_size > max_bytes_)
+    return;
+
+  const Key key = {hash, target_width, target_height};
+  auto found = index_.find(key);
+  if (found != index_.end()) {
+    resident_bytes_ -= found->second->byte_size;
+    SkiaUnrefOnIOThread(&found->second->image);
+    entries_.erase(found->second);
+    index_.erase(found);
+  }
+
+  entries_.push_front({key, std::move(encoded), std::move(image), byte_size});
+  index_[key] = entries_.begin();
+  resident_bytes_ += byte_size;
+  EvictToBudget();
+}
+
+void ImageCache::SetMaxBytes(size_t max_bytes) {
+  fxl::MutexLocker lock(&mutex_);
+  max_bytes_ = max_bytes;
+  EvictToBudget();
+}
+
+size_t ImageCache::max_bytes() const {
+  fxl::MutexLocker lock(&mutex_);
+  return max_bytes_;
+}
+
+size_t ImageCache::resident_bytes() const {
+  fxl::MutexLocker lock(&mutex_);
+  return resident_bytes_;
+}
+
+void ImageCache::Clear() {
+  fxl::MutexLocker lock(&mutex_);
+  for (Entry& entry : entries_)
+    SkiaUnrefOnIOThread(&entry.image);
+  entries_.clear();
+  index_.clear();
+  resident_bytes_ = 0;
+}
+
+void ImageCache::EvictToBudget() {
+  while (resident_bytes_ > max_bytes_ && !entries_.empty()) {
+    Entry& entry = entries_.back();
+    resident_bytes_ -= entry.byte_size;
+    // Images may hold textures in the resource context.
+    SkiaUnrefOnIOThread(&entry.image);
+    index_.erase(entry.key);
+    entries_.pop_back();
+  }
+}
+
+}  // namespace blink
@@ -0,0 +1,99 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_IMAGE_CACHE_H_
+#define FLUTTER_LIB_UI_PAINTING_IMAGE_CACHE_H_
+
+#include <list>
+#include <unordered_map>
+
+#include "lib/fxl/macros.h"
+#include "lib/fxl/synchronization/mutex.h"
+#include "lib/fxl/synchronization/thread_annotations.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkImage.h"
+
+namespace blink {
+
+// Holds recently decoded images so that decoding the same encoded bytes again
+// at the same target size is free. Entries are evicted least recently used
+// first once the decoded images exceed the byte budget. Thread safe.
+class ImageCache {
+ public:
+  ImageCache();
+  ~ImageCache();
+
+  // Hashes encoded image bytes for use as a key.
+  static uint64_t Hash(const void* data, size_t length);
+
+  // Returns the image decoded from |data| at the given target size, or null.
+  // |hash| must be |Hash(data, length)|.
+  sk_sp<SkImage> Get(uint64_t hash,
+                     const void* data,
+                     size_t length,
+                     int target_width,
+                     int target_height);
+
+  void Put(uint64_t hash,
+           sk_sp<SkData> encoded,
+           int target_width,
+           int target_height,
+           sk_sp<SkImage> image);
+
+  // Sets the number of bytes decoded images may occupy. A budget of zero
+  // disables the cache.
+  void SetMaxBytes(size_t max_bytes);
+
+  size_t max_bytes() const;
+
+  // The number of bytes currently occupied by decoded images.
+  size_t resident_bytes() const;
+
+  void Clear();
+
+ private:
+  struct Key {
+    uint64_t hash;
+    int target_width;
+    int target_height;
+
+    bool operator==(const Key& other) const {
+      return hash == other.hash && target_width == other.target_width &&
+             target_height == other.target_height;
+    }
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const {
+      return key.hash ^ (static_cast<uint64_t>(key.target_width) << 32) ^
+             static_cast<uint64_t>(key.target_height);
+    }
+  };
+
+  struct Entry {
+    Key key;
+    // Kept to rule out hash collisions.
+    sk_sp<SkData> encoded;
+    sk_sp<SkImage> image;
+    size_t byte_size;
+  };
+
+  using EntryList = std::list<Entry>;
+
+  void EvictToBudget() FXL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  mutable fxl::Mutex mutex_;
+  size_t max_bytes_ FXL_GUARDED_BY(mutex_);
+  size_t resident_bytes_ FXL_GUARDED_BY(mutex_) = 0;
+  // Most recently used first.
+  EntryList entries_ FXL_GUARDED_BY(mutex_);
+  std::unordered_map<Key, EntryList::iterator, KeyHash> index_
+      FXL_GUARDED_BY(mutex_);
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(ImageCache);
+};
+
+}  // namespace blink
+
+#endif  // FLUTTER_LIB_UI_PAINTING_IMAGE_CACHE_H_
@@ -4,9 +4,17 @@
 
 #include "flutter/lib/ui/painting/image_decoding.h"
 
+#include <algorithm>
+#include <cmath>
+#include <map>
+
 #include "flutter/common/threads.h"
 #include "flutter/glue/trace_event.h"
+#include "flutter/lib/ui/painting/hardware_image_allocator.h"
 #include "flutter/lib/ui/painting/image.h"
+#include "flutter/lib/ui/painting/image_atlas.h"
+#include "flutter/lib/ui/painting/image_cache.h"
+#include "flutter/lib/ui/painting/image_upload_queue.h"
 #include "flutter/lib/ui/painting/resource_context.h"
 #include "lib/fxl/build_config.h"
 #include "lib/fxl/functional/make_copyable.h"
@@ -14,6 +22,8 @@
 #include "lib/tonic/dart_state.h"
 #include "lib/tonic/logging/dart_invoke.h"
 #include "lib/tonic/typed_data/uint8_list.h"
+#include "third_party/skia/include/codec/SkCodec.h"
+#include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkImageGenerator.h"
 
 using tonic::DartInvoke;
@@ -25,26 +35,181 @@ namespace {
 
 static constexpr const char* kDecodeImageTraceTag = "DecodeImage";
 
-sk_sp<SkImage> DecodeImage(sk_sp<SkData> buffer, size_t trace_id) {
+// The size to decode an image at. Zero dimensions are unconstrained.
+struct TargetSize {
+  int width = 0;
+  int height = 0;
+
+  bool IsSet() const { return width > 0 || height > 0; }
+};
+
+// Images smaller than this are uploaded as usual. Hardware buffers have a
+// fixed cost that small uploads do not make up for.
+constexpr int kMinHardwareBufferPixels = 256 * 256;
+
+// Decoded images are handed to the IO thread in one of two forms.
+struct DecodedImage {
+  // Pixels in CPU memory that still need to be uploaded.
+  sk_sp<SkImage> raster;
+  // Pixels the GPU can sample from directly.
+  std::unique_ptr<HardwareImageAllocator::Buffer> hardware_buffer;
+  SkAlphaType alpha_type = kPremul_SkAlphaType;
+};
+
+// The scale at which an image just covers |target_size|. Never above one.
+float GetDecodeScale(const SkImageInfo& info, TargetSize target_size) {
+  float scale = 0.0f;
+  if (target_size.width > 0) {
+    scale = std::max(scale, static_cast<float>(target_size.width) /
+                                info.width());
+  }
+  if (target_size.height > 0) {
+    scale = std::max(scale, static_cast<float>(target_size.height) /
+                                info.height());
+  }
+  return target_size.IsSet() ? std::min(scale, 1.0f) : 1.0f;
+}
+
+SkAlphaType GetDecodeAlphaType(const SkImageInfo& info) {
+  return info.alphaType() == kOpaque_SkAlphaType ? kOpaque_SkAlphaType
+                                                 : kPremul_SkAlphaType;
+}
+
+// Decodes |buffer| straight into a buffer from the platform's hardware image
+// allocator, if there is one. Returns false if the image is better off taking
+// the raster path.
+bool DecodeIntoHardwareBuffer(const sk_sp<SkData>& buffer,
+                              TargetSize target_size,
+                              DecodedImage* decoded) {
+  HardwareImageAllocator* allocator = HardwareImageAllocator::Get();
+  if (!allocator || !ResourceContext::Get()) {
+    return false;
+  }
+
+  std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(buffer);
+  if (!codec) {
+    return false;
+  }
+
+  const SkImageInfo& info = codec->getInfo();
+  const float scale = GetDecodeScale(info, target_size);
+  const SkISize decode_size = codec->getScaledDimensions(scale);
+  // Sizes the codec cannot reach by itself need a resampling pass, which the
+  // raster path does.
+  if (decode_size.width() !=
+          std::max(1, static_cast<int>(std::round(info.width() * scale))) ||
+      decode_size.height() !=
+          std::max(1, static_cast<int>(std::round(info.height() * scale))) ||
+      decode_size.width() * decode_size.height() < kMinHardwareBufferPixels) {
+    return false;
+  }
+
+  std::unique_ptr<HardwareImageAllocator::Buffer> hardware_buffer =
+      allocator->Allocate(decode_size.width(), decode_size.height());
+  if (!hardware_buffer) {
+    return false;
+  }
+
+  const SkAlphaType alpha_type = GetDecodeAlphaType(info);
+  const SkImageInfo decode_info =
+      info.makeWH(decode_size.width(), decode_size.height())
+          .makeColorType(allocator->color_type())
+          .makeAlphaType(alpha_type);
+  SkCodec::Result result =
+      codec->getPixels(decode_info, hardware_buffer->pixels(),
+                       hardware_buffer->row_bytes());
+  if (result != SkCodec::kSuccess && result != SkCodec::kIncompleteInput) {
+    return false;
+  }
+
+  decoded->hardware_buffer = std::move(hardware_buffer);
+  decoded->alpha_type = alpha_type;
+  return true;
+}
+
+// Decodes |buffer| into CPU memory at roughly |target_size|. Lets the codec
+// subsample where it can, which is much cheaper than decoding at the intrinsic
+// size, and scales the rest of the way down.
+sk_sp<SkImage> DecodeImageAtTargetSize(sk_sp<SkData> buffer,
+                                       TargetSize target_size) {
+  std::unique_ptr<SkCodec> codec = SkCodec::MakeFromData(std::move(buffer));
+  if (!codec) {
+    return nullptr;
+  }
+
+  const SkImageInfo& info = codec->getInfo();
+  const float scale = GetDecodeScale(info, target_size);
+  const SkISize decode_size = codec->getScaledDimensions(scale);
+  const SkAlphaType alpha_type = GetDecodeAlphaType(info);
+  SkImageInfo decode_info =
+      info.makeWH(decode_size.width(), decode_size.height())
+          .makeColorType(kN32_SkColorType)
+          .makeAlphaType(alpha_type);
+
+  SkBitmap bitmap;
+  if (!bitmap.tryAllocPixels(decode_info)) {
+    return nullptr;
+  }
+  SkCodec::Result result = codec->getPixels(bitmap.pixmap());
+  if (result != SkCodec::kSuccess && result != SkCodec::kIncompleteInput) {
+    return nullptr;
+  }
+
+  // Codecs only subsample by some factors. Finish the job if they fell short.
+  const int width =
+      std::max(1, static_cast<int>(std::round(info.width() * scale)));
+  const int height =
+      std::max(1, static_cast<int>(std::round(info.height() * scale)));
+  if (width < decode_size.width() || height < decode_size.height()) {
+    SkBitmap scaled;
+    if (!scaled.tryAllocPixels(decode_info.makeWH(width, height)) ||
+        !bitmap.pixmap().scalePixels(scaled.pixmap(),
+                                     kMedium_SkFilterQuality)) {
+      return nullptr;
+    }
+    bitmap = scaled;
+  }
+
+  bitmap.setImmutable();
+  return SkImage::MakeFromBitmap(bitmap);
+}
+
+// Decodes |buffer| without touching the resource context, so it may run on
+// any thread. Images that |build_mips| are never decoded into hardware
+// buffers, which have no mipmaps.
+DecodedImage DecodeImageForUpload(sk_sp<SkData> buffer,
+                                  TargetSize target_size,
+                                  bool build_mips,
+                                  size_t trace_id) {
   TRACE_FLOW_STEP("flutter", kDecodeImageTraceTag, trace_id);
-  TRACE_EVENT0("blink", "DecodeImage");
+  TRACE_EVENT0("blink", "DecodeImageForUpload");
 
+  DecodedImage decoded;
   if (buffer == nullptr || buffer->isEmpty()) {
-    return nullptr;
+    return decoded;
   }
 
-  GrContext* context = ResourceContext::Get();
-  if (context) {
-    // This acts as a flag to indicate that we want a color space aware decode.
-    sk_sp<SkColorSpace> dstColorSpace = SkColorSpace::MakeSRGB();
-    return SkImage::MakeCrossContextFromEncoded(context, std::move(buffer),
-                                                false, dstColorSpace.get());
-  } else {
-    return SkImage::MakeFromEncoded(std::move(buffer));
+  if (!build_mips &&
+      DecodeIntoHardwareBuffer(buffer, target_size, &decoded)) {
+    return decoded;
+  }
+
+  if (target_size.IsSet()) {
+    decoded.raster = DecodeImageAtTargetSize(std::move(buffer), target_size);
+    return decoded;
   }
+
+  sk_sp<SkImage> image = SkImage::MakeFromEncoded(std::move(buffer));
+  // Images made from encoded data decode lazily. Force the decode here so
+  // that it does not happen later on whichever thread draws the image.
+  decoded.raster = image ? image->makeRasterImage() : nullptr;
+  return decoded;
 }
 
+// A non-empty |atlas_rect| is the region of the atlas page |image| the
+// decoded image was packed into.
 void InvokeImageCallback(sk_sp<SkImage> image,
+                         const SkIRect& atlas_rect,
                          std::unique_ptr<DartPersistentValue> callback,
                          size_t trace_id) {
   tonic::DartState* dart_state = callback->dart_state().get();
@@ -57,20 +222,223 @@ void InvokeImageCallback(sk_sp<SkImage> image,
     DartInvoke(callback->value(), {Dart_Null()});
   } else {
     fxl::RefPtr<CanvasImage> resultImage = CanvasImage::Create();
-    resultImage->set_image(std::move(image));
+    if (atlas_rect.isEmpty()) {
+      resultImage->set_image(std::move(image));
+    } else {
+      resultImage->set_atlas_region(std::move(image), atlas_rect);
+    }
     DartInvoke(callback->value(), {ToDart(resultImage)});
   }
   TRACE_FLOW_END("flutter", kDecodeImageTraceTag, trace_id);
 }
 
-void DecodeImageAndInvokeImageCallback(
+// Identifies a call to decodeImageFromList as it moves between threads.
+struct DecodeRequest {
+  size_t id;
+  uint64_t hash;
+  TargetSize target_size;
+  // Whether the mipmaps of the texture are built when it is uploaded.
+  bool build_mips;
+  size_t trace_id;
+};
+
+// Decodes finish out of order on the decoder pool. Callbacks are held on the
+// UI thread until every earlier request has been answered so that they still
+// run in request order. Only accessed on the UI thread.
+size_t g_next_request = 0;
+size_t g_next_callback = 0;
+std::map<size_t, fxl::Closure>* g_pending_callbacks = nullptr;
+
+ImageCache& GetImageCache() {
+  static ImageCache* cache = new ImageCache();
+  return *cache;
+}
+
+void InvokeImageCallbackInOrder(const DecodeRequest& request,
+                                sk_sp<SkImage> image,
+                                const SkIRect& atlas_rect,
+                                std::unique_ptr<DartPersistentValue> callback) {
+  if (!g_pending_callbacks)
+    g_pending_callbacks = new std::map<size_t, fxl::Closure>();
+  (*g_pending_callbacks)[request.id] = fxl::MakeCopyable([
+    image = std::move(image), atlas_rect, callback = std::move(callback),
+    trace_id = request.trace_id
+  ]() mutable {
+    InvokeImageCallback(image, atlas_rect, std::move(callback), trace_id);
+  });
+
+  auto it = g_pending_callbacks->begin();
+  while (it != g_pending_callbacks->end() && it->first == g_next_callback) {
+    fxl::Closure closure = std::move(it->second);
+    g_pending_callbacks->erase(it);
+    g_next_callback++;
+    closure();
+    it = g_pending_callbacks->begin();
+  }
+}
+
+// Called on the UI thread once |buffer| has been decoded to |image|, or to
+// |atlas_rect| of it if that is not empty.
+void CompleteDecode(const DecodeRequest& request,
+                    sk_sp<SkData> buffer,
+                    sk_sp<SkImage> image,
+                    const SkIRect& atlas_rect,
+                    std::unique_ptr<DartPersistentValue> callback) {
+  // Caching a packed image would charge the cache for its whole page.
+  if (atlas_rect.isEmpty()) {
+    GetImageCache().Put(request.hash, std::move(buffer),
+                        request.target_size.width, request.target_size.height,
+                        image);
+  }
+  InvokeImageCallbackInOrder(request, std::move(image), atlas_rect,
+                             std::move(callback));
+}
+
+// Hashes |buffer| into |request| and answers the request from the image cache
+// if it can. Runs on the decoder threads, so that the UI thread never touches
+// every byte of the image.
+bool AnswerFromCache(DecodeRequest* request,
+                     std::unique_ptr<DartPersistentValue>* callback,
+                     const sk_sp<SkData>& buffer) {
+  request->hash = ImageCache::Hash(buffer->data(), buffer->size());
+  sk_sp<SkImage> cached = GetImageCache().Get(
+      request->hash, buffer->data(), buffer->size(),
+      request->target_size.width, request->target_size.height);
+  if (!cached)
+    return false;
+
+  Threads::UI()->PostTask(fxl::MakeCopyable([
+    request = *request, callback = std::move(*callback), cached
+  ]() mutable {
+    InvokeImageCallbackInOrder(request, cached, SkIRect::MakeEmpty(),
+                               std::move(callback));
+  }));
+  return true;
+}
+
+// Queues the upload of an image decoded by |DecodeImageForUpload|. Must be
+// called on the IO thread.
+void UploadImageAndInvokeImageCallback(
+    const DecodeRequest& request,
     std::unique_ptr<DartPersistentValue> callback,
     sk_sp<SkData> buffer,
-    size_t trace_id) {
-  sk_sp<SkImage> image = DecodeImage(std::move(buffer), trace_id);
-  Threads::UI()->PostTask(fxl::MakeCopyable([
-    callback = std::move(callback), image, trace_id
-  ]() mutable { InvokeImageCallback(image, std::move(callback), trace_id); }));
+    DecodedImage decoded) {
+  TRACE_FLOW_STEP("flutter", kDecodeImageTraceTag, request.trace_id);
+  if (decoded.hardware_buffer) {
+    // Nothing to copy, so there is no need to wait for the upload queue.
+    sk_sp<SkImage> image = decoded.hardware_buffer->MakeImage(
+        ResourceContext::Get(), decoded.alpha_type);
+    Threads::UI()->PostTask(fxl::MakeCopyable([
+      request, callback = std::move(callback), buffer = std::move(buffer),
+      image
+    ]() mutable {
+      CompleteDecode(request, std::move(buffer), image, SkIRect::MakeEmpty(),
+                     std::move(callback));
+    }));
+    return;
+  }
+
+  // Mipmaps of a page would blend the images packed next to each other.
+  if (decoded.raster && !request.build_mips &&
+      ImageAtlas::Get().ShouldPack(*decoded.raster)) {
+    ImageAtlas::Get().Pack(
+        std::move(decoded.raster), fxl::MakeCopyable([
+          request, callback = std::move(callback), buffer = std::move(buffer)
+        ](ImageAtlas::Region region) mutable {
+          // Images packed alone are uploaded as they are.
+          SkIRect atlas_rect =
+              region.page && region.rect != region.page->bounds()
+                  ? region.rect
+                  : SkIRect::MakeEmpty();
+          Threads::UI()->PostTask(fxl::MakeCopyable([
+            request, callback = std::move(callback),
+            buffer = std::move(buffer), page = std::move(region.page),
+            atlas_rect
+          ]() mutable {
+            CompleteDecode(request, std::move(buffer), page, atlas_rect,
+                           std::move(callback));
+          }));
+        }));
+    return;
+  }
+
+  auto on_uploaded = fxl::MakeCopyable([
+    request, callback = std::move(callback), buffer = std::move(buffer)
+  ](sk_sp<SkImage> uploaded) mutable {
+    Threads::UI()->PostTask(fxl::MakeCopyable([
+      request, callback = std::move(callback), buffer = std::move(buffer),
+      uploaded
+    ]() mutable {
+      CompleteDecode(request, std::move(buffer), uploaded, SkIRect::MakeEmpty(),
+                     std::move(callback));
+    }));
+  });
+  if (request.build_mips) {
+    ImageUploadQueue::Get().UploadWithMipmaps(
+        std::move(decoded.raster), ImageUploadQueue::Priority::kNormal,
+        std::move(on_uploaded));
+  } else {
+    ImageUploadQueue::Get().Upload(std::move(decoded.raster),
+                                   ImageUploadQueue::Priority::kNormal,
+                                   std::move(on_uploaded));
+  }
+}
+
+// Decodes and uploads on the IO thread.
+void DecodeImageAndInvokeImageCallback(
+    DecodeRequest request,
+    std::unique_ptr<DartPersistentValue> callback,
+    sk_sp<SkData> buffer) {
+  if (AnswerFromCache(&request, &callback, buffer))
+    return;
+
+  DecodedImage decoded = DecodeImageForUpload(
+      buffer, request.target_size, request.build_mips, request.trace_id);
+  UploadImageAndInvokeImageCallback(request, std::move(callback),
+                                    std::move(buffer), std::move(decoded));
+}
+
+// Decodes on the worker pool, where decodes run in parallel, and then uploads
+// on the IO thread, which owns the resource context.
+void DecodeOnWorkerAndInvokeImageCallback(
+    DecodeRequest request,
+    std::unique_ptr<DartPersistentValue> callback,
+    sk_sp<SkData> buffer) {
+  if (AnswerFromCache(&request, &callback, buffer))
+    return;
+
+  DecodedImage decoded = DecodeImageForUpload(
+      buffer, request.target_size, request.build_mips, request.trace_id);
+  Threads::IO()->PostTask(fxl::MakeCopyable([
+    request, callback = std::move(callback), buffer = std::move(buffer),
+    decoded = std::move(decoded)
+  ]() mutable {
+    UploadImageAndInvokeImageCallback(request, std::move(callback),
+                                      std::move(buffer), std::move(decoded));
+  }));
+}
+
+void ReleaseExternalList(const void* ptr, void* context) {
+  // Persistent handles may only be deleted on the UI thread.
+  auto* list = static_cast<DartPersistentValue*>(context);
+  Threads::UI()->PostTask([list] { delete list; });
+}
+
+// Wraps the bytes of |list_handle| without copying them if they live outside
+// the Dart heap, where the garbage collector never moves them. Such lists, for
+// example the ones backing large platform messages, are kept alive until the
+// decoders are done with them. Returns null for lists on the Dart heap.
+sk_sp<SkData> WrapExternalList(Dart_Handle list_handle,
+                               const uint8_t* data,
+                               size_t length) {
+  if (Dart_GetTypeOfExternalTypedData(list_handle) ==
+      Dart_TypedData_kInvalid) {
+    return nullptr;
+  }
+
+  auto* list =
+      new DartPersistentValue(tonic::DartState::Current(), list_handle);
+  return SkData::MakeWithProc(data, length, &ReleaseExternalList, list);
 }
 
 void DecodeImageFromList(Dart_NativeArguments args) {
@@ -95,23 +463,79 @@ void DecodeImageFromList(Dart_NativeArguments args) {
     return;
   }
 
-  auto buffer = SkData::MakeWithCopy(list.data(), list.num_elements());
+  TargetSize target_size;
+  target_size.width =
+      tonic::DartConverter<int>::FromArguments(args, 2, exception);
+  if (!exception) {
+    target_size.height =
+        tonic::DartConverter<int>::FromArguments(args, 3, exception);
+  }
+  bool build_mips = false;
+  if (!exception) {
+    build_mips = tonic::DartConverter<bool>::FromArguments(args, 4, exception);
+  }
+  if (exception) {
+    TRACE_FLOW_END("flutter", kDecodeImageTraceTag, trace_id);
+    Dart_ThrowException(exception);
+    return;
+  }
+
+  DecodeRequest request;
+  request.id = g_next_request++;
+  request.hash = 0;
+  request.target_size = target_size;
+  request.build_mips = build_mips;
+  request.trace_id = trace_id;
+
+  auto callback = std::make_unique<DartPersistentValue>(
+      tonic::DartState::Current(), callback_handle);
+
+  sk_sp<SkData> buffer = WrapExternalList(Dart_GetNativeArgument(args, 0),
+                                          list.data(), list.num_elements());
+  if (!buffer) {
+    buffer = SkData::MakeWithCopy(list.data(), list.num_elements());
+  }
+
+  if (Threads::Worker()) {
+    Threads::Worker()->PostTask(fxl::MakeCopyable([
+      request, callback = std::move(callback), buffer = std::move(buffer)
+    ]() mutable {
+      DecodeOnWorkerAndInvokeImageCallback(request, std::move(callback),
+                                           std::move(buffer));
+    }));
+    return;
+  }
 
   Threads::IO()->PostTask(fxl::MakeCopyable([
-    callback = std::make_unique<DartPersistentValue>(
-        tonic::DartState::Current(), callback_handle),
-    buffer = std::move(buffer), trace_id
+    request, callback = std::move(callback), buffer = std::move(buffer)
   ]() mutable {
-    DecodeImageAndInvokeImageCallback(std::move(callback), std::move(buffer),
-                                      trace_id);
+    DecodeImageAndInvokeImageCallback(request, std::move(callback),
+                                      std::move(buffer));
   }));
 }
 
 }  // namespace
 
+sk_sp<SkImage> ImageDecoding::UploadToResourceContext(sk_sp<SkImage> image,
+                                                      bool build_mips) {
+  TRACE_EVENT0("blink", "UploadImage");
+
+  GrContext* context = ResourceContext::Get();
+  SkPixmap pixmap;
+  if (!image || !context || !image->peekPixels(&pixmap)) {
+    return image;
+  }
+
+  return SkImage::MakeCrossContextFromPixmap(context, pixmap, build_mips);
+}
+
+void ImageDecoding::ClearImageCache() {
+  GetImageCache().Clear();
+}
+
 void ImageDecoding::RegisterNatives(tonic::DartLibraryNatives* natives) {
   natives->Register({
-      {"decodeImageFromList", DecodeImageFromList, 2, true},
+      {"decodeImageFromList", DecodeImageFromList, 5, true},
   });
 }
 
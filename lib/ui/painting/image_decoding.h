@@ -6,12 +6,22 @@
 #define FLUTTER_LIB_UI_PAINTING_IMAGE_DECODING_H_
 
 #include "lib/tonic/dart_library_natives.h"
+#include "third_party/skia/include/core/SkImage.h"
 
 namespace blink {
 
 class ImageDecoding {
  public:
   static void RegisterNatives(tonic::DartLibraryNatives* natives);
+
+  // Uploads a raster image to the resource context, if there is one, along
+  // with its mipmaps if |build_mips| is set. Returns |image| unchanged
+  // otherwise. Must be called on the IO thread.
+  static sk_sp<SkImage> UploadToResourceContext(sk_sp<SkImage> image,
+                                                bool build_mips);
+
+  // Drops the decoded images kept for reuse by decodeImageFromList.
+  static void ClearImageCache();
 };
 
 }  // namespace blink
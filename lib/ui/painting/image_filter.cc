@@ -37,7 +37,7 @@ fxl::RefPtr<ImageFilter> ImageFilter::Create() {
   return fxl::MakeRefCounted<ImageFilter>();
 }
 
-ImageFilter::ImageFilter() {}
+ImageFilter::ImageFilter() : blur_sigma_(SkVector::Make(0, 0)) {}
 
 ImageFilter::~ImageFilter() {}
 
@@ -51,6 +51,7 @@ void ImageFilter::initPicture(Picture* picture) {
 
 void ImageFilter::initBlur(double sigma_x, double sigma_y) {
   filter_ = SkBlurImageFilter::Make(sigma_x, sigma_y, nullptr);
+  blur_sigma_ = SkVector::Make(sigma_x, sigma_y);
 }
 
 }  // namespace blink
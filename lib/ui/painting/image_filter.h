@@ -9,6 +9,7 @@
 #include "flutter/lib/ui/painting/picture.h"
 #include "lib/tonic/dart_wrappable.h"
 #include "third_party/skia/include/core/SkImageFilter.h"
+#include "third_party/skia/include/core/SkPoint.h"
 
 namespace blink {
 
@@ -27,12 +28,16 @@ class ImageFilter : public fxl::RefCountedThreadSafe<ImageFilter>,
 
   const sk_sp<SkImageFilter>& filter() { return filter_; }
 
+  // The sigmas of the filter if it is a Gaussian blur. Zero otherwise.
+  const SkVector& blur_sigma() const { return blur_sigma_; }
+
   static void RegisterNatives(tonic::DartLibraryNatives* natives);
 
  private:
   ImageFilter();
 
   sk_sp<SkImageFilter> filter_;
+  SkVector blur_sigma_;
 };
 
 }  // namespace blink
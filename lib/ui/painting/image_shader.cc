@@ -4,6 +4,7 @@
 
 #include "flutter/lib/ui/painting/image_shader.h"
 
+#include "flutter/lib/ui/painting/shader_cache.h"
 #include "lib/tonic/converter/dart_converter.h"
 #include "lib/tonic/dart_args.h"
 #include "lib/tonic/dart_binding_macros.h"
@@ -41,7 +42,20 @@ void ImageShader::initWithImage(CanvasImage* image,
     Dart_ThrowException(
         ToDart("ImageShader constructor called with non-genuine Image."));
   SkMatrix sk_matrix = ToSkMatrix(matrix4);
-  set_shader(image->image()->makeShader(tmx, tmy, &sk_matrix));
+  const sk_sp<SkImage>& sk_image = image->image();
+
+  // Images are identified by their unique ID, the shader keeps the image
+  // alive so that the ID is not reused while the entry exists.
+  std::string key(1, 'i');
+  const uint32_t image_id = sk_image->uniqueID();
+  SkScalar matrix_values[9];
+  sk_matrix.get9(matrix_values);
+  ShaderCache::AppendToKey(&key, &image_id, sizeof(image_id));
+  ShaderCache::AppendToKey(&key, &tmx, sizeof(tmx));
+  ShaderCache::AppendToKey(&key, &tmy, sizeof(tmy));
+  ShaderCache::AppendToKey(&key, matrix_values, sizeof(matrix_values));
+  set_shader(ShaderCache::Shared().Get(
+      key, [&] { return sk_image->makeShader(tmx, tmy, &sk_matrix); }));
 }
 
 ImageShader::ImageShader() : Shader(nullptr) {}
@@ -0,0 +1,100 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/image_upload_queue.h"
+
+#include "flutter/common/settings.h"
+#include "flutter/common/threads.h"
+#include "flutter/glue/trace_event.h"
+#include "flutter/lib/ui/painting/image_decoding.h"
+#include "flutter/lib/ui/painting/resource_context.h"
+
+namespace blink {
+namespace {
+
+constexpr fxl::TimeDelta kInterval = fxl::TimeDelta::FromMicroseconds(16667);
+
+size_t GetUploadBytes(const sk_sp<SkImage>& image, bool build_mips) {
+  if (!image)
+    return 0;
+  const size_t bytes = image->width() * image->height() * 4;
+  // The mipmap levels add up to a third of the base level.
+  return build_mips ? bytes + bytes / 3 : bytes;
+}
+
+}  // namespace
+
+ImageUploadQueue& ImageUploadQueue::Get() {
+  static ImageUploadQueue* queue = new ImageUploadQueue();
+  return *queue;
+}
+
+ImageUploadQueue::ImageUploadQueue()
+    : max_bytes_per_interval_(
+          Settings::Get().image_upload_max_bytes_per_frame) {}
+
+ImageUploadQueue::~ImageUploadQueue() = default;
+
+void ImageUploadQueue::Upload(sk_sp<SkImage> image,
+                              Priority priority,
+                              Callback callback) {
+  Enqueue(std::move(image), priority, false, std::move(callback));
+}
+
+void ImageUploadQueue::UploadWithMipmaps(sk_sp<SkImage> image,
+                                         Priority priority,
+                                         Callback callback) {
+  Enqueue(std::move(image), priority, true, std::move(callback));
+}
+
+void ImageUploadQueue::Enqueue(sk_sp<SkImage> image,
+                               Priority priority,
+                               bool build_mips,
+                               Callback callback) {
+  if (!ResourceContext::Get()) {
+    // Nothing to upload to.
+    callback(std::move(image));
+    return;
+  }
+
+  pending_[static_cast<size_t>(priority)].push_back(
+      {std::move(image), build_mips, std::move(callback)});
+  if (!drain_scheduled_)
+    Drain();
+}
+
+void ImageUploadQueue::Drain() {
+  drain_scheduled_ = false;
+
+  const fxl::TimePoint now = fxl::TimePoint::Now();
+  if (now - interval_start_ >= kInterval) {
+    interval_start_ = now;
+    interval_bytes_ = 0;
+  }
+
+  for (auto& queue : pending_) {
+    while (!queue.empty()) {
+      const size_t bytes =
+          GetUploadBytes(queue.front().image, queue.front().build_mips);
+      // At least one upload goes through per interval so that images larger
+      // than the budget still make progress.
+      if (max_bytes_per_interval_ > 0 && interval_bytes_ > 0 &&
+          interval_bytes_ + bytes > max_bytes_per_interval_) {
+        TRACE_EVENT0("flutter", "ImageUploadQueue::Throttled");
+        drain_scheduled_ = true;
+        Threads::IO()->PostDelayedTask([this] { Drain(); },
+                                       interval_start_ + kInterval - now);
+        return;
+      }
+
+      PendingUpload upload = std::move(queue.front());
+      queue.pop_front();
+      interval_bytes_ += bytes;
+      upload.callback(ImageDecoding::UploadToResourceContext(
+          std::move(upload.image), upload.build_mips));
+    }
+  }
+}
+
+}  // namespace blink
@@ -0,0 +1,75 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_IMAGE_UPLOAD_QUEUE_H_
+#define FLUTTER_LIB_UI_PAINTING_IMAGE_UPLOAD_QUEUE_H_
+
+#include <deque>
+#include <functional>
+
+#include "lib/fxl/macros.h"
+#include "lib/fxl/time/time_point.h"
+#include "third_party/skia/include/core/SkImage.h"
+
+namespace blink {
+
+// Spreads texture uploads to the resource context over frame intervals. On
+// drivers that serialize the resource context with the GPU thread's context, a
+// burst of large uploads would otherwise stall rasterization. Only accessed on
+// the IO thread.
+class ImageUploadQueue {
+ public:
+  enum class Priority {
+    // Frames of running animations, which are shown as soon as they arrive.
+    kHigh,
+    // Images that have just been decoded.
+    kNormal,
+  };
+
+  using Callback = std::function<void(sk_sp<SkImage>)>;
+
+  static ImageUploadQueue& Get();
+
+  // Uploads the raster |image| and invokes |callback| with the result on the
+  // IO thread. Runs right away if the current interval's budget allows it.
+  void Upload(sk_sp<SkImage> image, Priority priority, Callback callback);
+
+  // Like |Upload|, but also builds the mipmaps of the texture, so that Skia
+  // does not build them on the GPU thread when the image is first drawn
+  // downscaled.
+  void UploadWithMipmaps(sk_sp<SkImage> image,
+                         Priority priority,
+                         Callback callback);
+
+ private:
+  struct PendingUpload {
+    sk_sp<SkImage> image;
+    bool build_mips;
+    Callback callback;
+  };
+
+  ImageUploadQueue();
+  ~ImageUploadQueue();
+
+  void Enqueue(sk_sp<SkImage> image,
+               Priority priority,
+               bool build_mips,
+               Callback callback);
+
+  void Drain();
+
+  static constexpr size_t kPriorityCount = 2;
+
+  const size_t max_bytes_per_interval_;
+  std::deque<PendingUpload> pending_[kPriorityCount];
+  fxl::TimePoint interval_start_;
+  size_t interval_bytes_ = 0;
+  bool drain_scheduled_ = false;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(ImageUploadQueue);
+};
+
+}  // namespace blink
+
+#endif  // FLUTTER_LIB_UI_PAINTING_IMAGE_UPLOAD_QUEUE_H_
@@ -4,6 +4,9 @@
 
 #include "flutter/lib/ui/painting/paint.h"
 
+#include <string.h>
+
+#include "flutter/lib/ui/painting/canvas.h"
 #include "flutter/lib/ui/painting/mask_filter.h"
 #include "flutter/lib/ui/painting/shader.h"
 #include "lib/fxl/logging.h"
@@ -13,9 +16,8 @@
 #include "third_party/skia/include/core/SkShader.h"
 #include "third_party/skia/include/core/SkString.h"
 
-using namespace blink;
-
-namespace tonic {
+namespace blink {
+namespace {
 
 constexpr int kIsAntiAliasIndex = 0;
 constexpr int kColorIndex = 1;
@@ -29,7 +31,6 @@ constexpr int kFilterQualityIndex = 8;
 constexpr int kColorFilterIndex = 9;
 constexpr int kColorFilterColorIndex = 10;
 constexpr int kColorFilterBlendModeIndex = 11;
-constexpr size_t kDataByteCount = 48;
 
 constexpr int kMaskFilterIndex = 0;
 constexpr int kShaderIndex = 1;
@@ -46,90 +47,156 @@ constexpr uint32_t kBlendModeDefault =
 // default SkPaintDefaults_MiterLimit in Skia (which is not in a public header).
 constexpr double kStrokeMiterLimitDefault = 4.0;
 
-Paint DartConverter<Paint>::FromArguments(Dart_NativeArguments args,
-                                          int index,
-                                          Dart_Handle& exception) {
-  Dart_Handle paint_objects = Dart_GetNativeArgument(args, index);
-  FXL_DCHECK(!LogIfError(paint_objects));
-
-  Dart_Handle paint_data = Dart_GetNativeArgument(args, index + 1);
-  FXL_DCHECK(!LogIfError(paint_data));
-
-  Paint result;
-  SkPaint& paint = result.paint_;
-
-  if (!Dart_IsNull(paint_objects)) {
-    FXL_DCHECK(Dart_IsList(paint_objects));
-    intptr_t length = 0;
-    Dart_ListLength(paint_objects, &length);
-
-    FXL_CHECK(length == kObjectCount);
-    Dart_Handle values[kObjectCount];
-    if (Dart_IsError(Dart_ListGetRange(paint_objects, 0, kObjectCount, values)))
-      return result;
-
-    Dart_Handle mask_filter = values[kMaskFilterIndex];
-    if (!Dart_IsNull(mask_filter)) {
-      MaskFilter* decoded = DartConverter<MaskFilter*>::FromDart(mask_filter);
-      paint.setMaskFilter(decoded->filter());
-    }
+}  // namespace
 
-    Dart_Handle shader = values[kShaderIndex];
-    if (!Dart_IsNull(shader)) {
-      Shader* decoded = DartConverter<Shader*>::FromDart(shader);
-      paint.setShader(decoded->shader());
-    }
-  }
+constexpr size_t Paint::kDataByteCount;
 
-  tonic::DartByteData byte_data(paint_data);
-  FXL_CHECK(byte_data.length_in_bytes() == kDataByteCount);
+void Paint::DecodeData(const void* data, SkPaint* paint) {
+  const uint32_t* uint_data = static_cast<const uint32_t*>(data);
+  const float* float_data = static_cast<const float*>(data);
 
-  const uint32_t* uint_data = static_cast<const uint32_t*>(byte_data.data());
-  const float* float_data = static_cast<const float*>(byte_data.data());
-
-  paint.setAntiAlias(uint_data[kIsAntiAliasIndex] == 0);
+  paint->setAntiAlias(uint_data[kIsAntiAliasIndex] == 0);
 
   uint32_t encoded_color = uint_data[kColorIndex];
   if (encoded_color) {
     SkColor color = encoded_color ^ kColorDefault;
-    paint.setColor(color);
+    paint->setColor(color);
   }
 
   uint32_t encoded_blend_mode = uint_data[kBlendModeIndex];
   if (encoded_blend_mode) {
     uint32_t blend_mode = encoded_blend_mode ^ kBlendModeDefault;
-    paint.setBlendMode(static_cast<SkBlendMode>(blend_mode));
+    paint->setBlendMode(static_cast<SkBlendMode>(blend_mode));
   }
 
   uint32_t style = uint_data[kStyleIndex];
   if (style)
-    paint.setStyle(static_cast<SkPaint::Style>(style));
+    paint->setStyle(static_cast<SkPaint::Style>(style));
 
   float stroke_width = float_data[kStrokeWidthIndex];
   if (stroke_width != 0.0)
-    paint.setStrokeWidth(stroke_width);
+    paint->setStrokeWidth(stroke_width);
 
   uint32_t stroke_cap = uint_data[kStrokeCapIndex];
   if (stroke_cap)
-    paint.setStrokeCap(static_cast<SkPaint::Cap>(stroke_cap));
+    paint->setStrokeCap(static_cast<SkPaint::Cap>(stroke_cap));
 
   uint32_t stroke_join = uint_data[kStrokeJoinIndex];
   if (stroke_join)
-    paint.setStrokeJoin(static_cast<SkPaint::Join>(stroke_join));
+    paint->setStrokeJoin(static_cast<SkPaint::Join>(stroke_join));
 
   float stroke_miter_limit = float_data[kStrokeMiterLimitIndex];
   if (stroke_miter_limit != 0.0)
-    paint.setStrokeMiter(stroke_miter_limit + kStrokeMiterLimitDefault);
+    paint->setStrokeMiter(stroke_miter_limit + kStrokeMiterLimitDefault);
 
   uint32_t filter_quality = uint_data[kFilterQualityIndex];
   if (filter_quality)
-    paint.setFilterQuality(static_cast<SkFilterQuality>(filter_quality));
+    paint->setFilterQuality(static_cast<SkFilterQuality>(filter_quality));
 
   if (uint_data[kColorFilterIndex]) {
     SkColor color = uint_data[kColorFilterColorIndex];
     SkBlendMode blend_mode =
         static_cast<SkBlendMode>(uint_data[kColorFilterBlendModeIndex]);
-    paint.setColorFilter(SkColorFilter::MakeModeFilter(color, blend_mode));
+    paint->setColorFilter(SkColorFilter::MakeModeFilter(color, blend_mode));
+  }
+}
+
+PaintCache::PaintCache() : entry_count_(0), next_entry_(0) {}
+
+PaintCache::~PaintCache() = default;
+
+const SkPaint& PaintCache::Get(const void* data,
+                               SkShader* shader,
+                               SkMaskFilter* mask_filter) {
+  for (size_t i = 0; i < entry_count_; ++i) {
+    const Entry& entry = entries_[i];
+    if (entry.shader == shader && entry.mask_filter == mask_filter &&
+        memcmp(entry.data, data, Paint::kDataByteCount) == 0)
+      return entry.paint;
+  }
+
+  size_t index;
+  if (entry_count_ < kMaxEntries) {
+    index = entry_count_++;
+  } else {
+    index = next_entry_;
+    next_entry_ = (next_entry_ + 1) % kMaxEntries;
+  }
+
+  Entry& entry = entries_[index];
+  memcpy(entry.data, data, Paint::kDataByteCount);
+  entry.shader = shader;
+  entry.mask_filter = mask_filter;
+  entry.paint = SkPaint();
+  entry.paint.setShader(sk_ref_sp(shader));
+  entry.paint.setMaskFilter(sk_ref_sp(mask_filter));
+  Paint::DecodeData(data, &entry.paint);
+  return entry.paint;
+}
+
+void PaintCache::Clear() {
+  for (size_t i = 0; i < entry_count_; ++i)
+    entries_[i].paint = SkPaint();
+  entry_count_ = 0;
+  next_entry_ = 0;
+}
+
+}  // namespace blink
+
+using namespace blink;
+
+namespace tonic {
+
+Paint DartConverter<Paint>::FromArguments(Dart_NativeArguments args,
+                                          int index,
+                                          Dart_Handle& exception) {
+  Dart_Handle paint_objects = Dart_GetNativeArgument(args, index);
+  FXL_DCHECK(!LogIfError(paint_objects));
+
+  Dart_Handle paint_data = Dart_GetNativeArgument(args, index + 1);
+  FXL_DCHECK(!LogIfError(paint_data));
+
+  Paint result;
+  result.is_null_ = true;
+
+  SkShader* shader = nullptr;
+  SkMaskFilter* mask_filter = nullptr;
+  if (!Dart_IsNull(paint_objects)) {
+    FXL_DCHECK(Dart_IsList(paint_objects));
+    intptr_t length = 0;
+    Dart_ListLength(paint_objects, &length);
+
+    FXL_CHECK(length == kObjectCount);
+    Dart_Handle values[kObjectCount];
+    if (Dart_IsError(Dart_ListGetRange(paint_objects, 0, kObjectCount, values)))
+      return result;
+
+    Dart_Handle mask_filter_handle = values[kMaskFilterIndex];
+    if (!Dart_IsNull(mask_filter_handle)) {
+      mask_filter = DartConverter<MaskFilter*>::FromDart(mask_filter_handle)
+                        ->filter()
+                        .get();
+    }
+
+    Dart_Handle shader_handle = values[kShaderIndex];
+    if (!Dart_IsNull(shader_handle)) {
+      shader = DartConverter<Shader*>::FromDart(shader_handle)->shader().get();
+    }
+  }
+
+  tonic::DartByteData byte_data(paint_data);
+  FXL_CHECK(byte_data.length_in_bytes() == Paint::kDataByteCount);
+
+  // Paints are only passed to the methods of Canvas, whose receiver is the
+  // first argument.
+  Canvas* canvas = DartConverter<Canvas*>::FromArguments(args, 0, exception);
+  if (canvas && canvas->IsRecording()) {
+    result.cached_paint_ =
+        &canvas->paint_cache().Get(byte_data.data(), shader, mask_filter);
+  } else {
+    result.paint_.setShader(sk_ref_sp(shader));
+    result.paint_.setMaskFilter(sk_ref_sp(mask_filter));
+    Paint::DecodeData(byte_data.data(), &result.paint_);
   }
 
   result.is_null_ = false;
@@ -5,22 +5,76 @@
 #ifndef FLUTTER_LIB_UI_PAINTING_PAINT_H_
 #define FLUTTER_LIB_UI_PAINTING_PAINT_H_
 
+#include "lib/fxl/macros.h"
 #include "lib/tonic/converter/dart_converter.h"
+#include "third_party/skia/include/core/SkMaskFilter.h"
 #include "third_party/skia/include/core/SkPaint.h"
+#include "third_party/skia/include/core/SkShader.h"
 
 namespace blink {
 
 class Paint {
  public:
-  const SkPaint* paint() const { return is_null_ ? nullptr : &paint_; }
+  // The size of the encoded paint data written by painting.dart.
+  static constexpr size_t kDataByteCount = 48;
+
+  // Applies the encoded paint data written by painting.dart to |paint|. The
+  // objects of the paint, such as its shader, are not part of the data.
+  static void DecodeData(const void* data, SkPaint* paint);
+
+  const SkPaint* paint() const {
+    if (is_null_)
+      return nullptr;
+    return cached_paint_ ? cached_paint_ : &paint_;
+  }
 
  private:
   friend struct tonic::DartConverter<Paint>;
 
   SkPaint paint_;
+  // Set instead of |paint_| when the paint is owned by the PaintCache of the
+  // canvas being drawn to.
+  const SkPaint* cached_paint_ = nullptr;
   bool is_null_;
 };
 
+// Keeps the paints most recently decoded for a canvas, keyed by their encoded
+// data and the identities of their shader and mask filter, so that draws that
+// reuse a Dart Paint do not decode it again.
+class PaintCache {
+ public:
+  PaintCache();
+  ~PaintCache();
+
+  // Returns the paint for the encoded |data| and the given objects, decoding
+  // it if it is not cached. The paint stays valid until the next call.
+  const SkPaint& Get(const void* data,
+                     SkShader* shader,
+                     SkMaskFilter* mask_filter);
+
+  // Releases the cached paints and the objects they reference.
+  void Clear();
+
+ private:
+  struct Entry {
+    uint8_t data[Paint::kDataByteCount];
+    // Compared by identity. The paint keeps them alive, so that their
+    // addresses cannot be reused while the entry exists.
+    const SkShader* shader;
+    const SkMaskFilter* mask_filter;
+    SkPaint paint;
+  };
+
+  static constexpr size_t kMaxEntries = 4;
+
+  Entry entries_[kMaxEntries];
+  size_t entry_count_;
+  // The entry replaced by the next miss once the cache is full.
+  size_t next_entry_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(PaintCache);
+};
+
 // The PaintData argument is a placeholder to receive encoded data for Paint
 // objects. The data is actually processed by DartConverter<Paint>, which reads
 // both at the given index and at the next index (which it assumes is a byte
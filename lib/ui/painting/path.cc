@@ -38,6 +38,7 @@ IMPLEMENT_WRAPPERTYPEINFO(ui, Path);
   V(Path, contains)                  \
   V(Path, cubicTo)                   \
   V(Path, extendWithPath)            \
+  V(Path, getBounds)                 \
   V(Path, getFillType)               \
   V(Path, lineTo)                    \
   V(Path, moveTo)                    \
@@ -60,7 +61,8 @@ void CanvasPath::RegisterNatives(tonic::DartLibraryNatives* natives) {
                      FOR_EACH_BINDING(DART_REGISTER_NATIVE)});
 }
 
-CanvasPath::CanvasPath() {}
+CanvasPath::CanvasPath()
+    : transformed_generation_id_(0), has_transformed_path_(false) {}
 
 CanvasPath::~CanvasPath() {}
 
@@ -226,17 +228,43 @@ bool CanvasPath::contains(double x, double y) {
   return path_.contains(x, y);
 }
 
+Dart_Handle CanvasPath::getBounds() {
+  const SkRect& bounds = path_.getBounds();
+  Dart_Handle result = Dart_NewTypedData(Dart_TypedData_kFloat32, 4);
+  tonic::Float32List list(result);
+  list.data()[0] = bounds.left();
+  list.data()[1] = bounds.top();
+  list.data()[2] = bounds.right();
+  list.data()[3] = bounds.bottom();
+  list.Release();
+  return result;
+}
+
 fxl::RefPtr<CanvasPath> CanvasPath::shift(double dx, double dy) {
   fxl::RefPtr<CanvasPath> path = CanvasPath::Create();
-  path_.offset(dx, dy, &path->path_);
+  path->path_ = GetTransformedPath(SkMatrix::MakeTrans(dx, dy));
   return path;
 }
 
 fxl::RefPtr<CanvasPath> CanvasPath::transform(tonic::Float64List& matrix4) {
   fxl::RefPtr<CanvasPath> path = CanvasPath::Create();
-  path_.transform(ToSkMatrix(matrix4), &path->path_);
+  path->path_ = GetTransformedPath(ToSkMatrix(matrix4));
   matrix4.Release();
   return path;
 }
 
+SkPath CanvasPath::GetTransformedPath(const SkMatrix& matrix) {
+  if (!has_transformed_path_ ||
+      transformed_generation_id_ != path_.getGenerationID() ||
+      transformed_matrix_ != matrix) {
+    path_.transform(matrix, &transformed_path_);
+    transformed_matrix_ = matrix;
+    transformed_generation_id_ = path_.getGenerationID();
+    has_transformed_path_ = true;
+  }
+  // The fill type is not part of the generation ID.
+  transformed_path_.setFillType(path_.getFillType());
+  return transformed_path_;
+}
+
 }  // namespace blink
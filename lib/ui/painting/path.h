@@ -82,6 +82,7 @@ class CanvasPath : public fxl::RefCountedThreadSafe<CanvasPath>,
   void close();
   void reset();
   bool contains(double x, double y);
+  Dart_Handle getBounds();
   fxl::RefPtr<CanvasPath> shift(double dx, double dy);
   fxl::RefPtr<CanvasPath> transform(tonic::Float64List& matrix4);
 
@@ -92,7 +93,17 @@ class CanvasPath : public fxl::RefCountedThreadSafe<CanvasPath>,
  private:
   CanvasPath();
 
+  // Returns |path_| transformed by |matrix|. The most recent result is reused
+  // while neither |path_| nor |matrix| changes. Copies of it share its points
+  // and generation ID, so that Skia's GPU path caches keep hitting for paths
+  // that are shifted or transformed the same way every frame.
+  SkPath GetTransformedPath(const SkMatrix& matrix);
+
   SkPath path_;
+  SkPath transformed_path_;
+  SkMatrix transformed_matrix_;
+  uint32_t transformed_generation_id_;
+  bool has_transformed_path_;
 };
 
 }  // namespace blink
@@ -5,29 +5,103 @@
 #include "flutter/lib/ui/painting/picture.h"
 
 #include "flutter/common/threads.h"
+#include "flutter/glue/trace_event.h"
 #include "flutter/lib/ui/painting/canvas.h"
+#include "flutter/lib/ui/painting/image_upload_queue.h"
 #include "flutter/lib/ui/painting/utils.h"
+#include "lib/fxl/functional/make_copyable.h"
 #include "lib/tonic/converter/dart_converter.h"
 #include "lib/tonic/dart_args.h"
 #include "lib/tonic/dart_binding_macros.h"
 #include "lib/tonic/dart_library_natives.h"
+#include "lib/tonic/dart_persistent_value.h"
+#include "lib/tonic/logging/dart_invoke.h"
 #include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+using tonic::DartInvoke;
+using tonic::DartPersistentValue;
+using tonic::ToDart;
 
 namespace blink {
+namespace {
+
+// Images are made in the same color space as the ones made by toImage.
+sk_sp<SkColorSpace> GetImageColorSpace() {
+  return SkColorSpace::MakeSRGB();
+}
+
+// Draws |picture| into CPU memory. Needs no GrContext, so it may run on any
+// thread.
+sk_sp<SkImage> RasterizePicture(const sk_sp<SkPicture>& picture,
+                                int width,
+                                int height) {
+  TRACE_EVENT0("flutter", "Picture::RasterizePicture");
+  sk_sp<SkSurface> surface = SkSurface::MakeRaster(
+      SkImageInfo::MakeN32Premul(width, height, GetImageColorSpace()));
+  if (!surface)
+    return nullptr;
+  surface->getCanvas()->clear(SK_ColorTRANSPARENT);
+  surface->getCanvas()->drawPicture(picture);
+  return surface->makeImageSnapshot();
+}
+
+void InvokeImageCallback(sk_sp<SkImage> image,
+                         std::unique_ptr<DartPersistentValue> callback) {
+  tonic::DartState* dart_state = callback->dart_state().get();
+  if (!dart_state)
+    return;
+  tonic::DartState::Scope scope(dart_state);
+  if (!image) {
+    DartInvoke(callback->value(), {Dart_Null()});
+    return;
+  }
+  fxl::RefPtr<CanvasImage> result = CanvasImage::Create();
+  result->set_image(std::move(image));
+  DartInvoke(callback->value(), {ToDart(result)});
+}
+
+// Queues the upload of the rasterized |image| through the resource context.
+// Must be called on the IO thread.
+void UploadAndInvokeImageCallback(
+    sk_sp<SkImage> image,
+    std::unique_ptr<DartPersistentValue> callback) {
+  if (!image) {
+    Threads::UI()->PostTask(fxl::MakeCopyable(
+        [callback = std::move(callback)]() mutable {
+          InvokeImageCallback(nullptr, std::move(callback));
+        }));
+    return;
+  }
+
+  ImageUploadQueue::Get().Upload(
+      std::move(image), ImageUploadQueue::Priority::kNormal,
+      fxl::MakeCopyable([callback = std::move(callback)](
+                            sk_sp<SkImage> uploaded) mutable {
+        Threads::UI()->PostTask(fxl::MakeCopyable([
+          uploaded, callback = std::move(callback)
+        ]() mutable { InvokeImageCallback(uploaded, std::move(callback)); }));
+      }));
+}
+
+}  // namespace
 
 IMPLEMENT_WRAPPERTYPEINFO(ui, Picture);
 
 #define FOR_EACH_BINDING(V) \
   V(Picture, toImage)       \
+  V(Picture, toImageAsync)  \
   V(Picture, dispose)
 
 DART_BIND_ALL(Picture, FOR_EACH_BINDING)
 
-fxl::RefPtr<Picture> Picture::Create(sk_sp<SkPicture> picture) {
-  return fxl::MakeRefCounted<Picture>(std::move(picture));
+fxl::RefPtr<Picture> Picture::Create(sk_sp<SkPicture> picture,
+                                     size_t referenced_bytes) {
+  return fxl::MakeRefCounted<Picture>(std::move(picture), referenced_bytes);
 }
 
-Picture::Picture(sk_sp<SkPicture> picture) : picture_(std::move(picture)) {}
+Picture::Picture(sk_sp<SkPicture> picture, size_t referenced_bytes)
+    : picture_(std::move(picture)), referenced_bytes_(referenced_bytes) {}
 
 Picture::~Picture() {
   // Skia objects must be deleted on the IO thread so that any associated GL
@@ -37,20 +111,57 @@ Picture::~Picture() {
 
 fxl::RefPtr<CanvasImage> Picture::toImage(int width, int height) {
   fxl::RefPtr<CanvasImage> image = CanvasImage::Create();
-  // TODO(abarth): We should pass in an SkColorSpace at some point.
   image->set_image(SkImage::MakeFromPicture(
       picture_, SkISize::Make(width, height), nullptr, nullptr,
-      SkImage::BitDepth::kU8, SkColorSpace::MakeSRGB()));
+      SkImage::BitDepth::kU8, GetImageColorSpace()));
   return image;
 }
 
+void Picture::toImageAsync(int width, int height, Dart_Handle callback) {
+  if (!Dart_IsClosure(callback)) {
+    Dart_ThrowException(ToDart("Callback must be a function"));
+    return;
+  }
+
+  auto persistent_callback = std::make_unique<DartPersistentValue>(
+      tonic::DartState::Current(), callback);
+
+  // The picture is drawn on the worker pool where there is one, so that the
+  // IO thread stays free for uploads.
+  auto rasterize = fxl::MakeCopyable([
+    picture = picture_, width, height, callback = std::move(persistent_callback)
+  ]() mutable {
+    sk_sp<SkImage> image = RasterizePicture(picture, width, height);
+    // The picture may hold the last references to images, which must be
+    // released on the IO thread.
+    if (Threads::Worker()) {
+      Threads::IO()->PostTask(fxl::MakeCopyable([
+        picture = std::move(picture), image = std::move(image),
+        callback = std::move(callback)
+      ]() mutable {
+        picture = nullptr;
+        UploadAndInvokeImageCallback(std::move(image), std::move(callback));
+      }));
+      return;
+    }
+    picture = nullptr;
+    UploadAndInvokeImageCallback(std::move(image), std::move(callback));
+  });
+
+  if (Threads::Worker()) {
+    Threads::Worker()->PostTask(std::move(rasterize));
+  } else {
+    Threads::IO()->PostTask(std::move(rasterize));
+  }
+}
+
 void Picture::dispose() {
   ClearDartWrapper();
 }
 
 size_t Picture::GetAllocationSize() {
   if (picture_) {
-    return picture_->approximateBytesUsed();
+    return picture_->approximateBytesUsed() + referenced_bytes_;
   } else {
     return sizeof(Picture);
   }
@@ -23,12 +23,20 @@ class Picture : public fxl::RefCountedThreadSafe<Picture>,
 
  public:
   ~Picture() override;
-  static fxl::RefPtr<Picture> Create(sk_sp<SkPicture> picture);
+  // |referenced_bytes| are held by objects the picture refers to, such as text
+  // blobs, that SkPicture::approximateBytesUsed does not count.
+  static fxl::RefPtr<Picture> Create(sk_sp<SkPicture> picture,
+                                     size_t referenced_bytes = 0);
 
   const sk_sp<SkPicture>& picture() const { return picture_; }
 
   fxl::RefPtr<CanvasImage> toImage(int width, int height);
 
+  // Rasterizes the picture off the UI thread and invokes |callback| on the UI
+  // thread with a GPU-backed image, or null if the picture could not be
+  // rasterized.
+  void toImageAsync(int width, int height, Dart_Handle callback);
+
   void dispose();
 
   virtual size_t GetAllocationSize() override;
@@ -36,9 +44,10 @@ class Picture : public fxl::RefCountedThreadSafe<Picture>,
   static void RegisterNatives(tonic::DartLibraryNatives* natives);
 
  private:
-  explicit Picture(sk_sp<SkPicture> picture);
+  Picture(sk_sp<SkPicture> picture, size_t referenced_bytes);
 
   sk_sp<SkPicture> picture_;
+  const size_t referenced_bytes_;
 };
 
 }  // namespace blink
@@ -10,9 +10,15 @@
 #include "lib/tonic/dart_args.h"
 #include "lib/tonic/dart_binding_macros.h"
 #include "lib/tonic/dart_library_natives.h"
+#include "third_party/skia/include/core/SkBBHFactory.h"
 
 namespace blink {
 
+// Pictures with fewer operations than this are kept without a bounding box
+// hierarchy. Most pictures are small, and for them building an R-tree costs
+// more on the UI thread than culling their playback saves.
+static const int kRTreeMinOpCount = 64;
+
 static void PictureRecorder_constructor(Dart_NativeArguments args) {
   DartCallConstructor(&PictureRecorder::Create, args);
 }
@@ -44,14 +50,24 @@ bool PictureRecorder::isRecording() {
 }
 
 SkCanvas* PictureRecorder::BeginRecording(SkRect bounds) {
-  return picture_recorder_.beginRecording(bounds, &rtree_factory_);
+  return picture_recorder_.beginRecording(bounds);
 }
 
 fxl::RefPtr<Picture> PictureRecorder::endRecording() {
   if (!isRecording())
     return nullptr;
+  sk_sp<SkPicture> sk_picture = picture_recorder_.finishRecordingAsPicture();
+  if (sk_picture->approximateOpCount() >= kRTreeMinOpCount) {
+    // The number of operations is only known once they are recorded, so
+    // large pictures are recorded again with an R-tree.
+    SkRTreeFactory rtree_factory;
+    SkPictureRecorder recorder;
+    sk_picture->playback(
+        recorder.beginRecording(sk_picture->cullRect(), &rtree_factory));
+    sk_picture = recorder.finishRecordingAsPicture();
+  }
   fxl::RefPtr<Picture> picture =
-      Picture::Create(picture_recorder_.finishRecordingAsPicture());
+      Picture::Create(std::move(sk_picture), canvas_->referenced_bytes());
   canvas_->Clear();
   canvas_->ClearDartWrapper();
   canvas_ = nullptr;
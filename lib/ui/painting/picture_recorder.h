@@ -37,7 +37,6 @@ class PictureRecorder : public fxl::RefCountedThreadSafe<PictureRecorder>,
  private:
   PictureRecorder();
 
-  SkRTreeFactory rtree_factory_;
   SkPictureRecorder picture_recorder_;
   fxl::RefPtr<Canvas> canvas_;
 };
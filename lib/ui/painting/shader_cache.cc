@@ -0,0 +1,61 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/shader_cache.h"
+
+namespace blink {
+namespace {
+
+// Enough for the distinct gradients of a screen. Image shaders keep their
+// images alive, so this is kept small.
+constexpr size_t kMaxEntries = 64;
+
+}  // namespace
+
+ShaderCache::ShaderCache() = default;
+
+ShaderCache::~ShaderCache() = default;
+
+ShaderCache& ShaderCache::Shared() {
+  static ShaderCache* cache = new ShaderCache();
+  return *cache;
+}
+
+sk_sp<SkShader> ShaderCache::Get(
+    const std::string& key,
+    const std::function<sk_sp<SkShader>()>& create) {
+  {
+    fxl::MutexLocker lock(&mutex_);
+    auto found = index_.find(key);
+    if (found != index_.end()) {
+      entries_.splice(entries_.begin(), entries_, found->second);
+      return found->second->shader;
+    }
+  }
+
+  // Created without the lock. Another thread creating the same shader
+  // meanwhile only costs a duplicate.
+  sk_sp<SkShader> shader = create();
+  if (!shader)
+    return nullptr;
+
+  fxl::MutexLocker lock(&mutex_);
+  if (index_.find(key) != index_.end())
+    return shader;
+  entries_.push_front({key, shader});
+  index_[key] = entries_.begin();
+  if (entries_.size() > kMaxEntries) {
+    index_.erase(entries_.back().key);
+    entries_.pop_back();
+  }
+  return shader;
+}
+
+void ShaderCache::Clear() {
+  fxl::MutexLocker lock(&mutex_);
+  index_.clear();
+  entries_.clear();
+}
+
+}  // namespace blink
@@ -0,0 +1,63 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_SHADER_CACHE_H_
+#define FLUTTER_LIB_UI_PAINTING_SHADER_CACHE_H_
+
+#include <functional>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+#include "lib/fxl/macros.h"
+#include "lib/fxl/synchronization/mutex.h"
+#include "lib/fxl/synchronization/thread_annotations.h"
+#include "third_party/skia/include/core/SkShader.h"
+
+namespace blink {
+
+// Hands out the same shader for gradients and image shaders that are created
+// again with identical parameters, so that they are not allocated again and
+// Skia can reuse the programs it built for them. Holds the most recently used
+// shaders. Thread safe.
+class ShaderCache {
+ public:
+  ShaderCache();
+  ~ShaderCache();
+
+  // The cache used by the dart:ui shaders.
+  static ShaderCache& Shared();
+
+  // Appends the bytes of a parameter to a key.
+  static void AppendToKey(std::string* key, const void* data, size_t length) {
+    key->append(static_cast<const char*>(data), length);
+  }
+
+  // Returns the shader for |key|, the bytes of all the parameters it is made
+  // from, calling |create| to make it if it is not cached.
+  sk_sp<SkShader> Get(const std::string& key,
+                      const std::function<sk_sp<SkShader>()>& create);
+
+  void Clear();
+
+ private:
+  struct Entry {
+    std::string key;
+    sk_sp<SkShader> shader;
+  };
+
+  using EntryList = std::list<Entry>;
+
+  fxl::Mutex mutex_;
+  // Most recently used first.
+  EntryList entries_ FXL_GUARDED_BY(mutex_);
+  std::unordered_map<std::string, EntryList::iterator> index_
+      FXL_GUARDED_BY(mutex_);
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(ShaderCache);
+};
+
+}  // namespace blink
+
+#endif  // FLUTTER_LIB_UI_PAINTING_SHADER_CACHE_H_
@@ -4,6 +4,8 @@
 
 #include "flutter/lib/ui/painting/vertices.h"
 
+#include <string.h>
+
 #include "lib/tonic/dart_binding_macros.h"
 #include "lib/tonic/dart_library_natives.h"
 
@@ -11,15 +13,27 @@ namespace blink {
 
 namespace {
 
+static_assert(sizeof(SkPoint) == sizeof(float) * 2,
+              "SkPoint doesn't use floats.");
+static_assert(sizeof(SkColor) == sizeof(int32_t),
+              "SkColor doesn't use 32 bit ints.");
+
+// Points and colors have the same layout in the typed lists as in
+// SkVertices, so they are copied straight from the lists' backing stores.
 void DecodePoints(const tonic::Float32List& coords, SkPoint* points) {
-  for (int i = 0; i < coords.num_elements(); i += 2)
-    points[i / 2] = SkPoint::Make(coords[i], coords[i + 1]);
+  memcpy(points, coords.data(), (coords.num_elements() / 2) * sizeof(SkPoint));
+}
+
+void DecodeColors(const tonic::Int32List& ints, SkColor* colors) {
+  memcpy(colors, ints.data(), ints.num_elements() * sizeof(SkColor));
 }
 
-template <typename T>
-void DecodeInts(const tonic::Int32List& ints, T* out) {
-  for (int i = 0; i < ints.num_elements(); i++)
-    out[i] = ints[i];
+// Indices are narrowed to 16 bits, so they have to be copied one by one.
+void DecodeIndices(const tonic::Int32List& ints, uint16_t* indices) {
+  const int32_t* data = ints.data();
+  const int count = ints.num_elements();
+  for (int i = 0; i < count; i++)
+    indices[i] = static_cast<uint16_t>(data[i]);
 }
 
 }  // namespace
@@ -65,9 +79,9 @@ void Vertices::init(SkVertices::VertexMode vertex_mode,
   if (texture_coordinates.data())
     DecodePoints(texture_coordinates, builder.texCoords());
   if (colors.data())
-    DecodeInts<SkColor>(colors, builder.colors());
+    DecodeColors(colors, builder.colors());
   if (indices.data())
-    DecodeInts<uint16_t>(indices, builder.indices());
+    DecodeIndices(indices, builder.indices());
 
   vertices_ = builder.detach();
 }
@@ -20,4 +20,23 @@ bool SemanticsNode::HasFlag(SemanticsFlags flag) {
   return (flags & static_cast<int32_t>(flag)) != 0;
 }
 
+int32_t SemanticsNode::GetChangedFields(const SemanticsNode& other) const {
+  int32_t fields = 0;
+  if (flags != other.flags)
+    fields |= kFlagsField;
+  if (actions != other.actions)
+    fields |= kActionsField;
+  if (label != other.label)
+    fields |= kLabelField;
+  if (textDirection != other.textDirection)
+    fields |= kTextDirectionField;
+  if (rect != other.rect)
+    fields |= kRectField;
+  if (transform != other.transform)
+    fields |= kTransformField;
+  if (children != other.children)
+    fields |= kChildrenField;
+  return fields;
+}
+
 }  // namespace blink
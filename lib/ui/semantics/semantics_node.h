@@ -41,12 +41,29 @@ enum class SemanticsFlags : int32_t {
 };
 
 struct SemanticsNode {
+  // Bits identifying the fields in which two versions of a node differ. Must
+  // match the field bits in AccessibilityBridge.java.
+  enum Field : int32_t {
+    kFlagsField = 1 << 0,
+    kActionsField = 1 << 1,
+    kLabelField = 1 << 2,
+    kTextDirectionField = 1 << 3,
+    kRectField = 1 << 4,
+    kTransformField = 1 << 5,
+    kChildrenField = 1 << 6,
+    kAllFields = (1 << 7) - 1,
+  };
+
   SemanticsNode();
   ~SemanticsNode();
 
   bool HasAction(SemanticsAction action);
   bool HasFlag(SemanticsFlags flag);
 
+  // Returns the |Field| bits of the fields that differ from |other|. The ids
+  // are not compared.
+  int32_t GetChangedFields(const SemanticsNode& other) const;
+
   int32_t id = 0;
   int32_t flags = 0;
   int32_t actions = 0;
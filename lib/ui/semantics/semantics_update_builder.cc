@@ -4,6 +4,8 @@
 
 #include "flutter/lib/ui/semantics/semantics_update_builder.h"
 
+#include <utility>
+
 #include "lib/tonic/converter/dart_converter.h"
 #include "lib/tonic/dart_args.h"
 #include "lib/tonic/dart_binding_macros.h"
@@ -45,17 +47,19 @@ void SemanticsUpdateBuilder::updateNode(int id,
                                         int textDirection,
                                         const tonic::Float64List& transform,
                                         const tonic::Int32List& children) {
-  SemanticsNode node;
+  // The node is filled in place, so its label and children are not copied
+  // again.
+  nodes_.emplace_back();
+  SemanticsNode& node = nodes_.back();
   node.id = id;
   node.flags = flags;
   node.actions = actions;
   node.rect = SkRect::MakeLTRB(left, top, right, bottom);
-  node.label = label;
+  node.label = std::move(label);
   node.textDirection = textDirection;
   node.transform.setColMajord(transform.data());
-  node.children = std::vector<int32_t>(
-      children.data(), children.data() + children.num_elements());
-  nodes_.push_back(node);
+  node.children.assign(children.data(),
+                       children.data() + children.num_elements());
 }
 
 fxl::RefPtr<SemanticsUpdate> SemanticsUpdateBuilder::build() {
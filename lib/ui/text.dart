@@ -342,6 +342,10 @@ class TextStyle {
   final double _wordSpacing;
   final double _height;
 
+  // The id of this style in the engine, assigned the first time the style is
+  // pushed, or 0 if the engine could not intern it.
+  int _handle;
+
   bool operator ==(dynamic other) {
     if (identical(this, other))
       return true;
@@ -798,6 +802,10 @@ abstract class Paragraph extends NativeFieldWrapperClass2 {
   void _paint(Canvas canvas, double x, double y) native "Paragraph_paint";
 }
 
+// Converts a style once so that it can be pushed by id. Returns 0 when the
+// engine interns no more styles.
+int _registerTextStyle(Int32List encoded, String fontFamily, double fontSize, double letterSpacing, double wordSpacing, double height) native "ParagraphBuilder_registerTextStyle";
+
 /// Builds a [Paragraph] containing text with the given styling information.
 ///
 /// To set the paragraph's alignment, truncation, and ellipsising behavior, pass
@@ -812,6 +820,11 @@ abstract class Paragraph extends NativeFieldWrapperClass2 {
 ///
 /// After constructing a [Paragraph], call [Paragraph.layout] on it and then
 /// paint it with [Canvas.drawParagraph].
+///
+/// Paragraphs can also be built and laid out on isolates other than the root
+/// isolate, for example to measure text ahead of time. Those paragraphs use
+/// the same fonts, but their metrics may differ slightly from those of the
+/// root isolate when it lays out text with Blink.
 class ParagraphBuilder extends NativeFieldWrapperClass2 {
   /// Creates a [ParagraphBuilder] object, which is used to create a
   /// [Paragraph].
@@ -821,7 +834,14 @@ class ParagraphBuilder extends NativeFieldWrapperClass2 {
   /// Applies the given style to the added text until [pop] is called.
   ///
   /// See [pop] for details.
-  void pushStyle(TextStyle style) => _pushStyle(style._encoded, style._fontFamily, style._fontSize, style._letterSpacing, style._wordSpacing, style._height);
+  void pushStyle(TextStyle style) {
+    style._handle ??= _registerTextStyle(style._encoded, style._fontFamily, style._fontSize, style._letterSpacing, style._wordSpacing, style._height);
+    if (style._handle != 0)
+      _pushStyleHandle(style._handle);
+    else
+      _pushStyle(style._encoded, style._fontFamily, style._fontSize, style._letterSpacing, style._wordSpacing, style._height);
+  }
+  void _pushStyleHandle(int handle) native "ParagraphBuilder_pushStyleHandle";
   void _pushStyle(Int32List encoded, String fontFamily, double fontSize, double letterSpacing, double wordSpacing, double height) native "ParagraphBuilder_pushStyle";
 
   /// Ends the effect of the most recent call to [pushStyle].
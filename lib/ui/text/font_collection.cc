@@ -4,17 +4,60 @@
 
 #include "flutter/lib/ui/text/font_collection.h"
 
+#include <algorithm>
 #include <mutex>
-
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "flutter/common/settings.h"
+#include "flutter/common/threads.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/lib/ui/text/persistent_layout_cache.h"
 #include "flutter/runtime/test_font_data.h"
+#include "lib/fxl/files/file.h"
+#include "minikin/Layout.h"
 #include "third_party/rapidjson/rapidjson/document.h"
 #include "third_party/rapidjson/rapidjson/rapidjson.h"
+#include "third_party/skia/include/core/SkData.h"
 #include "third_party/skia/include/core/SkStream.h"
 #include "third_party/skia/include/ports/SkFontMgr.h"
 #include "txt/asset_font_manager.h"
+#include "txt/hyphenator_cache.h"
 #include "txt/test_font_manager.h"
 
 namespace blink {
+namespace {
+
+// Adds the fallback fonts found by previous launches, looks up those of common
+// scripts and remembers the result in the file at path for the next launch.
+void WarmFallbackFonts(txt::FontCollection* collection,
+                       const std::string& path) {
+  std::vector<std::string> families;
+  std::string contents;
+  if (!path.empty() && files::ReadFileToString(path, &contents)) {
+    std::istringstream stream(contents);
+    std::string family;
+    while (std::getline(stream, family)) {
+      if (!family.empty())
+        families.push_back(family);
+    }
+  }
+
+  collection->AddFallbackFontFamilies(families);
+  collection->WarmFallbackFonts();
+
+  std::vector<std::string> found = collection->GetFallbackFontFamilies();
+  if (path.empty() || found == families)
+    return;
+  std::string output;
+  for (const std::string& family : found)
+    output += family + "\n";
+  if (!files::WriteFile(path, output.data(), output.size()))
+    FXL_DLOG(WARNING) << "Could not remember the fallback fonts in " << path;
+}
+
+}  // namespace
 
 FontCollection& FontCollection::ForProcess() {
   static std::once_flag once = {};
@@ -26,6 +69,30 @@ FontCollection& FontCollection::ForProcess() {
 FontCollection::FontCollection()
     : collection_(std::make_shared<txt::FontCollection>()) {
   collection_->PushBack(SkFontMgr::RefDefault());
+
+  const Settings& settings = Settings::Get();
+  // Matching the system fonts against characters is slow, so the fallback
+  // fonts text is likely to need are looked up off the UI thread.
+  if (Threads::IO()) {
+    std::shared_ptr<txt::FontCollection> collection = collection_;
+    std::string path = settings.temp_directory_path.empty()
+                           ? std::string()
+                           : settings.temp_directory_path +
+                                 "/flutter_fallback_font_families";
+    Threads::IO()->PostTask([collection, path]() {
+      WarmFallbackFonts(collection.get(), path);
+    });
+  }
+  minikin::Layout::setCacheCapacities(settings.text_layout_cache_max_entries,
+                                      settings.text_font_cache_max_entries);
+  if (settings.persistent_text_layout_cache &&
+      !settings.temp_directory_path.empty() && Threads::IO()) {
+    minikin::Layout::setCacheStorage(std::make_shared<PersistentLayoutCache>(
+        settings.temp_directory_path + "/flutter_text_layout_cache",
+        Threads::IO(), settings.text_layout_cache_max_entries));
+  }
+  txt::HyphenatorCache::Get().SetPatternDirectory(
+      settings.hyphenation_patterns_path);
 }
 
 FontCollection::~FontCollection() = default;
@@ -34,12 +101,64 @@ std::shared_ptr<txt::FontCollection> FontCollection::GetFontCollection() const {
   return collection_;
 }
 
+size_t FontCollection::GetFontDataBytes() const {
+  return font_data_bytes_.load();
+}
+
+sk_sp<SkData> FontCollection::GetFontAssetData(
+    fxl::RefPtr<blink::ZipAssetStore> asset_store,
+    const std::string& asset_name) {
+  if (!asset_store) {
+    return nullptr;
+  }
+
+  std::lock_guard<std::mutex> lock(font_asset_data_mutex_);
+  auto key = std::make_pair(asset_store.get(), asset_name);
+  auto found = font_asset_data_.find(key);
+  if (found != font_asset_data_.end()) {
+    return found->second.data;
+  }
+
+  std::unique_ptr<fml::Mapping> font_mapping =
+      asset_store->GetAsMapping(asset_name);
+  if (!font_mapping) {
+    return nullptr;
+  }
+
+  // The data points into the mapped bundle, or into the inflated asset for
+  // compressed fonts, instead of copying it.
+  const uint8_t* font_bytes = font_mapping->GetMapping();
+  size_t font_size = font_mapping->GetSize();
+  font_data_bytes_ += font_size;
+  sk_sp<SkData> data = SkData::MakeWithProc(
+      font_bytes, font_size,
+      [](const void* ptr, void* context) {
+        delete reinterpret_cast<fml::Mapping*>(context);
+      },
+      font_mapping.release());
+  font_asset_data_.emplace(std::move(key),
+                           FontAssetData{std::move(asset_store), data});
+  return data;
+}
+
 void FontCollection::RegisterFontsFromAssetStore(
     fxl::RefPtr<blink::ZipAssetStore> asset_store) {
   if (!asset_store) {
     return;
   }
 
+  {
+    // Each font manager pushed invalidates the fallback lookups of the
+    // collection, and its typefaces would duplicate those already there.
+    std::lock_guard<std::mutex> lock(registration_mutex_);
+    if (std::find(registered_asset_stores_.begin(),
+                  registered_asset_stores_.end(),
+                  asset_store) != registered_asset_stores_.end()) {
+      return;
+    }
+    registered_asset_stores_.push_back(asset_store);
+  }
+
   std::vector<uint8_t> manifest_data;
   if (!asset_store->GetAsBuffer("FontManifest.json", &manifest_data)) {
     FXL_DLOG(WARNING) << "Could not find the font manifest in the asset store.";
@@ -90,14 +209,12 @@ void FontCollection::RegisterFontsFromAssetStore(
       }
 
       // TODO: Handle weights and styles.
-      std::vector<uint8_t> font_data;
-      if (asset_store->GetAsBuffer(font_asset->value.GetString(), &font_data)) {
-        // The data must be copied because it needs to be moved into the
-        // typeface as a stream.
-        auto data =
-            SkMemoryStream::MakeCopy(font_data.data(), font_data.size());
+      sk_sp<SkData> data =
+          GetFontAssetData(asset_store, font_asset->value.GetString());
+      if (data) {
         // Ownership of the stream is transferred.
-        auto typeface = SkTypeface::MakeFromStream(data.release());
+        auto typeface =
+            SkTypeface::MakeFromStream(new SkMemoryStream(std::move(data)));
         font_asset_data_provider->RegisterTypeface(
             std::move(typeface), family_name->value.GetString());
       }
@@ -109,8 +226,17 @@ void FontCollection::RegisterFontsFromAssetStore(
 }
 
 void FontCollection::RegisterTestFonts() {
+  {
+    std::lock_guard<std::mutex> lock(registration_mutex_);
+    if (registered_test_fonts_)
+      return;
+    registered_test_fonts_ = true;
+  }
+
+  auto test_font_data = GetTestFontData();
+  font_data_bytes_ += test_font_data->getLength();
   sk_sp<SkTypeface> test_typeface =
-      SkTypeface::MakeFromStream(GetTestFontData().release());
+      SkTypeface::MakeFromStream(test_font_data.release());
 
   std::unique_ptr<txt::AssetDataProvider> asset_data_provider =
       std::make_unique<txt::AssetDataProvider>();
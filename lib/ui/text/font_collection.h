@@ -5,22 +5,40 @@
 #ifndef FLUTTER_LIB_UI_TEXT_FONT_COLLECTION_H_
 #define FLUTTER_LIB_UI_TEXT_FONT_COLLECTION_H_
 
+#include <atomic>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
 #include <vector>
 #include "flutter/assets/zip_asset_store.h"
 #include "lib/fxl/macros.h"
 #include "lib/fxl/memory/ref_ptr.h"
+#include "third_party/skia/include/core/SkData.h"
 #include "txt/asset_data_provider.h"
 #include "txt/font_collection.h"
 
 namespace blink {
 
+// The fonts of every engine in the process. Engines that run the same
+// bundle share its asset store, so its fonts are registered only once.
 class FontCollection {
  public:
   static FontCollection& ForProcess();
 
   std::shared_ptr<txt::FontCollection> GetFontCollection() const;
 
+  // The bytes of the font files registered so far. Fonts stored uncompressed
+  // in a bundle are mapped rather than copied to the heap.
+  size_t GetFontDataBytes() const;
+
+  // Returns the bytes of a font in the asset store, or null if there is no
+  // such asset. Fonts stored uncompressed are mapped from the bundle, and every
+  // caller in the process shares the data of a font.
+  sk_sp<SkData> GetFontAssetData(fxl::RefPtr<blink::ZipAssetStore> asset_store,
+                                 const std::string& asset_name);
+
   void RegisterFontsFromAssetStore(
       fxl::RefPtr<blink::ZipAssetStore> asset_store);
 
@@ -28,6 +46,19 @@ class FontCollection {
 
  private:
   std::shared_ptr<txt::FontCollection> collection_;
+  std::mutex registration_mutex_;
+  std::vector<fxl::RefPtr<blink::ZipAssetStore>> registered_asset_stores_;
+  bool registered_test_fonts_ = false;
+  std::atomic<size_t> font_data_bytes_{0};
+
+  struct FontAssetData {
+    // Keeps the store alive so that its address is not reused as a key.
+    fxl::RefPtr<blink::ZipAssetStore> asset_store;
+    sk_sp<SkData> data;
+  };
+  std::mutex font_asset_data_mutex_;
+  std::map<std::pair<blink::ZipAssetStore*, std::string>, FontAssetData>
+      font_asset_data_;
 
   FontCollection();
 
@@ -6,6 +6,7 @@
 
 #include "flutter/common/settings.h"
 #include "flutter/common/threads.h"
+#include "flutter/lib/ui/text/render_view_pool.h"
 #include "flutter/sky/engine/core/rendering/PaintInfo.h"
 #include "flutter/sky/engine/core/rendering/RenderParagraph.h"
 #include "flutter/sky/engine/core/rendering/RenderText.h"
@@ -51,17 +52,12 @@ Paragraph::Paragraph(std::unique_ptr<txt::Paragraph> paragraph)
           std::make_unique<ParagraphImplTxt>(std::move(paragraph))) {}
 
 Paragraph::~Paragraph() {
-  if (m_renderView) {
-    RenderView* renderView = m_renderView.leakPtr();
-    Threads::UI()->PostTask([renderView]() { renderView->destroy(); });
-  }
+  if (m_renderView)
+    RenderViewPool::Get().Release(m_renderView.release());
 }
 
 size_t Paragraph::GetAllocationSize() {
-  // We don't have an accurate accounting of the paragraph's memory consumption,
-  // so return a fixed size to indicate that its impact is more than the size
-  // of the Paragraph class.
-  return 2000;
+  return sizeof(Paragraph) + m_paragraphImpl->GetAllocationSize();
 }
 
 double Paragraph::width() {
@@ -4,10 +4,19 @@
 
 #include "flutter/lib/ui/text/paragraph_builder.h"
 
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 #include "flutter/common/settings.h"
 #include "flutter/common/threads.h"
 #include "flutter/lib/ui/text/font_collection.h"
+#include "flutter/lib/ui/text/render_view_pool.h"
 #include "flutter/lib/ui/ui_dart_state.h"
+#include "flutter/lib/ui/window/window.h"
 #include "flutter/sky/engine/core/rendering/RenderInline.h"
 #include "flutter/sky/engine/core/rendering/RenderParagraph.h"
 #include "flutter/sky/engine/core/rendering/RenderText.h"
@@ -173,18 +182,108 @@ Color getColorFromARGB(int argb) {
                (argb & 0x000000FF) >> 0, (argb & 0xFF000000) >> 24);
 }
 
+// Styles beyond this many are pushed by value.
+constexpr size_t kMaxInternedTextStyles = 4096;
+
+// Blink's render tree, font cache and atomic strings belong to the UI thread,
+// so the paragraphs of other isolates are laid out by libtxt against the fonts
+// of the process. This lets worker isolates measure text.
+bool UseBlinkOnCurrentIsolate() {
+  if (!Settings::Get().using_blink)
+    return false;
+  UIDartState* state = UIDartState::Current();
+  return state && state->is_controller_state();
+}
+
+// Returns the locale of the window of the current isolate, if it has one.
+std::string GetCurrentLocaleTag() {
+  UIDartState* state = UIDartState::Current();
+  Window* window = state ? state->window() : nullptr;
+  return window ? window->locale_tag() : std::string();
+}
+
+}  // namespace
+
+// A text style as encoded by text.dart, converted from Dart once.
+struct InternedTextStyle {
+  InternedTextStyle(tonic::Int32List& encoded,
+                    const std::string& fontFamily,
+                    double fontSize,
+                    double letterSpacing,
+                    double wordSpacing,
+                    double height)
+      : fontFamily(fontFamily),
+        fontSize(fontSize),
+        letterSpacing(letterSpacing),
+        wordSpacing(wordSpacing),
+        height(height) {
+    std::copy(encoded.data(), encoded.data() + kEncodedSize, this->encoded);
+    if (UseBlinkOnCurrentIsolate() && (this->encoded[0] & tsFontFamilyMask))
+      blinkFontFamily = AtomicString(String::fromUTF8(fontFamily));
+  }
+
+  // The bytes that identify equal styles.
+  std::string Key() const {
+    std::string key(reinterpret_cast<const char*>(encoded), sizeof(encoded));
+    for (double value : {fontSize, letterSpacing, wordSpacing, height})
+      key.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    key.append(fontFamily);
+    return key;
+  }
+
+  static constexpr size_t kEncodedSize = 8;
+
+  int32_t encoded[kEncodedSize];
+  std::string fontFamily;
+  // Null if the style was registered by an isolate that does not use Blink.
+  AtomicString blinkFontFamily;
+  double fontSize;
+  double letterSpacing;
+  double wordSpacing;
+  double height;
+};
+
+constexpr size_t InternedTextStyle::kEncodedSize;
+
+namespace {
+
+// Guards the registry, which every isolate shares.
+std::mutex& GetInternedTextStylesMutex() {
+  static auto* mutex = new std::mutex();
+  return *mutex;
+}
+
+std::vector<std::unique_ptr<InternedTextStyle>>& GetInternedTextStyles() {
+  static auto* styles = new std::vector<std::unique_ptr<InternedTextStyle>>();
+  return *styles;
+}
+
+// Styles are never removed, so the returned style stays valid.
+const InternedTextStyle* GetInternedTextStyle(int handle) {
+  std::lock_guard<std::mutex> lock(GetInternedTextStylesMutex());
+  const auto& styles = GetInternedTextStyles();
+  if (handle < 1 || static_cast<size_t>(handle) > styles.size())
+    return nullptr;
+  return styles[handle - 1].get();
+}
+
 }  // namespace
 
 static void ParagraphBuilder_constructor(Dart_NativeArguments args) {
   DartCallConstructor(&ParagraphBuilder::create, args);
 }
 
+static void ParagraphBuilder_registerTextStyle(Dart_NativeArguments args) {
+  tonic::DartCallStatic(&ParagraphBuilder::registerTextStyle, args);
+}
+
 IMPLEMENT_WRAPPERTYPEINFO(ui, ParagraphBuilder);
 
-#define FOR_EACH_BINDING(V)      \
-  V(ParagraphBuilder, pushStyle) \
-  V(ParagraphBuilder, pop)       \
-  V(ParagraphBuilder, addText)   \
+#define FOR_EACH_BINDING(V)            \
+  V(ParagraphBuilder, pushStyle)       \
+  V(ParagraphBuilder, pushStyleHandle) \
+  V(ParagraphBuilder, pop)             \
+  V(ParagraphBuilder, addText)         \
   V(ParagraphBuilder, build)
 
 FOR_EACH_BINDING(DART_NATIVE_CALLBACK)
@@ -192,9 +291,39 @@ FOR_EACH_BINDING(DART_NATIVE_CALLBACK)
 void ParagraphBuilder::RegisterNatives(tonic::DartLibraryNatives* natives) {
   natives->Register(
       {{"ParagraphBuilder_constructor", ParagraphBuilder_constructor, 6, true},
+       {"ParagraphBuilder_registerTextStyle",
+        ParagraphBuilder_registerTextStyle, 6, true},
        FOR_EACH_BINDING(DART_REGISTER_NATIVE)});
 }
 
+int ParagraphBuilder::registerTextStyle(tonic::Int32List& encoded,
+                                        const std::string& fontFamily,
+                                        double fontSize,
+                                        double letterSpacing,
+                                        double wordSpacing,
+                                        double height) {
+  FXL_DCHECK(encoded.num_elements() == InternedTextStyle::kEncodedSize);
+  static auto* ids = new std::unordered_map<std::string, int>();
+
+  auto style = std::make_unique<InternedTextStyle>(
+      encoded, fontFamily, fontSize, letterSpacing, wordSpacing, height);
+  encoded.Release();
+
+  std::string key = style->Key();
+  std::lock_guard<std::mutex> lock(GetInternedTextStylesMutex());
+  auto found = ids->find(key);
+  if (found != ids->end())
+    return found->second;
+
+  auto& styles = GetInternedTextStyles();
+  if (styles.size() >= kMaxInternedTextStyles)
+    return 0;
+  styles.push_back(std::move(style));
+  int handle = static_cast<int>(styles.size());
+  ids->emplace(std::move(key), handle);
+  return handle;
+}
+
 fxl::RefPtr<ParagraphBuilder> ParagraphBuilder::create(
     tonic::Int32List& encoded,
     const std::string& fontFamily,
@@ -209,8 +338,9 @@ ParagraphBuilder::ParagraphBuilder(tonic::Int32List& encoded,
                                    const std::string& fontFamily,
                                    double fontSize,
                                    double lineHeight,
-                                   const std::u16string& ellipsis) {
-  if (!Settings::Get().using_blink) {
+                                   const std::u16string& ellipsis)
+    : m_usingBlink(UseBlinkOnCurrentIsolate()) {
+  if (!m_usingBlink) {
     int32_t mask = encoded[0];
     txt::ParagraphStyle style;
     if (mask & psTextAlignMask)
@@ -242,6 +372,11 @@ ParagraphBuilder::ParagraphBuilder(tonic::Int32List& encoded,
       style.ellipsis = ellipsis;
     }
 
+    if (!Settings::Get().hyphenation_patterns_path.empty()) {
+      style.locale = GetCurrentLocaleTag();
+      style.hyphenation_frequency = minikin::kHyphenationFrequency_Normal;
+    }
+
     m_paragraphBuilder = std::make_unique<txt::ParagraphBuilder>(
         style, blink::FontCollection::ForProcess().GetFontCollection());
   } else {
@@ -263,10 +398,8 @@ ParagraphBuilder::ParagraphBuilder(tonic::Int32List& encoded,
 }  // namespace blink
 
 ParagraphBuilder::~ParagraphBuilder() {
-  if (m_renderView) {
-    RenderView* renderView = m_renderView.leakPtr();
-    Threads::UI()->PostTask([renderView]() { renderView->destroy(); });
-  }
+  if (m_renderView)
+    RenderViewPool::Get().Release(m_renderView.release());
 }
 
 void ParagraphBuilder::pushStyle(tonic::Int32List& encoded,
@@ -277,27 +410,42 @@ void ParagraphBuilder::pushStyle(tonic::Int32List& encoded,
                                  double height) {
   FXL_DCHECK(encoded.num_elements() == 8);
 
-  int32_t mask = encoded[0];
+  InternedTextStyle values(encoded, fontFamily, fontSize, letterSpacing,
+                           wordSpacing, height);
+  encoded.Release();
+  pushInternedStyle(values);
+}
 
-  if (!Settings::Get().using_blink) {
+void ParagraphBuilder::pushStyleHandle(int handle) {
+  const InternedTextStyle* values = GetInternedTextStyle(handle);
+  if (!values)
+    return;
+  pushInternedStyle(*values);
+}
+
+void ParagraphBuilder::pushInternedStyle(const InternedTextStyle& values) {
+  int32_t mask = values.encoded[0];
+
+  if (!m_usingBlink) {
     // Set to use the properties of the previous style if the property is not
     // explicitly given.
     txt::TextStyle style = m_paragraphBuilder->PeekStyle();
 
     if (mask & tsColorMask)
-      style.color = encoded[tsColorIndex];
+      style.color = values.encoded[tsColorIndex];
 
     if (mask & tsTextDecorationMask) {
       style.decoration =
-          static_cast<txt::TextDecoration>(encoded[tsTextDecorationIndex]);
+          static_cast<txt::TextDecoration>(
+          values.encoded[tsTextDecorationIndex]);
     }
 
     if (mask & tsTextDecorationColorMask)
-      style.decoration_color = encoded[tsTextDecorationColorIndex];
+      style.decoration_color = values.encoded[tsTextDecorationColorIndex];
 
     if (mask & tsTextDecorationStyleMask)
       style.decoration_style = static_cast<txt::TextDecorationStyle>(
-          encoded[tsTextDecorationStyleIndex]);
+          values.encoded[tsTextDecorationStyleIndex]);
 
     if (mask & tsTextBaselineMask) {
       // TODO(abarth): Implement TextBaseline. The CSS version of this
@@ -308,27 +456,27 @@ void ParagraphBuilder::pushStyle(tonic::Int32List& encoded,
                 tsFontSizeMask | tsLetterSpacingMask | tsWordSpacingMask)) {
       if (mask & tsFontWeightMask)
         style.font_weight =
-            static_cast<txt::FontWeight>(encoded[tsFontWeightIndex]);
+            static_cast<txt::FontWeight>(values.encoded[tsFontWeightIndex]);
 
       if (mask & tsFontStyleMask)
         style.font_style =
-            static_cast<txt::FontStyle>(encoded[tsFontStyleIndex]);
+            static_cast<txt::FontStyle>(values.encoded[tsFontStyleIndex]);
 
       if (mask & tsFontFamilyMask)
-        style.font_family = fontFamily;
+        style.font_family = values.fontFamily;
 
       if (mask & tsFontSizeMask)
-        style.font_size = fontSize;
+        style.font_size = values.fontSize;
 
       if (mask & tsLetterSpacingMask)
-        style.letter_spacing = letterSpacing;
+        style.letter_spacing = values.letterSpacing;
 
       if (mask & tsWordSpacingMask)
-        style.word_spacing = wordSpacing;
+        style.word_spacing = values.wordSpacing;
     }
 
     if (mask & tsHeightMask) {
-      style.height = height;
+      style.height = values.height;
     }
 
     m_paragraphBuilder->PushStyle(style);
@@ -338,21 +486,21 @@ void ParagraphBuilder::pushStyle(tonic::Int32List& encoded,
     style->inheritFrom(m_currentRenderObject->style());
 
     if (mask & tsColorMask)
-      style->setColor(getColorFromARGB(encoded[tsColorIndex]));
+      style->setColor(getColorFromARGB(values.encoded[tsColorIndex]));
 
     if (mask & tsTextDecorationMask) {
       style->setTextDecoration(
-          static_cast<TextDecoration>(encoded[tsTextDecorationIndex]));
+          static_cast<TextDecoration>(values.encoded[tsTextDecorationIndex]));
       style->applyTextDecorations();
     }
 
     if (mask & tsTextDecorationColorMask)
-      style->setTextDecorationColor(
-          StyleColor(getColorFromARGB(encoded[tsTextDecorationColorIndex])));
+      style->setTextDecorationColor(StyleColor(
+          getColorFromARGB(values.encoded[tsTextDecorationColorIndex])));
 
     if (mask & tsTextDecorationStyleMask)
       style->setTextDecorationStyle(static_cast<TextDecorationStyle>(
-          encoded[tsTextDecorationStyleIndex]));
+          values.encoded[tsTextDecorationStyleIndex]));
 
     if (mask & tsTextBaselineMask) {
       // TODO(abarth): Implement TextBaseline. The CSS version of this
@@ -365,41 +513,41 @@ void ParagraphBuilder::pushStyle(tonic::Int32List& encoded,
 
       if (mask & tsFontWeightMask)
         fontDescription.setWeight(
-            static_cast<FontWeight>(encoded[tsFontWeightIndex]));
+            static_cast<FontWeight>(values.encoded[tsFontWeightIndex]));
 
       if (mask & tsFontStyleMask)
         fontDescription.setStyle(
-            static_cast<FontStyle>(encoded[tsFontStyleIndex]));
+            static_cast<FontStyle>(values.encoded[tsFontStyleIndex]));
 
       if (mask & tsFontFamilyMask) {
         FontFamily family;
-        family.setFamily(String::fromUTF8(fontFamily));
+        family.setFamily(values.blinkFontFamily.isNull()
+                             ? AtomicString(String::fromUTF8(values.fontFamily))
+                             : values.blinkFontFamily);
         fontDescription.setFamily(family);
       }
 
       if (mask & tsFontSizeMask) {
-        fontDescription.setSpecifiedSize(fontSize);
+        fontDescription.setSpecifiedSize(values.fontSize);
         fontDescription.setIsAbsoluteSize(true);
         fontDescription.setComputedSize(
-            getComputedSizeFromSpecifiedSize(fontSize));
+            getComputedSizeFromSpecifiedSize(values.fontSize));
       }
 
       if (mask & tsLetterSpacingMask)
-        fontDescription.setLetterSpacing(letterSpacing);
+        fontDescription.setLetterSpacing(values.letterSpacing);
 
       if (mask & tsWordSpacingMask)
-        fontDescription.setWordSpacing(wordSpacing);
+        fontDescription.setWordSpacing(values.wordSpacing);
 
       style->setFontDescription(fontDescription);
       style->font().update(UIDartState::Current()->font_selector());
     }
 
     if (mask & tsHeightMask) {
-      style->setLineHeight(Length(height * 100.0, Percent));
+      style->setLineHeight(Length(values.height * 100.0, Percent));
     }
 
-    encoded.Release();
-
     RenderObject* span = new RenderInline();
     span->setStyle(style.release());
     m_currentRenderObject->addChild(span);
@@ -408,7 +556,7 @@ void ParagraphBuilder::pushStyle(tonic::Int32List& encoded,
 }
 
 void ParagraphBuilder::pop() {
-  if (!Settings::Get().using_blink) {
+  if (!m_usingBlink) {
     m_paragraphBuilder->Pop();
   } else {
     // Blink Version.
@@ -417,14 +565,16 @@ void ParagraphBuilder::pop() {
   }
 }
 
-void ParagraphBuilder::addText(const std::string& text) {
-  if (!Settings::Get().using_blink) {
+void ParagraphBuilder::addText(const std::u16string& text) {
+  if (!m_usingBlink) {
     m_paragraphBuilder->AddText(text);
   } else {
     // Blink Version.
     if (!m_currentRenderObject)
       return;
-    RenderText* renderText = new RenderText(String::fromUTF8(text).impl());
+    RenderText* renderText = new RenderText(
+        String(reinterpret_cast<const UChar*>(text.data()), text.size())
+            .impl());
     RefPtr<RenderStyle> style = RenderStyle::create();
     style->inheritFrom(m_currentRenderObject->style());
     renderText->setStyle(style.release());
@@ -434,8 +584,11 @@ void ParagraphBuilder::addText(const std::string& text) {
 
 fxl::RefPtr<Paragraph> ParagraphBuilder::build() {
   m_currentRenderObject = nullptr;
-  if (!Settings::Get().using_blink) {
-    return Paragraph::Create(m_paragraphBuilder->Build());
+  if (!m_usingBlink) {
+    std::unique_ptr<txt::Paragraph> paragraph = m_paragraphBuilder->Build();
+    if (Settings::Get().concurrent_text_layout && Threads::Worker())
+      paragraph->SetWorkerTaskRunner(Threads::Worker());
+    return Paragraph::Create(std::move(paragraph));
   } else {
     return Paragraph::Create(m_renderView.release());
   }
@@ -448,8 +601,7 @@ void ParagraphBuilder::createRenderView() {
   style->setUserModify(READ_ONLY);
   createFontForDocument(style.get());
 
-  m_renderView = adoptPtr(new RenderView());
-  m_renderView->setStyle(style.release());
+  m_renderView = RenderViewPool::Get().Acquire(style.release());
 }
 
 }  // namespace blink
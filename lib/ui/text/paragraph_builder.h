@@ -20,6 +20,7 @@ class DartLibraryNatives;
 namespace blink {
 
 class Paragraph;
+struct InternedTextStyle;
 
 class ParagraphBuilder : public fxl::RefCountedThreadSafe<ParagraphBuilder>,
                          public tonic::DartWrappable {
@@ -42,12 +43,27 @@ class ParagraphBuilder : public fxl::RefCountedThreadSafe<ParagraphBuilder>,
                  double wordSpacing,
                  double height);
 
+  // Pushes a style returned by |registerTextStyle|.
+  void pushStyleHandle(int handle);
+
   void pop();
 
-  void addText(const std::string& text);
+  // Takes the text as UTF-16, as Dart strings hold it, so that it reaches txt
+  // without being transcoded to UTF-8 and back.
+  void addText(const std::u16string& text);
 
   fxl::RefPtr<Paragraph> build();
 
+  // Converts a text style once and returns its id, or 0 once the maximum
+  // number of styles has been registered. Registering an equal style again
+  // returns the same id. Callable from any isolate.
+  static int registerTextStyle(tonic::Int32List& encoded,
+                               const std::string& fontFamily,
+                               double fontSize,
+                               double letterSpacing,
+                               double wordSpacing,
+                               double height);
+
   static void RegisterNatives(tonic::DartLibraryNatives* natives);
 
  private:
@@ -59,10 +75,14 @@ class ParagraphBuilder : public fxl::RefCountedThreadSafe<ParagraphBuilder>,
 
   void createRenderView();
 
+  void pushInternedStyle(const InternedTextStyle& values);
+
   OwnPtr<RenderView> m_renderView;
   RenderObject* m_renderParagraph;
   RenderObject* m_currentRenderObject;
   std::unique_ptr<txt::ParagraphBuilder> m_paragraphBuilder;
+  // Whether the paragraph is laid out by Blink rather than by libtxt.
+  bool m_usingBlink;
 };
 
 }  // namespace blink
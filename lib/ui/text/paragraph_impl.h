@@ -38,6 +38,9 @@ class ParagraphImpl {
   virtual Dart_Handle getPositionForOffset(double dx, double dy) = 0;
 
   virtual Dart_Handle getWordBoundary(unsigned offset) = 0;
+
+  // The native memory held by the paragraph.
+  virtual size_t GetAllocationSize() = 0;
 };
 
 }  // namespace blink
@@ -4,12 +4,16 @@
 
 #include "flutter/lib/ui/text/paragraph_impl_blink.h"
 
+#include <algorithm>
+
 #include "flutter/common/threads.h"
 #include "flutter/lib/ui/text/paragraph.h"
 #include "flutter/lib/ui/text/paragraph_impl.h"
+#include "flutter/lib/ui/text/render_view_pool.h"
 #include "flutter/sky/engine/core/rendering/PaintInfo.h"
 #include "flutter/sky/engine/core/rendering/RenderParagraph.h"
 #include "flutter/sky/engine/core/rendering/RenderText.h"
+#include "flutter/sky/engine/core/rendering/RootInlineBox.h"
 #include "flutter/sky/engine/core/rendering/style/RenderStyle.h"
 #include "flutter/sky/engine/platform/fonts/FontCache.h"
 #include "flutter/sky/engine/platform/graphics/GraphicsContext.h"
@@ -28,17 +32,19 @@ ParagraphImplBlink::ParagraphImplBlink(PassOwnPtr<RenderView> renderView)
     : m_renderView(renderView) {}
 
 ParagraphImplBlink::~ParagraphImplBlink() {
-  if (m_renderView) {
-    RenderView* renderView = m_renderView.leakPtr();
-    Threads::UI()->PostTask([renderView]() { renderView->destroy(); });
-  }
+  if (m_renderView)
+    RenderViewPool::Get().Release(m_renderView.release());
 }
 
 double ParagraphImplBlink::width() {
+  if (m_hasSimpleLayout)
+    return m_layoutWidth;
   return firstChildBox()->width();
 }
 
 double ParagraphImplBlink::height() {
+  if (m_hasSimpleLayout)
+    return firstChildBox()->style()->computedLineHeight();
   return firstChildBox()->height();
 }
 
@@ -51,16 +57,22 @@ double ParagraphImplBlink::maxIntrinsicWidth() {
 }
 
 double ParagraphImplBlink::alphabeticBaseline() {
+  if (m_hasSimpleLayout)
+    return simpleTextBaseline(AlphabeticBaseline);
   return firstChildBox()->firstLineBoxBaseline(
       FontBaselineOrAuto(AlphabeticBaseline));
 }
 
 double ParagraphImplBlink::ideographicBaseline() {
+  if (m_hasSimpleLayout)
+    return simpleTextBaseline(IdeographicBaseline);
   return firstChildBox()->firstLineBoxBaseline(
       FontBaselineOrAuto(IdeographicBaseline));
 }
 
 bool ParagraphImplBlink::didExceedMaxLines() {
+  if (m_hasSimpleLayout)
+    return false;
   RenderBox* box = firstChildBox();
   ASSERT(box->isRenderParagraph());
   RenderParagraph* paragraph = static_cast<RenderParagraph*>(box);
@@ -71,8 +83,140 @@ void ParagraphImplBlink::layout(double width) {
   FontCachePurgePreventer fontCachePurgePreventer;
 
   int maxWidth = LayoutUnit(width);  // Handles infinity properly.
+
+  // A simple text that fits on one line needs no line layout.
+  if (RenderText* text = simpleText()) {
+    const Font& font = text->style()->font();
+    float textWidth = font.width(TextRun(text->text()));
+    if (LayoutUnit::fromFloatCeil(textWidth) <= maxWidth) {
+      m_hasSimpleLayout = true;
+      // The render tree is left as it was, at a width that is not recorded.
+      m_hasLayout = false;
+      m_layoutWidth = maxWidth;
+      return;
+    }
+  }
+  m_hasSimpleLayout = false;
+
   m_renderView->setFrameViewSize(IntSize(maxWidth, intMaxForLayoutUnit));
+  if (canKeepLineBreaks(maxWidth)) {
+    // Only the widths of the boxes depend on the new width.
+    m_renderView->setWidth(maxWidth);
+    firstChildBox()->setWidth(maxWidth);
+  } else {
+    m_renderView->layout();
+  }
+  m_hasLayout = true;
+  m_layoutWidth = maxWidth;
+}
+
+bool ParagraphImplBlink::canKeepLineBreaks(int width) {
+  if (!m_hasLayout || m_renderView->needsLayout())
+    return false;
+  if (width == m_layoutWidth)
+    return false;  // RenderView::layout() returns early by itself.
+
+  RenderBox* box = firstChildBox();
+  if (!box || !box->isRenderParagraph())
+    return false;
+  RenderParagraph* paragraph = static_cast<RenderParagraph*>(box);
+  RenderStyle* style = paragraph->style();
+
+  // Lines that are not aligned to the left edge move with the width.
+  bool leftAligned =
+      style->textAlign() == LEFT ||
+      (style->textAlign() == TASTART && style->isLeftToRightDirection());
+  if (!leftAligned || !style->ellipsis().isNull() ||
+      paragraph->didExceedMaxLines())
+    return false;
+
+  // Every line has to fit the new width...
+  float widestLine = 0;
+  for (RootInlineBox* line = paragraph->firstRootBox(); line;
+       line = line->nextRootBox())
+    widestLine = std::max(widestLine, line->logicalRight());
+  if (width < LayoutUnit::fromFloatCeil(widestLine))
+    return false;
+
+  // ...and a wider paragraph must not pull words back onto a wrapped line.
+  return width < m_layoutWidth ||
+         LayoutUnit(m_layoutWidth) >= paragraph->maxPreferredLogicalWidth();
+}
+
+RenderText* ParagraphImplBlink::simpleText() {
+  if (m_checkedSimpleText)
+    return m_simpleText;
+  m_checkedSimpleText = true;
+
+  RenderBox* box = firstChildBox();
+  if (!box || !box->isRenderParagraph() || box->nextSibling())
+    return nullptr;
+  RenderObject* child = box->slowFirstChild();
+  if (!child || !child->isText() || child->nextSibling())
+    return nullptr;
+  RenderText* text = toRenderText(child);
+  if (!text->canUseSimpleFontCodePath())
+    return nullptr;
+
+  RenderStyle* style = box->style();
+  RenderStyle* textStyle = text->style();
+  bool leftAligned =
+      style->textAlign() == LEFT ||
+      (style->textAlign() == TASTART && style->isLeftToRightDirection());
+  if (!leftAligned || textStyle->font() != style->font() ||
+      textStyle->textDecorationsInEffect() != TextDecorationNone ||
+      textStyle->textShadow() || textStyle->textStrokeWidth() > 0)
+    return nullptr;
+
+  // Collapsible white space would be removed or merged by line layout.
+  const String& string = text->text();
+  if (string.isEmpty() || !string.is8Bit())
+    return nullptr;
+  for (unsigned i = 0; i < string.length(); ++i) {
+    LChar c = string[i];
+    if (c == ' ') {
+      if (i == 0 || i + 1 == string.length() || string[i + 1] == ' ')
+        return nullptr;
+    } else if (c < 0x21 || c > 0x7E) {
+      return nullptr;
+    }
+  }
+
+  m_simpleText = text;
+  return m_simpleText;
+}
+
+double ParagraphImplBlink::simpleTextBaseline(FontBaseline baselineType) {
+  RenderStyle* style = firstChildBox()->style();
+  const FontMetrics& fontMetrics = style->fontMetrics();
+  // Matches RenderBlock::baselinePosition for the root line box.
+  return fontMetrics.ascent(baselineType) +
+         (style->computedLineHeight() - fontMetrics.height()) / 2;
+}
+
+void ParagraphImplBlink::paintSimpleText(Canvas* canvas, double x, double y) {
+  RenderStyle* style = m_simpleText->style();
+  GraphicsContext context(canvas->canvas());
+  context.setFillColor(style->resolveColor(style->textFillColor()));
+
+  TextRun run(m_simpleText->text());
+  TextRunPaintInfo runInfo(run);
+  runInfo.bounds = FloatRect(0, 0, width(), height());
+  runInfo.bounds.move(x, y);
+  runInfo.cachedTextBlob = nullptr;
+  context.drawText(style->font(), runInfo,
+                   FloatPoint(x, y + simpleTextBaseline(AlphabeticBaseline)));
+}
+
+void ParagraphImplBlink::ensureFullLayout() {
+  if (!m_hasSimpleLayout)
+    return;
+  m_hasSimpleLayout = false;
+
+  FontCachePurgePreventer fontCachePurgePreventer;
+  m_renderView->setFrameViewSize(IntSize(m_layoutWidth, intMaxForLayoutUnit));
   m_renderView->layout();
+  m_hasLayout = true;
 }
 
 void ParagraphImplBlink::paint(Canvas* canvas, double x, double y) {
@@ -82,6 +226,11 @@ void ParagraphImplBlink::paint(Canvas* canvas, double x, double y) {
 
   FontCachePurgePreventer fontCachePurgePreventer;
 
+  if (m_hasSimpleLayout) {
+    paintSimpleText(canvas, x, y);
+    return;
+  }
+
   // Very simplified painting to allow painting an arbitrary (layer-less)
   // subtree.
   RenderBox* box = firstChildBox();
@@ -104,6 +253,8 @@ std::vector<TextBox> ParagraphImplBlink::getRectsForRange(unsigned start,
   if (end <= start || start == end)
     return std::vector<TextBox>();
 
+  ensureFullLayout();
+
   unsigned offset = 0;
   std::vector<TextBox> boxes;
   for (RenderObject* object = m_renderView.get(); object;
@@ -143,6 +294,7 @@ int ParagraphImplBlink::absoluteOffsetForPosition(
 }
 
 Dart_Handle ParagraphImplBlink::getPositionForOffset(double dx, double dy) {
+  ensureFullLayout();
   LayoutPoint point(dx, dy);
   PositionWithAffinity position = m_renderView->positionForPoint(point);
   Dart_Handle result = Dart_NewList(2);
@@ -177,4 +329,11 @@ Dart_Handle ParagraphImplBlink::getWordBoundary(unsigned offset) {
   return result;
 }
 
+size_t ParagraphImplBlink::GetAllocationSize() {
+  // We don't have an accurate accounting of the render tree's memory
+  // consumption, so return a fixed size to indicate that its impact is more
+  // than the size of the Paragraph class.
+  return 2000;
+}
+
 }  // namespace blink
@@ -34,6 +34,8 @@ class ParagraphImplBlink : public ParagraphImpl {
   Dart_Handle getPositionForOffset(double dx, double dy) override;
   Dart_Handle getWordBoundary(unsigned offset) override;
 
+  size_t GetAllocationSize() override;
+
   RenderView* renderView() const { return m_renderView.get(); }
 
  private:
@@ -41,7 +43,27 @@ class ParagraphImplBlink : public ParagraphImpl {
 
   int absoluteOffsetForPosition(const PositionWithAffinity& position);
 
+  // Whether laying out at |width| would break the lines where the last layout
+  // did and place them at the same offsets.
+  bool canKeepLineBreaks(int width);
+
+  // Returns the only text of the paragraph if it is a single run of printable
+  // ASCII in the style of the paragraph, which lays out as one left aligned
+  // line without bidi resolution or line boxes whenever it fits.
+  RenderText* simpleText();
+  double simpleTextBaseline(FontBaseline baselineType);
+  void paintSimpleText(Canvas* canvas, double x, double y);
+  // Lays out the render tree if the last layout used the simple text path.
+  void ensureFullLayout();
+
   OwnPtr<RenderView> m_renderView;
+  bool m_hasLayout = false;
+  int m_layoutWidth = 0;
+  bool m_checkedSimpleText = false;
+  RenderText* m_simpleText = nullptr;
+  // Whether the last layout measured |m_simpleText| instead of laying out the
+  // render tree.
+  bool m_hasSimpleLayout = false;
 };
 
 }  // namespace blink
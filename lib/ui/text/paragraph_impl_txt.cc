@@ -59,6 +59,7 @@ void ParagraphImplTxt::paint(Canvas* canvas, double x, double y) {
   if (!sk_canvas)
     return;
   m_paragraph->Paint(sk_canvas, x, y);
+  canvas->AddReferencedBytes(m_paragraph->GetTextBlobMemoryUsage());
 }
 
 std::vector<TextBox> ParagraphImplTxt::getRectsForRange(unsigned start,
@@ -90,4 +91,8 @@ Dart_Handle ParagraphImplTxt::getWordBoundary(unsigned offset) {
   return result;
 }
 
+size_t ParagraphImplTxt::GetAllocationSize() {
+  return m_paragraph->GetMemoryUsage();
+}
+
 }  // namespace blink
@@ -0,0 +1,192 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/text/persistent_layout_cache.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "lib/fxl/files/file.h"
+#include "lib/fxl/logging.h"
+#include "lib/fxl/time/time_delta.h"
+
+namespace blink {
+namespace {
+
+const uint32_t kFileMagic = 0x4354584c;  // 'LXTC'
+const uint32_t kFileVersion = 1;
+
+// Words shaped during startup usually arrive in a burst. Waiting before
+// writing them collects the burst into one write off the critical path.
+constexpr fxl::TimeDelta kWriteDelay = fxl::TimeDelta::FromSeconds(5);
+
+bool ReadUint32(const uint8_t** cursor, const uint8_t* end, uint32_t* value) {
+  if (static_cast<size_t>(end - *cursor) < sizeof(uint32_t)) {
+    return false;
+  }
+  memcpy(value, *cursor, sizeof(uint32_t));
+  *cursor += sizeof(uint32_t);
+  return true;
+}
+
+void AppendUint32(std::string* out, uint32_t value) {
+  out->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void AppendEntry(std::string* out,
+                 const std::string& key,
+                 const char* value,
+                 size_t value_size) {
+  AppendUint32(out, key.size());
+  AppendUint32(out, value_size);
+  out->append(key);
+  out->append(value, value_size);
+}
+
+}  // namespace
+
+PersistentLayoutCache::PersistentLayoutCache(
+    std::string path,
+    fxl::RefPtr<fxl::TaskRunner> task_runner,
+    size_t max_entries)
+    : path_(std::move(path)),
+      task_runner_(std::move(task_runner)),
+      max_entries_(max_entries),
+      mapping_(std::make_unique<fml::FileMapping>(path_)) {
+  ReadEntries();
+}
+
+PersistentLayoutCache::~PersistentLayoutCache() = default;
+
+void PersistentLayoutCache::ReadEntries() {
+  const uint8_t* cursor = mapping_->GetMapping();
+  if (cursor == nullptr) {
+    return;
+  }
+  const uint8_t* end = cursor + mapping_->GetSize();
+
+  uint32_t magic, version, count;
+  if (!ReadUint32(&cursor, end, &magic) ||
+      !ReadUint32(&cursor, end, &version) ||
+      !ReadUint32(&cursor, end, &count) || magic != kFileMagic ||
+      version != kFileVersion) {
+    FXL_DLOG(WARNING) << "Ignoring the text layout cache at " << path_;
+    return;
+  }
+
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t key_size, value_size;
+    if (!ReadUint32(&cursor, end, &key_size) ||
+        !ReadUint32(&cursor, end, &value_size) ||
+        static_cast<size_t>(end - cursor) <
+            static_cast<size_t>(key_size) + value_size) {
+      FXL_DLOG(WARNING) << "The text layout cache at " << path_
+                        << " is truncated.";
+      return;
+    }
+    std::string key(reinterpret_cast<const char*>(cursor), key_size);
+    cursor += key_size;
+    stored_[std::move(key)] = {cursor, value_size, false};
+    cursor += value_size;
+  }
+}
+
+bool PersistentLayoutCache::get(const std::string& key, std::string* value) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto added = added_.find(key);
+  if (added != added_.end()) {
+    *value = added->second;
+    return true;
+  }
+  auto stored = stored_.find(key);
+  if (stored != stored_.end()) {
+    stored->second.used = true;
+    value->assign(reinterpret_cast<const char*>(stored->second.data),
+                  stored->second.size);
+    return true;
+  }
+  return false;
+}
+
+void PersistentLayoutCache::put(const std::string& key,
+                                const std::string& value) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (max_entries_ != 0 && added_.size() >= max_entries_) {
+    return;
+  }
+  added_[key] = value;
+  if (write_scheduled_) {
+    return;
+  }
+  write_scheduled_ = true;
+  std::weak_ptr<PersistentLayoutCache> weak_this = shared_from_this();
+  task_runner_->PostDelayedTask(
+      [weak_this]() {
+        if (auto cache = weak_this.lock()) {
+          cache->Write();
+        }
+      },
+      kWriteDelay);
+}
+
+void PersistentLayoutCache::Write() {
+  std::string file;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    write_scheduled_ = false;
+
+    // New words first, then the stored words this launch used, then the rest
+    // while there is room.
+    std::vector<const std::pair<const std::string, StoredEntry>*> unused;
+    std::string entries;
+    uint32_t count = 0;
+    auto has_room = [this, &count]() {
+      return max_entries_ == 0 || count < max_entries_;
+    };
+    for (const auto& entry : added_) {
+      AppendEntry(&entries, entry.first, entry.second.data(),
+                  entry.second.size());
+      count++;
+    }
+    for (const auto& entry : stored_) {
+      if (added_.count(entry.first)) {
+        continue;
+      }
+      if (!entry.second.used) {
+        unused.push_back(&entry);
+      } else if (has_room()) {
+        AppendEntry(&entries, entry.first,
+                    reinterpret_cast<const char*>(entry.second.data),
+                    entry.second.size);
+        count++;
+      }
+    }
+    for (const auto* entry : unused) {
+      if (!has_room()) {
+        break;
+      }
+      AppendEntry(&entries, entry->first,
+                  reinterpret_cast<const char*>(entry->second.data),
+                  entry->second.size);
+      count++;
+    }
+
+    AppendUint32(&file, kFileMagic);
+    AppendUint32(&file, kFileVersion);
+    AppendUint32(&file, count);
+    file.append(entries);
+  }
+
+  // Replace the file instead of writing it in place so that the mapping of
+  // the old one stays valid.
+  const std::string temp_path = path_ + ".tmp";
+  if (!files::WriteFile(temp_path, file.data(), file.size()) ||
+      ::rename(temp_path.c_str(), path_.c_str()) != 0) {
+    FXL_DLOG(WARNING) << "Could not write the text layout cache to " << path_;
+  }
+}
+
+}  // namespace blink
@@ -0,0 +1,72 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_TEXT_PERSISTENT_LAYOUT_CACHE_H_
+#define FLUTTER_LIB_UI_TEXT_PERSISTENT_LAYOUT_CACHE_H_
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "flutter/fml/mapping.h"
+#include "lib/fxl/macros.h"
+#include "lib/fxl/memory/ref_ptr.h"
+#include "lib/fxl/tasks/task_runner.h"
+#include "minikin/Layout.h"
+
+namespace blink {
+
+// Keeps the shaped words of previous launches in a file so that the text of
+// the first frames does not have to be shaped again. The file is mapped when
+// the cache is created and rewritten on the task runner a few seconds after
+// new words are added.
+class PersistentLayoutCache
+    : public minikin::LayoutCacheStorage,
+      public std::enable_shared_from_this<PersistentLayoutCache> {
+ public:
+  // Zero max_entries keeps every word.
+  PersistentLayoutCache(std::string path,
+                        fxl::RefPtr<fxl::TaskRunner> task_runner,
+                        size_t max_entries);
+
+  ~PersistentLayoutCache() override;
+
+  // |minikin::LayoutCacheStorage|
+  bool get(const std::string& key, std::string* value) override;
+
+  // |minikin::LayoutCacheStorage|
+  void put(const std::string& key, const std::string& value) override;
+
+ private:
+  const std::string path_;
+  fxl::RefPtr<fxl::TaskRunner> task_runner_;
+  const size_t max_entries_;
+  std::unique_ptr<fml::FileMapping> mapping_;
+
+  // A value of the mapped file, pointing into mapping_.
+  struct StoredEntry {
+    const uint8_t* data;
+    size_t size;
+    // Whether this launch looked the word up. Words that are not looked up
+    // are the first to be dropped when the file is full.
+    bool used;
+  };
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, StoredEntry> stored_;
+  // Words shaped since the file was mapped.
+  std::unordered_map<std::string, std::string> added_;
+  bool write_scheduled_ = false;
+
+  void ReadEntries();
+
+  void Write();
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(PersistentLayoutCache);
+};
+
+}  // namespace blink
+
+#endif  // FLUTTER_LIB_UI_TEXT_PERSISTENT_LAYOUT_CACHE_H_
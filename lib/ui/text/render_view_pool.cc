@@ -0,0 +1,71 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/text/render_view_pool.h"
+
+#include "flutter/common/threads.h"
+#include "flutter/glue/trace_event.h"
+#include "flutter/sky/engine/core/rendering/style/RenderStyle.h"
+
+namespace blink {
+
+constexpr size_t RenderViewPool::kMaxPooledViews;
+
+RenderViewPool RenderViewPool::instance_;
+
+RenderViewPool::RenderViewPool() : drain_pending_(false) {}
+
+RenderViewPool& RenderViewPool::Get() {
+  return instance_;
+}
+
+PassOwnPtr<RenderView> RenderViewPool::Acquire(PassRefPtr<RenderStyle> style) {
+  RenderView* view;
+  if (pooled_.empty()) {
+    view = new RenderView();
+  } else {
+    view = pooled_.back();
+    pooled_.pop_back();
+  }
+  view->setStyle(style);
+  return adoptPtr(view);
+}
+
+void RenderViewPool::Release(PassOwnPtr<RenderView> view) {
+  RenderView* render_view = view.leakPtr();
+  if (!render_view) {
+    return;
+  }
+  fxl::MutexLocker lock(&mutex_);
+  released_.push_back(render_view);
+  if (!drain_pending_) {
+    drain_pending_ = true;
+    Threads::UI()->PostTask([this] { Drain(); });
+  }
+}
+
+void RenderViewPool::Drain() {
+  TRACE_EVENT0("flutter", "RenderViewPool::Drain");
+  std::deque<RenderView*> released;
+  {
+    fxl::MutexLocker lock(&mutex_);
+    released_.swap(released);
+    drain_pending_ = false;
+  }
+  RenderObject::TreeTeardownScope teardown;
+  for (RenderView* view : released) {
+    if (pooled_.size() >= kMaxPooledViews) {
+      view->destroy();
+      continue;
+    }
+    // Positioned children are not unlinked from the view while it is torn
+    // down.
+    view->removePositionedObjects(nullptr);
+    while (RenderObject* child = view->slowFirstChild())
+      child->destroy();
+    pooled_.push_back(view);
+  }
+}
+
+}  // namespace blink
@@ -0,0 +1,52 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_TEXT_RENDER_VIEW_POOL_H_
+#define FLUTTER_LIB_UI_TEXT_RENDER_VIEW_POOL_H_
+
+#include <deque>
+#include <vector>
+
+#include "flutter/sky/engine/core/rendering/RenderView.h"
+#include "flutter/sky/engine/wtf/PassOwnPtr.h"
+#include "flutter/sky/engine/wtf/PassRefPtr.h"
+#include "lib/fxl/macros.h"
+#include "lib/fxl/synchronization/mutex.h"
+
+namespace blink {
+
+// Recycles the RenderViews that Blink paragraphs are laid out in. Released
+// views are emptied on the UI thread in one task for everything released
+// since the last one, and kept for the next paragraphs that are built.
+class RenderViewPool {
+ public:
+  static constexpr size_t kMaxPooledViews = 64;
+
+  static RenderViewPool& Get();
+
+  // Returns an empty view with |style|. Only called on the UI thread.
+  PassOwnPtr<RenderView> Acquire(PassRefPtr<RenderStyle> style);
+
+  // Destroys the contents of |view| on the UI thread and pools it. May be
+  // called on any thread.
+  void Release(PassOwnPtr<RenderView> view);
+
+ private:
+  RenderViewPool();
+  void Drain();
+
+  static RenderViewPool instance_;
+
+  fxl::Mutex mutex_;
+  std::deque<RenderView*> released_ FXL_GUARDED_BY(mutex_);
+  bool drain_pending_ FXL_GUARDED_BY(mutex_);
+  // Only used on the UI thread.
+  std::vector<RenderView*> pooled_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(RenderViewPool);
+};
+
+}  // namespace blink
+
+#endif  // FLUTTER_LIB_UI_TEXT_RENDER_VIEW_POOL_H_
@@ -10,6 +10,9 @@ typedef void VoidCallback();
 /// Signature for [Window.onBeginFrame].
 typedef void FrameCallback(Duration duration);
 
+/// Signature for [Window.onReportTimings].
+typedef void TimingsCallback(List<FrameTiming> timings);
+
 /// Signature for [Window.onPointerDataPacket].
 typedef void PointerDataPacketCallback(PointerDataPacket packet);
 
@@ -25,6 +28,83 @@ typedef void PlatformMessageResponseCallback(ByteData data);
 /// Signature for [Window.onPlatformMessage].
 typedef void PlatformMessageCallback(String name, ByteData data, PlatformMessageResponseCallback callback);
 
+/// Signature for [Window.onJsonPlatformMessage].
+typedef void JsonPlatformMessageCallback(String name, dynamic message, PlatformMessageResponseCallback callback);
+
+/// The phases a frame passes through between the vsync signal that started
+/// it and the moment it was handed to the screen.
+enum FramePhase {
+  /// When the vsync signal that started the frame was received.
+  vsyncStart,
+
+  /// When the UI thread started building the frame.
+  buildStart,
+
+  /// When the UI thread finished building the frame.
+  buildFinish,
+
+  /// When the GPU thread started rasterizing the frame.
+  rasterStart,
+
+  /// When the GPU thread finished rasterizing the frame.
+  rasterFinish,
+
+  /// When the rasterized frame was presented to the screen.
+  present,
+
+  /// When the frame appeared on the display.
+  ///
+  /// Only known on platforms that report when presented frames are displayed.
+  /// Zero elsewhere, and for frames the display skipped.
+  display,
+}
+
+/// Timestamps of a single presented frame.
+///
+/// See also:
+///
+///  * [Window.onReportTimings], which delivers these records.
+class FrameTiming {
+  FrameTiming._(this.frameNumber, this._timestamps);
+
+  /// The sequence number of the frame. Frame numbers increase by one for each
+  /// frame the engine begins, so gaps indicate frames that were never
+  /// presented.
+  final int frameNumber;
+
+  final List<int> _timestamps;
+
+  /// The time at which the frame reached the given [phase], on the same
+  /// clock as the durations passed to [Window.onBeginFrame].
+  Duration timestampInMicroseconds(FramePhase phase) {
+    return new Duration(microseconds: _timestamps[phase.index]);
+  }
+
+  /// The time the UI thread spent building the frame.
+  Duration get buildDuration => timestampInMicroseconds(FramePhase.buildFinish) - timestampInMicroseconds(FramePhase.buildStart);
+
+  /// The time the GPU thread spent rasterizing the frame.
+  Duration get rasterDuration => timestampInMicroseconds(FramePhase.rasterFinish) - timestampInMicroseconds(FramePhase.rasterStart);
+
+  /// The time between the vsync signal that started the frame and the frame
+  /// being presented.
+  Duration get totalSpan => timestampInMicroseconds(FramePhase.present) - timestampInMicroseconds(FramePhase.vsyncStart);
+
+  /// Whether the time the frame appeared on the display is known.
+  ///
+  /// See also:
+  ///
+  ///  * [FramePhase.display], which explains when it is not.
+  bool get wasDisplayed => _timestamps[FramePhase.display.index] != 0;
+
+  /// The time between the vsync signal that started the frame and the frame
+  /// appearing on the display. Zero unless [wasDisplayed].
+  Duration get displaySpan => wasDisplayed ? timestampInMicroseconds(FramePhase.display) - timestampInMicroseconds(FramePhase.vsyncStart) : Duration.ZERO;
+
+  @override
+  String toString() => '$runtimeType(frameNumber: $frameNumber, buildDuration: $buildDuration, rasterDuration: $rasterDuration, totalSpan: $totalSpan)';
+}
+
 /// States that an application can be in.
 ///
 /// The values below describe notifications from the operating system.
@@ -342,6 +422,22 @@ class Window {
     _onDrawFrameZone = Zone.current;
   }
 
+  /// A callback that is invoked with the timings of frames that have been
+  /// presented.
+  ///
+  /// Timings are delivered in batches, roughly once a second while frames
+  /// are being produced, so this callback is not invoked for every frame.
+  ///
+  /// The framework invokes this callback in the same zone in which the
+  /// callback was set.
+  TimingsCallback get onReportTimings => _onReportTimings;
+  TimingsCallback _onReportTimings;
+  Zone _onReportTimingsZone;
+  set onReportTimings(TimingsCallback callback) {
+    _onReportTimings = callback;
+    _onReportTimingsZone = Zone.current;
+  }
+
   /// A callback that is invoked when pointer data is available.
   ///
   /// The framework invokes this callback in the same zone in which the
@@ -483,6 +579,40 @@ class Window {
     _onPlatformMessageZone = Zone.current;
   }
 
+  /// Called whenever this window receives a message on one of the channels
+  /// whose messages the engine decodes as JSON.
+  ///
+  /// These channels are given to the engine with the
+  /// `--json-platform-message-channels` switch. Once this callback is set, the
+  /// engine parses the messages of those channels on a background thread and
+  /// passes `message` already decoded, as maps, lists, strings, numbers,
+  /// booleans and nulls, as `JSON.decode` would. The lists are fixed-length.
+  /// Messages that are empty or not valid JSON are passed to
+  /// [onPlatformMessage] instead.
+  ///
+  /// The messages of a channel arrive in order, but not necessarily in order
+  /// with those of other channels.
+  ///
+  /// Message handlers must call the function given in the `callback`
+  /// parameter, as for [onPlatformMessage].
+  ///
+  /// The framework invokes this callback in the same zone in which the
+  /// callback was set.
+  JsonPlatformMessageCallback get onJsonPlatformMessage => _onJsonPlatformMessage;
+  JsonPlatformMessageCallback _onJsonPlatformMessage;
+  Zone _onJsonPlatformMessageZone;
+  RawReceivePort _jsonPlatformMessagePort;
+  set onJsonPlatformMessage(JsonPlatformMessageCallback callback) {
+    _onJsonPlatformMessage = callback;
+    _onJsonPlatformMessageZone = Zone.current;
+    if (_jsonPlatformMessagePort == null) {
+      _jsonPlatformMessagePort = new RawReceivePort(_dispatchJsonPlatformMessage);
+      _setJsonPlatformMessagePort(_jsonPlatformMessagePort.sendPort);
+    }
+  }
+  void _setJsonPlatformMessagePort(SendPort port)
+      native "Window_setJsonPlatformMessagePort";
+
   /// Called by [_dispatchPlatformMessage].
   void _respondToPlatformMessage(int responseId, ByteData data)
       native "Window_respondToPlatformMessage";
@@ -0,0 +1,176 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/window/json_platform_message.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+#include "flutter/common/settings.h"
+#include "flutter/glue/trace_event.h"
+#include "lib/fxl/macros.h"
+#include "third_party/dart/runtime/include/dart_native_api.h"
+#include "third_party/rapidjson/rapidjson/document.h"
+
+namespace blink {
+namespace {
+
+// Deeper documents are posted undecoded rather than risking the stack.
+constexpr int kMaxJsonDepth = 512;
+
+// Builds the Dart_CObject graph of a parsed document. Strings point into the
+// document, which has to outlive the graph.
+class CObjectBuilder {
+ public:
+  CObjectBuilder() = default;
+
+  Dart_CObject* NewObject(Dart_CObject_Type type) {
+    objects_.emplace_back();
+    Dart_CObject* object = &objects_.back();
+    object->type = type;
+    return object;
+  }
+
+  Dart_CObject** NewArray(Dart_CObject* object, size_t length) {
+    arrays_.emplace_back(length);
+    object->value.as_array.length = length;
+    object->value.as_array.values = arrays_.back().data();
+    return arrays_.back().data();
+  }
+
+  Dart_CObject* NewString(const char* string, size_t length) {
+    // The VM reads strings up to their terminator.
+    if (memchr(string, '\0', length) != nullptr)
+      return nullptr;
+    Dart_CObject* object = NewObject(Dart_CObject_kString);
+    object->value.as_string = const_cast<char*>(string);
+    return object;
+  }
+
+  Dart_CObject* NewBytes(uint8_t* bytes, size_t size) {
+    Dart_CObject* object = NewObject(Dart_CObject_kTypedData);
+    object->value.as_typed_data.type = Dart_TypedData_kUint8;
+    object->value.as_typed_data.length = size;
+    object->value.as_typed_data.values = bytes;
+    return object;
+  }
+
+  // JSON objects become arrays of their keys and values that start with an
+  // empty typed data, which JSON itself never produces.
+  Dart_CObject* Build(const rapidjson::Value& value, int depth) {
+    if (depth > kMaxJsonDepth)
+      return nullptr;
+    Dart_CObject* object = nullptr;
+    switch (value.GetType()) {
+      case rapidjson::kNullType:
+        object = NewObject(Dart_CObject_kNull);
+        break;
+      case rapidjson::kFalseType:
+      case rapidjson::kTrueType:
+        object = NewObject(Dart_CObject_kBool);
+        object->value.as_bool = value.GetBool();
+        break;
+      case rapidjson::kNumberType:
+        if (value.IsInt64()) {
+          object = NewObject(Dart_CObject_kInt64);
+          object->value.as_int64 = value.GetInt64();
+        } else {
+          object = NewObject(Dart_CObject_kDouble);
+          object->value.as_double = value.GetDouble();
+        }
+        break;
+      case rapidjson::kStringType:
+        object = NewString(value.GetString(), value.GetStringLength());
+        break;
+      case rapidjson::kArrayType: {
+        object = NewObject(Dart_CObject_kArray);
+        Dart_CObject** values = NewArray(object, value.Size());
+        for (rapidjson::SizeType i = 0; i < value.Size(); i++) {
+          values[i] = Build(value[i], depth + 1);
+          if (!values[i])
+            return nullptr;
+        }
+        break;
+      }
+      case rapidjson::kObjectType: {
+        object = NewObject(Dart_CObject_kArray);
+        Dart_CObject** values =
+            NewArray(object, 1 + 2 * value.MemberCount());
+        *values++ = NewBytes(nullptr, 0);
+        for (auto member = value.MemberBegin(); member != value.MemberEnd();
+             ++member) {
+          Dart_CObject* key = NewString(member->name.GetString(),
+                                        member->name.GetStringLength());
+          Dart_CObject* member_value = Build(member->value, depth + 1);
+          if (!key || !member_value)
+            return nullptr;
+          *values++ = key;
+          *values++ = member_value;
+        }
+        break;
+      }
+    }
+    return object;
+  }
+
+ private:
+  // Deques keep their elements in place as they grow.
+  std::deque<Dart_CObject> objects_;
+  std::deque<std::vector<Dart_CObject*>> arrays_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(CObjectBuilder);
+};
+
+}  // namespace
+
+bool IsJsonPlatformMessageChannel(const std::string& channel) {
+  const std::vector<std::string>& channels =
+      Settings::Get().json_platform_message_channels;
+  return std::find(channels.begin(), channels.end(), channel) !=
+         channels.end();
+}
+
+bool PostJsonPlatformMessage(Dart_Port port,
+                             PlatformMessage* message,
+                             int response_id) {
+  TRACE_EVENT1("flutter", "PostJsonPlatformMessage", "channel",
+               message->channel().c_str());
+  CObjectBuilder builder;
+  rapidjson::Document document;
+  Dart_CObject* payload = nullptr;
+  bool decoded = false;
+  if (message->hasData()) {
+    document.Parse<rapidjson::kParseIterativeFlag |
+                   rapidjson::kParseValidateEncodingFlag>(
+        reinterpret_cast<const char*>(message->data()), message->size());
+    if (!document.HasParseError())
+      payload = builder.Build(document, 0);
+    decoded = payload != nullptr;
+    if (!decoded) {
+      payload = builder.NewBytes(const_cast<uint8_t*>(message->data()),
+                                 message->size());
+    }
+  } else {
+    payload = builder.NewObject(Dart_CObject_kNull);
+  }
+
+  Dart_CObject* channel = builder.NewObject(Dart_CObject_kString);
+  channel->value.as_string = const_cast<char*>(message->channel().c_str());
+  Dart_CObject* id = builder.NewObject(Dart_CObject_kInt64);
+  id->value.as_int64 = response_id;
+  Dart_CObject* is_decoded = builder.NewObject(Dart_CObject_kBool);
+  is_decoded->value.as_bool = decoded;
+
+  Dart_CObject root;
+  root.type = Dart_CObject_kArray;
+  Dart_CObject* values[] = {channel, id, is_decoded, payload};
+  root.value.as_array.length = 4;
+  root.value.as_array.values = values;
+  return Dart_PostCObject(port, &root);
+}
+
+}  // namespace blink
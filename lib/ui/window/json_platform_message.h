@@ -0,0 +1,30 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_WINDOW_JSON_PLATFORM_MESSAGE_H_
+#define FLUTTER_LIB_UI_WINDOW_JSON_PLATFORM_MESSAGE_H_
+
+#include <string>
+
+#include "flutter/lib/ui/window/platform_message.h"
+#include "third_party/dart/runtime/include/dart_api.h"
+
+namespace blink {
+
+// Whether the messages of the channel are listed in
+// |Settings::json_platform_message_channels|.
+bool IsJsonPlatformMessageChannel(const std::string& channel);
+
+// Parses the payload of the message as JSON and posts it to the port, so that
+// the VM creates the decoded objects when the port handles the message rather
+// than Dart code parsing the payload. Payloads that are not valid JSON are
+// posted as they are. May be called on any thread. See
+// |_dispatchJsonPlatformMessage| in hooks.dart for the layout of the message.
+bool PostJsonPlatformMessage(Dart_Port port,
+                             PlatformMessage* message,
+                             int response_id);
+
+}  // namespace blink
+
+#endif  // FLUTTER_LIB_UI_WINDOW_JSON_PLATFORM_MESSAGE_H_
@@ -12,16 +12,51 @@ PlatformMessage::PlatformMessage(std::string channel,
                                  std::vector<uint8_t> data,
                                  fxl::RefPtr<PlatformMessageResponse> response)
     : channel_(std::move(channel)),
-      data_(std::move(data)),
+      vector_data_(std::move(data)),
+      data_(vector_data_.data()),
+      size_(vector_data_.size()),
       hasData_(true),
       response_(std::move(response)) {}
 PlatformMessage::PlatformMessage(std::string channel,
+                                 uint8_t* data,
+                                 size_t size,
+                                 fxl::Closure release,
                                  fxl::RefPtr<PlatformMessageResponse> response)
     : channel_(std::move(channel)),
-      data_(),
+      data_(data),
+      size_(size),
+      release_(std::move(release)),
+      hasData_(true),
+      response_(std::move(response)) {}
+PlatformMessage::PlatformMessage(std::string channel,
+                                 fxl::RefPtr<PlatformMessageResponse> response)
+    : channel_(std::move(channel)),
+      data_(nullptr),
+      size_(0),
       hasData_(false),
       response_(std::move(response)) {}
 
-PlatformMessage::~PlatformMessage() = default;
+PlatformMessage::~PlatformMessage() {
+  if (release_) {
+    release_();
+  }
+}
+
+fxl::Closure PlatformMessage::TakeData(uint8_t** data, size_t* size) {
+  *data = data_;
+  *size = size_;
+  data_ = nullptr;
+  size_ = 0;
+
+  if (release_) {
+    fxl::Closure release = std::move(release_);
+    release_ = nullptr;
+    return release;
+  }
+
+  // Move the vector to the heap so that the bytes stay where they are.
+  auto* vector = new std::vector<uint8_t>(std::move(vector_data_));
+  return [vector]() { delete vector; };
+}
 
 }  // namespace blink
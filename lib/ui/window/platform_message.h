@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "flutter/lib/ui/window/platform_message_response.h"
+#include "lib/fxl/functional/closure.h"
 #include "lib/fxl/memory/ref_counted.h"
 #include "lib/fxl/memory/ref_ptr.h"
 
@@ -20,23 +21,42 @@ class PlatformMessage : public fxl::RefCountedThreadSafe<PlatformMessage> {
 
  public:
   const std::string& channel() const { return channel_; }
-  const std::vector<uint8_t>& data() const { return data_; }
+  const uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
   bool hasData() { return hasData_; }
 
   const fxl::RefPtr<PlatformMessageResponse>& response() const {
     return response_;
   }
 
+  // Transfers ownership of the payload to the caller, who must invoke the
+  // returned closure once it is done with |*data|. The message keeps reporting
+  // that it has data but its payload is empty afterwards.
+  fxl::Closure TakeData(uint8_t** data, size_t* size);
+
  private:
   PlatformMessage(std::string name,
                   std::vector<uint8_t> data,
                   fxl::RefPtr<PlatformMessageResponse> response);
+  // Wraps |size| bytes at |data| without copying them. The message owns the
+  // buffer and invokes |release| once the buffer is no longer needed, which
+  // may happen on any thread. The buffer must be writable because it may be
+  // handed to Dart as-is.
+  PlatformMessage(std::string name,
+                  uint8_t* data,
+                  size_t size,
+                  fxl::Closure release,
+                  fxl::RefPtr<PlatformMessageResponse> response);
   PlatformMessage(std::string name,
                   fxl::RefPtr<PlatformMessageResponse> response);
   ~PlatformMessage();
 
   std::string channel_;
-  std::vector<uint8_t> data_;
+  // Backs |data_| unless the payload is an external buffer.
+  std::vector<uint8_t> vector_data_;
+  uint8_t* data_;
+  size_t size_;
+  fxl::Closure release_;
   bool hasData_;
   fxl::RefPtr<PlatformMessageResponse> response_;
 };
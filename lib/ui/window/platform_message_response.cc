@@ -10,4 +10,12 @@ PlatformMessageResponse::PlatformMessageResponse() = default;
 
 PlatformMessageResponse::~PlatformMessageResponse() = default;
 
+void PlatformMessageResponse::CompleteWithExternalData(uint8_t* data,
+                                                       size_t size,
+                                                       fxl::Closure release) {
+  std::vector<uint8_t> copy(data, data + size);
+  release();
+  Complete(std::move(copy));
+}
+
 }  // namespace blink
@@ -7,6 +7,7 @@
 
 #include <vector>
 
+#include "lib/fxl/functional/closure.h"
 #include "lib/fxl/memory/ref_counted.h"
 #include "lib/fxl/memory/ref_ptr.h"
 
@@ -21,6 +22,14 @@ class PlatformMessageResponse
   virtual void Complete(std::vector<uint8_t> data) = 0;
   virtual void CompleteEmpty() = 0;
 
+  // Completes with |size| bytes at |data|, which receivers that can refer to
+  // them hand on without copying. |release| is invoked once the bytes are no
+  // longer needed, which may happen on any thread. The bytes must be writable
+  // because they may be handed to Dart as-is. Copies them by default.
+  virtual void CompleteWithExternalData(uint8_t* data,
+                                        size_t size,
+                                        fxl::Closure release);
+
   bool is_complete() const { return is_complete_; }
 
  protected:
@@ -12,6 +12,39 @@
 #include "lib/tonic/logging/dart_invoke.h"
 
 namespace blink {
+namespace {
+
+void FinalizeExternalData(void* isolate_callback_data,
+                          Dart_WeakPersistentHandle handle,
+                          void* peer) {
+  auto* release = static_cast<fxl::Closure*>(peer);
+  (*release)();
+  delete release;
+}
+
+}  // namespace
+
+Dart_Handle ToExternalByteData(uint8_t* data,
+                               size_t size,
+                               fxl::Closure release) {
+  // The finalizer goes on the backing store. Views onto it, like the ByteData
+  // handed to Dart, keep it alive.
+  Dart_Handle array =
+      Dart_NewExternalTypedData(Dart_TypedData_kUint8, data, size);
+  if (Dart_IsError(array)) {
+    release();
+    return array;
+  }
+  Dart_NewWeakPersistentHandle(array, new fxl::Closure(std::move(release)),
+                               size, &FinalizeExternalData);
+
+  Dart_Handle buffer =
+      Dart_GetField(array, Dart_NewStringFromCString("buffer"));
+  if (Dart_IsError(buffer))
+    return buffer;
+  return Dart_Invoke(buffer, Dart_NewStringFromCString("asByteData"), 0,
+                     nullptr);
+}
 
 PlatformMessageResponseDart::PlatformMessageResponseDart(
     tonic::DartPersistentValue callback)
@@ -55,6 +88,38 @@ void PlatformMessageResponseDart::Complete(std::vector<uint8_t> data) {
       }));
 }
 
+void PlatformMessageResponseDart::CompleteWithExternalData(
+    uint8_t* data,
+    size_t size,
+    fxl::Closure release) {
+  if (size < kExternalPlatformMessageThreshold) {
+    PlatformMessageResponse::CompleteWithExternalData(data, size,
+                                                      std::move(release));
+    return;
+  }
+  if (callback_.is_empty()) {
+    release();
+    return;
+  }
+  FXL_DCHECK(!is_complete_);
+  is_complete_ = true;
+  Threads::UI()->PostTask(fxl::MakeCopyable([
+    callback = std::move(callback_), data, size, release = std::move(release)
+  ]() mutable {
+    tonic::DartState* dart_state = callback.dart_state().get();
+    if (!dart_state) {
+      release();
+      return;
+    }
+    tonic::DartState::Scope scope(dart_state);
+
+    Dart_Handle byte_buffer =
+        ToExternalByteData(data, size, std::move(release));
+    DART_CHECK_VALID(byte_buffer);
+    tonic::DartInvoke(callback.Release(), {byte_buffer});
+  }));
+}
+
 void PlatformMessageResponseDart::CompleteEmpty() {
   if (callback_.is_empty())
     return;
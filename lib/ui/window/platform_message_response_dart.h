@@ -6,10 +6,24 @@
 #define FLUTTER_LIB_UI_PLATFORM_PLATFORM_MESSAGE_RESPONSE_DART_H_
 
 #include "flutter/lib/ui/window/platform_message_response.h"
+#include "lib/fxl/functional/closure.h"
 #include "lib/tonic/dart_persistent_value.h"
+#include "third_party/dart/runtime/include/dart_api.h"
 
 namespace blink {
 
+// Platform messages and responses at least this large are handed to Dart
+// without a copy. Below it, copying is cheaper than the finalizer of an
+// external typed data.
+constexpr size_t kExternalPlatformMessageThreshold = 16 * 1024;
+
+// Wraps |size| bytes at |data| in a ByteData without copying them. |release|
+// is invoked once Dart no longer refers to them, or right away if the
+// ByteData could not be created. Requires a current isolate.
+Dart_Handle ToExternalByteData(uint8_t* data,
+                               size_t size,
+                               fxl::Closure release);
+
 class PlatformMessageResponseDart : public PlatformMessageResponse {
   FRIEND_MAKE_REF_COUNTED(PlatformMessageResponseDart);
 
@@ -17,6 +31,9 @@ class PlatformMessageResponseDart : public PlatformMessageResponse {
   // Callable on any thread.
   void Complete(std::vector<uint8_t> data) override;
   void CompleteEmpty() override;
+  void CompleteWithExternalData(uint8_t* data,
+                                size_t size,
+                                fxl::Closure release) override;
 
  protected:
   explicit PlatformMessageResponseDart(tonic::DartPersistentValue callback);
@@ -23,6 +23,13 @@ class PointerDataPacket {
   void SetPointerData(size_t i, const PointerData& data);
   const std::vector<uint8_t>& data() const { return data_; }
 
+  // Moves the bytes out of the packet, leaving it empty.
+  std::vector<uint8_t> TakeData() {
+    std::vector<uint8_t> data;
+    data.swap(data_);
+    return data;
+  }
+
  private:
   std::vector<uint8_t> data_;
 
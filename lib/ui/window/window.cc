@@ -4,8 +4,10 @@
 
 #include "flutter/lib/ui/window/window.h"
 
+#include "flutter/common/threads.h"
 #include "flutter/lib/ui/compositing/scene.h"
 #include "flutter/lib/ui/ui_dart_state.h"
+#include "flutter/lib/ui/window/json_platform_message.h"
 #include "flutter/lib/ui/window/platform_message_response_dart.h"
 #include "lib/tonic/converter/dart_converter.h"
 #include "lib/tonic/dart_args.h"
@@ -22,9 +24,8 @@ using tonic::ToDart;
 namespace blink {
 namespace {
 
-Dart_Handle ToByteData(const std::vector<uint8_t>& buffer) {
-  Dart_Handle data_handle =
-      Dart_NewTypedData(Dart_TypedData_kByteData, buffer.size());
+Dart_Handle ToByteData(const uint8_t* bytes, size_t size) {
+  Dart_Handle data_handle = Dart_NewTypedData(Dart_TypedData_kByteData, size);
   if (Dart_IsError(data_handle))
     return data_handle;
 
@@ -34,11 +35,30 @@ Dart_Handle ToByteData(const std::vector<uint8_t>& buffer) {
   FXL_CHECK(!Dart_IsError(
       Dart_TypedDataAcquireData(data_handle, &type, &data, &num_bytes)));
 
-  memcpy(data, buffer.data(), num_bytes);
+  memcpy(data, bytes, num_bytes);
   Dart_TypedDataReleaseData(data_handle);
   return data_handle;
 }
 
+Dart_Handle ToByteData(const std::vector<uint8_t>& buffer) {
+  return ToByteData(buffer.data(), buffer.size());
+}
+
+// Wraps the payload of |message| in a ByteData without copying it.
+Dart_Handle ToExternalByteData(PlatformMessage* message) {
+  uint8_t* bytes = nullptr;
+  size_t size = 0;
+  fxl::Closure release = message->TakeData(&bytes, &size);
+  return blink::ToExternalByteData(bytes, size, std::move(release));
+}
+
+// Wraps the bytes of |packet| in a ByteData without copying them.
+Dart_Handle ToExternalByteData(std::unique_ptr<PointerDataPacket> packet) {
+  auto* data = new std::vector<uint8_t>(packet->TakeData());
+  return blink::ToExternalByteData(data->data(), data->size(),
+                                   [data]() { delete data; });
+}
+
 void DefaultRouteName(Dart_NativeArguments args) {
   std::string routeName =
       UIDartState::Current()->window()->client()->DefaultRouteName();
@@ -117,6 +137,17 @@ void _RespondToPlatformMessage(Dart_NativeArguments args) {
   tonic::DartCallStatic(&RespondToPlatformMessage, args);
 }
 
+void SetJsonPlatformMessagePort(Dart_NativeArguments args) {
+  Dart_Port port = ILLEGAL_PORT;
+  Dart_Handle result =
+      Dart_SendPortGetId(Dart_GetNativeArgument(args, 1), &port);
+  if (Dart_IsError(result)) {
+    Dart_PropagateError(result);
+    return;
+  }
+  UIDartState::Current()->window()->set_json_platform_message_port(port);
+}
+
 }  // namespace
 
 WindowClient::~WindowClient() {}
@@ -151,6 +182,9 @@ void Window::UpdateWindowMetrics(const ViewportMetrics& metrics) {
 
 void Window::UpdateLocale(const std::string& language_code,
                           const std::string& country_code) {
+  locale_tag_ = country_code.empty() ? language_code
+                                     : language_code + "-" + country_code;
+
   tonic::DartState* dart_state = library_.dart_state().get();
   if (!dart_state)
     return;
@@ -189,18 +223,30 @@ void Window::DispatchPlatformMessage(fxl::RefPtr<PlatformMessage> message) {
   tonic::DartState* dart_state = library_.dart_state().get();
   if (!dart_state)
     return;
-  tonic::DartState::Scope scope(dart_state);
-  Dart_Handle data_handle =
-      (message->hasData()) ? ToByteData(message->data()) : Dart_Null();
-  if (Dart_IsError(data_handle))
+
+  if (json_platform_message_port_ != ILLEGAL_PORT &&
+      IsJsonPlatformMessageChannel(message->channel())) {
+    // The IO thread runs tasks in order, so the messages of a channel still
+    // arrive in order.
+    int response_id = RegisterPendingResponse(message.get());
+    Threads::IO()->PostTask(
+        [port = json_platform_message_port_, message, response_id]() {
+          PostJsonPlatformMessage(port, message.get(), response_id);
+        });
     return;
+  }
 
-  int response_id = 0;
-  if (auto response = message->response()) {
-    response_id = next_response_id_++;
-    pending_responses_[response_id] = response;
+  tonic::DartState::Scope scope(dart_state);
+  Dart_Handle data_handle = Dart_Null();
+  if (message->hasData()) {
+    data_handle = message->size() >= kExternalPlatformMessageThreshold
+                      ? ToExternalByteData(message.get())
+                      : ToByteData(message->data(), message->size());
   }
+  if (Dart_IsError(data_handle))
+    return;
 
+  int response_id = RegisterPendingResponse(message.get());
   DartInvokeField(
       library_.value(), "_dispatchPlatformMessage",
       {ToDart(message->channel()), data_handle, ToDart(response_id)});
@@ -219,6 +265,25 @@ void Window::DispatchPointerDataPacket(const PointerDataPacket& packet) {
                   {data_handle});
 }
 
+void Window::DispatchPointerDataPacket(
+    std::unique_ptr<PointerDataPacket> packet) {
+  if (packet->data().size() < kExternalPlatformMessageThreshold) {
+    DispatchPointerDataPacket(*packet);
+    return;
+  }
+
+  tonic::DartState* dart_state = library_.dart_state().get();
+  if (!dart_state)
+    return;
+  tonic::DartState::Scope scope(dart_state);
+
+  Dart_Handle data_handle = ToExternalByteData(std::move(packet));
+  if (Dart_IsError(data_handle))
+    return;
+  DartInvokeField(library_.value(), "_dispatchPointerDataPacket",
+                  {data_handle});
+}
+
 void Window::DispatchSemanticsAction(int32_t id, SemanticsAction action) {
   tonic::DartState* dart_state = library_.dart_state().get();
   if (!dart_state)
@@ -247,6 +312,41 @@ void Window::BeginFrame(fxl::TimePoint frameTime) {
   DartInvokeField(library_.value(), "_drawFrame", {});
 }
 
+void Window::ReportTimings(const std::vector<flow::FrameTiming>& timings) {
+  tonic::DartState* dart_state = library_.dart_state().get();
+  if (!dart_state)
+    return;
+  tonic::DartState::Scope scope(dart_state);
+
+  // Each record is packed as the frame number followed by the timestamp of
+  // each phase. See |_unpackFrameTimings| in hooks.dart.
+  std::vector<int64_t> fields;
+  fields.reserve(timings.size() * (flow::FrameTiming::kPhaseCount + 1));
+  for (const auto& timing : timings) {
+    fields.push_back(timing.frame_number());
+    for (int phase = 0; phase < flow::FrameTiming::kPhaseCount; phase++) {
+      fields.push_back(
+          timing.GetMicros(static_cast<flow::FrameTiming::Phase>(phase)));
+    }
+  }
+
+  std::vector<uint8_t> buffer(fields.size() * sizeof(int64_t));
+  memcpy(buffer.data(), fields.data(), buffer.size());
+
+  Dart_Handle data_handle = ToByteData(buffer);
+  if (Dart_IsError(data_handle))
+    return;
+  DartInvokeField(library_.value(), "_reportTimings", {data_handle});
+}
+
+int Window::RegisterPendingResponse(PlatformMessage* message) {
+  if (!message->response())
+    return 0;
+  int response_id = next_response_id_++;
+  pending_responses_[response_id] = message->response();
+  return response_id;
+}
+
 void Window::CompletePlatformMessageEmptyResponse(int response_id) {
   if (!response_id)
     return;
@@ -276,6 +376,8 @@ void Window::RegisterNatives(tonic::DartLibraryNatives* natives) {
       {"Window_scheduleFrame", ScheduleFrame, 1, true},
       {"Window_sendPlatformMessage", _SendPlatformMessage, 4, true},
       {"Window_respondToPlatformMessage", _RespondToPlatformMessage, 3, true},
+      {"Window_setJsonPlatformMessagePort", SetJsonPlatformMessagePort, 2,
+       true},
       {"Window_render", Render, 2, true},
       {"Window_updateSemantics", UpdateSemantics, 2, true},
   });
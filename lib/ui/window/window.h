@@ -5,14 +5,18 @@
 #ifndef FLUTTER_LIB_UI_WINDOW_WINDOW_H_
 #define FLUTTER_LIB_UI_WINDOW_WINDOW_H_
 
+#include <memory>
+#include <string>
 #include <unordered_map>
 
+#include "flutter/flow/frame_timing.h"
 #include "flutter/lib/ui/semantics/semantics_update.h"
 #include "flutter/lib/ui/window/platform_message.h"
 #include "flutter/lib/ui/window/pointer_data_packet.h"
 #include "flutter/lib/ui/window/viewport_metrics.h"
 #include "lib/fxl/time/time_point.h"
 #include "lib/tonic/dart_persistent_value.h"
+#include "third_party/dart/runtime/include/dart_api.h"
 
 namespace tonic {
 class DartLibraryNatives;
@@ -41,6 +45,10 @@ class Window {
   WindowClient* client() const { return client_; }
   const ViewportMetrics& viewport_metrics() { return viewport_metrics_; }
 
+  // The tag of the locale last sent to Dart, such as "en-US". Empty until the
+  // platform reports a locale.
+  const std::string& locale_tag() const { return locale_tag_; }
+
   void DidCreateIsolate();
   void UpdateWindowMetrics(const ViewportMetrics& metrics);
   void UpdateLocale(const std::string& language_code,
@@ -49,24 +57,38 @@ class Window {
   void UpdateSemanticsEnabled(bool enabled);
   void DispatchPlatformMessage(fxl::RefPtr<PlatformMessage> message);
   void DispatchPointerDataPacket(const PointerDataPacket& packet);
+  // Large packets are handed to Dart without copying them.
+  void DispatchPointerDataPacket(std::unique_ptr<PointerDataPacket> packet);
   void DispatchSemanticsAction(int32_t id, SemanticsAction action);
   void BeginFrame(fxl::TimePoint frameTime);
+  void ReportTimings(const std::vector<flow::FrameTiming>& timings);
 
   void CompletePlatformMessageResponse(int response_id,
                                        std::vector<uint8_t> data);
   void CompletePlatformMessageEmptyResponse(int response_id);
 
+  // Messages of the JSON channels are decoded and posted to the port once it
+  // is set. See |IsJsonPlatformMessageChannel|.
+  void set_json_platform_message_port(Dart_Port port) {
+    json_platform_message_port_ = port;
+  }
+
   static void RegisterNatives(tonic::DartLibraryNatives* natives);
 
  private:
   WindowClient* client_;
   tonic::DartPersistentValue library_;
   ViewportMetrics viewport_metrics_;
+  std::string locale_tag_;
+  Dart_Port json_platform_message_port_ = ILLEGAL_PORT;
 
   // We use id 0 to mean that no response is expected.
   int next_response_id_ = 1;
   std::unordered_map<int, fxl::RefPtr<blink::PlatformMessageResponse>>
       pending_responses_;
+
+  // Returns the id Dart responds to the message with.
+  int RegisterPendingResponse(PlatformMessage* message);
 };
 
 }  // namespace blink
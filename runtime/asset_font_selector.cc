@@ -5,13 +5,14 @@
 #include "flutter/runtime/asset_font_selector.h"
 
 #include "flutter/assets/zip_asset_store.h"
+#include "flutter/lib/ui/text/font_collection.h"
 #include "flutter/lib/ui/ui_dart_state.h"
 #include "flutter/sky/engine/platform/fonts/FontData.h"
 #include "flutter/sky/engine/platform/fonts/FontFaceCreationParams.h"
 #include "flutter/sky/engine/platform/fonts/SimpleFontData.h"
 #include "lib/fxl/arraysize.h"
 #include "third_party/rapidjson/rapidjson/document.h"
-#include "third_party/skia/include/core/SkStream.h"
+#include "third_party/skia/include/core/SkData.h"
 #include "third_party/skia/include/core/SkTypeface.h"
 #include "third_party/skia/include/ports/SkFontMgr.h"
 
@@ -26,12 +27,13 @@ struct AssetFontSelector::FlutterFontAttributes {
   FontStyle style;
 };
 
-// A Skia typeface along with a buffer holding the raw typeface asset data.
+// A Skia typeface along with the raw typeface asset data. The data is shared
+// with the process's font collection and the other engines of the bundle.
 struct AssetFontSelector::TypefaceAsset {
   TypefaceAsset();
   ~TypefaceAsset();
   sk_sp<SkTypeface> typeface;
-  std::vector<uint8_t> data;
+  sk_sp<SkData> data;
 };
 
 namespace {
@@ -222,17 +224,15 @@ sk_sp<SkTypeface> AssetFontSelector::getTypefaceAsset(
   }
 
   std::unique_ptr<TypefaceAsset> typeface_asset(new TypefaceAsset);
-  if (!asset_store_->GetAsBuffer(asset_path, &typeface_asset->data)) {
+  typeface_asset->data =
+      FontCollection::ForProcess().GetFontAssetData(asset_store_, asset_path);
+  if (!typeface_asset->data) {
     typeface_cache_.insert(std::make_pair(asset_path, nullptr));
     return nullptr;
   }
 
   sk_sp<SkFontMgr> font_mgr(SkFontMgr::RefDefault());
-  std::unique_ptr<SkStreamAsset> typeface_stream =
-      std::make_unique<SkMemoryStream>(typeface_asset->data.data(),
-                                       typeface_asset->data.size());
-  typeface_asset->typeface =
-      font_mgr->makeFromStream(std::move(typeface_stream));
+  typeface_asset->typeface = font_mgr->makeFromData(typeface_asset->data);
   if (typeface_asset->typeface == nullptr) {
     typeface_cache_.insert(std::make_pair(asset_path, nullptr));
     return nullptr;
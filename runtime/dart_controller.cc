@@ -4,7 +4,9 @@
 
 #include "flutter/runtime/dart_controller.h"
 
+#include <memory>
 #include <utility>
+#include <vector>
 
 #include "flutter/common/settings.h"
 #include "flutter/common/threads.h"
@@ -15,6 +17,7 @@
 #include "flutter/lib/ui/ui_dart_state.h"
 #include "flutter/runtime/dart_init.h"
 #include "flutter/runtime/dart_service_isolate.h"
+#include "flutter/runtime/start_up.h"
 #include "lib/fxl/files/directory.h"
 #include "lib/fxl/files/path.h"
 #include "lib/tonic/dart_class_library.h"
@@ -34,6 +37,23 @@ using tonic::ToDart;
 namespace blink {
 namespace {
 
+// Hands a kernel read into a buffer to the VM without copying it again.
+class VectorMapping : public fml::Mapping {
+ public:
+  explicit VectorMapping(std::vector<uint8_t> data) : data_(std::move(data)) {}
+
+  ~VectorMapping() override = default;
+
+  size_t GetSize() const override { return data_.size(); }
+
+  const uint8_t* GetMapping() const override { return data_.data(); }
+
+ private:
+  std::vector<uint8_t> data_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(VectorMapping);
+};
+
 // TODO(abarth): Consider adding this to //garnet/public/lib/fxl.
 std::string ResolvePath(std::string path) {
   if (!path.empty() && path[0] == '/')
@@ -43,10 +63,12 @@ std::string ResolvePath(std::string path) {
 
 }  // namespace
 
-DartController::DartController()
-    : ui_dart_state_(nullptr), platform_kernel_bytes(nullptr) {}
+DartController::DartController() : ui_dart_state_(nullptr) {}
 
 DartController::~DartController() {
+  // The pooled isolates are children of the main isolate.
+  isolate_pool_.reset();
+
   if (ui_dart_state_) {
     ui_dart_state_->set_isolate_client(nullptr);
 
@@ -57,9 +79,6 @@ DartController::~DartController() {
     Dart_ShutdownIsolate();
     delete ui_dart_state_;
   }
-  if (platform_kernel_bytes) {
-    free(platform_kernel_bytes);
-  }
 }
 
 const std::string DartController::main_entrypoint_ = "main";
@@ -69,6 +88,8 @@ bool DartController::SendStartMessage(Dart_Handle root_library,
   if (LogIfError(root_library))
     return true;
 
+  ScopedStartupPhase startup_phase(StartupPhase::kMainInvocation);
+
   {
     // Temporarily exit the isolate while we make it runnable.
     Dart_Isolate isolate = dart_state()->isolate();
@@ -78,6 +99,9 @@ bool DartController::SendStartMessage(Dart_Handle root_library,
     Dart_EnterIsolate(isolate);
   }
 
+  if (isolate_pool_)
+    isolate_pool_->Fill();
+
   // In order to support pausing the isolate at start, we indirectly invoke
   // main by sending a message to the isolate.
 
@@ -102,29 +126,24 @@ bool DartController::SendStartMessage(Dart_Handle root_library,
   return LogIfError(result);
 }
 
-static void CopyVectorBytes(const std::vector<uint8_t>& vector,
-                            uint8_t*& bytes) {
-  bytes = (uint8_t*)malloc(vector.size());
-  memcpy(bytes, vector.data(), vector.size());
-}
-
-static void ReleaseFetchedBytes(uint8_t* buffer) {
-  free(buffer);
+tonic::DartErrorHandleType DartController::RunFromKernel(
+    std::vector<uint8_t> kernel,
+    const std::string& entrypoint) {
+  return RunFromKernel(std::make_unique<VectorMapping>(std::move(kernel)),
+                       entrypoint);
 }
 
 tonic::DartErrorHandleType DartController::RunFromKernel(
-    const std::vector<uint8_t>& kernel,
+    std::unique_ptr<fml::Mapping> kernel,
     const std::string& entrypoint) {
   tonic::DartState::Scope scope(dart_state());
   tonic::DartErrorHandleType error = tonic::kNoError;
   if (Dart_IsNull(Dart_RootLibrary())) {
-    // Copy kernel bytes and pass ownership of the copy to the Dart_LoadKernel,
-    // which is expected to release them.
-    uint8_t* kernel_bytes = nullptr;
-    CopyVectorBytes(kernel, kernel_bytes);
-
-    Dart_Handle result = Dart_LoadKernel(Dart_ReadKernelBinary(
-        kernel_bytes, kernel.size(), ReleaseFetchedBytes));
+    ScopedStartupPhase startup_phase(StartupPhase::kSnapshotLoad);
+    // The VM reads the kernel in place and releases the mapping once it is
+    // done with it.
+    Dart_Handle result =
+        Dart_LoadKernel(ReadKernelMapping(std::move(kernel)));
     LogIfError(result);
     error = tonic::GetErrorHandleType(result);
   }
@@ -152,6 +171,7 @@ tonic::DartErrorHandleType DartController::RunFromScriptSnapshot(
   tonic::DartState::Scope scope(dart_state());
   tonic::DartErrorHandleType error = tonic::kNoError;
   if (Dart_IsNull(Dart_RootLibrary())) {
+    ScopedStartupPhase startup_phase(StartupPhase::kSnapshotLoad);
     Dart_Handle result = Dart_LoadScriptFromSnapshot(buffer, size);
     LogIfError(result);
     error = tonic::GetErrorHandleType(result);
@@ -168,6 +188,7 @@ tonic::DartErrorHandleType DartController::RunFromSource(
   tonic::DartState::Scope scope(dart_state());
   tonic::DartErrorHandleType error = tonic::kNoError;
   if (Dart_IsNull(Dart_RootLibrary())) {
+    ScopedStartupPhase startup_phase(StartupPhase::kSnapshotLoad);
     tonic::FileLoader& loader = dart_state()->file_loader();
     if (!packages.empty() && !loader.LoadPackagesMap(ResolvePath(packages)))
       FXL_LOG(WARNING) << "Failed to load package map: " << packages;
@@ -185,23 +206,19 @@ void DartController::CreateIsolateFor(
     const std::string& script_uri,
     const uint8_t* isolate_snapshot_data,
     const uint8_t* isolate_snapshot_instr,
-    const std::vector<uint8_t>& platform_kernel,
+    std::unique_ptr<fml::Mapping> platform_kernel,
     std::unique_ptr<UIDartState> state) {
+  ScopedStartupPhase startup_phase(StartupPhase::kRootIsolateCreation);
   char* error = nullptr;
 
   Dart_Isolate isolate;
-  if (!platform_kernel.empty()) {
-    // Copy kernel bytes so they won't go away after we exit this method.
-    // This is needed because original kernel data has to be available
-    // during code execution.
-    CopyVectorBytes(platform_kernel, platform_kernel_bytes);
-
+  if (platform_kernel && platform_kernel->GetSize() != 0) {
+    // The kernel has to stay available while the isolate runs, so the
+    // mapping is kept alive until the VM releases it.
     isolate = Dart_CreateIsolateFromKernel(
         script_uri.c_str(), "main",
-        Dart_ReadKernelBinary(platform_kernel_bytes, platform_kernel.size(),
-                              ReleaseFetchedBytes),
-        nullptr /* flags */, static_cast<tonic::DartState*>(state.get()),
-        &error);
+        ReadKernelMapping(std::move(platform_kernel)), nullptr /* flags */,
+        static_cast<tonic::DartState*>(state.get()), &error);
   } else {
     isolate =
         Dart_CreateIsolate(script_uri.c_str(), "main", isolate_snapshot_data,
@@ -211,6 +228,10 @@ void DartController::CreateIsolateFor(
   FXL_CHECK(isolate) << error;
   ui_dart_state_ = state.release();
   ui_dart_state_->set_is_controller_state(true);
+  if (Settings::Get().isolate_pool_size != 0) {
+    isolate_pool_ = std::make_unique<IsolatePool>(
+        ui_dart_state_, script_uri, Settings::Get().isolate_pool_size);
+  }
   dart_state()->message_handler().Initialize(blink::Threads::UI());
 
   Dart_SetShouldPauseOnStart(Settings::Get().start_paused);
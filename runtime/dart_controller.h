@@ -8,6 +8,8 @@
 #include <memory>
 #include <vector>
 
+#include "flutter/fml/mapping.h"
+#include "flutter/runtime/isolate_pool.h"
 #include "lib/fxl/macros.h"
 #include "lib/tonic/logging/dart_error.h"
 #include "third_party/dart/runtime/include/dart_api.h"
@@ -20,8 +22,12 @@ class DartController {
   DartController();
   ~DartController();
 
+  // The kernel is read in place, without copying it.
   tonic::DartErrorHandleType RunFromKernel(
-      const std::vector<uint8_t>& kernel,
+      std::unique_ptr<fml::Mapping> kernel,
+      const std::string& entrypoint = main_entrypoint_);
+  tonic::DartErrorHandleType RunFromKernel(
+      std::vector<uint8_t> kernel,
       const std::string& entrypoint = main_entrypoint_);
   tonic::DartErrorHandleType RunFromPrecompiledSnapshot(
       const std::string& entrypoint = main_entrypoint_);
@@ -35,7 +41,7 @@ class DartController {
   void CreateIsolateFor(const std::string& script_uri,
                         const uint8_t* isolate_snapshot_data,
                         const uint8_t* isolate_snapshot_instr,
-                        const std::vector<uint8_t>& platform_kernel,
+                        std::unique_ptr<fml::Mapping> platform_kernel,
                         std::unique_ptr<UIDartState> ui_dart_state);
 
   UIDartState* dart_state() const { return ui_dart_state_; }
@@ -53,10 +59,9 @@ class DartController {
   // object is deleted.
   UIDartState* ui_dart_state_;
 
-  // Kernel binary image of platform core libraries. This is copied and
-  // maintained for dart script lifespan, so that kernel loading mechanism can
-  // incrementally build the dart objects from it.
-  uint8_t* platform_kernel_bytes;
+  // Filled once the main isolate is runnable. Null unless
+  // |Settings::isolate_pool_size| is set.
+  std::unique_ptr<IsolatePool> isolate_pool_;
 
   FXL_DISALLOW_COPY_AND_ASSIGN(DartController);
 };
@@ -9,14 +9,16 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
 
-#include "flutter/assets/unzipper_provider.h"
 #include "flutter/assets/zip_asset_store.h"
 #include "flutter/common/settings.h"
+#include "flutter/fml/mapping.h"
 #include "flutter/glue/trace_event.h"
 #include "flutter/lib/io/dart_io.h"
 #include "flutter/lib/ui/dart_runtime_hooks.h"
@@ -24,10 +26,12 @@
 #include "flutter/lib/ui/ui_dart_state.h"
 #include "flutter/lib/ui/window/window.h"
 #include "flutter/runtime/dart_service_isolate.h"
+#include "flutter/runtime/isolate_pool.h"
 #include "flutter/runtime/start_up.h"
 #include "lib/fxl/arraysize.h"
 #include "lib/fxl/build_config.h"
 #include "lib/fxl/logging.h"
+#include "lib/fxl/synchronization/waitable_event.h"
 #include "lib/fxl/time/time_delta.h"
 #include "lib/tonic/converter/dart_converter.h"
 #include "lib/tonic/dart_class_library.h"
@@ -72,6 +76,34 @@ const char kPlatformKernelAssetKey[] = "platform.dill";
 
 namespace {
 
+// Kernel binaries handed to the VM, keyed by their bytes. Stored entries of
+// the same bundle map to the same bytes, so a key may appear more than once.
+static std::mutex g_kernel_mappings_mutex;
+static std::multimap<const uint8_t*, std::unique_ptr<fml::Mapping>>*
+    g_kernel_mappings =
+        new std::multimap<const uint8_t*, std::unique_ptr<fml::Mapping>>();
+
+static void ReleaseKernelMapping(uint8_t* buffer) {
+  std::lock_guard<std::mutex> lock(g_kernel_mappings_mutex);
+  auto found = g_kernel_mappings->find(buffer);
+  if (found != g_kernel_mappings->end())
+    g_kernel_mappings->erase(found);
+}
+
+}  // namespace
+
+void* ReadKernelMapping(std::unique_ptr<fml::Mapping> mapping) {
+  uint8_t* buffer = const_cast<uint8_t*>(mapping->GetMapping());
+  size_t size = mapping->GetSize();
+  {
+    std::lock_guard<std::mutex> lock(g_kernel_mappings_mutex);
+    g_kernel_mappings->emplace(buffer, std::move(mapping));
+  }
+  return Dart_ReadKernelBinary(buffer, size, ReleaseKernelMapping);
+}
+
+namespace {
+
 // Arguments passed to the Dart VM in all configurations.
 static const char* kDartLanguageArgs[] = {
     "--enable_mirrors=false",
@@ -120,6 +152,7 @@ constexpr size_t kFileUriPrefixLength = sizeof(kFileUriPrefix) - 1;
 static const uint8_t* g_default_isolate_snapshot_data = nullptr;
 static const uint8_t* g_default_isolate_snapshot_instructions = nullptr;
 static bool g_service_isolate_initialized = false;
+static fxl::AutoResetWaitableEvent g_service_isolate_startup_allowed;
 static ServiceIsolateHook g_service_isolate_hook = nullptr;
 static RegisterNativeServiceProtocolExtensionHook
     g_register_native_service_protocol_extensions_hook = nullptr;
@@ -183,8 +216,37 @@ static bool StringEndsWith(const std::string& string,
          0;
 }
 
-static void ReleaseFetchedBytes(uint8_t* buffer) {
-  free(buffer);
+// The platform kernel of a bundle is the same for all of its isolates, so it
+// is read once and shared by the secondary isolates spawned from the bundle.
+// So is the kernel program of the bundle when |share_isolate_program| is set.
+struct SharedKernel {
+  fxl::RefPtr<ZipAssetStore> asset_store;
+  void* kernel;
+};
+
+static void* GetSharedKernel(const std::string& bundle_path,
+                             const char* asset_key,
+                             fxl::RefPtr<ZipAssetStore> asset_store) {
+  static std::mutex mutex;
+  static std::map<std::pair<std::string, std::string>, SharedKernel>* kernels =
+      new std::map<std::pair<std::string, std::string>, SharedKernel>();
+  std::lock_guard<std::mutex> lock(mutex);
+  const auto key = std::make_pair(bundle_path, std::string(asset_key));
+  auto found = kernels->find(key);
+  if (found != kernels->end() && found->second.asset_store == asset_store) {
+    return found->second.kernel;
+  }
+
+  // The bundle is new or has changed. The VM has no way to free the kernel of
+  // an earlier version, which may still be used by its isolates.
+  void* kernel = nullptr;
+  std::unique_ptr<fml::Mapping> mapping = asset_store->GetAsMapping(asset_key);
+  if (mapping && mapping->GetSize() != 0) {
+    kernel = ReadKernelMapping(std::move(mapping));
+    FXL_DCHECK(kernel != NULL);
+  }
+  (*kernels)[key] = {std::move(asset_store), kernel};
+  return kernel;
 }
 
 Dart_Isolate ServiceIsolateCreateCallback(const char* script_uri,
@@ -193,6 +255,14 @@ Dart_Isolate ServiceIsolateCreateCallback(const char* script_uri,
   // No VM-service in release mode.
   return nullptr;
 #else   // FLUTTER_RUNTIME_MODE
+  if (Settings::Get().lazy_service_isolate) {
+    // The VM creates the service isolate on a thread of its own, so waiting
+    // here holds back nothing but the service isolate. The wait is bounded so
+    // that the observatory also comes up for apps that do not render.
+    TRACE_EVENT0("flutter", "WaitForServiceIsolateStartup");
+    g_service_isolate_startup_allowed.WaitWithTimeout(
+        fxl::TimeDelta::FromSeconds(5));
+  }
   UIDartState* dart_state = new UIDartState(nullptr, nullptr);
   Dart_Isolate isolate =
       Dart_CreateIsolate(script_uri, "main", g_default_isolate_snapshot_data,
@@ -235,26 +305,20 @@ Dart_Isolate ServiceIsolateCreateCallback(const char* script_uri,
 #endif  // FLUTTER_RUNTIME_MODE
 }
 
-Dart_Isolate IsolateCreateCallback(const char* script_uri,
-                                   const char* main,
-                                   const char* package_root,
-                                   const char* package_config,
-                                   Dart_IsolateFlags* flags,
-                                   void* callback_data,
-                                   char** error) {
-  TRACE_EVENT0("flutter", __func__);
-
-  if (IsServiceIsolateURL(script_uri)) {
-    return ServiceIsolateCreateCallback(script_uri, error);
-  }
+}  // namespace
 
+Dart_Isolate CreateSecondaryIsolate(const char* script_uri,
+                                    const char* main,
+                                    UIDartState* parent_dart_state,
+                                    char** error) {
   std::string entry_uri = script_uri;
   // Are we running from a Dart source file?
   const bool running_from_source = StringEndsWith(entry_uri, ".dart");
 
   void* kernel_platform = nullptr;
-  std::vector<uint8_t> kernel_data;
-  std::vector<uint8_t> snapshot_data;
+  void* kernel_program = nullptr;
+  std::unique_ptr<fml::Mapping> kernel_mapping;
+  std::unique_ptr<fml::Mapping> snapshot_mapping;
   std::string entry_path;
   if (!IsRunningPrecompiledCode()) {
     // Check that the entry script URI starts with file://
@@ -265,25 +329,23 @@ Dart_Isolate IsolateCreateCallback(const char* script_uri,
     // Entry script path (file:// is stripped).
     entry_path = std::string(script_uri + strlen(kFileUriPrefix));
     if (!running_from_source) {
-      // Attempt to copy the snapshot from the asset bundle.
-      const std::string& bundle_path = entry_path;
+      // Attempt to map the snapshot from the asset bundle. The store is
+      // shared with the engine and earlier isolates of the same bundle.
       fxl::RefPtr<ZipAssetStore> zip_asset_store =
-          fxl::MakeRefCounted<ZipAssetStore>(
-              GetUnzipperProviderForPath(std::move(bundle_path)));
-      zip_asset_store->GetAsBuffer(kKernelAssetKey, &kernel_data);
-      zip_asset_store->GetAsBuffer(kSnapshotAssetKey, &snapshot_data);
-
-      std::vector<uint8_t> platform_data;
-      zip_asset_store->GetAsBuffer(kPlatformKernelAssetKey, &platform_data);
-      if (!platform_data.empty()) {
-        kernel_platform = Dart_ReadKernelBinary(
-            platform_data.data(), platform_data.size(), ReleaseFetchedBytes);
-        FXL_DCHECK(kernel_platform != NULL);
+          ZipAssetStore::GetShared(entry_path);
+      if (Settings::Get().share_isolate_program) {
+        kernel_program =
+            GetSharedKernel(entry_path, kKernelAssetKey, zip_asset_store);
+      } else {
+        kernel_mapping = zip_asset_store->GetAsMapping(kKernelAssetKey);
       }
+      if (!kernel_program && !kernel_mapping)
+        snapshot_mapping = zip_asset_store->GetAsMapping(kSnapshotAssetKey);
+      kernel_platform = GetSharedKernel(entry_path, kPlatformKernelAssetKey,
+                                        std::move(zip_asset_store));
     }
   }
 
-  UIDartState* parent_dart_state = static_cast<UIDartState*>(callback_data);
   UIDartState* dart_state = parent_dart_state->CreateForChildIsolate();
 
   Dart_Isolate isolate =
@@ -311,14 +373,18 @@ Dart_Isolate IsolateCreateCallback(const char* script_uri,
     dart_state->class_library().add_provider("ui",
                                              std::move(ui_class_provider));
 
-    if (!kernel_data.empty()) {
+    if (kernel_program != nullptr) {
+      // We are running kernel code the VM has read for an earlier isolate of
+      // the bundle.
+      FXL_CHECK(!LogIfError(Dart_LoadKernel(kernel_program)));
+    } else if (kernel_mapping && kernel_mapping->GetSize() != 0) {
       // We are running kernel code.
-      FXL_CHECK(!LogIfError(Dart_LoadKernel(Dart_ReadKernelBinary(
-          kernel_data.data(), kernel_data.size(), ReleaseFetchedBytes))));
-    } else if (!snapshot_data.empty()) {
+      FXL_CHECK(!LogIfError(
+          Dart_LoadKernel(ReadKernelMapping(std::move(kernel_mapping)))));
+    } else if (snapshot_mapping && snapshot_mapping->GetSize() != 0) {
       // We are running from a script snapshot.
-      FXL_CHECK(!LogIfError(Dart_LoadScriptFromSnapshot(snapshot_data.data(),
-                                                        snapshot_data.size())));
+      FXL_CHECK(!LogIfError(Dart_LoadScriptFromSnapshot(
+          snapshot_mapping->GetMapping(), snapshot_mapping->GetSize())));
     } else if (running_from_source) {
       // We are running from source.
       // Forward the .packages configuration from the parent isolate to the
@@ -337,6 +403,32 @@ Dart_Isolate IsolateCreateCallback(const char* script_uri,
   }
 
   Dart_ExitIsolate();
+  return isolate;
+}
+
+namespace {
+
+Dart_Isolate IsolateCreateCallback(const char* script_uri,
+                                   const char* main,
+                                   const char* package_root,
+                                   const char* package_config,
+                                   Dart_IsolateFlags* flags,
+                                   void* callback_data,
+                                   char** error) {
+  TRACE_EVENT0("flutter", __func__);
+
+  if (IsServiceIsolateURL(script_uri)) {
+    return ServiceIsolateCreateCallback(script_uri, error);
+  }
+
+  UIDartState* parent_dart_state = static_cast<UIDartState*>(callback_data);
+  Dart_Isolate isolate = IsolatePool::Take(parent_dart_state, script_uri);
+  if (isolate == nullptr) {
+    isolate =
+        CreateSecondaryIsolate(script_uri, main, parent_dart_state, error);
+    if (isolate == nullptr)
+      return nullptr;
+  }
 
   FXL_CHECK(Dart_IsolateMakeRunnable(isolate));
   return isolate;
@@ -429,6 +521,10 @@ static std::vector<const char*> ProfilingFlags(bool enable_profiling) {
   }
 }
 
+void AllowServiceIsolateStartup() {
+  g_service_isolate_startup_allowed.Signal();
+}
+
 void SetServiceIsolateHook(ServiceIsolateHook hook) {
   FXL_CHECK(!g_service_isolate_initialized);
   g_service_isolate_hook = hook;
@@ -459,6 +555,7 @@ void InitDartVM(const uint8_t* vm_snapshot_data,
                 const uint8_t* default_isolate_snapshot_data,
                 const uint8_t* default_isolate_snapshot_instructions) {
   TRACE_EVENT0("flutter", __func__);
+  ScopedStartupPhase startup_phase(StartupPhase::kDartVMInit);
 
   g_default_isolate_snapshot_data = default_isolate_snapshot_data;
   g_default_isolate_snapshot_instructions =
@@ -539,8 +636,6 @@ void InitDartVM(const uint8_t* vm_snapshot_data,
 
   FXL_CHECK(Dart_SetVMFlags(args.size(), args.data()));
 
-  DartUI::InitForGlobal();
-
   // Setup embedder tracing hooks. To avoid data races, it is recommended that
   // these hooks be installed before the DartInitialize, so do that setup now.
   Dart_SetEmbedderTimelineCallbacks(&EmbedderTimelineStartRecording,
@@ -12,7 +12,12 @@
 #include <memory>
 #include <string>
 
+namespace fml {
+class Mapping;
+}  // namespace fml
+
 namespace blink {
+class UIDartState;
 
 // Name of the kernel blob asset within the FLX bundle.
 extern const char kKernelAssetKey[];
@@ -25,6 +30,22 @@ extern const char kPlatformKernelAssetKey[];
 
 bool IsRunningPrecompiledCode();
 
+// Reads a kernel binary without copying it. The mapping is kept alive until
+// the VM releases the binary.
+void* ReadKernelMapping(std::unique_ptr<fml::Mapping> mapping);
+
+// Creates a child isolate of the isolate of parent_dart_state and loads its
+// program. The isolate is not made runnable. Returns null and sets error if
+// the isolate can not be created.
+Dart_Isolate CreateSecondaryIsolate(const char* script_uri,
+                                    const char* main,
+                                    UIDartState* parent_dart_state,
+                                    char** error);
+
+// Lets the service isolate start if |Settings::lazy_service_isolate| holds it
+// back. May be called more than once and on any thread.
+void AllowServiceIsolateStartup();
+
 using EmbedderTracingCallback = fxl::Closure;
 
 typedef void (*ServiceIsolateHook)(bool);
@@ -0,0 +1,152 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/runtime/isolate_pool.h"
+
+#include <stdlib.h>
+
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <utility>
+
+#include "flutter/common/threads.h"
+#include "flutter/glue/trace_event.h"
+#include "flutter/runtime/dart_init.h"
+#include "lib/fxl/logging.h"
+
+namespace blink {
+
+struct IsolatePool::State {
+  State(UIDartState* p_parent_dart_state,
+        std::string p_script_uri,
+        size_t p_size)
+      : parent_dart_state(p_parent_dart_state),
+        script_uri(std::move(p_script_uri)),
+        size(p_size) {}
+
+  UIDartState* const parent_dart_state;
+  const std::string script_uri;
+  const size_t size;
+
+  std::mutex mutex;
+  std::deque<Dart_Isolate> isolates;
+  // The isolates that are posted or being created.
+  size_t pending = 0;
+  // The isolates being created. The pool waits for them before it goes away,
+  // as they are children of the parent isolate.
+  size_t creating = 0;
+  std::condition_variable creation_done;
+  bool closed = false;
+};
+
+namespace {
+
+std::mutex g_pools_mutex;
+std::map<UIDartState*, IsolatePool*>* g_pools =
+    new std::map<UIDartState*, IsolatePool*>();
+
+fxl::RefPtr<fxl::TaskRunner> GetCreationTaskRunner() {
+  const fxl::RefPtr<fxl::TaskRunner>& worker = Threads::Worker();
+  return worker ? worker : Threads::IO();
+}
+
+void ShutdownIsolate(Dart_Isolate isolate) {
+  Dart_EnterIsolate(isolate);
+  Dart_ShutdownIsolate();
+}
+
+}  // namespace
+
+IsolatePool::IsolatePool(UIDartState* parent_dart_state,
+                         std::string script_uri,
+                         size_t size)
+    : state_(std::make_shared<State>(parent_dart_state,
+                                     std::move(script_uri),
+                                     size)) {
+  std::lock_guard<std::mutex> lock(g_pools_mutex);
+  (*g_pools)[parent_dart_state] = this;
+}
+
+IsolatePool::~IsolatePool() {
+  {
+    std::lock_guard<std::mutex> lock(g_pools_mutex);
+    g_pools->erase(state_->parent_dart_state);
+  }
+
+  std::unique_lock<std::mutex> lock(state_->mutex);
+  state_->closed = true;
+  State* state = state_.get();
+  state->creation_done.wait(lock, [state]() { return state->creating == 0; });
+  for (Dart_Isolate isolate : state->isolates)
+    ShutdownIsolate(isolate);
+  state->isolates.clear();
+}
+
+void IsolatePool::Fill() {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  ScheduleIsolatesLocked(state_);
+}
+
+Dart_Isolate IsolatePool::Take(UIDartState* parent_dart_state,
+                               const char* script_uri) {
+  std::lock_guard<std::mutex> pools_lock(g_pools_mutex);
+  auto found = g_pools->find(parent_dart_state);
+  if (found == g_pools->end())
+    return nullptr;
+
+  const std::shared_ptr<State>& state = found->second->state_;
+  std::lock_guard<std::mutex> lock(state->mutex);
+  if (state->script_uri != script_uri)
+    return nullptr;
+
+  Dart_Isolate isolate = nullptr;
+  if (!state->isolates.empty()) {
+    isolate = state->isolates.front();
+    state->isolates.pop_front();
+  }
+  ScheduleIsolatesLocked(state);
+  return isolate;
+}
+
+void IsolatePool::ScheduleIsolatesLocked(const std::shared_ptr<State>& state) {
+  while (!state->closed &&
+         state->isolates.size() + state->pending < state->size) {
+    state->pending++;
+    GetCreationTaskRunner()->PostTask([state]() { CreateIsolate(state); });
+  }
+}
+
+void IsolatePool::CreateIsolate(const std::shared_ptr<State>& state) {
+  TRACE_EVENT0("flutter", "IsolatePool::CreateIsolate");
+  {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    if (state->closed)
+      return;
+    state->creating++;
+  }
+
+  char* error = nullptr;
+  Dart_Isolate isolate = CreateSecondaryIsolate(
+      state->script_uri.c_str(), "main", state->parent_dart_state, &error);
+  if (isolate == nullptr) {
+    FXL_LOG(ERROR) << "Could not create a pooled isolate: " << error;
+    free(error);
+  }
+
+  std::lock_guard<std::mutex> lock(state->mutex);
+  if (isolate != nullptr) {
+    if (state->closed) {
+      ShutdownIsolate(isolate);
+    } else {
+      state->isolates.push_back(isolate);
+    }
+  }
+  state->pending--;
+  state->creating--;
+  state->creation_done.notify_all();
+}
+
+}  // namespace blink
@@ -0,0 +1,58 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_RUNTIME_ISOLATE_POOL_H_
+#define FLUTTER_RUNTIME_ISOLATE_POOL_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <string>
+
+#include "lib/fxl/macros.h"
+#include "third_party/dart/runtime/include/dart_api.h"
+
+namespace blink {
+class UIDartState;
+
+// Keeps secondary isolates of a root isolate created ahead of time, so that
+// the isolates it spawns with |Isolate.spawn| do not wait for an isolate to
+// be created and its program to be loaded. The pooled isolates are created on
+// the worker threads, or on the IO thread if there are no workers.
+class IsolatePool {
+ public:
+  IsolatePool(UIDartState* parent_dart_state,
+              std::string script_uri,
+              size_t size);
+
+  // Shuts down the isolates in the pool. Must be called before the parent
+  // isolate shuts down and while no isolate is current.
+  ~IsolatePool();
+
+  // Starts creating isolates until the pool holds |size| of them.
+  void Fill();
+
+  // Returns a pooled isolate for the child of parent_dart_state with the
+  // script_uri and starts creating its replacement. Returns null if there is
+  // no such pool or it is empty. The isolate is not runnable yet.
+  static Dart_Isolate Take(UIDartState* parent_dart_state,
+                           const char* script_uri);
+
+ private:
+  struct State;
+
+  std::shared_ptr<State> state_;
+
+  // Posts the creation of isolates until those pooled and pending fill the
+  // pool.
+  static void ScheduleIsolatesLocked(const std::shared_ptr<State>& state);
+
+  static void CreateIsolate(const std::shared_ptr<State>& state);
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(IsolatePool);
+};
+
+}  // namespace blink
+
+#endif  // FLUTTER_RUNTIME_ISOLATE_POOL_H_
@@ -30,13 +30,13 @@ void RuntimeController::CreateDartController(
     const std::string& script_uri,
     const uint8_t* isolate_snapshot_data,
     const uint8_t* isolate_snapshot_instr,
-    const std::vector<uint8_t>& platform_kernel) {
+    std::unique_ptr<fml::Mapping> platform_kernel) {
   FXL_DCHECK(!dart_controller_);
 
   dart_controller_.reset(new DartController());
   dart_controller_->CreateIsolateFor(
       script_uri, isolate_snapshot_data, isolate_snapshot_instr,
-      platform_kernel,
+      std::move(platform_kernel),
       std::make_unique<UIDartState>(this, std::make_unique<Window>(this)));
 
   UIDartState* dart_state = dart_controller_->dart_state();
@@ -107,6 +107,13 @@ void RuntimeController::DispatchPointerDataPacket(
   GetWindow()->DispatchPointerDataPacket(packet);
 }
 
+void RuntimeController::DispatchPointerDataPacket(
+    std::unique_ptr<PointerDataPacket> packet) {
+  TRACE_EVENT1("flutter", "RuntimeController::DispatchPointerDataPacket",
+               "mode", "basic");
+  GetWindow()->DispatchPointerDataPacket(std::move(packet));
+}
+
 void RuntimeController::DispatchSemanticsAction(int32_t id,
                                                 SemanticsAction action) {
   TRACE_EVENT1("flutter", "RuntimeController::DispatchSemanticsAction", "mode",
@@ -114,6 +121,13 @@ void RuntimeController::DispatchSemanticsAction(int32_t id,
   GetWindow()->DispatchSemanticsAction(id, action);
 }
 
+void RuntimeController::ReportTimings(
+    const std::vector<flow::FrameTiming>& timings) {
+  TRACE_EVENT1("flutter", "RuntimeController::ReportTimings", "mode",
+               "basic");
+  GetWindow()->ReportTimings(timings);
+}
+
 Window* RuntimeController::GetWindow() {
   return dart_controller_->dart_state()->window();
 }
@@ -8,6 +8,7 @@
 #include <memory>
 
 #include "flutter/flow/layers/layer_tree.h"
+#include "flutter/fml/mapping.h"
 #include "flutter/lib/ui/ui_dart_state.h"
 #include "flutter/lib/ui/window/pointer_data_packet.h"
 #include "flutter/lib/ui/window/window.h"
@@ -29,7 +30,7 @@ class RuntimeController : public WindowClient, public IsolateClient {
   void CreateDartController(const std::string& script_uri,
                             const uint8_t* isolate_snapshot_data,
                             const uint8_t* isolate_snapshot_instr,
-                            const std::vector<uint8_t>& kernel_platform);
+                            std::unique_ptr<fml::Mapping> platform_kernel);
   DartController* dart_controller() const { return dart_controller_.get(); }
 
   void SetViewportMetrics(const ViewportMetrics& metrics);
@@ -43,7 +44,9 @@ class RuntimeController : public WindowClient, public IsolateClient {
 
   void DispatchPlatformMessage(fxl::RefPtr<PlatformMessage> message);
   void DispatchPointerDataPacket(const PointerDataPacket& packet);
+  void DispatchPointerDataPacket(std::unique_ptr<PointerDataPacket> packet);
   void DispatchSemanticsAction(int32_t id, SemanticsAction action);
+  void ReportTimings(const std::vector<flow::FrameTiming>& timings);
 
   Dart_Port GetMainPort();
   std::string GetIsolateName();
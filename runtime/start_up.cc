@@ -4,8 +4,82 @@
 
 #include "flutter/runtime/start_up.h"
 
+#include <atomic>
+
+#include "lib/fxl/logging.h"
+#include "third_party/dart/runtime/include/dart_tools_api.h"
+
 namespace blink {
 
 int64_t engine_main_enter_ts = 0;
 
+namespace {
+
+struct PhaseRecord {
+  std::atomic<bool> recorded{false};
+  std::atomic<int64_t> start{0};
+  std::atomic<int64_t> end{0};
+};
+
+PhaseRecord g_phases[static_cast<size_t>(StartupPhase::kCount)];
+
+PhaseRecord& GetPhaseRecord(StartupPhase phase) {
+  FXL_DCHECK(phase < StartupPhase::kCount);
+  return g_phases[static_cast<size_t>(phase)];
+}
+
+}  // namespace
+
+const char* GetStartupPhaseName(StartupPhase phase) {
+  switch (phase) {
+    case StartupPhase::kDartVMInit:
+      return "dartVMInit";
+    case StartupPhase::kSnapshotLoad:
+      return "snapshotLoad";
+    case StartupPhase::kRootIsolateCreation:
+      return "rootIsolateCreation";
+    case StartupPhase::kMainInvocation:
+      return "mainInvocation";
+    case StartupPhase::kFirstBeginFrame:
+      return "firstBeginFrame";
+    case StartupPhase::kFirstRender:
+      return "firstRender";
+    case StartupPhase::kFirstPresent:
+      return "firstPresent";
+    case StartupPhase::kCount:
+      break;
+  }
+  return "unknown";
+}
+
+void RecordStartupPhase(StartupPhase phase, int64_t start, int64_t end) {
+  PhaseRecord& record = GetPhaseRecord(phase);
+  bool recorded = false;
+  if (!record.recorded.compare_exchange_strong(recorded, true))
+    return;
+  record.start.store(start);
+  record.end.store(end);
+}
+
+bool IsStartupPhaseRecorded(StartupPhase phase) {
+  return GetPhaseRecord(phase).recorded.load(std::memory_order_relaxed);
+}
+
+StartupPhaseTiming GetStartupPhaseTiming(StartupPhase phase) {
+  const PhaseRecord& record = GetPhaseRecord(phase);
+  StartupPhaseTiming timing;
+  timing.start = record.start.load();
+  timing.end = record.end.load();
+  return timing;
+}
+
+ScopedStartupPhase::ScopedStartupPhase(StartupPhase phase)
+    : phase_(phase),
+      start_(IsStartupPhaseRecorded(phase) ? 0 : Dart_TimelineGetMicros()) {}
+
+ScopedStartupPhase::~ScopedStartupPhase() {
+  if (start_ != 0)
+    RecordStartupPhase(phase_, start_, Dart_TimelineGetMicros());
+}
+
 }  // namespace blink
@@ -7,6 +7,8 @@
 
 #include <stdint.h>
 
+#include "lib/fxl/macros.h"
+
 namespace blink {
 
 // The earliest available timestamp in the application's lifecycle. The
@@ -19,6 +21,49 @@ namespace blink {
 // user code prior to initializing Flutter.
 extern int64_t engine_main_enter_ts;
 
+// The steps between engine_main_enter_ts and the first frame on screen, in
+// the order they usually run.
+enum class StartupPhase {
+  kDartVMInit,
+  kSnapshotLoad,
+  kRootIsolateCreation,
+  kMainInvocation,
+  kFirstBeginFrame,
+  kFirstRender,
+  kFirstPresent,
+  kCount,
+};
+
+struct StartupPhaseTiming {
+  // Timestamps from Dart_TimelineGetMicros, or zero if the phase has not run.
+  int64_t start = 0;
+  int64_t end = 0;
+};
+
+const char* GetStartupPhaseName(StartupPhase phase);
+
+// Records that phase ran from start to end. Only the first run of each phase
+// is kept. Callable on any thread.
+void RecordStartupPhase(StartupPhase phase, int64_t start, int64_t end);
+
+bool IsStartupPhaseRecorded(StartupPhase phase);
+
+StartupPhaseTiming GetStartupPhaseTiming(StartupPhase phase);
+
+// Records the phase from construction to destruction, unless it was already
+// recorded. Cheap enough to be used on every frame.
+class ScopedStartupPhase {
+ public:
+  explicit ScopedStartupPhase(StartupPhase phase);
+  ~ScopedStartupPhase();
+
+ private:
+  const StartupPhase phase_;
+  int64_t start_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(ScopedStartupPhase);
+};
+
 }  // namespace blink
 
 #endif  // FLUTTER_RUNTIME_START_UP_H_
@@ -4,12 +4,37 @@
 
 #include "flutter/shell/common/animator.h"
 
+#include <algorithm>
+
+#include "flutter/common/runtime_settings.h"
+#include "flutter/common/settings.h"
 #include "flutter/common/threads.h"
+#include "flutter/flow/instrumentation.h"
+#include "flutter/fml/message_loop.h"
+#include "flutter/fml/task_priority.h"
 #include "flutter/fml/trace_event.h"
+#include "flutter/runtime/start_up.h"
+#include "flutter/shell/common/frame_coordinator.h"
 #include "lib/fxl/time/stopwatch.h"
 #include "third_party/dart/runtime/include/dart_tools_api.h"
 
 namespace shell {
+namespace {
+
+// Frames are throttled once this many in a row rendered nothing.
+constexpr int kIdleFramesBeforeThrottling = 3;
+
+// While throttled, one frame begins every this many vsyncs.
+constexpr int kThrottledFrameInterval = 4;
+
+// Once no frame has been requested for this many frame intervals, the app is
+// taken to be idle and the VM is given enough time for an old generation
+// collection.
+constexpr int kFramesBeforeLongIdle = 3;
+constexpr fxl::TimeDelta kLongIdleDuration =
+    fxl::TimeDelta::FromMilliseconds(100);
+
+}  // namespace
 
 Animator::Animator(fxl::WeakPtr<Rasterizer> rasterizer,
                    VsyncWaiter* waiter,
@@ -18,15 +43,61 @@ Animator::Animator(fxl::WeakPtr<Rasterizer> rasterizer,
       waiter_(waiter),
       engine_(engine),
       last_begin_frame_time_(),
-      dart_frame_deadline_(0),
-      layer_tree_pipeline_(fxl::MakeRefCounted<LayerTreePipeline>(2)),
+      layer_tree_pipeline_(fxl::MakeRefCounted<LayerTreePipeline>(
+          std::max<uint32_t>(blink::Settings::Get().layer_tree_pipeline_depth,
+                             1))),
       pending_frame_semaphore_(1),
       frame_number_(1),
       paused_(false),
       frame_scheduled_(false),
-      weak_factory_(this) {}
+      frame_rendered_(true),
+      idle_frame_count_(0),
+      vsyncs_to_skip_(0),
+      frame_rate_divisor_(1),
+      throttle_idle_frames_(
+          blink::RuntimeSettings::Get().throttle_idle_frames),
+      weak_factory_(this) {
+  const blink::Settings& settings = blink::Settings::Get();
+  SetFrameRateDivisor(settings.frame_rate_divisor);
+  if (settings.enable_frame_pacing) {
+    frame_pacer_ = std::make_unique<FramePacer>();
+  }
+  if (settings.benchmark_mode) {
+    benchmark_waiter_ = std::make_unique<VsyncWaiterBenchmark>(
+        fxl::TimeDelta::FromMicroseconds(
+            settings.benchmark_frame_interval_micros));
+    waiter_ = benchmark_waiter_.get();
+    std::string path = settings.benchmark_output_path;
+    if (path.empty() && !settings.temp_directory_path.empty()) {
+      path = settings.temp_directory_path + "/benchmark_frames.csv";
+    }
+    if (!path.empty()) {
+      benchmark_recorder_ = BenchmarkFrameRecorder::Create(path);
+    }
+  }
+}
 
-Animator::~Animator() = default;
+Animator::~Animator() {
+  FrameCoordinator::Get().RemoveOwner(this);
+}
+
+void Animator::set_vsync_waiter(VsyncWaiter* waiter) {
+  if (benchmark_waiter_) {
+    return;
+  }
+  waiter_ = waiter;
+  FrameCoordinator::Get().SetWaiter(this, waiter);
+}
+
+void Animator::SetFrameRateDivisor(int divisor) {
+  frame_rate_divisor_ = std::max(divisor, 1);
+  vsyncs_to_skip_ = std::min(vsyncs_to_skip_, frame_rate_divisor_ - 1);
+}
+
+void Animator::SetThrottleIdleFrames(bool throttle) {
+  throttle_idle_frames_ = throttle;
+  vsyncs_to_skip_ = std::min(vsyncs_to_skip_, GetVsyncsToSkip());
+}
 
 void Animator::Stop() {
   paused_ = true;
@@ -42,7 +113,9 @@ void Animator::Start() {
 }
 
 // This Parity is used by the timeline component to correctly align
-// GPU Workloads events with their respective Framework Workload.
+// GPU Workloads events with their respective Framework Workload. Traces also
+// follow each frame with a "Frame" flow identified by its frame number, from
+// the beginning of the frame to the submission of its surface frame.
 const char* Animator::FrameParity() {
   return (frame_number_ % 2) ? "even" : "odd";
 }
@@ -55,6 +128,12 @@ static int64_t FxlToDartOrEarlier(fxl::TimePoint time) {
 
 void Animator::BeginFrame(fxl::TimePoint frame_start_time,
                           fxl::TimePoint frame_target_time) {
+  blink::ScopedStartupPhase startup_phase(
+      blink::StartupPhase::kFirstBeginFrame);
+  frame_timing_ = flow::FrameTiming();
+  frame_timing_.set_frame_number(frame_number_);
+  frame_timing_.Set(flow::FrameTiming::kVsyncStart, frame_start_time);
+
   TRACE_EVENT_ASYNC_END0("flutter", "Frame Request Pending", frame_number_++);
 
   frame_scheduled_ = false;
@@ -66,6 +145,12 @@ void Animator::BeginFrame(fxl::TimePoint frame_start_time,
     // instead of asking the pipeline for a fresh continuation.
     producer_continuation_ = layer_tree_pipeline_->Produce();
 
+    // Report how many frames are still waiting on the GPU thread. With deeper
+    // pipelines, a non-zero count here is the latency being traded for
+    // throughput.
+    TRACE_COUNTER1("flutter", "LayerTreePipelineQueueDepth",
+                   layer_tree_pipeline_->GetQueuedItemCount());
+
     if (!producer_continuation_) {
       // If we still don't have valid continuation, the pipeline is currently
       // full because the consumer is being too slow. Try again at the next
@@ -80,40 +165,128 @@ void Animator::BeginFrame(fxl::TimePoint frame_start_time,
   // to service potential frame.
   FXL_DCHECK(producer_continuation_);
 
+  // Frames deferred for the pipeline above did not get to render, so they
+  // are not counted as idle.
+  idle_frame_count_ = frame_rendered_ ? 0 : idle_frame_count_ + 1;
+  frame_rendered_ = false;
+
   last_begin_frame_time_ = frame_start_time;
-  dart_frame_deadline_ = FxlToDartOrEarlier(frame_target_time);
+  frame_deadline_ = frame_target_time;
+  frame_interval_ = frame_target_time - frame_start_time;
   {
     TRACE_EVENT2("flutter", "Framework Workload", "mode", "basic", "frame",
                  FrameParity());
+    TRACE_FLOW_BEGIN("flutter", "Frame", frame_timing_.frame_number());
+    for (int64_t flow_id : pending_pointer_event_flows_) {
+      TRACE_FLOW_END("flutter", "PointerEvent", flow_id);
+    }
+    pending_pointer_event_flows_.clear();
+    frame_timing_.Set(flow::FrameTiming::kBuildStart, fxl::TimePoint::Now());
     engine_->BeginFrame(last_begin_frame_time_);
   }
 
   if (!frame_scheduled_) {
     // We don't have another frame pending, so we're waiting on user input
-    // or I/O. Allow the Dart VM 100 ms.
-    engine_->NotifyIdle(dart_frame_deadline_ + 100000);
+    // or I/O. Either may request a frame for the next vsync, so the VM only
+    // gets the time until then. Longer collections wait until no frame has
+    // been requested for a few intervals.
+    NotifyIdle(GetIdleDeadline());
+    const fxl::TimeDelta long_idle_delay = fxl::TimeDelta::FromMicroseconds(
+        frame_interval_.ToMicroseconds() * kFramesBeforeLongIdle);
+    blink::Threads::UI()->PostDelayedTask(
+        [ self = weak_factory_.GetWeakPtr(), frame_number = frame_number_ ]() {
+          if (self)
+            self->NotifyIdleIfNoFrameSince(frame_number);
+        },
+        (frame_deadline_ - fxl::TimePoint::Now()) + long_idle_delay);
+  }
+}
+
+void Animator::NotifyIdleIfNoFrameSince(int64_t frame_number) {
+  if (frame_scheduled_ || frame_number_ != frame_number) {
+    return;
   }
+  TRACE_EVENT_INSTANT0("flutter", "LongIdle");
+  NotifyIdle(fxl::TimePoint::Now() + kLongIdleDuration);
+}
+
+fxl::TimePoint Animator::GetIdleDeadline() const {
+  const fxl::TimePoint now = fxl::TimePoint::Now();
+  fxl::TimePoint next_vsync = frame_deadline_;
+  if (next_vsync < now && frame_interval_ > fxl::TimeDelta::Zero()) {
+    const int64_t intervals =
+        (now - next_vsync).ToMicroseconds() / frame_interval_.ToMicroseconds() +
+        1;
+    next_vsync = next_vsync + fxl::TimeDelta::FromMicroseconds(
+                                  frame_interval_.ToMicroseconds() * intervals);
+  }
+  if (!frame_pacer_) {
+    return next_vsync;
+  }
+  return frame_pacer_->GetBuildStartTime(next_vsync,
+                                         next_vsync + frame_interval_);
 }
 
 void Animator::Render(std::unique_ptr<flow::LayerTree> layer_tree) {
+  blink::ScopedStartupPhase startup_phase(blink::StartupPhase::kFirstRender);
+  TRACE_EVENT0("flutter", "Animator::Render");
+  frame_rendered_ = true;
+  idle_frame_count_ = 0;
   if (layer_tree) {
+    TRACE_FLOW_STEP("flutter", "Frame", frame_timing_.frame_number());
     // Note the frame time for instrumentation.
-    layer_tree->set_construction_time(fxl::TimePoint::Now() -
-                                      last_begin_frame_time_);
+    const fxl::TimePoint now = fxl::TimePoint::Now();
+    layer_tree->set_construction_time(now - last_begin_frame_time_);
+    frame_timing_.Set(flow::FrameTiming::kBuildFinish, now);
+    layer_tree->set_frame_timing(frame_timing_);
+    if (frame_pacer_ &&
+        frame_timing_.Get(flow::FrameTiming::kBuildStart) != fxl::TimePoint()) {
+      frame_pacer_->AddBuildDuration(
+          now - frame_timing_.Get(flow::FrameTiming::kBuildStart));
+    }
   }
 
   // Commit the pending continuation.
   producer_continuation_.Complete(std::move(layer_tree));
 
-  blink::Threads::Gpu()->PostTask([
+  // In benchmark mode, the next frame may begin once the GPU thread is done
+  // with this one.
+  const bool notify_completion = benchmark_waiter_ != nullptr;
+  if (notify_completion) {
+    benchmark_waiter_->OnFrameSubmitted();
+  }
+
+  auto draw = [
     rasterizer = rasterizer_, pipeline = layer_tree_pipeline_,
-    frame_id = FrameParity()
+    frame_id = FrameParity(), notify_completion,
+    self = weak_factory_.GetWeakPtr()
   ]() {
-    if (!rasterizer.get())
-      return;
-    TRACE_EVENT2("flutter", "GPU Workload", "mode", "basic", "frame", frame_id);
-    rasterizer->Draw(pipeline);
-  });
+    if (rasterizer.get()) {
+      TRACE_EVENT2("flutter", "GPU Workload", "mode", "basic", "frame",
+                   frame_id);
+      rasterizer->Draw(pipeline);
+    }
+    if (notify_completion) {
+      blink::Threads::UI()->PostTask([self]() {
+        if (self)
+          self->OnFrameCompleted();
+      });
+    }
+  };
+
+  // When the GPU tasks run on this thread, the frame is rasterized right away
+  // rather than after the tasks queued before it.
+  if (blink::Threads::Gpu()->RunsTasksOnCurrentThread()) {
+    draw();
+    return;
+  }
+  FrameCoordinator::Get().PostDraw(draw);
+}
+
+void Animator::OnFrameCompleted() {
+  if (benchmark_waiter_) {
+    benchmark_waiter_->OnFrameCompleted();
+  }
 }
 
 void Animator::RequestFrame() {
@@ -141,19 +314,121 @@ void Animator::RequestFrame() {
         }
         TRACE_EVENT_ASYNC_BEGIN0("flutter", "Frame Request Pending",
                                  frame_number);
+        self->vsyncs_to_skip_ = self->GetVsyncsToSkip();
         self->AwaitVSync();
       });
   frame_scheduled_ = true;
 }
 
 void Animator::AwaitVSync() {
-  waiter_->AsyncWaitForVsync([self = weak_factory_.GetWeakPtr()](
+  VsyncWaiter::Callback callback = [self = weak_factory_.GetWeakPtr()](
       fxl::TimePoint frame_start_time, fxl::TimePoint frame_target_time) {
     if (self)
-      self->BeginFrame(frame_start_time, frame_target_time);
-  });
+      self->OnVSync(frame_start_time, frame_target_time);
+  };
+  // Benchmark frames are paced by this animator alone. Otherwise, the
+  // animators of all views begin their frames on the same vsync.
+  if (benchmark_waiter_) {
+    waiter_->AsyncWaitForVsync(std::move(callback));
+  } else {
+    FrameCoordinator::Get().AsyncWaitForVsync(this, waiter_,
+                                              std::move(callback));
+  }
 
-  engine_->NotifyIdle(dart_frame_deadline_);
+  NotifyIdle(GetIdleDeadline());
+}
+
+int Animator::GetVsyncsToSkip() const {
+  if (!throttle_idle_frames_ ||
+      idle_frame_count_ < kIdleFramesBeforeThrottling) {
+    return frame_rate_divisor_ - 1;
+  }
+  return std::max(kThrottledFrameInterval, frame_rate_divisor_) - 1;
+}
+
+void Animator::OnVSync(fxl::TimePoint frame_start_time,
+                       fxl::TimePoint frame_target_time) {
+  if (vsyncs_to_skip_ > 0) {
+    // Recent frames rendered nothing. Neither the framework nor the GPU
+    // thread does any work for this vsync.
+    vsyncs_to_skip_--;
+    TRACE_EVENT_INSTANT0("flutter", "IdleFrameThrottled");
+    AwaitVSync();
+    return;
+  }
+
+  // With a capped frame rate, the frame is due by the last vsync before the
+  // next frame begins. Animations advance by the frame start times passed to
+  // the framework, so they keep their pace.
+  if (frame_rate_divisor_ > 1) {
+    const fxl::TimeDelta interval = frame_target_time - frame_start_time;
+    frame_target_time =
+        frame_start_time + fxl::TimeDelta::FromMicroseconds(
+                               interval.ToMicroseconds() * frame_rate_divisor_);
+  }
+
+  // The performance overlay and the frame time statistics measure frames
+  // against the interval they have, the refresh interval of the display
+  // unless the frame rate is capped.
+  flow::SetFrameBudget(frame_target_time - frame_start_time);
+
+  if (!frame_pacer_) {
+    BeginFrame(frame_start_time, frame_target_time);
+    return;
+  }
+
+  const fxl::TimePoint build_start_time =
+      frame_pacer_->GetBuildStartTime(frame_start_time, frame_target_time);
+  const fxl::TimeDelta delay = build_start_time - fxl::TimePoint::Now();
+
+  if (delay <= fxl::TimeDelta::Zero()) {
+    BeginFrame(frame_start_time, frame_target_time);
+    return;
+  }
+
+  // The UI thread has nothing to do until the frame starts. Let the VM use
+  // that time.
+  TRACE_EVENT_INSTANT0("flutter", "FramePacingDelay");
+  NotifyIdle(build_start_time);
+
+  fml::ScopedTaskPriority priority(fml::TaskPriority::kFrameCritical);
+  blink::Threads::UI()->PostDelayedTask(
+      [ self = weak_factory_.GetWeakPtr(), frame_start_time,
+        frame_target_time ]() {
+        if (self)
+          self->BeginFrame(frame_start_time, frame_target_time);
+      },
+      delay);
+}
+
+void Animator::NotifyIdle(fxl::TimePoint deadline) {
+  engine_->NotifyIdle(FxlToDartOrEarlier(deadline));
+  // Native idle tasks get the slack the VM left.
+  if (fml::MessageLoop::IsInitializedForCurrentThread()) {
+    fml::MessageLoop::GetCurrent().RunIdleTasks(deadline);
+  }
+}
+
+void Animator::AddPointerEventFlow(int64_t flow_id) {
+  pending_pointer_event_flows_.push_back(flow_id);
+  // Input is likely to make the next frames render, so they begin on time,
+  // though no sooner than the frame rate cap allows.
+  idle_frame_count_ = 0;
+  vsyncs_to_skip_ = std::min(vsyncs_to_skip_, frame_rate_divisor_ - 1);
+}
+
+void Animator::ReportTimings(const std::vector<flow::FrameTiming>& timings) {
+  if (benchmark_recorder_) {
+    benchmark_recorder_->Record(timings);
+  }
+  if (!frame_pacer_) {
+    return;
+  }
+  for (const auto& timing : timings) {
+    frame_pacer_->AddRasterDuration(
+        timing.Get(flow::FrameTiming::kRasterFinish) -
+        timing.Get(flow::FrameTiming::kRasterStart));
+  }
 }
 
 }  // namespace shell
@@ -5,9 +5,13 @@
 #ifndef FLUTTER_SHELL_COMMON_ANIMATOR_H_
 #define FLUTTER_SHELL_COMMON_ANIMATOR_H_
 
+#include "flutter/flow/frame_timing.h"
+#include "flutter/shell/common/benchmark_frame_recorder.h"
 #include "flutter/shell/common/engine.h"
+#include "flutter/shell/common/frame_pacer.h"
 #include "flutter/shell/common/rasterizer.h"
 #include "flutter/shell/common/vsync_waiter.h"
+#include "flutter/shell/common/vsync_waiter_benchmark.h"
 #include "flutter/synchronization/pipeline.h"
 #include "flutter/synchronization/semaphore.h"
 #include "lib/fxl/memory/ref_ptr.h"
@@ -28,14 +32,36 @@ class Animator {
     rasterizer_ = rasterizer;
   }
 
+  // Ignored in benchmark mode, where frames are paced by a waiter of the
+  // animator.
+  void set_vsync_waiter(VsyncWaiter* waiter);
+
   void RequestFrame();
 
+  // Caps the frame rate to the display rate divided by |divisor|, such as to
+  // 30 fps on a 60Hz display with a divisor of two, by letting vsyncs pass
+  // between frames. Frames are due by the vsync before the next frame
+  // begins. One begins a frame on every vsync.
+  void SetFrameRateDivisor(int divisor);
+
+  // Whether frames begin only every few vsyncs while the frames requested in
+  // a row rendered nothing. See |Settings::throttle_idle_frames|.
+  void SetThrottleIdleFrames(bool throttle);
+
   void Render(std::unique_ptr<flow::LayerTree> layer_tree);
 
   void Start();
 
   void Stop();
 
+  // Feeds the raster durations of presented frames to the frame pacer, and
+  // the frames to the benchmark recorder.
+  void ReportTimings(const std::vector<flow::FrameTiming>& timings);
+
+  // Ends the trace flow |flow_id| of a dispatched pointer event in the next
+  // frame that begins, so that traces link input to the frame showing it.
+  void AddPointerEventFlow(int64_t flow_id);
+
  private:
   using LayerTreePipeline = flutter::Pipeline<flow::LayerTree>;
 
@@ -44,6 +70,28 @@ class Animator {
 
   void AwaitVSync();
 
+  void OnVSync(fxl::TimePoint frame_start_time,
+               fxl::TimePoint frame_target_time);
+
+  // Lets the Dart VM and then native idle tasks on the UI thread use the time
+  // until |deadline|.
+  void NotifyIdle(fxl::TimePoint deadline);
+
+  // The time at which the UI thread may next have to build a frame: the next
+  // vsync after now, or the build start the frame pacer picks for it.
+  fxl::TimePoint GetIdleDeadline() const;
+
+  // Gives the VM time for a longer collection if no frame has begun or been
+  // requested since frame |frame_number| began.
+  void NotifyIdleIfNoFrameSince(int64_t frame_number);
+
+  // Called once the GPU thread is done with a frame in benchmark mode.
+  void OnFrameCompleted();
+
+  // The vsyncs to let pass before the next frame begins given the frames in
+  // a row that rendered nothing.
+  int GetVsyncsToSkip() const;
+
   const char* FrameParity();
 
   fxl::WeakPtr<Rasterizer> rasterizer_;
@@ -51,13 +99,33 @@ class Animator {
   Engine* engine_;
 
   fxl::TimePoint last_begin_frame_time_;
-  int64_t dart_frame_deadline_;
+  flow::FrameTiming frame_timing_;
+  // Null unless frame pacing is enabled.
+  std::unique_ptr<FramePacer> frame_pacer_;
+  // Only set in benchmark mode.
+  std::unique_ptr<VsyncWaiterBenchmark> benchmark_waiter_;
+  std::unique_ptr<BenchmarkFrameRecorder> benchmark_recorder_;
+  // The target time of the last frame that began.
+  fxl::TimePoint frame_deadline_;
+  // The vsync interval of the last frame that began.
+  fxl::TimeDelta frame_interval_;
   fxl::RefPtr<LayerTreePipeline> layer_tree_pipeline_;
   flutter::Semaphore pending_frame_semaphore_;
   LayerTreePipeline::ProducerContinuation producer_continuation_;
   int64_t frame_number_;
+  // The flows of pointer events dispatched since the last frame began.
+  std::vector<int64_t> pending_pointer_event_flows_;
   bool paused_;
   bool frame_scheduled_;
+  // Whether the last frame that began called Render.
+  bool frame_rendered_;
+  // The frames in a row that began without rendering.
+  int idle_frame_count_;
+  // The vsyncs still to let pass before the requested frame begins.
+  int vsyncs_to_skip_;
+  // Frames begin on every this many vsyncs.
+  int frame_rate_divisor_;
+  bool throttle_idle_frames_;
 
   fxl::WeakPtrFactory<Animator> weak_factory_;
 
@@ -0,0 +1,84 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/benchmark_frame_recorder.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <sstream>
+
+#include "flutter/common/threads.h"
+#include "lib/fxl/files/eintr_wrapper.h"
+#include "lib/fxl/logging.h"
+
+namespace shell {
+namespace {
+
+// Frame times are synthetic in benchmark mode, so the latency is measured from
+// the start of the build.
+constexpr char kHeader[] =
+    "frame_number,present_micros,build_micros,raster_micros,"
+    "build_start_to_present_micros\n";
+
+void WriteAll(const fxl::UniqueFD& fd, const std::string& data) {
+  size_t written = 0;
+  while (written < data.size()) {
+    ssize_t result = HANDLE_EINTR(
+        ::write(fd.get(), data.data() + written, data.size() - written));
+    if (result <= 0) {
+      FXL_DLOG(WARNING) << "Could not write benchmark frame records.";
+      return;
+    }
+    written += result;
+  }
+}
+
+int64_t Micros(const flow::FrameTiming& timing,
+               flow::FrameTiming::Phase from,
+               flow::FrameTiming::Phase to) {
+  return (timing.Get(to) - timing.Get(from)).ToMicroseconds();
+}
+
+}  // namespace
+
+std::unique_ptr<BenchmarkFrameRecorder> BenchmarkFrameRecorder::Create(
+    const std::string& path) {
+  auto fd = std::make_shared<fxl::UniqueFD>(
+      HANDLE_EINTR(::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)));
+  if (!fd->is_valid()) {
+    FXL_LOG(ERROR) << "Could not create the benchmark frame records at "
+                   << path;
+    return nullptr;
+  }
+  FXL_LOG(INFO) << "Recording benchmark frames to " << path;
+  WriteAll(*fd, kHeader);
+  return std::unique_ptr<BenchmarkFrameRecorder>(
+      new BenchmarkFrameRecorder(std::move(fd)));
+}
+
+BenchmarkFrameRecorder::BenchmarkFrameRecorder(
+    std::shared_ptr<fxl::UniqueFD> fd)
+    : fd_(std::move(fd)) {}
+
+BenchmarkFrameRecorder::~BenchmarkFrameRecorder() = default;
+
+void BenchmarkFrameRecorder::Record(
+    const std::vector<flow::FrameTiming>& timings) {
+  using Phase = flow::FrameTiming::Phase;
+  std::ostringstream records;
+  for (const auto& timing : timings) {
+    records << timing.frame_number() << ","
+            << timing.GetMicros(Phase::kPresent) << ","
+            << Micros(timing, Phase::kBuildStart, Phase::kBuildFinish) << ","
+            << Micros(timing, Phase::kRasterStart, Phase::kRasterFinish)
+            << "," << Micros(timing, Phase::kBuildStart, Phase::kPresent)
+            << "\n";
+  }
+  blink::Threads::IO()->PostTask([fd = fd_, data = records.str()]() {
+    WriteAll(*fd, data);
+  });
+}
+
+}  // namespace shell
@@ -0,0 +1,42 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_BENCHMARK_FRAME_RECORDER_H_
+#define FLUTTER_SHELL_COMMON_BENCHMARK_FRAME_RECORDER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "flutter/flow/frame_timing.h"
+#include "lib/fxl/files/unique_fd.h"
+#include "lib/fxl/macros.h"
+
+namespace shell {
+
+// Writes the build and raster times of presented frames to a CSV file, so
+// that engine builds can be compared by their measured throughput. Only used
+// on the UI thread. The file is written on the IO thread.
+class BenchmarkFrameRecorder {
+ public:
+  // Returns null if the file can not be created.
+  static std::unique_ptr<BenchmarkFrameRecorder> Create(
+      const std::string& path);
+
+  ~BenchmarkFrameRecorder();
+
+  void Record(const std::vector<flow::FrameTiming>& timings);
+
+ private:
+  // Shared with the pending writes, which may outlive the recorder.
+  std::shared_ptr<fxl::UniqueFD> fd_;
+
+  explicit BenchmarkFrameRecorder(std::shared_ptr<fxl::UniqueFD> fd);
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(BenchmarkFrameRecorder);
+};
+
+}  // namespace shell
+
+#endif  // FLUTTER_SHELL_COMMON_BENCHMARK_FRAME_RECORDER_H_
@@ -5,7 +5,6 @@
 #include "flutter/shell/common/diagnostic/diagnostic_server.h"
 
 #include "flutter/common/threads.h"
-#include "flutter/flow/compositor_context.h"
 #include "flutter/runtime/embedder_resources.h"
 #include "flutter/shell/common/engine.h"
 #include "flutter/shell/common/picture_serializer.h"
@@ -117,23 +116,22 @@ void DiagnosticServer::SkiaPictureTask(Dart_Port port_id) {
     return;
   }
 
-  flow::LayerTree* layer_tree = rasterizer->GetLastLayerTree();
-  if (layer_tree == nullptr) {
+  sk_sp<SkPicture> picture = rasterizer->RecordLastLayerTree();
+  if (picture == nullptr) {
     SendNull(port_id);
     return;
   }
 
-  SkPictureRecorder recorder;
-  recorder.beginRecording(SkRect::MakeWH(layer_tree->frame_size().width(),
-                                         layer_tree->frame_size().height()));
-
-  flow::CompositorContext compositor_context(nullptr);
-  flow::CompositorContext::ScopedFrame frame = compositor_context.AcquireFrame(
-      nullptr, recorder.getRecordingCanvas(), false);
-  layer_tree->Raster(frame);
-
-  sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+  // Encoding the images of the picture takes much longer than recording it,
+  // so it is kept off the GPU thread.
+  const fxl::RefPtr<fxl::TaskRunner>& runner =
+      blink::Threads::Worker() ? blink::Threads::Worker() : blink::Threads::IO();
+  runner->PostTask(
+      [port_id, picture]() { SerializePictureTask(port_id, picture); });
+}
 
+void DiagnosticServer::SerializePictureTask(Dart_Port port_id,
+                                            sk_sp<SkPicture> picture) {
   SkDynamicMemoryWStream stream;
   PngPixelSerializer serializer;
   picture->serialize(&stream, &serializer);
@@ -6,6 +6,7 @@
 #define SKY_ENGINE_CORE_DIAGNOSTIC_DIAGNOSTIC_SERVER_H_
 
 #include "third_party/dart/runtime/include/dart_api.h"
+#include "third_party/skia/include/core/SkPicture.h"
 
 namespace shell {
 
@@ -15,7 +16,11 @@ class DiagnosticServer {
   static void HandleSkiaPictureRequest(Dart_Handle send_port);
 
  private:
+  // Records the last frame on the GPU thread.
   static void SkiaPictureTask(Dart_Port port_id);
+
+  // Serializes |picture| and posts it to |port_id| from a background thread.
+  static void SerializePictureTask(Dart_Port port_id, sk_sp<SkPicture> picture);
 };
 
 }  // namespace shell
@@ -9,12 +9,15 @@
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#include <algorithm>
 #include <memory>
+#include <sstream>
 #include <utility>
+#include <vector>
 
 #include "flutter/assets/directory_asset_bundle.h"
-#include "flutter/assets/unzipper_provider.h"
 #include "flutter/assets/zip_asset_store.h"
+#include "flutter/common/runtime_settings.h"
 #include "flutter/common/settings.h"
 #include "flutter/common/threads.h"
 #include "flutter/glue/trace_event.h"
@@ -27,6 +30,8 @@
 #include "flutter/runtime/test_font_selector.h"
 #include "flutter/shell/common/animator.h"
 #include "flutter/shell/common/platform_view.h"
+#include "flutter/shell/common/shell.h"
+#include "flutter/sky/engine/platform/fonts/FontCache.h"
 #include "flutter/sky/engine/public/web/Sky.h"
 #include "lib/fxl/files/eintr_wrapper.h"
 #include "lib/fxl/files/file.h"
@@ -41,10 +46,38 @@ namespace shell {
 namespace {
 
 constexpr char kAssetChannel[] = "flutter/assets";
+constexpr char kFrameRateChannel[] = "flutter/framerate";
 constexpr char kLifecycleChannel[] = "flutter/lifecycle";
 constexpr char kNavigationChannel[] = "flutter/navigation";
 constexpr char kLocalizationChannel[] = "flutter/localization";
 constexpr char kSettingsChannel[] = "flutter/settings";
+constexpr char kRuntimeSettingsChannel[] = "flutter/runtimesettings";
+
+// A JSON array of the names of the assets a recorded startup loaded, in the
+// order it loaded them.
+constexpr char kAssetPrefetchManifest[] = "AssetPrefetchManifest.json";
+
+// Reads the members of |args| that name runtime settings into |settings|.
+// Members of the wrong type are ignored.
+void ReadRuntimeSettings(const rapidjson::Value& args,
+                         blink::RuntimeSettings* settings) {
+  auto read_size = [&args](const char* name, size_t* value) {
+    auto member = args.FindMember(name);
+    if (member != args.MemberEnd() && member->value.IsUint64())
+      *value = static_cast<size_t>(member->value.GetUint64());
+  };
+  auto read_bool = [&args](const char* name, bool* value) {
+    auto member = args.FindMember(name);
+    if (member != args.MemberEnd() && member->value.IsBool())
+      *value = member->value.GetBool();
+  };
+  read_size("rasterCacheThreshold", &settings->raster_cache_threshold);
+  read_size("rasterCacheMaxBytes", &settings->raster_cache_max_bytes);
+  read_size("gpuResourceCacheMaxBytes",
+            &settings->gpu_resource_cache_max_bytes);
+  read_bool("layerTreeDiffing", &settings->enable_layer_tree_diffing);
+  read_bool("throttleIdleFrames", &settings->throttle_idle_frames);
+}
 
 bool PathExists(const std::string& path) {
   return access(path.c_str(), R_OK) == 0;
@@ -66,6 +99,29 @@ std::string GetScriptUriFromPath(const std::string& path) {
   return "file://" + path;
 }
 
+// Reads the assets listed in the prefetch manifest of the bundle so that they
+// are in the page cache by the time the isolate asks for them.
+void PrefetchAssets(fxl::RefPtr<blink::AssetManager> asset_manager) {
+  TRACE_EVENT0("flutter", "PrefetchAssets");
+  std::vector<uint8_t> manifest_data;
+  if (!asset_manager->GetAsBuffer(kAssetPrefetchManifest, &manifest_data))
+    return;
+
+  rapidjson::Document document;
+  document.Parse(reinterpret_cast<const char*>(manifest_data.data()),
+                 manifest_data.size());
+  if (document.HasParseError() || !document.IsArray()) {
+    FXL_DLOG(WARNING) << "Could not parse the asset prefetch manifest.";
+    return;
+  }
+
+  std::vector<uint8_t> asset_data;
+  for (const auto& asset : document.GetArray()) {
+    if (asset.IsString())
+      asset_manager->GetAsBuffer(asset.GetString(), &asset_data);
+  }
+}
+
 }  // namespace
 
 Engine::Engine(PlatformView* platform_view)
@@ -78,10 +134,61 @@ Engine::Engine(PlatformView* platform_view)
       user_settings_data_("{}"),
       activity_running_(false),
       have_surface_(false),
-      weak_factory_(this) {}
+      weak_factory_(this) {
+  if (blink::Settings::Get().enable_pointer_coalescing) {
+    pointer_data_queue_ = std::make_unique<PointerDataQueue>();
+  }
+}
+
+Engine::Engine()
+    : animator_(std::make_unique<Animator>(fxl::WeakPtr<Rasterizer>(),
+                                           nullptr,
+                                           this)),
+      load_script_error_(tonic::kNoError),
+      user_settings_data_("{}"),
+      activity_running_(false),
+      have_surface_(false),
+      weak_factory_(this) {
+  if (blink::Settings::Get().enable_pointer_coalescing) {
+    pointer_data_queue_ = std::make_unique<PointerDataQueue>();
+  }
+  // There is nothing to wait for vsync with or draw into yet.
+  animator_->Stop();
+}
 
 Engine::~Engine() {}
 
+void Engine::Prewarm(const std::string& bundle_path,
+                     const std::string& entrypoint) {
+  TRACE_EVENT0("flutter", "Engine::Prewarm");
+  FXL_DCHECK(platform_view_.expired());
+  RunBundle(bundle_path, entrypoint);
+  prewarmed_bundle_path_ = bundle_path;
+  prewarmed_entrypoint_ = entrypoint;
+}
+
+void Engine::AttachToPlatformView(PlatformView* platform_view) {
+  platform_view_ = platform_view->GetWeakPtr();
+  animator_->set_rasterizer(platform_view->rasterizer().GetWeakRasterizerPtr());
+  animator_->set_vsync_waiter(platform_view->GetVsyncWaiter());
+  animator_->Start();
+}
+
+// Returns whether the pre-warmed run is the one asked for. If it is not, the
+// pre-warmed isolate is dropped so that the requested run starts from scratch.
+bool Engine::ClaimPrewarmedRun(const std::string& bundle_path,
+                               const std::string& entrypoint) {
+  if (prewarmed_bundle_path_.empty())
+    return false;
+  bool matches = prewarmed_bundle_path_ == bundle_path &&
+                 prewarmed_entrypoint_ == entrypoint;
+  prewarmed_bundle_path_.clear();
+  prewarmed_entrypoint_.clear();
+  if (!matches)
+    runtime_.reset();
+  return matches;
+}
+
 void Engine::set_rasterizer(fxl::WeakPtr<Rasterizer> rasterizer) {
   animator_->set_rasterizer(rasterizer);
 }
@@ -93,10 +200,70 @@ fxl::WeakPtr<Engine> Engine::GetWeakPtr() {
 #if !FLUTTER_AOT
 #elif OS(IOS)
 #elif OS(ANDROID)
+// The ranges of a snapshot that a recorded startup used, as lines of a byte
+// offset and a length, next to the snapshot with this extension.
+static const char kPageProfileExtension[] = ".pages";
+
+static const uint8_t* isolate_snapshot_instr_mapping = nullptr;
+static size_t isolate_snapshot_instr_size = 0;
+
+// Asks the kernel to read the ranges of the profile ahead, so that the
+// startup does not wait on a fault for each page of code it first runs.
+static void PrefetchProfiledPages(const uint8_t* mapping,
+                                  size_t size,
+                                  const std::string& profile_path) {
+  std::string profile;
+  if (!files::ReadFileToString(profile_path, &profile))
+    return;
+  TRACE_EVENT0("flutter", "PrefetchProfiledPages");
+  const size_t page_size = getpagesize();
+  std::istringstream stream(profile);
+  size_t offset = 0;
+  size_t length = 0;
+  while (stream >> offset >> length) {
+    if (offset % page_size != 0 || offset >= size)
+      continue;
+    length = std::min(length, size - offset);
+    madvise(const_cast<uint8_t*>(mapping) + offset, length, MADV_WILLNEED);
+  }
+}
+
+static void WriteSnapshotPageProfile(const std::string& profile_path) {
+  if (isolate_snapshot_instr_mapping == nullptr)
+    return;
+  const size_t page_size = getpagesize();
+  const size_t page_count =
+      (isolate_snapshot_instr_size + page_size - 1) / page_size;
+  std::vector<unsigned char> resident(page_count);
+  if (mincore(const_cast<uint8_t*>(isolate_snapshot_instr_mapping),
+              isolate_snapshot_instr_size, resident.data()) != 0) {
+    FXL_LOG(ERROR) << "Could not query the resident snapshot pages.";
+    return;
+  }
+
+  std::ostringstream profile;
+  for (size_t page = 0; page < page_count;) {
+    if (!(resident[page] & 1)) {
+      page++;
+      continue;
+    }
+    const size_t first = page;
+    while (page < page_count && (resident[page] & 1))
+      page++;
+    profile << first * page_size << " " << (page - first) * page_size << "\n";
+  }
+  const std::string contents = profile.str();
+  if (!files::WriteFile(profile_path, contents.data(), contents.size())) {
+    FXL_LOG(ERROR) << "Could not write the snapshot page profile to "
+                   << profile_path;
+  }
+}
+
 static const uint8_t* MemMapSnapshot(const std::string& aot_snapshot_path,
                                      const std::string& default_file_name,
                                      const std::string& settings_file_name,
-                                     bool executable) {
+                                     bool executable,
+                                     size_t* size = nullptr) {
   std::string asset_path;
   if (settings_file_name.empty()) {
     asset_path = aot_snapshot_path + "/" + default_file_name;
@@ -123,10 +290,28 @@ static const uint8_t* MemMapSnapshot(const std::string& aot_snapshot_path,
   if (symbol == MAP_FAILED) {
     return nullptr;
   }
-  return reinterpret_cast<const uint8_t*>(symbol);
+  const uint8_t* mapping = reinterpret_cast<const uint8_t*>(symbol);
+  if (executable)
+    PrefetchProfiledPages(mapping, asset_size,
+                          asset_path + kPageProfileExtension);
+  if (size != nullptr)
+    *size = asset_size;
+  return mapping;
 }
 #endif
 
+// Records the profile asked for by |Settings::snapshot_page_profile_path|.
+static void RecordSnapshotPageProfile() {
+#if FLUTTER_AOT && OS(ANDROID)
+  const std::string& profile_path =
+      blink::Settings::Get().snapshot_page_profile_path;
+  if (profile_path.empty())
+    return;
+  blink::Threads::IO()->PostTask(
+      [profile_path]() { WriteSnapshotPageProfile(profile_path); });
+#endif
+}
+
 static const uint8_t* default_isolate_snapshot_data = nullptr;
 static const uint8_t* default_isolate_snapshot_instr = nullptr;
 
@@ -174,9 +359,11 @@ void Engine::Init() {
   default_isolate_snapshot_data =
       MemMapSnapshot(aot_snapshot_path, "isolate_snapshot_data",
                      settings.aot_isolate_snapshot_data_filename, false);
-  default_isolate_snapshot_instr =
-      MemMapSnapshot(aot_snapshot_path, "isolate_snapshot_instr",
-                     settings.aot_isolate_snapshot_instr_filename, true);
+  default_isolate_snapshot_instr = MemMapSnapshot(
+      aot_snapshot_path, "isolate_snapshot_instr",
+      settings.aot_isolate_snapshot_instr_filename, true,
+      &isolate_snapshot_instr_size);
+  isolate_snapshot_instr_mapping = default_isolate_snapshot_instr;
 #else
 #error Unknown OS
 #endif
@@ -191,17 +378,19 @@ const std::string Engine::main_entrypoint_ = "main";
 void Engine::RunBundle(const std::string& bundle_path,
                        const std::string& entrypoint) {
   TRACE_EVENT0("flutter", "Engine::RunBundle");
+  if (ClaimPrewarmedRun(bundle_path, entrypoint))
+    return;
   ConfigureAssetBundle(bundle_path);
-  std::vector<uint8_t> platform_kernel;
-  GetAssetAsBuffer(blink::kPlatformKernelAssetKey, &platform_kernel);
-  ConfigureRuntime(GetScriptUriFromPath(bundle_path), platform_kernel);
+  ConfigureRuntime(GetScriptUriFromPath(bundle_path),
+                   GetAssetAsMapping(blink::kPlatformKernelAssetKey));
 
   if (blink::IsRunningPrecompiledCode()) {
     runtime_->dart_controller()->RunFromPrecompiledSnapshot(entrypoint);
   } else {
-    std::vector<uint8_t> kernel;
-    if (GetAssetAsBuffer(blink::kKernelAssetKey, &kernel)) {
-      runtime_->dart_controller()->RunFromKernel(kernel, entrypoint);
+    // Kernels are mapped from the bundle rather than copied out of it.
+    if (auto kernel = GetAssetAsMapping(blink::kKernelAssetKey)) {
+      runtime_->dart_controller()->RunFromKernel(std::move(kernel),
+                                                 entrypoint);
       return;
     }
     std::vector<uint8_t> snapshot;
@@ -220,6 +409,7 @@ void Engine::RunBundleAndSnapshot(const std::string& bundle_path,
     RunBundle(bundle_path, entrypoint);
     return;
   }
+  ClaimPrewarmedRun(std::string(), std::string());
   ConfigureAssetBundle(bundle_path);
   ConfigureRuntime(GetScriptUriFromPath(bundle_path));
   if (blink::IsRunningPrecompiledCode()) {
@@ -239,23 +429,28 @@ void Engine::RunBundleAndSource(const std::string& bundle_path,
   TRACE_EVENT0("flutter", "Engine::RunBundleAndSource");
   FXL_CHECK(!blink::IsRunningPrecompiledCode())
       << "Cannot run from source in a precompiled build.";
+  ClaimPrewarmedRun(std::string(), std::string());
   std::string packages_path = packages;
   if (packages_path.empty())
     packages_path = FindPackagesPath(main);
 
-  std::vector<uint8_t> platform_kernel;
+  std::unique_ptr<fml::Mapping> platform_kernel;
   if (!bundle_path.empty()) {
     ConfigureAssetBundle(bundle_path);
-    GetAssetAsBuffer(blink::kPlatformKernelAssetKey, &platform_kernel);
+    platform_kernel = GetAssetAsMapping(blink::kPlatformKernelAssetKey);
   }
-  ConfigureRuntime(GetScriptUriFromPath(bundle_path), platform_kernel);
+  const bool has_platform_kernel = platform_kernel != nullptr;
+  ConfigureRuntime(GetScriptUriFromPath(bundle_path),
+                   std::move(platform_kernel));
 
-  if (!platform_kernel.empty()) {
-    std::vector<uint8_t> kernel;
-    if (!files::ReadFileToVector(main, &kernel)) {
+  if (has_platform_kernel) {
+    auto kernel = std::make_unique<fml::FileMapping>(main);
+    if (kernel->GetMapping() == nullptr) {
       load_script_error_ = tonic::kUnknownErrorType;
+      return;
     }
-    load_script_error_ = runtime_->dart_controller()->RunFromKernel(kernel);
+    load_script_error_ =
+        runtime_->dart_controller()->RunFromKernel(std::move(kernel));
   } else {
     load_script_error_ =
         runtime_->dart_controller()->RunFromSource(main, packages_path);
@@ -264,6 +459,14 @@ void Engine::RunBundleAndSource(const std::string& bundle_path,
 
 void Engine::BeginFrame(fxl::TimePoint frame_time) {
   TRACE_EVENT0("flutter", "Engine::BeginFrame");
+  // The frame should see all input that arrived before it began.
+  if (frame_input_callback_) {
+    in_frame_input_callback_ = true;
+    frame_input_callback_();
+    in_frame_input_callback_ = false;
+  }
+  FlushPointerDataQueue(frame_time);
+  DeliverPendingViewportMetrics();
   if (runtime_)
     runtime_->BeginFrame(frame_time);
 }
@@ -324,7 +527,23 @@ void Engine::OnOutputSurfaceDestroyed(const fxl::Closure& gpu_continuation) {
 }
 
 void Engine::SetViewportMetrics(const blink::ViewportMetrics& metrics) {
-  viewport_metrics_ = metrics;
+  pending_viewport_metrics_ = metrics;
+  have_pending_viewport_metrics_ = true;
+  if (runtime_ && activity_running_ && have_surface_) {
+    // Resizes and keyboard animations send metrics many times per frame. Only
+    // the last ones before the frame are laid out.
+    ScheduleFrame();
+    return;
+  }
+  // No frame may begin soon, so Dart sees the new metrics right away.
+  DeliverPendingViewportMetrics();
+}
+
+void Engine::DeliverPendingViewportMetrics() {
+  if (!have_pending_viewport_metrics_)
+    return;
+  have_pending_viewport_metrics_ = false;
+  viewport_metrics_ = pending_viewport_metrics_;
   if (runtime_)
     runtime_->SetViewportMetrics(viewport_metrics_);
 }
@@ -340,6 +559,12 @@ void Engine::DispatchPlatformMessage(
   } else if (message->channel() == kSettingsChannel) {
     HandleSettingsPlatformMessage(message.get());
     return;
+  } else if (message->channel() == kFrameRateChannel) {
+    HandleFrameRatePlatformMessage(message.get());
+    return;
+  } else if (message->channel() == kRuntimeSettingsChannel) {
+    HandleRuntimeSettingsPlatformMessage(message.get());
+    return;
   }
 
   if (runtime_) {
@@ -353,8 +578,8 @@ void Engine::DispatchPlatformMessage(
 }
 
 bool Engine::HandleLifecyclePlatformMessage(blink::PlatformMessage* message) {
-  const auto& data = message->data();
-  std::string state(reinterpret_cast<const char*>(data.data()), data.size());
+  std::string state(reinterpret_cast<const char*>(message->data()),
+                    message->size());
   if (state == "AppLifecycleState.paused" ||
       state == "AppLifecycleState.suspending") {
     activity_running_ = false;
@@ -377,10 +602,9 @@ bool Engine::HandleLifecyclePlatformMessage(blink::PlatformMessage* message) {
 bool Engine::HandleNavigationPlatformMessage(
     fxl::RefPtr<blink::PlatformMessage> message) {
   FXL_DCHECK(!runtime_);
-  const auto& data = message->data();
-
   rapidjson::Document document;
-  document.Parse(reinterpret_cast<const char*>(data.data()), data.size());
+  document.Parse(reinterpret_cast<const char*>(message->data()),
+                 message->size());
   if (document.HasParseError() || !document.IsObject())
     return false;
   auto root = document.GetObject();
@@ -394,10 +618,9 @@ bool Engine::HandleNavigationPlatformMessage(
 
 bool Engine::HandleLocalizationPlatformMessage(
     blink::PlatformMessage* message) {
-  const auto& data = message->data();
-
   rapidjson::Document document;
-  document.Parse(reinterpret_cast<const char*>(data.data()), data.size());
+  document.Parse(reinterpret_cast<const char*>(message->data()),
+                 message->size());
   if (document.HasParseError() || !document.IsObject())
     return false;
   auto root = document.GetObject();
@@ -423,8 +646,8 @@ bool Engine::HandleLocalizationPlatformMessage(
 }
 
 void Engine::HandleSettingsPlatformMessage(blink::PlatformMessage* message) {
-  const auto& data = message->data();
-  std::string jsonData(reinterpret_cast<const char*>(data.data()), data.size());
+  std::string jsonData(reinterpret_cast<const char*>(message->data()),
+                       message->size());
   user_settings_data_ = jsonData;
   if (runtime_) {
     runtime_->SetUserSettingsData(user_settings_data_);
@@ -433,9 +656,118 @@ void Engine::HandleSettingsPlatformMessage(blink::PlatformMessage* message) {
   }
 }
 
+void Engine::HandleFrameRatePlatformMessage(blink::PlatformMessage* message) {
+  fxl::RefPtr<blink::PlatformMessageResponse> response = message->response();
+  rapidjson::Document document;
+  document.Parse(reinterpret_cast<const char*>(message->data()),
+                 message->size());
+  if (!document.HasParseError() && document.IsObject()) {
+    auto root = document.GetObject();
+    auto method = root.FindMember("method");
+    auto args = root.FindMember("args");
+    if (method != root.MemberEnd() && method->value == "setFrameRateDivisor" &&
+        args != root.MemberEnd() && args->value.IsInt()) {
+      SetFrameRateDivisor(args->value.GetInt());
+    }
+  }
+  if (response)
+    response->CompleteEmpty();
+}
+
+void Engine::SetFrameRateDivisor(int divisor) {
+  animator_->SetFrameRateDivisor(divisor);
+}
+
+void Engine::HandleRuntimeSettingsPlatformMessage(
+    blink::PlatformMessage* message) {
+  fxl::RefPtr<blink::PlatformMessageResponse> response = message->response();
+  rapidjson::Document document;
+  document.Parse(reinterpret_cast<const char*>(message->data()),
+                 message->size());
+  bool handled = false;
+  blink::RuntimeSettings settings = blink::RuntimeSettings::Get();
+  if (!document.HasParseError() && document.IsObject()) {
+    auto root = document.GetObject();
+    auto method = root.FindMember("method");
+    auto args = root.FindMember("args");
+    if (method != root.MemberEnd() && method->value == "get") {
+      handled = true;
+    } else if (method != root.MemberEnd() && method->value == "update" &&
+               args != root.MemberEnd() && args->value.IsObject()) {
+      ReadRuntimeSettings(args->value, &settings);
+      Shell::Shared().UpdateRuntimeSettings(settings);
+      handled = true;
+    }
+  }
+  if (!response)
+    return;
+  if (!handled) {
+    response->CompleteEmpty();
+    return;
+  }
+  std::string json = settings.ToJSON();
+  response->Complete(std::vector<uint8_t>(json.begin(), json.end()));
+}
+
+void Engine::ApplyRuntimeSettings(const blink::RuntimeSettings& settings) {
+  animator_->SetThrottleIdleFrames(settings.throttle_idle_frames);
+}
+
 void Engine::DispatchPointerDataPacket(const PointerDataPacket& packet) {
-  if (runtime_)
-    runtime_->DispatchPointerDataPacket(packet);
+  TRACE_EVENT0("flutter", "Engine::DispatchPointerDataPacket");
+  const int64_t flow_id = next_pointer_event_flow_++;
+  TRACE_FLOW_BEGIN("flutter", "PointerEvent", flow_id);
+  animator_->AddPointerEventFlow(flow_id);
+
+  if (!pointer_data_queue_) {
+    if (runtime_)
+      runtime_->DispatchPointerDataPacket(packet);
+    return;
+  }
+
+  if (pointer_data_queue_->Enqueue(packet)) {
+    // Downs, ups and the like go out right away along with the moves queued
+    // before them.
+    FlushPointerDataQueue(fxl::TimePoint());
+    return;
+  }
+
+  // The queued moves go out with the next frame, unless that frame is the one
+  // feeding them in.
+  if (!in_frame_input_callback_)
+    ScheduleFrame();
+}
+
+void Engine::SetFrameInputCallback(fxl::Closure callback) {
+  frame_input_callback_ = std::move(callback);
+}
+
+void Engine::NotifyInputPending() {
+  ScheduleFrame();
+}
+
+void Engine::FlushPointerDataQueue(fxl::TimePoint frame_time) {
+  if (!pointer_data_queue_ || pointer_data_queue_->empty())
+    return;
+
+  TRACE_EVENT0("flutter", "Engine::FlushPointerDataQueue");
+  // Android's input resampling uses the same latency. It keeps the sample
+  // time within the span of samples that arrived before the frame.
+  const fxl::TimeDelta kResampleLatency =
+      fxl::TimeDelta::FromMilliseconds(5);
+  std::unique_ptr<PointerDataPacket> packet;
+  if (blink::Settings::Get().enable_pointer_resampling &&
+      frame_time != fxl::TimePoint()) {
+    packet =
+        pointer_data_queue_->TakeResampledEvents(frame_time - kResampleLatency);
+  } else {
+    packet = pointer_data_queue_->TakeEvents();
+  }
+
+  // Many coalesced moves can make for a large packet, which is then handed to
+  // Dart without a copy.
+  if (runtime_ && packet)
+    runtime_->DispatchPointerDataPacket(std::move(packet));
 }
 
 void Engine::DispatchSemanticsAction(int id, blink::SemanticsAction action) {
@@ -443,16 +775,30 @@ void Engine::DispatchSemanticsAction(int id, blink::SemanticsAction action) {
     runtime_->DispatchSemanticsAction(id, action);
 }
 
+void Engine::ReportTimings(const std::vector<flow::FrameTiming>& timings) {
+  animator_->ReportTimings(timings);
+  if (runtime_)
+    runtime_->ReportTimings(timings);
+}
+
 void Engine::SetSemanticsEnabled(bool enabled) {
   semantics_enabled_ = enabled;
   if (runtime_)
     runtime_->SetSemanticsEnabled(semantics_enabled_);
 }
 
+void Engine::NotifyMemoryPressure(MemoryPressureLevel level) {
+  TRACE_EVENT0("flutter", "Engine::NotifyMemoryPressure");
+  if (blink::Settings::Get().using_blink) {
+    blink::FontCache::fontCache()->purgeForMemoryPressure(
+        level == MemoryPressureLevel::kCritical);
+  }
+}
+
 void Engine::ConfigureAssetBundle(const std::string& path) {
   struct stat stat_result = {};
 
-  directory_asset_bundle_.reset();
+  asset_manager_ = fxl::MakeRefCounted<blink::AssetManager>();
   // TODO(abarth): We should reset asset_store_ as well, but that might break
   // custom font loading in hot reload.
 
@@ -462,27 +808,36 @@ void Engine::ConfigureAssetBundle(const std::string& path) {
   }
 
   if (S_ISDIR(stat_result.st_mode)) {
-    directory_asset_bundle_ =
-        std::make_unique<blink::DirectoryAssetBundle>(path);
+    asset_manager_->PushBack(
+        fxl::MakeRefCounted<blink::DirectoryAssetBundle>(path));
+  } else if (S_ISREG(stat_result.st_mode)) {
+    asset_store_ = blink::ZipAssetStore::GetShared(path);
+    asset_store_->SetInflatedCacheMaxBytes(
+        blink::Settings::Get().asset_cache_max_bytes);
+    asset_manager_->PushBack(fxl::MakeRefCounted<blink::DirectoryAssetBundle>(
+        files::GetDirectoryName(path)));
+    asset_manager_->PushBack(asset_store_);
+  } else {
     return;
   }
 
-  if (S_ISREG(stat_result.st_mode)) {
-    asset_store_ = fxl::MakeRefCounted<blink::ZipAssetStore>(
-        blink::GetUnzipperProviderForPath(path));
-    directory_asset_bundle_ = std::make_unique<blink::DirectoryAssetBundle>(
-        files::GetDirectoryName(path));
-    return;
-  }
+  // The bundle is configured before the isolate is created, so reading the
+  // assets of a recorded startup now overlaps their I/O with the VM boot.
+  blink::Threads::IO()->PostTask(
+      [asset_manager = asset_manager_]() { PrefetchAssets(asset_manager); });
 }
 
 void Engine::ConfigureRuntime(const std::string& script_uri,
-                              const std::vector<uint8_t>& platform_kernel) {
+                              std::unique_ptr<fml::Mapping> platform_kernel) {
   if (!runtime_) {
     runtime_ = blink::RuntimeController::Create(this);
     runtime_->CreateDartController(
         std::move(script_uri), default_isolate_snapshot_data,
-        default_isolate_snapshot_instr, platform_kernel);
+        default_isolate_snapshot_instr, std::move(platform_kernel));
+    if (have_pending_viewport_metrics_) {
+      have_pending_viewport_metrics_ = false;
+      viewport_metrics_ = pending_viewport_metrics_;
+    }
     runtime_->SetViewportMetrics(viewport_metrics_);
     runtime_->SetLocale(language_code_, country_code_);
     runtime_->SetUserSettingsData(user_settings_data_);
@@ -491,16 +846,15 @@ void Engine::ConfigureRuntime(const std::string& script_uri,
 }
 
 void Engine::DidCreateMainIsolate(Dart_Isolate isolate) {
+  // The fonts are registered with the process's collection even when Blink
+  // lays out text, since the paragraphs of other isolates use libtxt.
   if (blink::Settings::Get().use_test_fonts) {
     blink::TestFontSelector::Install();
-    if (!blink::Settings::Get().using_blink)
-      blink::FontCollection::ForProcess().RegisterTestFonts();
+    blink::FontCollection::ForProcess().RegisterTestFonts();
   } else if (asset_store_) {
     blink::AssetFontSelector::Install(asset_store_);
-    if (!blink::Settings::Get().using_blink) {
-      blink::FontCollection::ForProcess().RegisterFontsFromAssetStore(
-          asset_store_);
-    }
+    blink::FontCollection::ForProcess().RegisterFontsFromAssetStore(
+        asset_store_);
   }
 }
 
@@ -508,6 +862,8 @@ void Engine::DidCreateSecondaryIsolate(Dart_Isolate isolate) {}
 
 void Engine::StopAnimator() {
   animator_->Stop();
+  // Metrics held for a frame that will not begin now.
+  DeliverPendingViewportMetrics();
 }
 
 void Engine::StartAnimatorIfPossible() {
@@ -537,6 +893,12 @@ void Engine::Render(std::unique_ptr<flow::LayerTree> layer_tree) {
 
   layer_tree->set_frame_size(frame_size);
   animator_->Render(std::move(layer_tree));
+
+  if (!rendered_frame_) {
+    rendered_frame_ = true;
+    blink::AllowServiceIsolateStartup();
+    RecordSnapshotPageProfile();
+  }
 }
 
 void Engine::UpdateSemantics(std::vector<blink::SemanticsNode> update) {
@@ -554,6 +916,18 @@ void Engine::HandlePlatformMessage(
     HandleAssetPlatformMessage(std::move(message));
     return;
   }
+  if (message->channel() == kFrameRateChannel) {
+    // The app may cap its own frame rate, such as while only a slow progress
+    // indicator animates.
+    HandleFrameRatePlatformMessage(message.get());
+    return;
+  }
+  if (message->channel() == kRuntimeSettingsChannel) {
+    // Lets the app tune the engine while it runs, such as from a performance
+    // test.
+    HandleRuntimeSettingsPlatformMessage(message.get());
+    return;
+  }
   blink::Threads::Platform()->PostTask([
     platform_view = platform_view_.lock(), message = std::move(message)
   ]() mutable {
@@ -567,22 +941,33 @@ void Engine::HandleAssetPlatformMessage(
   fxl::RefPtr<blink::PlatformMessageResponse> response = message->response();
   if (!response)
     return;
-  const auto& data = message->data();
-  std::string asset_name(reinterpret_cast<const char*>(data.data()),
-                         data.size());
-  std::vector<uint8_t> asset_data;
-  if (GetAssetAsBuffer(asset_name, &asset_data)) {
-    response->Complete(std::move(asset_data));
-  } else {
-    response->CompleteEmpty();
-  }
+  std::string asset_name(reinterpret_cast<const char*>(message->data()),
+                         message->size());
+  // Reading, and for compressed entries inflating, a large asset can take
+  // longer than a frame, so the UI thread only hands the request off.
+  // Responses can be completed on any thread.
+  blink::Threads::IO()->PostTask([
+    asset_manager = asset_manager_, asset_name = std::move(asset_name),
+    response = std::move(response)
+  ]() {
+    TRACE_EVENT0("flutter", "Engine::HandleAssetPlatformMessage");
+    std::vector<uint8_t> asset_data;
+    if (asset_manager && asset_manager->GetAsBuffer(asset_name, &asset_data)) {
+      response->Complete(std::move(asset_data));
+    } else {
+      response->CompleteEmpty();
+    }
+  });
 }
 
 bool Engine::GetAssetAsBuffer(const std::string& name,
                               std::vector<uint8_t>* data) {
-  return (directory_asset_bundle_ &&
-          directory_asset_bundle_->GetAsBuffer(name, data)) ||
-         (asset_store_ && asset_store_->GetAsBuffer(name, data));
+  return asset_manager_ && asset_manager_->GetAsBuffer(name, data);
+}
+
+std::unique_ptr<fml::Mapping> Engine::GetAssetAsMapping(
+    const std::string& name) {
+  return asset_manager_ ? asset_manager_->GetAsMapping(name) : nullptr;
 }
 
 }  // namespace shell
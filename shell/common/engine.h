@@ -5,21 +5,20 @@
 #ifndef SHELL_COMMON_ENGINE_H_
 #define SHELL_COMMON_ENGINE_H_
 
+#include "flutter/assets/asset_manager.h"
 #include "flutter/assets/zip_asset_store.h"
+#include "flutter/fml/mapping.h"
 #include "flutter/lib/ui/window/platform_message.h"
 #include "flutter/lib/ui/window/viewport_metrics.h"
 #include "flutter/runtime/runtime_controller.h"
 #include "flutter/runtime/runtime_delegate.h"
+#include "flutter/shell/common/pointer_data_queue.h"
 #include "flutter/shell/common/rasterizer.h"
+#include "lib/fxl/functional/closure.h"
 #include "lib/fxl/macros.h"
 #include "lib/fxl/memory/weak_ptr.h"
 #include "third_party/skia/include/core/SkPicture.h"
 
-namespace blink {
-class DirectoryAssetBundle;
-class ZipAssetBundle;
-}  // namespace blink
-
 namespace shell {
 class PlatformView;
 class Animator;
@@ -29,12 +28,27 @@ class Engine : public blink::RuntimeDelegate {
  public:
   explicit Engine(PlatformView* platform_view);
 
+  // Creates an engine that is not attached to a platform view yet. Its
+  // animator stays paused until AttachToPlatformView.
+  Engine();
+
   ~Engine() override;
 
   fxl::WeakPtr<Engine> GetWeakPtr();
 
   static void Init();
 
+  // Runs the bundle on an engine that is not attached to a platform view, so
+  // that its isolate, assets and fonts are ready when a view adopts it. The
+  // first run the view asks for reuses this one if it is for the same bundle
+  // and entrypoint.
+  void Prewarm(const std::string& bundle_path,
+               const std::string& entrypoint = main_entrypoint_);
+
+  // Starts drawing the pre-warmed engine into the platform view. Must be
+  // called on the UI thread.
+  void AttachToPlatformView(PlatformView* platform_view);
+
   void RunBundle(const std::string& bundle_path,
                  const std::string& entrypoint = main_entrypoint_);
 
@@ -71,6 +85,21 @@ class Engine : public blink::RuntimeDelegate {
   void DispatchPointerDataPacket(const PointerDataPacket& packet);
   void DispatchSemanticsAction(int id, blink::SemanticsAction action);
   void SetSemanticsEnabled(bool enabled);
+  // Frees the text caches that live on the UI thread.
+  void NotifyMemoryPressure(MemoryPressureLevel level);
+  void ReportTimings(const std::vector<flow::FrameTiming>& timings);
+  // Caps the frame rate to the display rate divided by |divisor|. See
+  // |Animator::SetFrameRateDivisor|.
+  void SetFrameRateDivisor(int divisor);
+  // Applies the runtime settings that concern the UI thread.
+  void ApplyRuntimeSettings(const blink::RuntimeSettings& settings);
+
+  // Sets a callback that runs at the start of every frame, before the input
+  // queued for the frame is dispatched. Lets embedders that batch input
+  // themselves feed it to the frame.
+  void SetFrameInputCallback(fxl::Closure callback);
+  // Schedules a frame so that the frame input callback gets to run.
+  void NotifyInputPending();
 
   void set_rasterizer(fxl::WeakPtr<Rasterizer> rasterizer);
 
@@ -85,38 +114,69 @@ class Engine : public blink::RuntimeDelegate {
   void DidCreateMainIsolate(Dart_Isolate isolate) override;
   void DidCreateSecondaryIsolate(Dart_Isolate isolate) override;
 
+  bool ClaimPrewarmedRun(const std::string& bundle_path,
+                         const std::string& entrypoint);
+
   void StopAnimator();
   void StartAnimatorIfPossible();
 
   void ConfigureAssetBundle(const std::string& path);
+  void DeliverPendingViewportMetrics();
   void ConfigureRuntime(
       const std::string& script_uri,
-      const std::vector<uint8_t>& platform_kernel = std::vector<uint8_t>());
+      std::unique_ptr<fml::Mapping> platform_kernel = nullptr);
 
   bool HandleLifecyclePlatformMessage(blink::PlatformMessage* message);
   bool HandleNavigationPlatformMessage(
       fxl::RefPtr<blink::PlatformMessage> message);
   bool HandleLocalizationPlatformMessage(blink::PlatformMessage* message);
   void HandleSettingsPlatformMessage(blink::PlatformMessage* message);
+  // Handles {"method": "setFrameRateDivisor", "args": <divisor>}, sent by
+  // either the platform or the app.
+  void HandleFrameRatePlatformMessage(blink::PlatformMessage* message);
+  // Handles {"method": "get"} and {"method": "update", "args": {...}}, sent by
+  // either the platform or the app, and responds with the runtime settings in
+  // effect. See |blink::RuntimeSettings::ToJSON| for the names.
+  void HandleRuntimeSettingsPlatformMessage(blink::PlatformMessage* message);
 
   void HandleAssetPlatformMessage(fxl::RefPtr<blink::PlatformMessage> message);
+
+  // Dispatches the queued pointer events. Resamples them at |frame_time| if
+  // resampling is enabled and |frame_time| is set.
+  void FlushPointerDataQueue(fxl::TimePoint frame_time);
   bool GetAssetAsBuffer(const std::string& name, std::vector<uint8_t>* data);
+  std::unique_ptr<fml::Mapping> GetAssetAsMapping(const std::string& name);
 
   static const std::string main_entrypoint_;
 
   std::weak_ptr<PlatformView> platform_view_;
   std::unique_ptr<Animator> animator_;
   std::unique_ptr<blink::RuntimeController> runtime_;
+  // Null unless pointer coalescing is enabled.
+  std::unique_ptr<PointerDataQueue> pointer_data_queue_;
+  fxl::Closure frame_input_callback_;
+  bool in_frame_input_callback_ = false;
+  // Identifies the trace flows of dispatched pointer events.
+  int64_t next_pointer_event_flow_ = 1;
   tonic::DartErrorHandleType load_script_error_;
+  // The run of a pre-warmed engine that its view has not asked for yet.
+  std::string prewarmed_bundle_path_;
+  std::string prewarmed_entrypoint_;
   std::string initial_route_;
+  // The metrics last delivered to Dart, which frames are rendered at.
   blink::ViewportMetrics viewport_metrics_;
+  // Metrics received while frames are being produced are delivered once, at
+  // the start of the next frame.
+  blink::ViewportMetrics pending_viewport_metrics_;
+  bool have_pending_viewport_metrics_ = false;
   std::string language_code_;
   std::string country_code_;
   std::string user_settings_data_;
   bool semantics_enabled_ = false;
-  // TODO(abarth): Unify these two behind a common interface.
+  bool rendered_frame_ = false;
+  fxl::RefPtr<blink::AssetManager> asset_manager_;
+  // The zip bundle of asset_manager_, if any, which fonts are loaded from.
   fxl::RefPtr<blink::ZipAssetStore> asset_store_;
-  std::unique_ptr<blink::DirectoryAssetBundle> directory_asset_bundle_;
   // TODO(eseidel): This should move into an AnimatorStateMachine.
   bool activity_running_;
   bool have_surface_;
@@ -0,0 +1,126 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/frame_coordinator.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+#include "flutter/common/threads.h"
+#include "flutter/fml/task_priority.h"
+#include "flutter/glue/trace_event.h"
+
+namespace shell {
+
+FrameCoordinator& FrameCoordinator::Get() {
+  static FrameCoordinator* coordinator = new FrameCoordinator();
+  return *coordinator;
+}
+
+FrameCoordinator::FrameCoordinator() = default;
+
+FrameCoordinator::~FrameCoordinator() = default;
+
+void FrameCoordinator::AsyncWaitForVsync(const void* owner,
+                                         VsyncWaiter* waiter,
+                                         VsyncWaiter::Callback callback) {
+  ASSERT_IS_UI_THREAD;
+  pending_waits_.push_back({owner, waiter, std::move(callback)});
+  // Callbacks that wait again while a vsync is dispatched wait for the next
+  // one once the dispatch is over.
+  if (!dispatching_) {
+    WaitIfNeeded();
+  }
+}
+
+void FrameCoordinator::SetWaiter(const void* owner, VsyncWaiter* waiter) {
+  ASSERT_IS_UI_THREAD;
+  for (PendingWait& wait : pending_waits_) {
+    if (wait.owner == owner) {
+      wait.waiter = waiter;
+    }
+  }
+}
+
+void FrameCoordinator::RemoveOwner(const void* owner) {
+  ASSERT_IS_UI_THREAD;
+  pending_waits_.erase(
+      std::remove_if(
+          pending_waits_.begin(), pending_waits_.end(),
+          [owner](const PendingWait& wait) { return wait.owner == owner; }),
+      pending_waits_.end());
+  if (owner != waiting_owner_) {
+    return;
+  }
+  // The waiter of the wait in flight may not call back anymore, so the
+  // others wait again with a waiter of their own.
+  waiting_owner_ = nullptr;
+  wait_generation_++;
+  if (!dispatching_) {
+    WaitIfNeeded();
+  }
+}
+
+void FrameCoordinator::PostDraw(fxl::Closure draw) {
+  ASSERT_IS_UI_THREAD;
+  if (dispatching_) {
+    pending_draws_.push_back(std::move(draw));
+    return;
+  }
+  fml::ScopedTaskPriority priority(fml::TaskPriority::kFrameCritical);
+  blink::Threads::Gpu()->PostTask(std::move(draw));
+}
+
+void FrameCoordinator::WaitIfNeeded() {
+  if (pending_waits_.empty() || waiting_owner_ != nullptr) {
+    return;
+  }
+  const PendingWait& wait = pending_waits_.front();
+  waiting_owner_ = wait.owner;
+  const int64_t generation = ++wait_generation_;
+  wait.waiter->AsyncWaitForVsync(
+      [this, generation](fxl::TimePoint frame_start_time,
+                         fxl::TimePoint frame_target_time) {
+        if (generation == wait_generation_) {
+          OnVsync(frame_start_time, frame_target_time);
+        }
+      });
+}
+
+void FrameCoordinator::OnVsync(fxl::TimePoint frame_start_time,
+                               fxl::TimePoint frame_target_time) {
+  TRACE_EVENT1("flutter", "FrameCoordinator::OnVsync", "views",
+               std::to_string(pending_waits_.size()).c_str());
+  waiting_owner_ = nullptr;
+  std::vector<PendingWait> waits;
+  waits.swap(pending_waits_);
+
+  dispatching_ = true;
+  for (PendingWait& wait : waits) {
+    wait.callback(frame_start_time, frame_target_time);
+  }
+  dispatching_ = false;
+
+  FlushDraws();
+  WaitIfNeeded();
+}
+
+void FrameCoordinator::FlushDraws() {
+  if (pending_draws_.empty()) {
+    return;
+  }
+  std::vector<fxl::Closure> draws;
+  draws.swap(pending_draws_);
+  fml::ScopedTaskPriority priority(fml::TaskPriority::kFrameCritical);
+  blink::Threads::Gpu()->PostTask([draws = std::move(draws)]() {
+    TRACE_EVENT1("flutter", "FrameCoordinator::Draw", "views",
+                 std::to_string(draws.size()).c_str());
+    for (const fxl::Closure& draw : draws) {
+      draw();
+    }
+  });
+}
+
+}  // namespace shell
@@ -0,0 +1,77 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_FRAME_COORDINATOR_H_
+#define FLUTTER_SHELL_COMMON_FRAME_COORDINATOR_H_
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "flutter/shell/common/vsync_waiter.h"
+#include "lib/fxl/functional/closure.h"
+#include "lib/fxl/macros.h"
+
+namespace shell {
+
+// Drives the animators of all views from one vsync wait at a time, and
+// rasterizes the frames they render for a vsync in a single task on the GPU
+// thread, so that the views present back to back. Only used on the UI thread.
+class FrameCoordinator {
+ public:
+  static FrameCoordinator& Get();
+
+  // Calls |callback| at the next vsync. Animators that wait at the same time
+  // share the wait of the first of them, which waits with its |waiter|.
+  // |owner| identifies the animator to |SetWaiter| and |RemoveOwner|.
+  void AsyncWaitForVsync(const void* owner,
+                         VsyncWaiter* waiter,
+                         VsyncWaiter::Callback callback);
+
+  // Replaces the waiter |owner| waits with from now on.
+  void SetWaiter(const void* owner, VsyncWaiter* waiter);
+
+  // Drops the pending callbacks of |owner|, whose waiter may go away.
+  void RemoveOwner(const void* owner);
+
+  // Runs |draw| on the GPU thread. The draws posted by the callbacks of a
+  // vsync run in a single task once all of the callbacks have returned.
+  void PostDraw(fxl::Closure draw);
+
+ private:
+  struct PendingWait {
+    const void* owner;
+    VsyncWaiter* waiter;
+    VsyncWaiter::Callback callback;
+  };
+
+  std::vector<PendingWait> pending_waits_;
+  // The owner whose waiter the wait in flight was issued with. Null if no
+  // wait is in flight.
+  const void* waiting_owner_ = nullptr;
+  // Identifies the wait in flight, so that the callbacks of abandoned waits
+  // are ignored.
+  int64_t wait_generation_ = 0;
+  // Whether the callbacks of a vsync are being called.
+  bool dispatching_ = false;
+  std::vector<fxl::Closure> pending_draws_;
+
+  FrameCoordinator();
+  ~FrameCoordinator();
+
+  // Issues a wait for the pending callbacks unless one is in flight.
+  void WaitIfNeeded();
+
+  void OnVsync(fxl::TimePoint frame_start_time,
+               fxl::TimePoint frame_target_time);
+
+  // Posts the draws of the callbacks of the last vsync as one task.
+  void FlushDraws();
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(FrameCoordinator);
+};
+
+}  // namespace shell
+
+#endif  // FLUTTER_SHELL_COMMON_FRAME_COORDINATOR_H_
@@ -0,0 +1,77 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/frame_pacer.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace shell {
+
+// Time left unclaimed between the predicted end of the build and the target
+// time to absorb scheduling jitter.
+static constexpr fxl::TimeDelta kSafetyMargin =
+    fxl::TimeDelta::FromMilliseconds(2);
+
+// The fraction of recent frames the prediction is expected to cover.
+static constexpr double kPredictionPercentile = 0.9;
+
+FramePacer::FramePacer(size_t history_size) : history_size_(history_size) {}
+
+FramePacer::~FramePacer() = default;
+
+void FramePacer::AddBuildDuration(fxl::TimeDelta duration) {
+  AddDuration(build_durations_, duration);
+}
+
+void FramePacer::AddRasterDuration(fxl::TimeDelta duration) {
+  AddDuration(raster_durations_, duration);
+}
+
+void FramePacer::AddDuration(std::deque<fxl::TimeDelta>& history,
+                             fxl::TimeDelta duration) {
+  if (history_size_ == 0) {
+    return;
+  }
+  if (history.size() == history_size_) {
+    history.pop_front();
+  }
+  history.push_back(duration);
+}
+
+fxl::TimeDelta FramePacer::Predict(
+    const std::deque<fxl::TimeDelta>& history) const {
+  std::vector<fxl::TimeDelta> sorted(history.begin(), history.end());
+  std::sort(sorted.begin(), sorted.end());
+  const size_t index = std::min<size_t>(
+      sorted.size() - 1, static_cast<size_t>(sorted.size() *
+                                             kPredictionPercentile));
+  return sorted[index];
+}
+
+fxl::TimePoint FramePacer::GetBuildStartTime(
+    fxl::TimePoint frame_start_time,
+    fxl::TimePoint frame_target_time) const {
+  // Only pace once a full history is available so that a few fast frames
+  // after startup do not push builds past their deadline.
+  if (history_size_ == 0 || build_durations_.size() < history_size_ ||
+      raster_durations_.empty()) {
+    return frame_start_time;
+  }
+
+  const fxl::TimeDelta interval = frame_target_time - frame_start_time;
+
+  // Rasterization of this frame overlaps the build of the next one. If the GPU
+  // thread cannot keep up with the display already, delaying builds would only
+  // make that worse.
+  if (Predict(raster_durations_) + kSafetyMargin >= interval) {
+    return frame_start_time;
+  }
+
+  const fxl::TimePoint start =
+      frame_target_time - Predict(build_durations_) - kSafetyMargin;
+  return std::max(start, frame_start_time);
+}
+
+}  // namespace shell
@@ -0,0 +1,53 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_FRAME_PACER_H_
+#define FLUTTER_SHELL_COMMON_FRAME_PACER_H_
+
+#include <deque>
+
+#include "lib/fxl/macros.h"
+#include "lib/fxl/time/time_delta.h"
+#include "lib/fxl/time/time_point.h"
+
+namespace shell {
+
+// Keeps a rolling history of how long the UI and GPU threads took to build
+// and rasterize recent frames and uses it to decide how late after vsync a
+// frame can be started while still being ready by its target time. Starting
+// later lets the frame pick up input that arrives in the meantime.
+class FramePacer {
+ public:
+  explicit FramePacer(size_t history_size = 32);
+
+  ~FramePacer();
+
+  void AddBuildDuration(fxl::TimeDelta duration);
+
+  void AddRasterDuration(fxl::TimeDelta duration);
+
+  // Returns the point in time at which the UI thread should begin building a
+  // frame that must be ready by |frame_target_time|. Never earlier than
+  // |frame_start_time|. Frames start immediately until enough history has
+  // been collected or if the GPU thread is not keeping up.
+  fxl::TimePoint GetBuildStartTime(fxl::TimePoint frame_start_time,
+                                   fxl::TimePoint frame_target_time) const;
+
+ private:
+  const size_t history_size_;
+  std::deque<fxl::TimeDelta> build_durations_;
+  std::deque<fxl::TimeDelta> raster_durations_;
+
+  void AddDuration(std::deque<fxl::TimeDelta>& history,
+                   fxl::TimeDelta duration);
+
+  // A conservative estimate of the next duration given a history.
+  fxl::TimeDelta Predict(const std::deque<fxl::TimeDelta>& history) const;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(FramePacer);
+};
+
+}  // namespace shell
+
+#endif  // FLUTTER_SHELL_COMMON_FRAME_PACER_H_
@@ -0,0 +1,74 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/memory_usage.h"
+
+#include "flutter/assets/zip_asset_store.h"
+#include "flutter/flow/image_memory_tracker.h"
+#include "flutter/fml/trace_event.h"
+#include "flutter/lib/ui/text/font_collection.h"
+#include "minikin/Layout.h"
+#include "third_party/skia/include/core/SkGraphics.h"
+
+namespace shell {
+
+void GetMemoryUsage(MemoryUsage* usage) {
+  using Category = flow::ImageMemoryTracker::Category;
+  const auto& tracker = flow::ImageMemoryTracker::Get();
+  usage->raster_cache_bytes = tracker.GetBytes(Category::kRasterCache);
+  usage->decoded_image_bytes = tracker.GetBytes(Category::kDecoded);
+  usage->gpu_resident_image_bytes = tracker.GetBytes(Category::kGPUResident);
+
+  usage->glyph_cache_bytes = SkGraphics::GetFontCacheUsed();
+
+  size_t layout_cache_entries = 0;
+  size_t layout_cache_bytes = 0;
+  minikin::Layout::getCacheUsage(&layout_cache_entries, &layout_cache_bytes);
+  usage->layout_cache_entries = layout_cache_entries;
+  usage->layout_cache_bytes = layout_cache_bytes;
+
+  usage->font_data_bytes =
+      blink::FontCollection::ForProcess().GetFontDataBytes();
+  usage->asset_cache_bytes = blink::ZipAssetStore::GetTotalInflatedCacheBytes();
+}
+
+int64_t GetResourceCacheBytes(GrContext* context) {
+  if (context == nullptr) {
+    return 0;
+  }
+  size_t bytes = 0;
+  context->getResourceCacheUsage(nullptr, &bytes);
+  return bytes;
+}
+
+void AppendMemoryUsageJSON(std::stringstream* stream,
+                           const MemoryUsage& usage) {
+  *stream << "{\"gpuResourceCacheBytes\":" << usage.gpu_resource_cache_bytes;
+  *stream << ",\"ioResourceCacheBytes\":" << usage.io_resource_cache_bytes;
+  *stream << ",\"rasterCacheBytes\":" << usage.raster_cache_bytes;
+  *stream << ",\"decodedImageBytes\":" << usage.decoded_image_bytes;
+  *stream << ",\"gpuResidentImageBytes\":" << usage.gpu_resident_image_bytes;
+  *stream << ",\"glyphCacheBytes\":" << usage.glyph_cache_bytes;
+  *stream << ",\"layoutCacheEntries\":" << usage.layout_cache_entries;
+  *stream << ",\"layoutCacheBytes\":" << usage.layout_cache_bytes;
+  *stream << ",\"fontDataBytes\":" << usage.font_data_bytes;
+  *stream << ",\"assetCacheBytes\":" << usage.asset_cache_bytes << "}";
+}
+
+void TraceMemoryUsage(const MemoryUsage& usage) {
+  TRACE_COUNTER1("flutter", "GpuResourceCacheBytes",
+                 usage.gpu_resource_cache_bytes);
+  TRACE_COUNTER1("flutter", "IoResourceCacheBytes",
+                 usage.io_resource_cache_bytes);
+  TRACE_COUNTER1("flutter", "RasterCacheBytes", usage.raster_cache_bytes);
+  TRACE_COUNTER1("flutter", "DecodedImageBytes", usage.decoded_image_bytes);
+  TRACE_COUNTER1("flutter", "GpuResidentImageBytes",
+                 usage.gpu_resident_image_bytes);
+  TRACE_COUNTER1("flutter", "GlyphCacheBytes", usage.glyph_cache_bytes);
+  TRACE_COUNTER1("flutter", "LayoutCacheBytes", usage.layout_cache_bytes);
+  TRACE_COUNTER1("flutter", "FontDataBytes", usage.font_data_bytes);
+  TRACE_COUNTER1("flutter", "AssetCacheBytes", usage.asset_cache_bytes);
+}
+
+}  // namespace shell
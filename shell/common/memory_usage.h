@@ -0,0 +1,54 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_MEMORY_USAGE_H_
+#define FLUTTER_SHELL_COMMON_MEMORY_USAGE_H_
+
+#include <stdint.h>
+
+#include <sstream>
+
+#include "third_party/skia/include/gpu/GrContext.h"
+
+namespace shell {
+
+// The native memory held by each subsystem of the engine, in bytes. The Dart
+// heaps and the external allocations of isolates are reported by the VM
+// service's own getMemoryUsage.
+struct MemoryUsage {
+  // The Skia resource caches of the GPU and IO thread contexts. These include
+  // the textures of raster cache entries and of GPU resident images, which are
+  // also accounted below.
+  int64_t gpu_resource_cache_bytes = 0;
+  int64_t io_resource_cache_bytes = 0;
+  int64_t raster_cache_bytes = 0;
+  int64_t decoded_image_bytes = 0;
+  int64_t gpu_resident_image_bytes = 0;
+  // The Skia glyph cache.
+  int64_t glyph_cache_bytes = 0;
+  // The shaped words of the minikin layout cache.
+  int64_t layout_cache_entries = 0;
+  int64_t layout_cache_bytes = 0;
+  int64_t font_data_bytes = 0;
+  // The inflated asset caches of the asset stores.
+  int64_t asset_cache_bytes = 0;
+};
+
+// Fills in everything but the resource caches, which can only be read on the
+// threads of their contexts. May be called on any thread.
+void GetMemoryUsage(MemoryUsage* usage);
+
+// The bytes held by the resource cache of |context|, or zero if it is null.
+// Must be called on the thread of the context.
+int64_t GetResourceCacheBytes(GrContext* context);
+
+void AppendMemoryUsageJSON(std::stringstream* stream,
+                           const MemoryUsage& usage);
+
+// Records a trace counter per subsystem.
+void TraceMemoryUsage(const MemoryUsage& usage);
+
+}  // namespace shell
+
+#endif  // FLUTTER_SHELL_COMMON_MEMORY_USAGE_H_
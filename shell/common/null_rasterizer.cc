@@ -51,4 +51,12 @@ void NullRasterizer::AddNextFrameCallback(fxl::Closure nextFrameCallback) {
   // Null rasterizer. Nothing to do.
 }
 
+void NullRasterizer::SetFrameTimingsCallback(FrameTimingsCallback callback) {
+  // Null rasterizers never present frames.
+}
+
+flow::TextureRegistry& NullRasterizer::GetTextureRegistry() {
+  return texture_registry_;
+}
+
 }  // namespace shell
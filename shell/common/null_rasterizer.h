@@ -32,8 +32,13 @@ class NullRasterizer : public Rasterizer {
 
   void AddNextFrameCallback(fxl::Closure nextFrameCallback) override;
 
+  void SetFrameTimingsCallback(FrameTimingsCallback callback) override;
+
+  flow::TextureRegistry& GetTextureRegistry() override;
+
  private:
   std::unique_ptr<Surface> surface_;
+  flow::TextureRegistry texture_registry_;
   fxl::WeakPtrFactory<NullRasterizer> weak_factory_;
 
   FXL_DISALLOW_COPY_AND_ASSIGN(NullRasterizer);
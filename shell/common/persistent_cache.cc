@@ -0,0 +1,100 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/persistent_cache.h"
+
+#include <stdio.h>
+
+#include <functional>
+#include <sstream>
+
+#include "flutter/common/settings.h"
+#include "flutter/common/threads.h"
+#include "lib/fxl/files/directory.h"
+#include "lib/fxl/files/file.h"
+#include "lib/fxl/files/path.h"
+#include "lib/fxl/logging.h"
+
+namespace shell {
+namespace {
+
+// Bump when the layout of the files changes.
+constexpr char kCacheFormatVersion[] = "1";
+
+constexpr char kVersionFileName[] = "version";
+
+std::string ToString(const SkData& data) {
+  return std::string(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
+}  // namespace
+
+std::unique_ptr<PersistentCache> PersistentCache::Create(
+    const std::string& driver_version) {
+  const blink::Settings& settings = blink::Settings::Get();
+  if (!settings.persistent_gpu_cache || settings.temp_directory_path.empty())
+    return nullptr;
+
+  const std::string directory =
+      settings.temp_directory_path + "/flutter_gpu_cache";
+  const std::string version_path = directory + "/" + kVersionFileName;
+  const std::string version =
+      std::string(kCacheFormatVersion) + "\n" + driver_version;
+
+  std::string stored_version;
+  if (!files::ReadFileToString(version_path, &stored_version) ||
+      stored_version != version) {
+    // Programs compiled by another driver cannot be used with this one.
+    files::DeletePath(directory, true);
+    if (!files::CreateDirectory(directory) ||
+        !files::WriteFile(version_path, version.data(), version.size())) {
+      FXL_DLOG(WARNING) << "Could not create the GPU cache in " << directory;
+      return nullptr;
+    }
+  }
+
+  return std::unique_ptr<PersistentCache>(new PersistentCache(directory));
+}
+
+PersistentCache::PersistentCache(std::string directory)
+    : directory_(std::move(directory)) {}
+
+PersistentCache::~PersistentCache() = default;
+
+std::string PersistentCache::GetPath(const SkData& key) const {
+  std::ostringstream path;
+  path << directory_ << "/" << std::hex
+       << std::hash<std::string>()(ToString(key));
+  return path.str();
+}
+
+// The files hold the key followed by the data, so that keys with the same
+// hash are told apart.
+sk_sp<SkData> PersistentCache::load(const SkData& key) {
+  std::string contents;
+  if (!files::ReadFileToString(GetPath(key), &contents))
+    return nullptr;
+  if (contents.size() < key.size() ||
+      contents.compare(0, key.size(), ToString(key)) != 0)
+    return nullptr;
+  return SkData::MakeWithCopy(contents.data() + key.size(),
+                              contents.size() - key.size());
+}
+
+void PersistentCache::store(const SkData& key, const SkData& data) {
+  std::string contents = ToString(key);
+  contents.append(reinterpret_cast<const char*>(data.data()), data.size());
+  blink::Threads::IO()->PostTask(
+      [path = GetPath(key), contents = std::move(contents)]() {
+        // Write a new file instead of truncating the old one so that a load
+        // on the GPU thread never reads half of it.
+        const std::string temp_path = path + ".tmp";
+        if (!files::WriteFile(temp_path, contents.data(), contents.size()) ||
+            ::rename(temp_path.c_str(), path.c_str()) != 0) {
+          FXL_DLOG(WARNING) << "Could not write to the GPU cache at " << path;
+        }
+      });
+}
+
+}  // namespace shell
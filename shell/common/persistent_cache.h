@@ -0,0 +1,49 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_PERSISTENT_CACHE_H_
+#define FLUTTER_SHELL_COMMON_PERSISTENT_CACHE_H_
+
+#include <memory>
+#include <string>
+
+#include "lib/fxl/macros.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/gpu/GrContextOptions.h"
+
+namespace shell {
+
+// Keeps the programs and pipelines Skia compiles for a GrContext in files in
+// the temporary directory, so that later launches do not compile them again.
+// The files are only used with the driver they were written by. Loads happen
+// on the thread of the GrContext, the files are written on the IO thread.
+class PersistentCache : public GrContextOptions::PersistentCache {
+ public:
+  // Returns null unless the persistent GPU cache is enabled and there is a
+  // temporary directory to keep it in. |driver_version| identifies the driver
+  // and device, a cache written with a different one is discarded.
+  static std::unique_ptr<PersistentCache> Create(
+      const std::string& driver_version);
+
+  ~PersistentCache() override;
+
+  // |GrContextOptions::PersistentCache|
+  sk_sp<SkData> load(const SkData& key) override;
+
+  // |GrContextOptions::PersistentCache|
+  void store(const SkData& key, const SkData& data) override;
+
+ private:
+  const std::string directory_;
+
+  explicit PersistentCache(std::string directory);
+
+  std::string GetPath(const SkData& key) const;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(PersistentCache);
+};
+
+}  // namespace shell
+
+#endif  // FLUTTER_SHELL_COMMON_PERSISTENT_CACHE_H_
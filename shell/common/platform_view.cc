@@ -6,15 +6,27 @@
 
 #include <utility>
 
+#include "flutter/common/settings.h"
 #include "flutter/common/threads.h"
+#include "flutter/glue/trace_event.h"
+#include "flutter/lib/ui/painting/image_decoding.h"
 #include "flutter/lib/ui/painting/resource_context.h"
+#include "flutter/lib/ui/painting/shader_cache.h"
 #include "flutter/shell/common/rasterizer.h"
 #include "flutter/shell/common/vsync_waiter_fallback.h"
 #include "lib/fxl/functional/make_copyable.h"
+#include "third_party/skia/include/core/SkGraphics.h"
 #include "third_party/skia/include/gpu/GrContextOptions.h"
 #include "third_party/skia/include/gpu/gl/GrGLInterface.h"
 
 namespace shell {
+namespace {
+
+// Only applies when the resource context has a byte budget. The byte budget is
+// the limit that matters.
+constexpr int kResourceContextCacheMaxCount = 8192;
+
+}  // namespace
 
 PlatformView::PlatformView(std::unique_ptr<Rasterizer> rasterizer)
     : rasterizer_(std::move(rasterizer)), size_(SkISize::Make(0, 0)) {}
@@ -34,10 +46,23 @@ void PlatformView::SetRasterizer(std::unique_ptr<Rasterizer> rasterizer) {
   blink::Threads::Gpu()->PostTask([r]() { delete r; });
   rasterizer_ = std::move(rasterizer);
   engine_->set_rasterizer(rasterizer_->GetWeakRasterizerPtr());
+  SetupFrameTimingsCallback();
 }
 
 void PlatformView::CreateEngine() {
-  engine_.reset(new Engine(this));
+  engine_ = Shell::Shared().TakePrewarmedEngine();
+  if (!engine_) {
+    engine_.reset(new Engine(this));
+    return;
+  }
+
+  // The pre-warmed engine is already running on the UI thread.
+  fxl::AutoResetWaitableEvent latch;
+  blink::Threads::UI()->PostTask([this, &latch]() {
+    engine_->AttachToPlatformView(this);
+    latch.Signal();
+  });
+  latch.Wait();
 }
 
 // Add this to the shell's list of PlatformVIews.
@@ -45,6 +70,56 @@ void PlatformView::CreateEngine() {
 void PlatformView::PostAddToShellTask() {
   blink::Threads::UI()->PostTask(
       [self = shared_from_this()] { Shell::Shared().AddPlatformView(self); });
+  SetupFrameTimingsCallback();
+}
+
+// Routes frame timing records and statistics from the rasterizer to Dart and
+// to the embedder. Requires the platform view to be owned by a shared pointer.
+void PlatformView::SetupFrameTimingsCallback() {
+  Rasterizer::FrameTimingsCallback callback = [
+    engine = engine_->GetWeakPtr(), view = GetWeakPtr()
+  ](std::vector<flow::FrameTiming> timings) {
+    blink::Threads::UI()->PostTask([engine, timings]() {
+      if (engine) {
+        engine->ReportTimings(timings);
+      }
+    });
+    blink::Threads::Platform()->PostTask(
+        fxl::MakeCopyable([ view, timings = std::move(timings) ]() mutable {
+          if (auto platform_view = view.lock()) {
+            platform_view->ReportFrameTimings(std::move(timings));
+          }
+        }));
+  };
+
+  blink::Threads::Gpu()->PostTask(
+      [ rasterizer = rasterizer_->GetWeakRasterizerPtr(), callback ]() {
+        if (rasterizer) {
+          rasterizer->SetFrameTimingsCallback(callback);
+        }
+      });
+
+  const fxl::TimeDelta statistics_interval = GetFrameStatisticsInterval();
+  if (statistics_interval <= fxl::TimeDelta::Zero()) {
+    return;
+  }
+  Rasterizer::FrameStatisticsCallback statistics_callback =
+      [view = GetWeakPtr()](const flow::FrameStatistics& statistics) {
+        blink::Threads::Platform()->PostTask([view, statistics]() {
+          if (auto platform_view = view.lock()) {
+            platform_view->ReportFrameStatistics(statistics);
+          }
+        });
+      };
+  blink::Threads::Gpu()->PostTask([
+    rasterizer = rasterizer_->GetWeakRasterizerPtr(), statistics_interval,
+    statistics_callback
+  ]() {
+    if (rasterizer) {
+      rasterizer->SetFrameStatisticsCallback(statistics_interval,
+                                             statistics_callback);
+    }
+  });
 }
 
 void PlatformView::DispatchPlatformMessage(
@@ -75,6 +150,94 @@ void PlatformView::SetSemanticsEnabled(bool enabled) {
   });
 }
 
+void PlatformView::SetFrameRateDivisor(int divisor) {
+  blink::Threads::UI()->PostTask([ engine = engine_->GetWeakPtr(), divisor ] {
+    if (engine)
+      engine->SetFrameRateDivisor(divisor);
+  });
+}
+
+void PlatformView::ApplyRuntimeSettings(
+    const blink::RuntimeSettings& settings) {
+  blink::Threads::UI()->PostTask([ engine = engine_->GetWeakPtr(), settings ] {
+    if (engine)
+      engine->ApplyRuntimeSettings(settings);
+  });
+
+  blink::Threads::Gpu()->PostTask(
+      [ rasterizer = rasterizer_->GetWeakRasterizerPtr(), settings ] {
+        if (rasterizer)
+          rasterizer->ApplyRuntimeSettings(settings);
+      });
+}
+
+void PlatformView::NotifyMemoryPressure(MemoryPressureLevel level) {
+  blink::Threads::UI()->PostTask([ engine = engine_->GetWeakPtr(), level ] {
+    if (engine)
+      engine->NotifyMemoryPressure(level);
+  });
+
+  blink::Threads::Gpu()->PostTask(
+      [ rasterizer = rasterizer_->GetWeakRasterizerPtr(), level ] {
+        if (rasterizer)
+          rasterizer->OnMemoryPressure(level);
+      });
+
+  blink::Threads::IO()->PostTask([level] {
+    TRACE_EVENT0("flutter", "PlatformView::NotifyMemoryPressure");
+    // Cached decoded images and the image shaders made from them hold
+    // textures in the resource context, so they go first.
+    blink::ImageDecoding::ClearImageCache();
+    blink::ShaderCache::Shared().Clear();
+    GrContext* context = blink::ResourceContext::Get();
+    if (level == MemoryPressureLevel::kCritical) {
+      if (context)
+        context->freeGpuResources();
+      SkGraphics::PurgeFontCache();
+      SkGraphics::PurgeResourceCache();
+    } else if (context) {
+      context->purgeAllUnlockedResources();
+    }
+  });
+}
+
+void PlatformView::RegisterTexture(std::shared_ptr<flow::Texture> texture) {
+  blink::Threads::Gpu()->PostTask([
+    rasterizer = rasterizer_->GetWeakRasterizerPtr(), texture
+  ] {
+    if (rasterizer)
+      rasterizer->GetTextureRegistry().RegisterTexture(texture);
+  });
+}
+
+void PlatformView::UnregisterTexture(int64_t texture_id) {
+  blink::Threads::Gpu()->PostTask(
+      [ rasterizer = rasterizer_->GetWeakRasterizerPtr(), texture_id ] {
+        if (rasterizer)
+          rasterizer->GetTextureRegistry().UnregisterTexture(texture_id);
+      });
+}
+
+void PlatformView::MarkTextureFrameAvailable(int64_t texture_id) {
+  blink::Threads::Gpu()->PostTask([
+    rasterizer = rasterizer_->GetWeakRasterizerPtr(), texture_id,
+    engine = engine_->GetWeakPtr()
+  ] {
+    if (!rasterizer)
+      return;
+    std::shared_ptr<flow::Texture> texture =
+        rasterizer->GetTextureRegistry().GetTexture(texture_id);
+    if (!texture)
+      return;
+    texture->MarkNewFrameAvailable();
+    // The framework composites the texture layer again on the next frame.
+    blink::Threads::UI()->PostTask([engine] {
+      if (engine)
+        engine->ScheduleFrame();
+    });
+  });
+}
+
 void PlatformView::NotifyCreated(std::unique_ptr<Surface> surface) {
   NotifyCreated(std::move(surface), []() {});
 }
@@ -122,6 +285,38 @@ void PlatformView::NotifyDestroyed() {
   latch.Wait();
 }
 
+bool PlatformView::NotifySuspended() {
+  fxl::AutoResetWaitableEvent latch;
+  bool suspended = false;
+
+  auto engine_continuation = [this, &suspended, &latch]() {
+    suspended = rasterizer_->Suspend();
+    latch.Signal();
+  };
+
+  blink::Threads::UI()->PostTask([this, engine_continuation]() {
+    engine_->OnOutputSurfaceDestroyed(engine_continuation);
+  });
+
+  latch.Wait();
+  return suspended;
+}
+
+void PlatformView::NotifyResumed(fxl::Closure caller_continuation) {
+  fxl::AutoResetWaitableEvent latch;
+
+  auto engine_continuation = [this, caller_continuation, &latch]() {
+    rasterizer_->Resume(caller_continuation);
+    latch.Signal();
+  };
+
+  blink::Threads::UI()->PostTask([this, engine_continuation]() {
+    engine_->OnOutputSurfaceCreated(engine_continuation);
+  });
+
+  latch.Wait();
+}
+
 std::weak_ptr<PlatformView> PlatformView::GetWeakPtr() {
   return shared_from_this();
 }
@@ -134,6 +329,26 @@ VsyncWaiter* PlatformView::GetVsyncWaiter() {
 
 void PlatformView::UpdateSemantics(std::vector<blink::SemanticsNode> update) {}
 
+void PlatformView::ReportFrameTimings(std::vector<flow::FrameTiming> timings) {}
+
+fxl::TimeDelta PlatformView::GetFrameStatisticsInterval() {
+  return fxl::TimeDelta::FromSeconds(
+      blink::Settings::Get().frame_statistics_interval_seconds);
+}
+
+void PlatformView::ReportFrameStatistics(
+    const flow::FrameStatistics& statistics) {
+  FXL_LOG(INFO) << "Frame statistics: " << statistics.frame_count
+                << " frames in "
+                << (statistics.end - statistics.start).ToMilliseconds()
+                << "ms, " << statistics.janky_build_frame_count
+                << " janky builds, " << statistics.janky_raster_frame_count
+                << " janky rasters, raster cache hit rate "
+                << statistics.GetRasterCacheHitRate()
+                << ", peak GPU resource cache "
+                << statistics.peak_gpu_resource_cache_bytes << " bytes.";
+}
+
 void PlatformView::HandlePlatformMessage(
     fxl::RefPtr<blink::PlatformMessage> message) {
   if (auto response = message->response())
@@ -160,15 +375,6 @@ void PlatformView::SetupResourceContextOnIOThreadPerform(
     return;
   }
 
-  bool current = ResourceContextMakeCurrent();
-
-  if (!current) {
-    FXL_DLOG(WARNING)
-        << "WARNING: Could not setup a context on the resource loader.";
-    latch->Signal();
-    return;
-  }
-
   GrContextOptions options;
   // There is currently a bug with doing GPU YUV to RGB conversions on the IO
   // thread. The necessary work isn't being flushed or synchronized with the
@@ -177,17 +383,34 @@ void PlatformView::SetupResourceContextOnIOThreadPerform(
   options.fDisableGpuYUVConversion = true;
   options.fRequireDecodeDisableForSRGB = false;
 
-  blink::ResourceContext::Set(GrContext::Create(
+  // The resource context lives for the rest of the process.
+  blink::ResourceContext::Set(CreateResourceContext(options).release());
+
+  // By default, do not cache textures created by the image decoder. These
+  // textures should be deleted when they are no longer referenced by an
+  // SkImage.
+  if (blink::ResourceContext::Get()) {
+    const size_t max_bytes =
+        blink::Settings::Get().resource_context_cache_max_bytes;
+    blink::ResourceContext::Get()->setResourceCacheLimits(
+        max_bytes > 0 ? kResourceContextCacheMaxCount : 0, max_bytes);
+  }
+
+  latch->Signal();
+}
+
+sk_sp<GrContext> PlatformView::CreateResourceContext(
+    const GrContextOptions& options) {
+  if (!ResourceContextMakeCurrent()) {
+    FXL_DLOG(WARNING)
+        << "WARNING: Could not setup a context on the resource loader.";
+    return nullptr;
+  }
+
+  return sk_sp<GrContext>(GrContext::Create(
       GrBackend::kOpenGL_GrBackend,
       reinterpret_cast<GrBackendContext>(GrGLCreateNativeInterface()),
       options));
-
-  // Do not cache textures created by the image decoder.  These textures should
-  // be deleted when they are no longer referenced by an SkImage.
-  if (blink::ResourceContext::Get())
-    blink::ResourceContext::Get()->setResourceCacheLimits(0, 0);
-
-  latch->Signal();
 }
 
 }  // namespace shell
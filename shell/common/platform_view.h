@@ -7,6 +7,7 @@
 
 #include <memory>
 
+#include "flutter/flow/texture.h"
 #include "flutter/lib/ui/semantics/semantics_node.h"
 #include "flutter/shell/common/engine.h"
 #include "flutter/shell/common/shell.h"
@@ -17,6 +18,7 @@
 #include "lib/fxl/synchronization/waitable_event.h"
 #include "third_party/skia/include/core/SkSize.h"
 #include "third_party/skia/include/gpu/GrContext.h"
+#include "third_party/skia/include/gpu/GrContextOptions.h"
 
 namespace shell {
 
@@ -43,6 +45,27 @@ class PlatformView : public std::enable_shared_from_this<PlatformView> {
   void DispatchSemanticsAction(int32_t id, blink::SemanticsAction action);
   void SetSemanticsEnabled(bool enabled);
 
+  // Frees cached resources on the GPU and IO threads. The rasterizer's cache
+  // is always cleared. Critical pressure also drops Skia's caches.
+  void NotifyMemoryPressure(MemoryPressureLevel level);
+
+  // Caps the frame rate to the display rate divided by |divisor|, such as
+  // while the device saves battery.
+  void SetFrameRateDivisor(int divisor);
+
+  // Hands |settings| to the engine on the UI thread and to the rasterizer on
+  // the GPU thread. See |Shell::UpdateRuntimeSettings|.
+  void ApplyRuntimeSettings(const blink::RuntimeSettings& settings);
+
+  // Makes |texture| available to |TextureLayer|s. The texture is handed to the
+  // GPU thread and only used there.
+  void RegisterTexture(std::shared_ptr<flow::Texture> texture);
+  void UnregisterTexture(int64_t texture_id);
+
+  // Called by the producer of a registered texture when it has a new frame.
+  // Schedules a frame so that the texture gets composited again.
+  void MarkTextureFrameAvailable(int64_t texture_id);
+
   void NotifyCreated(std::unique_ptr<Surface> surface);
 
   void NotifyCreated(std::unique_ptr<Surface> surface,
@@ -50,6 +73,15 @@ class PlatformView : public std::enable_shared_from_this<PlatformView> {
 
   void NotifyDestroyed();
 
+  // Like |NotifyDestroyed|, but the rasterizer keeps its surface and the GPU
+  // resources cached for it. Returns false if the rasterizer kept nothing, in
+  // which case |NotifyDestroyed| must still be called.
+  bool NotifySuspended();
+
+  // Resumes drawing into the surface kept by |NotifySuspended| once the
+  // platform has bound it to a new window.
+  void NotifyResumed(fxl::Closure continuation);
+
   std::weak_ptr<PlatformView> GetWeakPtr();
 
   // The VsyncWaiter will live at least as long as the PlatformView.
@@ -61,6 +93,20 @@ class PlatformView : public std::enable_shared_from_this<PlatformView> {
   virtual void HandlePlatformMessage(
       fxl::RefPtr<blink::PlatformMessage> message);
 
+  // Called on the platform thread with batches of timing records of presented
+  // frames. The same records are also delivered to Dart.
+  virtual void ReportFrameTimings(std::vector<flow::FrameTiming> timings);
+
+  // The interval over which the statistics of presented frames are
+  // aggregated for |ReportFrameStatistics|. Zero reports none. Defaults to
+  // the frame statistics interval setting.
+  virtual fxl::TimeDelta GetFrameStatisticsInterval();
+
+  // Called on the platform thread with the statistics of the frames presented
+  // in each interval. Neither tracing nor the performance overlay need to be
+  // enabled. Logs a summary by default.
+  virtual void ReportFrameStatistics(const flow::FrameStatistics& statistics);
+
   void SetRasterizer(std::unique_ptr<Rasterizer> rasterizer);
 
   Rasterizer& rasterizer() { return *rasterizer_; }
@@ -75,10 +121,16 @@ class PlatformView : public std::enable_shared_from_this<PlatformView> {
 
   void CreateEngine();
   void PostAddToShellTask();
+  void SetupFrameTimingsCallback();
 
   void SetupResourceContextOnIOThreadPerform(
       fxl::AutoResetWaitableEvent* event);
 
+  // Called on the IO thread. By default, creates an OpenGL context after
+  // making the resource context current.
+  virtual sk_sp<GrContext> CreateResourceContext(
+      const GrContextOptions& options);
+
   SurfaceConfig surface_config_;
   std::unique_ptr<Rasterizer> rasterizer_;
   std::unique_ptr<Engine> engine_;
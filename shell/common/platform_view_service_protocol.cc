@@ -4,17 +4,28 @@
 
 #include "flutter/shell/common/platform_view_service_protocol.h"
 
+#include <stdlib.h>
 #include <string.h>
 
+#include <functional>
+#include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "flutter/common/runtime_settings.h"
 #include "flutter/common/threads.h"
+#include "flutter/flow/image_memory_tracker.h"
+#include "flutter/flow/layer_tree_serialization.h"
+#include "flutter/fml/task_runner.h"
+#include "flutter/lib/ui/painting/resource_context.h"
+#include "flutter/runtime/start_up.h"
+#include "flutter/shell/common/memory_usage.h"
 #include "flutter/shell/common/picture_serializer.h"
 #include "flutter/shell/common/rasterizer.h"
 #include "flutter/shell/common/shell.h"
 #include "lib/fxl/memory/weak_ptr.h"
-#include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/src/utils/SkBase64.h"
 
 namespace shell {
@@ -113,6 +124,74 @@ static void AppendFlutterView(std::stringstream* stream,
   *stream << "}";
 }
 
+// Runs |callback| on the raster cache of every rasterizer on the GPU thread
+// and waits for it.
+static void ForEachRasterCache(
+    const std::function<void(flow::RasterCache&)>& callback) {
+  fxl::AutoResetWaitableEvent latch;
+  blink::Threads::Gpu()->PostTask([&latch, &callback]() {
+    std::vector<fxl::WeakPtr<Rasterizer>> rasterizers;
+    Shell::Shared().GetRasterizers(&rasterizers);
+    for (const auto& rasterizer : rasterizers) {
+      if (!rasterizer) {
+        continue;
+      }
+      flow::RasterCache* cache = rasterizer->GetRasterCache();
+      if (cache != nullptr) {
+        callback(*cache);
+      }
+    }
+    latch.Signal();
+  });
+  latch.Wait();
+}
+
+static const char* GetRasterCacheKindName(flow::RasterCacheKey::Kind kind) {
+  switch (kind) {
+    case flow::RasterCacheKey::Kind::kPicture:
+      return "picture";
+    case flow::RasterCacheKey::Kind::kLayer:
+      return "layer";
+  }
+  return "unknown";
+}
+
+static bool ParseSize(const char* value, size_t* result) {
+  if (value == NULL || *value == '\0' || *value == '-') {
+    return false;
+  }
+  char* end = NULL;
+  const unsigned long long parsed = strtoull(value, &end, 10);
+  if (*end != '\0') {
+    return false;
+  }
+  *result = static_cast<size_t>(parsed);
+  return true;
+}
+
+static bool ParseBool(const char* value, bool* result) {
+  if (value == NULL) {
+    return false;
+  }
+  if (strcmp(value, "true") == 0) {
+    *result = true;
+    return true;
+  }
+  if (strcmp(value, "false") == 0) {
+    *result = false;
+    return true;
+  }
+  return false;
+}
+
+static const char* RuntimeSettingsResponse(
+    const blink::RuntimeSettings& settings) {
+  std::stringstream response;
+  response << "{\"type\":\"RuntimeSettings\",\"settings\":"
+           << settings.ToJSON() << "}";
+  return strdup(response.str().c_str());
+}
+
 }  // namespace
 
 void PlatformViewServiceProtocol::RegisterHook(bool running_precompiled_code) {
@@ -122,6 +201,42 @@ void PlatformViewServiceProtocol::RegisterHook(bool running_precompiled_code) {
   // Screenshot.
   Dart_RegisterRootServiceRequestCallback(kScreenshotExtensionName, &Screenshot,
                                           nullptr);
+  // Layer tree capture for offline replay.
+  Dart_RegisterRootServiceRequestCallback(kCaptureLayerTreeExtensionName,
+                                          &CaptureLayerTree, nullptr);
+  // Per layer paint times.
+  Dart_RegisterRootServiceRequestCallback(kProfileLayersExtensionName,
+                                          &ProfileLayers, nullptr);
+  // Task latency histograms. Also available in release mode to diagnose jank
+  // in the field.
+  Dart_RegisterRootServiceRequestCallback(kGetTaskLatenciesExtensionName,
+                                          &GetTaskLatencies, nullptr);
+  // Bytes held by native images. Also available in release mode so that
+  // memory budgets can be checked on production builds.
+  Dart_RegisterRootServiceRequestCallback(kGetImageMemoryUsageExtensionName,
+                                          &GetImageMemoryUsage, nullptr);
+  // Native memory of each subsystem, for the same reason.
+  Dart_RegisterRootServiceRequestCallback(kGetMemoryUsageExtensionName,
+                                          &GetMemoryUsage, nullptr);
+  // Raster cache inspection and tuning. Also available in release mode, where
+  // the thresholds that matter are measured.
+  Dart_RegisterRootServiceRequestCallback(kGetRasterCacheEntriesExtensionName,
+                                          &GetRasterCacheEntries, nullptr);
+  Dart_RegisterRootServiceRequestCallback(kGetRasterCacheStatsExtensionName,
+                                          &GetRasterCacheStats, nullptr);
+  Dart_RegisterRootServiceRequestCallback(kConfigureRasterCacheExtensionName,
+                                          &ConfigureRasterCache, nullptr);
+  Dart_RegisterRootServiceRequestCallback(kClearRasterCacheExtensionName,
+                                          &ClearRasterCache, nullptr);
+  // Tuning without a restart, for the same reason.
+  Dart_RegisterRootServiceRequestCallback(kGetRuntimeSettingsExtensionName,
+                                          &GetRuntimeSettings, nullptr);
+  Dart_RegisterRootServiceRequestCallback(kSetRuntimeSettingsExtensionName,
+                                          &SetRuntimeSettings, nullptr);
+  // Startup phases. Also available in release mode, where cold start is
+  // measured.
+  Dart_RegisterRootServiceRequestCallback(kGetStartupTimelineExtensionName,
+                                          &GetStartupTimeline, nullptr);
   // The following set of service protocol extensions require debug build
   if (running_precompiled_code) {
     return;
@@ -260,14 +375,27 @@ bool PlatformViewServiceProtocol::Screenshot(const char* method,
                                              void* user_data,
                                              const char** json_object) {
   fxl::AutoResetWaitableEvent latch;
-  SkBitmap bitmap;
-  blink::Threads::Gpu()->PostTask([&latch, &bitmap]() {
-    ScreenshotGpuTask(&bitmap);
+  sk_sp<SkPicture> picture;
+  blink::Threads::Gpu()->PostTask([&latch, &picture]() {
+    picture = ScreenshotGpuTask();
     latch.Signal();
   });
 
   latch.Wait();
 
+  // The GPU thread only records the frame. Rasterizing and encoding it, which
+  // take far longer, happen here on the service isolate's thread so that
+  // capturing does not delay frames.
+  SkBitmap bitmap;
+  if (picture) {
+    const SkIRect bounds = picture->cullRect().roundOut();
+    if (bitmap.tryAllocN32Pixels(bounds.width(), bounds.height())) {
+      SkCanvas canvas(bitmap);
+      canvas.clear(SK_ColorBLACK);
+      canvas.drawPicture(picture);
+    }
+  }
+
   sk_sp<SkData> png(EncodeBitmapAsPNG(bitmap));
 
   if (!png)
@@ -285,35 +413,455 @@ bool PlatformViewServiceProtocol::Screenshot(const char* method,
   return true;
 }
 
-void PlatformViewServiceProtocol::ScreenshotGpuTask(SkBitmap* bitmap) {
+sk_sp<SkPicture> PlatformViewServiceProtocol::ScreenshotGpuTask() {
   std::vector<fxl::WeakPtr<Rasterizer>> rasterizers;
   Shell::Shared().GetRasterizers(&rasterizers);
   if (rasterizers.size() != 1)
-    return;
+    return nullptr;
 
   Rasterizer* rasterizer = rasterizers[0].get();
   if (rasterizer == nullptr)
-    return;
+    return nullptr;
+
+  return rasterizer->RecordLastLayerTree();
+}
+
+const char* PlatformViewServiceProtocol::kCaptureLayerTreeExtensionName =
+    "_flutter.captureLayerTree";
+
+bool PlatformViewServiceProtocol::CaptureLayerTree(const char* method,
+                                                   const char** param_keys,
+                                                   const char** param_values,
+                                                   intptr_t num_params,
+                                                   void* user_data,
+                                                   const char** json_object) {
+  fxl::AutoResetWaitableEvent latch;
+  sk_sp<SkData> data;
+  blink::Threads::Gpu()->PostTask([&latch, &data]() {
+    data = CaptureLayerTreeGpuTask();
+    latch.Signal();
+  });
+
+  latch.Wait();
+
+  if (!data)
+    return ErrorServer(json_object, "no layer tree to capture");
+
+  size_t b64_size = SkBase64::Encode(data->data(), data->size(), nullptr);
+  SkAutoTMalloc<char> b64_data(b64_size);
+  SkBase64::Encode(data->data(), data->size(), b64_data.get());
+
+  std::stringstream response;
+  response << "{\"type\":\"LayerTree\","
+           << "\"layerTree\":\"" << std::string{b64_data.get(), b64_size}
+           << "\"}";
+  *json_object = strdup(response.str().c_str());
+  return true;
+}
+
+sk_sp<SkData> PlatformViewServiceProtocol::CaptureLayerTreeGpuTask() {
+  std::vector<fxl::WeakPtr<Rasterizer>> rasterizers;
+  Shell::Shared().GetRasterizers(&rasterizers);
+  if (rasterizers.size() != 1)
+    return nullptr;
+
+  Rasterizer* rasterizer = rasterizers[0].get();
+  if (rasterizer == nullptr)
+    return nullptr;
 
   flow::LayerTree* layer_tree = rasterizer->GetLastLayerTree();
   if (layer_tree == nullptr)
-    return;
+    return nullptr;
 
-  const SkISize& frame_size = layer_tree->frame_size();
-  if (!bitmap->tryAllocN32Pixels(frame_size.width(), frame_size.height()))
-    return;
+  // Images in pictures are encoded as PNGs, as they would be in an SKP.
+  PngPixelSerializer serializer;
+  return flow::SerializeLayerTree(*layer_tree, &serializer);
+}
 
-  sk_sp<SkSurface> surface = SkSurface::MakeRasterDirect(
-      bitmap->info(), bitmap->getPixels(), bitmap->rowBytes());
+const char* PlatformViewServiceProtocol::kProfileLayersExtensionName =
+    "_flutter.profileLayers";
+
+bool PlatformViewServiceProtocol::ProfileLayers(const char* method,
+                                                const char** param_keys,
+                                                const char** param_values,
+                                                intptr_t num_params,
+                                                void* user_data,
+                                                const char** json_object) {
+  const char* synchronize_param =
+      ValueForKey(param_keys, param_values, num_params, "synchronize");
+  const char* count_param =
+      ValueForKey(param_keys, param_values, num_params, "count");
+  const bool synchronize =
+      synchronize_param != NULL && strcmp(synchronize_param, "true") == 0;
+  size_t count = 10;
+  if (count_param != NULL) {
+    char* end = NULL;
+    count = strtoul(count_param, &end, 10);
+    if (end == count_param || *end != '\0') {
+      return ErrorBadParameter(json_object, "count", count_param);
+    }
+  }
 
-  flow::CompositorContext compositor_context(nullptr);
-  SkCanvas* canvas = surface->getCanvas();
-  flow::CompositorContext::ScopedFrame frame =
-      compositor_context.AcquireFrame(nullptr, canvas, false);
+  fxl::AutoResetWaitableEvent latch;
+  std::vector<flow::LayerProfiler::Entry> entries;
+  blink::Threads::Gpu()->PostTask([&latch, &entries, synchronize, count]() {
+    std::vector<fxl::WeakPtr<Rasterizer>> rasterizers;
+    Shell::Shared().GetRasterizers(&rasterizers);
+    if (rasterizers.size() == 1 && rasterizers[0]) {
+      entries = rasterizers[0]->ProfileLastLayerTree(synchronize, count);
+    }
+    latch.Signal();
+  });
+
+  latch.Wait();
+
+  std::stringstream response;
+  response << "{\"type\":\"LayerProfile\",\"synchronized\":"
+           << (synchronize ? "true" : "false") << ",\"layers\":[";
+  for (size_t i = 0; i < entries.size(); i++) {
+    const flow::LayerProfiler::Entry& entry = entries[i];
+    const SkRect& bounds = entry.paint_bounds;
+    response << (i == 0 ? "" : ",") << "{\"type\":\"" << entry.type_name
+             << "\",\"paintBounds\":[" << bounds.left() << ","
+             << bounds.top() << "," << bounds.right() << "," << bounds.bottom()
+             << "],\"selfMicros\":" << entry.self_time.ToMicroseconds()
+             << ",\"totalMicros\":" << entry.total_time.ToMicroseconds()
+             << ",\"opCount\":" << entry.op_count << "}";
+  }
+  response << "]}";
+  *json_object = strdup(response.str().c_str());
+  return true;
+}
+
+const char* PlatformViewServiceProtocol::kGetTaskLatenciesExtensionName =
+    "_flutter.getTaskLatencies";
 
-  canvas->clear(SK_ColorBLACK);
-  layer_tree->Raster(frame);
-  canvas->flush();
+static void AppendCounts(std::stringstream* stream,
+                         const fml::LatencyHistogram::Counts& counts) {
+  *stream << "[";
+  for (size_t i = 0; i < counts.size(); i++) {
+    *stream << (i == 0 ? "" : ",") << counts[i];
+  }
+  *stream << "]";
+}
+
+bool PlatformViewServiceProtocol::GetTaskLatencies(const char* method,
+                                                   const char** param_keys,
+                                                   const char** param_values,
+                                                   intptr_t num_params,
+                                                   void* user_data,
+                                                   const char** json_object) {
+  // Runners supplied by the embedder keep no histograms and are left out.
+  const auto& threads = Shell::Shared().GetMessageLoopTaskRunners();
+
+  std::stringstream response;
+  response << "{\"type\":\"TaskLatencies\",\"bucketLimitsMicros\":[";
+  // The last bucket is unbounded.
+  for (size_t i = 0; i < fml::LatencyHistogram::kBucketCount - 1; i++) {
+    response << (i == 0 ? "" : ",")
+             << fml::LatencyHistogram::GetBucketLimitMicros(i);
+  }
+  response << "],\"threads\":[";
+  bool prefix_comma = false;
+  for (const auto& thread : threads) {
+    auto* runner = static_cast<fml::TaskRunner*>(thread.second.get());
+    if (prefix_comma) {
+      response << ",";
+    } else {
+      prefix_comma = true;
+    }
+    response << "{\"name\":\"" << thread.first << "\",\"queueDelays\":";
+    AppendCounts(&response, runner->GetTaskQueueDelays().GetCounts());
+    response << ",\"durations\":";
+    AppendCounts(&response, runner->GetTaskDurations().GetCounts());
+    response << "}";
+  }
+  response << "]}";
+  *json_object = strdup(response.str().c_str());
+  return true;
+}
+
+const char* PlatformViewServiceProtocol::kGetImageMemoryUsageExtensionName =
+    "_flutter.getImageMemoryUsage";
+
+bool PlatformViewServiceProtocol::GetImageMemoryUsage(
+    const char* method,
+    const char** param_keys,
+    const char** param_values,
+    intptr_t num_params,
+    void* user_data,
+    const char** json_object) {
+  using Category = flow::ImageMemoryTracker::Category;
+  const auto& tracker = flow::ImageMemoryTracker::Get();
+
+  std::stringstream response;
+  response << "{\"type\":\"ImageMemoryUsage\"";
+  response << ",\"imageCount\":" << tracker.GetImageCount();
+  response << ",\"decodedBytes\":" << tracker.GetBytes(Category::kDecoded);
+  response << ",\"gpuResidentBytes\":"
+           << tracker.GetBytes(Category::kGPUResident);
+  response << ",\"rasterCacheBytes\":"
+           << tracker.GetBytes(Category::kRasterCache);
+  response << ",\"totalBytes\":" << tracker.GetTotalBytes() << "}";
+  *json_object = strdup(response.str().c_str());
+  return true;
+}
+
+const char* PlatformViewServiceProtocol::kGetMemoryUsageExtensionName =
+    "_flutter.getMemoryUsage";
+
+bool PlatformViewServiceProtocol::GetMemoryUsage(const char* method,
+                                                 const char** param_keys,
+                                                 const char** param_values,
+                                                 intptr_t num_params,
+                                                 void* user_data,
+                                                 const char** json_object) {
+  MemoryUsage usage;
+  shell::GetMemoryUsage(&usage);
+
+  // Resource caches can only be read on the threads of their contexts.
+  fxl::AutoResetWaitableEvent latch;
+  blink::Threads::Gpu()->PostTask([&latch, &usage]() {
+    std::vector<fxl::WeakPtr<Rasterizer>> rasterizers;
+    Shell::Shared().GetRasterizers(&rasterizers);
+    for (const auto& rasterizer : rasterizers) {
+      if (rasterizer) {
+        usage.gpu_resource_cache_bytes +=
+            GetResourceCacheBytes(rasterizer->GetGrContext());
+      }
+    }
+    latch.Signal();
+  });
+  latch.Wait();
+
+  blink::Threads::IO()->PostTask([&latch, &usage]() {
+    usage.io_resource_cache_bytes =
+        GetResourceCacheBytes(blink::ResourceContext::Get());
+    latch.Signal();
+  });
+  latch.Wait();
+
+  std::stringstream response;
+  response << "{\"type\":\"MemoryUsage\",\"subsystems\":";
+  AppendMemoryUsageJSON(&response, usage);
+  response << "}";
+  *json_object = strdup(response.str().c_str());
+  return true;
+}
+
+const char* PlatformViewServiceProtocol::kGetRasterCacheEntriesExtensionName =
+    "_flutter.rasterCache.getEntries";
+
+bool PlatformViewServiceProtocol::GetRasterCacheEntries(
+    const char* method,
+    const char** param_keys,
+    const char** param_values,
+    intptr_t num_params,
+    void* user_data,
+    const char** json_object) {
+  std::stringstream response;
+  response << "{\"type\":\"RasterCacheEntries\",\"entries\":[";
+  bool first = true;
+  ForEachRasterCache([&response, &first](flow::RasterCache& cache) {
+    for (const auto& entry : cache.GetEntries()) {
+      if (!first)
+        response << ",";
+      first = false;
+      response << "{\"kind\":\"" << GetRasterCacheKindName(entry.kind)
+               << "\"";
+      response << ",\"id\":" << entry.id;
+      response << ",\"scaleX\":" << entry.scale_key.width() / 1e3;
+      response << ",\"scaleY\":" << entry.scale_key.height() / 1e3;
+      response << ",\"width\":" << entry.image_size.width();
+      response << ",\"height\":" << entry.image_size.height();
+      response << ",\"bytes\":" << entry.byte_size;
+      response << ",\"accessCount\":" << entry.access_count;
+      response << ",\"ageFrames\":" << entry.age;
+      response << ",\"pending\":" << (entry.pending ? "true" : "false");
+      response << "}";
+    }
+  });
+  response << "]}";
+  *json_object = strdup(response.str().c_str());
+  return true;
+}
+
+const char* PlatformViewServiceProtocol::kGetRasterCacheStatsExtensionName =
+    "_flutter.rasterCache.getStats";
+
+bool PlatformViewServiceProtocol::GetRasterCacheStats(
+    const char* method,
+    const char** param_keys,
+    const char** param_values,
+    intptr_t num_params,
+    void* user_data,
+    const char** json_object) {
+  std::stringstream response;
+  response << "{\"type\":\"RasterCacheStats\",\"caches\":[";
+  bool first = true;
+  ForEachRasterCache([&response, &first](flow::RasterCache& cache) {
+    if (!first)
+      response << ",";
+    first = false;
+    response << "{\"hits\":" << cache.total_hit_count();
+    response << ",\"misses\":" << cache.total_miss_count();
+    response << ",\"entries\":" << cache.entry_count();
+    response << ",\"pendingEntries\":" << cache.pending_entry_count();
+    response << ",\"residentBytes\":" << cache.resident_bytes();
+    response << ",\"maxBytes\":" << cache.max_bytes();
+    response << ",\"threshold\":" << cache.threshold() << "}";
+  });
+  response << "]}";
+  *json_object = strdup(response.str().c_str());
+  return true;
+}
+
+const char* PlatformViewServiceProtocol::kConfigureRasterCacheExtensionName =
+    "_flutter.rasterCache.configure";
+
+bool PlatformViewServiceProtocol::ConfigureRasterCache(
+    const char* method,
+    const char** param_keys,
+    const char** param_values,
+    intptr_t num_params,
+    void* user_data,
+    const char** json_object) {
+  const char* threshold_value =
+      ValueForKey(param_keys, param_values, num_params, "threshold");
+  const char* max_bytes_value =
+      ValueForKey(param_keys, param_values, num_params, "maxBytes");
+
+  size_t threshold = 0;
+  if (threshold_value != NULL && !ParseSize(threshold_value, &threshold)) {
+    return ErrorBadParameter(json_object, "threshold", threshold_value);
+  }
+  size_t max_bytes = 0;
+  if (max_bytes_value != NULL && !ParseSize(max_bytes_value, &max_bytes)) {
+    return ErrorBadParameter(json_object, "maxBytes", max_bytes_value);
+  }
+
+  // Rasterizers created later start out with the new configuration too.
+  blink::RuntimeSettings settings = blink::RuntimeSettings::Get();
+  if (threshold_value != NULL)
+    settings.raster_cache_threshold = threshold;
+  if (max_bytes_value != NULL)
+    settings.raster_cache_max_bytes = max_bytes;
+  blink::RuntimeSettings::Set(settings);
+
+  ForEachRasterCache([&](flow::RasterCache& cache) {
+    if (threshold_value != NULL)
+      cache.SetThreshold(threshold);
+    if (max_bytes_value != NULL)
+      cache.SetMaxBytes(max_bytes);
+  });
+  *json_object = strdup("{\"type\":\"Success\"}");
+  return true;
+}
+
+const char* PlatformViewServiceProtocol::kClearRasterCacheExtensionName =
+    "_flutter.rasterCache.clear";
+
+bool PlatformViewServiceProtocol::ClearRasterCache(const char* method,
+                                                   const char** param_keys,
+                                                   const char** param_values,
+                                                   intptr_t num_params,
+                                                   void* user_data,
+                                                   const char** json_object) {
+  ForEachRasterCache([](flow::RasterCache& cache) { cache.Clear(); });
+  *json_object = strdup("{\"type\":\"Success\"}");
+  return true;
+}
+
+const char* PlatformViewServiceProtocol::kGetRuntimeSettingsExtensionName =
+    "_flutter.getRuntimeSettings";
+
+bool PlatformViewServiceProtocol::GetRuntimeSettings(const char* method,
+                                                     const char** param_keys,
+                                                     const char** param_values,
+                                                     intptr_t num_params,
+                                                     void* user_data,
+                                                     const char** json_object) {
+  *json_object = RuntimeSettingsResponse(blink::RuntimeSettings::Get());
+  return true;
+}
+
+const char* PlatformViewServiceProtocol::kSetRuntimeSettingsExtensionName =
+    "_flutter.setRuntimeSettings";
+
+bool PlatformViewServiceProtocol::SetRuntimeSettings(const char* method,
+                                                     const char** param_keys,
+                                                     const char** param_values,
+                                                     intptr_t num_params,
+                                                     void* user_data,
+                                                     const char** json_object) {
+  blink::RuntimeSettings settings = blink::RuntimeSettings::Get();
+  const struct {
+    const char* name;
+    size_t* value;
+  } sizes[] = {
+      {"rasterCacheThreshold", &settings.raster_cache_threshold},
+      {"rasterCacheMaxBytes", &settings.raster_cache_max_bytes},
+      {"gpuResourceCacheMaxBytes", &settings.gpu_resource_cache_max_bytes},
+  };
+  for (const auto& size : sizes) {
+    const char* value =
+        ValueForKey(param_keys, param_values, num_params, size.name);
+    if (value != NULL && !ParseSize(value, size.value)) {
+      return ErrorBadParameter(json_object, size.name, value);
+    }
+  }
+  const struct {
+    const char* name;
+    bool* value;
+  } bools[] = {
+      {"layerTreeDiffing", &settings.enable_layer_tree_diffing},
+      {"throttleIdleFrames", &settings.throttle_idle_frames},
+  };
+  for (const auto& flag : bools) {
+    const char* value =
+        ValueForKey(param_keys, param_values, num_params, flag.name);
+    if (value != NULL && !ParseBool(value, flag.value)) {
+      return ErrorBadParameter(json_object, flag.name, value);
+    }
+  }
+
+  Shell::Shared().UpdateRuntimeSettings(settings);
+
+  // The rasterizers apply the settings in tasks posted before this one.
+  fxl::AutoResetWaitableEvent latch;
+  blink::Threads::Gpu()->PostTask([&latch]() { latch.Signal(); });
+  latch.Wait();
+  *json_object = RuntimeSettingsResponse(settings);
+  return true;
+}
+
+const char* PlatformViewServiceProtocol::kGetStartupTimelineExtensionName =
+    "_flutter.getStartupTimeline";
+
+bool PlatformViewServiceProtocol::GetStartupTimeline(
+    const char* method,
+    const char** param_keys,
+    const char** param_values,
+    intptr_t num_params,
+    void* user_data,
+    const char** json_object) {
+  std::stringstream response;
+  response << "{\"type\":\"StartupTimeline\"";
+  response << ",\"engineMainEnter\":" << blink::engine_main_enter_ts;
+  response << ",\"phases\":[";
+  for (size_t i = 0; i < static_cast<size_t>(blink::StartupPhase::kCount);
+       ++i) {
+    auto phase = static_cast<blink::StartupPhase>(i);
+    blink::StartupPhaseTiming timing = blink::GetStartupPhaseTiming(phase);
+    if (i > 0)
+      response << ",";
+    response << "{\"name\":\"" << blink::GetStartupPhaseName(phase) << "\"";
+    response << ",\"start\":" << timing.start;
+    response << ",\"end\":" << timing.end << "}";
+  }
+  response << "]}";
+  *json_object = strdup(response.str().c_str());
+  return true;
 }
 
 const char* PlatformViewServiceProtocol::kFlushUIThreadTasksExtensionName =
@@ -11,6 +11,7 @@
 #include "lib/fxl/synchronization/waitable_event.h"
 #include "third_party/dart/runtime/include/dart_tools_api.h"
 #include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkPicture.h"
 
 namespace shell {
 
@@ -39,14 +40,144 @@ class PlatformViewServiceProtocol {
 
   static const char* kScreenshotExtensionName;
   // It should be invoked from the VM Service and and blocks it until previous
-  // GPU thread tasks are processed.
+  // GPU thread tasks are processed. The GPU thread only records the frame,
+  // which is rasterized and encoded on the VM Service's thread.
   static bool Screenshot(const char* method,
                          const char** param_keys,
                          const char** param_values,
                          intptr_t num_params,
                          void* user_data,
                          const char** json_object);
-  static void ScreenshotGpuTask(SkBitmap* bitmap);
+  static sk_sp<SkPicture> ScreenshotGpuTask();
+
+  static const char* kCaptureLayerTreeExtensionName;
+  // Serializes the last rasterized layer tree, with its pictures, so that it
+  // can be replayed offline by the flow benchmarks. Blocks the VM Service
+  // until previous GPU thread tasks are processed.
+  static bool CaptureLayerTree(const char* method,
+                               const char** param_keys,
+                               const char** param_values,
+                               intptr_t num_params,
+                               void* user_data,
+                               const char** json_object);
+  static sk_sp<SkData> CaptureLayerTreeGpuTask();
+
+  static const char* kProfileLayersExtensionName;
+  // Paints the last frame again offscreen and reports the layers that took
+  // the longest to paint. Accepts "synchronize" ("true" to wait on the GPU
+  // around each layer) and "count" (defaults to 10). Blocks the VM Service
+  // until previous GPU thread tasks are processed.
+  static bool ProfileLayers(const char* method,
+                            const char** param_keys,
+                            const char** param_values,
+                            intptr_t num_params,
+                            void* user_data,
+                            const char** json_object);
+
+  static const char* kGetTaskLatenciesExtensionName;
+  // Reports the task queue delay and task duration histograms of the
+  // platform, GPU, UI and IO threads. Does not wait on any of the threads.
+  static bool GetTaskLatencies(const char* method,
+                               const char** param_keys,
+                               const char** param_values,
+                               intptr_t num_params,
+                               void* user_data,
+                               const char** json_object);
+
+  static const char* kGetImageMemoryUsageExtensionName;
+  // Reports the bytes held by decoded, GPU resident and raster cached images
+  // across the engine. Does not wait on any of the threads.
+  static bool GetImageMemoryUsage(const char* method,
+                                  const char** param_keys,
+                                  const char** param_values,
+                                  intptr_t num_params,
+                                  void* user_data,
+                                  const char** json_object);
+
+  static const char* kGetMemoryUsageExtensionName;
+  // Reports the native memory held by each subsystem of the engine. Blocks the
+  // VM Service until previous GPU and IO thread tasks are processed.
+  static bool GetMemoryUsage(const char* method,
+                             const char** param_keys,
+                             const char** param_values,
+                             intptr_t num_params,
+                             void* user_data,
+                             const char** json_object);
+
+  static const char* kGetRasterCacheEntriesExtensionName;
+  // Lists the entries of the raster cache of each view. Blocks the VM Service
+  // until previous GPU thread tasks are processed.
+  static bool GetRasterCacheEntries(const char* method,
+                                    const char** param_keys,
+                                    const char** param_values,
+                                    intptr_t num_params,
+                                    void* user_data,
+                                    const char** json_object);
+
+  static const char* kGetRasterCacheStatsExtensionName;
+  // Reports the hits, misses, size and configuration of the raster cache of
+  // each view. Blocks the VM Service until previous GPU thread tasks are
+  // processed.
+  static bool GetRasterCacheStats(const char* method,
+                                  const char** param_keys,
+                                  const char** param_values,
+                                  intptr_t num_params,
+                                  void* user_data,
+                                  const char** json_object);
+
+  static const char* kConfigureRasterCacheExtensionName;
+  // Sets the access threshold and the byte budget of every raster cache from
+  // the optional "threshold" and "maxBytes" parameters. Blocks the VM Service
+  // until previous GPU thread tasks are processed.
+  static bool ConfigureRasterCache(const char* method,
+                                   const char** param_keys,
+                                   const char** param_values,
+                                   intptr_t num_params,
+                                   void* user_data,
+                                   const char** json_object);
+
+  static const char* kClearRasterCacheExtensionName;
+  // Drops every entry of every raster cache. Blocks the VM Service until
+  // previous GPU thread tasks are processed.
+  static bool ClearRasterCache(const char* method,
+                               const char** param_keys,
+                               const char** param_values,
+                               intptr_t num_params,
+                               void* user_data,
+                               const char** json_object);
+
+  static const char* kGetRuntimeSettingsExtensionName;
+  // Reports the settings that may be changed while the engine runs. Does not
+  // wait on any of the threads.
+  static bool GetRuntimeSettings(const char* method,
+                                 const char** param_keys,
+                                 const char** param_values,
+                                 intptr_t num_params,
+                                 void* user_data,
+                                 const char** json_object);
+
+  static const char* kSetRuntimeSettingsExtensionName;
+  // Updates the runtime settings named by the optional parameters and applies
+  // them to every view, reporting the settings in effect. Takes the names of
+  // |blink::RuntimeSettings::ToJSON|. Blocks the VM Service until previous GPU
+  // thread tasks are processed, but not the UI thread.
+  static bool SetRuntimeSettings(const char* method,
+                                 const char** param_keys,
+                                 const char** param_values,
+                                 intptr_t num_params,
+                                 void* user_data,
+                                 const char** json_object);
+
+  static const char* kGetStartupTimelineExtensionName;
+  // Reports when the engine was entered and when each startup phase began and
+  // ended, up to the first frame on screen. Does not wait on any of the
+  // threads.
+  static bool GetStartupTimeline(const char* method,
+                                 const char** param_keys,
+                                 const char** param_values,
+                                 intptr_t num_params,
+                                 void* user_data,
+                                 const char** json_object);
 
   // This API should not be invoked by production code.
   // It can potentially starve the service isolate if the main isolate pauses
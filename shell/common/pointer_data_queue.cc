@@ -0,0 +1,128 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/pointer_data_queue.h"
+
+#include <string.h>
+
+#include <map>
+
+namespace shell {
+namespace {
+
+using blink::PointerData;
+
+bool CanWait(const PointerData& data) {
+  return data.change == PointerData::Change::kMove ||
+         data.change == PointerData::Change::kHover;
+}
+
+std::unique_ptr<blink::PointerDataPacket> ToPacket(
+    const std::vector<PointerData>& events) {
+  auto packet = std::make_unique<blink::PointerDataPacket>(events.size());
+  for (size_t i = 0; i < events.size(); i++) {
+    packet->SetPointerData(i, events[i]);
+  }
+  return packet;
+}
+
+// Interpolates the position of the device at |time| from |samples|, which are
+// ordered by time. Does not extrapolate past the first and last sample.
+PointerData Resample(const std::vector<const PointerData*>& samples,
+                     int64_t time) {
+  const PointerData* before = nullptr;
+  const PointerData* after = nullptr;
+  for (const PointerData* sample : samples) {
+    if (sample->time_stamp <= time) {
+      before = sample;
+    } else {
+      after = sample;
+      break;
+    }
+  }
+
+  if (before == nullptr) {
+    return *samples.front();
+  }
+  if (after == nullptr || after->time_stamp == before->time_stamp) {
+    return *before;
+  }
+
+  const double t = static_cast<double>(time - before->time_stamp) /
+                   (after->time_stamp - before->time_stamp);
+  PointerData result = *after;
+  result.time_stamp = time;
+  result.physical_x =
+      before->physical_x + (after->physical_x - before->physical_x) * t;
+  result.physical_y =
+      before->physical_y + (after->physical_y - before->physical_y) * t;
+  return result;
+}
+
+}  // namespace
+
+PointerDataQueue::PointerDataQueue() = default;
+
+PointerDataQueue::~PointerDataQueue() = default;
+
+bool PointerDataQueue::Enqueue(const blink::PointerDataPacket& packet) {
+  const auto& data = packet.data();
+  const size_t count = data.size() / sizeof(PointerData);
+  bool needs_flush = false;
+  for (size_t i = 0; i < count; i++) {
+    PointerData event;
+    memcpy(&event, &data[i * sizeof(PointerData)], sizeof(PointerData));
+    needs_flush |= !CanWait(event);
+    events_.push_back(event);
+  }
+  return needs_flush;
+}
+
+std::unique_ptr<blink::PointerDataPacket> PointerDataQueue::TakeEvents() {
+  if (events_.empty()) {
+    return nullptr;
+  }
+  auto packet = ToPacket(events_);
+  events_.clear();
+  return packet;
+}
+
+std::unique_ptr<blink::PointerDataPacket>
+PointerDataQueue::TakeResampledEvents(fxl::TimePoint sample_time) {
+  if (events_.empty()) {
+    return nullptr;
+  }
+
+  // Devices with only moves or only hovers queued are resampled.
+  struct DeviceSamples {
+    std::vector<const PointerData*> samples;
+    bool resamplable = true;
+  };
+  std::map<int64_t, DeviceSamples> devices;
+  for (const auto& event : events_) {
+    auto& device = devices[event.device];
+    device.resamplable =
+        device.resamplable && CanWait(event) &&
+        (device.samples.empty() ||
+         device.samples.front()->change == event.change);
+    device.samples.push_back(&event);
+  }
+
+  const int64_t time = (sample_time - fxl::TimePoint()).ToMicroseconds();
+  std::vector<PointerData> result;
+  for (const auto& event : events_) {
+    const auto& device = devices[event.device];
+    if (!device.resamplable) {
+      result.push_back(event);
+    } else if (&event == device.samples.back()) {
+      // Emit the resampled event in place of the last sample of the device.
+      result.push_back(Resample(device.samples, time));
+    }
+  }
+
+  events_.clear();
+  return ToPacket(result);
+}
+
+}  // namespace shell
@@ -0,0 +1,52 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_POINTER_DATA_QUEUE_H_
+#define FLUTTER_SHELL_COMMON_POINTER_DATA_QUEUE_H_
+
+#include <memory>
+#include <vector>
+
+#include "flutter/lib/ui/window/pointer_data.h"
+#include "flutter/lib/ui/window/pointer_data_packet.h"
+#include "lib/fxl/macros.h"
+#include "lib/fxl/time/time_point.h"
+
+namespace shell {
+
+// Collects the pointer events that arrive between two frames so that they
+// can be handed to Dart in a single packet at the start of the next frame.
+// Events other than moves and hovers cannot wait and should be flushed as soon
+// as they are enqueued.
+class PointerDataQueue {
+ public:
+  PointerDataQueue();
+
+  ~PointerDataQueue();
+
+  // Returns true if |packet| contains an event that must be dispatched right
+  // away.
+  bool Enqueue(const blink::PointerDataPacket& packet);
+
+  bool empty() const { return events_.empty(); }
+
+  // Returns all queued events in order or nullptr if there are none.
+  std::unique_ptr<blink::PointerDataPacket> TakeEvents();
+
+  // Like |TakeEvents| but replaces the moves and hovers of each device that
+  // has no other queued events with a single event whose position is
+  // resampled at |sample_time| from the samples around it. Assumes event time
+  // stamps are based on the same monotonic clock as |fxl::TimePoint|.
+  std::unique_ptr<blink::PointerDataPacket> TakeResampledEvents(
+      fxl::TimePoint sample_time);
+
+ private:
+  std::vector<blink::PointerData> events_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(PointerDataQueue);
+};
+
+}  // namespace shell
+
+#endif  // FLUTTER_SHELL_COMMON_POINTER_DATA_QUEUE_H_
@@ -4,8 +4,60 @@
 
 #include "flutter/shell/common/rasterizer.h"
 
+#include "flutter/flow/compositor_context.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+
 namespace shell {
 
 Rasterizer::~Rasterizer() = default;
 
+bool Rasterizer::Suspend() {
+  return false;
+}
+
+void Rasterizer::Resume(fxl::Closure rasterizer_continuation) {
+  rasterizer_continuation();
+}
+
+sk_sp<SkPicture> Rasterizer::RecordLastLayerTree() {
+  flow::LayerTree* layer_tree = GetLastLayerTree();
+  if (layer_tree == nullptr)
+    return nullptr;
+
+  SkPictureRecorder recorder;
+  recorder.beginRecording(SkRect::MakeWH(layer_tree->frame_size().width(),
+                                         layer_tree->frame_size().height()));
+
+  flow::CompositorContext compositor_context(nullptr);
+  flow::CompositorContext::ScopedFrame frame = compositor_context.AcquireFrame(
+      nullptr, recorder.getRecordingCanvas(), false);
+  layer_tree->Raster(frame);
+
+  return recorder.finishRecordingAsPicture();
+}
+
+void Rasterizer::SetFramePresentedCallback(FramePresentedCallback callback) {}
+
+void Rasterizer::SetFrameStatisticsCallback(
+    fxl::TimeDelta interval,
+    FrameStatisticsCallback callback) {}
+
+GrContext* Rasterizer::GetGrContext() {
+  return nullptr;
+}
+
+flow::RasterCache* Rasterizer::GetRasterCache() {
+  return nullptr;
+}
+
+void Rasterizer::OnMemoryPressure(MemoryPressureLevel level) {}
+
+void Rasterizer::ApplyRuntimeSettings(const blink::RuntimeSettings& settings) {}
+
+std::vector<flow::LayerProfiler::Entry> Rasterizer::ProfileLastLayerTree(
+    bool synchronize,
+    size_t count) {
+  return {};
+}
+
 }  // namespace shell
@@ -5,17 +5,35 @@
 #ifndef SHELL_COMMON_RASTERIZER_H_
 #define SHELL_COMMON_RASTERIZER_H_
 
+#include <functional>
 #include <memory>
+#include <vector>
 
+#include "flutter/common/runtime_settings.h"
+#include "flutter/flow/frame_statistics.h"
+#include "flutter/flow/frame_timing.h"
+#include "flutter/flow/layers/layer_profiler.h"
 #include "flutter/flow/layers/layer_tree.h"
+#include "flutter/flow/raster_cache.h"
+#include "flutter/flow/texture.h"
 #include "flutter/shell/common/surface.h"
 #include "flutter/synchronization/pipeline.h"
 #include "lib/fxl/functional/closure.h"
 #include "lib/fxl/memory/weak_ptr.h"
 #include "lib/fxl/synchronization/waitable_event.h"
+#include "third_party/skia/include/core/SkPicture.h"
 
 namespace shell {
 
+// How urgently the platform wants memory given back.
+enum class MemoryPressureLevel {
+  // Drop caches that are cheap to rebuild.
+  kModerate,
+  // Drop everything that can be rebuilt, for example because the application
+  // is in the background and about to be killed.
+  kCritical,
+};
+
 class Rasterizer {
  public:
   virtual ~Rasterizer();
@@ -27,17 +45,80 @@ class Rasterizer {
   virtual void Teardown(
       fxl::AutoResetWaitableEvent* teardown_completion_event) = 0;
 
+  // Stops drawing into the surface but keeps it, along with the resources
+  // cached for its context, while the platform binds it to a new window.
+  // Returns false if there is no surface to keep, in which case the rasterizer
+  // must be torn down. Called on the GPU thread. Keeps nothing by default.
+  virtual bool Suspend();
+
+  // Draws into the surface kept by |Suspend| again. Called on the GPU thread.
+  virtual void Resume(fxl::Closure rasterizer_continuation);
+
   virtual void Clear(SkColor color, const SkISize& size) = 0;
 
   virtual fxl::WeakPtr<Rasterizer> GetWeakRasterizerPtr() = 0;
 
   virtual flow::LayerTree* GetLastLayerTree() = 0;
 
+  // Records the last layer tree into a picture, which unlike the tree may be
+  // rasterized or serialized on another thread. Returns null if there is no
+  // tree. Called on the GPU thread.
+  sk_sp<SkPicture> RecordLastLayerTree();
+
   virtual void Draw(
       fxl::RefPtr<flutter::Pipeline<flow::LayerTree>> pipeline) = 0;
 
   // Set a callback to be called once when the next frame is drawn.
   virtual void AddNextFrameCallback(fxl::Closure nextFrameCallback) = 0;
+
+  using FrameTimingsCallback =
+      std::function<void(std::vector<flow::FrameTiming>)>;
+
+  // Set a callback that receives the timing records of presented frames in
+  // batches. The callback is invoked on the GPU thread.
+  virtual void SetFrameTimingsCallback(FrameTimingsCallback callback) = 0;
+
+  using FramePresentedCallback = std::function<void(const flow::FrameTiming&)>;
+
+  // Set a callback that receives the timing record of each frame on the GPU
+  // thread as soon as it has been presented. Does nothing by default.
+  virtual void SetFramePresentedCallback(FramePresentedCallback callback);
+
+  using FrameStatisticsCallback =
+      std::function<void(const flow::FrameStatistics&)>;
+
+  // Set a callback that receives the statistics of the frames presented in
+  // each |interval| on the GPU thread. Frames are not aggregated while there
+  // is no callback. Does nothing by default.
+  virtual void SetFrameStatisticsCallback(fxl::TimeDelta interval,
+                                          FrameStatisticsCallback callback);
+
+  // The external textures this rasterizer can composite. Only used on the GPU
+  // thread.
+  virtual flow::TextureRegistry& GetTextureRegistry() = 0;
+
+  // The context of the surface this rasterizer draws into, if any. Only used
+  // on the GPU thread. Returns null by default.
+  virtual GrContext* GetGrContext();
+
+  // The cache of rasterized pictures and layers, if any. Only used on the GPU
+  // thread. Returns null by default.
+  virtual flow::RasterCache* GetRasterCache();
+
+  // Frees cached resources. Called on the GPU thread. Does nothing by default.
+  virtual void OnMemoryPressure(MemoryPressureLevel level);
+
+  // Applies the settings that may change while the engine runs. Called on the
+  // GPU thread. Does nothing by default.
+  virtual void ApplyRuntimeSettings(const blink::RuntimeSettings& settings);
+
+  // Paints the last layer tree again into an offscreen surface, measuring the
+  // time spent on each layer. If |synchronize| is true, the GPU is waited on
+  // around each layer. Returns up to |count| of the most expensive layers.
+  // Called on the GPU thread. Returns nothing by default.
+  virtual std::vector<flow::LayerProfiler::Entry> ProfileLastLayerTree(
+      bool synchronize,
+      size_t count);
 };
 
 }  // namespace shell
@@ -0,0 +1,80 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/shader_warmup.h"
+
+#include <algorithm>
+
+#include "flutter/glue/trace_event.h"
+#include "lib/fxl/logging.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkPicture.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace shell {
+
+// Shader programs do not depend on the size of the target, so large pictures
+// are clipped to bound the memory of the offscreen surface.
+static const int kMaxWarmupSurfaceDimension = 1024;
+
+size_t WarmUpShaders(GrContext* context,
+                     const std::vector<sk_sp<SkData>>& pictures) {
+  if (context == nullptr || pictures.empty()) {
+    return 0;
+  }
+
+  TRACE_EVENT0("flutter", "WarmUpShaders");
+
+  size_t drawn = 0;
+  for (const auto& data : pictures) {
+    sk_sp<SkPicture> picture = SkPicture::MakeFromData(data.get());
+    if (picture == nullptr) {
+      FXL_DLOG(WARNING) << "Could not deserialize a shader warmup picture.";
+      continue;
+    }
+
+    const SkIRect bounds = picture->cullRect().roundOut();
+    if (bounds.isEmpty()) {
+      continue;
+    }
+
+    // The same sRGB 8888 configuration the frames are rendered in, so that
+    // the compiled programs are the ones the frames use.
+    const SkImageInfo image_info = SkImageInfo::MakeS32(
+        std::min(bounds.width(), kMaxWarmupSurfaceDimension),
+        std::min(bounds.height(), kMaxWarmupSurfaceDimension),
+        kPremul_SkAlphaType);
+    sk_sp<SkSurface> surface =
+        SkSurface::MakeRenderTarget(context, SkBudgeted::kNo, image_info);
+    if (surface == nullptr) {
+      FXL_DLOG(WARNING) << "Could not create a shader warmup surface.";
+      return drawn;
+    }
+
+    SkCanvas* canvas = surface->getCanvas();
+    canvas->translate(-bounds.left(), -bounds.top());
+    canvas->drawPicture(picture.get());
+    canvas->flush();
+    drawn++;
+  }
+
+  return drawn;
+}
+
+std::vector<sk_sp<SkData>> ReadSerializedPictures(
+    const std::vector<std::string>& paths) {
+  std::vector<sk_sp<SkData>> pictures;
+  for (const auto& path : paths) {
+    sk_sp<SkData> data = SkData::MakeFromFileName(path.c_str());
+    if (data == nullptr) {
+      FXL_LOG(WARNING) << "Could not read the shader warmup picture at "
+                       << path;
+      continue;
+    }
+    pictures.push_back(std::move(data));
+  }
+  return pictures;
+}
+
+}  // namespace shell
@@ -0,0 +1,31 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_SHADER_WARMUP_H_
+#define FLUTTER_SHELL_COMMON_SHADER_WARMUP_H_
+
+#include <string>
+#include <vector>
+
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/gpu/GrContext.h"
+
+namespace shell {
+
+// Draws each of the pictures (serialized with |SerializePicture|) into an
+// offscreen surface of |context| and flushes it, so that the shader programs
+// the pictures need are compiled before the frames that first draw similar
+// content. Pictures that cannot be deserialized are skipped. Returns the
+// number of pictures drawn. Must be called with |context| current.
+size_t WarmUpShaders(GrContext* context,
+                     const std::vector<sk_sp<SkData>>& pictures);
+
+// Reads the serialized pictures at |paths|, skipping those that cannot be
+// read.
+std::vector<sk_sp<SkData>> ReadSerializedPictures(
+    const std::vector<std::string>& paths);
+
+}  // namespace shell
+
+#endif  // FLUTTER_SHELL_COMMON_SHADER_WARMUP_H_
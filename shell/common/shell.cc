@@ -14,6 +14,7 @@
 #include "flutter/fml/icu_util.h"
 #include "flutter/fml/message_loop.h"
 #include "flutter/fml/trace_event.h"
+#include "flutter/fml/trace_recorder.h"
 #include "flutter/runtime/dart_init.h"
 #include "flutter/shell/common/diagnostic/diagnostic_server.h"
 #include "flutter/shell/common/engine.h"
@@ -67,21 +68,51 @@ void ServiceIsolateHook(bool running_precompiled) {
 
 }  // namespace
 
-Shell::Shell(fxl::CommandLine command_line)
+Shell::Shell(fxl::CommandLine command_line,
+             CustomTaskRunners custom_task_runners)
     : command_line_(std::move(command_line)) {
   FXL_DCHECK(!g_shell);
 
-  gpu_thread_.reset(new fml::Thread("gpu_thread"));
-  ui_thread_.reset(new fml::Thread("ui_thread"));
-  io_thread_.reset(new fml::Thread("io_thread"));
+  const bool prioritize = blink::Settings::Get().enable_thread_priorities;
+  const auto display_priority = prioritize ? fml::ThreadPriority::kDisplay
+                                           : fml::ThreadPriority::kNormal;
+  const auto background_priority = prioritize
+                                       ? fml::ThreadPriority::kBackground
+                                       : fml::ThreadPriority::kNormal;
+  const bool merge_ui_and_gpu_threads =
+      blink::Settings::Get().merge_ui_and_gpu_threads;
+  if (!custom_task_runners.gpu && !merge_ui_and_gpu_threads) {
+    gpu_thread_.reset(new fml::Thread("gpu_thread", display_priority));
+  }
+  ui_thread_.reset(new fml::Thread("ui_thread", display_priority));
+  io_thread_.reset(new fml::Thread("io_thread", background_priority));
+  worker_pool_.reset(new fml::WorkerPool("worker"));
+
+  fxl::RefPtr<fxl::TaskRunner> platform_runner =
+      std::move(custom_task_runners.platform);
+  if (!platform_runner) {
+    // Since we are not using fml::Thread, we need to initialize the message
+    // loop manually.
+    fml::MessageLoop::EnsureInitializedForCurrentThread();
+    platform_runner = fml::MessageLoop::GetCurrent().GetTaskRunner();
+    message_loop_task_runners_.emplace_back("platform", platform_runner);
+  }
+
+  fxl::RefPtr<fxl::TaskRunner> gpu_runner = std::move(custom_task_runners.gpu);
+  if (!gpu_runner && merge_ui_and_gpu_threads) {
+    gpu_runner = ui_thread_->GetTaskRunner();
+  } else if (!gpu_runner) {
+    gpu_runner = gpu_thread_->GetTaskRunner();
+    message_loop_task_runners_.emplace_back("gpu", gpu_runner);
+  }
+
+  message_loop_task_runners_.emplace_back("ui", ui_thread_->GetTaskRunner());
+  message_loop_task_runners_.emplace_back("io", io_thread_->GetTaskRunner());
 
-  // Since we are not using fml::Thread, we need to initialize the message loop
-  // manually.
-  fml::MessageLoop::EnsureInitializedForCurrentThread();
-  blink::Threads threads(fml::MessageLoop::GetCurrent().GetTaskRunner(),
-                         gpu_thread_->GetTaskRunner(),
+  blink::Threads threads(platform_runner, gpu_runner,
                          ui_thread_->GetTaskRunner(),
-                         io_thread_->GetTaskRunner());
+                         io_thread_->GetTaskRunner(),
+                         worker_pool_->GetTaskRunner());
   blink::Threads::Set(threads);
 
   blink::Threads::Gpu()->PostTask([this]() { InitGpuThread(); });
@@ -96,7 +127,8 @@ Shell::~Shell() {}
 
 void Shell::InitStandalone(fxl::CommandLine command_line,
                            std::string icu_data_path,
-                           std::string application_library_path) {
+                           std::string application_library_path,
+                           CustomTaskRunners custom_task_runners) {
   TRACE_EVENT0("flutter", "Shell::InitStandalone");
 
   fml::icu::InitializeICU(icu_data_path);
@@ -141,12 +173,78 @@ void Shell::InitStandalone(fxl::CommandLine command_line,
   settings.start_paused =
       command_line.HasOption(FlagForSwitch(Switch::StartPaused));
 
+  settings.lazy_service_isolate =
+      command_line.HasOption(FlagForSwitch(Switch::LazyServiceIsolate));
+
   settings.enable_dart_profiling =
       command_line.HasOption(FlagForSwitch(Switch::EnableDartProfiling));
 
+  settings.share_isolate_program =
+      command_line.HasOption(FlagForSwitch(Switch::ShareIsolateProgram));
+
+  if (command_line.HasOption(FlagForSwitch(Switch::IsolatePoolSize))) {
+    if (!GetSwitchValue(command_line, Switch::IsolatePoolSize,
+                        &settings.isolate_pool_size)) {
+      FXL_LOG(INFO) << "Isolate pool size specified was malformed. Will not "
+                       "pool isolates.";
+    }
+  }
+
   settings.enable_software_rendering =
       command_line.HasOption(FlagForSwitch(Switch::EnableSoftwareRendering));
 
+  settings.enable_tiled_software_rendering = command_line.HasOption(
+      FlagForSwitch(Switch::EnableTiledSoftwareRendering));
+
+  settings.enable_layer_tree_diffing =
+      command_line.HasOption(FlagForSwitch(Switch::EnableLayerTreeDiffing));
+
+  settings.enable_frame_pacing =
+      command_line.HasOption(FlagForSwitch(Switch::EnableFramePacing));
+
+  settings.throttle_idle_frames =
+      command_line.HasOption(FlagForSwitch(Switch::ThrottleIdleFrames));
+
+  if (command_line.HasOption(FlagForSwitch(Switch::FrameRateDivisor)) &&
+      !GetSwitchValue(command_line, Switch::FrameRateDivisor,
+                      &settings.frame_rate_divisor)) {
+    FXL_LOG(INFO) << "Frame rate divisor specified was malformed. Will not "
+                     "cap the frame rate.";
+  }
+
+  settings.enable_pointer_resampling =
+      command_line.HasOption(FlagForSwitch(Switch::EnablePointerResampling));
+
+  settings.enable_pointer_coalescing =
+      settings.enable_pointer_resampling ||
+      command_line.HasOption(FlagForSwitch(Switch::EnablePointerCoalescing));
+
+  settings.enable_hardware_image_buffers = !command_line.HasOption(
+      FlagForSwitch(Switch::DisableHardwareImageBuffers));
+
+  settings.enable_thread_priorities =
+      !command_line.HasOption(FlagForSwitch(Switch::DisableThreadPriorities));
+
+  settings.merge_ui_and_gpu_threads =
+      command_line.HasOption(FlagForSwitch(Switch::MergeUIAndGPUThreads));
+
+  if (command_line.HasOption(FlagForSwitch(Switch::EnableTripleBuffering))) {
+    settings.layer_tree_pipeline_depth = 3;
+  }
+
+  if (command_line.HasOption(FlagForSwitch(Switch::LayerTreePipelineDepth))) {
+    uint32_t pipeline_depth = 0;
+    if (GetSwitchValue(command_line, Switch::LayerTreePipelineDepth,
+                       &pipeline_depth) &&
+        pipeline_depth > 0) {
+      settings.layer_tree_pipeline_depth = pipeline_depth;
+    } else {
+      FXL_LOG(INFO) << "Layer tree pipeline depth specified was malformed. "
+                       "Will use a depth of "
+                    << settings.layer_tree_pipeline_depth << ".";
+    }
+  }
+
   settings.using_blink =
       !command_line.HasOption(FlagForSwitch(Switch::EnableTxt));
 
@@ -156,6 +254,10 @@ void Shell::InitStandalone(fxl::CommandLine command_line,
   settings.trace_startup =
       command_line.HasOption(FlagForSwitch(Switch::TraceStartup));
 
+  settings.enable_trace_recorder =
+      command_line.HasOption(FlagForSwitch(Switch::EnableTraceRecorder));
+  fml::tracing::TraceRecorder::SetEnabled(settings.enable_trace_recorder);
+
   command_line.GetOptionValue(FlagForSwitch(Switch::AotSnapshotPath),
                               &settings.aot_snapshot_path);
 
@@ -172,12 +274,211 @@ void Shell::InitStandalone(fxl::CommandLine command_line,
       FlagForSwitch(Switch::AotIsolateSnapshotInstructions),
       &settings.aot_isolate_snapshot_instr_filename);
 
+  command_line.GetOptionValue(
+      FlagForSwitch(Switch::RecordSnapshotPageProfile),
+      &settings.snapshot_page_profile_path);
+
   command_line.GetOptionValue(FlagForSwitch(Switch::CacheDirPath),
                               &settings.temp_directory_path);
 
   settings.use_test_fonts =
       command_line.HasOption(FlagForSwitch(Switch::UseTestFonts));
 
+  if (command_line.HasOption(FlagForSwitch(Switch::RasterCacheMaxMegabytes))) {
+    size_t raster_cache_max_mb = 0;
+    if (GetSwitchValue(command_line, Switch::RasterCacheMaxMegabytes,
+                       &raster_cache_max_mb)) {
+      settings.raster_cache_max_bytes = raster_cache_max_mb << 20;
+    } else {
+      FXL_LOG(INFO) << "Raster cache budget specified was malformed. Will "
+                       "evict unused entries every frame.";
+    }
+  }
+
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::GpuResourceCacheMaxMegabytes))) {
+    size_t gpu_resource_cache_max_mb = 0;
+    if (GetSwitchValue(command_line, Switch::GpuResourceCacheMaxMegabytes,
+                       &gpu_resource_cache_max_mb)) {
+      settings.gpu_resource_cache_max_bytes = gpu_resource_cache_max_mb << 20;
+    } else {
+      FXL_LOG(INFO) << "GPU resource cache budget specified was malformed. "
+                       "Will use the default budget.";
+    }
+  }
+
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::ResourceContextCacheMaxMegabytes))) {
+    size_t resource_context_cache_max_mb = 0;
+    if (GetSwitchValue(command_line, Switch::ResourceContextCacheMaxMegabytes,
+                       &resource_context_cache_max_mb)) {
+      settings.resource_context_cache_max_bytes =
+          resource_context_cache_max_mb << 20;
+    } else {
+      FXL_LOG(INFO) << "Resource context cache budget specified was "
+                       "malformed. Will not cache resources.";
+    }
+  }
+
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::AssetCacheMaxMegabytes))) {
+    size_t asset_cache_max_mb = 0;
+    if (GetSwitchValue(command_line, Switch::AssetCacheMaxMegabytes,
+                       &asset_cache_max_mb)) {
+      settings.asset_cache_max_bytes = asset_cache_max_mb << 20;
+    } else {
+      FXL_LOG(INFO) << "Asset cache budget specified was malformed. Will "
+                       "inflate assets on every read.";
+    }
+  }
+
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::ImageUploadMaxKilobytesPerFrame))) {
+    size_t image_upload_max_kb = 0;
+    if (GetSwitchValue(command_line, Switch::ImageUploadMaxKilobytesPerFrame,
+                       &image_upload_max_kb)) {
+      settings.image_upload_max_bytes_per_frame = image_upload_max_kb << 10;
+    } else {
+      FXL_LOG(INFO) << "Image upload budget specified was malformed. Will "
+                       "upload images as soon as they are decoded.";
+    }
+  }
+
+  settings.enable_image_atlas =
+      command_line.HasOption(FlagForSwitch(Switch::EnableImageAtlas));
+
+  settings.raster_cache_deferred_population = command_line.HasOption(
+      FlagForSwitch(Switch::RasterCacheDeferredPopulation));
+
+  settings.raster_cache_concurrent_population = command_line.HasOption(
+      FlagForSwitch(Switch::RasterCacheConcurrentPopulation));
+
+  settings.raster_cache_rgb565 =
+      command_line.HasOption(FlagForSwitch(Switch::RasterCacheRGB565));
+
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::RasterCacheScaleBucketsPerOctave))) {
+    size_t buckets = 0;
+    if (!GetSwitchValue(command_line, Switch::RasterCacheScaleBucketsPerOctave,
+                        &buckets)) {
+      FXL_LOG(INFO) << "Raster cache scale buckets specified were malformed. "
+                       "Will rasterize at the exact scale.";
+    }
+    settings.raster_cache_scale_buckets_per_octave = buckets;
+  }
+
+  settings.concurrent_text_layout =
+      command_line.HasOption(FlagForSwitch(Switch::ConcurrentTextLayout));
+
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::TextLayoutCacheMaxEntries))) {
+    if (!GetSwitchValue(command_line, Switch::TextLayoutCacheMaxEntries,
+                        &settings.text_layout_cache_max_entries)) {
+      FXL_LOG(INFO) << "Text layout cache size specified was malformed. Will "
+                       "keep "
+                    << settings.text_layout_cache_max_entries << " entries.";
+    }
+  }
+
+  if (command_line.HasOption(FlagForSwitch(Switch::TextFontCacheMaxEntries))) {
+    if (!GetSwitchValue(command_line, Switch::TextFontCacheMaxEntries,
+                        &settings.text_font_cache_max_entries)) {
+      FXL_LOG(INFO) << "Text font cache size specified was malformed. Will "
+                       "keep "
+                    << settings.text_font_cache_max_entries << " entries.";
+    }
+  }
+
+  settings.persistent_text_layout_cache =
+      command_line.HasOption(FlagForSwitch(Switch::PersistentTextLayoutCache));
+
+  command_line.GetOptionValue(FlagForSwitch(Switch::HyphenationPatternsPath),
+                              &settings.hyphenation_patterns_path);
+
+  settings.persistent_gpu_cache =
+      command_line.HasOption(FlagForSwitch(Switch::PersistentGpuCache));
+
+  settings.enable_vulkan_mailbox_present_mode = command_line.HasOption(
+      FlagForSwitch(Switch::EnableVulkanMailboxPresentMode));
+
+  settings.enable_metal =
+      command_line.HasOption(FlagForSwitch(Switch::EnableMetal));
+
+  settings.enable_gpu_timer_queries =
+      command_line.HasOption(FlagForSwitch(Switch::EnableGpuTimerQueries));
+
+  settings.enable_legacy_color_rendering = command_line.HasOption(
+      FlagForSwitch(Switch::EnableLegacyColorRendering));
+
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::DynamicResolutionMinScale)) &&
+      !GetSwitchValue(command_line, Switch::DynamicResolutionMinScale,
+                      &settings.dynamic_resolution_min_scale)) {
+    FXL_LOG(INFO) << "Dynamic resolution minimum scale specified was "
+                     "malformed. Will render at full scale.";
+  }
+
+  if (command_line.HasOption(FlagForSwitch(Switch::FrameStatisticsInterval)) &&
+      !GetSwitchValue(command_line, Switch::FrameStatisticsInterval,
+                      &settings.frame_statistics_interval_seconds)) {
+    FXL_LOG(INFO) << "Frame statistics interval specified was malformed. "
+                     "Will not collect frame statistics.";
+  }
+
+  settings.benchmark_mode =
+      command_line.HasOption(FlagForSwitch(Switch::BenchmarkMode));
+
+  if (command_line.HasOption(FlagForSwitch(Switch::BenchmarkFrameInterval)) &&
+      !GetSwitchValue(command_line, Switch::BenchmarkFrameInterval,
+                      &settings.benchmark_frame_interval_micros)) {
+    FXL_LOG(INFO) << "Benchmark frame interval specified was malformed. "
+                     "Will begin frames as soon as the previous ones are done.";
+  }
+
+  command_line.GetOptionValue(FlagForSwitch(Switch::BenchmarkOutput),
+                              &settings.benchmark_output_path);
+
+  std::string shader_warmup_pictures;
+  if (command_line.GetOptionValue(FlagForSwitch(Switch::ShaderWarmupPictures),
+                                  &shader_warmup_pictures)) {
+    std::stringstream stream(shader_warmup_pictures);
+    std::string path;
+    while (std::getline(stream, path, ',')) {
+      if (!path.empty())
+        settings.shader_warmup_picture_paths.push_back(path);
+    }
+  }
+
+  std::string skia_trace_categories;
+  if (command_line.GetOptionValue(FlagForSwitch(Switch::SkiaTraceCategories),
+                                  &skia_trace_categories)) {
+    std::stringstream stream(skia_trace_categories);
+    std::string category;
+    while (std::getline(stream, category, ',')) {
+      if (!category.empty())
+        settings.skia_trace_categories.push_back(category);
+    }
+  }
+
+  std::string json_platform_message_channels;
+  if (command_line.GetOptionValue(
+          FlagForSwitch(Switch::JsonPlatformMessageChannels),
+          &json_platform_message_channels)) {
+    std::stringstream stream(json_platform_message_channels);
+    std::string channel;
+    while (std::getline(stream, channel, ',')) {
+      if (!channel.empty())
+        settings.json_platform_message_channels.push_back(channel);
+    }
+  }
+
+  if (command_line.HasOption(FlagForSwitch(Switch::SkiaTraceFrameInterval)) &&
+      !GetSwitchValue(command_line, Switch::SkiaTraceFrameInterval,
+                      &settings.skia_trace_frame_interval)) {
+    FXL_LOG(INFO) << "Skia trace frame interval specified was malformed. "
+                     "Will trace the Skia calls of every frame.";
+  }
+
   std::string all_dart_flags;
   if (command_line.GetOptionValue(FlagForSwitch(Switch::DartFlags),
                                   &all_dart_flags)) {
@@ -191,17 +492,21 @@ void Shell::InitStandalone(fxl::CommandLine command_line,
 
   blink::Settings::Set(settings);
 
-  Init(std::move(command_line));
+  Init(std::move(command_line), std::move(custom_task_runners));
 }
 
-void Shell::Init(fxl::CommandLine command_line) {
+void Shell::Init(fxl::CommandLine command_line,
+                 CustomTaskRunners custom_task_runners) {
 #if FLUTTER_RUNTIME_MODE != FLUTTER_RUNTIME_MODE_RELEASE
   bool trace_skia = command_line.HasOption(FlagForSwitch(Switch::TraceSkia));
-  InitSkiaEventTracer(trace_skia);
+  const blink::Settings& settings = blink::Settings::Get();
+  InitSkiaEventTracer(trace_skia, settings.skia_trace_categories,
+                      settings.skia_trace_frame_interval);
 #endif
 
   FXL_DCHECK(!g_shell);
-  g_shell = new Shell(std::move(command_line));
+  g_shell =
+      new Shell(std::move(command_line), std::move(custom_task_runners));
   blink::Threads::UI()->PostTask(Engine::Init);
 }
 
@@ -218,6 +523,11 @@ TracingController& Shell::tracing_controller() {
   return tracing_controller_;
 }
 
+const std::vector<std::pair<std::string, fxl::RefPtr<fxl::TaskRunner>>>&
+Shell::GetMessageLoopTaskRunners() const {
+  return message_loop_task_runners_;
+}
+
 void Shell::InitGpuThread() {
   gpu_thread_checker_.reset(new fxl::ThreadChecker());
 }
@@ -267,6 +577,17 @@ void Shell::GetPlatformViews(
   *platform_views = platform_views_;
 }
 
+void Shell::UpdateRuntimeSettings(const blink::RuntimeSettings& settings) {
+  blink::RuntimeSettings::Set(settings);
+  std::vector<std::weak_ptr<PlatformView>> platform_views;
+  GetPlatformViews(&platform_views);
+  for (const auto& weak_view : platform_views) {
+    std::shared_ptr<PlatformView> view = weak_view.lock();
+    if (view)
+      view->ApplyRuntimeSettings(settings);
+  }
+}
+
 void Shell::GetPlatformViewIds(
     std::vector<PlatformViewInfo>* platform_view_ids) {
   std::lock_guard<std::mutex> lk(platform_views_mutex_);
@@ -337,4 +658,23 @@ void Shell::RunInPlatformViewUIThread(uintptr_t view_id,
   latch->Signal();
 }
 
+void Shell::PrewarmEngine(const std::string& bundle_path,
+                          const std::string& entrypoint) {
+  blink::Threads::UI()->PostTask([this, bundle_path, entrypoint]() {
+    auto engine = std::make_unique<Engine>();
+    engine->Prewarm(bundle_path, entrypoint);
+    std::unique_ptr<Engine> replaced;
+    {
+      std::lock_guard<std::mutex> lk(prewarmed_engine_mutex_);
+      replaced = std::move(prewarmed_engine_);
+      prewarmed_engine_ = std::move(engine);
+    }
+  });
+}
+
+std::unique_ptr<Engine> Shell::TakePrewarmedEngine() {
+  std::lock_guard<std::mutex> lk(prewarmed_engine_mutex_);
+  return std::move(prewarmed_engine_);
+}
+
 }  // namespace shell
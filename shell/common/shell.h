@@ -5,7 +5,9 @@
 #ifndef SHELL_COMMON_SHELL_H_
 #define SHELL_COMMON_SHELL_H_
 
+#include "flutter/common/runtime_settings.h"
 #include "flutter/fml/thread.h"
+#include "flutter/fml/worker_pool.h"
 #include "flutter/shell/common/tracing_controller.h"
 #include "lib/fxl/command_line.h"
 #include "lib/fxl/macros.h"
@@ -16,19 +18,32 @@
 #include "lib/fxl/tasks/task_runner.h"
 
 #include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace shell {
 
+class Engine;
 class PlatformView;
 class Rasterizer;
 
 class Shell {
  public:
+  // Runners supplied by the embedder in place of the message loop of the
+  // thread that initializes the shell and of the GPU thread. Null runners are
+  // not replaced. Each runner must run all of its tasks on one thread.
+  struct CustomTaskRunners {
+    fxl::RefPtr<fxl::TaskRunner> platform;
+    fxl::RefPtr<fxl::TaskRunner> gpu;
+  };
+
   ~Shell();
 
   static void InitStandalone(fxl::CommandLine command_line,
                              std::string icu_data_path = "",
-                             std::string application_library_path = "");
+                             std::string application_library_path = "",
+                             CustomTaskRunners custom_task_runners = {});
 
   static Shell& Shared();
 
@@ -36,6 +51,12 @@ class Shell {
 
   TracingController& tracing_controller();
 
+  // The runners of the message loops created by the shell, by thread name.
+  // These are |fml::TaskRunner|s, which record the latency of their tasks.
+  // Custom runners are left out.
+  const std::vector<std::pair<std::string, fxl::RefPtr<fxl::TaskRunner>>>&
+  GetMessageLoopTaskRunners() const;
+
   // Maintain a list of rasterizers.
   // These APIs must only be accessed on the GPU thread.
   void AddRasterizer(const fxl::WeakPtr<Rasterizer>& rasterizer);
@@ -50,6 +71,11 @@ class Shell {
   void GetPlatformViews(
       std::vector<std::weak_ptr<PlatformView>>* platform_views);
 
+  // Replaces the runtime settings and applies them to the engines on the UI
+  // thread and to the rasterizers on the GPU thread. Can be called from any
+  // thread.
+  void UpdateRuntimeSettings(const blink::RuntimeSettings& settings);
+
   struct PlatformViewInfo {
     uintptr_t view_id;
     int64_t isolate_id;
@@ -70,10 +96,22 @@ class Shell {
                          int64_t* dart_isolate_id,
                          std::string* isolate_name);
 
+  // Creates an engine on the UI thread and runs the bundle in it before any
+  // view exists. The next platform view that is created adopts the engine
+  // instead of creating its own. Replaces the engine of an earlier call that
+  // no view adopted. Can be called from any thread.
+  void PrewarmEngine(const std::string& bundle_path,
+                     const std::string& entrypoint = "main");
+
+  // Returns the pre-warmed engine once it is running, or null. Can be called
+  // from any thread.
+  std::unique_ptr<Engine> TakePrewarmedEngine();
+
  private:
-  static void Init(fxl::CommandLine command_line);
+  static void Init(fxl::CommandLine command_line,
+                   CustomTaskRunners custom_task_runners);
 
-  Shell(fxl::CommandLine command_line);
+  Shell(fxl::CommandLine command_line, CustomTaskRunners custom_task_runners);
 
   void InitGpuThread();
   void InitUIThread();
@@ -92,6 +130,9 @@ class Shell {
   std::unique_ptr<fml::Thread> gpu_thread_;
   std::unique_ptr<fml::Thread> ui_thread_;
   std::unique_ptr<fml::Thread> io_thread_;
+  std::unique_ptr<fml::WorkerPool> worker_pool_;
+  std::vector<std::pair<std::string, fxl::RefPtr<fxl::TaskRunner>>>
+      message_loop_task_runners_;
 
   std::unique_ptr<fxl::ThreadChecker> gpu_thread_checker_;
   std::unique_ptr<fxl::ThreadChecker> ui_thread_checker_;
@@ -103,6 +144,9 @@ class Shell {
 
   std::mutex platform_views_mutex_;
 
+  std::unique_ptr<Engine> prewarmed_engine_;
+  std::mutex prewarmed_engine_mutex_;
+
   FXL_DISALLOW_COPY_AND_ASSIGN(Shell);
 };
 
@@ -7,6 +7,14 @@
 #define TRACE_EVENT_HIDE_MACROS
 #include "flutter/fml/trace_event.h"
 
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
 #include <vector>
 
 #include "lib/fxl/logging.h"
@@ -18,11 +26,15 @@ namespace skia {
 
 class FlutterEventTracer : public SkEventTracer {
  public:
-  static constexpr const char* kSkiaTag = "skia";
   static constexpr uint8_t kYes = 1;
   static constexpr uint8_t kNo = 0;
 
-  FlutterEventTracer(bool enabled) : enabled_(enabled ? kYes : kNo){};
+  FlutterEventTracer(bool enabled,
+                     std::vector<std::string> categories,
+                     uint32_t frame_interval)
+      : enabled_(enabled),
+        categories_(std::move(categories)),
+        frame_interval_(frame_interval) {}
 
   SkEventTracer::Handle addTraceEvent(char phase,
                                       const uint8_t* category_enabled_flag,
@@ -33,22 +45,23 @@ class FlutterEventTracer : public SkEventTracer {
                                       const uint8_t* p_arg_types,
                                       const uint64_t* p_arg_values,
                                       uint8_t flags) override {
+    const char* category = getCategoryGroupName(category_enabled_flag);
     switch (phase) {
       case TRACE_EVENT_PHASE_BEGIN:
       case TRACE_EVENT_PHASE_COMPLETE:
-        fml::tracing::TraceEvent0(kSkiaTag, name);
+        fml::tracing::TraceEvent0(category, name);
         break;
       case TRACE_EVENT_PHASE_END:
         fml::tracing::TraceEventEnd(name);
         break;
       case TRACE_EVENT_PHASE_INSTANT:
-        fml::tracing::TraceEventInstant0(kSkiaTag, name);
+        fml::tracing::TraceEventInstant0(category, name);
         break;
       case TRACE_EVENT_PHASE_ASYNC_BEGIN:
-        fml::tracing::TraceEventAsyncBegin0(kSkiaTag, name, id);
+        fml::tracing::TraceEventAsyncBegin0(category, name, id);
         break;
       case TRACE_EVENT_PHASE_ASYNC_END:
-        fml::tracing::TraceEventAsyncEnd0(kSkiaTag, name, id);
+        fml::tracing::TraceEventAsyncEnd0(category, name, id);
         break;
       default:
         break;
@@ -64,22 +77,122 @@ class FlutterEventTracer : public SkEventTracer {
     fml::tracing::TraceEventEnd(name);
   }
 
+  // Skia keeps the returned flag of each trace site and only calls into the
+  // tracer while it is set, so filtered events cost a single load.
   const uint8_t* getCategoryGroupEnabled(const char* name) override {
-    return &enabled_;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = categories_by_name_.find(name);
+    if (found == categories_by_name_.end()) {
+      found = categories_by_name_.emplace(name, Category()).first;
+      found->second.name = found->first.c_str();
+      found->second.enabled = GetFlag(found->first);
+    }
+    return &found->second.enabled;
   }
 
   const char* getCategoryGroupName(
       const uint8_t* category_enabled_flag) override {
-    return kSkiaTag;
+    return reinterpret_cast<const Category*>(category_enabled_flag)->name;
+  }
+
+  // Leaves the categories or the frame interval unchanged if they are null.
+  void Configure(bool enabled,
+                 const std::vector<std::string>* categories,
+                 const uint32_t* frame_interval) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    enabled_ = enabled;
+    if (categories) {
+      categories_ = *categories;
+    }
+    if (frame_interval) {
+      frame_interval_ = *frame_interval;
+      frame_count_ = 0;
+      sampled_frame_ = true;
+    }
+    UpdateFlags();
   }
 
-  void enable() { enabled_ = kYes; }
+  void BeginFrame() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (frame_interval_ <= 1) {
+      return;
+    }
+    const bool sampled = frame_count_++ % frame_interval_ == 0;
+    if (sampled != sampled_frame_) {
+      sampled_frame_ = sampled;
+      UpdateFlags();
+    }
+  }
 
  private:
-  uint8_t enabled_;
+  std::mutex mutex_;
+  bool enabled_;
+  // Empty enables all categories.
+  std::vector<std::string> categories_;
+  uint32_t frame_interval_;
+  uint64_t frame_count_ = 0;
+  // Whether the events of the current frame are passed on.
+  bool sampled_frame_ = true;
+  // The flag handed to Skia for a category group comes first, so that the
+  // group can be found from the flag.
+  struct Category {
+    uint8_t enabled = kNo;
+    const char* name = nullptr;
+  };
+  // Map nodes, and so the flags and names, never move.
+  std::map<std::string, Category> categories_by_name_;
+
+  // Category groups are comma separated lists of categories. A group is
+  // enabled if any of its categories is.
+  bool IsCategoryGroupEnabled(const std::string& group) const {
+    if (categories_.empty()) {
+      return true;
+    }
+    std::stringstream stream(group);
+    std::string category;
+    while (std::getline(stream, category, ',')) {
+      if (std::find(categories_.begin(), categories_.end(), category) !=
+          categories_.end()) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  uint8_t GetFlag(const std::string& group) const {
+    return enabled_ && sampled_frame_ && IsCategoryGroupEnabled(group) ? kYes
+                                                                       : kNo;
+  }
+
+  void UpdateFlags() {
+    for (auto& category : categories_by_name_) {
+      category.second.enabled = GetFlag(category.first);
+    }
+  }
+
   FXL_DISALLOW_COPY_AND_ASSIGN(FlutterEventTracer);
 };
 
+constexpr uint8_t FlutterEventTracer::kYes;
+constexpr uint8_t FlutterEventTracer::kNo;
+
+// Owned by Skia once set.
+static FlutterEventTracer* g_tracer = nullptr;
+
+static const char* ValueForKey(const char** param_keys,
+                               const char** param_values,
+                               intptr_t num_params,
+                               const char* key) {
+  for (intptr_t i = 0; i < num_params; i++) {
+    if (strcmp(param_keys[i], key) == 0) {
+      return param_values[i];
+    }
+  }
+  return nullptr;
+}
+
+// Accepts "enabled" ("false" disables tracing), "categories" (a comma
+// separated list, empty for all) and "frameInterval".
 bool enableSkiaTracingCallback(const char* method,
                                const char** param_keys,
                                const char** param_values,
@@ -87,19 +200,62 @@ bool enableSkiaTracingCallback(const char* method,
                                void* user_data,
                                const char** json_object) {
   FlutterEventTracer* tracer = static_cast<FlutterEventTracer*>(user_data);
-  tracer->enable();
+
+  const char* enabled_param =
+      ValueForKey(param_keys, param_values, num_params, "enabled");
+  const bool enabled =
+      enabled_param == nullptr || strcmp(enabled_param, "false") != 0;
+
+  std::vector<std::string> categories;
+  const char* categories_param =
+      ValueForKey(param_keys, param_values, num_params, "categories");
+  if (categories_param) {
+    std::stringstream stream(categories_param);
+    std::string category;
+    while (std::getline(stream, category, ',')) {
+      if (!category.empty())
+        categories.push_back(category);
+    }
+  }
+
+  uint32_t frame_interval = 0;
+  const char* frame_interval_param =
+      ValueForKey(param_keys, param_values, num_params, "frameInterval");
+  if (frame_interval_param) {
+    char* end = nullptr;
+    frame_interval = strtoul(frame_interval_param, &end, 10);
+    if (end == frame_interval_param || *end != '\0') {
+      *json_object = strdup(
+          "{\"code\":-32602,\"message\":\"Invalid params\","
+          "\"data\":{\"details\":\"frameInterval is not a number\"}}");
+      return false;
+    }
+  }
+
+  tracer->Configure(enabled, categories_param ? &categories : nullptr,
+                    frame_interval_param ? &frame_interval : nullptr);
   *json_object = strdup("{\"type\":\"Success\"}");
   return true;
 }
 
 }  // namespace skia
 
-void InitSkiaEventTracer(bool enabled) {
-  skia::FlutterEventTracer* tracer = new skia::FlutterEventTracer(enabled);
+void InitSkiaEventTracer(bool enabled,
+                         const std::vector<std::string>& categories,
+                         uint32_t frame_interval) {
+  skia::FlutterEventTracer* tracer =
+      new skia::FlutterEventTracer(enabled, categories, frame_interval);
   Dart_RegisterRootServiceRequestCallback("_flutter.enableSkiaTracing",
                                           skia::enableSkiaTracingCallback,
                                           static_cast<void*>(tracer));
   // Initialize the binding to Skia's tracing events. Skia will
   // take ownership of and clean up the memory allocated here.
   SkEventTracer::SetInstance(tracer);
+  skia::g_tracer = tracer;
+}
+
+void SkiaEventTracerBeginFrame() {
+  if (skia::g_tracer) {
+    skia::g_tracer->BeginFrame();
+  }
 }
@@ -5,6 +5,19 @@
 #ifndef FLUTTER_SHELL_COMMON_SKIA_EVENT_TRACER_IMPL_H_
 #define FLUTTER_SHELL_COMMON_SKIA_EVENT_TRACER_IMPL_H_
 
-void InitSkiaEventTracer(bool enabled);
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+// Passes the Skia trace events of |categories| (all of them if empty) on to
+// the timeline while |enabled|, and only those of every |frame_interval|th
+// frame if that is larger than one. The service protocol can update all three.
+void InitSkiaEventTracer(bool enabled,
+                         const std::vector<std::string>& categories,
+                         uint32_t frame_interval);
+
+// Marks the beginning of a frame of the GPU thread for frame sampling.
+void SkiaEventTracerBeginFrame();
 
 #endif  // FLUTTER_SHELL_COMMON_SKIA_EVENT_TRACER_IMPL_H_
@@ -0,0 +1,113 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/standard_codec_stream.h"
+
+namespace shell {
+
+StandardCodecWriter::StandardCodecWriter(size_t base_offset)
+    : base_offset_(base_offset) {}
+
+StandardCodecWriter::~StandardCodecWriter() = default;
+
+void StandardCodecWriter::Flush() {
+  base_offset_ += buffer_.size();
+  buffer_.clear();
+}
+
+void StandardCodecWriter::WriteSize(uint32_t size) {
+  if (size < 254) {
+    WriteByte(static_cast<uint8_t>(size));
+  } else if (size <= 0xffff) {
+    WriteByte(254);
+    Write<uint16_t>(static_cast<uint16_t>(size));
+  } else {
+    WriteByte(255);
+    Write<uint32_t>(size);
+  }
+}
+
+void StandardCodecWriter::WriteAlignment(size_t alignment) {
+  const size_t mod = (base_offset_ + buffer_.size()) % alignment;
+  if (mod) {
+    buffer_.insert(buffer_.end(), alignment - mod, 0);
+  }
+}
+
+void StandardCodecWriter::WriteBytes(const void* bytes, size_t length) {
+  const uint8_t* begin = static_cast<const uint8_t*>(bytes);
+  buffer_.insert(buffer_.end(), begin, begin + length);
+}
+
+void StandardCodecWriter::WriteTypedArray(const void* elements,
+                                          size_t element_count,
+                                          size_t element_size) {
+  WriteSize(static_cast<uint32_t>(element_count));
+  WriteAlignment(element_size);
+  WriteBytes(elements, element_count * element_size);
+}
+
+StandardCodecReader::StandardCodecReader(const uint8_t* bytes, size_t length)
+    : bytes_(bytes), length_(length), position_(0), failed_(false) {}
+
+StandardCodecReader::~StandardCodecReader() = default;
+
+uint8_t StandardCodecReader::ReadByte() {
+  const uint8_t* byte = ReadSpan(1);
+  return byte ? *byte : 0;
+}
+
+uint32_t StandardCodecReader::ReadSize() {
+  const uint8_t byte = ReadByte();
+  if (byte < 254) {
+    return byte;
+  } else if (byte == 254) {
+    return Read<uint16_t>();
+  } else {
+    return Read<uint32_t>();
+  }
+}
+
+void StandardCodecReader::ReadAlignment(size_t alignment) {
+  const size_t mod = position_ % alignment;
+  if (mod) {
+    ReadSpan(alignment - mod);
+  }
+}
+
+void StandardCodecReader::ReadBytes(void* destination, size_t length) {
+  const uint8_t* span = ReadSpan(length);
+  if (span) {
+    memcpy(destination, span, length);
+  } else {
+    memset(destination, 0, length);
+  }
+}
+
+const uint8_t* StandardCodecReader::ReadSpan(size_t length) {
+  if (failed_ || length > length_ - position_) {
+    failed_ = true;
+    return nullptr;
+  }
+  const uint8_t* span = bytes_ + position_;
+  position_ += length;
+  return span;
+}
+
+const uint8_t* StandardCodecReader::ReadTypedArray(size_t element_size,
+                                                   size_t* element_count) {
+  const size_t count = ReadSize();
+  ReadAlignment(element_size);
+  // Guard against counts whose byte length does not fit the remaining buffer
+  // before multiplying.
+  if (failed_ || count > (length_ - position_) / element_size) {
+    failed_ = true;
+    *element_count = 0;
+    return nullptr;
+  }
+  *element_count = count;
+  return ReadSpan(count * element_size);
+}
+
+}  // namespace shell
@@ -0,0 +1,111 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_STANDARD_CODEC_STREAM_H_
+#define FLUTTER_SHELL_COMMON_STANDARD_CODEC_STREAM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <vector>
+
+#include "lib/fxl/macros.h"
+
+namespace shell {
+
+// The wire format of the standard message codec below the level of values.
+// Platform codecs map their value types onto these primitives. The writer and
+// reader work on contiguous buffers and move typed arrays with a single copy.
+
+class StandardCodecWriter {
+ public:
+  // |base_offset| is the number of bytes that precede the output in the final
+  // message. Alignment padding is computed relative to the message start.
+  explicit StandardCodecWriter(size_t base_offset = 0);
+
+  ~StandardCodecWriter();
+
+  const std::vector<uint8_t>& buffer() const { return buffer_; }
+
+  // Clears the buffer and moves the base offset past its contents.
+  void Flush();
+
+  void WriteByte(uint8_t value) { buffer_.push_back(value); }
+
+  void WriteSize(uint32_t size);
+
+  void WriteAlignment(size_t alignment);
+
+  void WriteBytes(const void* bytes, size_t length);
+
+  // Writes the raw bytes of a fixed size value.
+  template <typename T>
+  void Write(T value) {
+    WriteBytes(&value, sizeof(T));
+  }
+
+  // Writes the element count, the alignment padding and then all elements.
+  void WriteTypedArray(const void* elements,
+                       size_t element_count,
+                       size_t element_size);
+
+ private:
+  size_t base_offset_;
+  std::vector<uint8_t> buffer_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(StandardCodecWriter);
+};
+
+// Reads values from a buffer it does not own. Reads past the end of the
+// buffer put the reader in an error state in which all further reads return
+// zeroes.
+class StandardCodecReader {
+ public:
+  StandardCodecReader(const uint8_t* bytes, size_t length);
+
+  ~StandardCodecReader();
+
+  bool HasMore() const { return !failed_ && position_ < length_; }
+
+  bool failed() const { return failed_; }
+
+  size_t position() const { return position_; }
+
+  uint8_t ReadByte();
+
+  uint32_t ReadSize();
+
+  void ReadAlignment(size_t alignment);
+
+  void ReadBytes(void* destination, size_t length);
+
+  template <typename T>
+  T Read() {
+    T value;
+    ReadBytes(&value, sizeof(T));
+    return value;
+  }
+
+  // Returns the next |length| bytes without copying them or nullptr if the
+  // buffer is too short.
+  const uint8_t* ReadSpan(size_t length);
+
+  // Reads the element count and alignment written by
+  // |StandardCodecWriter::WriteTypedArray| and returns the elements without
+  // copying them.
+  const uint8_t* ReadTypedArray(size_t element_size, size_t* element_count);
+
+ private:
+  const uint8_t* bytes_;
+  size_t length_;
+  size_t position_;
+  bool failed_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(StandardCodecReader);
+};
+
+}  // namespace shell
+
+#endif  // FLUTTER_SHELL_COMMON_STANDARD_CODEC_STREAM_H_
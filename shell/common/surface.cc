@@ -3,6 +3,8 @@
 // found in the LICENSE file.
 
 #include "flutter/shell/common/surface.h"
+
+#include "flutter/glue/trace_event.h"
 #include "lib/fxl/logging.h"
 #include "third_party/skia/include/core/SkSurface.h"
 
@@ -10,8 +12,23 @@ namespace shell {
 
 SurfaceFrame::SurfaceFrame(sk_sp<SkSurface> surface,
                            SubmitCallback submit_callback)
-    : submitted_(false), surface_(surface), submit_callback_(submit_callback) {
+    : SurfaceFrame(surface,
+                   surface ? surface->getCanvas() : nullptr,
+                   std::move(submit_callback)) {}
+
+SurfaceFrame::SurfaceFrame(sk_sp<SkSurface> surface,
+                           SkCanvas* canvas,
+                           SubmitCallback submit_callback)
+    : submitted_(false),
+      surface_(surface),
+      canvas_(canvas),
+      submit_callback_(submit_callback) {
   FXL_DCHECK(submit_callback_);
+  const SkIRect bounds =
+      surface_ ? SkIRect::MakeWH(surface_->width(), surface_->height())
+               : SkIRect::MakeEmpty();
+  buffer_damage_ = bounds;
+  frame_damage_ = bounds;
 }
 
 SurfaceFrame::~SurfaceFrame() {
@@ -26,13 +43,19 @@ bool SurfaceFrame::Submit() {
     return false;
   }
 
+  // The submit callback presents the frame, which ends its flow.
+  TRACE_EVENT0("flutter", "SurfaceFrame::Submit");
+  if (frame_number_ != 0) {
+    TRACE_FLOW_END("flutter", "Frame", frame_number_);
+  }
+
   submitted_ = PerformSubmit();
 
   return submitted_;
 }
 
 SkCanvas* SurfaceFrame::SkiaCanvas() {
-  return surface_ != nullptr ? surface_->getCanvas() : nullptr;
+  return canvas_;
 }
 
 sk_sp<SkSurface> SurfaceFrame::SkiaSurface() const {
@@ -55,10 +78,26 @@ Surface::Surface() : scale_(1.0) {}
 
 Surface::~Surface() = default;
 
+bool Surface::MakeRenderContextCurrent() {
+  return true;
+}
+
 bool Surface::SupportsScaling() const {
   return false;
 }
 
+bool Surface::TakeGpuFrameTime(fxl::TimeDelta* time) {
+  return false;
+}
+
+bool Surface::WillReportDisplayTime() const {
+  return false;
+}
+
+bool Surface::TakeDisplayTime(int64_t* frame_number, fxl::TimePoint* time) {
+  return false;
+}
+
 double Surface::GetScale() const {
   return scale_;
 }
@@ -9,6 +9,8 @@
 
 #include "lib/fxl/compiler_specific.h"
 #include "lib/fxl/macros.h"
+#include "lib/fxl/time/time_delta.h"
+#include "lib/fxl/time/time_point.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 
 namespace shell {
@@ -22,6 +24,13 @@ class SurfaceFrame {
 
   SurfaceFrame(sk_sp<SkSurface> surface, SubmitCallback submit_callback);
 
+  // Renders the frame into |canvas| instead of the canvas of |surface|, such
+  // as a recording canvas that the surface plays back when it is submitted.
+  // The canvas must remain valid until the frame is submitted or dropped.
+  SurfaceFrame(sk_sp<SkSurface> surface,
+               SkCanvas* canvas,
+               SubmitCallback submit_callback);
+
   ~SurfaceFrame();
 
   bool Submit();
@@ -30,10 +39,35 @@ class SurfaceFrame {
 
   sk_sp<SkSurface> SkiaSurface() const;
 
+  // The region of the surface (in physical pixels) whose contents are not
+  // known to match the previously submitted frame. Callers that only repaint
+  // what changed since the previous frame must also repaint this region. The
+  // entire surface unless the surface tracks the age of its buffers.
+  const SkIRect& buffer_damage() const { return buffer_damage_; }
+
+  void set_buffer_damage(const SkIRect& damage) { buffer_damage_ = damage; }
+
+  // The region of the frame (in physical pixels) whose contents differ from
+  // the previously submitted frame. Surfaces may use this to only present the
+  // changed region. The entire surface unless specified otherwise.
+  const SkIRect& frame_damage() const { return frame_damage_; }
+
+  void set_frame_damage(const SkIRect& damage) { frame_damage_ = damage; }
+
+  // The number of the frame rendered into this surface frame. Links the
+  // submission to the flow of that frame in traces. Zero if unknown.
+  int64_t frame_number() const { return frame_number_; }
+
+  void set_frame_number(int64_t frame_number) { frame_number_ = frame_number; }
+
  private:
   bool submitted_;
   sk_sp<SkSurface> surface_;
+  SkCanvas* canvas_;
   SubmitCallback submit_callback_;
+  SkIRect buffer_damage_;
+  SkIRect frame_damage_;
+  int64_t frame_number_ = 0;
 
   bool PerformSubmit();
 
@@ -52,8 +86,31 @@ class Surface {
 
   virtual GrContext* GetContext() = 0;
 
+  // Makes the context returned by |GetContext| current on the calling thread
+  // so that its resources may be freed. Surfaces whose contexts need not be
+  // current return true.
+  virtual bool MakeRenderContextCurrent();
+
   virtual bool SupportsScaling() const;
 
+  // Sets |time| to how long the GPU spent on the most recently submitted frame
+  // for which that is known. The GPU time of a frame is only known some frames
+  // after it was submitted. Returns false if the surface does not measure GPU
+  // time or no new measurement completed since the previous call.
+  virtual bool TakeGpuFrameTime(fxl::TimeDelta* time);
+
+  // Whether the display time of the most recently submitted frame is going to
+  // be reported by |TakeDisplayTime|.
+  virtual bool WillReportDisplayTime() const;
+
+  // Sets |frame_number| and |time| to the number of a submitted frame and
+  // when it appeared on the display. |time| is null for frames the display
+  // skipped and frames whose display time could not be learned. Frames are
+  // reported in the order they were submitted, once the platform knows, which
+  // is some frames later. Returns false if no frame became known since the
+  // previous call.
+  virtual bool TakeDisplayTime(int64_t* frame_number, fxl::TimePoint* time);
+
   double GetScale() const;
 
   void SetScale(double scale);
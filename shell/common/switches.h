@@ -27,6 +27,14 @@ DEF_SWITCH(AotVmSnapshotData, "vm-snapshot-data", "")
 DEF_SWITCH(AotVmSnapshotInstructions, "vm-snapshot-instr", "")
 DEF_SWITCH(AotIsolateSnapshotData, "isolate-snapshot-data", "")
 DEF_SWITCH(AotIsolateSnapshotInstructions, "isolate-snapshot-instr", "")
+DEF_SWITCH(RecordSnapshotPageProfile,
+           "record-snapshot-page-profile",
+           "Write the ranges of the AOT isolate instructions that were paged "
+           "in by the time the first frame was rendered to the given path. "
+           "Placed next to the instructions with the extension .pages, the "
+           "profile makes later launches read those pages ahead instead of "
+           "faulting them in one by one. Record after dropping the page "
+           "cache. Android only.")
 DEF_SWITCH(CacheDirPath, "cache-dir-path", "Path to the cache directory.")
 DEF_SWITCH(DartFlags,
            "dart-flags",
@@ -39,6 +47,12 @@ DEF_SWITCH(DisableObservatory,
            "disable-observatory",
            "Disable the Dart Observatory. The observatory is never available "
            "in release mode.")
+DEF_SWITCH(LazyServiceIsolate,
+           "lazy-service-isolate",
+           "Start the service isolate, and with it the observatory, only once "
+           "the first frame has been rendered, or a few seconds after launch "
+           "if none is. This makes the startup of profile builds closer to "
+           "that of release builds.")
 DEF_SWITCH(DeviceDiagnosticPort,
            "diagnostic-port",
            "A custom diagnostic server port.")
@@ -50,10 +64,37 @@ DEF_SWITCH(IPv6,
            "ipv6",
            "Bind to the IPv6 localhost address for the Dart Observatory and "
            "the diagnostic server.")
+DEF_SWITCH(DisableHardwareImageBuffers,
+           "disable-hardware-image-buffers",
+           "Upload decoded images as textures instead of decoding them into "
+           "AHardwareBuffers or IOSurfaces.")
+DEF_SWITCH(DisableThreadPriorities,
+           "disable-thread-priorities",
+           "Leave the UI, GPU and IO threads at the default scheduling "
+           "priority. By default, the UI and GPU threads run at display "
+           "priority and the IO thread runs at background priority.")
+DEF_SWITCH(MergeUIAndGPUThreads,
+           "merge-ui-and-gpu-threads",
+           "Run the GPU tasks on the UI thread instead of a thread of their "
+           "own, and rasterize each frame right after it is built. For "
+           "devices with few cores, where the hand-off between the threads "
+           "costs more than the parallelism buys.")
 DEF_SWITCH(EnableDartProfiling,
            "enable-dart-profiling",
            "Enable Dart profiling. Profiling information can be viewed from "
            "the observatory.")
+DEF_SWITCH(ShareIsolateProgram,
+           "share-isolate-program",
+           "Read the kernel program of the bundle once and load the secondary "
+           "isolates spawned from it from the program already read, instead "
+           "of mapping and reading the kernel again for every isolate. This "
+           "makes spawning compute isolates cheaper.")
+DEF_SWITCH(IsolatePoolSize,
+           "isolate-pool-size",
+           "The number of worker isolates the root isolate keeps created and "
+           "loaded on background threads, so that Isolate.spawn hands one out "
+           "immediately instead of creating it. Defaults to zero, which "
+           "creates each isolate when it is spawned.")
 DEF_SWITCH(EndlessTraceBuffer,
            "endless-trace-buffer",
            "Enable an endless trace buffer. The default is a ring buffer. "
@@ -65,11 +106,86 @@ DEF_SWITCH(EnableSoftwareRendering,
            "Enable rendering using the Skia software backend. This is useful"
            "when testing Flutter on emulators. By default, Flutter will"
            "attempt to either use OpenGL or Vulkan.")
+DEF_SWITCH(EnableTiledSoftwareRendering,
+           "enable-tiled-software-rendering",
+           "When rendering with the Skia software backend, record each frame "
+           "and rasterize it in horizontal tiles concurrently on the worker "
+           "threads. This has no effect without "
+           "--enable-software-rendering.")
+DEF_SWITCH(EnableFramePacing,
+           "enable-frame-pacing",
+           "Measure how long recent frames took to build and rasterize and "
+           "start building each frame as late after vsync as possible while "
+           "still meeting its deadline. This reduces the latency between "
+           "input and the frame that reflects it.")
+DEF_SWITCH(ThrottleIdleFrames,
+           "throttle-idle-frames",
+           "Once several frames in a row did not render anything, begin the "
+           "frames requested next only every few vsyncs until one renders "
+           "again or pointer input arrives. This saves power on screens that "
+           "keep requesting frames without changing.")
+DEF_SWITCH(FrameRateDivisor,
+           "frame-rate-divisor",
+           "Begin frames only on every this many vsyncs, such as 2 for 30 fps "
+           "on a 60Hz display, to save power. Animations keep their pace. By "
+           "default, frames may begin on every vsync.")
+DEF_SWITCH(EnableLayerTreeDiffing,
+           "enable-layer-tree-diffing",
+           "Retain the previously rasterized layer tree and compare it with "
+           "each new one to compute the region of the frame that changed. "
+           "Frames in which nothing changed are not rasterized.")
+DEF_SWITCH(EnablePointerCoalescing,
+           "enable-pointer-coalescing",
+           "Queue pointer move and hover events and dispatch them to Dart in a "
+           "single packet at the start of the next frame. Other pointer "
+           "events are dispatched immediately along with the queued ones.")
+DEF_SWITCH(EnablePointerResampling,
+           "enable-pointer-resampling",
+           "Replace the queued moves of each pointer with a single move "
+           "interpolated to shortly before the frame time. Implies "
+           "--enable-pointer-coalescing.")
+DEF_SWITCH(EnableTripleBuffering,
+           "enable-triple-buffering",
+           "Allow the UI thread to produce up to three frames ahead of the GPU "
+           "thread instead of two. This trades an additional frame of latency "
+           "for fewer skipped frames when the GPU stalls intermittently. "
+           "Equivalent to --layer-tree-pipeline-depth=3.")
+DEF_SWITCH(EnableTraceRecorder,
+           "enable-trace-recorder",
+           "Keep the most recent trace events of each thread in memory, "
+           "independently of the Dart timeline. This is cheap enough to leave "
+           "on in release mode. The events of the last seconds are written "
+           "out along with the frames captured by the rasterizer tracing "
+           "threshold.")
 DEF_SWITCH(EnableTxt,
            "enable-txt",
            "Enable libtxt as the text shaping library instead of Blink.")
 DEF_SWITCH(FLX, "flx", "Specify the FLX path.")
 DEF_SWITCH(Help, "help", "Display this help text.")
+DEF_SWITCH(GpuResourceCacheMaxMegabytes,
+           "gpu-resource-cache-max-mb",
+           "The amount of memory, in megabytes, that Skia may use to cache GPU "
+           "resources for the rasterizer. Defaults to 512.")
+DEF_SWITCH(ImageUploadMaxKilobytesPerFrame,
+           "image-upload-max-kb-per-frame",
+           "The amount of decoded image data, in kilobytes, that may be "
+           "uploaded to the GPU per frame interval. Further uploads wait for "
+           "the next interval. By default, images are uploaded as soon as "
+           "they are decoded.")
+DEF_SWITCH(EnableImageAtlas,
+           "enable-image-atlas",
+           "Pack images of up to 128x128 pixels decoded by decodeImageFromList "
+           "into shared textures, so that their draws can be batched.")
+DEF_SWITCH(LayerTreePipelineDepth,
+           "layer-tree-pipeline-depth",
+           "The number of frames the UI thread may produce ahead of the GPU "
+           "thread. Defaults to 2.")
+DEF_SWITCH(JsonPlatformMessageChannels,
+           "json-platform-message-channels",
+           "A comma-separated list of platform channels whose messages are "
+           "UTF-8 encoded JSON. Their messages are parsed on the IO thread "
+           "and handed to Window.onJsonPlatformMessage already decoded, so "
+           "that large messages do not stall the UI thread.")
 DEF_SWITCH(LogTag, "log-tag", "Tag associated with log messages.")
 DEF_SWITCH(MainDartFile, "dart-main", "The path to the main Dart file.")
 DEF_SWITCH(NonInteractive,
@@ -90,6 +206,16 @@ DEF_SWITCH(TraceSkia,
            "Trace Skia calls. This is useful when debugging the GPU threed."
            "By default, Skia tracing is not enable to reduce the number of "
            "traced events")
+DEF_SWITCH(SkiaTraceCategories,
+           "skia-trace-categories",
+           "A comma separated list of the Skia trace categories, such as "
+           "skia.gpu, to trace when Skia calls are traced. By default, all "
+           "categories are traced.")
+DEF_SWITCH(SkiaTraceFrameInterval,
+           "skia-trace-frame-interval",
+           "When Skia calls are traced, only trace those of every Nth frame "
+           "so that the traced frames stay representative of untraced ones. "
+           "By default, the calls of every frame are traced.")
 DEF_SWITCH(UseTestFonts,
            "use-test-fonts",
            "Running tests that layout and measure text will not yield "
@@ -97,6 +223,134 @@ DEF_SWITCH(UseTestFonts,
            "will make font resolution default to the Ahem test font on all "
            "platforms (See https://www.w3.org/Style/CSS/Test/Fonts/Ahem/). "
            "This option is only available on the desktop test shells.")
+DEF_SWITCH(RasterCacheMaxMegabytes,
+           "raster-cache-max-mb",
+           "The amount of memory, in megabytes, that rasterized pictures may "
+           "occupy in the raster cache. Unused entries are retained until "
+           "this budget is exceeded. By default, entries are evicted as soon "
+           "as they go unused for a single frame.")
+DEF_SWITCH(RasterCacheDeferredPopulation,
+           "raster-cache-deferred-population",
+           "Rasterize pictures admitted into the raster cache in the idle time "
+           "after a frame has been presented instead of while that frame is "
+           "being drawn. The pictures are drawn directly until their cached "
+           "images are available.")
+DEF_SWITCH(RasterCacheConcurrentPopulation,
+           "raster-cache-concurrent-population",
+           "Rasterize pictures admitted into the raster cache on worker "
+           "threads and upload the results on the GPU thread. Implies "
+           "--raster-cache-deferred-population.")
+DEF_SWITCH(RasterCacheRGB565,
+           "raster-cache-rgb565",
+           "Rasterize pictures admitted into the raster cache that are found "
+           "to be opaque into 16 bit 565 images where the destination has no "
+           "color space. This halves the memory and bandwidth they use at the "
+           "cost of banding in gradients.")
+DEF_SWITCH(RasterCacheScaleBucketsPerOctave,
+           "raster-cache-scale-buckets-per-octave",
+           "Rasterize raster cache entries at this many scales for each "
+           "power of two, picking the next one up from the scale they are "
+           "drawn at. Zoom animations then reuse entries instead of "
+           "rasterizing pictures again on every frame. 2 gives buckets a "
+           "square root of two apart. By default, entries are rasterized at "
+           "the exact scale.")
+DEF_SWITCH(ConcurrentTextLayout,
+           "concurrent-text-layout",
+           "Break and shape the newline-delimited blocks of long paragraphs "
+           "concurrently on the worker threads.")
+DEF_SWITCH(TextLayoutCacheMaxEntries,
+           "text-layout-cache-max-entries",
+           "The number of shaped words the text layout cache may keep. Zero "
+           "keeps all of them. Defaults to 5000.")
+DEF_SWITCH(TextFontCacheMaxEntries,
+           "text-font-cache-max-entries",
+           "The number of fonts that text layout may keep ready for shaping. "
+           "Apps using many fonts may want to raise this. Zero keeps all of "
+           "them. Defaults to 100.")
+DEF_SWITCH(PersistentTextLayoutCache,
+           "persistent-text-layout-cache",
+           "Keep shaped words in a file in the temporary directory so that the "
+           "text of the first frames of later launches is not shaped again. "
+           "At most --text-layout-cache-max-entries words are kept.")
+DEF_SWITCH(HyphenationPatternsPath,
+           "hyphenation-patterns-path",
+           "The directory of the hyph-<locale>.hyb hyphenation pattern files, "
+           "such as /system/usr/hyphen-data on Android. When specified, text "
+           "is hyphenated in the locale of the window. The patterns of a "
+           "locale are mapped the first time text in it is laid out.")
+DEF_SWITCH(PersistentGpuCache,
+           "persistent-gpu-cache",
+           "Keep the shader programs and pipelines compiled for the GPU in "
+           "files in the temporary directory so that later launches do not "
+           "compile them again. The files are discarded when the GPU driver "
+           "changes.")
+DEF_SWITCH(EnableVulkanMailboxPresentMode,
+           "enable-vulkan-mailbox-present-mode",
+           "Present Vulkan swapchain images in mailbox mode where the surface "
+           "supports it, so that the GPU thread does not block acquiring an "
+           "image while the previous one waits to be displayed.")
+DEF_SWITCH(EnableMetal,
+           "enable-metal",
+           "Render with Metal instead of OpenGL ES on iOS devices that support "
+           "it. This has no effect unless the engine was built with Metal "
+           "support.")
+DEF_SWITCH(EnableGpuTimerQueries,
+           "enable-gpu-timer-queries",
+           "Measure how long the GPU spends on each frame using GL timer "
+           "queries or Vulkan timestamps where they are supported. The GPU "
+           "times are shown in the performance overlay and traced.")
+DEF_SWITCH(EnableLegacyColorRendering,
+           "enable-legacy-color-rendering",
+           "When the GL surface does not support sRGB, render directly to the "
+           "onscreen framebuffer without color management rather than to an "
+           "offscreen surface that is copied onscreen each frame. Saves a "
+           "full-screen read and write per frame on low-end GPUs at the cost "
+           "of colors that differ from color managed devices.")
+DEF_SWITCH(DynamicResolutionMinScale,
+           "dynamic-resolution-min-scale",
+           "While frames keep missing their budget, render them at a lower "
+           "scale, down to this one, and upscale them when they are "
+           "presented. The scale returns to full once the load drops. Only "
+           "applies to surfaces that support scaling. By default, frames are "
+           "always rendered at full scale.")
+DEF_SWITCH(FrameStatisticsInterval,
+           "frame-statistics-interval",
+           "Aggregate frame time histograms, janky frame counts, the raster "
+           "cache hit rate and the peak GPU memory of the frames presented "
+           "every this many seconds and log them, without enabling tracing. "
+           "By default, frame statistics are not collected.")
+DEF_SWITCH(BenchmarkMode,
+           "benchmark-mode",
+           "Pace frames independently of the display so that benchmarks are "
+           "reproducible. Frames are given synthetic frame times that advance "
+           "by a fixed interval, and the build and raster times of each frame "
+           "are recorded to a CSV file.")
+DEF_SWITCH(BenchmarkFrameInterval,
+           "benchmark-frame-interval",
+           "In benchmark mode, begin frames at this fixed cadence, in "
+           "microseconds. By default, each frame begins as soon as the GPU "
+           "thread is done with the previous ones.")
+DEF_SWITCH(BenchmarkOutput,
+           "benchmark-output",
+           "In benchmark mode, the path of the CSV file frames are recorded "
+           "to. Defaults to benchmark_frames.csv in the temporary directory.")
+DEF_SWITCH(ShaderWarmupPictures,
+           "shader-warmup-pictures",
+           "A comma separated list of paths to serialized SkPictures. They "
+           "are drawn offscreen with the onscreen GPU context before the "
+           "first frame, so that the shader programs they use are compiled "
+           "during the splash screen instead of in the frames that first "
+           "draw similar content.")
+DEF_SWITCH(AssetCacheMaxMegabytes,
+           "asset-cache-max-mb",
+           "The amount of memory, in megabytes, that the asset bundle may use "
+           "to keep compressed assets inflated, so that assets read again, "
+           "such as fonts, are not inflated again. By default, nothing is "
+           "kept.")
+DEF_SWITCH(ResourceContextCacheMaxMegabytes,
+           "resource-context-cache-max-mb",
+           "The amount of memory, in megabytes, that Skia may use to cache GPU "
+           "resources for image uploads. By default, nothing is cached.")
 DEF_SWITCH(RunForever,
            "run-forever",
            "In non-interactive mode, keep the shell running after the Dart "
@@ -7,12 +7,19 @@
 
 #include <functional>
 
+#include "lib/fxl/time/time_delta.h"
 #include "lib/fxl/time/time_point.h"
 
 namespace shell {
 
+// The refresh interval assumed for displays whose actual one is not known.
+constexpr fxl::TimeDelta kDefaultRefreshInterval =
+    fxl::TimeDelta::FromSecondsF(1.0 / 60.0);
+
 class VsyncWaiter {
  public:
+  // The target time is the start time plus the refresh interval of the
+  // display, so that frame deadlines and budgets follow its refresh rate.
   using Callback = std::function<void(fxl::TimePoint frame_start_time,
                                       fxl::TimePoint frame_target_time)>;
 
@@ -0,0 +1,87 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/vsync_waiter_benchmark.h"
+
+#include "flutter/common/threads.h"
+#include "flutter/fml/task_priority.h"
+#include "lib/fxl/logging.h"
+
+namespace shell {
+
+VsyncWaiterBenchmark::VsyncWaiterBenchmark(fxl::TimeDelta cadence)
+    : cadence_(cadence),
+      origin_(fxl::TimePoint::Now()),
+      frame_count_(0),
+      frames_in_flight_(0),
+      weak_factory_(this) {}
+
+VsyncWaiterBenchmark::~VsyncWaiterBenchmark() = default;
+
+void VsyncWaiterBenchmark::AsyncWaitForVsync(Callback callback) {
+  FXL_DCHECK(!callback_);
+  callback_ = std::move(callback);
+
+  if (cadence_ <= fxl::TimeDelta::Zero()) {
+    MaybeFire();
+    return;
+  }
+
+  // The ticks keep their phase so that a slow frame does not shift the ones
+  // after it.
+  const fxl::TimeDelta delay =
+      cadence_ - (fxl::TimePoint::Now() - origin_) % cadence_;
+
+  fml::ScopedTaskPriority priority(fml::TaskPriority::kFrameCritical);
+  blink::Threads::UI()->PostDelayedTask(
+      [self = weak_factory_.GetWeakPtr()]() {
+        if (self)
+          self->Fire();
+      },
+      delay);
+}
+
+void VsyncWaiterBenchmark::OnFrameSubmitted() {
+  frames_in_flight_++;
+}
+
+void VsyncWaiterBenchmark::OnFrameCompleted() {
+  if (frames_in_flight_ > 0)
+    frames_in_flight_--;
+  if (cadence_ <= fxl::TimeDelta::Zero())
+    MaybeFire();
+}
+
+void VsyncWaiterBenchmark::MaybeFire() {
+  if (!callback_ || frames_in_flight_ > 0)
+    return;
+
+  // Fire from a fresh task, as the platform waiters do, rather than from
+  // within the caller.
+  fml::ScopedTaskPriority priority(fml::TaskPriority::kFrameCritical);
+  blink::Threads::UI()->PostTask([self = weak_factory_.GetWeakPtr()]() {
+    if (self)
+      self->Fire();
+  });
+}
+
+void VsyncWaiterBenchmark::Fire() {
+  if (!callback_)
+    return;
+  if (cadence_ <= fxl::TimeDelta::Zero() && frames_in_flight_ > 0)
+    return;
+
+  const fxl::TimeDelta interval =
+      cadence_ > fxl::TimeDelta::Zero() ? cadence_ : kDefaultRefreshInterval;
+  const fxl::TimePoint frame_time =
+      origin_ + fxl::TimeDelta::FromMicroseconds(interval.ToMicroseconds() *
+                                                 frame_count_);
+  frame_count_++;
+
+  Callback callback = std::move(callback_);
+  callback_ = Callback();
+  callback(frame_time, frame_time + interval);
+}
+
+}  // namespace shell
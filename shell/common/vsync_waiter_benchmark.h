@@ -0,0 +1,60 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_VSYNC_WAITER_BENCHMARK_H_
+#define FLUTTER_SHELL_COMMON_VSYNC_WAITER_BENCHMARK_H_
+
+#include <stddef.h>
+
+#include "flutter/shell/common/vsync_waiter.h"
+#include "lib/fxl/macros.h"
+#include "lib/fxl/memory/weak_ptr.h"
+#include "lib/fxl/time/time_delta.h"
+#include "lib/fxl/time/time_point.h"
+
+namespace shell {
+
+// Paces frames independently of the display for benchmarks. Frame N starts at
+// the synthetic time of the first frame plus N intervals, however long frames
+// actually take, so that animations advance the same way on every run.
+//
+// Without a |cadence|, each frame begins as soon as the GPU thread is done
+// with the frames submitted before it. Otherwise, frames begin at that fixed
+// cadence of real time. Only used on the UI thread.
+class VsyncWaiterBenchmark : public VsyncWaiter {
+ public:
+  explicit VsyncWaiterBenchmark(fxl::TimeDelta cadence);
+
+  ~VsyncWaiterBenchmark() override;
+
+  // |shell::VsyncWaiter|
+  void AsyncWaitForVsync(Callback callback) override;
+
+  // Called when a frame has been handed to the GPU thread.
+  void OnFrameSubmitted();
+
+  // Called when the GPU thread is done with a submitted frame.
+  void OnFrameCompleted();
+
+ private:
+  // Zero paces frames by their completion.
+  const fxl::TimeDelta cadence_;
+  const fxl::TimePoint origin_;
+  size_t frame_count_;
+  size_t frames_in_flight_;
+  Callback callback_;
+
+  fxl::WeakPtrFactory<VsyncWaiterBenchmark> weak_factory_;
+
+  // Posts the pending callback if the frames before it are done.
+  void MaybeFire();
+
+  void Fire();
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(VsyncWaiterBenchmark);
+};
+
+}  // namespace shell
+
+#endif  // FLUTTER_SHELL_COMMON_VSYNC_WAITER_BENCHMARK_H_
@@ -5,6 +5,7 @@
 #include "flutter/shell/common/vsync_waiter_fallback.h"
 
 #include "flutter/common/threads.h"
+#include "flutter/fml/task_priority.h"
 #include "lib/fxl/logging.h"
 
 namespace shell {
@@ -21,20 +22,19 @@ fxl::TimePoint SnapToNextTick(fxl::TimePoint value,
 
 }  // namespace
 
-VsyncWaiterFallback::VsyncWaiterFallback()
-    : phase_(fxl::TimePoint::Now()), weak_factory_(this) {}
+VsyncWaiterFallback::VsyncWaiterFallback(fxl::TimeDelta interval)
+    : interval_(interval), phase_(fxl::TimePoint::Now()), weak_factory_(this) {}
 
 VsyncWaiterFallback::~VsyncWaiterFallback() = default;
 
-constexpr fxl::TimeDelta interval = fxl::TimeDelta::FromSecondsF(1.0 / 60.0);
-
 void VsyncWaiterFallback::AsyncWaitForVsync(Callback callback) {
   FXL_DCHECK(!callback_);
   callback_ = std::move(callback);
 
   fxl::TimePoint now = fxl::TimePoint::Now();
-  fxl::TimePoint next = SnapToNextTick(now, phase_, interval);
+  fxl::TimePoint next = SnapToNextTick(now, phase_, interval_);
 
+  fml::ScopedTaskPriority priority(fml::TaskPriority::kFrameCritical);
   blink::Threads::UI()->PostDelayedTask(
       [self = weak_factory_.GetWeakPtr()] {
         if (!self)
@@ -42,7 +42,7 @@ void VsyncWaiterFallback::AsyncWaitForVsync(Callback callback) {
         fxl::TimePoint frame_time = fxl::TimePoint::Now();
         Callback callback = std::move(self->callback_);
         self->callback_ = Callback();
-        callback(frame_time, frame_time + interval);
+        callback(frame_time, frame_time + self->interval_);
       },
       next - now);
 }
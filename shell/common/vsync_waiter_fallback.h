@@ -14,12 +14,14 @@ namespace shell {
 
 class VsyncWaiterFallback : public VsyncWaiter {
  public:
-  VsyncWaiterFallback();
+  explicit VsyncWaiterFallback(
+      fxl::TimeDelta interval = kDefaultRefreshInterval);
   ~VsyncWaiterFallback() override;
 
   void AsyncWaitForVsync(Callback callback) override;
 
  private:
+  const fxl::TimeDelta interval_;
   fxl::TimePoint phase_;
   Callback callback_;
 
@@ -0,0 +1,77 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/gpu/dynamic_resolution_governor.h"
+
+#include <algorithm>
+
+namespace shell {
+namespace {
+
+// The change of the scale in each step.
+constexpr double kScaleStep = 0.125;
+
+// The scale is lowered after this many consecutive frames missed the budget,
+// and raised after this many consecutive frames would have fit the budget at
+// the higher scale. Raising it waits longer so that the scale does not
+// oscillate.
+constexpr int kSlowFramesBeforeDownscale = 6;
+constexpr int kFastFramesBeforeUpscale = 60;
+
+// The share of the budget a frame has to fit at the higher scale to count
+// towards raising the scale.
+constexpr double kUpscaleHeadroom = 0.8;
+
+}  // namespace
+
+DynamicResolutionGovernor::DynamicResolutionGovernor(double min_scale)
+    : min_scale_(std::min(std::max(min_scale, kScaleStep), 1.0)),
+      scale_(1.0),
+      slow_frame_count_(0),
+      fast_frame_count_(0) {}
+
+DynamicResolutionGovernor::~DynamicResolutionGovernor() = default;
+
+double DynamicResolutionGovernor::AddFrame(fxl::TimeDelta frame_time,
+                                           fxl::TimeDelta budget) {
+  if (budget <= fxl::TimeDelta::Zero()) {
+    return scale_;
+  }
+
+  // The time of a frame mostly grows with the number of pixels, which is the
+  // square of the scale.
+  const double higher_scale = std::min(scale_ + kScaleStep, 1.0);
+  const double higher_scale_ratio = higher_scale / scale_;
+  const double estimated_higher_scale_time = frame_time.ToSecondsF() *
+                                             higher_scale_ratio *
+                                             higher_scale_ratio;
+
+  if (frame_time > budget) {
+    fast_frame_count_ = 0;
+    if (++slow_frame_count_ >= kSlowFramesBeforeDownscale) {
+      slow_frame_count_ = 0;
+      scale_ = std::max(scale_ - kScaleStep, min_scale_);
+    }
+  } else if (scale_ < 1.0 && estimated_higher_scale_time <
+                                 budget.ToSecondsF() * kUpscaleHeadroom) {
+    slow_frame_count_ = 0;
+    if (++fast_frame_count_ >= kFastFramesBeforeUpscale) {
+      fast_frame_count_ = 0;
+      scale_ = higher_scale;
+    }
+  } else {
+    slow_frame_count_ = 0;
+    fast_frame_count_ = 0;
+  }
+
+  return scale_;
+}
+
+void DynamicResolutionGovernor::Reset() {
+  scale_ = 1.0;
+  slow_frame_count_ = 0;
+  fast_frame_count_ = 0;
+}
+
+}  // namespace shell
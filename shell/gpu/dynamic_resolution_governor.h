@@ -0,0 +1,46 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_GPU_DYNAMIC_RESOLUTION_GOVERNOR_H_
+#define FLUTTER_SHELL_GPU_DYNAMIC_RESOLUTION_GOVERNOR_H_
+
+#include "lib/fxl/macros.h"
+#include "lib/fxl/time/time_delta.h"
+
+namespace shell {
+
+// Picks the scale at which frames are rendered from how long the previous
+// frames took. The scale is lowered in steps while frames keep missing their
+// budget and raised again once the frames would fit the budget at the higher
+// scale, so that a weak GPU renders fewer pixels rather than fewer frames.
+class DynamicResolutionGovernor {
+ public:
+  // Scales are kept between |min_scale| and 1.
+  explicit DynamicResolutionGovernor(double min_scale);
+
+  ~DynamicResolutionGovernor();
+
+  double scale() const { return scale_; }
+
+  // Records how long a frame rendered at the current scale took and returns
+  // the scale the next frame should be rendered at.
+  double AddFrame(fxl::TimeDelta frame_time, fxl::TimeDelta budget);
+
+  // Returns to rendering at full scale, such as when the surface changes.
+  void Reset();
+
+ private:
+  const double min_scale_;
+  double scale_;
+  // The number of consecutive frames that missed the budget or that would
+  // have fit it at the next higher scale.
+  int slow_frame_count_;
+  int fast_frame_count_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(DynamicResolutionGovernor);
+};
+
+}  // namespace shell
+
+#endif  // FLUTTER_SHELL_GPU_DYNAMIC_RESOLUTION_GOVERNOR_H_
@@ -7,17 +7,98 @@
 #include <string>
 #include <utility>
 
+#include "flutter/common/runtime_settings.h"
+#include "flutter/common/settings.h"
 #include "flutter/common/threads.h"
+#include "flutter/flow/instrumentation.h"
+#include "flutter/fml/task_priority.h"
+#include "flutter/fml/trace_recorder.h"
 #include "flutter/glue/trace_event.h"
+#include "flutter/lib/ui/painting/resource_context.h"
+#include "flutter/runtime/start_up.h"
+#include "flutter/shell/common/memory_usage.h"
 #include "flutter/shell/common/picture_serializer.h"
 #include "flutter/shell/common/platform_view.h"
+#include "flutter/shell/common/shader_warmup.h"
 #include "flutter/shell/common/shell.h"
+#include "flutter/shell/common/skia_event_tracer_impl.h"
+#include "flutter/shell/common/vsync_waiter.h"
+#include "lib/fxl/files/directory.h"
+#include "lib/fxl/files/file.h"
+#include "lib/fxl/files/path.h"
+#include "lib/fxl/logging.h"
+#include "third_party/dart/runtime/include/dart_tools_api.h"
 #include "third_party/skia/include/core/SkPicture.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/core/SkSurface.h"
 
 namespace shell {
 
+// The amount of time spent populating deferred raster cache entries after a
+// frame has been presented.
+static constexpr fxl::TimeDelta kRasterCachePopulationBudget =
+    fxl::TimeDelta::FromMilliseconds(4);
+
+// The number of slow frames whose pictures are kept. Later captures replace
+// the oldest ones.
+static constexpr size_t kMaxSlowFrameCaptures = 10;
+
+// The time before a slow frame whose recorded trace events are written out
+// with it.
+static constexpr fxl::TimeDelta kSlowFrameTraceDuration =
+    fxl::TimeDelta::FromSeconds(2);
+
+// Frame timing records are reported once this many have been collected or
+// once the oldest unreported record is this old, whichever happens first.
+static constexpr size_t kFrameTimingsBatchSize = 60;
+static constexpr fxl::TimeDelta kFrameTimingsReportInterval =
+    fxl::TimeDelta::FromMilliseconds(1000);
+
+// How often the display times of presented frames are collected while no
+// frames are being drawn, and how long a frame waits for its display time
+// before it is recorded without one.
+static constexpr fxl::TimeDelta kDisplayTimePollInterval =
+    fxl::TimeDelta::FromMilliseconds(50);
+static constexpr fxl::TimeDelta kDisplayTimeTimeout =
+    fxl::TimeDelta::FromMilliseconds(500);
+
+// How often the memory usage of each subsystem is traced while frames are
+// drawn.
+static constexpr fxl::TimeDelta kMemoryUsageTraceInterval =
+    fxl::TimeDelta::FromSeconds(1);
+
 GPURasterizer::GPURasterizer(std::unique_ptr<flow::ProcessInfo> info)
-    : compositor_context_(std::move(info)), weak_factory_(this) {
+    : surface_suspended_(false),
+      compositor_context_(std::move(info)),
+      enable_layer_tree_diffing_(false),
+      display_time_poll_scheduled_(false),
+      shader_warmup_pictures_read_(false),
+      slow_frame_capture_count_(0),
+      io_resource_cache_bytes_(0),
+      weak_factory_(this) {
+  const blink::Settings& settings = blink::Settings::Get();
+  const blink::RuntimeSettings runtime_settings = blink::RuntimeSettings::Get();
+  enable_layer_tree_diffing_ = runtime_settings.enable_layer_tree_diffing;
+  compositor_context_.SetRasterCacheMaxBytes(
+      runtime_settings.raster_cache_max_bytes);
+  compositor_context_.raster_cache().SetThreshold(
+      runtime_settings.raster_cache_threshold);
+  const bool concurrent_population =
+      settings.raster_cache_concurrent_population && blink::Threads::Worker();
+  compositor_context_.raster_cache().SetDeferredPopulation(
+      settings.raster_cache_deferred_population || concurrent_population);
+  compositor_context_.raster_cache().SetAllowRGB565(
+      settings.raster_cache_rgb565);
+  compositor_context_.raster_cache().SetScaleBucketsPerOctave(
+      settings.raster_cache_scale_buckets_per_octave);
+  if (concurrent_population) {
+    compositor_context_.raster_cache().SetWorkerTaskRunner(
+        blink::Threads::Worker());
+  }
+  if (settings.dynamic_resolution_min_scale < 1.0) {
+    resolution_governor_ = std::make_unique<DynamicResolutionGovernor>(
+        settings.dynamic_resolution_min_scale);
+  }
   auto weak_ptr = weak_factory_.GetWeakPtr();
   blink::Threads::Gpu()->PostTask(
       [weak_ptr]() { Shell::Shared().AddRasterizer(weak_ptr); });
@@ -36,14 +117,55 @@ void GPURasterizer::Setup(std::unique_ptr<Surface> surface,
                           fxl::Closure continuation,
                           fxl::AutoResetWaitableEvent* setup_completion_event) {
   surface_ = std::move(surface);
+  surface_suspended_ = false;
+  compositor_context_.OnGrContextCreated();
+  if (resolution_governor_) {
+    resolution_governor_->Reset();
+  }
+
+  WarmUpShaders();
 
   continuation();
 
   setup_completion_event->Signal();
 }
 
-void GPURasterizer::Clear(SkColor color, const SkISize& size) {
+void GPURasterizer::WarmUpShaders() {
+  const auto& paths = blink::Settings::Get().shader_warmup_picture_paths;
+  if (paths.empty() || !surface_ || !surface_->GetContext() ||
+      !surface_->MakeRenderContextCurrent()) {
+    return;
+  }
+
+  // Each surface has a new context that has not compiled anything yet. The
+  // pictures are read once and kept for the surfaces created later.
+  if (!shader_warmup_pictures_read_) {
+    shader_warmup_pictures_ = ReadSerializedPictures(paths);
+    shader_warmup_pictures_read_ = true;
+  }
+
+  shell::WarmUpShaders(surface_->GetContext(), shader_warmup_pictures_);
+}
+
+bool GPURasterizer::Suspend() {
   if (surface_ == nullptr) {
+    return false;
+  }
+
+  surface_suspended_ = true;
+  // The next window starts out blank, so the next frame must be painted
+  // entirely even if nothing changed.
+  last_layer_tree_.reset();
+  return true;
+}
+
+void GPURasterizer::Resume(fxl::Closure continuation) {
+  surface_suspended_ = false;
+  continuation();
+}
+
+void GPURasterizer::Clear(SkColor color, const SkISize& size) {
+  if (surface_ == nullptr || surface_suspended_) {
     return;
   }
 
@@ -66,9 +188,11 @@ void GPURasterizer::Clear(SkColor color, const SkISize& size) {
 
 void GPURasterizer::Teardown(
     fxl::AutoResetWaitableEvent* teardown_completion_event) {
+  RecordFramesAwaitingDisplay();
   if (surface_) {
     surface_.reset();
   }
+  surface_suspended_ = false;
   last_layer_tree_.reset();
   compositor_context_.OnGrContextDestroyed();
   teardown_completion_event->Signal();
@@ -78,6 +202,47 @@ flow::LayerTree* GPURasterizer::GetLastLayerTree() {
   return last_layer_tree_.get();
 }
 
+std::vector<flow::LayerProfiler::Entry> GPURasterizer::ProfileLastLayerTree(
+    bool synchronize,
+    size_t count) {
+  if (!last_layer_tree_) {
+    return {};
+  }
+
+  // Paint with the context of the surface where possible so that the GPU
+  // time of the layers is representative.
+  GrContext* context = nullptr;
+  if (surface_ && surface_->GetContext() &&
+      surface_->MakeRenderContextCurrent()) {
+    context = surface_->GetContext();
+  }
+
+  const SkISize& frame_size = last_layer_tree_->frame_size();
+  const SkImageInfo info =
+      SkImageInfo::MakeN32Premul(frame_size.width(), frame_size.height());
+  sk_sp<SkSurface> surface =
+      context ? SkSurface::MakeRenderTarget(context, SkBudgeted::kNo, info)
+              : SkSurface::MakeRaster(info);
+  if (!surface) {
+    return {};
+  }
+
+  // A separate compositor context keeps the raster cache of onscreen frames
+  // untouched. The raster cache is not used so that every layer is painted.
+  flow::CompositorContext compositor_context(nullptr);
+  SkCanvas* canvas = surface->getCanvas();
+  flow::LayerProfiler profiler(canvas, synchronize);
+  {
+    flow::CompositorContext::ScopedFrame frame =
+        compositor_context.AcquireFrame(context, canvas, false);
+    canvas->clear(SK_ColorTRANSPARENT);
+    last_layer_tree_->Preroll(frame, true);
+    last_layer_tree_->Paint(frame, &profiler);
+    canvas->flush();
+  }
+  return profiler.GetMostExpensiveLayers(count);
+}
+
 void GPURasterizer::Draw(
     fxl::RefPtr<flutter::Pipeline<flow::LayerTree>> pipeline) {
   TRACE_EVENT0("flutter", "GPURasterizer::Draw");
@@ -90,6 +255,7 @@ void GPURasterizer::Draw(
   switch (pipeline->Consume(consumer)) {
     case flutter::PipelineConsumeResult::MoreAvailable: {
       auto weak_this = weak_factory_.GetWeakPtr();
+      fml::ScopedTaskPriority priority(fml::TaskPriority::kFrameCritical);
       blink::Threads::Gpu()->PostTask([weak_this, pipeline]() {
         if (weak_this) {
           weak_this->Draw(pipeline);
@@ -103,7 +269,7 @@ void GPURasterizer::Draw(
 }
 
 void GPURasterizer::DoDraw(std::unique_ptr<flow::LayerTree> layer_tree) {
-  if (!layer_tree || !surface_) {
+  if (!layer_tree || !surface_ || surface_suspended_) {
     return;
   }
 
@@ -112,40 +278,423 @@ void GPURasterizer::DoDraw(std::unique_ptr<flow::LayerTree> layer_tree) {
   // for instrumentation.
   compositor_context_.engine_time().SetLapTime(layer_tree->construction_time());
 
-  DrawToSurface(*layer_tree);
+  // Skia trace events are only passed on for the sampled frames, if any.
+  SkiaEventTracerBeginFrame();
+
+  flow::FrameTiming& timing = layer_tree->frame_timing();
+  timing.Set(flow::FrameTiming::kRasterStart, fxl::TimePoint::Now());
+
+  TRACE_EVENT0("flutter", "GPURasterizer::DoDraw");
+  if (timing.frame_number() != 0) {
+    TRACE_FLOW_STEP("flutter", "Frame", timing.frame_number());
+  }
+
+  // Only spans frames that reach the screen.
+  const bool first_present =
+      !blink::IsStartupPhaseRecorded(blink::StartupPhase::kFirstPresent);
+  const int64_t raster_start = first_present ? Dart_TimelineGetMicros() : 0;
+
+  if (DrawToSurface(*layer_tree)) {
+    if (first_present) {
+      blink::RecordStartupPhase(blink::StartupPhase::kFirstPresent,
+                                raster_start, Dart_TimelineGetMicros());
+    }
+    timing.Set(flow::FrameTiming::kPresent, fxl::TimePoint::Now());
+    if (frame_presented_callback_) {
+      frame_presented_callback_(timing);
+    }
+    if (surface_->WillReportDisplayTime()) {
+      frames_awaiting_display_.push_back(timing);
+    } else {
+      RecordFrameTiming(timing);
+    }
+    RecordFrameStatistics(timing);
+    if (layer_tree->rasterizer_tracing_threshold() != 0) {
+      CaptureSlowFrame(*layer_tree);
+    }
+  }
+
+  CollectDisplayTimes();
 
   NotifyNextFrameOnce();
 
+  TraceMemoryUsage();
+
   last_layer_tree_ = std::move(layer_tree);
 }
 
-void GPURasterizer::DrawToSurface(flow::LayerTree& layer_tree) {
+void GPURasterizer::TraceMemoryUsage() {
+  const fxl::TimePoint now = fxl::TimePoint::Now();
+  if (now - last_memory_usage_trace_time_ < kMemoryUsageTraceInterval) {
+    return;
+  }
+  last_memory_usage_trace_time_ = now;
+
+  MemoryUsage usage;
+  GetMemoryUsage(&usage);
+  usage.gpu_resource_cache_bytes =
+      GetResourceCacheBytes(GetGrContext());
+  usage.io_resource_cache_bytes = io_resource_cache_bytes_;
+  shell::TraceMemoryUsage(usage);
+
+  auto weak_this = weak_factory_.GetWeakPtr();
+  blink::Threads::IO()->PostTask([weak_this]() {
+    const int64_t bytes =
+        GetResourceCacheBytes(blink::ResourceContext::Get());
+    blink::Threads::Gpu()->PostTask([weak_this, bytes]() {
+      if (weak_this) {
+        weak_this->io_resource_cache_bytes_ = bytes;
+      }
+    });
+  });
+}
+
+void GPURasterizer::CaptureSlowFrame(flow::LayerTree& layer_tree) {
+  const flow::FrameTiming& timing = layer_tree.frame_timing();
+  const fxl::TimeDelta raster_time =
+      timing.Get(flow::FrameTiming::kPresent) -
+      timing.Get(flow::FrameTiming::kRasterStart);
+  const fxl::TimeDelta threshold = fxl::TimeDelta::FromMicroseconds(
+      kDefaultRefreshInterval.ToMicroseconds() *
+      layer_tree.rasterizer_tracing_threshold());
+  if (raster_time <= threshold) {
+    return;
+  }
+
+  const std::string& temp_directory =
+      blink::Settings::Get().temp_directory_path;
+  if (temp_directory.empty()) {
+    return;
+  }
+
+  TRACE_EVENT0("flutter", "GPURasterizer::CaptureSlowFrame");
+
+  // The raster cache is ignored so that the picture holds the draw calls of
+  // every layer instead of cached images.
+  SkPictureRecorder recorder;
+  const SkISize& frame_size = layer_tree.frame_size();
+  SkCanvas* canvas = recorder.beginRecording(
+      SkRect::MakeWH(frame_size.width(), frame_size.height()));
+  {
+    auto frame = compositor_context_.AcquireFrame(nullptr, canvas, false);
+    canvas->clear(SK_ColorBLACK);
+    layer_tree.Raster(frame, true);
+  }
+  sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+  if (picture == nullptr) {
+    return;
+  }
+
+  // Texture backed images can only be encoded on this thread, the file is
+  // written on the IO thread.
+  PngPixelSerializer serializer;
+  sk_sp<SkData> data = picture->serialize(&serializer);
+  if (data == nullptr) {
+    return;
+  }
+
+  // The trace events are taken now, before later frames push them out.
+  std::string trace;
+  if (fml::tracing::TraceRecorder::IsEnabled()) {
+    trace =
+        fml::tracing::TraceRecorder::DumpRecentEvents(kSlowFrameTraceDuration);
+  }
+
+  const std::string directory = temp_directory + "/flutter_slow_frames";
+  const std::string base_path =
+      directory + "/slow_frame_" +
+      std::to_string(slow_frame_capture_count_++ % kMaxSlowFrameCaptures);
+  const std::string path = base_path + ".skp";
+  FXL_LOG(INFO) << "Rasterizing a frame took " << raster_time.ToMillisecondsF()
+                << "ms. Writing its picture to " << path;
+  blink::Threads::IO()->PostTask([directory, base_path, path, data,
+                                  trace = std::move(trace)]() {
+    files::CreateDirectory(directory);
+    if (!files::WriteFile(path, reinterpret_cast<const char*>(data->data()),
+                          data->size())) {
+      FXL_DLOG(WARNING) << "Could not write the slow frame to " << path;
+    }
+    const std::string trace_path = base_path + ".json";
+    if (trace.empty()) {
+      // Do not leave the trace of an earlier capture next to this one.
+      files::DeletePath(trace_path, false);
+    } else if (!files::WriteFile(trace_path, trace.data(), trace.size())) {
+      FXL_DLOG(WARNING) << "Could not write the slow frame trace to "
+                        << trace_path;
+    }
+  });
+}
+
+bool GPURasterizer::DrawToSurface(flow::LayerTree& layer_tree) {
   auto frame = surface_->AcquireFrame(layer_tree.frame_size());
 
   if (frame == nullptr) {
-    return;
+    return false;
   }
 
+  frame->set_frame_number(layer_tree.frame_timing().frame_number());
+
   auto canvas = frame->SkiaCanvas();
 
   if (canvas == nullptr) {
-    return;
+    return false;
   }
 
   auto compositor_frame =
       compositor_context_.AcquireFrame(surface_->GetContext(), canvas);
 
+  layer_tree.Preroll(compositor_frame);
+
+  SkAutoCanvasRestore save(canvas, true);
+
+  if (enable_layer_tree_diffing_) {
+    const SkIRect frame_damage =
+        layer_tree.ComputeDamage(last_layer_tree_.get()).roundOut();
+
+    if (frame_damage.isEmpty()) {
+      // Nothing on screen would change. Drop the frame without presenting it
+      // so that the previous one remains visible.
+      TRACE_EVENT0("flutter", "GPURasterizer::SkipUndamagedFrame");
+      return false;
+    }
+
+    // Only repaint what changed since the previous frame and whatever the
+    // surface's buffer is missing relative to that frame.
+    SkIRect repaint_region = frame_damage;
+    repaint_region.join(frame->buffer_damage());
+    frame->set_frame_damage(frame_damage);
+    canvas->clipRect(SkRect::Make(repaint_region));
+  }
+
   canvas->clear(SK_ColorBLACK);
 
-  layer_tree.Raster(compositor_frame);
+  layer_tree.Paint(compositor_frame);
 
-  frame->Submit();
+  layer_tree.frame_timing().Set(flow::FrameTiming::kRasterFinish,
+                                fxl::TimePoint::Now());
+
+  const bool presented = frame->Submit();
+
+  // Measurements complete some frames after the frames they measure.
+  fxl::TimeDelta gpu_time;
+  const bool has_gpu_time = surface_->TakeGpuFrameTime(&gpu_time);
+  if (has_gpu_time) {
+    compositor_context_.gpu_time().SetLapTime(gpu_time);
+    TRACE_COUNTER1("flutter", "GpuFrameTimeMicros", gpu_time.ToMicroseconds());
+  }
+
+  if (presented) {
+    // Surfaces that do not measure the GPU draw on the CPU when the frame is
+    // submitted, which the raster time includes.
+    UpdateSurfaceScale(has_gpu_time
+                           ? gpu_time
+                           : fxl::TimePoint::Now() -
+                                 layer_tree.frame_timing().Get(
+                                     flow::FrameTiming::kRasterStart));
+  }
+
+  // The frame has been handed off to the surface. Spend some of the remaining
+  // time before the next vsync on pictures the raster cache deferred so that
+  // subsequent frames may use the cached images.
+  compositor_context_.raster_cache().PopulatePendingEntries(
+      surface_->GetContext(), kRasterCachePopulationBudget);
+
+  return presented;
+}
+
+void GPURasterizer::UpdateSurfaceScale(fxl::TimeDelta frame_time) {
+  if (!resolution_governor_ || !surface_->SupportsScaling()) {
+    return;
+  }
+
+  const double scale = resolution_governor_->AddFrame(
+      frame_time, fxl::TimeDelta::FromSecondsF(flow::FrameBudgetMS() / 1e3));
+  if (scale == surface_->GetScale()) {
+    return;
+  }
+
+  TRACE_EVENT1("flutter", "GPURasterizer::UpdateSurfaceScale", "scale",
+               std::to_string(scale).c_str());
+  surface_->SetScale(scale);
+  // The next frame is rendered into a backing store of another size.
+  last_layer_tree_.reset();
 }
 
 void GPURasterizer::AddNextFrameCallback(fxl::Closure nextFrameCallback) {
   nextFrameCallback_ = nextFrameCallback;
 }
 
+void GPURasterizer::SetFrameTimingsCallback(FrameTimingsCallback callback) {
+  frame_timings_callback_ = std::move(callback);
+  pending_frame_timings_.clear();
+}
+
+void GPURasterizer::SetFramePresentedCallback(
+    FramePresentedCallback callback) {
+  frame_presented_callback_ = std::move(callback);
+}
+
+void GPURasterizer::SetFrameStatisticsCallback(
+    fxl::TimeDelta interval,
+    FrameStatisticsCallback callback) {
+  frame_statistics_callback_ = std::move(callback);
+  frame_statistics_interval_ = interval;
+  frame_statistics_.reset();
+  if (frame_statistics_callback_) {
+    frame_statistics_ = std::make_unique<flow::FrameStatisticsAggregator>(
+        kDefaultRefreshInterval);
+  }
+}
+
+flow::TextureRegistry& GPURasterizer::GetTextureRegistry() {
+  return compositor_context_.texture_registry();
+}
+
+GrContext* GPURasterizer::GetGrContext() {
+  return surface_ ? surface_->GetContext() : nullptr;
+}
+
+flow::RasterCache* GPURasterizer::GetRasterCache() {
+  return &compositor_context_.raster_cache();
+}
+
+void GPURasterizer::OnMemoryPressure(MemoryPressureLevel level) {
+  TRACE_EVENT0("flutter", "GPURasterizer::OnMemoryPressure");
+  compositor_context_.raster_cache().Clear();
+
+  if (!surface_ || !surface_->GetContext() ||
+      !surface_->MakeRenderContextCurrent()) {
+    return;
+  }
+
+  GrContext* context = surface_->GetContext();
+  if (level == MemoryPressureLevel::kCritical) {
+    context->freeGpuResources();
+  } else {
+    context->purgeAllUnlockedResources();
+  }
+}
+
+void GPURasterizer::ApplyRuntimeSettings(
+    const blink::RuntimeSettings& settings) {
+  TRACE_EVENT0("flutter", "GPURasterizer::ApplyRuntimeSettings");
+  compositor_context_.raster_cache().SetThreshold(
+      settings.raster_cache_threshold);
+  compositor_context_.SetRasterCacheMaxBytes(settings.raster_cache_max_bytes);
+  enable_layer_tree_diffing_ = settings.enable_layer_tree_diffing;
+
+  // Lowering the budget purges resources, which needs the context current.
+  if (!surface_ || !surface_->GetContext() ||
+      !surface_->MakeRenderContextCurrent()) {
+    return;
+  }
+  GrContext* context = surface_->GetContext();
+  int max_resources = 0;
+  context->getResourceCacheLimits(&max_resources, nullptr);
+  context->setResourceCacheLimits(max_resources,
+                                  settings.gpu_resource_cache_max_bytes);
+}
+
+void GPURasterizer::RecordFrameTiming(const flow::FrameTiming& timing) {
+  if (!frame_timings_callback_) {
+    return;
+  }
+
+  const fxl::TimePoint now = fxl::TimePoint::Now();
+
+  if (pending_frame_timings_.empty()) {
+    last_frame_timings_report_time_ = now;
+  }
+
+  pending_frame_timings_.push_back(timing);
+
+  if (pending_frame_timings_.size() < kFrameTimingsBatchSize &&
+      now - last_frame_timings_report_time_ < kFrameTimingsReportInterval) {
+    return;
+  }
+
+  TRACE_EVENT0("flutter", "GPURasterizer::ReportFrameTimings");
+  std::vector<flow::FrameTiming> timings;
+  timings.swap(pending_frame_timings_);
+  frame_timings_callback_(std::move(timings));
+}
+
+void GPURasterizer::CollectDisplayTimes() {
+  if (!surface_) {
+    return;
+  }
+
+  int64_t frame_number = 0;
+  fxl::TimePoint display_time;
+  while (surface_->TakeDisplayTime(&frame_number, &display_time)) {
+    // Surfaces report frames in order, so earlier frames that are still
+    // waiting are not going to be reported.
+    while (!frames_awaiting_display_.empty() &&
+           frames_awaiting_display_.front().frame_number() < frame_number) {
+      RecordFrameTiming(frames_awaiting_display_.front());
+      frames_awaiting_display_.pop_front();
+    }
+    if (frames_awaiting_display_.empty() ||
+        frames_awaiting_display_.front().frame_number() != frame_number) {
+      continue;
+    }
+    flow::FrameTiming& timing = frames_awaiting_display_.front();
+    timing.Set(flow::FrameTiming::kDisplay, display_time);
+    if (display_time == fxl::TimePoint()) {
+      TRACE_EVENT_INSTANT0("flutter", "FrameNotDisplayed");
+    }
+    RecordFrameTiming(timing);
+    frames_awaiting_display_.pop_front();
+  }
+
+  const fxl::TimePoint now = fxl::TimePoint::Now();
+  while (!frames_awaiting_display_.empty() &&
+         now - frames_awaiting_display_.front().Get(
+                   flow::FrameTiming::kPresent) > kDisplayTimeTimeout) {
+    RecordFrameTiming(frames_awaiting_display_.front());
+    frames_awaiting_display_.pop_front();
+  }
+
+  // The last frames of an animation are only displayed after it ends.
+  if (frames_awaiting_display_.empty() || display_time_poll_scheduled_) {
+    return;
+  }
+  display_time_poll_scheduled_ = true;
+  auto weak_this = weak_factory_.GetWeakPtr();
+  blink::Threads::Gpu()->PostDelayedTask(
+      [weak_this]() {
+        if (weak_this) {
+          weak_this->display_time_poll_scheduled_ = false;
+          weak_this->CollectDisplayTimes();
+        }
+      },
+      kDisplayTimePollInterval);
+}
+
+void GPURasterizer::RecordFramesAwaitingDisplay() {
+  for (const flow::FrameTiming& timing : frames_awaiting_display_) {
+    RecordFrameTiming(timing);
+  }
+  frames_awaiting_display_.clear();
+}
+
+void GPURasterizer::RecordFrameStatistics(const flow::FrameTiming& timing) {
+  if (!frame_statistics_) {
+    return;
+  }
+
+  frame_statistics_->AddFrame(timing, compositor_context_.frame_work_counts(),
+                              GetResourceCacheBytes(GetGrContext()));
+
+  const fxl::TimePoint now = fxl::TimePoint::Now();
+  if (now - frame_statistics_->start() < frame_statistics_interval_) {
+    return;
+  }
+
+  TRACE_EVENT0("flutter", "GPURasterizer::ReportFrameStatistics");
+  frame_statistics_callback_(frame_statistics_->Take(now));
+}
+
 void GPURasterizer::NotifyNextFrameOnce() {
   if (nextFrameCallback_) {
     blink::Threads::Platform()->PostTask([callback = nextFrameCallback_] {
@@ -5,10 +5,15 @@
 #ifndef SHELL_GPU_DIRECT_GPU_RASTERIZER_H_
 #define SHELL_GPU_DIRECT_GPU_RASTERIZER_H_
 
+#include <deque>
+#include <vector>
+
 #include "flutter/flow/compositor_context.h"
 #include "flutter/shell/common/rasterizer.h"
+#include "flutter/shell/gpu/dynamic_resolution_governor.h"
 #include "lib/fxl/memory/weak_ptr.h"
 #include "lib/fxl/synchronization/waitable_event.h"
+#include "third_party/skia/include/core/SkData.h"
 
 namespace shell {
 
@@ -29,6 +34,10 @@ class GPURasterizer : public Rasterizer {
   void Teardown(
       fxl::AutoResetWaitableEvent* teardown_completion_event) override;
 
+  bool Suspend() override;
+
+  void Resume(fxl::Closure continuation) override;
+
   fxl::WeakPtr<Rasterizer> GetWeakRasterizerPtr() override;
 
   flow::LayerTree* GetLastLayerTree() override;
@@ -38,22 +47,104 @@ class GPURasterizer : public Rasterizer {
   // Set a callback to be called once when the next frame is drawn.
   void AddNextFrameCallback(fxl::Closure nextFrameCallback) override;
 
+  void SetFrameTimingsCallback(FrameTimingsCallback callback) override;
+
+  void SetFramePresentedCallback(FramePresentedCallback callback) override;
+
+  void SetFrameStatisticsCallback(fxl::TimeDelta interval,
+                                  FrameStatisticsCallback callback) override;
+
+  flow::TextureRegistry& GetTextureRegistry() override;
+
+  GrContext* GetGrContext() override;
+
+  flow::RasterCache* GetRasterCache() override;
+
+  void OnMemoryPressure(MemoryPressureLevel level) override;
+
+  void ApplyRuntimeSettings(const blink::RuntimeSettings& settings) override;
+
+  std::vector<flow::LayerProfiler::Entry> ProfileLastLayerTree(
+      bool synchronize,
+      size_t count) override;
+
  private:
   std::unique_ptr<Surface> surface_;
+  // Whether |surface_| is kept without a window to draw into.
+  bool surface_suspended_;
   flow::CompositorContext compositor_context_;
   std::unique_ptr<flow::LayerTree> last_layer_tree_;
+  // Whether a new layer tree is compared with |last_layer_tree_| before it is
+  // painted.
+  bool enable_layer_tree_diffing_;
   // A closure to be called when the underlaying surface presents a frame the
   // next time. NULL if there is no callback or the callback was set back to
   // NULL after being called.
   fxl::Closure nextFrameCallback_;
+  FrameTimingsCallback frame_timings_callback_;
+  FramePresentedCallback frame_presented_callback_;
+  // Timing records of presented frames that have not been reported yet.
+  std::vector<flow::FrameTiming> pending_frame_timings_;
+  fxl::TimePoint last_frame_timings_report_time_;
+  // Timing records of presented frames whose display time the surface is
+  // going to report. Oldest first.
+  std::deque<flow::FrameTiming> frames_awaiting_display_;
+  bool display_time_poll_scheduled_;
+  FrameStatisticsCallback frame_statistics_callback_;
+  fxl::TimeDelta frame_statistics_interval_;
+  std::unique_ptr<flow::FrameStatisticsAggregator> frame_statistics_;
+  // The serialized pictures drawn before the first frame of each surface.
+  std::vector<sk_sp<SkData>> shader_warmup_pictures_;
+  bool shader_warmup_pictures_read_;
+  // The number of slow frames captured, which picks the file the next one is
+  // written to.
+  size_t slow_frame_capture_count_;
+  fxl::TimePoint last_memory_usage_trace_time_;
+  // Sampled on the IO thread along with the other memory usage counters, and
+  // traced with the next ones.
+  int64_t io_resource_cache_bytes_;
+  // Lowers the scale of surfaces that support scaling while frames miss
+  // their budget. Null unless dynamic resolution is enabled.
+  std::unique_ptr<DynamicResolutionGovernor> resolution_governor_;
   fxl::WeakPtrFactory<GPURasterizer> weak_factory_;
 
+  // Compiles the shader programs of the warmup pictures, if any, with the
+  // context of the new surface.
+  void WarmUpShaders();
+
   void DoDraw(std::unique_ptr<flow::LayerTree> layer_tree);
 
-  void DrawToSurface(flow::LayerTree& layer_tree);
+  // Returns whether a frame was presented.
+  // Records the layer tree into a picture file if it rasterized slower than
+  // its tracing threshold allows.
+  void CaptureSlowFrame(flow::LayerTree& layer_tree);
+
+  bool DrawToSurface(flow::LayerTree& layer_tree);
+
+  // Hands the time of a presented frame to the resolution governor and
+  // applies the scale it picks to the surface.
+  void UpdateSurfaceScale(fxl::TimeDelta frame_time);
+
+  void RecordFrameTiming(const flow::FrameTiming& timing);
+
+  // Fills in the display times the surface has learned since the previous
+  // call and records the frames they belong to. Polls again later while
+  // frames are still awaiting their display time.
+  void CollectDisplayTimes();
+
+  // Records the frames awaiting their display time without one.
+  void RecordFramesAwaitingDisplay();
+
+  // Adds a presented frame to the statistics, reporting them once the
+  // interval is over.
+  void RecordFrameStatistics(const flow::FrameTiming& timing);
 
   void NotifyNextFrameOnce();
 
+  // Records the memory usage of each subsystem as trace counters, at most
+  // once per |kMemoryUsageTraceInterval|.
+  void TraceMemoryUsage();
+
   FXL_DISALLOW_COPY_AND_ASSIGN(GPURasterizer);
 };
 
@@ -4,6 +4,8 @@
 
 #include "gpu_surface_gl.h"
 
+#include "flutter/common/runtime_settings.h"
+#include "flutter/common/settings.h"
 #include "flutter/glue/trace_event.h"
 #include "lib/fxl/arraysize.h"
 #include "lib/fxl/logging.h"
@@ -18,24 +20,43 @@ namespace shell {
 // Default maximum number of budgeted resources in the cache.
 static const int kGrCacheMaxCount = 8192;
 
-// Default maximum number of bytes of GPU memory of budgeted resources in the
-// cache.
-static const size_t kGrCacheMaxByteSize = 512 * (1 << 20);
+// GL_RENDERER and GL_VERSION.
+static const GrGLenum kGLRenderer = 0x1F01;
+static const GrGLenum kGLVersion = 0x1F02;
+
+// The oldest buffer age for which damage is tracked. Older buffers are
+// repainted entirely.
+static const size_t kMaxTrackedBufferAge = 4;
+
+// The most presented frames whose display times are looked up. Older frames
+// are dropped as more are presented.
+static const size_t kMaxFramesAwaitingDisplay = 8;
 
 GPUSurfaceGL::GPUSurfaceGL(GPUSurfaceGLDelegate* delegate)
     : delegate_(delegate), weak_factory_(this) {
-  if (!delegate_->GLContextMakeCurrent()) {
+  if (!MakeContextCurrent()) {
     FXL_LOG(ERROR)
         << "Could not make the context current to setup the gr context.";
     return;
   }
 
-  auto backend_context =
-      reinterpret_cast<GrBackendContext>(GrGLCreateNativeInterface());
+  sk_sp<const GrGLInterface> interface(GrGLCreateNativeInterface());
+  auto backend_context = reinterpret_cast<GrBackendContext>(interface.get());
 
   GrContextOptions options;
   options.fRequireDecodeDisableForSRGB = false;
 
+  if (interface) {
+    // Program binaries only load on the driver that produced them.
+    auto get_string = [&interface](GrGLenum name) -> std::string {
+      const GrGLubyte* value = interface->fFunctions.fGetString(name);
+      return value ? reinterpret_cast<const char*>(value) : "";
+    };
+    persistent_cache_ = PersistentCache::Create(
+        "gl\n" + get_string(kGLRenderer) + "\n" + get_string(kGLVersion));
+    options.fPersistentCache = persistent_cache_.get();
+  }
+
   auto context = sk_sp<GrContext>(
       GrContext::Create(kOpenGL_GrBackend, backend_context, options));
 
@@ -46,9 +67,21 @@ GPUSurfaceGL::GPUSurfaceGL(GPUSurfaceGLDelegate* delegate)
 
   context_ = std::move(context);
 
-  context_->setResourceCacheLimits(kGrCacheMaxCount, kGrCacheMaxByteSize);
+  context_->setResourceCacheLimits(
+      kGrCacheMaxCount,
+      blink::RuntimeSettings::Get().gpu_resource_cache_max_bytes);
 
-  delegate_->GLContextClearCurrent();
+  if (blink::Settings::Get().enable_gpu_timer_queries) {
+    timer_queries_ = GPUTimerQueriesGL::Create(std::move(interface));
+    if (!timer_queries_) {
+      FXL_LOG(INFO) << "GPU timer queries are not supported by the context.";
+    }
+  }
+
+  // Thread exclusive contexts stay current until the surface is destroyed.
+  if (!context_current_) {
+    ClearContextCurrent();
+  }
 
   valid_ = true;
 }
@@ -58,18 +91,19 @@ GPUSurfaceGL::~GPUSurfaceGL() {
     return;
   }
 
-  if (!delegate_->GLContextMakeCurrent()) {
+  if (!MakeContextCurrent()) {
     FXL_LOG(ERROR) << "Could not make the context current to destroy the "
                       "GrContext resources.";
     return;
   }
 
+  timer_queries_ = nullptr;
   onscreen_surface_ = nullptr;
   offscreen_surface_ = nullptr;
   context_->releaseResourcesAndAbandonContext();
   context_ = nullptr;
 
-  delegate_->GLContextClearCurrent();
+  ClearContextCurrent();
 }
 
 bool GPUSurfaceGL::IsValid() {
@@ -157,6 +191,7 @@ bool GPUSurfaceGL::CreateOrUpdateSurfaces(const SkISize& size) {
   // Either way, we need to get rid of previous surfaces.
   onscreen_surface_ = nullptr;
   offscreen_surface_ = nullptr;
+  damage_history_.clear();
 
   if (size.isEmpty()) {
     FXL_LOG(ERROR) << "Cannot create surfaces of empty size.";
@@ -177,7 +212,10 @@ bool GPUSurfaceGL::CreateOrUpdateSurfaces(const SkISize& size) {
     return false;
   }
 
-  if (!surface_supports_srgb) {
+  // Legacy color rendering trades color correctness for the copy of the
+  // offscreen surface onscreen.
+  if (!surface_supports_srgb &&
+      !blink::Settings::Get().enable_legacy_color_rendering) {
     offscreen_surface = CreateOffscreenSurface(context_.get(), size);
     if (offscreen_surface == nullptr) {
       // If the offscreen surface was needed but could not be wrapped. Render to
@@ -207,7 +245,7 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceGL::AcquireFrame(const SkISize& size) {
     return nullptr;
   }
 
-  if (!delegate_->GLContextMakeCurrent()) {
+  if (!MakeContextCurrent()) {
     FXL_LOG(ERROR)
         << "Could not make the context current to acquire the frame.";
     return nullptr;
@@ -223,17 +261,47 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceGL::AcquireFrame(const SkISize& size) {
 
   SurfaceFrame::SubmitCallback submit_callback =
       [weak_this](const SurfaceFrame& surface_frame, SkCanvas* canvas) {
-        return weak_this ? weak_this->PresentSurface(canvas) : false;
+        return weak_this ? weak_this->PresentSurface(surface_frame, canvas)
+                         : false;
       };
 
-  return std::make_unique<SurfaceFrame>(surface, submit_callback);
+  auto frame = std::make_unique<SurfaceFrame>(surface, submit_callback);
+  frame->set_buffer_damage(GetBufferDamage(size));
+  return frame;
+}
+
+SkIRect GPUSurfaceGL::GetBufferDamage(const SkISize& size) {
+  const SkIRect bounds = SkIRect::MakeSize(size);
+
+  // The offscreen surface always holds the contents of the previous frame.
+  // Otherwise, ask the delegate how old the contents of the back buffer are.
+  const int buffer_age =
+      offscreen_surface_ != nullptr ? 1 : delegate_->GLContextBufferAge();
+
+  // An empty history means nothing has been presented to the current surfaces
+  // yet.
+  if (buffer_age <= 0 || damage_history_.empty() ||
+      static_cast<size_t>(buffer_age - 1) > damage_history_.size()) {
+    return bounds;
+  }
+
+  // The buffer is missing the changes made by the frames presented after it.
+  SkIRect damage = SkIRect::MakeEmpty();
+  for (int i = 0; i < buffer_age - 1; i++) {
+    damage.join(damage_history_[i]);
+  }
+  return damage;
 }
 
-bool GPUSurfaceGL::PresentSurface(SkCanvas* canvas) {
+bool GPUSurfaceGL::PresentSurface(const SurfaceFrame& frame, SkCanvas* canvas) {
   if (delegate_ == nullptr || canvas == nullptr || context_ == nullptr) {
     return false;
   }
 
+  const SkIRect& frame_damage = frame.frame_damage();
+  SkIRect repaint_region = frame_damage;
+  repaint_region.join(frame.buffer_damage());
+
   if (offscreen_surface_ != nullptr) {
     // Because the surface did not support sRGB, we rendered to an offscreen
     // surface. Now we must ensure that the texture is copied onscreen.
@@ -251,16 +319,89 @@ bool GPUSurfaceGL::PresentSurface(SkCanvas* canvas) {
     );
   }
 
+  if (offscreen_surface_ != nullptr) {
+    // The entire onscreen surface was written to by the copy above.
+    repaint_region = SkIRect::MakeWH(onscreen_surface_->width(),
+                                     onscreen_surface_->height());
+  }
+
+  delegate_->GLContextSetDamageRegion(repaint_region);
+
+  // Skia issues the GL commands of the frame when it is flushed, so the flush
+  // is what the GPU time is measured around.
+  if (timer_queries_) {
+    timer_queries_->BeginFrame();
+  }
+
   {
     TRACE_EVENT0("flutter", "SkCanvas::Flush");
     onscreen_surface_->getCanvas()->flush();
   }
 
-  delegate_->GLContextPresent();
+  if (timer_queries_) {
+    timer_queries_->EndFrame();
+  }
+
+  uint64_t frame_id = 0;
+  last_frame_awaits_display_ = delegate_->GLContextNextFrameId(&frame_id);
+  if (last_frame_awaits_display_) {
+    frames_awaiting_display_.push_back({frame.frame_number(), frame_id});
+    if (frames_awaiting_display_.size() > kMaxFramesAwaitingDisplay) {
+      frames_awaiting_display_.pop_front();
+    }
+  }
+
+  delegate_->GLContextPresentWithDamage(frame_damage);
+
+  damage_history_.push_front(frame_damage);
+  if (damage_history_.size() > kMaxTrackedBufferAge) {
+    damage_history_.pop_back();
+  }
+
+  return true;
+}
+
+bool GPUSurfaceGL::TakeGpuFrameTime(fxl::TimeDelta* time) {
+  if (!timer_queries_ || !MakeContextCurrent()) {
+    return false;
+  }
+  return timer_queries_->TakeFrameTime(time);
+}
+
+bool GPUSurfaceGL::WillReportDisplayTime() const {
+  return last_frame_awaits_display_;
+}
+
+bool GPUSurfaceGL::TakeDisplayTime(int64_t* frame_number,
+                                   fxl::TimePoint* time) {
+  if (frames_awaiting_display_.empty()) {
+    return false;
+  }
+  const PresentedFrame& frame = frames_awaiting_display_.front();
+  if (!delegate_->GLContextDisplayTime(frame.frame_id, time)) {
+    return false;
+  }
+  *frame_number = frame.frame_number;
+  frames_awaiting_display_.pop_front();
+  return true;
+}
 
+bool GPUSurfaceGL::MakeContextCurrent() {
+  if (context_current_) {
+    return true;
+  }
+  if (!delegate_->GLContextMakeCurrent()) {
+    return false;
+  }
+  context_current_ = delegate_->GLContextIsThreadExclusive();
   return true;
 }
 
+void GPUSurfaceGL::ClearContextCurrent() {
+  context_current_ = false;
+  delegate_->GLContextClearCurrent();
+}
+
 sk_sp<SkSurface> GPUSurfaceGL::AcquireRenderSurface(const SkISize& size) {
   if (!CreateOrUpdateSurfaces(size)) {
     return nullptr;
@@ -269,6 +410,10 @@ sk_sp<SkSurface> GPUSurfaceGL::AcquireRenderSurface(const SkISize& size) {
   return offscreen_surface_ != nullptr ? offscreen_surface_ : onscreen_surface_;
 }
 
+bool GPUSurfaceGL::MakeRenderContextCurrent() {
+  return MakeContextCurrent();
+}
+
 GrContext* GPUSurfaceGL::GetContext() {
   return context_.get();
 }
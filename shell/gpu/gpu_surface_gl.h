@@ -5,7 +5,11 @@
 #ifndef SHELL_GPU_GPU_SURFACE_GL_H_
 #define SHELL_GPU_GPU_SURFACE_GL_H_
 
+#include <deque>
+
+#include "flutter/shell/common/persistent_cache.h"
 #include "flutter/shell/common/surface.h"
+#include "flutter/shell/gpu/gpu_timer_queries_gl.h"
 #include "flutter/synchronization/debug_thread_checker.h"
 #include "lib/fxl/macros.h"
 #include "lib/fxl/memory/weak_ptr.h"
@@ -24,6 +28,42 @@ class GPUSurfaceGLDelegate {
   virtual intptr_t GLContextFBO() const = 0;
 
   virtual bool SurfaceSupportsSRGB() const = 0;
+
+  // Whether the context is only ever made current on the GPU thread by the
+  // surface, and no other context is made current on that thread. The
+  // surface then keeps track of whether the context is current instead of
+  // making it current again for every frame.
+  virtual bool GLContextIsThreadExclusive() const { return false; }
+
+  // The number of frames ago the current contents of the back buffer were
+  // presented (as described by EGL_EXT_buffer_age). Zero if the contents are
+  // undefined. The context is current when this is queried.
+  virtual int GLContextBufferAge() { return 0; }
+
+  // Informs the delegate of the region of the back buffer that is about to be
+  // rendered to (as described by EGL_KHR_partial_update). Rendering commands
+  // for the frame have been recorded but not yet flushed.
+  virtual void GLContextSetDamageRegion(const SkIRect& region) {}
+
+  // Presents the back buffer, hinting that only |damage| (in top-left origin
+  // window coordinates) changed since the last present.
+  virtual bool GLContextPresentWithDamage(const SkIRect& damage) {
+    return GLContextPresent();
+  }
+
+  // Sets |frame_id| to the identifier of the frame the next present is going
+  // to display, for looking up its display time with |GLContextDisplayTime|.
+  // Returns false if the delegate does not learn display times. The context
+  // is current when this is queried.
+  virtual bool GLContextNextFrameId(uint64_t* frame_id) { return false; }
+
+  // Sets |time| to when the frame with |frame_id| appeared on the display, or
+  // to a null time if it was skipped or is no longer known. Returns false
+  // while that is still pending.
+  virtual bool GLContextDisplayTime(uint64_t frame_id, fxl::TimePoint* time) {
+    *time = fxl::TimePoint();
+    return true;
+  }
 };
 
 class GPUSurfaceGL : public Surface {
@@ -38,11 +78,37 @@ class GPUSurfaceGL : public Surface {
 
   GrContext* GetContext() override;
 
+  bool MakeRenderContextCurrent() override;
+
+  bool TakeGpuFrameTime(fxl::TimeDelta* time) override;
+
+  bool WillReportDisplayTime() const override;
+
+  bool TakeDisplayTime(int64_t* frame_number, fxl::TimePoint* time) override;
+
  private:
+  // A presented frame and the identifier the delegate gave it.
+  struct PresentedFrame {
+    int64_t frame_number;
+    uint64_t frame_id;
+  };
+
   GPUSurfaceGLDelegate* delegate_;
+  // Null unless the persistent GPU cache is enabled. Outlives context_.
+  std::unique_ptr<PersistentCache> persistent_cache_;
   sk_sp<GrContext> context_;
+  // Null unless GPU timer queries are enabled and supported.
+  std::unique_ptr<GPUTimerQueriesGL> timer_queries_;
   sk_sp<SkSurface> onscreen_surface_;
   sk_sp<SkSurface> offscreen_surface_;
+  // The frame damage of the most recently presented frames. Newest first.
+  std::deque<SkIRect> damage_history_;
+  // The presented frames whose display times have not been taken yet. Oldest
+  // first.
+  std::deque<PresentedFrame> frames_awaiting_display_;
+  bool last_frame_awaits_display_ = false;
+  // Whether the context of a thread exclusive delegate is current.
+  bool context_current_ = false;
   bool valid_ = false;
   fxl::WeakPtrFactory<GPUSurfaceGL> weak_factory_;
 
@@ -50,10 +116,17 @@ class GPUSurfaceGL : public Surface {
 
   sk_sp<SkSurface> AcquireRenderSurface(const SkISize& size);
 
-  bool PresentSurface(SkCanvas* canvas);
+  bool PresentSurface(const SurfaceFrame& frame, SkCanvas* canvas);
+
+  SkIRect GetBufferDamage(const SkISize& size);
 
   bool SelectPixelConfig(GrPixelConfig* config);
 
+  // Makes the context of the delegate current unless it is known to be.
+  bool MakeContextCurrent();
+
+  void ClearContextCurrent();
+
   FXL_DISALLOW_COPY_AND_ASSIGN(GPUSurfaceGL);
 };
 
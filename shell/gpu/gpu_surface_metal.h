@@ -0,0 +1,59 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_GPU_GPU_SURFACE_METAL_H_
+#define SHELL_GPU_GPU_SURFACE_METAL_H_
+
+#include <Metal/Metal.h>
+
+#include <memory>
+
+#include "flutter/fml/platform/darwin/scoped_nsobject.h"
+#include "flutter/shell/common/persistent_cache.h"
+#include "flutter/shell/common/surface.h"
+#include "lib/fxl/macros.h"
+#include "third_party/skia/include/gpu/GrContext.h"
+
+@class CAMetalLayer;
+
+namespace shell {
+
+// Renders into the drawables of a CAMetalLayer with a Skia Metal GrContext.
+// The layer must have a device. Frames are acquired and presented on the GPU
+// thread.
+class GPUSurfaceMetal : public Surface {
+ public:
+  explicit GPUSurfaceMetal(CAMetalLayer* layer);
+
+  ~GPUSurfaceMetal() override;
+
+  bool IsValid() override;
+
+  std::unique_ptr<SurfaceFrame> AcquireFrame(const SkISize& size) override;
+
+  GrContext* GetContext() override;
+
+  bool WillReportDisplayTime() const override;
+
+  bool TakeDisplayTime(int64_t* frame_number, fxl::TimePoint* time) override;
+
+ private:
+  // The presented drawables whose display times have not been taken yet.
+  // Filled in by the presented handlers of the drawables, which run on other
+  // threads.
+  struct PresentedFrames;
+
+  std::shared_ptr<PresentedFrames> presented_frames_;
+  fml::scoped_nsobject<CAMetalLayer> layer_;
+  fml::scoped_nsprotocol<id<MTLCommandQueue>> command_queue_;
+  // Null unless the persistent GPU cache is enabled. Outlives context_.
+  std::unique_ptr<PersistentCache> persistent_cache_;
+  sk_sp<GrContext> context_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(GPUSurfaceMetal);
+};
+
+}  // namespace shell
+
+#endif  // SHELL_GPU_GPU_SURFACE_METAL_H_
@@ -0,0 +1,204 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/gpu/gpu_surface_metal.h"
+
+#include <QuartzCore/CAMetalLayer.h>
+
+#include <deque>
+#include <mutex>
+
+#include "flutter/common/runtime_settings.h"
+#include "flutter/glue/trace_event.h"
+#include "lib/fxl/logging.h"
+#include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/gpu/GrBackendSurface.h"
+#include "third_party/skia/include/gpu/GrContextOptions.h"
+#include "third_party/skia/include/gpu/mtl/GrMtlTypes.h"
+
+namespace shell {
+
+// Default maximum number of budgeted resources in the cache.
+static const int kGrCacheMaxCount = 8192;
+
+// The most presented drawables whose display times are waited for. Older
+// ones are dropped as more are presented.
+static const size_t kMaxFramesAwaitingDisplay = 8;
+
+struct GPUSurfaceMetal::PresentedFrames {
+  struct Frame {
+    int64_t frame_number;
+    int64_t sequence_number;
+    bool known;
+    fxl::TimePoint display_time;
+  };
+
+  std::mutex mutex;
+  // Oldest first.
+  std::deque<Frame> frames;
+  int64_t next_sequence_number = 0;
+  // Whether the drawable presented last has a presented handler.
+  bool last_frame_tracked = false;
+};
+
+GPUSurfaceMetal::GPUSurfaceMetal(CAMetalLayer* layer)
+    : presented_frames_(std::make_shared<PresentedFrames>()), layer_([layer retain]) {
+  id<MTLDevice> device = layer.device;
+  if (device == nil) {
+    FXL_LOG(ERROR) << "The Metal layer has no device.";
+    return;
+  }
+
+  command_queue_.reset([device newCommandQueue]);
+  if (command_queue_ == nil) {
+    FXL_LOG(ERROR) << "Could not create a Metal command queue.";
+    return;
+  }
+
+  GrContextOptions options;
+
+  // Compiled pipelines only load on the device that produced them.
+  persistent_cache_ = PersistentCache::Create(std::string("metal\n") + device.name.UTF8String);
+  options.fPersistentCache = persistent_cache_.get();
+
+  context_ = GrContext::MakeMetal(device, command_queue_.get(), options);
+  if (context_ == nullptr) {
+    FXL_LOG(ERROR) << "Failed to setup Skia Metal context.";
+    return;
+  }
+
+  context_->setResourceCacheLimits(kGrCacheMaxCount,
+                                   blink::RuntimeSettings::Get().gpu_resource_cache_max_bytes);
+}
+
+GPUSurfaceMetal::~GPUSurfaceMetal() {
+  if (context_ != nullptr) {
+    context_->releaseResourcesAndAbandonContext();
+  }
+}
+
+bool GPUSurfaceMetal::IsValid() {
+  return context_ != nullptr;
+}
+
+std::unique_ptr<SurfaceFrame> GPUSurfaceMetal::AcquireFrame(const SkISize& size) {
+  if (!IsValid() || size.isEmpty()) {
+    return nullptr;
+  }
+
+  const CGSize drawable_size = CGSizeMake(size.width(), size.height());
+  if (!CGSizeEqualToSize(drawable_size, layer_.get().drawableSize)) {
+    layer_.get().drawableSize = drawable_size;
+  }
+
+  fml::scoped_nsprotocol<id<CAMetalDrawable>> drawable;
+  {
+    // Waits for a drawable if all of them are in use by the compositor.
+    TRACE_EVENT0("flutter", "CAMetalLayer::nextDrawable");
+    @autoreleasepool {
+      drawable.reset([[layer_.get() nextDrawable] retain]);
+    }
+  }
+  if (drawable == nil) {
+    FXL_LOG(ERROR) << "Could not acquire a drawable from the Metal layer.";
+    return nullptr;
+  }
+
+  GrMtlTextureInfo texture_info;
+  texture_info.fTexture = reinterpret_cast<const void*>(drawable.get().texture);
+
+  GrBackendRenderTarget render_target(size.width(),   // width
+                                      size.height(),  // height
+                                      1,              // sample count
+                                      texture_info    // texture info
+  );
+
+  SkSurfaceProps surface_props(SkSurfaceProps::InitType::kLegacyFontHost_InitType);
+
+  sk_sp<SkSurface> surface = SkSurface::MakeFromBackendRenderTarget(
+      context_.get(),                             // gr context
+      render_target,                              // render target
+      GrSurfaceOrigin::kTopLeft_GrSurfaceOrigin,  // origin
+      nullptr,                                    // colorspace
+      &surface_props                              // surface properties
+  );
+  if (surface == nullptr) {
+    FXL_LOG(ERROR) << "Could not wrap the Metal drawable in a surface.";
+    return nullptr;
+  }
+
+  auto submit_callback = [drawable, command_queue = command_queue_,
+                          presented_frames = presented_frames_](
+                             const SurfaceFrame& surface_frame, SkCanvas* canvas) -> bool {
+    TRACE_EVENT0("flutter", "GPUSurfaceMetal::Submit");
+    // Skia commits the commands of the frame to the queue before the drawable
+    // is presented by a command buffer committed after them.
+    canvas->flush();
+    // Presented handlers are only available on iOS 10.3 and later.
+    const bool tracked = [drawable.get() respondsToSelector:@selector(addPresentedHandler:)];
+    int64_t sequence_number = 0;
+    {
+      std::lock_guard<std::mutex> lock(presented_frames->mutex);
+      presented_frames->last_frame_tracked = tracked;
+      if (tracked) {
+        sequence_number = presented_frames->next_sequence_number++;
+        presented_frames->frames.push_back(
+            {surface_frame.frame_number(), sequence_number, false, fxl::TimePoint()});
+        if (presented_frames->frames.size() > kMaxFramesAwaitingDisplay) {
+          presented_frames->frames.pop_front();
+        }
+      }
+    }
+    if (tracked) {
+      std::shared_ptr<PresentedFrames> frames = presented_frames;
+      [drawable.get() addPresentedHandler:^(id<MTLDrawable> presented) {
+        // Zero if the drawable was never displayed. Otherwise in the host time
+        // base of |CACurrentMediaTime|, which time points also use.
+        const CFTimeInterval presented_time = presented.presentedTime;
+        std::lock_guard<std::mutex> lock(frames->mutex);
+        for (auto& frame : frames->frames) {
+          if (frame.sequence_number == sequence_number) {
+            frame.known = true;
+            if (presented_time > 0) {
+              frame.display_time =
+                  fxl::TimePoint::FromEpochDelta(fxl::TimeDelta::FromSecondsF(presented_time));
+            }
+            break;
+          }
+        }
+      }];
+    }
+    @autoreleasepool {
+      id<MTLCommandBuffer> command_buffer = [command_queue.get() commandBuffer];
+      [command_buffer presentDrawable:drawable.get()];
+      [command_buffer commit];
+    }
+    return true;
+  };
+
+  return std::make_unique<SurfaceFrame>(std::move(surface), submit_callback);
+}
+
+GrContext* GPUSurfaceMetal::GetContext() {
+  return context_.get();
+}
+
+bool GPUSurfaceMetal::WillReportDisplayTime() const {
+  std::lock_guard<std::mutex> lock(presented_frames_->mutex);
+  return presented_frames_->last_frame_tracked;
+}
+
+bool GPUSurfaceMetal::TakeDisplayTime(int64_t* frame_number, fxl::TimePoint* time) {
+  std::lock_guard<std::mutex> lock(presented_frames_->mutex);
+  auto& frames = presented_frames_->frames;
+  if (frames.empty() || !frames.front().known) {
+    return false;
+  }
+  *frame_number = frames.front().frame_number;
+  *time = frames.front().display_time;
+  frames.pop_front();
+  return true;
+}
+
+}  // namespace shell
@@ -4,13 +4,95 @@
 
 #include "flutter/shell/gpu/gpu_surface_software.h"
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
+
+#include "flutter/common/settings.h"
+#include "flutter/common/threads.h"
+#include "flutter/glue/trace_event.h"
 #include "lib/fxl/logging.h"
+#include "lib/fxl/synchronization/waitable_event.h"
+#include "third_party/skia/include/core/SkPicture.h"
+#include "third_party/skia/include/utils/SkNoDrawCanvas.h"
 
 namespace shell {
+namespace {
+
+// Recorded frames are rasterized in horizontal tiles of this many rows. Tiles
+// span the width of the backing store, so each worker writes to contiguous
+// memory.
+const int kTileHeight = 128;
+
+// Finds saveLayers with backdrop filters while a picture is played back.
+// Backdrop filters read the pixels around them, which a tile does not have
+// near its edges.
+class BackdropFilterFinder : public SkNoDrawCanvas {
+ public:
+  BackdropFilterFinder(int width, int height) : SkNoDrawCanvas(width, height) {}
+
+  bool found() const { return found_; }
+
+ protected:
+  SaveLayerStrategy getSaveLayerStrategy(const SaveLayerRec& rec) override {
+    found_ |= rec.fBackdrop != nullptr;
+    return kNoLayer_SaveLayerStrategy;
+  }
+
+ private:
+  bool found_ = false;
+};
+
+bool HasBackdropFilter(SkPicture* picture, const SkISize& size) {
+  BackdropFilterFinder finder(size.width(), size.height());
+  picture->playback(&finder);
+  return finder.found();
+}
+
+void DrawPicture(SkCanvas* canvas, SkPicture* picture) {
+  canvas->resetMatrix();
+  canvas->drawPicture(picture);
+  canvas->flush();
+}
+
+// Draws the picture into the tiles of the pixels concurrently on the worker
+// threads and waits for all of them.
+void DrawPictureTiled(const SkPixmap& pixmap, SkPicture* picture) {
+  const int tile_count = (pixmap.height() + kTileHeight - 1) / kTileHeight;
+  std::atomic<int> remaining(tile_count);
+  fxl::AutoResetWaitableEvent latch;
+  for (int tile = 0; tile < tile_count; tile++) {
+    blink::Threads::Worker()->PostTask(
+        [tile, &pixmap, picture, &remaining, &latch]() {
+          TRACE_EVENT0("flutter", "GPUSurfaceSoftware::DrawTile");
+          const SkIRect bounds = SkIRect::MakeXYWH(
+              0, tile * kTileHeight, pixmap.width(),
+              std::min(kTileHeight, pixmap.height() - tile * kTileHeight));
+          SkPixmap tile_pixmap;
+          if (pixmap.extractSubset(&tile_pixmap, bounds)) {
+            std::unique_ptr<SkCanvas> canvas = SkCanvas::MakeRasterDirect(
+                tile_pixmap.info(), tile_pixmap.writable_addr(),
+                tile_pixmap.rowBytes());
+            if (canvas) {
+              canvas->translate(-bounds.left(), -bounds.top());
+              canvas->drawPicture(picture);
+            }
+          }
+          if (--remaining == 0) {
+            latch.Signal();
+          }
+        });
+  }
+  latch.Wait();
+}
+
+}  // namespace
 
 GPUSurfaceSoftware::GPUSurfaceSoftware(GPUSurfaceSoftwareDelegate* delegate)
-    : delegate_(delegate), weak_factory_(this) {}
+    : delegate_(delegate),
+      tiled_(blink::Settings::Get().enable_tiled_software_rendering &&
+             blink::Threads::Worker()),
+      weak_factory_(this) {}
 
 GPUSurfaceSoftware::~GPUSurfaceSoftware() = default;
 
@@ -46,7 +128,9 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireFrame(
   // If the surface has been scaled, we need to apply the inverse scaling to the
   // underlying canvas so that coordinates are mapped to the same spot
   // irrespective of surface scaling.
-  SkCanvas* canvas = backing_store->getCanvas();
+  SkCanvas* canvas =
+      tiled_ ? recorder_.beginRecording(SkRect::Make(size), &rtree_factory_)
+             : backing_store->getCanvas();
   canvas->resetMatrix();
   canvas->scale(scale, scale);
 
@@ -59,12 +143,41 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireFrame(
       return false;
     }
 
+    if (self->tiled_) {
+      return self->PresentRecording(surface_frame.SkiaSurface());
+    }
+
     canvas->flush();
 
     return self->delegate_->PresentBackingStore(surface_frame.SkiaSurface());
   };
 
-  return std::make_unique<SurfaceFrame>(backing_store, on_submit);
+  return std::make_unique<SurfaceFrame>(backing_store, canvas, on_submit);
+}
+
+bool GPUSurfaceSoftware::PresentRecording(sk_sp<SkSurface> backing_store) {
+  sk_sp<SkPicture> picture = recorder_.finishRecordingAsPicture();
+  if (picture == nullptr) {
+    return false;
+  }
+
+  const SkISize size =
+      SkISize::Make(backing_store->width(), backing_store->height());
+
+  // Snapshots of the backing store must not see the pixels change.
+  backing_store->notifyContentWillChange(SkSurface::kRetain_ContentChangeMode);
+
+  SkPixmap pixmap;
+  if (size.height() <= kTileHeight || !backing_store->peekPixels(&pixmap) ||
+      HasBackdropFilter(picture.get(), size)) {
+    TRACE_EVENT0("flutter", "GPUSurfaceSoftware::DrawUntiled");
+    DrawPicture(backing_store->getCanvas(), picture.get());
+  } else {
+    TRACE_EVENT0("flutter", "GPUSurfaceSoftware::DrawTiled");
+    DrawPictureTiled(pixmap, picture.get());
+  }
+
+  return delegate_->PresentBackingStore(std::move(backing_store));
 }
 
 GrContext* GPUSurfaceSoftware::GetContext() {
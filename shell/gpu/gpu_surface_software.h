@@ -8,6 +8,8 @@
 #include "flutter/shell/common/surface.h"
 #include "lib/fxl/macros.h"
 #include "lib/fxl/memory/weak_ptr.h"
+#include "third_party/skia/include/core/SkBBHFactory.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
 #include "third_party/skia/include/core/SkSurface.h"
 
 namespace shell {
@@ -34,9 +36,16 @@ class GPUSurfaceSoftware : public Surface {
 
  private:
   GPUSurfaceSoftwareDelegate* delegate_;
+  // Whether frames are recorded and rasterized in tiles on the worker threads.
+  const bool tiled_;
+  // Lets each tile only play back the operations that intersect it.
+  SkRTreeFactory rtree_factory_;
+  SkPictureRecorder recorder_;
 
   fxl::WeakPtrFactory<GPUSurfaceSoftware> weak_factory_;
 
+  bool PresentRecording(sk_sp<SkSurface> backing_store);
+
   FXL_DISALLOW_COPY_AND_ASSIGN(GPUSurfaceSoftware);
 };
 
@@ -3,14 +3,35 @@
 // found in the LICENSE file.
 
 #include "flutter/shell/gpu/gpu_surface_vulkan.h"
+#include "flutter/common/settings.h"
+#include "flutter/shell/common/persistent_cache.h"
 #include "lib/fxl/logging.h"
 
 namespace shell {
 
+static std::unique_ptr<GrContextOptions::PersistentCache> CreatePersistentCache(
+    const std::string& driver_version) {
+  return PersistentCache::Create(driver_version);
+}
+
 GPUSurfaceVulkan::GPUSurfaceVulkan(
     fxl::RefPtr<vulkan::VulkanProcTable> proc_table,
     std::unique_ptr<vulkan::VulkanNativeSurface> native_surface)
-    : window_(std::move(proc_table), std::move(native_surface)),
+    : window_(std::move(proc_table),
+              std::move(native_surface),
+              &CreatePersistentCache,
+              blink::Settings::Get().enable_vulkan_mailbox_present_mode,
+              blink::Settings::Get().enable_gpu_timer_queries),
+      weak_factory_(this) {}
+
+GPUSurfaceVulkan::GPUSurfaceVulkan(
+    fxl::RefPtr<vulkan::VulkanContext> context,
+    std::unique_ptr<vulkan::VulkanNativeSurface> native_surface)
+    : window_(std::move(context),
+              std::move(native_surface),
+              &CreatePersistentCache,
+              blink::Settings::Get().enable_vulkan_mailbox_present_mode,
+              blink::Settings::Get().enable_gpu_timer_queries),
       weak_factory_(this) {}
 
 GPUSurfaceVulkan::~GPUSurfaceVulkan() = default;
@@ -48,4 +69,8 @@ GrContext* GPUSurfaceVulkan::GetContext() {
   return window_.GetSkiaGrContext();
 }
 
+bool GPUSurfaceVulkan::TakeGpuFrameTime(fxl::TimeDelta* time) {
+  return window_.TakeGpuFrameTime(time);
+}
+
 }  // namespace shell
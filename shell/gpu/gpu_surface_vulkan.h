@@ -7,6 +7,7 @@
 
 #include <memory>
 #include "flutter/shell/common/surface.h"
+#include "flutter/vulkan/vulkan_context.h"
 #include "flutter/vulkan/vulkan_native_surface.h"
 #include "flutter/vulkan/vulkan_window.h"
 #include "lib/fxl/macros.h"
@@ -19,6 +20,11 @@ class GPUSurfaceVulkan : public Surface {
   GPUSurfaceVulkan(fxl::RefPtr<vulkan::VulkanProcTable> proc_table,
                    std::unique_ptr<vulkan::VulkanNativeSurface> native_surface);
 
+  // Shares the device of |context| with the other users of it, such as the
+  // resource context.
+  GPUSurfaceVulkan(fxl::RefPtr<vulkan::VulkanContext> context,
+                   std::unique_ptr<vulkan::VulkanNativeSurface> native_surface);
+
   ~GPUSurfaceVulkan() override;
 
   bool IsValid() override;
@@ -27,6 +33,8 @@ class GPUSurfaceVulkan : public Surface {
 
   GrContext* GetContext() override;
 
+  bool TakeGpuFrameTime(fxl::TimeDelta* time) override;
+
  private:
   vulkan::VulkanWindow window_;
   fxl::WeakPtrFactory<GPUSurfaceVulkan> weak_factory_;
@@ -0,0 +1,145 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/gpu/gpu_timer_queries_gl.h"
+
+#include "lib/fxl/logging.h"
+
+namespace shell {
+
+// GL_TIME_ELAPSED, GL_QUERY_RESULT, GL_QUERY_RESULT_AVAILABLE and
+// GL_GPU_DISJOINT_EXT.
+static const GrGLenum kGLTimeElapsed = 0x88BF;
+static const GrGLenum kGLQueryResult = 0x8866;
+static const GrGLenum kGLQueryResultAvailable = 0x8867;
+static const GrGLenum kGLGPUDisjoint = 0x8FBB;
+
+// The GPU runs at most a few frames behind. Frames are not timed while this
+// many measurements are outstanding, which bounds the number of queries.
+static const size_t kMaxPendingQueries = 4;
+
+std::unique_ptr<GPUTimerQueriesGL> GPUTimerQueriesGL::Create(
+    sk_sp<const GrGLInterface> interface) {
+  if (!interface) {
+    return nullptr;
+  }
+
+  const bool disjoint_timer_query =
+      interface->hasExtension("GL_EXT_disjoint_timer_query");
+  if (!disjoint_timer_query &&
+      !interface->hasExtension("GL_ARB_timer_query")) {
+    return nullptr;
+  }
+
+  const GrGLInterface::Functions& functions = interface->fFunctions;
+  if (!functions.fGenQueries || !functions.fDeleteQueries ||
+      !functions.fBeginQuery || !functions.fEndQuery ||
+      !functions.fGetQueryObjectuiv || !functions.fGetQueryObjectui64v) {
+    FXL_DLOG(INFO) << "Timer queries are supported but could not be resolved.";
+    return nullptr;
+  }
+
+  return std::unique_ptr<GPUTimerQueriesGL>(
+      new GPUTimerQueriesGL(std::move(interface), disjoint_timer_query));
+}
+
+GPUTimerQueriesGL::GPUTimerQueriesGL(sk_sp<const GrGLInterface> interface,
+                                     bool check_disjoint)
+    : gl_(std::move(interface)),
+      check_disjoint_(check_disjoint),
+      active_query_(0),
+      has_frame_time_(false) {}
+
+GPUTimerQueriesGL::~GPUTimerQueriesGL() {
+  if (active_query_ != 0) {
+    gl_->fFunctions.fEndQuery(kGLTimeElapsed);
+    free_queries_.push_back(active_query_);
+  }
+  free_queries_.insert(free_queries_.end(), pending_queries_.begin(),
+                       pending_queries_.end());
+  if (!free_queries_.empty()) {
+    gl_->fFunctions.fDeleteQueries(free_queries_.size(), free_queries_.data());
+  }
+}
+
+void GPUTimerQueriesGL::BeginFrame() {
+  FXL_DCHECK(active_query_ == 0);
+
+  ReadAvailableResults();
+
+  if (free_queries_.empty()) {
+    if (pending_queries_.size() >= kMaxPendingQueries) {
+      return;
+    }
+    GrGLuint query = 0;
+    gl_->fFunctions.fGenQueries(1, &query);
+    if (query == 0) {
+      return;
+    }
+    free_queries_.push_back(query);
+  }
+
+  active_query_ = free_queries_.back();
+  free_queries_.pop_back();
+  gl_->fFunctions.fBeginQuery(kGLTimeElapsed, active_query_);
+}
+
+void GPUTimerQueriesGL::EndFrame() {
+  if (active_query_ == 0) {
+    return;
+  }
+
+  gl_->fFunctions.fEndQuery(kGLTimeElapsed);
+  pending_queries_.push_back(active_query_);
+  active_query_ = 0;
+}
+
+bool GPUTimerQueriesGL::TakeFrameTime(fxl::TimeDelta* time) {
+  ReadAvailableResults();
+
+  if (!has_frame_time_) {
+    return false;
+  }
+
+  *time = frame_time_;
+  has_frame_time_ = false;
+  return true;
+}
+
+void GPUTimerQueriesGL::ReadAvailableResults() {
+  bool read_result = false;
+  while (!pending_queries_.empty()) {
+    const GrGLuint query = pending_queries_.front();
+
+    GrGLuint available = 0;
+    gl_->fFunctions.fGetQueryObjectuiv(query, kGLQueryResultAvailable,
+                                       &available);
+    if (!available) {
+      // Queries complete in order, so the later ones are not available
+      // either.
+      break;
+    }
+
+    GrGLuint64 elapsed = 0;
+    gl_->fFunctions.fGetQueryObjectui64v(query, kGLQueryResult, &elapsed);
+    pending_queries_.pop_front();
+    free_queries_.push_back(query);
+
+    frame_time_ = fxl::TimeDelta::FromNanoseconds(elapsed);
+    read_result = true;
+  }
+
+  if (!read_result) {
+    return;
+  }
+
+  // Reading the disjoint state also clears it.
+  GrGLint disjoint = 0;
+  if (check_disjoint_) {
+    gl_->fFunctions.fGetIntegerv(kGLGPUDisjoint, &disjoint);
+  }
+  has_frame_time_ = !disjoint;
+}
+
+}  // namespace shell
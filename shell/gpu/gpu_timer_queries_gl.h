@@ -0,0 +1,61 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SHELL_GPU_GPU_TIMER_QUERIES_GL_H_
+#define SHELL_GPU_GPU_TIMER_QUERIES_GL_H_
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "lib/fxl/macros.h"
+#include "lib/fxl/time/time_delta.h"
+#include "third_party/skia/include/gpu/gl/GrGLInterface.h"
+
+namespace shell {
+
+// Measures the GPU time of frames with GL_TIME_ELAPSED queries
+// (GL_EXT_disjoint_timer_query or GL_ARB_timer_query). Results are read
+// without stalling once the GPU has made them available, which is usually a
+// few frames later. All methods must be called with the context current.
+class GPUTimerQueriesGL {
+ public:
+  // Returns null if the context does not support timer queries.
+  static std::unique_ptr<GPUTimerQueriesGL> Create(
+      sk_sp<const GrGLInterface> interface);
+
+  ~GPUTimerQueriesGL();
+
+  // Starts timing the GL commands issued until |EndFrame|. Frames are not
+  // timed while too many earlier measurements are outstanding.
+  void BeginFrame();
+
+  void EndFrame();
+
+  // Sets |time| to the most recent measurement that completed since the
+  // previous call. Returns false if there is none.
+  bool TakeFrameTime(fxl::TimeDelta* time);
+
+ private:
+  sk_sp<const GrGLInterface> gl_;
+  // Whether the results must be discarded after the GPU reports a disjoint
+  // operation, such as a change of clock frequency.
+  const bool check_disjoint_;
+  std::vector<GrGLuint> free_queries_;
+  // Ended queries whose results are not yet read. Oldest first.
+  std::deque<GrGLuint> pending_queries_;
+  GrGLuint active_query_;
+  fxl::TimeDelta frame_time_;
+  bool has_frame_time_;
+
+  GPUTimerQueriesGL(sk_sp<const GrGLInterface> interface, bool check_disjoint);
+
+  void ReadAvailableResults();
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(GPUTimerQueriesGL);
+};
+
+}  // namespace shell
+
+#endif  // SHELL_GPU_GPU_TIMER_QUERIES_GL_H_
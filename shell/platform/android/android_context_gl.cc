@@ -14,6 +14,10 @@
 #define EGL_GL_COLORSPACE_SRGB_KHR 0x3089
 #endif
 
+#ifndef EGL_BUFFER_AGE_EXT
+#define EGL_BUFFER_AGE_EXT 0x313D
+#endif
+
 namespace shell {
 
 template <class T>
@@ -128,6 +132,9 @@ bool AndroidContextGL::CreateWindowSurface(
   window_ = std::move(window);
   EGLDisplay display = environment_->Display();
 
+  TeardownSurface(display, surface_);
+  surface_ = EGL_NO_SURFACE;
+
   const EGLint srgb_attribs[] = {EGL_GL_COLORSPACE_KHR,
                                  EGL_GL_COLORSPACE_SRGB_KHR, EGL_NONE};
   const EGLint default_attribs[] = {EGL_NONE};
@@ -140,9 +147,27 @@ bool AndroidContextGL::CreateWindowSurface(
   surface_ = eglCreateWindowSurface(
       display, config_,
       reinterpret_cast<EGLNativeWindowType>(window_->handle()), attribs);
+  frame_timestamps_enabled_ =
+      surface_ != EGL_NO_SURFACE && EnableFrameTimestamps();
   return surface_ != EGL_NO_SURFACE;
 }
 
+bool AndroidContextGL::EnableFrameTimestamps() {
+  if (get_next_frame_id_ == nullptr || get_frame_timestamps_ == nullptr ||
+      get_frame_timestamp_supported_ == nullptr) {
+    return false;
+  }
+
+  // Some compositors cannot tell when frames are displayed.
+  EGLDisplay display = environment_->Display();
+  if (!get_frame_timestamp_supported_(display, surface_,
+                                      EGL_DISPLAY_PRESENT_TIME_ANDROID)) {
+    return false;
+  }
+  return eglSurfaceAttrib(display, surface_, EGL_TIMESTAMPS_ANDROID,
+                          EGL_TRUE) == EGL_TRUE;
+}
+
 // For offscreen rendering.
 bool AndroidContextGL::CreatePBufferSurface() {
   // We only ever create pbuffer surfaces for background resource loading
@@ -150,6 +175,10 @@ bool AndroidContextGL::CreatePBufferSurface() {
 
   EGLDisplay display = environment_->Display();
 
+  TeardownSurface(display, surface_);
+  surface_ = EGL_NO_SURFACE;
+  frame_timestamps_enabled_ = false;
+
   const EGLint srgb_attribs[] = {EGL_WIDTH,
                                  1,
                                  EGL_HEIGHT,
@@ -168,6 +197,11 @@ bool AndroidContextGL::CreatePBufferSurface() {
   return surface_ != EGL_NO_SURFACE;
 }
 
+bool AndroidContextGL::DestroyWindowSurface() {
+  window_ = nullptr;
+  return CreatePBufferSurface();
+}
+
 AndroidContextGL::AndroidContextGL(fxl::RefPtr<AndroidEnvironmentGL> env,
                                    PlatformView::SurfaceConfig config,
                                    const AndroidContextGL* share_context)
@@ -176,6 +210,14 @@ AndroidContextGL::AndroidContextGL(fxl::RefPtr<AndroidEnvironmentGL> env,
       config_(nullptr),
       surface_(EGL_NO_SURFACE),
       context_(EGL_NO_CONTEXT),
+      srgb_support_(false),
+      buffer_age_support_(false),
+      swap_buffers_with_damage_(nullptr),
+      set_damage_region_(nullptr),
+      get_next_frame_id_(nullptr),
+      get_frame_timestamps_(nullptr),
+      get_frame_timestamp_supported_(nullptr),
+      frame_timestamps_enabled_(false),
       valid_(false) {
   if (!environment_->IsValid()) {
     return;
@@ -212,6 +254,31 @@ AndroidContextGL::AndroidContextGL(fxl::RefPtr<AndroidEnvironmentGL> env,
   const char* exts = eglQueryString(environment_->Display(), EGL_EXTENSIONS);
   srgb_support_ = strstr(exts, "EGL_KHR_gl_colorspace");
 
+  // Extensions used to avoid repainting and presenting unchanged regions of
+  // the window surface.
+  buffer_age_support_ = strstr(exts, "EGL_EXT_buffer_age");
+  if (strstr(exts, "EGL_KHR_swap_buffers_with_damage")) {
+    swap_buffers_with_damage_ =
+        reinterpret_cast<PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC>(
+            eglGetProcAddress("eglSwapBuffersWithDamageKHR"));
+  }
+  if (strstr(exts, "EGL_KHR_partial_update")) {
+    set_damage_region_ = reinterpret_cast<PFNEGLSETDAMAGEREGIONKHRPROC>(
+        eglGetProcAddress("eglSetDamageRegionKHR"));
+  }
+
+  // Used to learn when presented frames appear on the display.
+  if (strstr(exts, "EGL_ANDROID_get_frame_timestamps")) {
+    get_next_frame_id_ = reinterpret_cast<PFNEGLGETNEXTFRAMEIDANDROIDPROC>(
+        eglGetProcAddress("eglGetNextFrameIdANDROID"));
+    get_frame_timestamps_ =
+        reinterpret_cast<PFNEGLGETFRAMETIMESTAMPSANDROIDPROC>(
+            eglGetProcAddress("eglGetFrameTimestampsANDROID"));
+    get_frame_timestamp_supported_ =
+        reinterpret_cast<PFNEGLGETFRAMETIMESTAMPSUPPORTEDANDROIDPROC>(
+            eglGetProcAddress("eglGetFrameTimestampSupportedANDROID"));
+  }
+
   if (!this->CreatePBufferSurface()) {
     FXL_LOG(ERROR) << "Could not create the EGL surface.";
     LogLastEGLError();
@@ -245,6 +312,11 @@ bool AndroidContextGL::IsValid() const {
 }
 
 bool AndroidContextGL::MakeCurrent() {
+  // Some drivers flush when a context is made current, even if it already is.
+  if (eglGetCurrentContext() == context_ &&
+      eglGetCurrentSurface(EGL_DRAW) == surface_) {
+    return true;
+  }
   if (eglMakeCurrent(environment_->Display(), surface_, surface_, context_) !=
       EGL_TRUE) {
     FXL_LOG(ERROR) << "Could not make the context current";
@@ -269,6 +341,87 @@ bool AndroidContextGL::SwapBuffers() {
   return eglSwapBuffers(environment_->Display(), surface_);
 }
 
+// EGL expects rectangles as (x, y, width, height) with a bottom-left origin.
+static void ToEGLRect(const SkIRect& rect, EGLint height, EGLint* egl_rect) {
+  egl_rect[0] = rect.left();
+  egl_rect[1] = height - rect.bottom();
+  egl_rect[2] = rect.width();
+  egl_rect[3] = rect.height();
+}
+
+bool AndroidContextGL::SwapBuffersWithDamage(const SkIRect& damage) {
+  if (swap_buffers_with_damage_ == nullptr) {
+    return SwapBuffers();
+  }
+
+  TRACE_EVENT0("flutter", "AndroidContextGL::SwapBuffersWithDamage");
+  EGLint rect[4];
+  ToEGLRect(damage, GetSize().height(), rect);
+  return swap_buffers_with_damage_(environment_->Display(), surface_, rect, 1);
+}
+
+int AndroidContextGL::GetBufferAge() {
+  if (!buffer_age_support_) {
+    return 0;
+  }
+
+  EGLint age = 0;
+  if (!eglQuerySurface(environment_->Display(), surface_, EGL_BUFFER_AGE_EXT,
+                       &age)) {
+    return 0;
+  }
+  return age;
+}
+
+void AndroidContextGL::SetDamageRegion(const SkIRect& region) {
+  if (set_damage_region_ == nullptr) {
+    return;
+  }
+
+  EGLint rect[4];
+  ToEGLRect(region, GetSize().height(), rect);
+  set_damage_region_(environment_->Display(), surface_, rect, 1);
+}
+
+bool AndroidContextGL::GetNextFrameId(uint64_t* frame_id) {
+  if (!frame_timestamps_enabled_) {
+    return false;
+  }
+
+  khronos_uint64_t id = 0;
+  if (!get_next_frame_id_(environment_->Display(), surface_, &id)) {
+    return false;
+  }
+  *frame_id = id;
+  return true;
+}
+
+bool AndroidContextGL::GetDisplayTime(uint64_t frame_id,
+                                      fxl::TimePoint* time) {
+  *time = fxl::TimePoint();
+  if (!frame_timestamps_enabled_) {
+    return true;
+  }
+
+  const EGLint timestamp = EGL_DISPLAY_PRESENT_TIME_ANDROID;
+  khronos_stime_nanoseconds_t value = 0;
+  if (!get_frame_timestamps_(environment_->Display(), surface_, frame_id, 1,
+                             &timestamp, &value)) {
+    // The frame is older than the timestamps the surface keeps.
+    return true;
+  }
+  if (value == EGL_TIMESTAMP_PENDING_ANDROID) {
+    return false;
+  }
+  // Negative otherwise if the frame was never displayed. The timestamps are
+  // on the monotonic clock, as are time points.
+  if (value >= 0) {
+    *time = fxl::TimePoint::FromEpochDelta(
+        fxl::TimeDelta::FromNanoseconds(value));
+  }
+  return true;
+}
+
 SkISize AndroidContextGL::GetSize() {
   EGLint width = 0;
   EGLint height = 0;
@@ -284,14 +437,16 @@ SkISize AndroidContextGL::GetSize() {
 }
 
 bool AndroidContextGL::Resize(const SkISize& size) {
+  if (window_ == nullptr) {
+    return false;
+  }
+
   if (size == GetSize()) {
     return true;
   }
 
   ClearCurrent();
 
-  TeardownSurface(environment_->Display(), surface_);
-
   if (!this->CreateWindowSurface(window_)) {
     FXL_LOG(ERROR) << "Unable to create EGL window surface on resize.";
     return false;
@@ -5,14 +5,55 @@
 #ifndef FLUTTER_SHELL_PLATFORM_ANDROID_ANDROID_CONTEXT_GL_H_
 #define FLUTTER_SHELL_PLATFORM_ANDROID_ANDROID_CONTEXT_GL_H_
 
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
 #include "flutter/shell/common/platform_view.h"
 #include "flutter/shell/platform/android/android_environment_gl.h"
 #include "flutter/shell/platform/android/android_native_window.h"
 #include "lib/fxl/macros.h"
 #include "lib/fxl/memory/ref_counted.h"
 #include "lib/fxl/memory/ref_ptr.h"
+#include "lib/fxl/time/time_point.h"
+#include "third_party/skia/include/core/SkRect.h"
 #include "third_party/skia/include/core/SkSize.h"
 
+#ifndef EGL_KHR_partial_update
+typedef EGLBoolean(EGLAPIENTRYP PFNEGLSETDAMAGEREGIONKHRPROC)(EGLDisplay dpy,
+                                                             EGLSurface surface,
+                                                             EGLint* rects,
+                                                             EGLint n_rects);
+#endif  // EGL_KHR_partial_update
+
+#ifndef EGL_KHR_swap_buffers_with_damage
+typedef EGLBoolean(EGLAPIENTRYP PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC)(
+    EGLDisplay dpy,
+    EGLSurface surface,
+    EGLint* rects,
+    EGLint n_rects);
+#endif  // EGL_KHR_swap_buffers_with_damage
+
+#ifndef EGL_ANDROID_get_frame_timestamps
+#define EGL_TIMESTAMPS_ANDROID 0x3430
+#define EGL_DISPLAY_PRESENT_TIME_ANDROID 0x343A
+#define EGL_TIMESTAMP_PENDING_ANDROID (-2)
+typedef EGLBoolean(EGLAPIENTRYP PFNEGLGETNEXTFRAMEIDANDROIDPROC)(
+    EGLDisplay dpy,
+    EGLSurface surface,
+    khronos_uint64_t* frame_id);
+typedef EGLBoolean(EGLAPIENTRYP PFNEGLGETFRAMETIMESTAMPSANDROIDPROC)(
+    EGLDisplay dpy,
+    EGLSurface surface,
+    khronos_uint64_t frame_id,
+    EGLint num_timestamps,
+    const EGLint* timestamps,
+    khronos_stime_nanoseconds_t* values);
+typedef EGLBoolean(EGLAPIENTRYP PFNEGLGETFRAMETIMESTAMPSUPPORTEDANDROIDPROC)(
+    EGLDisplay dpy,
+    EGLSurface surface,
+    EGLint timestamp);
+#endif  // EGL_ANDROID_get_frame_timestamps
+
 namespace shell {
 
 class AndroidContextGL : public fxl::RefCountedThreadSafe<AndroidContextGL> {
@@ -21,6 +62,11 @@ class AndroidContextGL : public fxl::RefCountedThreadSafe<AndroidContextGL> {
 
   bool CreatePBufferSurface();
 
+  // Replaces the window surface with a pbuffer surface so that the context,
+  // and the GPU resources created with it, remain usable after the window is
+  // gone. Must not be current on any thread.
+  bool DestroyWindowSurface();
+
   fxl::RefPtr<AndroidEnvironmentGL> Environment() const;
 
   bool IsValid() const;
@@ -31,6 +77,27 @@ class AndroidContextGL : public fxl::RefCountedThreadSafe<AndroidContextGL> {
 
   bool SwapBuffers();
 
+  // Swaps buffers hinting that only |damage| (top-left origin) changed. Falls
+  // back to a full swap if EGL_KHR_swap_buffers_with_damage is unavailable.
+  bool SwapBuffersWithDamage(const SkIRect& damage);
+
+  // The age of the back buffer of the window surface. Zero if unknown.
+  int GetBufferAge();
+
+  // Restricts rendering of the current frame to |region| (top-left origin) if
+  // EGL_KHR_partial_update is available.
+  void SetDamageRegion(const SkIRect& region);
+
+  // Sets |frame_id| to the identifier of the frame the next swap displays.
+  // Returns false unless the window surface records frame timestamps (as
+  // described by EGL_ANDROID_get_frame_timestamps).
+  bool GetNextFrameId(uint64_t* frame_id);
+
+  // Sets |time| to when the frame with |frame_id| appeared on the display, or
+  // to a null time if it never did or EGL no longer knows. Returns false
+  // while that is still pending.
+  bool GetDisplayTime(uint64_t frame_id, fxl::TimePoint* time);
+
   SkISize GetSize();
 
   bool Resize(const SkISize& size);
@@ -44,6 +111,14 @@ class AndroidContextGL : public fxl::RefCountedThreadSafe<AndroidContextGL> {
   EGLSurface surface_;
   EGLContext context_;
   bool srgb_support_;
+  bool buffer_age_support_;
+  PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC swap_buffers_with_damage_;
+  PFNEGLSETDAMAGEREGIONKHRPROC set_damage_region_;
+  PFNEGLGETNEXTFRAMEIDANDROIDPROC get_next_frame_id_;
+  PFNEGLGETFRAMETIMESTAMPSANDROIDPROC get_frame_timestamps_;
+  PFNEGLGETFRAMETIMESTAMPSUPPORTEDANDROIDPROC get_frame_timestamp_supported_;
+  // Whether the window surface records frame timestamps.
+  bool frame_timestamps_enabled_;
   bool valid_;
 
   AndroidContextGL(fxl::RefPtr<AndroidEnvironmentGL> env,
@@ -52,6 +127,9 @@ class AndroidContextGL : public fxl::RefCountedThreadSafe<AndroidContextGL> {
 
   ~AndroidContextGL();
 
+  // Asks the window surface to record the times its frames are displayed.
+  bool EnableFrameTimestamps();
+
   FRIEND_MAKE_REF_COUNTED(AndroidContextGL);
   FRIEND_REF_COUNTED_THREAD_SAFE(AndroidContextGL);
   FXL_DISALLOW_COPY_AND_ASSIGN(AndroidContextGL);
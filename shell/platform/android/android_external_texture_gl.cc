@@ -0,0 +1,145 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/android/android_external_texture_gl.h"
+
+#include <GLES2/gl2ext.h>
+
+#include "flutter/common/threads.h"
+#include "flutter/shell/platform/android/platform_view_android_jni.h"
+#include "third_party/skia/include/gpu/GrBackendSurface.h"
+#include "third_party/skia/include/gpu/GrContext.h"
+#include "third_party/skia/include/gpu/gl/GrGLTypes.h"
+
+namespace shell {
+
+AndroidExternalTextureGL::AndroidExternalTextureGL(
+    int64_t id,
+    const fml::jni::JavaObjectWeakGlobalRef& surface_texture)
+    : Texture(id),
+      surface_texture_(surface_texture),
+      state_(AttachmentState::kUninitialized),
+      new_frame_ready_(false),
+      texture_name_(0),
+      transform_(SkMatrix::I()) {}
+
+AndroidExternalTextureGL::~AndroidExternalTextureGL() {
+  if (state_ == AttachmentState::kAttached) {
+    glDeleteTextures(1, &texture_name_);
+  }
+}
+
+void AndroidExternalTextureGL::MarkNewFrameAvailable() {
+  new_frame_ready_ = true;
+}
+
+void AndroidExternalTextureGL::Paint(SkCanvas& canvas, const SkRect& bounds) {
+  if (state_ == AttachmentState::kDetached) {
+    return;
+  }
+  GrContext* context = canvas.getGrContext();
+  if (context == nullptr) {
+    return;
+  }
+  if (state_ == AttachmentState::kUninitialized) {
+    glGenTextures(1, &texture_name_);
+    Attach(static_cast<jint>(texture_name_));
+    state_ = AttachmentState::kAttached;
+  }
+  if (new_frame_ready_) {
+    Update();
+    new_frame_ready_ = false;
+  }
+  // The SurfaceTexture binds its texture behind Skia's back.
+  context->resetContext(kTextureBinding_GrGLBackendState);
+
+  GrGLTextureInfo texture_info = {GL_TEXTURE_EXTERNAL_OES, texture_name_};
+  GrBackendTexture backend_texture(1, 1, kRGBA_8888_GrPixelConfig,
+                                   texture_info);
+  sk_sp<SkImage> image = SkImage::MakeFromTexture(
+      context, backend_texture, kTopLeft_GrSurfaceOrigin,
+      kPremul_SkAlphaType, nullptr);
+  if (!image) {
+    return;
+  }
+
+  // The image is the unit square. The transform selects the region of the
+  // buffer that holds the frame, in texture coordinates whose origin is at
+  // the bottom left.
+  SkAutoCanvasRestore save(&canvas, true);
+  canvas.translate(bounds.x(), bounds.y());
+  canvas.scale(bounds.width(), bounds.height());
+  if (!transform_.isIdentity()) {
+    SkMatrix transform(transform_);
+    transform.preTranslate(-0.5f, -0.5f);
+    transform.postScale(1, -1);
+    transform.postTranslate(0.5f, 0.5f);
+    canvas.concat(transform);
+  }
+  canvas.drawImage(image, 0, 0);
+}
+
+void AndroidExternalTextureGL::UpdateTransform() {
+  JNIEnv* env = fml::jni::AttachCurrentThread();
+  fml::jni::ScopedJavaLocalRef<jobject> surface_texture =
+      surface_texture_.get(env);
+  if (surface_texture.is_null()) {
+    return;
+  }
+  fml::jni::ScopedJavaLocalRef<jfloatArray> transform_matrix(
+      env, env->NewFloatArray(16));
+  SurfaceTextureGetTransformMatrix(env, surface_texture.obj(),
+                                   transform_matrix.obj());
+  float* m = env->GetFloatArrayElements(transform_matrix.obj(), nullptr);
+  // SurfaceTexture hands out a column major 4x4 matrix.
+  SkScalar matrix3[] = {
+      m[0], m[4], m[12],  //
+      m[1], m[5], m[13],  //
+      m[3], m[7], m[15],  //
+  };
+  env->ReleaseFloatArrayElements(transform_matrix.obj(), m, JNI_ABORT);
+  transform_.set9(matrix3);
+}
+
+void AndroidExternalTextureGL::OnGrContextDestroyed() {
+  if (state_ == AttachmentState::kAttached) {
+    Detach();
+    glDeleteTextures(1, &texture_name_);
+  }
+  state_ = AttachmentState::kDetached;
+}
+
+void AndroidExternalTextureGL::OnGrContextCreated() {
+  state_ = AttachmentState::kUninitialized;
+}
+
+void AndroidExternalTextureGL::Attach(jint texture_name) {
+  JNIEnv* env = fml::jni::AttachCurrentThread();
+  fml::jni::ScopedJavaLocalRef<jobject> surface_texture =
+      surface_texture_.get(env);
+  if (!surface_texture.is_null()) {
+    SurfaceTextureAttachToGLContext(env, surface_texture.obj(), texture_name);
+  }
+}
+
+void AndroidExternalTextureGL::Update() {
+  JNIEnv* env = fml::jni::AttachCurrentThread();
+  fml::jni::ScopedJavaLocalRef<jobject> surface_texture =
+      surface_texture_.get(env);
+  if (!surface_texture.is_null()) {
+    SurfaceTextureUpdateTexImage(env, surface_texture.obj());
+    UpdateTransform();
+  }
+}
+
+void AndroidExternalTextureGL::Detach() {
+  JNIEnv* env = fml::jni::AttachCurrentThread();
+  fml::jni::ScopedJavaLocalRef<jobject> surface_texture =
+      surface_texture_.get(env);
+  if (!surface_texture.is_null()) {
+    SurfaceTextureDetachFromGLContext(env, surface_texture.obj());
+  }
+}
+
+}  // namespace shell
@@ -0,0 +1,61 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_ANDROID_ANDROID_EXTERNAL_TEXTURE_GL_H_
+#define FLUTTER_SHELL_PLATFORM_ANDROID_ANDROID_EXTERNAL_TEXTURE_GL_H_
+
+#include <GLES2/gl2.h>
+
+#include "flutter/flow/texture.h"
+#include "flutter/fml/platform/android/jni_weak_ref.h"
+#include "lib/fxl/macros.h"
+
+namespace shell {
+
+// Composites the frames a SurfaceTexture receives from a camera, video decoder
+// or any other producer. The SurfaceTexture is attached to the GPU thread's
+// context the first time it is painted.
+class AndroidExternalTextureGL : public flow::Texture {
+ public:
+  AndroidExternalTextureGL(
+      int64_t id,
+      const fml::jni::JavaObjectWeakGlobalRef& surface_texture);
+
+  ~AndroidExternalTextureGL() override;
+
+  // |flow::Texture|
+  void Paint(SkCanvas& canvas, const SkRect& bounds) override;
+
+  // |flow::Texture|
+  void OnGrContextCreated() override;
+
+  // |flow::Texture|
+  void OnGrContextDestroyed() override;
+
+  // |flow::Texture|
+  void MarkNewFrameAvailable() override;
+
+ private:
+  enum class AttachmentState { kUninitialized, kAttached, kDetached };
+
+  void Attach(jint texture_name);
+
+  void Update();
+
+  void Detach();
+
+  void UpdateTransform();
+
+  fml::jni::JavaObjectWeakGlobalRef surface_texture_;
+  AttachmentState state_;
+  bool new_frame_ready_;
+  GLuint texture_name_;
+  SkMatrix transform_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(AndroidExternalTextureGL);
+};
+
+}  // namespace shell
+
+#endif  // FLUTTER_SHELL_PLATFORM_ANDROID_ANDROID_EXTERNAL_TEXTURE_GL_H_
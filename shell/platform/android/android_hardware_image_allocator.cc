@@ -0,0 +1,223 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/android/android_hardware_image_allocator.h"
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GLES2/gl2.h>
+#include <GLES2/gl2ext.h>
+#include <dlfcn.h>
+
+#include "lib/fxl/logging.h"
+#include "third_party/skia/include/gpu/GrBackendSurface.h"
+#include "third_party/skia/include/gpu/gl/GrGLTypes.h"
+
+namespace shell {
+namespace {
+
+// AHardwareBuffer is only available from API level 26, so its entry points
+// are resolved at runtime. These mirror <android/hardware_buffer.h>.
+struct AHardwareBuffer;
+
+struct AHardwareBuffer_Desc {
+  uint32_t width;
+  uint32_t height;
+  uint32_t layers;
+  uint32_t format;
+  uint64_t usage;
+  uint32_t stride;
+  uint32_t rfu0;
+  uint64_t rfu1;
+};
+
+constexpr uint32_t kFormatR8G8B8A8Unorm = 1;
+constexpr uint64_t kUsageCpuWriteOften = 3ULL << 4;
+constexpr uint64_t kUsageGpuSampledImage = 1ULL << 8;
+
+#ifndef EGL_NATIVE_BUFFER_ANDROID
+#define EGL_NATIVE_BUFFER_ANDROID 0x3140
+#endif
+
+struct Functions {
+  int (*allocate)(const AHardwareBuffer_Desc*, AHardwareBuffer**);
+  void (*release)(AHardwareBuffer*);
+  void (*describe)(const AHardwareBuffer*, AHardwareBuffer_Desc*);
+  int (*lock)(AHardwareBuffer*, uint64_t, int32_t, const void*, void**);
+  int (*unlock)(AHardwareBuffer*, int32_t*);
+  EGLClientBuffer (*get_native_client_buffer)(const AHardwareBuffer*);
+  PFNEGLCREATEIMAGEKHRPROC create_image;
+  PFNEGLDESTROYIMAGEKHRPROC destroy_image;
+  PFNGLEGLIMAGETARGETTEXTURE2DOESPROC image_target_texture;
+};
+
+Functions g_functions;
+
+template <typename T>
+bool Resolve(void* library, const char* name, T* function) {
+  *function = reinterpret_cast<T>(dlsym(library, name));
+  return *function != nullptr;
+}
+
+template <typename T>
+bool ResolveEGL(const char* name, T* function) {
+  *function = reinterpret_cast<T>(eglGetProcAddress(name));
+  return *function != nullptr;
+}
+
+bool ResolveFunctions() {
+  void* library = dlopen("libandroid.so", RTLD_NOW | RTLD_LOCAL);
+  if (library == nullptr) {
+    return false;
+  }
+  return Resolve(library, "AHardwareBuffer_allocate", &g_functions.allocate) &&
+         Resolve(library, "AHardwareBuffer_release", &g_functions.release) &&
+         Resolve(library, "AHardwareBuffer_describe", &g_functions.describe) &&
+         Resolve(library, "AHardwareBuffer_lock", &g_functions.lock) &&
+         Resolve(library, "AHardwareBuffer_unlock", &g_functions.unlock) &&
+         ResolveEGL("eglGetNativeClientBufferANDROID",
+                    &g_functions.get_native_client_buffer) &&
+         ResolveEGL("eglCreateImageKHR", &g_functions.create_image) &&
+         ResolveEGL("eglDestroyImageKHR", &g_functions.destroy_image) &&
+         ResolveEGL("glEGLImageTargetTexture2DOES",
+                    &g_functions.image_target_texture);
+}
+
+// Owns what the GPU samples from for as long as Skia uses the texture.
+struct TextureRelease {
+  AHardwareBuffer* buffer;
+  EGLDisplay display;
+  EGLImageKHR egl_image;
+  GLuint texture;
+};
+
+void ReleaseTexture(void* context) {
+  auto* release = static_cast<TextureRelease*>(context);
+  glDeleteTextures(1, &release->texture);
+  g_functions.destroy_image(release->display, release->egl_image);
+  g_functions.release(release->buffer);
+  delete release;
+}
+
+class HardwareBuffer : public blink::HardwareImageAllocator::Buffer {
+ public:
+  HardwareBuffer(AHardwareBuffer* buffer, void* pixels, size_t row_bytes)
+      : buffer_(buffer), pixels_(pixels), row_bytes_(row_bytes) {}
+
+  ~HardwareBuffer() override {
+    if (buffer_ == nullptr)
+      return;
+    if (pixels_ != nullptr)
+      g_functions.unlock(buffer_, nullptr);
+    g_functions.release(buffer_);
+  }
+
+  void* pixels() override { return pixels_; }
+
+  size_t row_bytes() override { return row_bytes_; }
+
+  sk_sp<SkImage> MakeImage(GrContext* context,
+                           SkAlphaType alpha_type) override {
+    g_functions.unlock(buffer_, nullptr);
+    pixels_ = nullptr;
+
+    EGLDisplay display = eglGetCurrentDisplay();
+    if (display == EGL_NO_DISPLAY) {
+      return nullptr;
+    }
+
+    const EGLint attributes[] = {EGL_IMAGE_PRESERVED_KHR, EGL_TRUE, EGL_NONE};
+    EGLImageKHR egl_image = g_functions.create_image(
+        display, EGL_NO_CONTEXT, EGL_NATIVE_BUFFER_ANDROID,
+        g_functions.get_native_client_buffer(buffer_), attributes);
+    if (egl_image == EGL_NO_IMAGE_KHR) {
+      FXL_DLOG(ERROR) << "Could not create an EGLImage from a hardware buffer: "
+                      << eglGetError();
+      return nullptr;
+    }
+
+    GLuint texture = 0;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    g_functions.image_target_texture(GL_TEXTURE_2D, egl_image);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    AHardwareBuffer_Desc desc;
+    g_functions.describe(buffer_, &desc);
+
+    GrGLTextureInfo texture_info;
+    texture_info.fTarget = GL_TEXTURE_2D;
+    texture_info.fID = texture;
+    GrBackendTexture backend_texture(desc.width, desc.height,
+                                     kRGBA_8888_GrPixelConfig, texture_info);
+
+    // The image takes over the buffer's reference.
+    auto* release = new TextureRelease{buffer_, display, egl_image, texture};
+    buffer_ = nullptr;
+    // Skia's GL state tracking does not know about the binding above.
+    context->resetContext(kTextureBinding_GrGLBackendState);
+    sk_sp<SkImage> image = SkImage::MakeFromTexture(
+        context, backend_texture, kTopLeft_GrSurfaceOrigin, alpha_type,
+        nullptr, &ReleaseTexture, release);
+    // Make sure the texture is complete before another context samples it.
+    glFlush();
+    return image;
+  }
+
+ private:
+  AHardwareBuffer* buffer_;
+  void* pixels_;
+  size_t row_bytes_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(HardwareBuffer);
+};
+
+}  // namespace
+
+std::unique_ptr<AndroidHardwareImageAllocator>
+AndroidHardwareImageAllocator::Create() {
+  if (!ResolveFunctions()) {
+    return nullptr;
+  }
+  return std::unique_ptr<AndroidHardwareImageAllocator>(
+      new AndroidHardwareImageAllocator());
+}
+
+AndroidHardwareImageAllocator::AndroidHardwareImageAllocator() = default;
+
+AndroidHardwareImageAllocator::~AndroidHardwareImageAllocator() = default;
+
+SkColorType AndroidHardwareImageAllocator::color_type() {
+  return kRGBA_8888_SkColorType;
+}
+
+std::unique_ptr<blink::HardwareImageAllocator::Buffer>
+AndroidHardwareImageAllocator::Allocate(int width, int height) {
+  AHardwareBuffer_Desc desc = {};
+  desc.width = width;
+  desc.height = height;
+  desc.layers = 1;
+  desc.format = kFormatR8G8B8A8Unorm;
+  desc.usage = kUsageCpuWriteOften | kUsageGpuSampledImage;
+
+  AHardwareBuffer* buffer = nullptr;
+  if (g_functions.allocate(&desc, &buffer) != 0 || buffer == nullptr) {
+    return nullptr;
+  }
+
+  // The stride is in pixels and may be larger than the width.
+  g_functions.describe(buffer, &desc);
+
+  void* pixels = nullptr;
+  if (g_functions.lock(buffer, kUsageCpuWriteOften, -1, nullptr, &pixels) !=
+          0 ||
+      pixels == nullptr) {
+    g_functions.release(buffer);
+    return nullptr;
+  }
+
+  return std::make_unique<HardwareBuffer>(buffer, pixels, desc.stride * 4);
+}
+
+}  // namespace shell
@@ -0,0 +1,38 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_ANDROID_ANDROID_HARDWARE_IMAGE_ALLOCATOR_H_
+#define FLUTTER_SHELL_PLATFORM_ANDROID_ANDROID_HARDWARE_IMAGE_ALLOCATOR_H_
+
+#include <memory>
+
+#include "flutter/lib/ui/painting/hardware_image_allocator.h"
+#include "lib/fxl/macros.h"
+
+namespace shell {
+
+// Decodes images into AHardwareBuffers and samples them through EGLImages on
+// the resource context.
+class AndroidHardwareImageAllocator : public blink::HardwareImageAllocator {
+ public:
+  // Returns null before Android O or when the EGL extensions are missing.
+  static std::unique_ptr<AndroidHardwareImageAllocator> Create();
+
+  ~AndroidHardwareImageAllocator() override;
+
+  // |blink::HardwareImageAllocator|
+  SkColorType color_type() override;
+
+  // |blink::HardwareImageAllocator|
+  std::unique_ptr<Buffer> Allocate(int width, int height) override;
+
+ private:
+  AndroidHardwareImageAllocator();
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(AndroidHardwareImageAllocator);
+};
+
+}  // namespace shell
+
+#endif  // FLUTTER_SHELL_PLATFORM_ANDROID_ANDROID_HARDWARE_IMAGE_ALLOCATOR_H_
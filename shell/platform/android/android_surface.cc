@@ -8,4 +8,17 @@ namespace shell {
 
 AndroidSurface::~AndroidSurface() = default;
 
+bool AndroidSurface::DetachOnScreenContext() {
+  return false;
+}
+
+sk_sp<GrContext> AndroidSurface::CreateResourceContext(
+    const GrContextOptions& options) {
+  return nullptr;
+}
+
+bool AndroidSurface::SupportsHardwareImageBuffers() const {
+  return true;
+}
+
 }  // namespace shell
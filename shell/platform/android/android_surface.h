@@ -14,6 +14,8 @@
 #include "flutter/shell/platform/android/android_native_window.h"
 #include "lib/fxl/macros.h"
 #include "third_party/skia/include/core/SkSize.h"
+#include "third_party/skia/include/gpu/GrContext.h"
+#include "third_party/skia/include/gpu/GrContextOptions.h"
 
 namespace shell {
 
@@ -25,6 +27,13 @@ class AndroidSurface {
 
   virtual void TeardownOnScreenContext() = 0;
 
+  // Releases the window of the onscreen context but keeps the context, so
+  // that the GPU surfaces created for it remain usable and the next
+  // |SetNativeWindow| only binds the new window to it. Returns false if the
+  // context cannot be kept, in which case |TeardownOnScreenContext| must be
+  // called. Never keeps it by default.
+  virtual bool DetachOnScreenContext();
+
   virtual std::unique_ptr<Surface> CreateGPUSurface() = 0;
 
   virtual SkISize OnScreenSurfaceSize() const = 0;
@@ -33,6 +42,16 @@ class AndroidSurface {
 
   virtual bool ResourceContextMakeCurrent() = 0;
 
+  // Called on the IO thread. Surfaces that do not render with OpenGL return
+  // their own resource context. Null means an OpenGL context is created after
+  // ResourceContextMakeCurrent.
+  virtual sk_sp<GrContext> CreateResourceContext(
+      const GrContextOptions& options);
+
+  // Whether images may be decoded into hardware buffers, which are only
+  // imported into OpenGL resource contexts.
+  virtual bool SupportsHardwareImageBuffers() const;
+
   virtual bool SetNativeWindow(fxl::RefPtr<AndroidNativeWindow> window,
                                PlatformView::SurfaceConfig config = {}) = 0;
 };
@@ -44,7 +44,8 @@ static fxl::RefPtr<AndroidContextGL> GlobalResourceLoadingContext(
 }
 
 AndroidSurfaceGL::AndroidSurfaceGL(
-    PlatformView::SurfaceConfig offscreen_config) {
+    PlatformView::SurfaceConfig offscreen_config)
+    : onscreen_context_detached_(false) {
   // Acquire the offscreen context.
   offscreen_context_ = GlobalResourceLoadingContext(offscreen_config);
 
@@ -73,6 +74,24 @@ void AndroidSurfaceGL::TeardownOnScreenContext() {
   });
   latch.Wait();
   onscreen_context_ = nullptr;
+  onscreen_context_detached_ = false;
+}
+
+bool AndroidSurfaceGL::DetachOnScreenContext() {
+  if (!IsValid()) {
+    return false;
+  }
+
+  bool detached = false;
+  fxl::AutoResetWaitableEvent latch;
+  blink::Threads::Gpu()->PostTask([this, &detached, &latch]() {
+    GLContextClearCurrent();
+    detached = onscreen_context_->DestroyWindowSurface();
+    latch.Signal();
+  });
+  latch.Wait();
+  onscreen_context_detached_ = detached;
+  return detached;
 }
 
 bool AndroidSurfaceGL::IsValid() const {
@@ -105,6 +124,18 @@ bool AndroidSurfaceGL::ResourceContextMakeCurrent() {
 
 bool AndroidSurfaceGL::SetNativeWindow(fxl::RefPtr<AndroidNativeWindow> window,
                                        PlatformView::SurfaceConfig config) {
+  // The GrContext created for a detached context is still in use, so the
+  // context is kept and only bound to the new window.
+  if (onscreen_context_detached_) {
+    onscreen_context_detached_ = false;
+    if (onscreen_context_->CreateWindowSurface(window)) {
+      return true;
+    }
+    FXL_LOG(ERROR) << "Could not bind the onscreen context to the new window.";
+    onscreen_context_detached_ = onscreen_context_->DestroyWindowSurface();
+    return false;
+  }
+
   // In any case, we want to get rid of our current onscreen context.
   onscreen_context_ = nullptr;
 
@@ -147,6 +178,32 @@ bool AndroidSurfaceGL::GLContextPresent() {
   return onscreen_context_->SwapBuffers();
 }
 
+int AndroidSurfaceGL::GLContextBufferAge() {
+  FXL_DCHECK(onscreen_context_ && onscreen_context_->IsValid());
+  return onscreen_context_->GetBufferAge();
+}
+
+void AndroidSurfaceGL::GLContextSetDamageRegion(const SkIRect& region) {
+  FXL_DCHECK(onscreen_context_ && onscreen_context_->IsValid());
+  onscreen_context_->SetDamageRegion(region);
+}
+
+bool AndroidSurfaceGL::GLContextPresentWithDamage(const SkIRect& damage) {
+  FXL_DCHECK(onscreen_context_ && onscreen_context_->IsValid());
+  return onscreen_context_->SwapBuffersWithDamage(damage);
+}
+
+bool AndroidSurfaceGL::GLContextNextFrameId(uint64_t* frame_id) {
+  FXL_DCHECK(onscreen_context_ && onscreen_context_->IsValid());
+  return onscreen_context_->GetNextFrameId(frame_id);
+}
+
+bool AndroidSurfaceGL::GLContextDisplayTime(uint64_t frame_id,
+                                            fxl::TimePoint* time) {
+  FXL_DCHECK(onscreen_context_ && onscreen_context_->IsValid());
+  return onscreen_context_->GetDisplayTime(frame_id, time);
+}
+
 intptr_t AndroidSurfaceGL::GLContextFBO() const {
   FXL_DCHECK(onscreen_context_ && onscreen_context_->IsValid());
   // The default window bound framebuffer on Android.
@@ -30,6 +30,8 @@ class AndroidSurfaceGL : public GPUSurfaceGLDelegate, public AndroidSurface {
 
   void TeardownOnScreenContext() override;
 
+  bool DetachOnScreenContext() override;
+
   SkISize OnScreenSurfaceSize() const override;
 
   bool OnScreenSurfaceResize(const SkISize& size) const override;
@@ -45,6 +47,16 @@ class AndroidSurfaceGL : public GPUSurfaceGLDelegate, public AndroidSurface {
 
   bool GLContextPresent() override;
 
+  int GLContextBufferAge() override;
+
+  void GLContextSetDamageRegion(const SkIRect& region) override;
+
+  bool GLContextPresentWithDamage(const SkIRect& damage) override;
+
+  bool GLContextNextFrameId(uint64_t* frame_id) override;
+
+  bool GLContextDisplayTime(uint64_t frame_id, fxl::TimePoint* time) override;
+
   intptr_t GLContextFBO() const override;
 
   bool SurfaceSupportsSRGB() const override;
@@ -52,6 +64,9 @@ class AndroidSurfaceGL : public GPUSurfaceGLDelegate, public AndroidSurface {
  private:
   fxl::RefPtr<AndroidContextGL> onscreen_context_;
   fxl::RefPtr<AndroidContextGL> offscreen_context_;
+  // Whether |onscreen_context_| was kept without a window by
+  // |DetachOnScreenContext|.
+  bool onscreen_context_detached_;
   sk_sp<GrContext> gr_context_;
 
   FXL_DISALLOW_COPY_AND_ASSIGN(AndroidSurfaceGL);
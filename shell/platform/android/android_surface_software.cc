@@ -68,6 +68,10 @@ sk_sp<SkSurface> AndroidSurfaceSoftware::AcquireBackingStore(
     return nullptr;
   }
 
+  if (sk_sp<SkSurface> window_surface = AcquireWindowSurface(size)) {
+    return window_surface;
+  }
+
   if (sk_surface_ != nullptr &&
       SkISize::Make(sk_surface_->width(), sk_surface_->height()) == size) {
     // The old and new surface sizes are the same. Nothing to do here.
@@ -82,6 +86,54 @@ sk_sp<SkSurface> AndroidSurfaceSoftware::AcquireBackingStore(
   return sk_surface_;
 }
 
+sk_sp<SkSurface> AndroidSurfaceSoftware::AcquireWindowSurface(
+    const SkISize& size) {
+  if (window_surface_ != nullptr) {
+    // The buffer of a frame that was not presented is still locked.
+    if (SkISize::Make(window_surface_->width(), window_surface_->height()) ==
+        size) {
+      return window_surface_;
+    }
+    UnlockWindow();
+  }
+
+  if (!(native_window_ && native_window_->IsValid())) {
+    return nullptr;
+  }
+
+  ANativeWindow_Buffer native_buffer;
+  if (ANativeWindow_lock(native_window_->handle(), &native_buffer, nullptr)) {
+    return nullptr;
+  }
+
+  SkColorType color_type;
+  if (native_buffer.width == size.width() &&
+      native_buffer.height == size.height() &&
+      GetSkColorType(native_buffer.format, &color_type)) {
+    SkImageInfo native_image_info =
+        SkImageInfo::Make(native_buffer.width, native_buffer.height, color_type,
+                          kPremul_SkAlphaType);
+    window_surface_ = SkSurface::MakeRasterDirect(
+        native_image_info, native_buffer.bits,
+        native_buffer.stride * SkColorTypeBytesPerPixel(color_type));
+  }
+
+  if (window_surface_ == nullptr) {
+    // The frame is drawn into the intermediate store and copied on present.
+    ANativeWindow_unlockAndPost(native_window_->handle());
+  }
+
+  return window_surface_;
+}
+
+void AndroidSurfaceSoftware::UnlockWindow() {
+  if (window_surface_ == nullptr) {
+    return;
+  }
+  window_surface_ = nullptr;
+  ANativeWindow_unlockAndPost(native_window_->handle());
+}
+
 bool AndroidSurfaceSoftware::PresentBackingStore(
     sk_sp<SkSurface> backing_store) {
   TRACE_EVENT0("flutter", "AndroidSurfaceSoftware::PresentBackingStore");
@@ -89,6 +141,12 @@ bool AndroidSurfaceSoftware::PresentBackingStore(
     return false;
   }
 
+  if (backing_store == window_surface_) {
+    // The frame was drawn straight into the buffer of the window.
+    UnlockWindow();
+    return true;
+  }
+
   SkPixmap pixmap;
   if (!backing_store->peekPixels(&pixmap)) {
     return false;
@@ -124,7 +182,9 @@ bool AndroidSurfaceSoftware::PresentBackingStore(
   return true;
 }
 
-void AndroidSurfaceSoftware::TeardownOnScreenContext() {}
+void AndroidSurfaceSoftware::TeardownOnScreenContext() {
+  UnlockWindow();
+}
 
 SkISize AndroidSurfaceSoftware::OnScreenSurfaceSize() const {
   return SkISize();
@@ -137,6 +197,7 @@ bool AndroidSurfaceSoftware::OnScreenSurfaceResize(const SkISize& size) const {
 bool AndroidSurfaceSoftware::SetNativeWindow(
     fxl::RefPtr<AndroidNativeWindow> window,
     PlatformView::SurfaceConfig config) {
+  UnlockWindow();
   native_window_ = std::move(window);
   if (!(native_window_ && native_window_->IsValid()))
     return false;
@@ -42,9 +42,21 @@ class AndroidSurfaceSoftware : public AndroidSurface,
  private:
   sk_sp<SkSurface> sk_surface_;
 
+  // Wraps the locked buffer of the window while a frame is drawn into it.
+  sk_sp<SkSurface> window_surface_;
+
   fxl::RefPtr<AndroidNativeWindow> native_window_;
   SkColorType target_color_type_;
 
+  // Locks the buffer of the window and wraps it in a surface, so that the
+  // frame is drawn without an intermediate copy. Returns null and leaves the
+  // window unlocked if the buffer does not match the size or has a format
+  // Skia cannot draw into.
+  sk_sp<SkSurface> AcquireWindowSurface(const SkISize& size);
+
+  // Posts the buffer of the window surface, if there is one.
+  void UnlockWindow();
+
   FXL_DISALLOW_COPY_AND_ASSIGN(AndroidSurfaceSoftware);
 };
 
@@ -4,7 +4,10 @@
 
 #include "flutter/shell/platform/android/android_surface_vulkan.h"
 
+#include <mutex>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "flutter/shell/gpu/gpu_surface_vulkan.h"
 #include "flutter/vulkan/vulkan_native_surface_android.h"
@@ -12,13 +15,30 @@
 
 namespace shell {
 
-AndroidSurfaceVulkan::AndroidSurfaceVulkan()
-    : proc_table_(fxl::MakeRefCounted<vulkan::VulkanProcTable>()) {}
+// The resource context is never collected, so the device it shares with the
+// onscreen surfaces is created once for the process.
+static fxl::RefPtr<vulkan::VulkanContext> GetSharedContext() {
+  static std::once_flag once;
+  static fxl::RefPtr<vulkan::VulkanContext>* context = nullptr;
+  std::call_once(once, []() {
+    std::vector<std::string> extensions = {
+        VK_KHR_SURFACE_EXTENSION_NAME,
+        VK_KHR_ANDROID_SURFACE_EXTENSION_NAME,
+    };
+    context = new fxl::RefPtr<vulkan::VulkanContext>(
+        fxl::MakeRefCounted<vulkan::VulkanContext>(
+            fxl::MakeRefCounted<vulkan::VulkanProcTable>(),
+            std::move(extensions)));
+  });
+  return *context;
+}
+
+AndroidSurfaceVulkan::AndroidSurfaceVulkan() : context_(GetSharedContext()) {}
 
 AndroidSurfaceVulkan::~AndroidSurfaceVulkan() = default;
 
 bool AndroidSurfaceVulkan::IsValid() const {
-  return proc_table_->HasAcquiredMandatoryProcAddresses();
+  return context_->IsValid();
 }
 
 void AndroidSurfaceVulkan::TeardownOnScreenContext() {
@@ -43,7 +63,7 @@ std::unique_ptr<Surface> AndroidSurfaceVulkan::CreateGPUSurface() {
   }
 
   auto gpu_surface = std::make_unique<GPUSurfaceVulkan>(
-      proc_table_, std::move(vulkan_surface_android));
+      context_, std::move(vulkan_surface_android));
 
   if (!gpu_surface->IsValid()) {
     return nullptr;
@@ -64,6 +84,29 @@ bool AndroidSurfaceVulkan::ResourceContextMakeCurrent() {
   return false;
 }
 
+// Uploads on the IO thread go to their own queue of the shared device. Skia
+// makes the onscreen context wait on a semaphore before it samples them.
+sk_sp<GrContext> AndroidSurfaceVulkan::CreateResourceContext(
+    const GrContextOptions& options) {
+  if (!IsValid()) {
+    return nullptr;
+  }
+
+  auto backend_context = context_->CreateSkiaResourceBackendContext();
+  if (backend_context == nullptr) {
+    FXL_DLOG(INFO) << "The Vulkan device has no queue for resource uploads.";
+    return nullptr;
+  }
+
+  return sk_sp<GrContext>(GrContext::Create(
+      kVulkan_GrBackend,
+      reinterpret_cast<GrBackendContext>(backend_context.get()), options));
+}
+
+bool AndroidSurfaceVulkan::SupportsHardwareImageBuffers() const {
+  return false;
+}
+
 bool AndroidSurfaceVulkan::SetNativeWindow(
     fxl::RefPtr<AndroidNativeWindow> window,
     PlatformView::SurfaceConfig config) {
@@ -9,7 +9,7 @@
 #include <memory>
 #include "flutter/shell/platform/android/android_native_window.h"
 #include "flutter/shell/platform/android/android_surface.h"
-#include "flutter/vulkan/vulkan_window.h"
+#include "flutter/vulkan/vulkan_context.h"
 #include "lib/fxl/macros.h"
 
 namespace shell {
@@ -32,11 +32,17 @@ class AndroidSurfaceVulkan : public AndroidSurface {
 
   bool ResourceContextMakeCurrent() override;
 
+  sk_sp<GrContext> CreateResourceContext(
+      const GrContextOptions& options) override;
+
+  bool SupportsHardwareImageBuffers() const override;
+
   bool SetNativeWindow(fxl::RefPtr<AndroidNativeWindow> window,
                        PlatformView::SurfaceConfig config) override;
 
  private:
-  fxl::RefPtr<vulkan::VulkanProcTable> proc_table_;
+  // Shared by all the surfaces and the resource context.
+  fxl::RefPtr<vulkan::VulkanContext> context_;
   fxl::RefPtr<AndroidNativeWindow> native_window_;
 
   FXL_DISALLOW_COPY_AND_ASSIGN(AndroidSurfaceVulkan);
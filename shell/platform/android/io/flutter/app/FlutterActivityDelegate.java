@@ -235,11 +235,19 @@ public final class FlutterActivityDelegate
         if (level == TRIM_MEMORY_RUNNING_LOW) {
             flutterView.onMemoryPressure();
         }
+        // Processes in the background are killed in order of their memory use,
+        // so give back everything the engine can rebuild.
+        if (level >= TRIM_MEMORY_BACKGROUND || level == TRIM_MEMORY_RUNNING_CRITICAL) {
+            flutterView.trimEngineMemory(true);
+        } else if (level >= TRIM_MEMORY_RUNNING_LOW) {
+            flutterView.trimEngineMemory(false);
+        }
     }
 
     @Override
     public void onLowMemory() {
         flutterView.onMemoryPressure();
+        flutterView.trimEngineMemory(true);
     }
 
     @Override
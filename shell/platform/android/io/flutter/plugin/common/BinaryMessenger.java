@@ -64,7 +64,9 @@ public interface BinaryMessenger {
          * <p>Any uncaught exception thrown by this method will be caught by the messenger implementation and
          * logged, and a null reply message will be sent back to Flutter.</p>
          *
-         * @param message the message {@link ByteBuffer} payload, possibly null.
+         * @param message the message {@link ByteBuffer} payload, possibly null. It is a direct buffer
+         * wrapping memory owned by Flutter, which is released once this method returns. Handlers that
+         * need the payload later must copy it.
          * @param reply A {@link BinaryReply} used for submitting a reply back to Flutter.
          */
         void onMessage(ByteBuffer message, BinaryReply reply);
@@ -81,7 +83,8 @@ public interface BinaryMessenger {
          *
          * @param reply the reply payload, a direct-allocated {@link ByteBuffer} or null. Senders of
          * outgoing replies must place the reply bytes between position zero and current position.
-         * Reply receivers can read from the buffer directly.
+         * Reply receivers can read from the buffer directly. Replies received from Flutter wrap memory
+         * owned by Flutter, which is released once this method returns.
          */
         void reply(ByteBuffer reply);
     }
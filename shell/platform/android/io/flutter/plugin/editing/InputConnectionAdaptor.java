@@ -24,20 +24,45 @@ class InputConnectionAdaptor extends BaseInputConnection {
     private final int mClient;
     private final MethodChannel mFlutterChannel;
     private final Editable mEditable;
+    private final boolean mSendDeltas;
+    // The text as Flutter last saw it, which deltas are relative to.
+    private String mLastText;
     private int mBatchCount;
     private InputMethodManager mImm;
 
     public InputConnectionAdaptor(FlutterView view, int client,
-        MethodChannel flutterChannel, Editable editable) {
+        MethodChannel flutterChannel, Editable editable, boolean sendDeltas) {
         super(view, true);
         mFlutterView = view;
         mClient = client;
         mFlutterChannel = flutterChannel;
         mEditable = editable;
+        mSendDeltas = sendDeltas;
+        mLastText = editable.toString();
         mBatchCount = 0;
         mImm = (InputMethodManager) view.getContext().getSystemService(Context.INPUT_METHOD_SERVICE);
     }
 
+    // Adds the range of mLastText that was replaced and the text that replaced it
+    // to state. Only the characters between the common prefix and suffix of the old
+    // and new text are sent, so a keystroke in a long document sends one character.
+    private static void putDelta(HashMap<Object, Object> state, String oldText, String newText) {
+        int start = 0;
+        int limit = Math.min(oldText.length(), newText.length());
+        while (start < limit && oldText.charAt(start) == newText.charAt(start))
+            start++;
+        int oldEnd = oldText.length();
+        int newEnd = newText.length();
+        while (oldEnd > start && newEnd > start &&
+               oldText.charAt(oldEnd - 1) == newText.charAt(newEnd - 1)) {
+            oldEnd--;
+            newEnd--;
+        }
+        state.put("deltaStart", start);
+        state.put("deltaEnd", oldEnd);
+        state.put("deltaText", newText.substring(start, newEnd));
+    }
+
     // Send the current state of the editable to Flutter.
     private void updateEditingState() {
         // If the IME is in the middle of a batch edit, then wait until it completes.
@@ -54,11 +79,19 @@ class InputConnectionAdaptor extends BaseInputConnection {
                              composingStart, composingEnd);
 
         HashMap<Object, Object> state = new HashMap<Object, Object>();
-        state.put("text", mEditable.toString());
         state.put("selectionBase", selectionStart);
         state.put("selectionExtent", selectionEnd);
         state.put("composingBase", composingStart);
         state.put("composingExtent", composingEnd);
+        String text = mEditable.toString();
+        if (mSendDeltas) {
+            putDelta(state, mLastText, text);
+            mLastText = text;
+            mFlutterChannel.invokeMethod("TextInputClient.updateEditingStateWithDeltas",
+                Arrays.asList(mClient, state));
+            return;
+        }
+        state.put("text", text);
         mFlutterChannel.invokeMethod("TextInputClient.updateEditingState",
             Arrays.asList(mClient, state));
     }
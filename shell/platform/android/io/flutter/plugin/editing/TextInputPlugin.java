@@ -136,7 +136,10 @@ public class TextInputPlugin implements MethodCallHandler {
         }
         outAttrs.imeOptions |= enterAction;
 
-        InputConnectionAdaptor connection = new InputConnectionAdaptor(view, mClient, mFlutterChannel, mEditable);
+        // Clients that opt in receive the edits made by the IME as deltas rather
+        // than the whole text.
+        InputConnectionAdaptor connection = new InputConnectionAdaptor(view, mClient,
+            mFlutterChannel, mEditable, mConfiguration.optBoolean("enableDeltaModel"));
         outAttrs.initialSelStart = Math.max(Selection.getSelectionStart(mEditable), 0);
         outAttrs.initialSelEnd = Math.max(Selection.getSelectionEnd(mEditable), 0);
 
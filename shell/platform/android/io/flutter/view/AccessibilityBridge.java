@@ -31,6 +31,8 @@ class AccessibilityBridge extends AccessibilityNodeProvider implements BasicMess
     private static final String TAG = "FlutterView";
 
     private Map<Integer, SemanticsObject> mObjects;
+    // The labels interned by the engine, indexed by their ids.
+    private final ArrayList<String> mLabels = new ArrayList<String>();
     private final FlutterView mOwner;
     private boolean mAccessibilityEnabled = false;
     private SemanticsObject mFocusedObject;
@@ -57,6 +59,16 @@ class AccessibilityBridge extends AccessibilityNodeProvider implements BasicMess
     private static final int SEMANTICS_FLAG_IS_CHECKED = 1 << 1;
     private static final int SEMANTICS_FLAG_IS_SELECTED = 1 << 2;
 
+    // The fields sent for a node in an update. Must match
+    // blink::SemanticsNode::Field.
+    private static final int SEMANTICS_FIELD_FLAGS = 1 << 0;
+    private static final int SEMANTICS_FIELD_ACTIONS = 1 << 1;
+    private static final int SEMANTICS_FIELD_LABEL = 1 << 2;
+    private static final int SEMANTICS_FIELD_TEXT_DIRECTION = 1 << 3;
+    private static final int SEMANTICS_FIELD_RECT = 1 << 4;
+    private static final int SEMANTICS_FIELD_TRANSFORM = 1 << 5;
+    private static final int SEMANTICS_FIELD_CHILDREN = 1 << 6;
+
     AccessibilityBridge(FlutterView owner) {
         assert owner != null;
         mOwner = owner;
@@ -291,11 +303,21 @@ class AccessibilityBridge extends AccessibilityNodeProvider implements BasicMess
         }
     }
 
+    // The buffer starts with the id of the first of the new labels in
+    // |strings|, zero if the interned labels start over. It is followed by the
+    // id of each changed node, the SEMANTICS_FIELD bits of its changed fields
+    // and their values.
     void updateSemantics(ByteBuffer buffer, String[] strings) {
+        final int firstLabelId = buffer.getInt();
+        if (firstLabelId == 0)
+            mLabels.clear();
+        assert mLabels.size() == firstLabelId;
+        mLabels.addAll(Arrays.asList(strings));
+
         ArrayList<Integer> updated = new ArrayList<Integer>();
         while (buffer.hasRemaining()) {
             int id = buffer.getInt();
-            getOrCreateObject(id).updateWith(buffer, strings);
+            getOrCreateObject(id).updateWith(buffer, mLabels);
             updated.add(id);
         }
 
@@ -398,6 +420,7 @@ class AccessibilityBridge extends AccessibilityNodeProvider implements BasicMess
 
     void reset() {
         mObjects.clear();
+        mLabels.clear();
         if (mFocusedObject != null)
             sendAccessibilityEvent(mFocusedObject.id, AccessibilityEvent.TYPE_VIEW_ACCESSIBILITY_FOCUS_CLEARED);
         mFocusedObject = null;
@@ -457,29 +480,44 @@ class AccessibilityBridge extends AccessibilityNodeProvider implements BasicMess
           }
         }
 
-        void updateWith(ByteBuffer buffer, String[] strings) {
-            flags = buffer.getInt();
-            actions = buffer.getInt();
+        void updateWith(ByteBuffer buffer, List<String> labels) {
+            final int fields = buffer.getInt();
 
-            final int stringIndex = buffer.getInt();
-            if (stringIndex == -1)
-                label = null;
-            else
-                label = strings[stringIndex];
+            if ((fields & SEMANTICS_FIELD_FLAGS) != 0)
+                flags = buffer.getInt();
+            if ((fields & SEMANTICS_FIELD_ACTIONS) != 0)
+                actions = buffer.getInt();
 
-            textDirection = TextDirection.fromInt(buffer.getInt());
+            if ((fields & SEMANTICS_FIELD_LABEL) != 0) {
+                final int labelId = buffer.getInt();
+                if (labelId == -1)
+                    label = null;
+                else
+                    label = labels.get(labelId);
+            }
 
-            left = buffer.getFloat();
-            top = buffer.getFloat();
-            right = buffer.getFloat();
-            bottom = buffer.getFloat();
+            if ((fields & SEMANTICS_FIELD_TEXT_DIRECTION) != 0)
+                textDirection = TextDirection.fromInt(buffer.getInt());
 
-            if (transform == null)
-                transform = new float[16];
-            for (int i = 0; i < 16; ++i)
-                transform[i] = buffer.getFloat();
-            inverseTransformDirty = true;
-            globalGeometryDirty = true;
+            if ((fields & SEMANTICS_FIELD_RECT) != 0) {
+                left = buffer.getFloat();
+                top = buffer.getFloat();
+                right = buffer.getFloat();
+                bottom = buffer.getFloat();
+                globalGeometryDirty = true;
+            }
+
+            if ((fields & SEMANTICS_FIELD_TRANSFORM) != 0) {
+                if (transform == null)
+                    transform = new float[16];
+                for (int i = 0; i < 16; ++i)
+                    transform[i] = buffer.getFloat();
+                inverseTransformDirty = true;
+                globalGeometryDirty = true;
+            }
+
+            if ((fields & SEMANTICS_FIELD_CHILDREN) == 0)
+                return;
 
             final int childCount = buffer.getInt();
             if (childCount == 0) {
@@ -15,6 +15,7 @@ import android.graphics.Bitmap;
 import android.graphics.Rect;
 import android.graphics.Canvas;
 import android.graphics.Paint;
+import android.graphics.SurfaceTexture;
 import android.graphics.Matrix;
 import android.os.Build;
 import android.text.format.DateFormat;
@@ -52,12 +53,13 @@ import java.util.List;
 import java.util.Locale;
 import java.util.Map;
 import java.util.concurrent.atomic.AtomicBoolean;
+import java.util.concurrent.atomic.AtomicLong;
 
 /**
  * An Android view containing a Flutter app.
  */
 public class FlutterView extends SurfaceView
-    implements BinaryMessenger, AccessibilityManager.AccessibilityStateChangeListener {
+    implements BinaryMessenger, TextureRegistry, AccessibilityManager.AccessibilityStateChangeListener {
 
     /**
      * Interface for those objects that maintain and expose a reference to a
@@ -106,6 +108,7 @@ public class FlutterView extends SurfaceView
     private final BroadcastReceiver mDiscoveryReceiver;
     private final List<ActivityLifecycleListener> mActivityLifecycleListeners;
     private final List<FirstFrameListener> mFirstFrameListeners;
+    private final AtomicLong nextTextureId = new AtomicLong(0L);
     private long mNativePlatformView;
     private boolean mIsSoftwareRenderingEnabled = false; // using the software renderer or not
 
@@ -261,6 +264,17 @@ public class FlutterView extends SurfaceView
         mFlutterSystemChannel.send(message);
     }
 
+    /**
+     * Frees the engine's caches. Critical pressure also drops caches that are
+     * expensive to rebuild.
+     */
+    public void trimEngineMemory(boolean critical) {
+        if (!isAttached()) {
+            return;
+        }
+        nativeNotifyMemoryPressure(mNativePlatformView, critical);
+    }
+
     /**
      * Provide a listener that will be called once when the FlutterView renders its first frame
      * to the underlaying SurfaceView.
@@ -612,6 +626,61 @@ public class FlutterView extends SurfaceView
         return nativeGetBitmap(mNativePlatformView);
     }
 
+    @Override
+    public TextureRegistry.SurfaceTextureEntry createSurfaceTexture() {
+        assertAttached();
+        final SurfaceTexture surfaceTexture = new SurfaceTexture(0);
+        // The engine attaches the texture to its own GL context on the GPU thread.
+        surfaceTexture.detachFromGLContext();
+        final SurfaceTextureRegistryEntry entry =
+            new SurfaceTextureRegistryEntry(nextTextureId.getAndIncrement(), surfaceTexture);
+        nativeRegisterTexture(mNativePlatformView, entry.id(), surfaceTexture);
+        return entry;
+    }
+
+    final class SurfaceTextureRegistryEntry implements TextureRegistry.SurfaceTextureEntry {
+        private final long id;
+        private final SurfaceTexture surfaceTexture;
+        private boolean released;
+
+        SurfaceTextureRegistryEntry(long id, SurfaceTexture surfaceTexture) {
+            this.id = id;
+            this.surfaceTexture = surfaceTexture;
+            this.surfaceTexture.setOnFrameAvailableListener(new SurfaceTexture.OnFrameAvailableListener() {
+                @Override
+                public void onFrameAvailable(SurfaceTexture texture) {
+                    if (released || !isAttached()) {
+                        return;
+                    }
+                    nativeMarkTextureFrameAvailable(mNativePlatformView, SurfaceTextureRegistryEntry.this.id);
+                }
+            });
+        }
+
+        @Override
+        public SurfaceTexture surfaceTexture() {
+            return surfaceTexture;
+        }
+
+        @Override
+        public long id() {
+            return id;
+        }
+
+        @Override
+        public void release() {
+            if (released) {
+                return;
+            }
+            released = true;
+            surfaceTexture.setOnFrameAvailableListener(null);
+            if (isAttached()) {
+                nativeUnregisterTexture(mNativePlatformView, id);
+            }
+            surfaceTexture.release();
+        }
+    }
+
     private static native long nativeAttach(FlutterView view);
 
     private static native String nativeGetObservatoryUri();
@@ -666,6 +735,11 @@ public class FlutterView extends SurfaceView
     private static native void nativeSetSemanticsEnabled(long nativePlatformViewAndroid,
         boolean enabled);
 
+    private static native void nativeResetSemantics(long nativePlatformViewAndroid);
+
+    private static native void nativeNotifyMemoryPressure(long nativePlatformViewAndroid,
+        boolean critical);
+
     // Send a data-carrying response to a platform message received from Dart.
     private static native void nativeInvokePlatformMessageResponseCallback(
         long nativePlatformViewAndroid, int responseId, ByteBuffer message, int position);
@@ -676,6 +750,14 @@ public class FlutterView extends SurfaceView
 
     private static native boolean nativeGetIsSoftwareRenderingEnabled();
 
+    private static native void nativeRegisterTexture(long nativePlatformViewAndroid, long textureId,
+        SurfaceTexture surfaceTexture);
+
+    private static native void nativeMarkTextureFrameAvailable(long nativePlatformViewAndroid,
+        long textureId);
+
+    private static native void nativeUnregisterTexture(long nativePlatformViewAndroid, long textureId);
+
     private void updateViewportMetrics() {
         if (!isAttached())
             return;
@@ -691,17 +773,17 @@ public class FlutterView extends SurfaceView
         WindowManager wm = (WindowManager) getContext()
             .getSystemService(Context.WINDOW_SERVICE);
         float fps = wm.getDefaultDisplay().getRefreshRate();
-        VsyncWaiter.refreshPeriodNanos = (long)(1000000000.0 / fps);
+        VsyncWaiter.setRefreshPeriodNanos((long)(1000000000.0 / fps));
     }
 
     // Called by native to send us a platform message.
-    private void handlePlatformMessage(final String channel, byte[] message, final int replyId) {
+    // The message wraps engine memory that is only valid during this call.
+    private void handlePlatformMessage(final String channel, ByteBuffer message, final int replyId) {
         assertAttached();
         BinaryMessageHandler handler = mMessageHandlers.get(channel);
         if (handler != null) {
             try {
-                final ByteBuffer buffer = (message == null ? null : ByteBuffer.wrap(message));
-                handler.onMessage(buffer,
+                handler.onMessage(message,
                     new BinaryReply() {
                         private final AtomicBoolean done = new AtomicBoolean(false);
                         @Override
@@ -735,11 +817,12 @@ public class FlutterView extends SurfaceView
     private final Map<Integer, BinaryReply> mPendingReplies = new HashMap<>();
 
     // Called by native to respond to a platform message that we sent.
-    private void handlePlatformMessageResponse(int replyId, byte[] reply) {
+    // The reply wraps engine memory that is only valid during this call.
+    private void handlePlatformMessageResponse(int replyId, ByteBuffer reply) {
         BinaryReply callback = mPendingReplies.remove(replyId);
         if (callback != null) {
             try {
-                callback.reply(reply == null ? null : ByteBuffer.wrap(reply));
+                callback.reply(reply);
             } catch (Exception ex) {
                 Log.e(TAG, "Uncaught exception in binary message reply handler", ex);
             }
@@ -866,6 +949,9 @@ public class FlutterView extends SurfaceView
     void resetAccessibilityTree() {
         if (mAccessibilityNodeProvider != null) {
             mAccessibilityNodeProvider.reset();
+            // The engine only sends what changed since its last update.
+            if (isAttached())
+                nativeResetSemantics(mNativePlatformView);
         }
     }
 
@@ -10,6 +10,11 @@ public class VsyncWaiter {
     // This estimate will be updated by FlutterView when it is attached to a Display.
     public static long refreshPeriodNanos = 1000000000 / 60;
 
+    public static void setRefreshPeriodNanos(long nanos) {
+        refreshPeriodNanos = nanos;
+        nativeSetRefreshPeriodNanos(nanos);
+    }
+
     public static void asyncWaitForVsync(final long cookie) {
         Choreographer.getInstance().postFrameCallback(new Choreographer.FrameCallback() {
             @Override
@@ -20,4 +25,5 @@ public class VsyncWaiter {
     }
 
     private static native void nativeOnVsync(long frameTimeNanos, long frameTargetTimeNanos, long cookie);
+    private static native void nativeSetRefreshPeriodNanos(long refreshPeriodNanos);
 }
@@ -5,6 +5,7 @@
 #include "flutter/shell/platform/android/platform_view_android.h"
 
 #include <android/native_window_jni.h>
+#include <string.h>
 #include <sys/resource.h>
 #include <sys/time.h>
 #include <sys/types.h>
@@ -15,9 +16,12 @@
 #include "flutter/common/threads.h"
 #include "flutter/fml/platform/android/jni_util.h"
 #include "flutter/fml/platform/android/scoped_java_ref.h"
+#include "flutter/lib/ui/painting/hardware_image_allocator.h"
 #include "flutter/runtime/dart_service_isolate.h"
 #include "flutter/shell/common/null_rasterizer.h"
 #include "flutter/shell/gpu/gpu_rasterizer.h"
+#include "flutter/shell/platform/android/android_external_texture_gl.h"
+#include "flutter/shell/platform/android/android_hardware_image_allocator.h"
 #include "flutter/shell/platform/android/android_surface_gl.h"
 #include "flutter/shell/platform/android/android_surface_software.h"
 #include "flutter/shell/platform/android/platform_view_android_jni.h"
@@ -94,6 +98,19 @@ static std::unique_ptr<AndroidSurface> InitializePlatformSurfaceSoftware() {
   return surface->IsValid() ? std::move(surface) : nullptr;
 }
 
+// Wraps |data| in a direct ByteBuffer without copying it. The caller must keep
+// |data| alive for as long as Java may read from the buffer.
+static fml::jni::ScopedJavaLocalRef<jobject> NewDirectByteBuffer(
+    JNIEnv* env,
+    const uint8_t* data,
+    size_t size) {
+  // JNI may return null for a buffer with a null address.
+  static uint8_t empty_buffer;
+  void* address = size > 0 ? const_cast<uint8_t*>(data) : &empty_buffer;
+  return fml::jni::ScopedJavaLocalRef<jobject>(
+      env, env->NewDirectByteBuffer(address, size));
+}
+
 static std::unique_ptr<AndroidSurface> InitializePlatformSurface() {
   if (blink::Settings::Get().enable_software_rendering) {
     if (auto surface = InitializePlatformSurfaceSoftware()) {
@@ -138,6 +155,18 @@ void PlatformViewAndroid::Attach() {
   // Eagerly setup the IO thread context. We have already setup the surface.
   SetupResourceContextOnIOThread();
 
+  const blink::Settings& settings = blink::Settings::Get();
+  if (settings.enable_hardware_image_buffers &&
+      !settings.enable_software_rendering &&
+      android_surface_->SupportsHardwareImageBuffers()) {
+    static bool allocator_installed = false;
+    if (!allocator_installed) {
+      allocator_installed = true;
+      blink::HardwareImageAllocator::Set(
+          AndroidHardwareImageAllocator::Create());
+    }
+  }
+
   UpdateThreadPriorities();
 
   PostAddToShellTask();
@@ -155,19 +184,28 @@ void PlatformViewAndroid::SurfaceCreated(JNIEnv* env,
   // workaround for https://code.google.com/p/android/issues/detail?id=68174
   fml::jni::ScopedJavaLocalFrame scoped_local_reference_frame(env);
 
-  // We have a drawing surface, so swap in a non-Null rasterizer.
-  SetRasterizer(std::make_unique<GPURasterizer>(nullptr));
+  auto native_window = fxl::MakeRefCounted<AndroidNativeWindow>(
+      ANativeWindow_fromSurface(env, jsurface));
 
-  rasterizer_->AddNextFrameCallback([this]() {
-    JNIEnv* env = fml::jni::AttachCurrentThread();
-    fml::jni::ScopedJavaLocalRef<jobject> view = flutter_view_.get(env);
-    if (!view.is_null()) {
-      FlutterViewOnFirstFrame(env, view.obj());
+  // The rasterizer kept by SurfaceDestroyed draws into the new window with
+  // the GrContext, raster cache and compiled programs it already has.
+  if (surface_suspended_) {
+    surface_suspended_ = false;
+    if (native_window->IsValid() &&
+        android_surface_->SetNativeWindow(native_window)) {
+      AddFirstFrameCallback();
+      NotifyResumed([
+        this, backgroundColor, native_window_size = native_window->GetSize()
+      ] { rasterizer().Clear(backgroundColor, native_window_size); });
+      return;
     }
-  });
+    ReleaseSurface();
+  }
 
-  auto native_window = fxl::MakeRefCounted<AndroidNativeWindow>(
-      ANativeWindow_fromSurface(env, jsurface));
+  // We have a drawing surface, so swap in a non-Null rasterizer.
+  SetRasterizer(std::make_unique<GPURasterizer>(nullptr));
+
+  AddFirstFrameCallback();
 
   if (!native_window->IsValid()) {
     return;
@@ -188,6 +226,16 @@ void PlatformViewAndroid::SurfaceCreated(JNIEnv* env,
   ] { rasterizer().Clear(backgroundColor, native_window_size); });
 }
 
+void PlatformViewAndroid::AddFirstFrameCallback() {
+  rasterizer_->AddNextFrameCallback([this]() {
+    JNIEnv* env = fml::jni::AttachCurrentThread();
+    fml::jni::ScopedJavaLocalRef<jobject> view = flutter_view_.get(env);
+    if (!view.is_null()) {
+      FlutterViewOnFirstFrame(env, view.obj());
+    }
+  });
+}
+
 void PlatformViewAndroid::SurfaceChanged(jint width, jint height) {
   blink::Threads::Gpu()->PostTask([this, width, height]() {
     if (android_surface_) {
@@ -205,6 +253,13 @@ void PlatformViewAndroid::UpdateThreadPriorities() {
 }
 
 void PlatformViewAndroid::SurfaceDestroyed() {
+  // Only the window goes away when the application is backgrounded or
+  // resized, so the rasterizer keeps its GrContext and caches for the next
+  // one if the onscreen context can outlive the window.
+  if (NotifySuspended() && android_surface_->DetachOnScreenContext()) {
+    surface_suspended_ = true;
+    return;
+  }
   ReleaseSurface();
 }
 
@@ -353,16 +408,19 @@ void PlatformViewAndroid::HandlePlatformMessage(
   }
   auto java_channel = fml::jni::StringToJavaString(env, message->channel());
   if (message->hasData()) {
-    fml::jni::ScopedJavaLocalRef<jbyteArray> message_array(
-        env, env->NewByteArray(message->data().size()));
-    env->SetByteArrayRegion(
-        message_array.obj(), 0, message->data().size(),
-        reinterpret_cast<const jbyte*>(message->data().data()));
+    // Java reads the payload in place. It is released once the handler has
+    // returned.
+    uint8_t* data = nullptr;
+    size_t size = 0;
+    fxl::Closure release = message->TakeData(&data, &size);
     message = nullptr;
+    fml::jni::ScopedJavaLocalRef<jobject> message_buffer =
+        NewDirectByteBuffer(env, data, size);
 
     // This call can re-enter in InvokePlatformMessageXxxResponseCallback.
     FlutterViewHandlePlatformMessage(env, view.obj(), java_channel.obj(),
-                                     message_array.obj(), response_id);
+                                     message_buffer.obj(), response_id);
+    release();
   } else {
     message = nullptr;
 
@@ -381,13 +439,12 @@ void PlatformViewAndroid::HandlePlatformMessageResponse(
 
   if (view.is_null())
     return;
-  fml::jni::ScopedJavaLocalRef<jbyteArray> data_array(
-      env, env->NewByteArray(data.size()));
-  env->SetByteArrayRegion(data_array.obj(), 0, data.size(),
-                          reinterpret_cast<const jbyte*>(data.data()));
+  // Java reads the response in place while the reply handler runs.
+  fml::jni::ScopedJavaLocalRef<jobject> data_buffer =
+      NewDirectByteBuffer(env, data.data(), data.size());
 
   FlutterViewHandlePlatformMessageResponse(env, view.obj(), response_id,
-                                           data_array.obj());
+                                           data_buffer.obj());
 }
 
 void PlatformViewAndroid::HandlePlatformMessageEmptyResponse(int response_id) {
@@ -407,10 +464,25 @@ void PlatformViewAndroid::DispatchSemanticsAction(jint id, jint action) {
 }
 
 void PlatformViewAndroid::SetSemanticsEnabled(jboolean enabled) {
+  // The AccessibilityBridge enabling semantics is a new one.
+  ResetSemantics();
   PlatformView::SetSemanticsEnabled(enabled);
 }
 
+void PlatformViewAndroid::ResetSemantics() {
+  semantics_nodes_.clear();
+  semantics_label_ids_.clear();
+}
+
+void PlatformViewAndroid::RegisterExternalTexture(
+    int64_t texture_id,
+    const fml::jni::JavaObjectWeakGlobalRef& surface_texture) {
+  RegisterTexture(
+      std::make_shared<AndroidExternalTextureGL>(texture_id, surface_texture));
+}
+
 void PlatformViewAndroid::ReleaseSurface() {
+  surface_suspended_ = false;
   NotifyDestroyed();
   android_surface_->TeardownOnScreenContext();
   SetRasterizer(std::make_unique<NullRasterizer>());
@@ -427,10 +499,19 @@ bool PlatformViewAndroid::ResourceContextMakeCurrent() {
   return android_surface_->ResourceContextMakeCurrent();
 }
 
+sk_sp<GrContext> PlatformViewAndroid::CreateResourceContext(
+    const GrContextOptions& options) {
+  FXL_CHECK(android_surface_);
+  if (auto context = android_surface_->CreateResourceContext(options)) {
+    return context;
+  }
+  return PlatformView::CreateResourceContext(options);
+}
+
 void PlatformViewAndroid::UpdateSemantics(
     std::vector<blink::SemanticsNode> update) {
-  constexpr size_t kBytesPerNode = 26 * sizeof(int32_t);
-  constexpr size_t kBytesPerChild = sizeof(int32_t);
+  // The interned labels start over once there are this many.
+  constexpr size_t kMaxSemanticsLabels = 1000;
 
   JNIEnv* env = fml::jni::AttachCurrentThread();
   {
@@ -438,44 +519,101 @@ void PlatformViewAndroid::UpdateSemantics(
     if (view.is_null())
       return;
 
-    size_t num_bytes = 0;
-    for (const blink::SemanticsNode& node : update) {
-      num_bytes += kBytesPerNode;
-      num_bytes += node.children.size() * kBytesPerChild;
-    }
+    if (semantics_label_ids_.size() >= kMaxSemanticsLabels)
+      semantics_label_ids_.clear();
 
-    std::vector<uint8_t> buffer(num_bytes);
-    int32_t* buffer_int32 = reinterpret_cast<int32_t*>(&buffer[0]);
-    float* buffer_float32 = reinterpret_cast<float*>(&buffer[0]);
+    // The layout is described in AccessibilityBridge.updateSemantics. Floats
+    // are stored bitwise.
+    std::vector<int32_t> buffer;
+    auto push_float = [&buffer](float value) {
+      int32_t bits;
+      memcpy(&bits, &value, sizeof(bits));
+      buffer.push_back(bits);
+    };
+    buffer.push_back(semantics_label_ids_.size());
 
     std::vector<std::string> strings;
-    size_t position = 0;
-    for (const blink::SemanticsNode& node : update) {
-      // If you edit this code, make sure you update kBytesPerNode
-      // above to match the number of values you are sending.
-      buffer_int32[position++] = node.id;
-      buffer_int32[position++] = node.flags;
-      buffer_int32[position++] = node.actions;
-      if (node.label.empty()) {
-        buffer_int32[position++] = -1;
-      } else {
-        buffer_int32[position++] = strings.size();
-        strings.push_back(node.label);
+    bool children_changed = false;
+    for (blink::SemanticsNode& node : update) {
+      auto previous = semantics_nodes_.find(node.id);
+      const int32_t fields = previous == semantics_nodes_.end()
+                                 ? blink::SemanticsNode::kAllFields
+                                 : previous->second.GetChangedFields(node);
+      if (fields == 0)
+        continue;
+
+      buffer.push_back(node.id);
+      buffer.push_back(fields);
+      if (fields & blink::SemanticsNode::kFlagsField)
+        buffer.push_back(node.flags);
+      if (fields & blink::SemanticsNode::kActionsField)
+        buffer.push_back(node.actions);
+      if (fields & blink::SemanticsNode::kLabelField) {
+        if (node.label.empty()) {
+          buffer.push_back(-1);
+        } else {
+          auto inserted = semantics_label_ids_.insert(
+              {node.label, static_cast<int32_t>(semantics_label_ids_.size())});
+          if (inserted.second)
+            strings.push_back(node.label);
+          buffer.push_back(inserted.first->second);
+        }
+      }
+      if (fields & blink::SemanticsNode::kTextDirectionField)
+        buffer.push_back(node.textDirection);
+      if (fields & blink::SemanticsNode::kRectField) {
+        push_float(node.rect.left());
+        push_float(node.rect.top());
+        push_float(node.rect.right());
+        push_float(node.rect.bottom());
+      }
+      if (fields & blink::SemanticsNode::kTransformField) {
+        float transform[16];
+        node.transform.asColMajorf(transform);
+        for (float value : transform)
+          push_float(value);
+      }
+      if (fields & blink::SemanticsNode::kChildrenField) {
+        buffer.push_back(node.children.size());
+        buffer.insert(buffer.end(), node.children.begin(),
+                      node.children.end());
+        children_changed = true;
+      }
+
+      semantics_nodes_[node.id] = std::move(node);
+    }
+
+    if (buffer.size() == 1) {
+      // Nothing changed.
+      return;
+    }
+
+    if (children_changed) {
+      // Forget the nodes no longer reachable from the root, like the
+      // AccessibilityBridge does.
+      std::unordered_set<int32_t> reachable;
+      std::vector<int32_t> pending = {0};
+      while (!pending.empty()) {
+        const int32_t id = pending.back();
+        pending.pop_back();
+        auto found = semantics_nodes_.find(id);
+        if (found == semantics_nodes_.end() || !reachable.insert(id).second)
+          continue;
+        pending.insert(pending.end(), found->second.children.begin(),
+                       found->second.children.end());
+      }
+      for (auto it = semantics_nodes_.begin(); it != semantics_nodes_.end();) {
+        if (reachable.count(it->first) == 0) {
+          it = semantics_nodes_.erase(it);
+        } else {
+          ++it;
+        }
       }
-      buffer_int32[position++] = node.textDirection;
-      buffer_float32[position++] = node.rect.left();
-      buffer_float32[position++] = node.rect.top();
-      buffer_float32[position++] = node.rect.right();
-      buffer_float32[position++] = node.rect.bottom();
-      node.transform.asColMajorf(&buffer_float32[position]);
-      position += 16;
-      buffer_int32[position++] = node.children.size();
-      for (int32_t child : node.children)
-        buffer_int32[position++] = child;
     }
 
     fml::jni::ScopedJavaLocalRef<jobject> direct_buffer(
-        env, env->NewDirectByteBuffer(buffer.data(), buffer.size()));
+        env, env->NewDirectByteBuffer(buffer.data(),
+                                      buffer.size() * sizeof(int32_t)));
 
     FlutterViewUpdateSemantics(
         env, view.obj(), direct_buffer.obj(),
@@ -12,6 +12,7 @@
 
 #include "flutter/fml/platform/android/jni_weak_ref.h"
 #include "flutter/fml/platform/android/scoped_java_ref.h"
+#include "flutter/lib/ui/semantics/semantics_node.h"
 #include "flutter/lib/ui/window/platform_message.h"
 #include "flutter/shell/common/platform_view.h"
 #include "flutter/shell/platform/android/android_native_window.h"
@@ -78,12 +79,23 @@ class PlatformViewAndroid : public PlatformView {
 
   void SetSemanticsEnabled(jboolean enabled);
 
+  // Forgets what has been sent to the AccessibilityBridge after it has
+  // discarded its nodes, so that the next update sends them whole.
+  void ResetSemantics();
+
+  void RegisterExternalTexture(
+      int64_t texture_id,
+      const fml::jni::JavaObjectWeakGlobalRef& surface_texture);
+
   fml::jni::ScopedJavaLocalRef<jobject> GetBitmap(JNIEnv* env);
 
   VsyncWaiter* GetVsyncWaiter() override;
 
   bool ResourceContextMakeCurrent() override;
 
+  sk_sp<GrContext> CreateResourceContext(
+      const GrContextOptions& options) override;
+
   void UpdateSemantics(std::vector<blink::SemanticsNode> update) override;
 
   void HandlePlatformMessage(
@@ -107,11 +119,20 @@ class PlatformViewAndroid : public PlatformView {
   fml::jni::JavaObjectWeakGlobalRef flutter_view_;
   // We use id 0 to mean that no response is expected.
   int next_response_id_ = 1;
+  // Whether the rasterizer kept its surface when the window was destroyed.
+  bool surface_suspended_ = false;
   std::unordered_map<int, fxl::RefPtr<blink::PlatformMessageResponse>>
       pending_responses_;
+  // The semantics nodes as last sent to the AccessibilityBridge, so that
+  // updates only carry the fields that changed.
+  std::unordered_map<int32_t, blink::SemanticsNode> semantics_nodes_;
+  // The labels sent to the AccessibilityBridge, which refers to them by id.
+  std::unordered_map<std::string, int32_t> semantics_label_ids_;
 
   void UpdateThreadPriorities();
 
+  void AddFirstFrameCallback();
+
   void ReleaseSurface();
 
   void GetBitmapGpuTask(jobject* pixels_out, SkISize* size_out);
@@ -17,6 +17,7 @@
 namespace shell {
 
 static fml::jni::ScopedJavaGlobalRef<jclass>* g_flutter_view_class = nullptr;
+static fml::jni::ScopedJavaGlobalRef<jclass>* g_surface_texture_class = nullptr;
 
 // Called By Native
 
@@ -56,6 +57,35 @@ void FlutterViewOnFirstFrame(JNIEnv* env, jobject obj) {
   FXL_CHECK(env->ExceptionCheck() == JNI_FALSE);
 }
 
+// The SurfaceTexture may have been released by its owner. That only means the
+// texture stops receiving frames, so the exception is cleared.
+
+static jmethodID g_attach_to_gl_context_method = nullptr;
+void SurfaceTextureAttachToGLContext(JNIEnv* env, jobject obj, jint textureId) {
+  env->CallVoidMethod(obj, g_attach_to_gl_context_method, textureId);
+  fml::jni::ClearException(env);
+}
+
+static jmethodID g_update_tex_image_method = nullptr;
+void SurfaceTextureUpdateTexImage(JNIEnv* env, jobject obj) {
+  env->CallVoidMethod(obj, g_update_tex_image_method);
+  fml::jni::ClearException(env);
+}
+
+static jmethodID g_get_transform_matrix_method = nullptr;
+void SurfaceTextureGetTransformMatrix(JNIEnv* env,
+                                      jobject obj,
+                                      jfloatArray result) {
+  env->CallVoidMethod(obj, g_get_transform_matrix_method, result);
+  fml::jni::ClearException(env);
+}
+
+static jmethodID g_detach_from_gl_context_method = nullptr;
+void SurfaceTextureDetachFromGLContext(JNIEnv* env, jobject obj) {
+  env->CallVoidMethod(obj, g_detach_from_gl_context_method);
+  fml::jni::ClearException(env);
+}
+
 // Called By Java
 
 static jlong Attach(JNIEnv* env, jclass clazz, jobject flutterView) {
@@ -192,6 +222,44 @@ static void SetSemanticsEnabled(JNIEnv* env,
   return PLATFORM_VIEW->SetSemanticsEnabled(enabled);
 }
 
+static void ResetSemantics(JNIEnv* env, jobject jcaller, jlong platform_view) {
+  return PLATFORM_VIEW->ResetSemantics();
+}
+
+static void NotifyMemoryPressure(JNIEnv* env,
+                                 jobject jcaller,
+                                 jlong platform_view,
+                                 jboolean critical) {
+  return PLATFORM_VIEW->NotifyMemoryPressure(
+      critical ? MemoryPressureLevel::kCritical
+               : MemoryPressureLevel::kModerate);
+}
+
+static void RegisterTexture(JNIEnv* env,
+                            jobject jcaller,
+                            jlong platform_view,
+                            jlong texture_id,
+                            jobject surface_texture) {
+  PLATFORM_VIEW->RegisterExternalTexture(
+      static_cast<int64_t>(texture_id),
+      fml::jni::JavaObjectWeakGlobalRef(env, surface_texture));
+}
+
+static void MarkTextureFrameAvailable(JNIEnv* env,
+                                      jobject jcaller,
+                                      jlong platform_view,
+                                      jlong texture_id) {
+  return PLATFORM_VIEW->MarkTextureFrameAvailable(
+      static_cast<int64_t>(texture_id));
+}
+
+static void UnregisterTexture(JNIEnv* env,
+                              jobject jcaller,
+                              jlong platform_view,
+                              jlong texture_id) {
+  return PLATFORM_VIEW->UnregisterTexture(static_cast<int64_t>(texture_id));
+}
+
 static jboolean GetIsSoftwareRendering(JNIEnv* env, jobject jcaller) {
   return blink::Settings::Get().enable_software_rendering;
 }
@@ -305,6 +373,16 @@ bool PlatformViewAndroid::Register(JNIEnv* env) {
           .signature = "(JZ)V",
           .fnPtr = reinterpret_cast<void*>(&shell::SetSemanticsEnabled),
       },
+      {
+          .name = "nativeResetSemantics",
+          .signature = "(J)V",
+          .fnPtr = reinterpret_cast<void*>(&shell::ResetSemantics),
+      },
+      {
+          .name = "nativeNotifyMemoryPressure",
+          .signature = "(JZ)V",
+          .fnPtr = reinterpret_cast<void*>(&shell::NotifyMemoryPressure),
+      },
       {
           .name = "nativeInvokePlatformMessageResponseCallback",
           .signature = "(JILjava/nio/ByteBuffer;I)V",
@@ -322,6 +400,21 @@ bool PlatformViewAndroid::Register(JNIEnv* env) {
           .signature = "()Z",
           .fnPtr = reinterpret_cast<void*>(&shell::GetIsSoftwareRendering),
       },
+      {
+          .name = "nativeRegisterTexture",
+          .signature = "(JJLandroid/graphics/SurfaceTexture;)V",
+          .fnPtr = reinterpret_cast<void*>(&shell::RegisterTexture),
+      },
+      {
+          .name = "nativeMarkTextureFrameAvailable",
+          .signature = "(JJ)V",
+          .fnPtr = reinterpret_cast<void*>(&shell::MarkTextureFrameAvailable),
+      },
+      {
+          .name = "nativeUnregisterTexture",
+          .signature = "(JJ)V",
+          .fnPtr = reinterpret_cast<void*>(&shell::UnregisterTexture),
+      },
   };
 
   if (env->RegisterNatives(g_flutter_view_class->obj(), methods,
@@ -331,14 +424,15 @@ bool PlatformViewAndroid::Register(JNIEnv* env) {
 
   g_handle_platform_message_method =
       env->GetMethodID(g_flutter_view_class->obj(), "handlePlatformMessage",
-                       "(Ljava/lang/String;[BI)V");
+                       "(Ljava/lang/String;Ljava/nio/ByteBuffer;I)V");
 
   if (g_handle_platform_message_method == nullptr) {
     return false;
   }
 
   g_handle_platform_message_response_method = env->GetMethodID(
-      g_flutter_view_class->obj(), "handlePlatformMessageResponse", "(I[B)V");
+      g_flutter_view_class->obj(), "handlePlatformMessageResponse",
+      "(ILjava/nio/ByteBuffer;)V");
 
   if (g_handle_platform_message_response_method == nullptr) {
     return false;
@@ -358,6 +452,42 @@ bool PlatformViewAndroid::Register(JNIEnv* env) {
   if (g_on_first_frame_method == nullptr) {
     return false;
   }
+
+  g_surface_texture_class = new fml::jni::ScopedJavaGlobalRef<jclass>(
+      env, env->FindClass("android/graphics/SurfaceTexture"));
+
+  if (g_surface_texture_class->is_null()) {
+    return false;
+  }
+
+  g_attach_to_gl_context_method = env->GetMethodID(
+      g_surface_texture_class->obj(), "attachToGLContext", "(I)V");
+
+  if (g_attach_to_gl_context_method == nullptr) {
+    return false;
+  }
+
+  g_update_tex_image_method =
+      env->GetMethodID(g_surface_texture_class->obj(), "updateTexImage", "()V");
+
+  if (g_update_tex_image_method == nullptr) {
+    return false;
+  }
+
+  g_get_transform_matrix_method = env->GetMethodID(
+      g_surface_texture_class->obj(), "getTransformMatrix", "([F)V");
+
+  if (g_get_transform_matrix_method == nullptr) {
+    return false;
+  }
+
+  g_detach_from_gl_context_method = env->GetMethodID(
+      g_surface_texture_class->obj(), "detachFromGLContext", "()V");
+
+  if (g_detach_from_gl_context_method == nullptr) {
+    return false;
+  }
+
   return true;
 }
 
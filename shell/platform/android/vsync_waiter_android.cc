@@ -4,12 +4,16 @@
 
 #include "flutter/shell/platform/android/vsync_waiter_android.h"
 
+#include <dlfcn.h>
+
+#include <atomic>
 #include <cmath>
 #include <utility>
 
 #include "flutter/common/threads.h"
 #include "flutter/fml/platform/android/jni_util.h"
 #include "flutter/fml/platform/android/scoped_java_ref.h"
+#include "flutter/fml/task_priority.h"
 #include "flutter/fml/trace_event.h"
 #include "lib/fxl/arraysize.h"
 #include "lib/fxl/logging.h"
@@ -19,6 +23,69 @@ namespace shell {
 static fml::jni::ScopedJavaGlobalRef<jclass>* g_vsync_waiter_class = nullptr;
 static jmethodID g_async_wait_for_vsync_method_ = nullptr;
 
+// Set by the Java VsyncWaiter from the refresh rate of the display.
+static std::atomic<int64_t> g_refresh_period_nanos(
+    kDefaultRefreshInterval.ToNanoseconds());
+
+namespace {
+
+// AChoreographer is only available from API level 24, so its entry points are
+// resolved at runtime. These mirror <android/choreographer.h>.
+using FrameCallback64 = void (*)(int64_t frame_time_nanos, void* data);
+using FrameCallback = void (*)(long frame_time_nanos, void* data);
+
+struct ChoreographerFunctions {
+  AChoreographer* (*get_instance)();
+  // Only available from API level 29.
+  void (*post_frame_callback_64)(AChoreographer*, FrameCallback64, void*);
+  void (*post_frame_callback)(AChoreographer*, FrameCallback, void*);
+};
+
+// Returns null if AChoreographer cannot be used, in which case frame
+// callbacks are requested from the Java Choreographer over JNI.
+const ChoreographerFunctions* GetChoreographerFunctions() {
+  static const ChoreographerFunctions* functions =
+      []() -> const ChoreographerFunctions* {
+    void* library = dlopen("libandroid.so", RTLD_NOW | RTLD_LOCAL);
+    if (library == nullptr) {
+      return nullptr;
+    }
+    auto* resolved = new ChoreographerFunctions();
+    resolved->get_instance = reinterpret_cast<AChoreographer* (*)()>(
+        dlsym(library, "AChoreographer_getInstance"));
+    resolved->post_frame_callback_64 = reinterpret_cast<void (*)(
+        AChoreographer*, FrameCallback64, void*)>(
+        dlsym(library, "AChoreographer_postFrameCallback64"));
+    resolved->post_frame_callback =
+        reinterpret_cast<void (*)(AChoreographer*, FrameCallback, void*)>(
+            dlsym(library, "AChoreographer_postFrameCallback"));
+    // Where long is 32 bits, the frame times of the older entry point wrap
+    // around every few seconds.
+    const bool can_post = resolved->post_frame_callback_64 != nullptr ||
+                          (sizeof(long) == sizeof(int64_t) &&
+                           resolved->post_frame_callback != nullptr);
+    if (resolved->get_instance == nullptr || !can_post) {
+      delete resolved;
+      return nullptr;
+    }
+    return resolved;
+  }();
+  return functions;
+}
+
+void OnChoreographerFrame(int64_t frame_time_nanos, void* data) {
+  TRACE_EVENT1("flutter", "VSYNC", "mode", "basic");
+  auto* weak = reinterpret_cast<fxl::WeakPtr<VsyncWaiterAndroid>*>(data);
+  VsyncWaiterAndroid* waiter = weak->get();
+  delete weak;
+  if (waiter) {
+    waiter->OnVsync(frame_time_nanos,
+                    frame_time_nanos + g_refresh_period_nanos.load());
+  }
+}
+
+}  // namespace
+
 VsyncWaiterAndroid::VsyncWaiterAndroid() : weak_factory_(this) {}
 
 VsyncWaiterAndroid::~VsyncWaiterAndroid() = default;
@@ -30,6 +97,10 @@ void VsyncWaiterAndroid::AsyncWaitForVsync(Callback callback) {
       new fxl::WeakPtr<VsyncWaiterAndroid>();
   *weak = weak_factory_.GetWeakPtr();
 
+  if (PostChoreographerFrameCallback(weak)) {
+    return;
+  }
+
   blink::Threads::Platform()->PostTask([weak] {
     JNIEnv* env = fml::jni::AttachCurrentThread();
     env->CallStaticVoidMethod(g_vsync_waiter_class->obj(),
@@ -38,10 +109,42 @@ void VsyncWaiterAndroid::AsyncWaitForVsync(Callback callback) {
   });
 }
 
+bool VsyncWaiterAndroid::PostChoreographerFrameCallback(
+    fxl::WeakPtr<VsyncWaiterAndroid>* weak) {
+  const ChoreographerFunctions* functions = GetChoreographerFunctions();
+  if (functions == nullptr) {
+    return false;
+  }
+
+  // The choreographer of the calling thread. Requests are made on the UI
+  // thread, whose message loop is an ALooper, so the frame callbacks are
+  // delivered to it directly instead of by way of the platform thread.
+  if (choreographer_ == nullptr) {
+    choreographer_ = functions->get_instance();
+    if (choreographer_ == nullptr) {
+      return false;
+    }
+  }
+
+  if (functions->post_frame_callback_64 != nullptr) {
+    functions->post_frame_callback_64(choreographer_, &OnChoreographerFrame,
+                                      weak);
+  } else {
+    functions->post_frame_callback(
+        choreographer_,
+        [](long frame_time_nanos, void* data) {
+          OnChoreographerFrame(frame_time_nanos, data);
+        },
+        weak);
+  }
+  return true;
+}
+
 void VsyncWaiterAndroid::OnVsync(int64_t frameTimeNanos,
                                  int64_t frameTargetTimeNanos) {
   Callback callback = std::move(callback_);
   callback_ = Callback();
+  fml::ScopedTaskPriority priority(fml::TaskPriority::kFrameCritical);
   blink::Threads::UI()->PostTask(
       [callback, frameTimeNanos, frameTargetTimeNanos] {
         callback(fxl::TimePoint::FromEpochDelta(
@@ -80,12 +183,27 @@ static void OnNativeVsync(JNIEnv* env,
   }
 }
 
+static void SetRefreshPeriodNanos(JNIEnv* env,
+                                  jclass jcaller,
+                                  jlong refreshPeriodNanos) {
+  if (refreshPeriodNanos > 0) {
+    g_refresh_period_nanos.store(refreshPeriodNanos);
+  }
+}
+
 bool VsyncWaiterAndroid::Register(JNIEnv* env) {
-  static const JNINativeMethod methods[] = {{
-      .name = "nativeOnVsync",
-      .signature = "(JJJ)V",
-      .fnPtr = reinterpret_cast<void*>(&OnNativeVsync),
-  }};
+  static const JNINativeMethod methods[] = {
+      {
+          .name = "nativeOnVsync",
+          .signature = "(JJJ)V",
+          .fnPtr = reinterpret_cast<void*>(&OnNativeVsync),
+      },
+      {
+          .name = "nativeSetRefreshPeriodNanos",
+          .signature = "(J)V",
+          .fnPtr = reinterpret_cast<void*>(&SetRefreshPeriodNanos),
+      },
+  };
 
   jclass clazz = env->FindClass("io/flutter/view/VsyncWaiter");
 
@@ -10,6 +10,9 @@
 #include "lib/fxl/macros.h"
 #include "lib/fxl/memory/weak_ptr.h"
 
+// From <android/choreographer.h>.
+struct AChoreographer;
+
 namespace shell {
 
 class VsyncWaiterAndroid : public VsyncWaiter {
@@ -26,10 +29,16 @@ class VsyncWaiterAndroid : public VsyncWaiter {
 
  private:
   Callback callback_;
+  // Only used on the UI thread.
+  AChoreographer* choreographer_ = nullptr;
   fxl::WeakPtr<VsyncWaiterAndroid> self_;
 
   fxl::WeakPtrFactory<VsyncWaiterAndroid> weak_factory_;
 
+  // Requests the next frame callback from the NDK choreographer, without
+  // calling into Java. Returns false if it is unavailable.
+  bool PostChoreographerFrameCallback(fxl::WeakPtr<VsyncWaiterAndroid>* weak);
+
   FXL_DISALLOW_COPY_AND_ASSIGN(VsyncWaiterAndroid);
 };
 
@@ -15,6 +15,10 @@ std::vector<uint8_t> GetVectorFromNSData(NSData* data);
 
 NSData* GetNSDataFromVector(const std::vector<uint8_t>& buffer);
 
+// Wraps the bytes of |buffer| without copying them. They are freed along with
+// the returned data.
+NSData* ConvertVectorToNSData(std::vector<uint8_t> buffer);
+
 }  // namespace shell
 
 #endif  // FLUTTER_SHELL_PLATFORM_DARWIN_COMMON_BUFFER_CONVERSIONS_H_
@@ -15,4 +15,17 @@ NSData* GetNSDataFromVector(const std::vector<uint8_t>& buffer) {
   return [NSData dataWithBytes:buffer.data() length:buffer.size()];
 }
 
+NSData* ConvertVectorToNSData(std::vector<uint8_t> buffer) {
+  if (buffer.empty()) {
+    return [NSData data];
+  }
+  // Move the vector to the heap so that the bytes stay where they are.
+  auto* vector = new std::vector<uint8_t>(std::move(buffer));
+  return [[[NSData alloc] initWithBytesNoCopy:vector->data()
+                                       length:vector->size()
+                                  deallocator:^(void*, NSUInteger) {
+                                    delete vector;
+                                  }] autorelease];
+}
+
 }  // namespace shell
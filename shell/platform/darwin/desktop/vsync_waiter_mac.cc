@@ -7,6 +7,7 @@
 #include <CoreVideo/CoreVideo.h>
 
 #include "flutter/common/threads.h"
+#include "flutter/fml/task_priority.h"
 #include "lib/fxl/logging.h"
 
 namespace shell {
@@ -51,6 +52,7 @@ void VsyncWaiterMac::OnDisplayLink() {
   auto callback = std::move(callback_);
   callback_ = Callback();
 
+  fml::ScopedTaskPriority priority(fml::TaskPriority::kFrameCritical);
   blink::Threads::UI()->PostTask(
       [callback, frame_start_time, frame_target_time] {
         callback(frame_start_time, frame_target_time);
@@ -0,0 +1,51 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FLUTTERTEXTURE_H_
+#define FLUTTER_FLUTTERTEXTURE_H_
+
+#import <CoreVideo/CoreVideo.h>
+#import <Foundation/Foundation.h>
+
+#include "FlutterMacros.h"
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ A source of frames for a `Texture` widget, such as a camera or a video player.
+ */
+FLUTTER_EXPORT
+@protocol FlutterTexture<NSObject>
+/**
+ Returns the most recent frame, or `NULL` if there is none. The caller takes
+ ownership of the returned buffer. Called on the GPU thread.
+ */
+- (CVPixelBufferRef _Nullable)copyPixelBuffer;
+@end
+
+/**
+ Registers `FlutterTexture`s so that Flutter can composite them.
+ */
+FLUTTER_EXPORT
+@protocol FlutterTextureRegistry<NSObject>
+/**
+ Registers `texture` and returns the id the Dart side passes to the `Texture`
+ widget.
+ */
+- (int64_t)registerTexture:(NSObject<FlutterTexture>*)texture;
+
+/**
+ Tells Flutter that the texture with id `textureId` has a new frame.
+ */
+- (void)textureFrameAvailable:(int64_t)textureId;
+
+/**
+ Stops compositing the texture with id `textureId` and releases it.
+ */
+- (void)unregisterTexture:(int64_t)textureId;
+@end
+
+NS_ASSUME_NONNULL_END
+
+#endif  // FLUTTER_FLUTTERTEXTURE_H_
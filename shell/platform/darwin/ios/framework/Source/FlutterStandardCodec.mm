@@ -4,6 +4,11 @@
 
 #include "FlutterStandardCodec_Internal.h"
 
+#include <memory>
+#include <vector>
+
+#include "flutter/shell/common/standard_codec_stream.h"
+
 #pragma mark - Codec for basic message channel
 
 @implementation FlutterStandardMessageCodec
@@ -199,6 +204,7 @@ using namespace shell;
 
 @implementation FlutterStandardWriter {
   NSMutableData* _data;
+  std::unique_ptr<StandardCodecWriter> _writer;
 }
 
 + (instancetype)writerWithData:(NSMutableData*)data {
@@ -211,6 +217,7 @@ using namespace shell;
   self = [super init];
   NSAssert(self, @"Super init cannot be nil");
   _data = [data retain];
+  _writer = std::make_unique<StandardCodecWriter>(data.length);
   return self;
 }
 
@@ -219,69 +226,60 @@ using namespace shell;
   [super dealloc];
 }
 
-- (void)writeByte:(UInt8)value {
-  [_data appendBytes:&value length:1];
-}
-
-- (void)writeSize:(UInt32)size {
-  if (size < 254) {
-    [self writeByte:(UInt8)size];
-  } else if (size <= 0xffff) {
-    [self writeByte:254];
-    UInt16 value = (UInt16)size;
-    [_data appendBytes:&value length:2];
-  } else {
-    [self writeByte:255];
-    [_data appendBytes:&size length:4];
+// Values are encoded into a C++ buffer and appended to |_data| in one call per
+// top level value.
+- (void)flush {
+  const std::vector<uint8_t>& buffer = _writer->buffer();
+  if (!buffer.empty()) {
+    [_data appendBytes:buffer.data() length:buffer.size()];
   }
+  _writer->Flush();
 }
 
-- (void)writeAlignment:(UInt8)alignment {
-  UInt8 mod = _data.length % alignment;
-  if (mod) {
-    for (int i = 0; i < (alignment - mod); i++) {
-      [self writeByte:0];
-    }
-  }
+- (void)writeByte:(UInt8)value {
+  _writer->WriteByte(value);
+  [self flush];
 }
 
 - (void)writeUTF8:(NSString*)value {
   UInt32 length = [value lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
-  [self writeSize:length];
-  [_data appendBytes:value.UTF8String length:length];
+  _writer->WriteSize(length);
+  _writer->WriteBytes(value.UTF8String, length);
 }
 
 - (void)writeValue:(id)value {
+  [self encodeValue:value];
+  [self flush];
+}
+
+- (void)encodeValue:(id)value {
   if (value == nil || value == [NSNull null]) {
-    [self writeByte:FlutterStandardFieldNil];
+    _writer->WriteByte(FlutterStandardFieldNil);
   } else if ([value isKindOfClass:[NSNumber class]]) {
     NSNumber* number = value;
     const char* type = [number objCType];
     if ([self isBool:number type:type]) {
       BOOL b = number.boolValue;
-      [self writeByte:(b ? FlutterStandardFieldTrue : FlutterStandardFieldFalse)];
+      _writer->WriteByte(b ? FlutterStandardFieldTrue : FlutterStandardFieldFalse);
     } else if (strcmp(type, @encode(signed int)) == 0 || strcmp(type, @encode(signed short)) == 0 ||
                strcmp(type, @encode(unsigned short)) == 0 ||
                strcmp(type, @encode(signed char)) == 0 ||
                strcmp(type, @encode(unsigned char)) == 0) {
-      SInt32 n = number.intValue;
-      [self writeByte:FlutterStandardFieldInt32];
-      [_data appendBytes:(UInt8*)&n length:4];
+      _writer->WriteByte(FlutterStandardFieldInt32);
+      _writer->Write<SInt32>(number.intValue);
     } else if (strcmp(type, @encode(signed long)) == 0 ||
                strcmp(type, @encode(unsigned int)) == 0) {
-      SInt64 n = number.longValue;
-      [self writeByte:FlutterStandardFieldInt64];
-      [_data appendBytes:(UInt8*)&n length:8];
+      _writer->WriteByte(FlutterStandardFieldInt64);
+      _writer->Write<SInt64>(number.longValue);
     } else if (strcmp(type, @encode(double)) == 0 || strcmp(type, @encode(float)) == 0) {
-      Float64 f = number.doubleValue;
-      [self writeByte:FlutterStandardFieldFloat64];
-      [self writeAlignment:8];
-      [_data appendBytes:(UInt8*)&f length:8];
+      _writer->WriteByte(FlutterStandardFieldFloat64);
+      _writer->WriteAlignment(8);
+      _writer->Write<Float64>(number.doubleValue);
     } else if (strcmp(type, @encode(unsigned long)) == 0 ||
                strcmp(type, @encode(signed long long)) == 0 ||
                strcmp(type, @encode(unsigned long long)) == 0) {
       NSString* hex = [NSString stringWithFormat:@"%llx", number.unsignedLongLongValue];
-      [self writeByte:FlutterStandardFieldIntHex];
+      _writer->WriteByte(FlutterStandardFieldIntHex);
       [self writeUTF8:hex];
     } else {
       NSLog(@"Unsupported value: %@ of type %s", value, type);
@@ -289,32 +287,30 @@ using namespace shell;
     }
   } else if ([value isKindOfClass:[NSString class]]) {
     NSString* string = value;
-    [self writeByte:FlutterStandardFieldString];
+    _writer->WriteByte(FlutterStandardFieldString);
     [self writeUTF8:string];
   } else if ([value isKindOfClass:[FlutterStandardBigInteger class]]) {
     FlutterStandardBigInteger* bigInt = value;
-    [self writeByte:FlutterStandardFieldIntHex];
+    _writer->WriteByte(FlutterStandardFieldIntHex);
     [self writeUTF8:bigInt.hex];
   } else if ([value isKindOfClass:[FlutterStandardTypedData class]]) {
     FlutterStandardTypedData* typedData = value;
-    [self writeByte:FlutterStandardFieldForDataType(typedData.type)];
-    [self writeSize:typedData.elementCount];
-    [self writeAlignment:typedData.elementSize];
-    [_data appendData:typedData.data];
+    _writer->WriteByte(FlutterStandardFieldForDataType(typedData.type));
+    _writer->WriteTypedArray(typedData.data.bytes, typedData.elementCount, typedData.elementSize);
   } else if ([value isKindOfClass:[NSArray class]]) {
     NSArray* array = value;
-    [self writeByte:FlutterStandardFieldList];
-    [self writeSize:array.count];
+    _writer->WriteByte(FlutterStandardFieldList);
+    _writer->WriteSize(array.count);
     for (id object in array) {
-      [self writeValue:object];
+      [self encodeValue:object];
     }
   } else if ([value isKindOfClass:[NSDictionary class]]) {
     NSDictionary* dict = value;
-    [self writeByte:FlutterStandardFieldMap];
-    [self writeSize:dict.count];
+    _writer->WriteByte(FlutterStandardFieldMap);
+    _writer->WriteSize(dict.count);
     for (id key in dict) {
-      [self writeValue:key];
-      [self writeValue:[dict objectForKey:key]];
+      [self encodeValue:key];
+      [self encodeValue:[dict objectForKey:key]];
     }
   } else {
     NSLog(@"Unsupported value: %@ of type %@", value, [value class]);
@@ -330,7 +326,7 @@ using namespace shell;
 
 @implementation FlutterStandardReader {
   NSData* _data;
-  NSRange _range;
+  std::unique_ptr<StandardCodecReader> _reader;
 }
 
 + (instancetype)readerWithData:(NSData*)data {
@@ -343,7 +339,8 @@ using namespace shell;
   self = [super init];
   NSAssert(self, @"Super init cannot be nil");
   _data = [data retain];
-  _range = NSMakeRange(0, 0);
+  _reader = std::make_unique<StandardCodecReader>(static_cast<const uint8_t*>(data.bytes),
+                                                  data.length);
   return self;
 }
 
@@ -353,65 +350,32 @@ using namespace shell;
 }
 
 - (BOOL)hasMore {
-  return _range.location < _data.length;
-}
-
-- (void)readBytes:(void*)destination length:(int)length {
-  _range.length = length;
-  [_data getBytes:destination range:_range];
-  _range.location += _range.length;
+  return _reader->HasMore();
 }
 
 - (UInt8)readByte {
-  UInt8 value;
-  [self readBytes:&value length:1];
-  return value;
-}
-
-- (UInt32)readSize {
-  UInt8 byte = [self readByte];
-  if (byte < 254) {
-    return (UInt32)byte;
-  } else if (byte == 254) {
-    UInt16 value;
-    [self readBytes:&value length:2];
-    return value;
-  } else {
-    UInt32 value;
-    [self readBytes:&value length:4];
-    return value;
-  }
-}
-
-- (NSData*)readData:(int)length {
-  _range.length = length;
-  NSData* data = [_data subdataWithRange:_range];
-  _range.location += _range.length;
-  return data;
+  return _reader->ReadByte();
 }
 
 - (NSString*)readUTF8 {
-  NSData* bytes = [self readData:[self readSize]];
-  return [[[NSString alloc] initWithData:bytes encoding:NSUTF8StringEncoding] autorelease];
-}
-
-- (void)readAlignment:(UInt8)alignment {
-  UInt8 mod = _range.location % alignment;
-  if (mod) {
-    _range.location += (alignment - mod);
-  }
+  const UInt32 length = _reader->ReadSize();
+  const uint8_t* bytes = _reader->ReadSpan(length);
+  NSAssert(bytes, @"Corrupted standard message");
+  return [[[NSString alloc] initWithBytes:bytes length:length encoding:NSUTF8StringEncoding]
+      autorelease];
 }
 
 - (FlutterStandardTypedData*)readTypedDataOfType:(FlutterStandardDataType)type {
-  UInt32 elementCount = [self readSize];
   UInt8 elementSize = elementSizeForFlutterStandardDataType(type);
-  [self readAlignment:elementSize];
-  NSData* data = [self readData:elementCount * elementSize];
+  size_t elementCount = 0;
+  const uint8_t* elements = _reader->ReadTypedArray(elementSize, &elementCount);
+  NSAssert(elements, @"Corrupted standard message");
+  NSData* data = [NSData dataWithBytes:elements length:elementCount * elementSize];
   return [FlutterStandardTypedData typedDataWithData:data type:type];
 }
 
 - (id)readValue {
-  FlutterStandardField field = (FlutterStandardField)[self readByte];
+  FlutterStandardField field = (FlutterStandardField)_reader->ReadByte();
   switch (field) {
     case FlutterStandardFieldNil:
       return nil;
@@ -419,21 +383,13 @@ using namespace shell;
       return @YES;
     case FlutterStandardFieldFalse:
       return @NO;
-    case FlutterStandardFieldInt32: {
-      SInt32 value;
-      [self readBytes:&value length:4];
-      return [NSNumber numberWithInt:value];
-    }
-    case FlutterStandardFieldInt64: {
-      SInt64 value;
-      [self readBytes:&value length:8];
-      return [NSNumber numberWithLong:value];
-    }
+    case FlutterStandardFieldInt32:
+      return [NSNumber numberWithInt:_reader->Read<SInt32>()];
+    case FlutterStandardFieldInt64:
+      return [NSNumber numberWithLong:_reader->Read<SInt64>()];
     case FlutterStandardFieldFloat64: {
-      Float64 value;
-      [self readAlignment:8];
-      [self readBytes:&value length:8];
-      return [NSNumber numberWithDouble:value];
+      _reader->ReadAlignment(8);
+      return [NSNumber numberWithDouble:_reader->Read<Float64>()];
     }
     case FlutterStandardFieldIntHex:
       return [FlutterStandardBigInteger bigIntegerWithHex:[self readUTF8]];
@@ -445,7 +401,7 @@ using namespace shell;
     case FlutterStandardFieldFloat64Data:
       return [self readTypedDataOfType:FlutterStandardDataTypeForField(field)];
     case FlutterStandardFieldList: {
-      UInt32 length = [self readSize];
+      UInt32 length = _reader->ReadSize();
       NSMutableArray* array = [NSMutableArray arrayWithCapacity:length];
       for (UInt32 i = 0; i < length; i++) {
         id value = [self readValue];
@@ -454,7 +410,7 @@ using namespace shell;
       return array;
     }
     case FlutterStandardFieldMap: {
-      UInt32 size = [self readSize];
+      UInt32 size = _reader->ReadSize();
       NSMutableDictionary* dict = [NSMutableDictionary dictionaryWithCapacity:size];
       for (UInt32 i = 0; i < size; i++) {
         id key = [self readValue];
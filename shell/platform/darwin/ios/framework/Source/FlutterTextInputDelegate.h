@@ -15,6 +15,7 @@ typedef NS_ENUM(NSInteger, FlutterTextInputAction) {
 @protocol FlutterTextInputDelegate<NSObject>
 
 - (void)updateEditingClient:(int)client withState:(NSDictionary*)state;
+- (void)updateEditingClient:(int)client withDelta:(NSDictionary*)delta;
 - (void)performAction:(FlutterTextInputAction)action withClient:(int)client;
 
 @end
@@ -129,6 +129,8 @@ static UITextAutocapitalizationType ToUITextAutocapitalizationType(NSString* inp
 @property(nonatomic, getter=isSecureTextEntry) BOOL secureTextEntry;
 
 @property(nonatomic, assign) id<FlutterTextInputDelegate> textInputDelegate;
+// Whether edits are sent to the framework as deltas rather than the whole text.
+@property(nonatomic) BOOL sendsDeltas;
 
 @end
 
@@ -136,6 +138,8 @@ static UITextAutocapitalizationType ToUITextAutocapitalizationType(NSString* inp
   int _textInputClient;
   const char* _selectionAffinity;
   FlutterTextRange* _selectedTextRange;
+  // The text as the framework last saw it, which deltas are relative to.
+  NSString* _lastText;
 }
 
 @synthesize tokenizer = _tokenizer;
@@ -149,6 +153,7 @@ static UITextAutocapitalizationType ToUITextAutocapitalizationType(NSString* inp
 
     // UITextInput
     _text = [[NSMutableString alloc] init];
+    _lastText = [@"" retain];
     _markedText = [[NSMutableString alloc] init];
     _selectedTextRange = [[FlutterTextRange alloc] initWithNSRange:NSMakeRange(0, 0)];
 
@@ -168,6 +173,7 @@ static UITextAutocapitalizationType ToUITextAutocapitalizationType(NSString* inp
 
 - (void)dealloc {
   [_text release];
+  [_lastText release];
   [_markedText release];
   [_markedTextRange release];
   [_selectedTextRange release];
@@ -185,6 +191,7 @@ static UITextAutocapitalizationType ToUITextAutocapitalizationType(NSString* inp
   if (textChanged) {
     [self.inputDelegate textWillChange:self];
     [self.text setString:newText];
+    [self setLastText:newText];
   }
 
   NSInteger selectionBase = [state[@"selectionBase"] intValue];
@@ -478,6 +485,37 @@ static UITextAutocapitalizationType ToUITextAutocapitalizationType(NSString* inp
 
 #pragma mark - UIKeyInput Overrides
 
+- (void)setLastText:(NSString*)text {
+  NSString* oldText = _lastText;
+  _lastText = [text copy];
+  [oldText release];
+}
+
+// Adds the range of the last text that was replaced and the text that
+// replaced it to |state|. Only the characters between the common prefix and
+// suffix of the old and new text are sent, so a keystroke in a long document
+// sends one character.
+- (void)addDeltaToState:(NSMutableDictionary*)state {
+  NSUInteger oldLength = _lastText.length;
+  NSUInteger newLength = self.text.length;
+  NSUInteger start = 0;
+  NSUInteger limit = MIN(oldLength, newLength);
+  while (start < limit &&
+         [_lastText characterAtIndex:start] == [self.text characterAtIndex:start])
+    ++start;
+  NSUInteger oldEnd = oldLength;
+  NSUInteger newEnd = newLength;
+  while (oldEnd > start && newEnd > start &&
+         [_lastText characterAtIndex:oldEnd - 1] == [self.text characterAtIndex:newEnd - 1]) {
+    --oldEnd;
+    --newEnd;
+  }
+  state[@"deltaStart"] = @(start);
+  state[@"deltaEnd"] = @(oldEnd);
+  state[@"deltaText"] = [self.text substringWithRange:NSMakeRange(start, newEnd - start)];
+  [self setLastText:self.text];
+}
+
 - (void)updateEditingState {
   NSUInteger selectionBase = ((FlutterTextPosition*)_selectedTextRange.start).index;
   NSUInteger selectionExtent = ((FlutterTextPosition*)_selectedTextRange.end).index;
@@ -488,16 +526,21 @@ static UITextAutocapitalizationType ToUITextAutocapitalizationType(NSString* inp
     composingBase = ((FlutterTextPosition*)self.markedTextRange.start).index;
     composingExtent = ((FlutterTextPosition*)self.markedTextRange.end).index;
   }
-  [_textInputDelegate updateEditingClient:_textInputClient
-                                withState:@{
-                                  @"selectionBase" : @(selectionBase),
-                                  @"selectionExtent" : @(selectionExtent),
-                                  @"selectionAffinity" : @(_selectionAffinity),
-                                  @"selectionIsDirectional" : @(false),
-                                  @"composingBase" : @(composingBase),
-                                  @"composingExtent" : @(composingExtent),
-                                  @"text" : [NSString stringWithString:self.text],
-                                }];
+  NSMutableDictionary* state = [NSMutableDictionary dictionaryWithDictionary:@{
+    @"selectionBase" : @(selectionBase),
+    @"selectionExtent" : @(selectionExtent),
+    @"selectionAffinity" : @(_selectionAffinity),
+    @"selectionIsDirectional" : @(false),
+    @"composingBase" : @(composingBase),
+    @"composingExtent" : @(composingExtent),
+  }];
+  if (self.sendsDeltas) {
+    [self addDeltaToState:state];
+    [_textInputDelegate updateEditingClient:_textInputClient withDelta:state];
+    return;
+  }
+  state[@"text"] = [NSString stringWithString:self.text];
+  [_textInputDelegate updateEditingClient:_textInputClient withState:state];
 }
 
 - (BOOL)hasText {
@@ -586,6 +629,7 @@ static UITextAutocapitalizationType ToUITextAutocapitalizationType(NSString* inp
   _view.autocorrectionType = autocorrect && ![autocorrect boolValue]
                                  ? UITextAutocorrectionTypeNo
                                  : UITextAutocorrectionTypeDefault;
+  _view.sendsDeltas = [configuration[@"enableDeltaModel"] boolValue];
   [_view setTextInputClient:client];
   [_view reloadInputViews];
 }
@@ -12,15 +12,30 @@
 #include "lib/fxl/synchronization/waitable_event.h"
 #include "third_party/skia/include/utils/mac/SkCGUtils.h"
 
+#if SHELL_ENABLE_METAL
+#include <QuartzCore/CAMetalLayer.h>
+
+#include "flutter/shell/platform/darwin/ios/ios_surface_metal.h"
+#endif  // SHELL_ENABLE_METAL
+
 @interface FlutterView ()<UIInputViewAudioFeedback>
 
 @end
 
 @implementation FlutterView
 
+static BOOL IsGPULayer(CALayer* layer) {
+#if SHELL_ENABLE_METAL
+  if ([layer isKindOfClass:[CAMetalLayer class]]) {
+    return YES;
+  }
+#endif  // SHELL_ENABLE_METAL
+  return [layer isKindOfClass:[CAEAGLLayer class]];
+}
+
 - (void)layoutSubviews {
-  if ([self.layer isKindOfClass:[CAEAGLLayer class]]) {
-    CAEAGLLayer* layer = reinterpret_cast<CAEAGLLayer*>(self.layer);
+  if (IsGPULayer(self.layer)) {
+    CALayer* layer = self.layer;
     layer.allowsGroupOpacity = YES;
     layer.opaque = YES;
     CGFloat screenScale = [UIScreen mainScreen].scale;
@@ -35,6 +50,11 @@
 #if TARGET_IPHONE_SIMULATOR
   return [CALayer class];
 #else   // TARGET_IPHONE_SIMULATOR
+#if SHELL_ENABLE_METAL
+  if (blink::Settings::Get().enable_metal && shell::IOSSurfaceMetal::IsSupported()) {
+    return [CAMetalLayer class];
+  }
+#endif  // SHELL_ENABLE_METAL
   return [CAEAGLLayer class];
 #endif  // TARGET_IPHONE_SIMULATOR
 }
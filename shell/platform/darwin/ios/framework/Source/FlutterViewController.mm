@@ -6,6 +6,7 @@
 
 #include <memory>
 
+#include "flutter/common/settings.h"
 #include "flutter/common/threads.h"
 #include "flutter/fml/platform/darwin/platform_version.h"
 #include "flutter/fml/platform/darwin/scoped_block.h"
@@ -19,6 +20,7 @@
 #include "flutter/shell/platform/darwin/ios/framework/Source/FlutterTextInputPlugin.h"
 #include "flutter/shell/platform/darwin/ios/framework/Source/flutter_main_ios.h"
 #include "flutter/shell/platform/darwin/ios/framework/Source/flutter_touch_mapper.h"
+#include "flutter/shell/platform/darwin/ios/ios_hardware_image_allocator.h"
 #include "flutter/shell/platform/darwin/ios/platform_view_ios.h"
 #include "lib/fxl/functional/make_copyable.h"
 #include "lib/fxl/time/time_delta.h"
@@ -35,7 +37,7 @@ class PlatformMessageResponseDarwin : public blink::PlatformMessageResponse {
     fxl::RefPtr<PlatformMessageResponseDarwin> self(this);
     blink::Threads::Platform()->PostTask(
         fxl::MakeCopyable([ self, data = std::move(data) ]() mutable {
-          self->callback_.get()(shell::GetNSDataFromVector(data));
+          self->callback_.get()(shell::ConvertVectorToNSData(std::move(data)));
         }));
   }
 
@@ -74,6 +76,7 @@ class PlatformMessageResponseDarwin : public blink::PlatformMessageResponse {
   fml::scoped_nsprotocol<FlutterBasicMessageChannel*> _systemChannel;
   fml::scoped_nsprotocol<FlutterBasicMessageChannel*> _settingsChannel;
   fml::scoped_nsprotocol<UIView*> _launchView;
+  int64_t _nextTextureId;
   bool _platformSupportsTouchTypes;
   bool _platformSupportsTouchPressure;
   bool _platformSupportsTouchOrientationAndTilt;
@@ -147,6 +150,13 @@ class PlatformMessageResponseDarwin : public blink::PlatformMessageResponse {
         }
       });
   _platformView->SetupResourceContextOnIOThread();
+  if (blink::Settings::Get().enable_hardware_image_buffers &&
+      !blink::Settings::Get().enable_software_rendering) {
+    static dispatch_once_t install_allocator;
+    dispatch_once(&install_allocator, ^{
+      blink::HardwareImageAllocator::Set(std::make_unique<shell::IOSHardwareImageAllocator>());
+    });
+  }
 
   _localizationChannel.reset([[FlutterMethodChannel alloc]
          initWithName:@"flutter/localization"
@@ -632,6 +642,11 @@ static inline blink::PointerData::DeviceKind DeviceKindFromTouchType(UITouch* to
                               arguments:@[ @(client), state ]];
 }
 
+- (void)updateEditingClient:(int)client withDelta:(NSDictionary*)delta {
+  [_textInputChannel.get() invokeMethod:@"TextInputClient.updateEditingStateWithDeltas"
+                              arguments:@[ @(client), delta ]];
+}
+
 - (void)performAction:(FlutterTextInputAction)action withClient:(int)client {
   NSString* actionString;
   switch (action) {
@@ -694,6 +709,7 @@ static inline blink::PointerData::DeviceKind DeviceKindFromTouchType(UITouch* to
 
 - (void)onMemoryWarning:(NSNotification*)notification {
   [_systemChannel.get() sendMessage:@{@"type" : @"memoryPressure"}];
+  _platformView->NotifyMemoryPressure(shell::MemoryPressureLevel::kCritical);
 }
 
 #pragma mark - Locale updates
@@ -828,10 +844,17 @@ constexpr CGFloat kStandardStatusBarHeight = 20.0;
                         : fxl::MakeRefCounted<PlatformMessageResponseDarwin>(^(NSData* reply) {
                             callback(reply);
                           });
-  fxl::RefPtr<blink::PlatformMessage> platformMessage =
-      (message == nil) ? fxl::MakeRefCounted<blink::PlatformMessage>(channel.UTF8String, response)
-                       : fxl::MakeRefCounted<blink::PlatformMessage>(
-                             channel.UTF8String, shell::GetVectorFromNSData(message), response);
+  fxl::RefPtr<blink::PlatformMessage> platformMessage;
+  if (message == nil) {
+    platformMessage = fxl::MakeRefCounted<blink::PlatformMessage>(channel.UTF8String, response);
+  } else {
+    // Hand the message on without copying it. The copy keeps mutable data from
+    // changing underneath and only retains immutable data.
+    NSData* data = [message copy];
+    platformMessage = fxl::MakeRefCounted<blink::PlatformMessage>(
+        channel.UTF8String, static_cast<uint8_t*>(const_cast<void*>(data.bytes)), data.length,
+        [data]() { [data release]; }, response);
+  }
   _platformView->DispatchPlatformMessage(platformMessage);
 }
 
@@ -840,4 +863,20 @@ constexpr CGFloat kStandardStatusBarHeight = 20.0;
   NSAssert(channel, @"The channel must not be null");
   _platformView->platform_message_router().SetMessageHandler(channel.UTF8String, handler);
 }
+
+#pragma mark - FlutterTextureRegistry
+
+- (int64_t)registerTexture:(NSObject<FlutterTexture>*)texture {
+  int64_t textureId = _nextTextureId++;
+  _platformView->RegisterExternalTexture(textureId, texture);
+  return textureId;
+}
+
+- (void)unregisterTexture:(int64_t)textureId {
+  _platformView->UnregisterTexture(textureId);
+}
+
+- (void)textureFrameAvailable:(int64_t)textureId {
+  _platformView->MarkTextureFrameAvailable(textureId);
+}
 @end
@@ -95,6 +95,7 @@ bool GeometryComparator(SemanticsObject* a, SemanticsObject* b) {
 @implementation SemanticsObject {
   shell::AccessibilityBridge* _bridge;
   blink::SemanticsNode _node;
+  BOOL _hasNode;
   std::vector<SemanticsObject*> _children;
   SemanticsObjectContainer* _container;
 }
@@ -127,6 +128,17 @@ bool GeometryComparator(SemanticsObject* a, SemanticsObject* b) {
 
 - (void)setSemanticsNode:(const blink::SemanticsNode*)node {
   _node = *node;
+  _hasNode = YES;
+}
+
+/**
+ * Returns the blink::SemanticsNode::Field bits of the fields in which |node| differs from the node
+ * last set, or all of them if none was set yet.
+ */
+- (int32_t)changedFieldsOfSemanticsNode:(const blink::SemanticsNode*)node {
+  if (!_hasNode)
+    return blink::SemanticsNode::kAllFields;
+  return _node.GetChangedFields(*node);
 }
 
 - (std::vector<SemanticsObject*>*)children {
@@ -352,24 +364,41 @@ void AccessibilityBridge::UpdateSemantics(std::vector<blink::SemanticsNode> node
   // traversal order (top left to bottom right, with hit testing order as tie breaker).
   NSMutableSet<SemanticsObject*>* childOrdersToUpdate = [[[NSMutableSet alloc] init] autorelease];
 
+  // The framework sends nodes whose fields did not change, for example those that only scrolled
+  // along with their parent. They are skipped.
+  bool changed = false;
+  bool childrenChanged = false;
   for (const blink::SemanticsNode& node : nodes) {
     SemanticsObject* object = GetOrCreateObject(node.id);
+    const int32_t changedFields = [object changedFieldsOfSemanticsNode:&node];
+    if (changedFields == 0)
+      continue;
+    changed = true;
     [object setSemanticsNode:&node];
-    const size_t childrenCount = node.children.size();
-    auto& children = *[object children];
-    children.resize(childrenCount);
-    for (size_t i = 0; i < childrenCount; ++i) {
-      SemanticsObject* child = GetOrCreateObject(node.children[i]);
-      child.parent = object;
-      // Reverting to get hit testing order (as tie breaker for sorting below).
-      children[childrenCount - i - 1] = child;
+
+    if (changedFields & blink::SemanticsNode::kChildrenField) {
+      childrenChanged = true;
+      const size_t childrenCount = node.children.size();
+      auto& children = *[object children];
+      children.resize(childrenCount);
+      for (size_t i = 0; i < childrenCount; ++i) {
+        SemanticsObject* child = GetOrCreateObject(node.children[i]);
+        child.parent = object;
+        // Reverting to get hit testing order (as tie breaker for sorting below).
+        children[childrenCount - i - 1] = child;
+      }
+      [childOrdersToUpdate addObject:object];
     }
 
-    [childOrdersToUpdate addObject:object];
-    if (object.parent)
+    const int32_t geometryFields =
+        blink::SemanticsNode::kRectField | blink::SemanticsNode::kTransformField;
+    if ((changedFields & geometryFields) && object.parent)
       [childOrdersToUpdate addObject:object.parent];
   }
 
+  if (!changed)
+    return;
+
   // Bring children into traversal order.
   for (SemanticsObject* object in childOrdersToUpdate) {
     std::vector<SemanticsObject*>* children = [object children];
@@ -386,10 +415,14 @@ void AccessibilityBridge::UpdateSemantics(std::vector<blink::SemanticsNode> node
     view_.accessibilityElements = nil;
   }
 
-  NSMutableArray<NSNumber*>* doomed_uids = [NSMutableArray arrayWithArray:[objects_.get() allKeys]];
-  if (root)
-    VisitObjectsRecursivelyAndRemove(root, doomed_uids);
-  [objects_ removeObjectsForKeys:doomed_uids];
+  // Nodes are only removed from the tree by changing the children of their parents.
+  if (childrenChanged) {
+    NSMutableArray<NSNumber*>* doomed_uids =
+        [NSMutableArray arrayWithArray:[objects_.get() allKeys]];
+    if (root)
+      VisitObjectsRecursivelyAndRemove(root, doomed_uids);
+    [objects_ removeObjectsForKeys:doomed_uids];
+  }
 
   // TODO(goderbauer): figure out which node to focus next.
   UIAccessibilityPostNotification(UIAccessibilityLayoutChangedNotification, nil);
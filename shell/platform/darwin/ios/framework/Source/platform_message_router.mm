@@ -4,10 +4,6 @@
 
 #include "flutter/shell/platform/darwin/ios/framework/Source/platform_message_router.h"
 
-#include <vector>
-
-#include "flutter/shell/platform/darwin/common/buffer_conversions.h"
-
 namespace shell {
 
 PlatformMessageRouter::PlatformMessageRouter() = default;
@@ -21,12 +17,26 @@ void PlatformMessageRouter::HandlePlatformMessage(fxl::RefPtr<blink::PlatformMes
     FlutterBinaryMessageHandler handler = it->second;
     NSData* data = nil;
     if (message->hasData()) {
-      data = GetNSDataFromVector(message->data());
+      // Hand the payload to the handler without copying it.
+      uint8_t* bytes = nullptr;
+      size_t size = 0;
+      fxl::Closure release = message->TakeData(&bytes, &size);
+      data = [[[NSData alloc] initWithBytesNoCopy:bytes
+                                           length:size
+                                      deallocator:^(void*, NSUInteger) {
+                                        release();
+                                      }] autorelease];
     }
     handler(data, ^(NSData* reply) {
       if (completer) {
         if (reply) {
-          completer->Complete(GetVectorFromNSData(reply));
+          // Hand the reply on without copying it. The copy keeps mutable data
+          // from changing underneath and only retains immutable data.
+          NSData* data = [reply copy];
+          completer->CompleteWithExternalData(
+              static_cast<uint8_t*>(const_cast<void*>(data.bytes)), data.length, [data]() {
+                [data release];
+              });
         } else {
           completer->CompleteEmpty();
         }
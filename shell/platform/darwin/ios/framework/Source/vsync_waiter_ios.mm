@@ -8,9 +8,11 @@
 
 #include <Foundation/Foundation.h>
 #include <QuartzCore/CADisplayLink.h>
+#include <UIKit/UIKit.h>
 #include <mach/mach_time.h>
 
 #include "flutter/common/threads.h"
+#include "flutter/fml/task_priority.h"
 #include "flutter/glue/trace_event.h"
 #include "lib/fxl/logging.h"
 
@@ -30,6 +32,11 @@
     _displayLink =
         [[CADisplayLink displayLinkWithTarget:self selector:@selector(onDisplayLink:)] retain];
     _displayLink.paused = YES;
+    if ([_displayLink respondsToSelector:@selector(setPreferredFramesPerSecond:)] &&
+        [UIScreen instancesRespondToSelector:@selector(maximumFramesPerSecond)]) {
+      // Run at the native rate of panels that refresh faster than 60Hz.
+      _displayLink.preferredFramesPerSecond = [UIScreen mainScreen].maximumFramesPerSecond;
+    }
 
     blink::Threads::UI()->PostTask([client = [self retain]]() {
       [client->_displayLink addToRunLoop:[NSRunLoop currentRunLoop] forMode:NSRunLoopCommonModes];
@@ -48,7 +55,13 @@
 
 - (void)onDisplayLink:(CADisplayLink*)link {
   fxl::TimePoint frame_start_time = fxl::TimePoint::Now();
-  fxl::TimePoint frame_target_time = frame_start_time + fxl::TimeDelta::FromSecondsF(link.duration);
+  // |duration| is the refresh interval of the display, which may be shorter
+  // than the interval between callbacks at the preferred frame rate.
+  CFTimeInterval interval = link.duration;
+  if ([link respondsToSelector:@selector(targetTimestamp)]) {
+    interval = link.targetTimestamp - link.timestamp;
+  }
+  fxl::TimePoint frame_target_time = frame_start_time + fxl::TimeDelta::FromSecondsF(interval);
 
   _displayLink.paused = YES;
 
@@ -76,6 +89,7 @@
   //
   // We are not using the PostTask for thread switching, but to make task
   // observers work.
+  fml::ScopedTaskPriority priority(fml::TaskPriority::kFrameCritical);
   blink::Threads::UI()->PostTask([
     callback = _pendingCallback, frame_start_time, frame_target_time
   ]() { callback(frame_start_time, frame_target_time); });
@@ -0,0 +1,50 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_DARWIN_IOS_IOS_EXTERNAL_TEXTURE_GL_H_
+#define FLUTTER_SHELL_PLATFORM_DARWIN_IOS_IOS_EXTERNAL_TEXTURE_GL_H_
+
+#include "flutter/flow/texture.h"
+#include "flutter/fml/platform/darwin/cf_utils.h"
+#include "flutter/fml/platform/darwin/scoped_nsobject.h"
+#include "flutter/shell/platform/darwin/ios/framework/Headers/FlutterTexture.h"
+#include "lib/fxl/macros.h"
+#include "third_party/skia/include/core/SkSize.h"
+
+namespace shell {
+
+// Composites the pixel buffers a |FlutterTexture| hands out. The buffers are
+// IOSurface backed and sampled through a CVOpenGLESTextureCache on the GPU
+// thread's context, so frames are not copied.
+class IOSExternalTextureGL : public flow::Texture {
+ public:
+  IOSExternalTextureGL(int64_t textureId, NSObject<FlutterTexture>* externalTexture);
+
+  ~IOSExternalTextureGL() override;
+
+  // |flow::Texture|
+  void Paint(SkCanvas& canvas, const SkRect& bounds) override;
+
+  // |flow::Texture|
+  void OnGrContextCreated() override;
+
+  // |flow::Texture|
+  void OnGrContextDestroyed() override;
+
+  // |flow::Texture|
+  void MarkNewFrameAvailable() override;
+
+ private:
+  fml::scoped_nsprotocol<NSObject<FlutterTexture>*> external_texture_;
+  fml::CFRef<CVOpenGLESTextureCacheRef> cache_ref_;
+  fml::CFRef<CVOpenGLESTextureRef> texture_ref_;
+  SkISize texture_size_;
+  bool new_frame_ready_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(IOSExternalTextureGL);
+};
+
+}  // namespace shell
+
+#endif  // FLUTTER_SHELL_PLATFORM_DARWIN_IOS_IOS_EXTERNAL_TEXTURE_GL_H_
@@ -0,0 +1,98 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/darwin/ios/ios_external_texture_gl.h"
+
+#import <OpenGLES/EAGL.h>
+#import <OpenGLES/ES2/gl.h>
+#import <OpenGLES/ES2/glext.h>
+
+#include "lib/fxl/logging.h"
+#include "third_party/skia/include/gpu/GrBackendSurface.h"
+#include "third_party/skia/include/gpu/GrContext.h"
+#include "third_party/skia/include/gpu/gl/GrGLTypes.h"
+
+namespace shell {
+
+IOSExternalTextureGL::IOSExternalTextureGL(int64_t textureId,
+                                           NSObject<FlutterTexture>* externalTexture)
+    : Texture(textureId),
+      external_texture_([externalTexture retain]),
+      texture_size_(SkISize::MakeEmpty()),
+      new_frame_ready_(true) {
+  FXL_DCHECK(external_texture_);
+}
+
+IOSExternalTextureGL::~IOSExternalTextureGL() = default;
+
+void IOSExternalTextureGL::Paint(SkCanvas& canvas, const SkRect& bounds) {
+  GrContext* context = canvas.getGrContext();
+  if (context == nullptr) {
+    return;
+  }
+
+  if (!cache_ref_) {
+    CVOpenGLESTextureCacheRef cache = nullptr;
+    CVReturn err = CVOpenGLESTextureCacheCreate(kCFAllocatorDefault, nullptr,
+                                                [EAGLContext currentContext], nullptr, &cache);
+    if (err != kCVReturnSuccess) {
+      FXL_DLOG(WARNING) << "Failed to create GLES texture cache: " << err;
+      return;
+    }
+    cache_ref_.Reset(cache);
+  }
+
+  if (new_frame_ready_) {
+    new_frame_ready_ = false;
+    fml::CFRef<CVPixelBufferRef> buffer_ref([external_texture_ copyPixelBuffer]);
+    if (buffer_ref) {
+      CVOpenGLESTextureRef texture = nullptr;
+      CVReturn err = CVOpenGLESTextureCacheCreateTextureFromImage(
+          kCFAllocatorDefault, cache_ref_, buffer_ref, nullptr, GL_TEXTURE_2D, GL_RGBA,
+          static_cast<int>(CVPixelBufferGetWidth(buffer_ref)),
+          static_cast<int>(CVPixelBufferGetHeight(buffer_ref)), GL_BGRA_EXT, GL_UNSIGNED_BYTE, 0,
+          &texture);
+      if (err != kCVReturnSuccess) {
+        FXL_DLOG(WARNING) << "Could not create texture from pixel buffer: " << err;
+      } else {
+        texture_ref_.Reset(texture);
+        texture_size_ = SkISize::Make(static_cast<int>(CVPixelBufferGetWidth(buffer_ref)),
+                                      static_cast<int>(CVPixelBufferGetHeight(buffer_ref)));
+      }
+      // Lets the cache recycle the textures of earlier frames.
+      CVOpenGLESTextureCacheFlush(cache_ref_, 0);
+    }
+  }
+
+  if (!texture_ref_) {
+    return;
+  }
+
+  GrGLTextureInfo texture_info;
+  texture_info.fTarget = CVOpenGLESTextureGetTarget(texture_ref_);
+  texture_info.fID = CVOpenGLESTextureGetName(texture_ref_);
+  GrBackendTexture backend_texture(texture_size_.width(), texture_size_.height(),
+                                   kBGRA_8888_GrPixelConfig, texture_info);
+  sk_sp<SkImage> image = SkImage::MakeFromTexture(context, backend_texture,
+                                                  kTopLeft_GrSurfaceOrigin, kPremul_SkAlphaType,
+                                                  nullptr);
+  if (image) {
+    canvas.drawImageRect(image, bounds, nullptr);
+  }
+}
+
+void IOSExternalTextureGL::OnGrContextCreated() {
+  new_frame_ready_ = true;
+}
+
+void IOSExternalTextureGL::OnGrContextDestroyed() {
+  texture_ref_.Reset(nullptr);
+  cache_ref_.Reset(nullptr);
+}
+
+void IOSExternalTextureGL::MarkNewFrameAvailable() {
+  new_frame_ready_ = true;
+}
+
+}  // namespace shell
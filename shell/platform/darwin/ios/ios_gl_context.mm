@@ -236,7 +236,11 @@ bool IOSGLContext::UpdateStorageSizeIfNecessary() {
 }
 
 bool IOSGLContext::MakeCurrent() {
-  return UpdateStorageSizeIfNecessary() && [EAGLContext setCurrentContext:context_.get()];
+  if (!UpdateStorageSizeIfNecessary()) {
+    return false;
+  }
+  return [EAGLContext currentContext] == context_.get() ||
+         [EAGLContext setCurrentContext:context_.get()];
 }
 
 bool IOSGLContext::ResourceMakeCurrent() {
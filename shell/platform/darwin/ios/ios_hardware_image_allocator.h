@@ -0,0 +1,40 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_DARWIN_IOS_IOS_HARDWARE_IMAGE_ALLOCATOR_H_
+#define FLUTTER_SHELL_PLATFORM_DARWIN_IOS_IOS_HARDWARE_IMAGE_ALLOCATOR_H_
+
+#include <CoreVideo/CoreVideo.h>
+
+#include "flutter/lib/ui/painting/hardware_image_allocator.h"
+#include "lib/fxl/macros.h"
+
+namespace shell {
+
+// Decodes images into IOSurface backed pixel buffers and samples them through
+// a CVOpenGLESTextureCache on the resource context's share group.
+class IOSHardwareImageAllocator : public blink::HardwareImageAllocator {
+ public:
+  IOSHardwareImageAllocator();
+
+  ~IOSHardwareImageAllocator() override;
+
+  // |blink::HardwareImageAllocator|
+  SkColorType color_type() override;
+
+  // |blink::HardwareImageAllocator|
+  std::unique_ptr<Buffer> Allocate(int width, int height) override;
+
+  // Called on the IO thread with the resource context current.
+  CVOpenGLESTextureCacheRef GetTextureCache();
+
+ private:
+  CVOpenGLESTextureCacheRef texture_cache_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(IOSHardwareImageAllocator);
+};
+
+}  // namespace shell
+
+#endif  // FLUTTER_SHELL_PLATFORM_DARWIN_IOS_IOS_HARDWARE_IMAGE_ALLOCATOR_H_
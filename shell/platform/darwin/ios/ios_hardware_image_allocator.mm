@@ -0,0 +1,143 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/darwin/ios/ios_hardware_image_allocator.h"
+
+#import <OpenGLES/EAGL.h>
+#import <OpenGLES/ES2/gl.h>
+#import <OpenGLES/ES2/glext.h>
+
+#include "lib/fxl/logging.h"
+#include "third_party/skia/include/gpu/GrBackendSurface.h"
+#include "third_party/skia/include/gpu/gl/GrGLTypes.h"
+
+namespace shell {
+namespace {
+
+// Owns what the GPU samples from for as long as Skia uses the texture.
+struct TextureRelease {
+  CVPixelBufferRef pixel_buffer;
+  CVOpenGLESTextureRef texture;
+};
+
+void ReleaseTexture(void* context) {
+  auto* release = static_cast<TextureRelease*>(context);
+  CFRelease(release->texture);
+  CVPixelBufferRelease(release->pixel_buffer);
+  delete release;
+}
+
+class IOSurfaceBuffer : public blink::HardwareImageAllocator::Buffer {
+ public:
+  IOSurfaceBuffer(IOSHardwareImageAllocator* allocator,
+                  CVPixelBufferRef pixel_buffer)
+      : allocator_(allocator), pixel_buffer_(pixel_buffer), locked_(true) {}
+
+  ~IOSurfaceBuffer() override {
+    if (locked_)
+      CVPixelBufferUnlockBaseAddress(pixel_buffer_, 0);
+    CVPixelBufferRelease(pixel_buffer_);
+  }
+
+  void* pixels() override { return CVPixelBufferGetBaseAddress(pixel_buffer_); }
+
+  size_t row_bytes() override { return CVPixelBufferGetBytesPerRow(pixel_buffer_); }
+
+  sk_sp<SkImage> MakeImage(GrContext* context, SkAlphaType alpha_type) override {
+    CVPixelBufferUnlockBaseAddress(pixel_buffer_, 0);
+    locked_ = false;
+
+    CVOpenGLESTextureCacheRef texture_cache = allocator_->GetTextureCache();
+    if (texture_cache == nullptr) {
+      return nullptr;
+    }
+
+    const int width = static_cast<int>(CVPixelBufferGetWidth(pixel_buffer_));
+    const int height = static_cast<int>(CVPixelBufferGetHeight(pixel_buffer_));
+    CVOpenGLESTextureRef texture = nullptr;
+    CVReturn result = CVOpenGLESTextureCacheCreateTextureFromImage(
+        kCFAllocatorDefault, texture_cache, pixel_buffer_, nullptr, GL_TEXTURE_2D, GL_RGBA, width,
+        height, GL_BGRA_EXT, GL_UNSIGNED_BYTE, 0, &texture);
+    if (result != kCVReturnSuccess || texture == nullptr) {
+      FXL_DLOG(ERROR) << "Could not create a texture from an IOSurface: " << result;
+      return nullptr;
+    }
+
+    GrGLTextureInfo texture_info;
+    texture_info.fTarget = CVOpenGLESTextureGetTarget(texture);
+    texture_info.fID = CVOpenGLESTextureGetName(texture);
+    GrBackendTexture backend_texture(width, height, kBGRA_8888_GrPixelConfig, texture_info);
+
+    // The image keeps the pixel buffer alive. The buffer's own reference goes
+    // away with this object.
+    auto* release = new TextureRelease{CVPixelBufferRetain(pixel_buffer_), texture};
+    sk_sp<SkImage> image =
+        SkImage::MakeFromTexture(context, backend_texture, kTopLeft_GrSurfaceOrigin, alpha_type,
+                                 nullptr, &ReleaseTexture, release);
+    // Make sure the texture is complete before another context samples it.
+    glFlush();
+    return image;
+  }
+
+ private:
+  IOSHardwareImageAllocator* allocator_;
+  CVPixelBufferRef pixel_buffer_;
+  bool locked_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(IOSurfaceBuffer);
+};
+
+}  // namespace
+
+IOSHardwareImageAllocator::IOSHardwareImageAllocator() : texture_cache_(nullptr) {}
+
+IOSHardwareImageAllocator::~IOSHardwareImageAllocator() {
+  if (texture_cache_ != nullptr)
+    CFRelease(texture_cache_);
+}
+
+SkColorType IOSHardwareImageAllocator::color_type() {
+  return kBGRA_8888_SkColorType;
+}
+
+std::unique_ptr<blink::HardwareImageAllocator::Buffer> IOSHardwareImageAllocator::Allocate(
+    int width,
+    int height) {
+  NSDictionary* attributes = @{
+    (NSString*)kCVPixelBufferIOSurfacePropertiesKey : @{},
+    (NSString*)kCVPixelBufferOpenGLESCompatibilityKey : @YES,
+  };
+  CVPixelBufferRef pixel_buffer = nullptr;
+  CVReturn result = CVPixelBufferCreate(kCFAllocatorDefault, width, height,
+                                        kCVPixelFormatType_32BGRA,
+                                        (CFDictionaryRef)attributes, &pixel_buffer);
+  if (result != kCVReturnSuccess || pixel_buffer == nullptr) {
+    return nullptr;
+  }
+
+  if (CVPixelBufferLockBaseAddress(pixel_buffer, 0) != kCVReturnSuccess) {
+    CVPixelBufferRelease(pixel_buffer);
+    return nullptr;
+  }
+
+  return std::make_unique<IOSurfaceBuffer>(this, pixel_buffer);
+}
+
+CVOpenGLESTextureCacheRef IOSHardwareImageAllocator::GetTextureCache() {
+  if (texture_cache_ == nullptr) {
+    EAGLContext* context = [EAGLContext currentContext];
+    if (context == nil) {
+      return nullptr;
+    }
+    CVReturn result =
+        CVOpenGLESTextureCacheCreate(kCFAllocatorDefault, nullptr, context, nullptr, &texture_cache_);
+    if (result != kCVReturnSuccess) {
+      FXL_DLOG(ERROR) << "Could not create a texture cache: " << result;
+      texture_cache_ = nullptr;
+    }
+  }
+  return texture_cache_;
+}
+
+}  // namespace shell
@@ -8,6 +8,11 @@
 #include <flutter/shell/platform/darwin/ios/ios_surface_software.h>
 #include <memory>
 
+#if SHELL_ENABLE_METAL
+#include <QuartzCore/CAMetalLayer.h>
+#include <flutter/shell/platform/darwin/ios/ios_surface_metal.h>
+#endif  // SHELL_ENABLE_METAL
+
 @class CALayer;
 @class CAEAGLLayer;
 
@@ -20,8 +25,11 @@ std::unique_ptr<IOSSurface> IOSSurface::Create(PlatformView::SurfaceConfig surfa
     return std::make_unique<IOSSurfaceGL>(surface_config, reinterpret_cast<CAEAGLLayer*>(layer));
   }
 
-  // If we ever support the metal rendering API, a check for CAMetalLayer would
-  // go here.
+#if SHELL_ENABLE_METAL
+  if ([layer isKindOfClass:[CAMetalLayer class]]) {
+    return std::make_unique<IOSSurfaceMetal>(surface_config, reinterpret_cast<CAMetalLayer*>(layer));
+  }
+#endif  // SHELL_ENABLE_METAL
 
   // Finally, fallback to software rendering.
   return std::make_unique<IOSSurfaceSoftware>(surface_config, layer);
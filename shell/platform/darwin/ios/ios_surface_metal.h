@@ -0,0 +1,39 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_DARWIN_IOS_IOS_SURFACE_METAL_H_
+#define FLUTTER_SHELL_PLATFORM_DARWIN_IOS_IOS_SURFACE_METAL_H_
+
+#include "flutter/shell/platform/darwin/ios/ios_surface.h"
+#include "lib/fxl/macros.h"
+
+@class CAMetalLayer;
+
+namespace shell {
+
+class IOSSurfaceMetal : public IOSSurface {
+ public:
+  // Whether the device has a GPU that supports Metal.
+  static bool IsSupported();
+
+  IOSSurfaceMetal(PlatformView::SurfaceConfig surface_config,
+                  CAMetalLayer* layer);
+
+  ~IOSSurfaceMetal() override;
+
+  bool IsValid() const override;
+
+  bool ResourceContextMakeCurrent() override;
+
+  void UpdateStorageSizeIfNecessary() override;
+
+  std::unique_ptr<Surface> CreateGPUSurface() override;
+
+ private:
+  FXL_DISALLOW_COPY_AND_ASSIGN(IOSSurfaceMetal);
+};
+
+}  // namespace shell
+
+#endif  // FLUTTER_SHELL_PLATFORM_DARWIN_IOS_IOS_SURFACE_METAL_H_
@@ -0,0 +1,58 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/darwin/ios/ios_surface_metal.h"
+
+#include <Metal/Metal.h>
+#include <QuartzCore/CAMetalLayer.h>
+
+#include "flutter/shell/gpu/gpu_surface_metal.h"
+
+namespace shell {
+
+bool IOSSurfaceMetal::IsSupported() {
+  fml::scoped_nsprotocol<id<MTLDevice>> device(MTLCreateSystemDefaultDevice());
+  return device != nil;
+}
+
+IOSSurfaceMetal::IOSSurfaceMetal(PlatformView::SurfaceConfig surface_config, CAMetalLayer* layer)
+    : IOSSurface(surface_config, reinterpret_cast<CALayer*>(layer)) {
+  fml::scoped_nsprotocol<id<MTLDevice>> device(MTLCreateSystemDefaultDevice());
+  layer.device = device.get();
+  layer.pixelFormat = MTLPixelFormatBGRA8Unorm;
+  // Skia may sample from or copy the drawable texture.
+  layer.framebufferOnly = NO;
+}
+
+IOSSurfaceMetal::~IOSSurfaceMetal() = default;
+
+bool IOSSurfaceMetal::IsValid() const {
+  return reinterpret_cast<CAMetalLayer*>(GetLayer()).device != nil;
+}
+
+bool IOSSurfaceMetal::ResourceContextMakeCurrent() {
+  // Images are uploaded by the GrContext of the GPU thread when first drawn.
+  return false;
+}
+
+void IOSSurfaceMetal::UpdateStorageSizeIfNecessary() {
+  // Nothing to do here. The drawable size of the layer is updated to match
+  // the size of each frame when it is acquired.
+}
+
+std::unique_ptr<Surface> IOSSurfaceMetal::CreateGPUSurface() {
+  if (!IsValid()) {
+    return nullptr;
+  }
+
+  auto surface = std::make_unique<GPUSurfaceMetal>(reinterpret_cast<CAMetalLayer*>(GetLayer()));
+
+  if (!surface->IsValid()) {
+    return nullptr;
+  }
+
+  return surface;
+}
+
+}  // namespace shell
@@ -8,6 +8,7 @@
 #include <memory>
 
 #include "flutter/shell/common/platform_view.h"
+#include "flutter/shell/platform/darwin/ios/framework/Headers/FlutterTexture.h"
 #include "flutter/shell/platform/darwin/ios/framework/Source/accessibility_bridge.h"
 #include "flutter/shell/platform/darwin/ios/framework/Source/platform_message_router.h"
 #include "flutter/shell/platform/darwin/ios/ios_surface.h"
@@ -35,6 +36,8 @@ class PlatformViewIOS : public PlatformView {
 
   void ToggleAccessibility(UIView* view, bool enabled);
 
+  void RegisterExternalTexture(int64_t id, NSObject<FlutterTexture>* texture);
+
   PlatformMessageRouter& platform_message_router() {
     return platform_message_router_;
   }
@@ -13,6 +13,7 @@
 #include "flutter/shell/gpu/gpu_rasterizer.h"
 #include "flutter/shell/platform/darwin/common/process_info_mac.h"
 #include "flutter/shell/platform/darwin/ios/framework/Source/vsync_waiter_ios.h"
+#include "flutter/shell/platform/darwin/ios/ios_external_texture_gl.h"
 #include "lib/fxl/synchronization/waitable_event.h"
 
 namespace shell {
@@ -58,6 +59,11 @@ void PlatformViewIOS::ToggleAccessibility(UIView* view, bool enabled) {
   SetSemanticsEnabled(enabled);
 }
 
+void PlatformViewIOS::RegisterExternalTexture(int64_t texture_id,
+                                              NSObject<FlutterTexture>* texture) {
+  RegisterTexture(std::make_shared<IOSExternalTextureGL>(texture_id, texture));
+}
+
 void PlatformViewIOS::SetupAndLoadFromSource(const std::string& assets_directory,
                                              const std::string& main,
                                              const std::string& packages) {
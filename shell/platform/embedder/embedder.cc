@@ -5,10 +5,20 @@
 #define FLUTTER_EXPORT __attribute__((visibility("default")))
 
 #include "flutter/shell/platform/embedder/embedder.h"
+#include <atomic>
 #include <type_traits>
 #include "flutter/common/threads.h"
+#include "flutter/flow/compositor_context.h"
+#include "flutter/flow/frame_statistics.h"
+#include "flutter/runtime/start_up.h"
+#include "flutter/shell/platform/embedder/embedder_task_runner.h"
 #include "flutter/shell/platform/embedder/platform_view_embedder.h"
 #include "lib/fxl/functional/make_copyable.h"
+#include "lib/fxl/synchronization/waitable_event.h"
+#include "third_party/dart/runtime/include/dart_tools_api.h"
+#include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/gpu/GrBackendSurface.h"
+#include "third_party/skia/include/gpu/gl/GrGLTypes.h"
 
 #define SAFE_ACCESS(pointer, member, default_value)                      \
   ({                                                                     \
@@ -22,11 +32,7 @@
     _return_value;                                                       \
   })
 
-bool IsRendererValid(const FlutterRendererConfig* config) {
-  if (config == nullptr || config->type != kOpenGL) {
-    return false;
-  }
-
+static bool IsOpenGLRendererConfigValid(const FlutterRendererConfig* config) {
   const FlutterOpenGLRendererConfig* open_gl_config = &config->open_gl;
 
   if (SAFE_ACCESS(open_gl_config, make_current, nullptr) == nullptr ||
@@ -39,6 +45,156 @@ bool IsRendererValid(const FlutterRendererConfig* config) {
   return true;
 }
 
+static bool IsSoftwareRendererConfigValid(
+    const FlutterRendererConfig* config) {
+  const FlutterSoftwareRendererConfig* software_config = &config->software;
+
+  if (SAFE_ACCESS(software_config, acquire_backing_store_callback, nullptr) ==
+          nullptr ||
+      SAFE_ACCESS(software_config, present_backing_store_callback, nullptr) ==
+          nullptr) {
+    return false;
+  }
+
+  return true;
+}
+
+bool IsRendererValid(const FlutterRendererConfig* config) {
+  if (config == nullptr) {
+    return false;
+  }
+
+  switch (config->type) {
+    case kOpenGL:
+      return IsOpenGLRendererConfigValid(config);
+    case kSoftware:
+      return IsSoftwareRendererConfigValid(config);
+  }
+
+  return false;
+}
+
+// Creates the runner described by the embedder in |runner|, which is left
+// null without a description. Returns false if the description is incomplete.
+static bool CreateEmbedderTaskRunner(
+    const FlutterTaskRunnerDescription* description,
+    fxl::RefPtr<fxl::TaskRunner>* runner) {
+  if (description == nullptr) {
+    return true;
+  }
+
+  auto runs_task_on_current_thread = SAFE_ACCESS(
+      description, runs_task_on_current_thread_callback, nullptr);
+  auto post_task = SAFE_ACCESS(description, post_task_callback, nullptr);
+  if (runs_task_on_current_thread == nullptr || post_task == nullptr) {
+    return false;
+  }
+  void* user_data = SAFE_ACCESS(description, user_data, nullptr);
+
+  shell::EmbedderTaskRunner::DispatchTable table = {
+      .post_task_callback =
+          [post_task, user_data](shell::EmbedderTaskRunner* task_runner,
+                                 uint64_t task_baton,
+                                 fxl::TimePoint target_time) {
+            FlutterTask task = {
+                reinterpret_cast<FlutterTaskRunner>(task_runner), task_baton};
+            post_task(task, target_time.ToEpochDelta().ToNanoseconds(),
+                      user_data);
+          },
+      .runs_task_on_current_thread_callback =
+          [runs_task_on_current_thread, user_data]() {
+            return runs_task_on_current_thread(user_data);
+          }};
+  *runner = fxl::MakeRefCounted<shell::EmbedderTaskRunner>(std::move(table));
+  return true;
+}
+
+static FlutterFrameTiming ToFlutterFrameTiming(
+    const flow::FrameTiming& timing) {
+  FlutterFrameTiming record = {};
+  record.struct_size = sizeof(FlutterFrameTiming);
+  record.frame_number = timing.frame_number();
+  record.vsync_start = timing.GetMicros(flow::FrameTiming::kVsyncStart);
+  record.build_start = timing.GetMicros(flow::FrameTiming::kBuildStart);
+  record.build_finish = timing.GetMicros(flow::FrameTiming::kBuildFinish);
+  record.raster_start = timing.GetMicros(flow::FrameTiming::kRasterStart);
+  record.raster_finish = timing.GetMicros(flow::FrameTiming::kRasterFinish);
+  record.present = timing.GetMicros(flow::FrameTiming::kPresent);
+  record.display = timing.GetMicros(flow::FrameTiming::kDisplay);
+  return record;
+}
+
+// The default interval over which frame statistics are aggregated.
+static constexpr fxl::TimeDelta kDefaultFrameStatisticsInterval =
+    fxl::TimeDelta::FromSeconds(10);
+
+static void ReportFrameStatistics(FrameStatisticsCallback callback,
+                                  void* user_data,
+                                  const flow::FrameStatistics& statistics) {
+  constexpr size_t kBucketCount = fml::LatencyHistogram::kBucketCount;
+  int64_t bucket_limits[kBucketCount];
+  for (size_t i = 0; i < kBucketCount; i++) {
+    bucket_limits[i] = fml::LatencyHistogram::GetBucketLimitMicros(i);
+  }
+
+  FlutterFrameStatistics record = {};
+  record.struct_size = sizeof(FlutterFrameStatistics);
+  record.start = (statistics.start - fxl::TimePoint()).ToMicroseconds();
+  record.end = (statistics.end - fxl::TimePoint()).ToMicroseconds();
+  record.frame_count = statistics.frame_count;
+  record.bucket_count = kBucketCount;
+  record.bucket_limits = bucket_limits;
+  record.build_time_counts = statistics.build_time_counts.data();
+  record.raster_time_counts = statistics.raster_time_counts.data();
+  record.janky_build_frame_count = statistics.janky_build_frame_count;
+  record.janky_raster_frame_count = statistics.janky_raster_frame_count;
+  record.raster_cache_hit_count = statistics.raster_cache_hit_count;
+  record.raster_cache_miss_count = statistics.raster_cache_miss_count;
+  record.peak_gpu_resource_cache_bytes =
+      statistics.peak_gpu_resource_cache_bytes;
+  callback(&record, user_data);
+}
+
+// A host supplied ring of pointer events. Shared with the engine's frame
+// input callback, which may outlive the holder.
+struct PointerEventRingState {
+  FlutterPointerEventRing* ring = nullptr;
+  // Set when the host notifies and cleared when a frame drains the ring.
+  std::atomic_bool drain_requested{false};
+};
+
+// Wraps the texture the embedder hands out for the current frame of an
+// external texture.
+static sk_sp<SkImage> ToSkImage(TextureFrameCallback callback,
+                                void* user_data,
+                                int64_t texture_identifier,
+                                GrContext* context,
+                                const SkISize& size) {
+  FlutterOpenGLTexture texture = {};
+  if (!callback(user_data, texture_identifier, size.width(), size.height(),
+                &texture)) {
+    return nullptr;
+  }
+
+  // GL_BGRA8_EXT. Everything else is sampled as RGBA.
+  constexpr uint32_t kGLBGRA8 = 0x93A1;
+  GrGLTextureInfo gr_texture_info = {texture.target, texture.name};
+  GrBackendTexture gr_backend_texture(
+      size.width(), size.height(),
+      texture.format == kGLBGRA8 ? kBGRA_8888_GrPixelConfig
+                                 : kRGBA_8888_GrPixelConfig,
+      gr_texture_info);
+  sk_sp<SkImage> image = SkImage::MakeFromTexture(
+      context, gr_backend_texture, kTopLeft_GrSurfaceOrigin,
+      kPremul_SkAlphaType, nullptr, texture.destruction_callback,
+      texture.user_data);
+  if (!image && texture.destruction_callback) {
+    // Skia did not take ownership of the texture.
+    texture.destruction_callback(texture.user_data);
+  }
+  return image;
+}
+
 class PlatformViewHolder {
  public:
   PlatformViewHolder(std::shared_ptr<shell::PlatformViewEmbedder> ptr)
@@ -48,8 +204,17 @@ class PlatformViewHolder {
     return platform_view_;
   }
 
+  std::shared_ptr<PointerEventRingState> pointer_event_ring() const {
+    return pointer_event_ring_;
+  }
+
+  void set_pointer_event_ring(std::shared_ptr<PointerEventRingState> ring) {
+    pointer_event_ring_ = std::move(ring);
+  }
+
  private:
   std::shared_ptr<shell::PlatformViewEmbedder> platform_view_;
+  std::shared_ptr<PointerEventRingState> pointer_event_ring_;
 
   FXL_DISALLOW_COPY_AND_ASSIGN(PlatformViewHolder);
 };
@@ -59,6 +224,10 @@ FlutterResult FlutterEngineRun(size_t version,
                                const FlutterProjectArgs* args,
                                void* user_data,
                                FlutterEngine* engine_out) {
+  if (blink::engine_main_enter_ts == 0) {
+    blink::engine_main_enter_ts = Dart_TimelineGetMicros();
+  }
+
   if (version != FLUTTER_ENGINE_VERSION) {
     return kInvalidLibraryVersion;
   }
@@ -81,40 +250,154 @@ FlutterResult FlutterEngineRun(size_t version,
     return kInvalidArguments;
   }
 
-  auto make_current =
-      [ ptr = config->open_gl.make_current, user_data ]()->bool {
-    return ptr(user_data);
-  };
+  shell::Shell::CustomTaskRunners custom_task_runners;
+  if (auto runners = SAFE_ACCESS(args, custom_task_runners, nullptr)) {
+    if (!CreateEmbedderTaskRunner(
+            SAFE_ACCESS(runners, platform_task_runner, nullptr),
+            &custom_task_runners.platform) ||
+        !CreateEmbedderTaskRunner(
+            SAFE_ACCESS(runners, render_task_runner, nullptr),
+            &custom_task_runners.gpu)) {
+      return kInvalidArguments;
+    }
+  }
+  const bool has_custom_task_runners =
+      custom_task_runners.platform || custom_task_runners.gpu;
+
+  std::function<void(const std::vector<flow::FrameTiming>&)>
+      frame_timings_callback = nullptr;
+  if (auto ptr = SAFE_ACCESS(args, frame_timings_callback, nullptr)) {
+    frame_timings_callback =
+        [ptr, user_data](const std::vector<flow::FrameTiming>& timings) {
+          std::vector<FlutterFrameTiming> records;
+          records.reserve(timings.size());
+          for (const auto& timing : timings) {
+            records.push_back(ToFlutterFrameTiming(timing));
+          }
+          ptr(records.data(), records.size(), user_data);
+        };
+  }
 
-  auto clear_current =
-      [ ptr = config->open_gl.clear_current, user_data ]()->bool {
-    return ptr(user_data);
-  };
+  shell::Rasterizer::FramePresentedCallback frame_presented_callback =
+      nullptr;
+  if (auto ptr = SAFE_ACCESS(args, frame_presented_callback, nullptr)) {
+    frame_presented_callback = [ptr,
+                                user_data](const flow::FrameTiming& timing) {
+      FlutterFrameTiming record = ToFlutterFrameTiming(timing);
+      ptr(&record, user_data);
+    };
+  }
 
-  auto present = [ ptr = config->open_gl.present, user_data ]()->bool {
-    return ptr(user_data);
-  };
+  std::function<void(const flow::FrameStatistics&)>
+      frame_statistics_callback = nullptr;
+  fxl::TimeDelta frame_statistics_interval = kDefaultFrameStatisticsInterval;
+  if (auto ptr = SAFE_ACCESS(args, frame_statistics_callback, nullptr)) {
+    frame_statistics_callback =
+        [ptr, user_data](const flow::FrameStatistics& statistics) {
+          ReportFrameStatistics(ptr, user_data, statistics);
+        };
+    if (auto interval = SAFE_ACCESS(args, frame_statistics_interval, 0)) {
+      if (interval < 0) {
+        return kInvalidArguments;
+      }
+      frame_statistics_interval = fxl::TimeDelta::FromMilliseconds(interval);
+    }
+  }
 
-  auto fbo_callback =
-      [ ptr = config->open_gl.fbo_callback, user_data ]()->intptr_t {
-    return ptr(user_data);
-  };
+  shell::VsyncWaiterEmbedder::VsyncCallback vsync_callback = nullptr;
+  if (auto ptr = SAFE_ACCESS(args, vsync_callback, nullptr)) {
+    vsync_callback = [ptr, user_data](intptr_t baton) {
+      ptr(user_data, baton);
+    };
+  }
 
+  bool initialized_shell = false;
   static std::once_flag once_shell_initialization;
   std::call_once(once_shell_initialization, [&]() {
     fxl::CommandLine null_command_line;
     shell::Shell::InitStandalone(
         fxl::CommandLine{},
         "",  // icu data path default lookup.
-        ""   // application library not supported in JIT mode.
-    );
+        "",  // application library not supported in JIT mode.
+        std::move(custom_task_runners));
+    initialized_shell = true;
   });
 
-  shell::PlatformViewEmbedder::DispatchTable table = {
-      .gl_make_current_callback = make_current,
-      .gl_clear_current_callback = clear_current,
-      .gl_present_callback = present,
-      .gl_fbo_callback = fbo_callback};
+  if (has_custom_task_runners && !initialized_shell) {
+    // The threads of the engine that was run first are already in use.
+    return kInvalidArguments;
+  }
+
+  shell::PlatformViewEmbedder::DispatchTable table = {};
+  table.frame_timings_callback = frame_timings_callback;
+  table.vsync_callback = vsync_callback;
+  table.frame_presented_callback = frame_presented_callback;
+  table.frame_statistics_callback = frame_statistics_callback;
+  table.frame_statistics_interval = frame_statistics_interval;
+
+  if (config->type == kSoftware) {
+    table.software_acquire_callback =
+        [ ptr = config->software.acquire_backing_store_callback, user_data ](
+            const SkISize& size,
+            shell::PlatformViewEmbedder::SoftwareBackingStore* backing_store)
+            ->bool {
+      FlutterSoftwareBackingStore store = {};
+      store.struct_size = sizeof(FlutterSoftwareBackingStore);
+      if (!ptr(user_data, size.width(), size.height(), &store)) {
+        return false;
+      }
+      backing_store->allocation = store.allocation;
+      backing_store->row_bytes = store.row_bytes;
+      backing_store->user_data = store.user_data;
+      return true;
+    };
+
+    table.software_present_callback =
+        [ ptr = config->software.present_backing_store_callback, user_data ](
+            const shell::PlatformViewEmbedder::SoftwareBackingStore&
+                backing_store)
+            ->bool {
+      FlutterSoftwareBackingStore store = {};
+      store.struct_size = sizeof(FlutterSoftwareBackingStore);
+      store.allocation = backing_store.allocation;
+      store.row_bytes = backing_store.row_bytes;
+      store.user_data = backing_store.user_data;
+      return ptr(user_data, &store);
+    };
+  } else {
+    table.gl_make_current_callback =
+        [ ptr = config->open_gl.make_current, user_data ]()->bool {
+      return ptr(user_data);
+    };
+
+    table.gl_clear_current_callback =
+        [ ptr = config->open_gl.clear_current, user_data ]()->bool {
+      return ptr(user_data);
+    };
+
+    table.gl_present_callback =
+        [ ptr = config->open_gl.present, user_data ]()->bool {
+      return ptr(user_data);
+    };
+
+    table.gl_fbo_callback =
+        [ ptr = config->open_gl.fbo_callback, user_data ]()->intptr_t {
+      return ptr(user_data);
+    };
+
+    table.gl_context_is_thread_exclusive =
+        SAFE_ACCESS(&config->open_gl, context_is_thread_exclusive, false);
+
+    if (auto ptr = SAFE_ACCESS(&config->open_gl,
+                               gl_external_texture_frame_callback, nullptr)) {
+      table.external_texture_callback = [ptr, user_data](
+                                            int64_t texture_identifier,
+                                            GrContext* context,
+                                            const SkISize& size) {
+        return ToSkImage(ptr, user_data, texture_identifier, context, size);
+      };
+    }
+  }
 
   auto platform_view = std::make_shared<shell::PlatformViewEmbedder>(table);
   platform_view->Attach();
@@ -193,6 +476,262 @@ inline blink::PointerData::Change ToPointerDataChange(
   return blink::PointerData::Change::kCancel;
 }
 
+blink::PointerData ToPointerData(const FlutterPointerEvent* event) {
+  blink::PointerData pointer_data;
+  pointer_data.Clear();
+  pointer_data.time_stamp = SAFE_ACCESS(event, timestamp, 0);
+  pointer_data.change = ToPointerDataChange(
+      SAFE_ACCESS(event, phase, FlutterPointerPhase::kCancel));
+  pointer_data.kind = blink::PointerData::DeviceKind::kMouse;
+  pointer_data.physical_x = SAFE_ACCESS(event, x, 0.0);
+  pointer_data.physical_y = SAFE_ACCESS(event, y, 0.0);
+  return pointer_data;
+}
+
+// Runs on the UI thread at the start of a frame.
+void DrainPointerEventRing(PointerEventRingState* state,
+                           shell::Engine* engine) {
+  state->drain_requested = false;
+
+  FlutterPointerEventRing* ring = state->ring;
+  static_assert(sizeof(std::atomic<uint64_t>) == sizeof(uint64_t),
+                "The ring counters must be usable as atomics in place.");
+  auto* write_count =
+      reinterpret_cast<std::atomic<uint64_t>*>(&ring->write_count);
+  auto* read_count = reinterpret_cast<std::atomic<uint64_t>*>(&ring->read_count);
+
+  const uint64_t end = write_count->load(std::memory_order_acquire);
+  const uint64_t begin = read_count->load(std::memory_order_relaxed);
+  if (end == begin || end - begin > ring->capacity) {
+    // Empty, or the host broke the protocol.
+    return;
+  }
+
+  const uint8_t* slots = reinterpret_cast<const uint8_t*>(ring + 1);
+  blink::PointerDataPacket packet(end - begin);
+  for (uint64_t i = begin; i < end; i++) {
+    const auto* event = reinterpret_cast<const FlutterPointerEvent*>(
+        slots + (i % ring->capacity) * ring->slot_size);
+    packet.SetPointerData(i - begin, ToPointerData(event));
+  }
+  read_count->store(end, std::memory_order_release);
+
+  engine->DispatchPointerDataPacket(packet);
+}
+
+FlutterResult FlutterEngineSetPointerEventRing(FlutterEngine engine,
+                                               FlutterPointerEventRing* ring) {
+  if (engine == nullptr || ring == nullptr || ring->capacity == 0 ||
+      ring->slot_size < sizeof(FlutterPointerEvent)) {
+    return kInvalidArguments;
+  }
+
+  auto holder = reinterpret_cast<PlatformViewHolder*>(engine);
+  if (holder->pointer_event_ring() != nullptr) {
+    return kInvalidArguments;
+  }
+
+  auto state = std::make_shared<PointerEventRingState>();
+  state->ring = ring;
+  holder->set_pointer_event_ring(state);
+
+  blink::Threads::UI()->PostTask(
+      [ state, weak_engine = holder->view()->engine().GetWeakPtr() ] {
+        if (auto engine = weak_engine) {
+          shell::Engine* raw_engine = engine.get();
+          raw_engine->SetFrameInputCallback([state, raw_engine]() {
+            DrainPointerEventRing(state.get(), raw_engine);
+          });
+        }
+      });
+  return kSuccess;
+}
+
+FlutterResult FlutterEngineNotifyPointerEventRing(FlutterEngine engine) {
+  if (engine == nullptr) {
+    return kInvalidArguments;
+  }
+
+  auto holder = reinterpret_cast<PlatformViewHolder*>(engine);
+  auto state = holder->pointer_event_ring();
+  if (state == nullptr) {
+    return kInvalidArguments;
+  }
+
+  if (state->drain_requested.exchange(true)) {
+    // A frame that drains the ring is already on its way.
+    return kSuccess;
+  }
+
+  blink::Threads::UI()->PostTask(
+      [weak_engine = holder->view()->engine().GetWeakPtr()] {
+        if (auto engine = weak_engine) {
+          engine->NotifyInputPending();
+        }
+      });
+  return kSuccess;
+}
+
+FlutterResult FlutterEngineNotifyMemoryPressure(
+    FlutterEngine engine,
+    FlutterMemoryPressureLevel level) {
+  if (engine == nullptr) {
+    return kInvalidArguments;
+  }
+
+  reinterpret_cast<PlatformViewHolder*>(engine)->view()->NotifyMemoryPressure(
+      level == kFlutterMemoryPressureCritical
+          ? shell::MemoryPressureLevel::kCritical
+          : shell::MemoryPressureLevel::kModerate);
+  return kSuccess;
+}
+
+FlutterResult FlutterEngineSetFrameRateDivisor(FlutterEngine engine,
+                                               uint32_t divisor) {
+  if (engine == nullptr || divisor == 0) {
+    return kInvalidArguments;
+  }
+
+  reinterpret_cast<PlatformViewHolder*>(engine)->view()->SetFrameRateDivisor(
+      divisor);
+  return kSuccess;
+}
+
+FlutterResult FlutterEngineGetStartupTimeline(
+    FlutterEngine engine,
+    FlutterStartupTimeline* timeline) {
+  if (engine == nullptr || timeline == nullptr ||
+      timeline->struct_size != sizeof(FlutterStartupTimeline)) {
+    return kInvalidArguments;
+  }
+
+  auto phase = [](blink::StartupPhase startup_phase) {
+    blink::StartupPhaseTiming timing =
+        blink::GetStartupPhaseTiming(startup_phase);
+    return FlutterStartupPhase{timing.start, timing.end};
+  };
+  timeline->engine_main_enter = blink::engine_main_enter_ts;
+  timeline->dart_vm_init = phase(blink::StartupPhase::kDartVMInit);
+  timeline->snapshot_load = phase(blink::StartupPhase::kSnapshotLoad);
+  timeline->root_isolate_creation =
+      phase(blink::StartupPhase::kRootIsolateCreation);
+  timeline->main_invocation = phase(blink::StartupPhase::kMainInvocation);
+  timeline->first_begin_frame = phase(blink::StartupPhase::kFirstBeginFrame);
+  timeline->first_render = phase(blink::StartupPhase::kFirstRender);
+  timeline->first_present = phase(blink::StartupPhase::kFirstPresent);
+  return kSuccess;
+}
+
+// Runs on the GPU thread.
+static bool RasterizeLastFrame(
+    const fxl::WeakPtr<shell::Rasterizer>& rasterizer,
+    const SkImageInfo& info,
+    void* allocation,
+    size_t row_bytes) {
+  if (!rasterizer) {
+    return false;
+  }
+
+  flow::LayerTree* layer_tree = rasterizer->GetLastLayerTree();
+  if (layer_tree == nullptr || layer_tree->frame_size().isEmpty()) {
+    return false;
+  }
+
+  sk_sp<SkSurface> surface =
+      SkSurface::MakeRasterDirect(info, allocation, row_bytes);
+  if (surface == nullptr) {
+    return false;
+  }
+
+  flow::CompositorContext compositor_context(nullptr);
+  SkCanvas* canvas = surface->getCanvas();
+  flow::CompositorContext::ScopedFrame frame =
+      compositor_context.AcquireFrame(nullptr, canvas, false);
+
+  const SkISize& frame_size = layer_tree->frame_size();
+  canvas->clear(SK_ColorBLACK);
+  canvas->scale(static_cast<SkScalar>(info.width()) / frame_size.width(),
+                static_cast<SkScalar>(info.height()) / frame_size.height());
+  layer_tree->Raster(frame);
+  canvas->flush();
+  return true;
+}
+
+FlutterResult FlutterEngineRasterizeLastFrame(
+    FlutterEngine engine,
+    size_t width,
+    size_t height,
+    const FlutterSoftwareBackingStore* backing_store) {
+  if (engine == nullptr || backing_store == nullptr || width == 0 ||
+      height == 0) {
+    return kInvalidArguments;
+  }
+
+  void* allocation = SAFE_ACCESS(backing_store, allocation, nullptr);
+  const size_t row_bytes = SAFE_ACCESS(backing_store, row_bytes, 0);
+  const SkImageInfo info = SkImageInfo::MakeN32Premul(width, height);
+  if (allocation == nullptr || row_bytes < info.minRowBytes()) {
+    return kInvalidArguments;
+  }
+
+  fxl::WeakPtr<shell::Rasterizer> rasterizer =
+      reinterpret_cast<PlatformViewHolder*>(engine)
+          ->view()
+          ->rasterizer()
+          .GetWeakRasterizerPtr();
+
+  bool rasterized = false;
+  if (blink::Threads::Gpu()->RunsTasksOnCurrentThread()) {
+    // A custom render task runner may call this from its own thread.
+    rasterized = RasterizeLastFrame(rasterizer, info, allocation, row_bytes);
+  } else {
+    fxl::AutoResetWaitableEvent latch;
+    blink::Threads::Gpu()->PostTask([&]() {
+      rasterized = RasterizeLastFrame(rasterizer, info, allocation, row_bytes);
+      latch.Signal();
+    });
+    latch.Wait();
+  }
+
+  return rasterized ? kSuccess : kInvalidArguments;
+}
+
+FlutterResult FlutterEngineOnVsync(FlutterEngine engine,
+                                   intptr_t baton,
+                                   uint64_t frame_start_time_nanos,
+                                   uint64_t frame_target_time_nanos) {
+  if (engine == nullptr || baton == 0 ||
+      frame_target_time_nanos < frame_start_time_nanos) {
+    return kInvalidArguments;
+  }
+
+  shell::VsyncWaiterEmbedder::OnEmbedderVsync(
+      baton,
+      fxl::TimePoint::FromEpochDelta(
+          fxl::TimeDelta::FromNanoseconds(frame_start_time_nanos)),
+      fxl::TimePoint::FromEpochDelta(
+          fxl::TimeDelta::FromNanoseconds(frame_target_time_nanos)));
+  return kSuccess;
+}
+
+uint64_t FlutterEngineGetCurrentTime() {
+  return fxl::TimePoint::Now().ToEpochDelta().ToNanoseconds();
+}
+
+FlutterResult FlutterEngineRunTask(FlutterEngine engine,
+                                   const FlutterTask* task) {
+  if (engine == nullptr || task == nullptr || task->runner == nullptr) {
+    return kInvalidArguments;
+  }
+
+  // The runners live as long as the process.
+  if (!reinterpret_cast<shell::EmbedderTaskRunner*>(task->runner)
+           ->RunTask(task->task)) {
+    return kInvalidArguments;
+  }
+  return kSuccess;
+}
+
 FlutterResult FlutterEngineSendPointerEvent(FlutterEngine engine,
                                             const FlutterPointerEvent* pointers,
                                             size_t events_count) {
@@ -205,15 +744,7 @@ FlutterResult FlutterEngineSendPointerEvent(FlutterEngine engine,
   const FlutterPointerEvent* current = pointers;
 
   for (size_t i = 0; i < events_count; ++i) {
-    blink::PointerData pointer_data;
-    pointer_data.Clear();
-    pointer_data.time_stamp = SAFE_ACCESS(current, timestamp, 0);
-    pointer_data.change = ToPointerDataChange(
-        SAFE_ACCESS(current, phase, FlutterPointerPhase::kCancel));
-    pointer_data.kind = blink::PointerData::DeviceKind::kMouse;
-    pointer_data.physical_x = SAFE_ACCESS(current, x, 0.0);
-    pointer_data.physical_y = SAFE_ACCESS(current, y, 0.0);
-    packet->SetPointerData(i, pointer_data);
+    packet->SetPointerData(i, ToPointerData(current));
     current = reinterpret_cast<const FlutterPointerEvent*>(
         reinterpret_cast<const uint8_t*>(current) + current->struct_size);
   }
@@ -247,12 +778,27 @@ FlutterResult FlutterEngineSendPlatformMessage(
 
   auto holder = reinterpret_cast<PlatformViewHolder*>(engine);
 
-  auto message = fxl::MakeRefCounted<blink::PlatformMessage>(
-      flutter_message->channel,
-      std::vector<uint8_t>(
-          flutter_message->message,
-          flutter_message->message + flutter_message->message_size),
-      nullptr);
+  fxl::RefPtr<blink::PlatformMessage> message;
+  auto release_callback =
+      SAFE_ACCESS(flutter_message, release_callback, nullptr);
+  if (release_callback != nullptr) {
+    const uint8_t* data = flutter_message->message;
+    const size_t size = flutter_message->message_size;
+    void* user_data = SAFE_ACCESS(flutter_message, release_user_data, nullptr);
+    message = fxl::MakeRefCounted<blink::PlatformMessage>(
+        flutter_message->channel, const_cast<uint8_t*>(data), size,
+        [release_callback, data, size, user_data]() {
+          release_callback(data, size, user_data);
+        },
+        nullptr);
+  } else {
+    message = fxl::MakeRefCounted<blink::PlatformMessage>(
+        flutter_message->channel,
+        std::vector<uint8_t>(
+            flutter_message->message,
+            flutter_message->message + flutter_message->message_size),
+        nullptr);
+  }
 
   blink::Threads::UI()->PostTask(
       [ weak_engine = holder->view()->engine().GetWeakPtr(), message ] {
@@ -262,3 +808,42 @@ FlutterResult FlutterEngineSendPlatformMessage(
       });
   return kSuccess;
 }
+
+FlutterResult FlutterEngineRegisterExternalTexture(FlutterEngine engine,
+                                                   int64_t texture_identifier) {
+  if (engine == nullptr) {
+    return kInvalidArguments;
+  }
+
+  if (!reinterpret_cast<PlatformViewHolder*>(engine)
+           ->view()
+           ->RegisterExternalTexture(texture_identifier)) {
+    return kInvalidArguments;
+  }
+  return kSuccess;
+}
+
+FlutterResult FlutterEngineUnregisterExternalTexture(
+    FlutterEngine engine,
+    int64_t texture_identifier) {
+  if (engine == nullptr) {
+    return kInvalidArguments;
+  }
+
+  reinterpret_cast<PlatformViewHolder*>(engine)->view()->UnregisterTexture(
+      texture_identifier);
+  return kSuccess;
+}
+
+FlutterResult FlutterEngineMarkExternalTextureFrameAvailable(
+    FlutterEngine engine,
+    int64_t texture_identifier) {
+  if (engine == nullptr) {
+    return kInvalidArguments;
+  }
+
+  reinterpret_cast<PlatformViewHolder*>(engine)
+      ->view()
+      ->MarkTextureFrameAvailable(texture_identifier);
+  return kSuccess;
+}
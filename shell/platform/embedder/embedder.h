@@ -27,12 +27,34 @@ typedef enum {
 
 typedef enum {
   kOpenGL,
+  kSoftware,
 } FlutterRendererType;
 
 typedef struct _FlutterEngine* FlutterEngine;
 
 typedef bool (*BoolCallback)(void* /* user data */);
 typedef uint32_t (*UIntCallback)(void* /* user data */);
+typedef void (*VoidCallback)(void* /* user data */);
+
+typedef struct {
+  // Target texture of the active texture unit (example GL_TEXTURE_2D).
+  uint32_t target;
+  // The name of the texture.
+  uint32_t name;
+  // The texture format (example GL_RGBA8).
+  uint32_t format;
+  // User data to be returned on the invocation of the destruction callback.
+  void* user_data;
+  // Callback invoked on a thread managed by the engine once the engine no
+  // longer samples the texture. The embedder may then collect it.
+  VoidCallback destruction_callback;
+} FlutterOpenGLTexture;
+
+typedef bool (*TextureFrameCallback)(void* /* user data */,
+                                     int64_t /* texture identifier */,
+                                     size_t /* width */,
+                                     size_t /* height */,
+                                     FlutterOpenGLTexture* /* texture out */);
 
 typedef struct {
   // The size of this struct. Must be sizeof(FlutterOpenGLRendererConfig).
@@ -41,15 +63,157 @@ typedef struct {
   BoolCallback clear_current;
   BoolCallback present;
   UIntCallback fbo_callback;
+  // Optional. Called on the GPU thread, with the rendering context current,
+  // when the engine composites an external texture that has been marked as
+  // having a new frame. The size is the one the texture will be drawn at.
+  // Return false if no texture is available.
+  TextureFrameCallback gl_external_texture_frame_callback;
+  // Optional. Set if the context of |make_current| is only made current on
+  // the GPU thread by the engine and no other context is made current on that
+  // thread. The engine then keeps it current instead of calling
+  // |make_current| for every frame.
+  bool context_is_thread_exclusive;
 } FlutterOpenGLRendererConfig;
 
+typedef struct {
+  // The size of this struct. Must be sizeof(FlutterSoftwareBackingStore).
+  size_t struct_size;
+  // Memory for the N32 premultiplied pixels of the frame, owned by the
+  // embedder. Rows are |row_bytes| apart, which must be at least four times
+  // the width.
+  void* allocation;
+  size_t row_bytes;
+  // Handed back with the backing store when it is presented.
+  void* user_data;
+} FlutterSoftwareBackingStore;
+
+typedef bool (*SoftwareBackingStoreAcquireCallback)(
+    void* /* user data */,
+    size_t /* width */,
+    size_t /* height */,
+    FlutterSoftwareBackingStore* /* backing store out */);
+
+typedef bool (*SoftwareBackingStorePresentCallback)(
+    void* /* user data */,
+    const FlutterSoftwareBackingStore* /* backing store */);
+
+typedef struct {
+  // The size of this struct. Must be sizeof(FlutterSoftwareRendererConfig).
+  size_t struct_size;
+  // Called on the GPU thread for the memory the engine renders the next frame
+  // into, which is drawn into directly instead of being copied out of a
+  // buffer of the engine. Return false if no memory is available.
+  SoftwareBackingStoreAcquireCallback acquire_backing_store_callback;
+  // Called on the GPU thread once the frame has been rendered into the last
+  // acquired backing store. Frames that are dropped between the two calls
+  // leave the backing store to be acquired again.
+  SoftwareBackingStorePresentCallback present_backing_store_callback;
+} FlutterSoftwareRendererConfig;
+
 typedef struct {
   FlutterRendererType type;
   union {
     FlutterOpenGLRendererConfig open_gl;
+    FlutterSoftwareRendererConfig software;
   };
 } FlutterRendererConfig;
 
+typedef struct {
+  // The size of this struct. Must be sizeof(FlutterFrameTiming).
+  size_t struct_size;
+  // The sequence number of the frame. Gaps indicate frames that were begun but
+  // not presented.
+  int64_t frame_number;
+  // Timestamps in microseconds on the engine's monotonic clock.
+  int64_t vsync_start;
+  int64_t build_start;
+  int64_t build_finish;
+  int64_t raster_start;
+  int64_t raster_finish;
+  int64_t present;
+  // When the frame appeared on the display. Zero if the renderer does not
+  // report display times or the display skipped the frame.
+  int64_t display;
+} FlutterFrameTiming;
+
+typedef void (*FramePresentedCallback)(const FlutterFrameTiming* /* timing */,
+                                       void* /* user data */);
+
+typedef struct {
+  // The size of this struct. Must be sizeof(FlutterFrameStatistics).
+  size_t struct_size;
+  // The interval the statistics were collected over, in microseconds on the
+  // engine's monotonic clock.
+  int64_t start;
+  int64_t end;
+  // The number of frames presented in the interval.
+  size_t frame_count;
+  // Histograms of the time frames spent being built on the UI thread and
+  // rasterized on the GPU thread. Bucket i counts the frames that took less
+  // than bucket_limits[i] microseconds, and at least bucket_limits[i - 1]. The
+  // last bucket is unbounded.
+  size_t bucket_count;
+  const int64_t* bucket_limits;
+  const uint64_t* build_time_counts;
+  const uint64_t* raster_time_counts;
+  // The frames whose build or raster time exceeded the frame budget.
+  size_t janky_build_frame_count;
+  size_t janky_raster_frame_count;
+  // Lookups of the frames in the raster cache that found a rasterized image,
+  // and that did not.
+  size_t raster_cache_hit_count;
+  size_t raster_cache_miss_count;
+  // The most bytes the GPU resource cache held after any of the frames.
+  int64_t peak_gpu_resource_cache_bytes;
+} FlutterFrameStatistics;
+
+typedef void (*FrameStatisticsCallback)(
+    const FlutterFrameStatistics* /* statistics */,
+    void* /* user data */);
+
+typedef void (*VsyncCallback)(void* /* user data */, intptr_t /* baton */);
+
+typedef struct _FlutterTaskRunner* FlutterTaskRunner;
+
+typedef struct {
+  FlutterTaskRunner runner;
+  uint64_t task;
+} FlutterTask;
+
+typedef void (*FlutterTaskRunnerPostTaskCallback)(
+    FlutterTask /* task */,
+    uint64_t /* target time in nanoseconds */,
+    void* /* user data */);
+
+typedef struct {
+  // The size of this struct. Must be sizeof(FlutterTaskRunnerDescription).
+  size_t struct_size;
+  void* user_data;
+  // Called on any thread. Returns whether the calling thread is the one the
+  // embedder runs the tasks of this runner on.
+  BoolCallback runs_task_on_current_thread_callback;
+  // Called on any thread with a task the embedder must hand back to
+  // |FlutterEngineRunTask| on the thread of the runner once the target time,
+  // on the clock of |FlutterEngineGetCurrentTime|, has been reached.
+  FlutterTaskRunnerPostTaskCallback post_task_callback;
+} FlutterTaskRunnerDescription;
+
+typedef struct {
+  // The size of this struct. Must be sizeof(FlutterCustomTaskRunners).
+  size_t struct_size;
+  // Optional. Runs the tasks of the platform thread, which are otherwise left
+  // in a message loop of the thread calling |FlutterEngineRun| that the
+  // embedder has no way to run.
+  const FlutterTaskRunnerDescription* platform_task_runner;
+  // Optional. Runs the rendering tasks, which otherwise run on a thread of the
+  // engine. The renderer config callbacks are then called on this thread.
+  const FlutterTaskRunnerDescription* render_task_runner;
+} FlutterCustomTaskRunners;
+
+typedef void (*FrameTimingsCallback)(const FlutterFrameTiming* /* timings */,
+                                     size_t /* timings count */,
+                                     void* /* user data */);
+
 typedef struct {
   // The size of this struct. Must be sizeof(FlutterProjectArgs).
   size_t struct_size;
@@ -65,8 +229,54 @@ typedef struct {
   // after the call to |FlutterEngineRun| returns. The string must be NULL
   // terminated.
   const char* packages_path;
+  // Optional. Invoked on the platform thread with batches of timing records of
+  // frames that have been presented. The records are only valid for the
+  // duration of the call.
+  FrameTimingsCallback frame_timings_callback;
+  // Optional. The threads are shared by all engines in the process, so only
+  // the first engine that is run may supply custom task runners.
+  const FlutterCustomTaskRunners* custom_task_runners;
+  // Optional. Called on an engine thread when the engine wants to begin a
+  // frame at the next vsync. The embedder must hand the baton to
+  // |FlutterEngineOnVsync| at that vsync. Without it, frames are paced by a
+  // timer that is not in phase with the display. Headless embedders may hand
+  // the baton back right away to render frames back to back.
+  VsyncCallback vsync_callback;
+  // Optional. Called on the rendering thread as soon as each frame has been
+  // presented, with its timing record. Unlike |frame_timings_callback|, the
+  // records are not batched. The record is only valid for the duration of the
+  // call.
+  FramePresentedCallback frame_presented_callback;
+  // Optional. Invoked on the platform thread with the statistics of the frames
+  // presented in each |frame_statistics_interval|. Neither tracing nor the
+  // performance overlay need to be enabled. The statistics are only valid for
+  // the duration of the call.
+  FrameStatisticsCallback frame_statistics_callback;
+  // The interval in milliseconds over which frame statistics are aggregated.
+  // Zero defaults to ten seconds.
+  int64_t frame_statistics_interval;
 } FlutterProjectArgs;
 
+typedef struct {
+  int64_t start;
+  int64_t end;
+} FlutterStartupPhase;
+
+typedef struct {
+  // The size of this struct. Must be sizeof(FlutterStartupTimeline).
+  size_t struct_size;
+  // Timestamps in microseconds on the Dart timeline clock. Phases that have
+  // not run yet are zero.
+  int64_t engine_main_enter;
+  FlutterStartupPhase dart_vm_init;
+  FlutterStartupPhase snapshot_load;
+  FlutterStartupPhase root_isolate_creation;
+  FlutterStartupPhase main_invocation;
+  FlutterStartupPhase first_begin_frame;
+  FlutterStartupPhase first_render;
+  FlutterStartupPhase first_present;
+} FlutterStartupTimeline;
+
 typedef struct {
   // The size of this struct. Must be sizeof(FlutterWindowMetricsEvent).
   size_t struct_size;
@@ -94,12 +304,46 @@ typedef struct {
   double y;
 } FlutterPointerEvent;
 
+typedef enum {
+  // Drop caches that are cheap to rebuild.
+  kFlutterMemoryPressureModerate,
+  // Drop everything that can be rebuilt.
+  kFlutterMemoryPressureCritical,
+} FlutterMemoryPressureLevel;
+
+// The header of a single producer, single consumer ring of pointer events
+// that the host may place in memory shared with the engine, for example to
+// deliver input from another process. The header is followed by |capacity|
+// slots of |slot_size| bytes each. Each slot holds a FlutterPointerEvent.
+//
+// The host writes the event for count |write_count| into slot
+// |write_count % capacity| and then increments |write_count| with release
+// semantics. It must not write while |write_count - read_count| equals
+// |capacity|. The engine drains the ring once per frame and increments
+// |read_count| with release semantics.
+typedef struct {
+  uint64_t write_count;
+  uint64_t read_count;
+  uint64_t capacity;
+  uint64_t slot_size;
+} FlutterPointerEventRing;
+
+typedef void (*PlatformMessageReleaseCallback)(const uint8_t* /* message */,
+                                               size_t /* message size */,
+                                               void* /* user data */);
+
 typedef struct {
   // The size of this struct. Must be sizeof(FlutterPlatformMessage).
   size_t struct_size;
   const char* channel;
   const uint8_t* message;
   const size_t message_size;
+  // Optional. When set and the message is accepted, the engine takes
+  // ownership of |message| instead of copying it and invokes the callback on
+  // an arbitrary thread once it no longer needs the buffer. The engine may
+  // write to the buffer.
+  PlatformMessageReleaseCallback release_callback;
+  void* release_user_data;
 } FlutterPlatformMessage;
 
 FLUTTER_EXPORT
@@ -122,11 +366,99 @@ FlutterResult FlutterEngineSendPointerEvent(FlutterEngine engine,
                                             const FlutterPointerEvent* events,
                                             size_t events_count);
 
+// Makes the engine drain |ring| at the start of every frame. The ring must stay
+// valid until the engine is shut down. Only one ring may be set per engine.
+FLUTTER_EXPORT
+FlutterResult FlutterEngineSetPointerEventRing(FlutterEngine engine,
+                                               FlutterPointerEventRing* ring);
+
+// Tells the engine that the ring has new events. The engine schedules a frame
+// to drain them. Calls made before that frame begins are coalesced, so the
+// host may call this after every write.
+FLUTTER_EXPORT
+FlutterResult FlutterEngineNotifyPointerEventRing(FlutterEngine engine);
+
+// Makes the engine give back cached GPU resources, rasterized pictures,
+// decoded images and, under critical pressure, font caches.
+FLUTTER_EXPORT
+FlutterResult FlutterEngineNotifyMemoryPressure(
+    FlutterEngine engine,
+    FlutterMemoryPressureLevel level);
+
+// Makes frames begin only on every |divisor| vsyncs, capping the frame rate to
+// a fraction of the display rate, such as while the host saves battery. A
+// divisor of one lets frames begin on every vsync.
+FLUTTER_EXPORT
+FlutterResult FlutterEngineSetFrameRateDivisor(FlutterEngine engine,
+                                               uint32_t divisor);
+
 FLUTTER_EXPORT
 FlutterResult FlutterEngineSendPlatformMessage(
     FlutterEngine engine,
     const FlutterPlatformMessage* message);
 
+// Makes the texture with |texture_identifier| available to the Dart side,
+// which passes the identifier to |SceneBuilder.addTexture|. Requires the
+// |gl_external_texture_frame_callback| of the renderer config.
+FLUTTER_EXPORT
+FlutterResult FlutterEngineRegisterExternalTexture(FlutterEngine engine,
+                                                   int64_t texture_identifier);
+
+FLUTTER_EXPORT
+FlutterResult FlutterEngineUnregisterExternalTexture(
+    FlutterEngine engine,
+    int64_t texture_identifier);
+
+// Tells the engine that the texture has a new frame. The engine asks for it
+// the next time the texture is composited.
+FLUTTER_EXPORT
+FlutterResult FlutterEngineMarkExternalTextureFrameAvailable(
+    FlutterEngine engine,
+    int64_t texture_identifier);
+
+// Fills |timeline| with the startup phases of the process recorded so far.
+// Callable on any thread.
+FLUTTER_EXPORT
+FlutterResult FlutterEngineGetStartupTimeline(
+    FlutterEngine engine,
+    FlutterStartupTimeline* timeline);
+
+// Signals the vsync requested with |baton| through the |vsync_callback| of the
+// project args. Frames begun for it are due at |frame_target_time_nanos|,
+// which is usually |frame_start_time_nanos| plus the refresh interval. Both
+// are on the clock of |FlutterEngineGetCurrentTime|. Callable on any thread.
+FLUTTER_EXPORT
+FlutterResult FlutterEngineOnVsync(FlutterEngine engine,
+                                   intptr_t baton,
+                                   uint64_t frame_start_time_nanos,
+                                   uint64_t frame_target_time_nanos);
+
+// Rasterizes the most recently presented frame in software into
+// |backing_store|, which must hold |width| by |height| N32 premultiplied
+// pixels, scaling the frame to fill it. The backing store callbacks are not
+// invoked. This works with any renderer, which makes it suitable for
+// generating thumbnails and previews headlessly: size the window with
+// |FlutterEngineSendWindowMetricsEvent|, wait for |frame_presented_callback|
+// and rasterize the frame into as many buffers as needed. Blocks until the
+// pixels are written. External textures are not drawn.
+FLUTTER_EXPORT
+FlutterResult FlutterEngineRasterizeLastFrame(
+    FlutterEngine engine,
+    size_t width,
+    size_t height,
+    const FlutterSoftwareBackingStore* backing_store);
+
+// Returns the current time in nanoseconds on the clock of the target times of
+// posted tasks and of vsyncs.
+FLUTTER_EXPORT
+uint64_t FlutterEngineGetCurrentTime();
+
+// Runs a task posted to a custom task runner. Must be called on the thread of
+// that runner. Each task may only be run once.
+FLUTTER_EXPORT
+FlutterResult FlutterEngineRunTask(FlutterEngine engine,
+                                   const FlutterTask* task);
+
 #if defined(__cplusplus)
 }  // extern "C"
 #endif
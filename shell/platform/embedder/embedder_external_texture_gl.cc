@@ -0,0 +1,56 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/embedder/embedder_external_texture_gl.h"
+
+#include "flutter/glue/trace_event.h"
+
+namespace shell {
+
+EmbedderExternalTextureGL::EmbedderExternalTextureGL(
+    int64_t texture_identifier,
+    ExternalTextureCallback callback)
+    : Texture(texture_identifier),
+      external_texture_callback_(std::move(callback)),
+      new_frame_ready_(true) {
+  FXL_DCHECK(external_texture_callback_);
+}
+
+EmbedderExternalTextureGL::~EmbedderExternalTextureGL() = default;
+
+void EmbedderExternalTextureGL::Paint(SkCanvas& canvas, const SkRect& bounds) {
+  GrContext* context = canvas.getGrContext();
+  if (context == nullptr) {
+    return;
+  }
+
+  if (new_frame_ready_) {
+    TRACE_EVENT0("flutter", "EmbedderExternalTextureGL::AcquireFrame");
+    new_frame_ready_ = false;
+    sk_sp<SkImage> image = external_texture_callback_(
+        Id(), context,
+        SkISize::Make(bounds.width(), bounds.height()));
+    if (image) {
+      last_image_ = std::move(image);
+    }
+  }
+
+  if (last_image_) {
+    canvas.drawImageRect(last_image_, bounds, nullptr);
+  }
+}
+
+void EmbedderExternalTextureGL::OnGrContextCreated() {
+  new_frame_ready_ = true;
+}
+
+void EmbedderExternalTextureGL::OnGrContextDestroyed() {
+  last_image_ = nullptr;
+}
+
+void EmbedderExternalTextureGL::MarkNewFrameAvailable() {
+  new_frame_ready_ = true;
+}
+
+}  // namespace shell
@@ -0,0 +1,51 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_EXTERNAL_TEXTURE_GL_H_
+#define FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_EXTERNAL_TEXTURE_GL_H_
+
+#include <functional>
+
+#include "flutter/flow/texture.h"
+#include "lib/fxl/macros.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkSize.h"
+
+namespace shell {
+
+// Composites GL textures owned by the embedder. The embedder is asked for a
+// texture whenever a new frame has been marked available.
+class EmbedderExternalTextureGL : public flow::Texture {
+ public:
+  using ExternalTextureCallback = std::function<
+      sk_sp<SkImage>(int64_t texture_identifier, GrContext*, const SkISize&)>;
+
+  EmbedderExternalTextureGL(int64_t texture_identifier,
+                            ExternalTextureCallback callback);
+
+  ~EmbedderExternalTextureGL() override;
+
+  // |flow::Texture|
+  void Paint(SkCanvas& canvas, const SkRect& bounds) override;
+
+  // |flow::Texture|
+  void OnGrContextCreated() override;
+
+  // |flow::Texture|
+  void OnGrContextDestroyed() override;
+
+  // |flow::Texture|
+  void MarkNewFrameAvailable() override;
+
+ private:
+  ExternalTextureCallback external_texture_callback_;
+  sk_sp<SkImage> last_image_;
+  bool new_frame_ready_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(EmbedderExternalTextureGL);
+};
+
+}  // namespace shell
+
+#endif  // FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_EXTERNAL_TEXTURE_GL_H_
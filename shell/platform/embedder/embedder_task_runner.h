@@ -0,0 +1,64 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_TASK_RUNNER_H_
+#define FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_TASK_RUNNER_H_
+
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+#include "lib/fxl/macros.h"
+#include "lib/fxl/tasks/task_runner.h"
+
+namespace shell {
+
+// A task runner whose tasks are scheduled by the embedder. Posted tasks are
+// kept by the runner and identified to the embedder by a baton, which the
+// embedder hands back to |RunTask| on its thread once the task is due.
+class EmbedderTaskRunner : public fxl::TaskRunner {
+ public:
+  struct DispatchTable {
+    // Called on any thread.
+    std::function<void(EmbedderTaskRunner* runner,
+                        uint64_t task_baton,
+                        fxl::TimePoint target_time)>
+        post_task_callback;
+    std::function<bool(void)> runs_task_on_current_thread_callback;
+  };
+
+  // |fxl::TaskRunner|
+  void PostTask(fxl::Closure task) override;
+
+  // |fxl::TaskRunner|
+  void PostTaskForTime(fxl::Closure task, fxl::TimePoint target_time) override;
+
+  // |fxl::TaskRunner|
+  void PostDelayedTask(fxl::Closure task, fxl::TimeDelta delay) override;
+
+  // |fxl::TaskRunner|
+  bool RunsTasksOnCurrentThread() override;
+
+  // Runs the task posted with |task_baton|. Returns false if there is no such
+  // task, for example because it already ran.
+  bool RunTask(uint64_t task_baton);
+
+ private:
+  const DispatchTable dispatch_table_;
+  std::mutex tasks_mutex_;
+  uint64_t last_baton_;
+  std::unordered_map<uint64_t, fxl::Closure> pending_tasks_;
+
+  explicit EmbedderTaskRunner(DispatchTable dispatch_table);
+
+  ~EmbedderTaskRunner();
+
+  FRIEND_MAKE_REF_COUNTED(EmbedderTaskRunner);
+  FRIEND_REF_COUNTED_THREAD_SAFE(EmbedderTaskRunner);
+  FXL_DISALLOW_COPY_AND_ASSIGN(EmbedderTaskRunner);
+};
+
+}  // namespace shell
+
+#endif  // FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_TASK_RUNNER_H_
@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 #include "flutter/shell/platform/embedder/platform_view_embedder.h"
+#include "flutter/common/threads.h"
 #include "flutter/shell/gpu/gpu_rasterizer.h"
 
 namespace shell {
@@ -31,14 +32,66 @@ intptr_t PlatformViewEmbedder::GLContextFBO() const {
   return dispatch_table_.gl_fbo_callback();
 }
 
+sk_sp<SkSurface> PlatformViewEmbedder::AcquireBackingStore(
+    const SkISize& size) {
+  SoftwareBackingStore backing_store;
+  if (!dispatch_table_.software_acquire_callback(size, &backing_store) ||
+      backing_store.allocation == nullptr) {
+    return nullptr;
+  }
+
+  const SkImageInfo info =
+      SkImageInfo::MakeN32Premul(size.width(), size.height());
+  if (backing_store.row_bytes < info.minRowBytes()) {
+    FXL_DLOG(ERROR) << "The software backing store rows are too short.";
+    return nullptr;
+  }
+
+  software_backing_store_ = backing_store;
+  return SkSurface::MakeRasterDirect(info, backing_store.allocation,
+                                     backing_store.row_bytes);
+}
+
+bool PlatformViewEmbedder::PresentBackingStore(
+    sk_sp<SkSurface> backing_store) {
+  return dispatch_table_.software_present_callback(software_backing_store_);
+}
+
+bool PlatformViewEmbedder::RegisterExternalTexture(int64_t texture_identifier) {
+  if (!dispatch_table_.external_texture_callback) {
+    return false;
+  }
+  RegisterTexture(std::make_shared<EmbedderExternalTextureGL>(
+      texture_identifier, dispatch_table_.external_texture_callback));
+  return true;
+}
+
 bool PlatformViewEmbedder::SurfaceSupportsSRGB() const {
   return true;
 }
 
+bool PlatformViewEmbedder::GLContextIsThreadExclusive() const {
+  return dispatch_table_.gl_context_is_thread_exclusive;
+}
+
 void PlatformViewEmbedder::Attach() {
   CreateEngine();
   PostAddToShellTask();
-  NotifyCreated(std::make_unique<shell::GPUSurfaceGL>(this));
+  if (dispatch_table_.frame_presented_callback) {
+    blink::Threads::Gpu()->PostTask([
+      rasterizer = rasterizer_->GetWeakRasterizerPtr(),
+      callback = dispatch_table_.frame_presented_callback
+    ]() {
+      if (rasterizer) {
+        rasterizer->SetFramePresentedCallback(callback);
+      }
+    });
+  }
+  if (dispatch_table_.software_acquire_callback) {
+    NotifyCreated(std::make_unique<shell::GPUSurfaceSoftware>(this));
+  } else {
+    NotifyCreated(std::make_unique<shell::GPUSurfaceGL>(this));
+  }
 }
 
 bool PlatformViewEmbedder::ResourceContextMakeCurrent() {
@@ -46,6 +99,38 @@ bool PlatformViewEmbedder::ResourceContextMakeCurrent() {
   return false;
 }
 
+VsyncWaiter* PlatformViewEmbedder::GetVsyncWaiter() {
+  if (!dispatch_table_.vsync_callback) {
+    return PlatformView::GetVsyncWaiter();
+  }
+  if (!vsync_waiter_) {
+    vsync_waiter_ =
+        std::make_unique<VsyncWaiterEmbedder>(dispatch_table_.vsync_callback);
+  }
+  return vsync_waiter_.get();
+}
+
+void PlatformViewEmbedder::ReportFrameTimings(
+    std::vector<flow::FrameTiming> timings) {
+  if (dispatch_table_.frame_timings_callback) {
+    dispatch_table_.frame_timings_callback(timings);
+  }
+}
+
+fxl::TimeDelta PlatformViewEmbedder::GetFrameStatisticsInterval() {
+  if (!dispatch_table_.frame_statistics_callback) {
+    return fxl::TimeDelta::Zero();
+  }
+  return dispatch_table_.frame_statistics_interval;
+}
+
+void PlatformViewEmbedder::ReportFrameStatistics(
+    const flow::FrameStatistics& statistics) {
+  if (dispatch_table_.frame_statistics_callback) {
+    dispatch_table_.frame_statistics_callback(statistics);
+  }
+}
+
 void PlatformViewEmbedder::RunFromSource(const std::string& assets_directory,
                                          const std::string& main,
                                          const std::string& packages) {
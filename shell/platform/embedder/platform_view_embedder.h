@@ -7,17 +7,44 @@
 
 #include "flutter/shell/common/platform_view.h"
 #include "flutter/shell/gpu/gpu_surface_gl.h"
+#include "flutter/shell/gpu/gpu_surface_software.h"
+#include "flutter/shell/platform/embedder/embedder_external_texture_gl.h"
+#include "flutter/shell/platform/embedder/vsync_waiter_embedder.h"
 #include "lib/fxl/macros.h"
 
 namespace shell {
 
-class PlatformViewEmbedder : public PlatformView, public GPUSurfaceGLDelegate {
+class PlatformViewEmbedder : public PlatformView,
+                             public GPUSurfaceGLDelegate,
+                             public GPUSurfaceSoftwareDelegate {
  public:
+  // Memory of the embedder that frames are rendered into directly.
+  struct SoftwareBackingStore {
+    void* allocation = nullptr;
+    size_t row_bytes = 0;
+    void* user_data = nullptr;
+  };
+
   struct DispatchTable {
     std::function<bool(void)> gl_make_current_callback;
     std::function<bool(void)> gl_clear_current_callback;
     std::function<bool(void)> gl_present_callback;
     std::function<intptr_t(void)> gl_fbo_callback;
+    bool gl_context_is_thread_exclusive = false;
+    // Frames are rendered in software when these are set instead of the GL
+    // callbacks.
+    std::function<bool(const SkISize&, SoftwareBackingStore*)>
+        software_acquire_callback;
+    std::function<bool(const SoftwareBackingStore&)> software_present_callback;
+    std::function<void(const std::vector<flow::FrameTiming>&)>
+        frame_timings_callback;  // optional
+    EmbedderExternalTextureGL::ExternalTextureCallback
+        external_texture_callback;  // optional
+    VsyncWaiterEmbedder::VsyncCallback vsync_callback;  // optional
+    Rasterizer::FramePresentedCallback frame_presented_callback;  // optional
+    std::function<void(const flow::FrameStatistics&)>
+        frame_statistics_callback;  // optional
+    fxl::TimeDelta frame_statistics_interval;
   };
 
   PlatformViewEmbedder(DispatchTable dispatch_table);
@@ -39,12 +66,36 @@ class PlatformViewEmbedder : public PlatformView, public GPUSurfaceGLDelegate {
   // |shell::GPUSurfaceGLDelegate|
   bool SurfaceSupportsSRGB() const override;
 
+  // |shell::GPUSurfaceGLDelegate|
+  bool GLContextIsThreadExclusive() const override;
+
+  // |shell::GPUSurfaceSoftwareDelegate|
+  sk_sp<SkSurface> AcquireBackingStore(const SkISize& size) override;
+
+  // |shell::GPUSurfaceSoftwareDelegate|
+  bool PresentBackingStore(sk_sp<SkSurface> backing_store) override;
+
   // |shell::PlatformView|
   void Attach() override;
 
   // |shell::PlatformView|
   bool ResourceContextMakeCurrent() override;
 
+  // |shell::PlatformView|
+  VsyncWaiter* GetVsyncWaiter() override;
+
+  // |shell::PlatformView|
+  void ReportFrameTimings(std::vector<flow::FrameTiming> timings) override;
+
+  // |shell::PlatformView|
+  fxl::TimeDelta GetFrameStatisticsInterval() override;
+
+  // |shell::PlatformView|
+  void ReportFrameStatistics(const flow::FrameStatistics& statistics) override;
+
+  // Returns false if the embedder did not supply a texture callback.
+  bool RegisterExternalTexture(int64_t texture_identifier);
+
   // |shell::PlatformView|
   void RunFromSource(const std::string& assets_directory,
                      const std::string& main,
@@ -52,6 +103,8 @@ class PlatformViewEmbedder : public PlatformView, public GPUSurfaceGLDelegate {
 
  private:
   DispatchTable dispatch_table_;
+  // The backing store of the software frame being rendered. GPU thread only.
+  SoftwareBackingStore software_backing_store_;
 
   FXL_DISALLOW_COPY_AND_ASSIGN(PlatformViewEmbedder);
 };
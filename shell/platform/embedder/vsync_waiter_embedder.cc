@@ -0,0 +1,54 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/embedder/vsync_waiter_embedder.h"
+
+#include <utility>
+
+#include "flutter/common/threads.h"
+#include "flutter/fml/task_priority.h"
+#include "flutter/fml/trace_event.h"
+#include "lib/fxl/logging.h"
+
+namespace shell {
+
+VsyncWaiterEmbedder::VsyncWaiterEmbedder(VsyncCallback vsync_callback)
+    : vsync_callback_(std::move(vsync_callback)), weak_factory_(this) {
+  FXL_DCHECK(vsync_callback_);
+}
+
+VsyncWaiterEmbedder::~VsyncWaiterEmbedder() = default;
+
+void VsyncWaiterEmbedder::AsyncWaitForVsync(Callback callback) {
+  FXL_DCHECK(!callback_);
+  callback_ = std::move(callback);
+
+  // Deleted when the embedder hands the baton back.
+  auto* weak = new fxl::WeakPtr<VsyncWaiterEmbedder>();
+  *weak = weak_factory_.GetWeakPtr();
+  vsync_callback_(reinterpret_cast<intptr_t>(weak));
+}
+
+void VsyncWaiterEmbedder::OnEmbedderVsync(intptr_t baton,
+                                          fxl::TimePoint frame_start_time,
+                                          fxl::TimePoint frame_target_time) {
+  TRACE_EVENT1("flutter", "VSYNC", "mode", "basic");
+  auto* weak = reinterpret_cast<fxl::WeakPtr<VsyncWaiterEmbedder>*>(baton);
+
+  // The waiter is only dereferenced on the UI thread, where it is destroyed.
+  fml::ScopedTaskPriority priority(fml::TaskPriority::kFrameCritical);
+  blink::Threads::UI()->PostTask(
+      [weak, frame_start_time, frame_target_time]() {
+        VsyncWaiterEmbedder* waiter = weak->get();
+        delete weak;
+        if (!waiter || !waiter->callback_) {
+          return;
+        }
+        Callback callback = std::move(waiter->callback_);
+        waiter->callback_ = Callback();
+        callback(frame_start_time, frame_target_time);
+      });
+}
+
+}  // namespace shell
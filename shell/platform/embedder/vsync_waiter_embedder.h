@@ -0,0 +1,47 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_EMBEDDER_VSYNC_WAITER_EMBEDDER_H_
+#define FLUTTER_SHELL_PLATFORM_EMBEDDER_VSYNC_WAITER_EMBEDDER_H_
+
+#include <functional>
+
+#include "flutter/shell/common/vsync_waiter.h"
+#include "lib/fxl/macros.h"
+#include "lib/fxl/memory/weak_ptr.h"
+
+namespace shell {
+
+// Waits for vsyncs signalled by the embedder, so that frames are in phase
+// with the compositor of the host instead of a free-running timer.
+class VsyncWaiterEmbedder : public VsyncWaiter {
+ public:
+  // Asks the embedder for the next vsync, which it signals by handing the
+  // baton to |OnEmbedderVsync|. Called on the UI thread.
+  using VsyncCallback = std::function<void(intptr_t baton)>;
+
+  explicit VsyncWaiterEmbedder(VsyncCallback vsync_callback);
+
+  ~VsyncWaiterEmbedder() override;
+
+  // |shell::VsyncWaiter|
+  void AsyncWaitForVsync(Callback callback) override;
+
+  // Can be called on any thread. Each baton may only be handed back once.
+  static void OnEmbedderVsync(intptr_t baton,
+                              fxl::TimePoint frame_start_time,
+                              fxl::TimePoint frame_target_time);
+
+ private:
+  const VsyncCallback vsync_callback_;
+  Callback callback_;
+
+  fxl::WeakPtrFactory<VsyncWaiterEmbedder> weak_factory_;
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(VsyncWaiterEmbedder);
+};
+
+}  // namespace shell
+
+#endif  // FLUTTER_SHELL_PLATFORM_EMBEDDER_VSYNC_WAITER_EMBEDDER_H_
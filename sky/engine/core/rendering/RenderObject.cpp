@@ -100,6 +100,8 @@ DEFINE_DEBUG_ONLY_GLOBAL(WTF::RefCountedLeakCounter,
                          ("RenderObject"));
 unsigned RenderObject::s_instanceCount = 0;
 
+unsigned RenderObject::s_treeTeardownDepth = 0;
+
 RenderObject::RenderObject()
     : m_style(nullptr),
       m_parent(nullptr),
@@ -241,6 +241,15 @@ class RenderObject {
 
   static unsigned instanceCount() { return s_instanceCount; }
 
+  // While in scope, the render trees that are destroyed go away as a whole,
+  // so their nodes skip dirtying their parents and unlinking their line boxes
+  // one by one. Only used on the main thread.
+  class TreeTeardownScope {
+   public:
+    TreeTeardownScope() { ++s_treeTeardownDepth; }
+    ~TreeTeardownScope() { --s_treeTeardownDepth; }
+  };
+
 #if !ENABLE(OILPAN)
   // RenderObjects are allocated out of the rendering partition.
   void* operator new(size_t);
@@ -918,6 +927,8 @@ class RenderObject {
   static bool s_affectsParentBlock;
 
   static unsigned s_instanceCount;
+
+  static unsigned s_treeTeardownDepth;
 };
 
 // Allow equality comparisons of RenderObjects by reference or pointer,
@@ -925,7 +936,7 @@ class RenderObject {
 DEFINE_COMPARISON_OPERATORS_WITH_REFERENCES(RenderObject)
 
 inline bool RenderObject::documentBeingDestroyed() const {
-  return false;
+  return s_treeTeardownDepth > 0;
 }
 
 // setNeedsLayout() won't cause full paint invalidations as
@@ -38,6 +38,7 @@
 #include "flutter/sky/engine/platform/fonts/FontPlatformData.h"
 #include "flutter/sky/engine/platform/fonts/FontSmoothingMode.h"
 #include "flutter/sky/engine/platform/fonts/TextRenderingMode.h"
+#include "flutter/sky/engine/platform/fonts/harfbuzz/HarfBuzzShaper.h"
 #include "flutter/sky/engine/platform/fonts/opentype/OpenTypeVerticalData.h"
 #include "flutter/sky/engine/wtf/HashMap.h"
 #include "flutter/sky/engine/wtf/ListHashSet.h"
@@ -252,6 +253,16 @@ void FontCache::purge(PurgeSeverity PurgeSeverity) {
   purgeFontVerticalDataCache();
 }
 
+void FontCache::purgeForMemoryPressure(bool critical) {
+  if (m_purgePreventCount)
+    return;
+
+  if (critical)
+    HarfBuzzShaper::clearShapingCache();
+
+  purge(ForcePurge);
+}
+
 static bool invalidateFontCache = false;
 
 HashSet<RawPtr<FontCacheClient>>& fontCacheClients() {
@@ -98,6 +98,11 @@ class PLATFORM_EXPORT FontCache {
   unsigned short generation();
   void invalidate();
 
+  // Drops the fonts that no text is using, along with their glyph pages. When
+  // |critical|, the cached shaping results, which keep their fonts in use,
+  // are dropped first. Does nothing while purging is prevented.
+  void purgeForMemoryPressure(bool critical);
+
 #if ENABLE(OPENTYPE_VERTICAL)
   typedef uint32_t FontFileKey;
   PassRefPtr<OpenTypeVerticalData> getVerticalData(const FontFileKey&,
@@ -74,11 +74,15 @@ class HarfBuzzScopedPtr {
   DestroyFunction m_destroy;
 };
 
-static const unsigned cHarfBuzzCacheMaxSize = 256;
+// Runs are cached by their text. The same text may be cached once for each
+// font, direction and locale it is shaped with, so that labels that repeat
+// the same words in different styles don't evict each other.
+static const unsigned cHarfBuzzCacheMaxSize = 2048;
 
 struct CachedShapingResultsLRUNode;
 struct CachedShapingResults;
-typedef std::map<std::wstring, CachedShapingResults*> CachedShapingResultsMap;
+typedef std::multimap<std::wstring, CachedShapingResults*>
+    CachedShapingResultsMap;
 typedef std::list<CachedShapingResultsLRUNode*> CachedShapingResultsLRU;
 
 struct CachedShapingResults {
@@ -88,6 +92,12 @@ struct CachedShapingResults {
                        const String& newLocale);
   ~CachedShapingResults();
 
+  bool matches(const Font& runFont,
+               hb_direction_t runDir,
+               const String& runLocale) const {
+    return dir == runDir && font == runFont && locale == runLocale;
+  }
+
   hb_buffer_t* buffer;
   Font font;
   hb_direction_t dir;
@@ -127,10 +137,14 @@ class HarfBuzzRunCache {
   HarfBuzzRunCache();
   ~HarfBuzzRunCache();
 
-  CachedShapingResults* find(const std::wstring& key) const;
+  CachedShapingResults* find(const std::wstring& key,
+                             const Font& font,
+                             hb_direction_t dir,
+                             const String& locale) const;
   void remove(CachedShapingResults* node);
   void moveToBack(CachedShapingResults* node);
-  bool insert(const std::wstring& key, CachedShapingResults* run);
+  void insert(const std::wstring& key, CachedShapingResults* run);
+  void clear();
 
  private:
   CachedShapingResultsMap m_harfBuzzRunMap;
@@ -140,24 +154,26 @@ class HarfBuzzRunCache {
 HarfBuzzRunCache::HarfBuzzRunCache() {}
 
 HarfBuzzRunCache::~HarfBuzzRunCache() {
+  clear();
+}
+
+void HarfBuzzRunCache::clear() {
   for (CachedShapingResultsMap::iterator it = m_harfBuzzRunMap.begin();
        it != m_harfBuzzRunMap.end(); ++it)
     delete it->second;
   for (CachedShapingResultsLRU::iterator it = m_harfBuzzRunLRU.begin();
        it != m_harfBuzzRunLRU.end(); ++it)
     delete *it;
+  m_harfBuzzRunMap.clear();
+  m_harfBuzzRunLRU.clear();
 }
 
-bool HarfBuzzRunCache::insert(const std::wstring& key,
+void HarfBuzzRunCache::insert(const std::wstring& key,
                               CachedShapingResults* data) {
-  std::pair<CachedShapingResultsMap::iterator, bool> results =
+  CachedShapingResultsMap::iterator entry =
       m_harfBuzzRunMap.insert(CachedShapingResultsMap::value_type(key, data));
 
-  if (!results.second)
-    return false;
-
-  CachedShapingResultsLRUNode* node =
-      new CachedShapingResultsLRUNode(results.first);
+  CachedShapingResultsLRUNode* node = new CachedShapingResultsLRUNode(entry);
 
   m_harfBuzzRunLRU.push_back(node);
   data->lru = --m_harfBuzzRunLRU.end();
@@ -170,15 +186,22 @@ bool HarfBuzzRunCache::insert(const std::wstring& key,
     delete foo;
     delete lru;
   }
-
-  return true;
 }
 
 inline CachedShapingResults* HarfBuzzRunCache::find(
-    const std::wstring& key) const {
-  CachedShapingResultsMap::const_iterator it = m_harfBuzzRunMap.find(key);
-
-  return it != m_harfBuzzRunMap.end() ? it->second : 0;
+    const std::wstring& key,
+    const Font& font,
+    hb_direction_t dir,
+    const String& locale) const {
+  std::pair<CachedShapingResultsMap::const_iterator,
+            CachedShapingResultsMap::const_iterator>
+      range = m_harfBuzzRunMap.equal_range(key);
+  for (CachedShapingResultsMap::const_iterator it = range.first;
+       it != range.second; ++it) {
+    if (it->second->matches(font, dir, locale))
+      return it->second;
+  }
+  return 0;
 }
 
 inline void HarfBuzzRunCache::remove(CachedShapingResults* node) {
@@ -202,6 +225,10 @@ HarfBuzzRunCache& harfBuzzRunCache() {
   return globalHarfBuzzRunCache;
 }
 
+void HarfBuzzShaper::clearShapingCache() {
+  harfBuzzRunCache().clear();
+}
+
 static inline float harfBuzzPositionToFloat(hb_position_t value) {
   return static_cast<float>(value) / (1 << 16);
 }
@@ -857,33 +884,24 @@ bool HarfBuzzShaper::shapeHarfBuzzRuns() {
     if (!face)
       return false;
 
-    hb_buffer_set_language(
-        harfBuzzBuffer.get(),
-        hb_language_from_string(locale.data(), locale.length()));
-    hb_buffer_set_script(harfBuzzBuffer.get(), currentRun->script());
-    hb_buffer_set_direction(harfBuzzBuffer.get(), currentRun->direction());
-
     const UChar* src = m_normalizedBuffer.get() + currentRun->startIndex();
     std::wstring key(src, src + currentRun->numCharacters());
 
-    CachedShapingResults* cachedResults = runCache.find(key);
+    CachedShapingResults* cachedResults =
+        runCache.find(key, *m_font, currentRun->direction(), localeString);
     if (cachedResults) {
-      if (cachedResults->dir == currentRun->direction() &&
-          cachedResults->font == *m_font &&
-          cachedResults->locale == localeString) {
-        currentRun->applyShapeResult(cachedResults->buffer);
-        setGlyphPositionsForHarfBuzzRun(currentRun, cachedResults->buffer);
-
-        hb_buffer_clear_contents(harfBuzzBuffer.get());
-
-        runCache.moveToBack(cachedResults);
-
-        continue;
-      }
-
-      runCache.remove(cachedResults);
+      currentRun->applyShapeResult(cachedResults->buffer);
+      setGlyphPositionsForHarfBuzzRun(currentRun, cachedResults->buffer);
+      runCache.moveToBack(cachedResults);
+      continue;
     }
 
+    hb_buffer_set_language(
+        harfBuzzBuffer.get(),
+        hb_language_from_string(locale.data(), locale.length()));
+    hb_buffer_set_script(harfBuzzBuffer.get(), currentRun->script());
+    hb_buffer_set_direction(harfBuzzBuffer.get(), currentRun->direction());
+
     // Add a space as pre-context to the buffer. This prevents showing
     // dotted-circle for combining marks at the beginning of runs.
     static const uint16_t preContext = ' ';
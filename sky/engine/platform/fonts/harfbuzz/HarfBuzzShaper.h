@@ -65,6 +65,9 @@ class HarfBuzzShaper final {
   FloatRect selectionRect(const FloatPoint&, int height, int from, int to);
   FloatBoxExtent glyphBoundingBox() const { return m_glyphBoundingBox; }
 
+  // Drops the shaping results that are cached across runs.
+  static void clearShapingCache();
+
  private:
   class HarfBuzzRun {
    public:
@@ -6,16 +6,15 @@
 #define SYNCHRONIZATION_PIPELINE_H_
 
 #include "flutter/glue/trace_event.h"
-#include "flutter/synchronization/pipeline.h"
-#include "flutter/synchronization/semaphore.h"
 #include "lib/fxl/functional/closure.h"
+#include "lib/fxl/logging.h"
 #include "lib/fxl/macros.h"
 #include "lib/fxl/memory/ref_counted.h"
-#include "lib/fxl/synchronization/mutex.h"
-#include "lib/fxl/synchronization/thread_annotations.h"
 
+#include <atomic>
+#include <functional>
 #include <memory>
-#include <queue>
+#include <vector>
 
 namespace flutter {
 
@@ -25,6 +24,14 @@ enum class PipelineConsumeResult {
   MoreAvailable,
 };
 
+/// A bounded queue of resources handed from a single producer thread to a
+/// single consumer thread. Slots are preallocated in a ring buffer and
+/// indices are exchanged using atomics, so neither producing nor consuming a
+/// resource takes a lock or allocates.
+///
+/// Continuations must be completed (or dropped) on the producer thread in the
+/// order in which they were produced. |Consume| must only be called on the
+/// consumer thread.
 template <class R>
 class Pipeline : public fxl::RefCountedThreadSafe<Pipeline<R>> {
  public:
@@ -35,126 +42,134 @@ class Pipeline : public fxl::RefCountedThreadSafe<Pipeline<R>> {
   /// preparing a completed pipeline resource.
   class ProducerContinuation {
    public:
-    ProducerContinuation() : trace_id_(0) {}
+    ProducerContinuation() : pipeline_(nullptr), sequence_(0) {}
 
     ProducerContinuation(ProducerContinuation&& other)
-        : continuation_(other.continuation_), trace_id_(other.trace_id_) {
-      other.continuation_ = nullptr;
-      other.trace_id_ = 0;
+        : pipeline_(other.pipeline_), sequence_(other.sequence_) {
+      other.pipeline_ = nullptr;
+      other.sequence_ = 0;
     }
 
     ProducerContinuation& operator=(ProducerContinuation&& other) {
-      std::swap(continuation_, other.continuation_);
-      std::swap(trace_id_, other.trace_id_);
+      std::swap(pipeline_, other.pipeline_);
+      std::swap(sequence_, other.sequence_);
       return *this;
     }
 
     ~ProducerContinuation() {
-      if (continuation_) {
-        continuation_(nullptr, trace_id_);
-        TRACE_EVENT_ASYNC_END0("flutter", "PipelineProduce", trace_id_);
+      if (pipeline_) {
+        pipeline_->ProducerCommit(nullptr, sequence_);
+        TRACE_EVENT_ASYNC_END0("flutter", "PipelineProduce", trace_id());
         // The continuation is being dropped on the floor. End the flow.
-        TRACE_FLOW_END("flutter", "PipelineItem", trace_id_);
+        TRACE_FLOW_END("flutter", "PipelineItem", trace_id());
       }
     }
 
     void Complete(ResourcePtr resource) {
-      if (continuation_) {
-        continuation_(std::move(resource), trace_id_);
-        continuation_ = nullptr;
-        TRACE_EVENT_ASYNC_END0("flutter", "PipelineProduce", trace_id_);
-        TRACE_FLOW_STEP("flutter", "PipelineItem", trace_id_);
+      if (pipeline_) {
+        pipeline_->ProducerCommit(std::move(resource), sequence_);
+        pipeline_ = nullptr;
+        TRACE_EVENT_ASYNC_END0("flutter", "PipelineProduce", trace_id());
+        TRACE_FLOW_STEP("flutter", "PipelineItem", trace_id());
       }
     }
 
-    operator bool() const { return continuation_ != nullptr; }
+    operator bool() const { return pipeline_ != nullptr; }
 
    private:
     friend class Pipeline;
-    using Continuation = std::function<void(ResourcePtr, size_t)>;
 
-    Continuation continuation_;
-    size_t trace_id_;
+    Pipeline* pipeline_;
+    size_t sequence_;
 
-    ProducerContinuation(Continuation continuation, size_t trace_id)
-        : continuation_(continuation), trace_id_(trace_id) {
-      TRACE_FLOW_BEGIN("flutter", "PipelineItem", trace_id_);
-      TRACE_EVENT_ASYNC_BEGIN0("flutter", "PipelineProduce", trace_id_);
+    ProducerContinuation(Pipeline* pipeline, size_t sequence)
+        : pipeline_(pipeline), sequence_(sequence) {
+      TRACE_FLOW_BEGIN("flutter", "PipelineItem", trace_id());
+      TRACE_EVENT_ASYNC_BEGIN0("flutter", "PipelineProduce", trace_id());
     }
 
+    size_t trace_id() const { return sequence_ + 1; }
+
     FXL_DISALLOW_COPY_AND_ASSIGN(ProducerContinuation);
   };
 
   explicit Pipeline(uint32_t depth)
-      : empty_(depth), available_(0), last_trace_id_(0) {}
+      : depth_(depth),
+        slots_(depth),
+        reserved_(0),
+        committed_(0),
+        consumed_(0) {}
 
   ~Pipeline() = default;
 
-  bool IsValid() const { return empty_.IsValid() && available_.IsValid(); }
+  bool IsValid() const { return depth_ > 0; }
+
+  /// The maximum number of resources that may be in flight at once.
+  uint32_t depth() const { return depth_; }
+
+  /// The number of completed resources waiting to be consumed.
+  size_t GetQueuedItemCount() const {
+    const size_t consumed = consumed_.load(std::memory_order_acquire);
+    const size_t committed = committed_.load(std::memory_order_acquire);
+    return committed > consumed ? committed - consumed : 0;
+  }
 
   ProducerContinuation Produce() {
-    if (!empty_.TryWait()) {
+    // Only the producer thread modifies |reserved_|. The consumer releases
+    // slots by advancing |consumed_|.
+    if (reserved_ - consumed_.load(std::memory_order_acquire) >= depth_) {
       return {};
     }
 
-    return ProducerContinuation{
-        std::bind(&Pipeline::ProducerCommit, this, std::placeholders::_1,
-                  std::placeholders::_2),  // continuation
-        ++last_trace_id_};                 // trace id
+    return ProducerContinuation{this, reserved_++};
   }
 
   using Consumer = std::function<void(ResourcePtr)>;
 
   FXL_WARN_UNUSED_RESULT
-  PipelineConsumeResult Consume(Consumer consumer) {
+  PipelineConsumeResult Consume(const Consumer& consumer) {
     if (consumer == nullptr) {
       return PipelineConsumeResult::NoneAvailable;
     }
 
-    if (!available_.TryWait()) {
+    const size_t sequence = consumed_.load(std::memory_order_relaxed);
+
+    if (committed_.load(std::memory_order_acquire) == sequence) {
       return PipelineConsumeResult::NoneAvailable;
     }
 
-    ResourcePtr resource;
-    size_t trace_id = 0;
-    size_t items_count = 0;
-
-    {
-      fxl::MutexLocker lock(&queue_mutex_);
-      std::tie(resource, trace_id) = std::move(queue_.front());
-      queue_.pop();
-      items_count = queue_.size();
-    }
+    ResourcePtr resource = std::move(slots_[sequence % depth_]);
 
     {
       TRACE_EVENT0("flutter", "PipelineConsume");
       consumer(std::move(resource));
     }
 
-    empty_.Signal();
+    // Hand the slot back to the producer.
+    consumed_.store(sequence + 1, std::memory_order_release);
 
-    TRACE_FLOW_END("flutter", "PipelineItem", trace_id);
+    TRACE_FLOW_END("flutter", "PipelineItem", sequence + 1);
 
-    return items_count > 0 ? PipelineConsumeResult::MoreAvailable
-                           : PipelineConsumeResult::Done;
+    return committed_.load(std::memory_order_acquire) > sequence + 1
+               ? PipelineConsumeResult::MoreAvailable
+               : PipelineConsumeResult::Done;
   }
 
  private:
-  Semaphore empty_;
-  Semaphore available_;
-  fxl::Mutex queue_mutex_;
-  std::queue<std::pair<ResourcePtr, size_t>> queue_
-      FXL_GUARDED_BY(queue_mutex_);
-  std::atomic_size_t last_trace_id_;
-
-  void ProducerCommit(ResourcePtr resource, size_t trace_id) {
-    {
-      fxl::MutexLocker lock(&queue_mutex_);
-      queue_.emplace(std::move(resource), trace_id);
-    }
-
-    // Ensure the queue mutex is not held as that would be a pessimization.
-    available_.Signal();
+  const uint32_t depth_;
+  std::vector<ResourcePtr> slots_;
+  // The number of slots handed out to the producer. Producer thread only.
+  size_t reserved_;
+  // The number of slots the producer has filled.
+  std::atomic_size_t committed_;
+  // The number of slots the consumer has drained.
+  std::atomic_size_t consumed_;
+
+  void ProducerCommit(ResourcePtr resource, size_t sequence) {
+    FXL_DCHECK(sequence == committed_.load(std::memory_order_relaxed))
+        << "Pipeline continuations must be completed in order.";
+    slots_[sequence % depth_] = std::move(resource);
+    committed_.store(sequence + 1, std::memory_order_release);
   }
 
   FXL_DISALLOW_COPY_AND_ASSIGN(Pipeline);
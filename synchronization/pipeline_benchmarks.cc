@@ -0,0 +1,92 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Benchmarks of handing resources through a pipeline, on one thread and from
+// a producer thread to a consumer on the message loop of another thread, as
+// the animator hands layer trees to the rasterizer.
+
+#include <memory>
+
+#include "flutter/fml/thread.h"
+#include "flutter/synchronization/pipeline.h"
+#include "lib/fxl/synchronization/waitable_event.h"
+#include "third_party/benchmark/include/benchmark/benchmark_api.h"
+
+namespace flutter {
+namespace {
+
+using IntPipeline = Pipeline<int>;
+
+// Produce, complete and consume one resource at a time.
+void BM_PipelineRoundTrip(benchmark::State& state) {
+  auto pipeline = fxl::MakeRefCounted<IntPipeline>(state.range(0));
+  int consumed = 0;
+  IntPipeline::Consumer consumer = [&consumed](std::unique_ptr<int> value) {
+    consumed += *value;
+  };
+  while (state.KeepRunning()) {
+    pipeline->Produce().Complete(std::make_unique<int>(1));
+    benchmark::DoNotOptimize(pipeline->Consume(consumer));
+  }
+  state.SetItemsProcessed(consumed);
+}
+BENCHMARK(BM_PipelineRoundTrip)->Arg(1)->Arg(2)->Arg(3);
+
+// Fill the pipeline and drain it, which exercises every slot.
+void BM_PipelineFillAndDrain(benchmark::State& state) {
+  const int depth = state.range(0);
+  auto pipeline = fxl::MakeRefCounted<IntPipeline>(depth);
+  IntPipeline::Consumer consumer = [](std::unique_ptr<int> value) {
+    benchmark::DoNotOptimize(value);
+  };
+  while (state.KeepRunning()) {
+    for (int i = 0; i < depth; i++)
+      pipeline->Produce().Complete(std::make_unique<int>(i));
+    while (pipeline->Consume(consumer) == PipelineConsumeResult::MoreAvailable)
+      ;
+  }
+  state.SetItemsProcessed(state.iterations() * depth);
+}
+BENCHMARK(BM_PipelineFillAndDrain)->Arg(2)->Arg(8)->Arg(64);
+
+// The producer completes a resource and posts its consumption to the loop of
+// another thread. When the pipeline is full it waits for the consumer to
+// free a slot. Measures the throughput of a produce/consume round trip
+// across threads.
+void BM_PipelineCrossThread(benchmark::State& state) {
+  fml::Thread consumer_thread("consumer");
+  fxl::RefPtr<fxl::TaskRunner> runner = consumer_thread.GetTaskRunner();
+  auto pipeline = fxl::MakeRefCounted<IntPipeline>(state.range(0));
+  fxl::AutoResetWaitableEvent slot_freed;
+  IntPipeline::Consumer consumer = [](std::unique_ptr<int> value) {
+    benchmark::DoNotOptimize(value);
+  };
+  // The slot is only handed back once Consume returns.
+  auto consume = [pipeline, &consumer, &slot_freed]() {
+    benchmark::DoNotOptimize(pipeline->Consume(consumer));
+    slot_freed.Signal();
+  };
+
+  while (state.KeepRunning()) {
+    IntPipeline::ProducerContinuation continuation = pipeline->Produce();
+    while (!continuation) {
+      slot_freed.Wait();
+      continuation = pipeline->Produce();
+    }
+    continuation.Complete(std::make_unique<int>(1));
+    runner->PostTask(consume);
+  }
+
+  // Let the consumer drain what is left before the pipeline goes away.
+  fxl::AutoResetWaitableEvent drained;
+  runner->PostTask([&drained]() { drained.Signal(); });
+  drained.Wait();
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PipelineCrossThread)->Arg(1)->Arg(2)->Arg(3)->UseRealTime();
+
+}  // namespace
+}  // namespace flutter
+
+BENCHMARK_MAIN();
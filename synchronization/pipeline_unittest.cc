@@ -0,0 +1,93 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <thread>
+
+#include "flutter/synchronization/pipeline.h"
+#include "gtest/gtest.h"
+
+using IntPipeline = flutter::Pipeline<int>;
+
+TEST(PipelineTest, SimpleValidity) {
+  auto pipeline = fxl::MakeRefCounted<IntPipeline>(2);
+  ASSERT_TRUE(pipeline->IsValid());
+  ASSERT_EQ(pipeline->depth(), 2u);
+  ASSERT_EQ(pipeline->GetQueuedItemCount(), 0u);
+}
+
+TEST(PipelineTest, ProduceIsBoundedByDepth) {
+  auto pipeline = fxl::MakeRefCounted<IntPipeline>(2);
+  auto first = pipeline->Produce();
+  auto second = pipeline->Produce();
+  ASSERT_TRUE(first);
+  ASSERT_TRUE(second);
+  ASSERT_FALSE(pipeline->Produce());
+}
+
+TEST(PipelineTest, ConsumeInProducedOrder) {
+  auto pipeline = fxl::MakeRefCounted<IntPipeline>(2);
+  pipeline->Produce().Complete(std::make_unique<int>(1));
+  pipeline->Produce().Complete(std::make_unique<int>(2));
+  ASSERT_EQ(pipeline->GetQueuedItemCount(), 2u);
+
+  int last = 0;
+  IntPipeline::Consumer consumer = [&last](std::unique_ptr<int> value) {
+    last = *value;
+  };
+  ASSERT_EQ(pipeline->Consume(consumer),
+            flutter::PipelineConsumeResult::MoreAvailable);
+  ASSERT_EQ(last, 1);
+  ASSERT_EQ(pipeline->Consume(consumer), flutter::PipelineConsumeResult::Done);
+  ASSERT_EQ(last, 2);
+  ASSERT_EQ(pipeline->Consume(consumer),
+            flutter::PipelineConsumeResult::NoneAvailable);
+
+  // Consumed slots are available to the producer again.
+  ASSERT_TRUE(pipeline->Produce());
+}
+
+TEST(PipelineTest, DroppedContinuationsCommitNothing) {
+  auto pipeline = fxl::MakeRefCounted<IntPipeline>(1);
+  { auto continuation = pipeline->Produce(); }
+
+  bool consumed_null = false;
+  ASSERT_EQ(pipeline->Consume([&consumed_null](std::unique_ptr<int> value) {
+    consumed_null = value == nullptr;
+  }),
+            flutter::PipelineConsumeResult::Done);
+  ASSERT_TRUE(consumed_null);
+}
+
+TEST(PipelineTest, ProducerAndConsumerOnSeparateThreads) {
+  auto pipeline = fxl::MakeRefCounted<IntPipeline>(3);
+  constexpr int kItemCount = 10000;
+
+  std::thread producer([pipeline]() {
+    for (int i = 0; i < kItemCount;) {
+      auto continuation = pipeline->Produce();
+      if (continuation) {
+        continuation.Complete(std::make_unique<int>(i++));
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  int expected = 0;
+  bool in_order = true;
+  IntPipeline::Consumer consumer = [&](std::unique_ptr<int> value) {
+    in_order = in_order && value && *value == expected;
+    expected++;
+  };
+  while (expected < kItemCount) {
+    if (pipeline->Consume(consumer) ==
+        flutter::PipelineConsumeResult::NoneAvailable) {
+      std::this_thread::yield();
+    }
+  }
+
+  producer.join();
+  ASSERT_TRUE(in_order);
+  ASSERT_EQ(expected, kItemCount);
+}
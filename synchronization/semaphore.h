@@ -5,7 +5,9 @@
 #ifndef SYNCHRONIZATION_SEMAPHORE_H_
 #define SYNCHRONIZATION_SEMAPHORE_H_
 
-#include <memory>
+#include <stdint.h>
+
+#include <atomic>
 
 #include "lib/fxl/compiler_specific.h"
 #include "lib/fxl/macros.h"
@@ -13,8 +15,9 @@
 
 namespace flutter {
 
-class PlatformSemaphore;
-
+// A counting semaphore that never blocks. As no caller waits, the count is
+// kept in an atomic rather than in a platform semaphore, so that neither
+// |TryWait| nor |Signal| makes a system call.
 class Semaphore {
  public:
   explicit Semaphore(uint32_t count);
@@ -29,7 +32,7 @@ class Semaphore {
   void Signal();
 
  private:
-  std::unique_ptr<PlatformSemaphore> _impl;
+  std::atomic<int64_t> count_;
 
   FXL_DISALLOW_COPY_AND_ASSIGN(Semaphore);
 };
@@ -2,7 +2,9 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <atomic>
 #include <thread>
+#include <vector>
 
 #include "flutter/synchronization/semaphore.h"
 #include "gtest/gtest.h"
@@ -25,3 +27,28 @@ TEST(SemaphoreTest, WaitOnZeroSignalThenWait) {
   ASSERT_TRUE(sem.TryWait());
   ASSERT_FALSE(sem.TryWait());
 }
+
+TEST(SemaphoreTest, ConcurrentWaitsTakeEachSignalOnce) {
+  const int kThreadCount = 4;
+  const int kSignalsPerThread = 10000;
+  flutter::Semaphore sem(0);
+  std::atomic<int> taken(0);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kThreadCount; i++) {
+    threads.emplace_back([&sem, &taken]() {
+      for (int j = 0; j < kSignalsPerThread; j++) {
+        sem.Signal();
+        if (sem.TryWait()) {
+          taken++;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  while (sem.TryWait()) {
+    taken++;
+  }
+  ASSERT_EQ(taken, kThreadCount * kSignalsPerThread);
+}
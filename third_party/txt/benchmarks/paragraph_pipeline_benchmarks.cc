@@ -0,0 +1,213 @@
+/*
+ * Copyright 2017 Google, Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Benchmarks of the stages of the full paragraph pipeline (build, layout,
+// relayout at a new width and paint), swept over text length, script, number
+// of style runs and layout width. Each benchmark is named
+//
+//   BM_Pipeline<Stage>/<code units>/<script>/<style runs>/<width>
+//
+// and labeled with the script name. Pass
+//
+//   --benchmark_out=<file> --benchmark_out_format=json
+//
+// to record the results in a form that can be compared across engine rolls.
+
+#include "third_party/benchmark/include/benchmark/benchmark_api.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
+#include "lib/fxl/logging.h"
+#include "third_party/icu/source/common/unicode/unistr.h"
+#include "third_party/icu/source/common/unicode/utf16.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkColor.h"
+#include "txt/font_collection.h"
+#include "txt/font_weight.h"
+#include "txt/paragraph.h"
+#include "txt/paragraph_builder.h"
+#include "utils.h"
+
+namespace txt {
+namespace {
+
+enum Script {
+  kLatin,
+  kCJK,
+  kArabicBidi,
+  kEmoji,
+  kScriptCount,
+};
+
+struct ScriptSample {
+  const char* name;
+  const char* font_family;
+  TextDirection direction;
+  // Repeated until the text has the benchmarked length.
+  const char* text;
+};
+
+const ScriptSample kSamples[kScriptCount] = {
+    {"latin", "Roboto", TextDirection::ltr,
+     "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+     "tempor incididunt ut labore et dolore magna aliqua. "},
+    {"cjk", "Source Han Serif CN", TextDirection::ltr,
+     "左線読設重説切後碁給能上目秘使約。満毎冠行来昼本可必図将発確年。"},
+    {"arabic_bidi", "Katibeh", TextDirection::rtl,
+     "من أسر وإعلان الخاصّة وهولندا، Flutter 2017 عل قائمة الضغوط بالمطالبة "
+     "تلك. "},
+    {"emoji", "Noto Color Emoji", TextDirection::ltr,
+     "😀😃😄😁😆😅😂🤣☺😇🙂😍😡😟😢😻👽💩👍👎🙏👌👋👄👁👦👼👨‍🚀👨‍🚒🙋‍♂️👳 "},
+};
+
+const int kLengths[] = {10, 100, 1000, 10000, 100000};
+const int kStyleRuns[] = {1, 32, 1024};
+const int kWidths[] = {300, 1000};
+
+// Returns length code units of the script's sample, without splitting a
+// surrogate pair at the end.
+std::u16string MakeText(Script script, size_t length) {
+  auto icu_text = icu::UnicodeString::fromUTF8(kSamples[script].text);
+  std::u16string sample(icu_text.getBuffer(),
+                        icu_text.getBuffer() + icu_text.length());
+  std::u16string text;
+  text.reserve(length);
+  while (text.size() < length)
+    text.append(sample, 0, length - text.size());
+  if (!text.empty() && U16_IS_LEAD(text.back()))
+    text.back() = u' ';
+  return text;
+}
+
+// Splits text into style_runs runs that alternate between two styles which
+// shape differently.
+std::unique_ptr<ParagraphBuilder> MakeBuilder(const std::u16string& text,
+                                              Script script,
+                                              size_t style_runs) {
+  ParagraphStyle paragraph_style;
+  paragraph_style.text_direction = kSamples[script].direction;
+  auto builder = std::make_unique<ParagraphBuilder>(paragraph_style,
+                                                    GetTestFontCollection());
+
+  TextStyle styles[2];
+  styles[0].font_family = kSamples[script].font_family;
+  styles[0].color = SK_ColorBLACK;
+  styles[1] = styles[0];
+  styles[1].font_weight = FontWeight::w700;
+  styles[1].color = SK_ColorBLUE;
+
+  size_t run_length = std::max<size_t>(1, text.size() / style_runs);
+  for (size_t start = 0, run = 0; start < text.size(); start += run_length) {
+    builder->PushStyle(styles[run++ % 2]);
+    builder->AddText(text.substr(start, run_length));
+    builder->Pop();
+  }
+  return builder;
+}
+
+struct PipelineArgs {
+  explicit PipelineArgs(const benchmark::State& state)
+      : length(state.range(0)),
+        script(static_cast<Script>(state.range(1))),
+        style_runs(state.range(2)),
+        width(state.range(3)) {}
+
+  size_t length;
+  Script script;
+  size_t style_runs;
+  double width;
+};
+
+void PipelineArguments(benchmark::internal::Benchmark* benchmark) {
+  for (int length : kLengths) {
+    for (int script = 0; script < kScriptCount; ++script) {
+      for (int style_runs : kStyleRuns) {
+        if (style_runs > length)
+          continue;
+        for (int width : kWidths)
+          benchmark->Args({length, script, style_runs, width});
+      }
+    }
+  }
+}
+
+void ReportPipeline(benchmark::State& state, const PipelineArgs& args) {
+  state.SetLabel(kSamples[args.script].name);
+  state.SetItemsProcessed(state.iterations() * args.length);
+}
+
+}  // namespace
+
+static void BM_PipelineBuild(benchmark::State& state) {
+  PipelineArgs args(state);
+  std::u16string text = MakeText(args.script, args.length);
+  while (state.KeepRunning()) {
+    auto paragraph = MakeBuilder(text, args.script, args.style_runs)->Build();
+    benchmark::DoNotOptimize(paragraph.get());
+  }
+  ReportPipeline(state, args);
+}
+BENCHMARK(BM_PipelineBuild)->Apply(PipelineArguments);
+
+// Lays out from scratch every iteration. Minikin's word cache stays warm, as
+// it would across the frames of an app.
+static void BM_PipelineLayout(benchmark::State& state) {
+  PipelineArgs args(state);
+  std::u16string text = MakeText(args.script, args.length);
+  auto paragraph = MakeBuilder(text, args.script, args.style_runs)->Build();
+  while (state.KeepRunning()) {
+    paragraph->Layout(args.width, true);
+  }
+  ReportPipeline(state, args);
+}
+BENCHMARK(BM_PipelineLayout)->Apply(PipelineArguments);
+
+// Alternates between the width and half of it, which keeps the measurements
+// and shaped runs of the previous layout.
+static void BM_PipelineRelayout(benchmark::State& state) {
+  PipelineArgs args(state);
+  std::u16string text = MakeText(args.script, args.length);
+  auto paragraph = MakeBuilder(text, args.script, args.style_runs)->Build();
+  paragraph->Layout(args.width);
+  size_t iteration = 0;
+  while (state.KeepRunning()) {
+    paragraph->Layout(++iteration % 2 ? args.width / 2 : args.width);
+  }
+  ReportPipeline(state, args);
+}
+BENCHMARK(BM_PipelineRelayout)->Apply(PipelineArguments);
+
+static void BM_PipelinePaint(benchmark::State& state) {
+  PipelineArgs args(state);
+  std::u16string text = MakeText(args.script, args.length);
+  auto paragraph = MakeBuilder(text, args.script, args.style_runs)->Build();
+  paragraph->Layout(args.width);
+
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(1000, 1000);
+  SkCanvas canvas(bitmap);
+  canvas.clear(SK_ColorWHITE);
+  while (state.KeepRunning()) {
+    paragraph->Paint(&canvas, 0, 0);
+  }
+  ReportPipeline(state, args);
+}
+BENCHMARK(BM_PipelinePaint)->Apply(PipelineArguments);
+
+}  // namespace txt
@@ -36,4 +36,35 @@ static void BM_StyledRunsGetRun(benchmark::State& state) {
 }
 BENCHMARK(BM_StyledRunsGetRun);
 
+static void BM_StyledRunsIterate(benchmark::State& state) {
+  StyledRuns runs;
+  TextStyle style;
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    style.font_size = 10 + i % 8;
+    runs.StartRun(runs.AddStyle(style), i * 10);
+    runs.EndRunIfNeeded(i * 10 + 10);
+  }
+  while (state.KeepRunning()) {
+    size_t end = 0;
+    for (size_t i = 0; i < runs.size(); ++i)
+      end += runs.GetRun(i).end;
+    benchmark::DoNotOptimize(end);
+  }
+}
+BENCHMARK(BM_StyledRunsIterate)->Range(1, 1 << 10);
+
+static void BM_StyledRunsCopy(benchmark::State& state) {
+  StyledRuns runs;
+  TextStyle style;
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    runs.StartRun(runs.AddStyle(style), i * 10);
+    runs.EndRunIfNeeded(i * 10 + 10);
+  }
+  while (state.KeepRunning()) {
+    StyledRuns copy(runs);
+    benchmark::DoNotOptimize(copy.size());
+  }
+}
+BENCHMARK(BM_StyledRunsCopy)->Range(1, 1 << 10);
+
 }  // namespace txt
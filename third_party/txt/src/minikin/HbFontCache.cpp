@@ -48,9 +48,13 @@ class HbFontCache : private android::OnEntryRemoved<int32_t, hb_font_t*> {
 
   void remove(int32_t fontId) { mCache.remove(fontId); }
 
- private:
+  void setMaxEntries(size_t maxEntries) { mCache.setMaxCapacity(maxEntries); }
+
+  // The default number of fonts kept, see setHbFontCacheCapacityLocked().
   static const size_t kMaxEntries = 100;
 
+ private:
+
   android::LruCache<int32_t, hb_font_t*> mCache;
 };
 
@@ -68,6 +72,11 @@ void purgeHbFontCacheLocked() {
   getFontCacheLocked()->clear();
 }
 
+void setHbFontCacheCapacityLocked(size_t maxEntries) {
+  assertMinikinLocked();
+  getFontCacheLocked()->setMaxEntries(maxEntries);
+}
+
 void purgeHbFontLocked(const MinikinFont* minikinFont) {
   assertMinikinLocked();
   const int32_t fontId = minikinFont->GetUniqueId();
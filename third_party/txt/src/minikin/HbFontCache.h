@@ -17,12 +17,16 @@
 #ifndef MINIKIN_HBFONT_CACHE_H
 #define MINIKIN_HBFONT_CACHE_H
 
+#include <stddef.h>
+
 struct hb_font_t;
 
 namespace minikin {
 class MinikinFont;
 
 void purgeHbFontCacheLocked();
+// Sets the number of HarfBuzz fonts kept alive. Zero keeps all of them.
+void setHbFontCacheCapacityLocked(size_t maxEntries);
 void purgeHbFontLocked(const MinikinFont* minikinFont);
 hb_font_t* getHbFontLocked(const MinikinFont* minikinFont);
 
@@ -22,6 +22,8 @@
 #include <algorithm>
 #include <fstream>
 #include <iostream>  // for debugging
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -101,6 +103,9 @@ class LayoutCacheKey {
     mChars = NULL;
   }
 
+  // The bytes of the text copied by copyText.
+  size_t textBytes() const { return mNchars * sizeof(uint16_t); }
+
   void doLayout(Layout* layout,
                 LayoutContext* ctx,
                 const std::shared_ptr<FontCollection>& collection) const {
@@ -110,6 +115,14 @@ class LayoutCacheKey {
                         collection);
   }
 
+  // Returns the key of the word in a LayoutCacheStorage, and the faces it is
+  // shaped with in the order doLayoutRun finds them. Fonts are identified by
+  // their 'head' table rather than by pointer, so the key is the same in every
+  // process. Returns an empty key if a font can't be identified.
+  std::string storageKey(const MinikinPaint& paint,
+                         const std::shared_ptr<FontCollection>& collection,
+                         std::vector<FakedFont>* faces) const;
+
  private:
   const uint16_t* mChars;
   size_t mNchars;
@@ -131,42 +144,110 @@ class LayoutCacheKey {
   android::hash_t computeHash() const;
 };
 
-class LayoutCache : private android::OnEntryRemoved<LayoutCacheKey, Layout*> {
+// One independently locked part of the LayoutCache.
+class LayoutCacheShard
+    : private android::OnEntryRemoved<LayoutCacheKey, Layout*> {
  public:
-  LayoutCache() : mCache(kMaxEntries) {
+  explicit LayoutCacheShard(size_t maxEntries) : mCache(maxEntries) {
     mCache.setOnEntryRemovedListener(this);
   }
 
+  // Guards the shard. Held around every other call.
+  std::mutex& lock() { return mLock; }
+
   void clear() { mCache.clear(); }
 
-  Layout* get(LayoutCacheKey& key,
-              LayoutContext* ctx,
-              const std::shared_ptr<FontCollection>& collection) {
-    Layout* layout = mCache.get(key);
-    if (layout == NULL) {
-      key.copyText();
-      layout = new Layout();
-      key.doLayout(layout, ctx, collection);
-      mCache.put(key, layout);
+  void setMaxEntries(size_t maxEntries) { mCache.setMaxCapacity(maxEntries); }
+
+  size_t entryCount() const { return mCache.size(); }
+
+  size_t bytes() const { return mBytes; }
+
+  // Returns the cached layout for key, or NULL. The returned layout is only
+  // valid while the shard is locked.
+  Layout* get(const LayoutCacheKey& key) { return mCache.get(key); }
+
+  // Takes ownership of layout, which was computed for key without holding the
+  // lock. If another thread cached the same key in the meantime, the layout is
+  // dropped.
+  void put(LayoutCacheKey& key, Layout* layout) {
+    key.copyText();
+    if (!mCache.put(key, layout)) {
+      key.freeText();
+      delete layout;
+      return;
     }
-    return layout;
+    mBytes += entryBytes(key, *layout);
   }
 
  private:
+  static size_t entryBytes(const LayoutCacheKey& key, const Layout& layout) {
+    return key.textBytes() + layout.getMemoryUsage();
+  }
+
   // callback for OnEntryRemoved
   void operator()(LayoutCacheKey& key, Layout*& value) {
+    mBytes -= entryBytes(key, *value);
     key.freeText();
     delete value;
   }
 
+  std::mutex mLock;
+  size_t mBytes = 0;
   android::LruCache<LayoutCacheKey, Layout*> mCache;
+};
+
+// Caches the layout of words. The entries are spread over shards by key hash
+// so that threads laying out different words rarely wait on each other.
+class LayoutCache {
+ public:
+  LayoutCache() {
+    for (size_t i = 0; i < kShardCount; i++) {
+      mShards[i].reset(new LayoutCacheShard(shardEntries(kMaxEntries)));
+    }
+  }
 
-  // static const size_t kMaxEntries = LruCache<LayoutCacheKey,
-  // Layout*>::kUnlimitedCapacity;
+  LayoutCacheShard& shardFor(const LayoutCacheKey& key) {
+    return *mShards[key.hash() % kShardCount];
+  }
+
+  void clear() {
+    for (size_t i = 0; i < kShardCount; i++) {
+      std::lock_guard<std::mutex> _l(mShards[i]->lock());
+      mShards[i]->clear();
+    }
+  }
+
+  // Zero keeps all entries.
+  void setMaxEntries(size_t maxEntries) {
+    for (size_t i = 0; i < kShardCount; i++) {
+      std::lock_guard<std::mutex> _l(mShards[i]->lock());
+      mShards[i]->setMaxEntries(shardEntries(maxEntries));
+    }
+  }
+
+  void getUsage(size_t* entries, size_t* bytes) {
+    *entries = 0;
+    *bytes = 0;
+    for (size_t i = 0; i < kShardCount; i++) {
+      std::lock_guard<std::mutex> _l(mShards[i]->lock());
+      *entries += mShards[i]->entryCount();
+      *bytes += mShards[i]->bytes();
+    }
+  }
 
   // TODO: eviction based on memory footprint; for now, we just use a constant
   // number of strings
   static const size_t kMaxEntries = 5000;
+
+ private:
+  static const size_t kShardCount = 8;
+
+  static size_t shardEntries(size_t maxEntries) {
+    return (maxEntries + kShardCount - 1) / kShardCount;
+  }
+
+  std::unique_ptr<LayoutCacheShard> mShards[kShardCount];
 };
 
 static unsigned int disabledDecomposeCompatibility(hb_unicode_funcs_t*,
@@ -183,11 +264,8 @@ class LayoutEngine {
     /* Disable the function used for compatibility decomposition */
     hb_unicode_funcs_set_decompose_compatibility_func(
         unicodeFunctions, disabledDecomposeCompatibility, NULL, NULL);
-    hbBuffer = hb_buffer_create();
-    hb_buffer_set_unicode_funcs(hbBuffer, unicodeFunctions);
   }
 
-  hb_buffer_t* hbBuffer;
   hb_unicode_funcs_t* unicodeFunctions;
   LayoutCache layoutCache;
 
@@ -195,6 +273,36 @@ class LayoutEngine {
     static LayoutEngine* instance = new LayoutEngine();
     return *instance;
   }
+
+  // Shaping runs without gMinikinLock held, so every thread shapes into its
+  // own buffer.
+  static hb_buffer_t* getThreadBuffer() {
+    static thread_local HbBufferHolder holder(getInstance().unicodeFunctions);
+    return holder.buffer;
+  }
+
+  std::shared_ptr<LayoutCacheStorage> getStorage() {
+    std::lock_guard<std::mutex> _l(storageLock);
+    return storage;
+  }
+
+  void setStorage(std::shared_ptr<LayoutCacheStorage> newStorage) {
+    std::lock_guard<std::mutex> _l(storageLock);
+    storage = std::move(newStorage);
+  }
+
+ private:
+  std::mutex storageLock;
+  std::shared_ptr<LayoutCacheStorage> storage;
+
+  struct HbBufferHolder {
+    explicit HbBufferHolder(hb_unicode_funcs_t* unicodeFunctions)
+        : buffer(hb_buffer_create()) {
+      hb_buffer_set_unicode_funcs(buffer, unicodeFunctions);
+    }
+    ~HbBufferHolder() { hb_buffer_destroy(buffer); }
+    hb_buffer_t* buffer;
+  };
 };
 
 bool LayoutCacheKey::operator==(const LayoutCacheKey& other) const {
@@ -227,6 +335,110 @@ android::hash_t hash_type(const LayoutCacheKey& key) {
   return key.hash();
 }
 
+// Bumped whenever the encoding of storage keys or values changes, so that
+// stale entries never match.
+static const uint32_t kStorageVersion = 1;
+
+template <typename T>
+static void appendValue(std::string* out, const T& value) {
+  out->append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+static void appendBytes(std::string* out, const void* data, size_t size) {
+  appendValue(out, static_cast<uint32_t>(size));
+  out->append(reinterpret_cast<const char*>(data), size);
+}
+
+template <typename T>
+static bool readValue(const std::string& in, size_t* offset, T* value) {
+  if (in.size() - *offset < sizeof(T)) {
+    return false;
+  }
+  memcpy(value, in.data() + *offset, sizeof(T));
+  *offset += sizeof(T);
+  return true;
+}
+
+// Lists the fonts of items in the order doLayoutRun adds them to mFaces.
+static void collectFaces(const vector<FontCollection::Run>& items,
+                         bool isRtl,
+                         vector<FakedFont>* faces) {
+  for (size_t i = 0; i < items.size(); i++) {
+    const FakedFont& face = items[isRtl ? items.size() - 1 - i : i].fakedFont;
+    if (face.font == NULL) {
+      continue;
+    }
+    bool found = false;
+    for (const FakedFont& existing : *faces) {
+      found = found || existing.font == face.font;
+    }
+    if (!found) {
+      faces->push_back(face);
+    }
+  }
+}
+
+static bool sameFonts(const vector<FakedFont>& a, const vector<FakedFont>& b) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.size(); i++) {
+    if (a[i].font != b[i].font) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::string LayoutCacheKey::storageKey(
+    const MinikinPaint& paint,
+    const std::shared_ptr<FontCollection>& collection,
+    std::vector<FakedFont>* faces) const {
+  std::lock_guard<std::mutex> _l(gMinikinLock);
+  vector<FontCollection::Run> items;
+  collection->itemize(mChars + mStart, mCount, mStyle, &items);
+  collectFaces(items, mIsRtl, faces);
+
+  std::string key;
+  appendValue(&key, kStorageVersion);
+  appendValue(&key, static_cast<uint32_t>(mStart));
+  appendValue(&key, static_cast<uint32_t>(mCount));
+  appendBytes(&key, mChars, mNchars * sizeof(uint16_t));
+  appendValue(&key, static_cast<int32_t>(mStyle.getWeight()));
+  appendValue(&key, static_cast<int32_t>(mStyle.getVariant()));
+  appendValue(&key, static_cast<uint8_t>(mStyle.getItalic()));
+  const FontLanguages& languages =
+      FontLanguageListCache::getById(mStyle.getLanguageListId());
+  appendValue(&key, static_cast<uint32_t>(languages.size()));
+  for (size_t i = 0; i < languages.size(); i++) {
+    const std::string language = languages[i].getString();
+    appendBytes(&key, language.data(), language.size());
+  }
+  appendValue(&key, mSize);
+  appendValue(&key, mScaleX);
+  appendValue(&key, mSkewX);
+  appendValue(&key, mLetterSpacing);
+  appendValue(&key, mPaintFlags);
+  appendValue(&key, mHyphenEdit.getHyphen());
+  appendValue(&key, static_cast<uint8_t>(mIsRtl));
+  appendBytes(&key, paint.fontFeatureSettings.data(),
+              paint.fontFeatureSettings.size());
+  appendValue(&key, static_cast<uint32_t>(faces->size()));
+  for (FakedFont& face : *faces) {
+    hb_font_t* font = getHbFontLocked(face.font);
+    HbBlob head(hb_face_reference_table(hb_font_get_face(font),
+                                        HB_TAG('h', 'e', 'a', 'd')));
+    hb_font_destroy(font);
+    if (head.size() == 0) {
+      return std::string();
+    }
+    appendBytes(&key, head.get(), head.size());
+    appendValue(&key, static_cast<uint8_t>(face.fakery.isFakeBold()));
+    appendValue(&key, static_cast<uint8_t>(face.fakery.isFakeItalic()));
+  }
+  return key;
+}
+
 void MinikinRect::join(const MinikinRect& r) {
   if (isEmpty()) {
     set(r);
@@ -329,7 +541,15 @@ int Layout::findFace(const FakedFont& face, LayoutContext* ctx) {
   // Note: ctx == NULL means we're copying from the cache, no need to create
   // corresponding hb_font object.
   if (ctx != NULL) {
-    hb_font_t* font = getHbFontLocked(face.font);
+    // The cached font is shared by all threads, so each layout scales its own
+    // sub font instead.
+    hb_font_t* font;
+    {
+      std::lock_guard<std::mutex> _l(gMinikinLock);
+      hb_font_t* parent = getHbFontLocked(face.font);
+      font = hb_font_create_sub_font(parent);
+      hb_font_destroy(parent);
+    }
     // Temporarily removed to fix advance integer rounding.
     // This is likely due to very old versions of harfbuzz and ICU.
     // hb_font_set_funcs(font, getHbFontFuncs(isColorBitmapFont(font)),
@@ -340,10 +560,7 @@ int Layout::findFace(const FakedFont& face, LayoutContext* ctx) {
 }
 
 static hb_script_t codePointToScript(hb_codepoint_t codepoint) {
-  static hb_unicode_funcs_t* u = 0;
-  if (!u) {
-    u = LayoutEngine::getInstance().unicodeFunctions;
-  }
+  static hb_unicode_funcs_t* u = LayoutEngine::getInstance().unicodeFunctions;
   return hb_unicode_script(u, codepoint);
 }
 
@@ -602,8 +819,6 @@ void Layout::doLayout(const uint16_t* buf,
                       const FontStyle& style,
                       const MinikinPaint& paint,
                       const std::shared_ptr<FontCollection>& collection) {
-  std::lock_guard<std::mutex> _l(gMinikinLock);
-
   LayoutContext ctx;
   ctx.style = style;
   ctx.paint = paint;
@@ -628,8 +843,6 @@ float Layout::measureText(const uint16_t* buf,
                           const MinikinPaint& paint,
                           const std::shared_ptr<FontCollection>& collection,
                           float* advances) {
-  std::lock_guard<std::mutex> _l(gMinikinLock);
-
   LayoutContext ctx;
   ctx.style = style;
   ctx.paint = paint;
@@ -714,6 +927,17 @@ float Layout::doLayoutRunCached(
   return advance;
 }
 
+// Adds the word spacing of a word to its advance.
+static float addWordSpacing(float advance, float wordSpacing, float* advances) {
+  if (wordSpacing != 0) {
+    advance += wordSpacing;
+    if (advances) {
+      advances[0] += wordSpacing;
+    }
+  }
+  return advance;
+}
+
 float Layout::doLayoutWord(const uint16_t* buf,
                            size_t start,
                            size_t count,
@@ -724,42 +948,65 @@ float Layout::doLayoutWord(const uint16_t* buf,
                            const std::shared_ptr<FontCollection>& collection,
                            Layout* layout,
                            float* advances) {
-  LayoutCache& cache = LayoutEngine::getInstance().layoutCache;
   LayoutCacheKey key(collection, ctx->paint, ctx->style, buf, start, count,
                      bufSize, isRtl);
+  LayoutCacheShard& cache =
+      LayoutEngine::getInstance().layoutCache.shardFor(key);
 
   float wordSpacing =
       count == 1 && isWordSpace(buf[start]) ? ctx->paint.wordSpacing : 0;
 
   float advance;
-  if (ctx->paint.skipCache()) {
-    Layout layoutForWord;
-    key.doLayout(&layoutForWord, ctx, collection);
-    if (layout) {
-      layout->appendLayout(&layoutForWord, bufStart, wordSpacing);
-    }
-    if (advances) {
-      layoutForWord.getAdvances(advances);
-    }
-    advance = layoutForWord.getAdvance();
-  } else {
-    Layout* layoutForWord = cache.get(key, ctx, collection);
-    if (layout) {
-      layout->appendLayout(layoutForWord, bufStart, wordSpacing);
-    }
-    if (advances) {
-      layoutForWord->getAdvances(advances);
+  if (!ctx->paint.skipCache()) {
+    std::lock_guard<std::mutex> _l(cache.lock());
+    Layout* layoutForWord = cache.get(key);
+    if (layoutForWord != NULL) {
+      if (layout) {
+        layout->appendLayout(layoutForWord, bufStart, wordSpacing);
+      }
+      if (advances) {
+        layoutForWord->getAdvances(advances);
+      }
+      return addWordSpacing(layoutForWord->getAdvance(), wordSpacing,
+                            advances);
     }
-    advance = layoutForWord->getAdvance();
   }
 
-  if (wordSpacing != 0) {
-    advance += wordSpacing;
-    if (advances) {
-      advances[0] += wordSpacing;
+  std::shared_ptr<LayoutCacheStorage> storage;
+  if (!ctx->paint.skipCache()) {
+    storage = LayoutEngine::getInstance().getStorage();
+  }
+  std::vector<FakedFont> faces;
+  std::string storageKey;
+  if (storage) {
+    storageKey = key.storageKey(ctx->paint, collection, &faces);
+  }
+
+  std::unique_ptr<Layout> layoutForWord(new Layout());
+  std::string storedLayout;
+  if (storageKey.empty() || !storage->get(storageKey, &storedLayout) ||
+      !layoutForWord->deserialize(storedLayout, faces, count)) {
+    // Shape the word without holding the lock so that other threads can lay
+    // out text at the same time.
+    key.doLayout(layoutForWord.get(), ctx, collection);
+    if (!storageKey.empty() && sameFonts(layoutForWord->mFaces, faces)) {
+      storedLayout.clear();
+      layoutForWord->serialize(&storedLayout);
+      storage->put(storageKey, storedLayout);
     }
   }
-  return advance;
+  if (layout) {
+    layout->appendLayout(layoutForWord.get(), bufStart, wordSpacing);
+  }
+  if (advances) {
+    layoutForWord->getAdvances(advances);
+  }
+  advance = layoutForWord->getAdvance();
+  if (!ctx->paint.skipCache()) {
+    std::lock_guard<std::mutex> _l(cache.lock());
+    cache.put(key, layoutForWord.release());
+  }
+  return addWordSpacing(advance, wordSpacing, advances);
 }
 
 static void addFeatures(const string& str, vector<hb_feature_t>* features) {
@@ -770,7 +1017,7 @@ static void addFeatures(const string& str, vector<hb_feature_t>* features) {
   const char* end = start + str.size();
 
   while (start < end) {
-    static hb_feature_t feature;
+    hb_feature_t feature;
     const char* p = strchr(start, ',');
     if (!p)
       p = end;
@@ -941,9 +1188,12 @@ void Layout::doLayoutRun(const uint16_t* buf,
                          bool isRtl,
                          LayoutContext* ctx,
                          const std::shared_ptr<FontCollection>& collection) {
-  hb_buffer_t* buffer = LayoutEngine::getInstance().hbBuffer;
+  hb_buffer_t* buffer = LayoutEngine::getThreadBuffer();
   vector<FontCollection::Run> items;
-  collection->itemize(buf + start, count, ctx->style, &items);
+  {
+    std::lock_guard<std::mutex> _l(gMinikinLock);
+    collection->itemize(buf + start, count, ctx->style, &items);
+  }
 
   vector<hb_feature_t> features;
   // Disable default-on non-required ligature features if letter-spacing
@@ -1027,17 +1277,20 @@ void Layout::doLayoutRun(const uint16_t* buf,
       hb_buffer_set_script(buffer, script);
       hb_buffer_set_direction(buffer,
                               isRtl ? HB_DIRECTION_RTL : HB_DIRECTION_LTR);
-      const FontLanguages& langList =
-          FontLanguageListCache::getById(ctx->style.getLanguageListId());
-      if (langList.size() != 0) {
-        const FontLanguage* hbLanguage = &langList[0];
-        for (size_t i = 0; i < langList.size(); ++i) {
-          if (langList[i].supportsHbScript(script)) {
-            hbLanguage = &langList[i];
-            break;
+      {
+        std::lock_guard<std::mutex> _l(gMinikinLock);
+        const FontLanguages& langList =
+            FontLanguageListCache::getById(ctx->style.getLanguageListId());
+        if (langList.size() != 0) {
+          const FontLanguage* hbLanguage = &langList[0];
+          for (size_t i = 0; i < langList.size(); ++i) {
+            if (langList[i].supportsHbScript(script)) {
+              hbLanguage = &langList[i];
+              break;
+            }
           }
+          hb_buffer_set_language(buffer, hbLanguage->getHbLanguage());
         }
-        hb_buffer_set_language(buffer, hbLanguage->getHbLanguage());
       }
 
       const uint32_t clusterStart =
@@ -1204,10 +1457,101 @@ void Layout::getBounds(MinikinRect* bounds) const {
 }
 
 void Layout::purgeCaches() {
+  LayoutEngine::getInstance().layoutCache.clear();
   std::lock_guard<std::mutex> _l(gMinikinLock);
-  LayoutCache& layoutCache = LayoutEngine::getInstance().layoutCache;
-  layoutCache.clear();
   purgeHbFontCacheLocked();
 }
 
+void Layout::serialize(std::string* out) const {
+  appendValue(out, static_cast<uint32_t>(mGlyphs.size()));
+  for (const LayoutGlyph& glyph : mGlyphs) {
+    appendValue(out, static_cast<int32_t>(glyph.font_ix));
+    appendValue(out, static_cast<uint32_t>(glyph.glyph_id));
+    appendValue(out, glyph.x);
+    appendValue(out, glyph.y);
+  }
+  appendValue(out, static_cast<uint32_t>(mAdvances.size()));
+  for (float advance : mAdvances) {
+    appendValue(out, advance);
+  }
+  appendValue(out, mAdvance);
+  appendValue(out, mBounds.mLeft);
+  appendValue(out, mBounds.mTop);
+  appendValue(out, mBounds.mRight);
+  appendValue(out, mBounds.mBottom);
+}
+
+bool Layout::deserialize(const std::string& data,
+                         const std::vector<FakedFont>& faces,
+                         size_t count) {
+  size_t offset = 0;
+  uint32_t glyphCount;
+  if (!readValue(data, &offset, &glyphCount) ||
+      glyphCount > data.size() / sizeof(LayoutGlyph)) {
+    return false;
+  }
+  std::vector<LayoutGlyph> glyphs(glyphCount);
+  for (LayoutGlyph& glyph : glyphs) {
+    int32_t fontIndex;
+    uint32_t glyphId;
+    if (!readValue(data, &offset, &fontIndex) ||
+        !readValue(data, &offset, &glyphId) ||
+        !readValue(data, &offset, &glyph.x) ||
+        !readValue(data, &offset, &glyph.y) || fontIndex < 0 ||
+        static_cast<size_t>(fontIndex) >= faces.size()) {
+      return false;
+    }
+    glyph.font_ix = fontIndex;
+    glyph.glyph_id = glyphId;
+  }
+  uint32_t advanceCount;
+  if (!readValue(data, &offset, &advanceCount) || advanceCount != count) {
+    return false;
+  }
+  std::vector<float> advances(advanceCount);
+  for (float& advance : advances) {
+    if (!readValue(data, &offset, &advance)) {
+      return false;
+    }
+  }
+  float totalAdvance;
+  MinikinRect bounds;
+  if (!readValue(data, &offset, &totalAdvance) ||
+      !readValue(data, &offset, &bounds.mLeft) ||
+      !readValue(data, &offset, &bounds.mTop) ||
+      !readValue(data, &offset, &bounds.mRight) ||
+      !readValue(data, &offset, &bounds.mBottom) || offset != data.size()) {
+    return false;
+  }
+  mGlyphs = std::move(glyphs);
+  mAdvances = std::move(advances);
+  mFaces = faces;
+  mAdvance = totalAdvance;
+  mBounds = bounds;
+  return true;
+}
+
+void Layout::setCacheCapacities(size_t layoutCacheEntries,
+                                size_t fontCacheEntries) {
+  LayoutEngine::getInstance().layoutCache.setMaxEntries(layoutCacheEntries);
+  std::lock_guard<std::mutex> _l(gMinikinLock);
+  setHbFontCacheCapacityLocked(fontCacheEntries);
+}
+
+void Layout::getCacheUsage(size_t* layoutCacheEntries,
+                           size_t* layoutCacheBytes) {
+  LayoutEngine::getInstance().layoutCache.getUsage(layoutCacheEntries,
+                                                   layoutCacheBytes);
+}
+
+size_t Layout::getMemoryUsage() const {
+  return sizeof(Layout) + mGlyphs.capacity() * sizeof(LayoutGlyph) +
+         mAdvances.capacity() * sizeof(float) +
+         mFaces.capacity() * sizeof(FakedFont);
+}
+
+void Layout::setCacheStorage(std::shared_ptr<LayoutCacheStorage> storage) {
+  LayoutEngine::getInstance().setStorage(std::move(storage));
+}
+
 }  // namespace minikin
@@ -20,6 +20,7 @@
 #include <hb.h>
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include <minikin/FontCollection.h>
@@ -53,9 +54,26 @@ enum {
   kBidi_Mask = 0x7
 };
 
+// A second level below the word layout cache, for example one that is kept on
+// disk across launches. Keys and values are opaque byte strings that do not
+// depend on the process. Called from every thread that lays out text, so
+// implementations must be thread safe.
+class LayoutCacheStorage {
+ public:
+  virtual ~LayoutCacheStorage() {}
+
+  // Copies the value stored for key into value. Returns false on a miss.
+  virtual bool get(const std::string& key, std::string* value) = 0;
+
+  // Stores the layout of a word that missed both caches.
+  virtual void put(const std::string& key, const std::string& value) = 0;
+};
+
 // Lifecycle and threading assumptions for Layout:
 // The object is assumed to be owned by a single thread; multiple threads
-// may not mutate it at the same time.
+// may not mutate it at the same time. Different Layout objects may be laid
+// out and measured concurrently; the shared caches are only locked around
+// lookups, and shaping itself runs unlocked.
 class Layout {
  public:
   Layout() : mGlyphs(), mAdvances(), mFaces(), mAdvance(0), mBounds() {
@@ -109,9 +127,27 @@ class Layout {
 
   void getBounds(MinikinRect* rect) const;
 
+  // An estimate of the heap bytes held by this layout, including itself.
+  size_t getMemoryUsage() const;
+
   // Purge all caches, useful in low memory conditions
   static void purgeCaches();
 
+  // Sets the number of word layouts and HarfBuzz fonts kept by the caches,
+  // evicting the oldest entries of each beyond the new capacity. Zero leaves a
+  // cache unbounded. Defaults to 5000 word layouts and 100 fonts.
+  static void setCacheCapacities(size_t layoutCacheEntries,
+                                 size_t fontCacheEntries);
+
+  // Reports the number of word layouts in the layout cache and an estimate of
+  // the bytes they hold.
+  static void getCacheUsage(size_t* layoutCacheEntries,
+                            size_t* layoutCacheBytes);
+
+  // Consults storage for words missing from the layout cache and adds newly
+  // shaped words to it. Null, the default, disables the second level.
+  static void setCacheStorage(std::shared_ptr<LayoutCacheStorage> storage);
+
  private:
   friend class LayoutCacheKey;
 
@@ -160,6 +196,16 @@ class Layout {
   // Append another layout (for example, cached value) into this one
   void appendLayout(Layout* src, size_t start, float extraAdvance);
 
+  // Encodes the glyphs, advances and bounds for a LayoutCacheStorage. Fonts
+  // are referenced by their index in mFaces.
+  void serialize(std::string* out) const;
+
+  // Restores a layout of count code units encoded by serialize, shaped with
+  // faces. Returns false, leaving the layout untouched, if data is malformed.
+  bool deserialize(const std::string& data,
+                   const std::vector<FakedFont>& faces,
+                   size_t count);
+
   std::vector<LayoutGlyph> mGlyphs;
   std::vector<float> mAdvances;
 
@@ -18,7 +18,9 @@
 
 #define LOG_TAG "Minikin"
 
+#include <algorithm>
 #include <limits>
+#include <numeric>
 
 #include <log/log.h>
 
@@ -120,15 +122,21 @@ float LineBreaker::addStyleRun(MinikinPaint* paint,
                                FontStyle style,
                                size_t start,
                                size_t end,
-                               bool isRtl) {
+                               bool isRtl,
+                               const float* widths) {
   float width = 0.0f;
   int bidiFlags = isRtl ? kBidi_Force_RTL : kBidi_Force_LTR;
 
   float hyphenPenalty = 0.0;
   if (paint != nullptr) {
-    width = Layout::measureText(mTextBuf.data(), start, end - start,
-                                mTextBuf.size(), bidiFlags, style, *paint,
-                                typeface, mCharWidths.data() + start);
+    if (widths != nullptr) {
+      std::copy(widths, widths + (end - start), mCharWidths.begin() + start);
+      width = std::accumulate(widths, widths + (end - start), 0.0f);
+    } else {
+      width = Layout::measureText(mTextBuf.data(), start, end - start,
+                                  mTextBuf.size(), bidiFlags, style, *paint,
+                                  typeface, mCharWidths.data() + start);
+    }
 
     // a heuristic that seems to perform well
     hyphenPenalty =
@@ -164,12 +164,17 @@ class LineBreaker {
   // need to be changed is having some kind of callback (or virtual class, or
   // maybe even template), which could easily be instantiated with Minikin's
   // Layout. Future work for when needed.
+  //
+  // When widths is non-null, it holds the advances of the code units in
+  // [start, end) from an earlier measurement of the same text, and they are
+  // used instead of measuring the text again.
   float addStyleRun(MinikinPaint* paint,
                     const std::shared_ptr<FontCollection>& typeface,
                     FontStyle style,
                     size_t start,
                     size_t end,
-                    bool isRtl);
+                    bool isRtl,
+                    const float* widths = nullptr);
 
   void addReplacement(size_t start, size_t end, float width);
 
@@ -26,15 +26,90 @@
 #include <unicode/uchar.h>
 #include <unicode/utf16.h>
 
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
 namespace minikin {
 
 const uint32_t CHAR_SOFT_HYPHEN = 0x00AD;
 const uint32_t CHAR_ZWJ = 0x200D;
 
+namespace {
+
+// Line break iterators kept for reuse, by locale. Creating an iterator sets up
+// its rule data, which costs far more than pointing a pooled one at new text.
+// Shared by the WordBreakers of all threads.
+class LineBreakIteratorPool {
+ public:
+  static LineBreakIteratorPool& getInstance() {
+    static LineBreakIteratorPool* pool = new LineBreakIteratorPool();
+    return *pool;
+  }
+
+  std::unique_ptr<icu::BreakIterator> acquire(const icu::Locale& locale) {
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      auto found = mPool.find(locale.getName());
+      if (found != mPool.end() && !found->second.empty()) {
+        std::unique_ptr<icu::BreakIterator> iterator =
+            std::move(found->second.back());
+        found->second.pop_back();
+        return iterator;
+      }
+    }
+    UErrorCode status = U_ZERO_ERROR;
+    std::unique_ptr<icu::BreakIterator> iterator(
+        icu::BreakIterator::createLineInstance(locale, status));
+    return U_SUCCESS(status) ? std::move(iterator) : nullptr;
+  }
+
+  void release(const icu::Locale& locale,
+               std::unique_ptr<icu::BreakIterator> iterator) {
+    if (iterator == nullptr)
+      return;
+    // Drop the text, which belongs to the breaker that is done with it.
+    UErrorCode status = U_ZERO_ERROR;
+    UText empty = UTEXT_INITIALIZER;
+    utext_openUChars(&empty, nullptr, 0, &status);
+    iterator->setText(&empty, status);
+    utext_close(&empty);
+    if (U_FAILURE(status))
+      return;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto& iterators = mPool[locale.getName()];
+    if (iterators.size() < kMaxIteratorsPerLocale)
+      iterators.push_back(std::move(iterator));
+  }
+
+ private:
+  // Enough for the paragraphs of one locale being laid out at once.
+  static const size_t kMaxIteratorsPerLocale = 8;
+
+  std::mutex mMutex;
+  std::map<std::string, std::vector<std::unique_ptr<icu::BreakIterator>>>
+      mPool;
+};
+
+}  // namespace
+
+WordBreaker::~WordBreaker() {
+  finish();
+  LineBreakIteratorPool::getInstance().release(mLocale,
+                                               std::move(mBreakIterator));
+}
+
 void WordBreaker::setLocale(const icu::Locale& locale) {
-  UErrorCode status = U_ZERO_ERROR;
-  mBreakIterator.reset(icu::BreakIterator::createLineInstance(locale, status));
+  if (mBreakIterator == nullptr || locale != mLocale) {
+    LineBreakIteratorPool& pool = LineBreakIteratorPool::getInstance();
+    pool.release(mLocale, std::move(mBreakIterator));
+    mBreakIterator = pool.acquire(locale);
+    mLocale = locale;
+  }
   // TODO: handle failure status
+  UErrorCode status = U_ZERO_ERROR;
   if (mText != nullptr) {
     mBreakIterator->setText(&mUText, status);
   }
@@ -30,8 +30,11 @@ namespace minikin {
 
 class WordBreaker {
  public:
-  ~WordBreaker() { finish(); }
+  ~WordBreaker();
 
+  // Takes a line break iterator for |locale| from a pool shared by all
+  // WordBreakers, which the iterator returns to when this breaker is
+  // destroyed or set to another locale.
   void setLocale(const icu::Locale& locale);
 
   void setText(const uint16_t* data, size_t size);
@@ -59,6 +62,7 @@ class WordBreaker {
   ssize_t findNextBreakInEmailOrUrl();
 
   std::unique_ptr<icu::BreakIterator> mBreakIterator;
+  icu::Locale mLocale;
   UText mUText = UTEXT_INITIALIZER;
   const uint16_t* mText = nullptr;
   size_t mTextSize;
@@ -6,6 +6,7 @@
 #include <dirent.h>
 #include <sstream>
 #include "lib/fxl/logging.h"
+#include "third_party/skia/include/core/SkData.h"
 #include "third_party/skia/include/core/SkStream.h"
 #include "third_party/skia/include/core/SkTypeface.h"
 
@@ -37,7 +38,16 @@ DirectoryAssetDataProvider::DirectoryAssetDataProvider(
     std::stringstream file_path;
     file_path << directory_path << "/" << file_name;
 
-    RegisterTypeface(SkTypeface::MakeFromFile(file_path.str().c_str()));
+    // Map the file rather than reading it so that the font's pages are
+    // shared and can be reclaimed by the system.
+    sk_sp<SkData> data = SkData::MakeFromFileName(file_path.str().c_str());
+    if (data == nullptr) {
+      continue;
+    }
+
+    // Ownership of the stream is transferred.
+    RegisterTypeface(
+        SkTypeface::MakeFromStream(new SkMemoryStream(std::move(data))));
   }
 }
 
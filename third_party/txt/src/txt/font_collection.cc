@@ -16,6 +16,7 @@
 
 #include "font_collection.h"
 
+#include <algorithm>
 #include <list>
 #include <memory>
 #include <mutex>
@@ -25,6 +26,8 @@
 #include <vector>
 #include "font_skia.h"
 #include "lib/fxl/logging.h"
+#include "third_party/icu/source/common/unicode/uchar.h"
+#include "third_party/icu/source/common/unicode/utf16.h"
 #include "txt/platform.h"
 #include "txt/text_style.h"
 
@@ -41,6 +44,24 @@ const std::vector<SkUnichar> fallback_characters{
     0x627,    // Arabic
 };
 
+// Returns the BCP 47 tag of the default locale, or an empty string.
+std::string GetDefaultLanguageTag() {
+  char language_tag[ULOC_FULLNAME_CAPACITY];
+  UErrorCode uerr = U_ZERO_ERROR;
+  uloc_toLanguageTag(icu::Locale::getDefault().getName(), language_tag,
+                     ULOC_FULLNAME_CAPACITY, FALSE, &uerr);
+  if (U_FAILURE(uerr))
+    return std::string();
+  return language_tag;
+}
+
+// Code points that are not drawn with a glyph of their own, so they never
+// need a fallback font.
+bool NeedsGlyph(SkUnichar code_point) {
+  return !u_iscntrl(code_point) && !u_isUWhiteSpace(code_point) &&
+         !u_hasBinaryProperty(code_point, UCHAR_DEFAULT_IGNORABLE_CODE_POINT);
+}
+
 }  // anonymous namespace
 
 FontCollection::FontCollection() = default;
@@ -48,6 +69,7 @@ FontCollection::FontCollection() = default;
 FontCollection::~FontCollection() = default;
 
 size_t FontCollection::GetFontManagersCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
   return skia_font_managers_.size();
 }
 
@@ -55,26 +77,71 @@ void FontCollection::PushFront(sk_sp<SkFontMgr> skia_font_manager) {
   if (!skia_font_manager) {
     return;
   }
-  UpdateFallbackFonts(skia_font_manager);
+  std::lock_guard<std::mutex> lock(mutex_);
   skia_font_managers_.push_front(std::move(skia_font_manager));
+  missing_characters_.clear();
 }
 
 void FontCollection::PushBack(sk_sp<SkFontMgr> skia_font_manager) {
   if (!skia_font_manager) {
     return;
   }
-  UpdateFallbackFonts(skia_font_manager);
+  std::lock_guard<std::mutex> lock(mutex_);
   skia_font_managers_.push_back(std::move(skia_font_manager));
+  missing_characters_.clear();
 }
 
 std::shared_ptr<minikin::FontCollection>
 FontCollection::GetMinikinFontCollectionForFamily(const std::string& family) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return GetMinikinFontCollectionForFamilyLocked(family);
+}
+
+std::shared_ptr<minikin::FontCollection>
+FontCollection::GetMinikinFontCollectionForFamilyLocked(
+    const std::string& family) {
   // Look inside the font collections cache first.
   auto cached = font_collections_cache_.find(family);
   if (cached != font_collections_cache_.end()) {
     return cached->second;
   }
 
+  std::shared_ptr<minikin::FontFamily> minikin_family =
+      GetFontFamilyLocked(family);
+  if (minikin_family == nullptr) {
+    const auto default_font_family = GetDefaultFontFamily();
+    if (family != default_font_family) {
+      return GetMinikinFontCollectionForFamilyLocked(default_font_family);
+    }
+
+    // No match found in any of our font managers.
+    return nullptr;
+  }
+
+  // Create a vector of font families for the Minikin font collection.
+  std::vector<std::shared_ptr<minikin::FontFamily>> minikin_families = {
+      minikin_family,
+  };
+  minikin_families.insert(minikin_families.end(), fallback_fonts_.begin(),
+                          fallback_fonts_.end());
+
+  // Create the minikin font collection.
+  auto font_collection =
+      std::make_shared<minikin::FontCollection>(std::move(minikin_families));
+
+  // Cache the font collection for future queries.
+  font_collections_cache_[family] = font_collection;
+
+  return font_collection;
+}
+
+std::shared_ptr<minikin::FontFamily> FontCollection::GetFontFamilyLocked(
+    const std::string& family) {
+  auto cached = font_families_cache_.find(family);
+  if (cached != font_families_cache_.end()) {
+    return cached->second;
+  }
+
   for (sk_sp<SkFontMgr> manager : skia_font_managers_) {
     auto font_style_set = manager->matchFamily(family.c_str());
     if (font_style_set == nullptr || font_style_set->count() == 0) {
@@ -106,57 +173,144 @@ FontCollection::GetMinikinFontCollectionForFamily(const std::string& family) {
     // Create a Minikin font family.
     auto minikin_family =
         std::make_shared<minikin::FontFamily>(std::move(minikin_fonts));
+    font_families_cache_[family] = minikin_family;
+    return minikin_family;
+  }
 
-    // Create a vector of font families for the Minikin font collection.
-    std::vector<std::shared_ptr<minikin::FontFamily>> minikin_families = {
-        minikin_family,
-    };
-    for (const auto& fallback : fallback_fonts_)
-      minikin_families.push_back(fallback.second);
+  return nullptr;
+}
 
-    // Create the minikin font collection.
-    auto font_collection =
-        std::make_shared<minikin::FontCollection>(std::move(minikin_families));
+bool FontCollection::ResolveFallbackFonts(const std::string& family,
+                                          const uint16_t* text,
+                                          size_t count) {
+  std::vector<SkUnichar> unresolved;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::shared_ptr<minikin::FontFamily> minikin_family =
+        GetFontFamilyLocked(family);
+    if (minikin_family == nullptr)
+      minikin_family = GetFontFamilyLocked(GetDefaultFontFamily());
 
-    // Cache the font collection for future queries.
-    font_collections_cache_[family] = font_collection;
+    std::unordered_set<SkUnichar> seen;
+    for (size_t i = 0; i < count;) {
+      SkUnichar code_point;
+      U16_NEXT(text, i, count, code_point);
+      if (NeedsGlyph(code_point) && seen.insert(code_point).second &&
+          !IsResolvedLocked(minikin_family.get(), code_point)) {
+        unresolved.push_back(code_point);
+      }
+    }
+  }
 
-    return font_collection;
+  bool found = false;
+  for (SkUnichar code_point : unresolved) {
+    // An earlier fallback font may cover the later code points too.
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (IsResolvedLocked(nullptr, code_point))
+        continue;
+    }
+    found = FindFallbackFont(code_point) || found;
   }
+  return found;
+}
 
-  const auto default_font_family = GetDefaultFontFamily();
-  if (family != default_font_family) {
-    return GetMinikinFontCollectionForFamily(default_font_family);
+void FontCollection::WarmFallbackFonts() {
+  for (SkUnichar code_point : fallback_characters) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (IsResolvedLocked(nullptr, code_point))
+        continue;
+    }
+    FindFallbackFont(code_point);
   }
+}
 
-  // No match found in any of our font managers.
-  return nullptr;
+std::vector<std::string> FontCollection::GetFallbackFontFamilies() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return fallback_font_families_;
 }
 
-void FontCollection::UpdateFallbackFonts(sk_sp<SkFontMgr> manager) {
-  char language_tag[ULOC_FULLNAME_CAPACITY];
-  UErrorCode uerr;
-  uloc_toLanguageTag(icu::Locale::getDefault().getName(), language_tag,
-                     ULOC_FULLNAME_CAPACITY, FALSE, &uerr);
-  if (U_FAILURE(uerr))
-    return;
-  const char* bcp47[] = {language_tag};
+void FontCollection::AddFallbackFontFamilies(
+    const std::vector<std::string>& families) {
+  std::deque<sk_sp<SkFontMgr>> managers;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    managers = skia_font_managers_;
+  }
 
-  for (SkUnichar fallback_char : fallback_characters) {
-    if (fallback_fonts_.count(fallback_char))
-      continue;
+  for (const std::string& family : families) {
+    for (const sk_sp<SkFontMgr>& manager : managers) {
+      sk_sp<SkTypeface> skia_typeface(
+          manager->matchFamilyStyle(family.c_str(), SkFontStyle()));
+      if (!skia_typeface)
+        continue;
+
+      std::lock_guard<std::mutex> lock(mutex_);
+      AddFallbackFontLocked(std::move(skia_typeface));
+      break;
+    }
+  }
+}
 
+bool FontCollection::IsResolvedLocked(const minikin::FontFamily* family,
+                                      SkUnichar code_point) const {
+  if (family != nullptr && family->getCoverage().get(code_point))
+    return true;
+  for (const auto& fallback : fallback_fonts_) {
+    if (fallback->getCoverage().get(code_point))
+      return true;
+  }
+  return missing_characters_.count(code_point) != 0;
+}
+
+bool FontCollection::FindFallbackFont(SkUnichar code_point) {
+  std::deque<sk_sp<SkFontMgr>> managers;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    managers = skia_font_managers_;
+  }
+
+  const std::string language_tag = GetDefaultLanguageTag();
+  const char* bcp47[] = {language_tag.c_str()};
+  const int bcp47_count = language_tag.empty() ? 0 : 1;
+
+  for (const sk_sp<SkFontMgr>& manager : managers) {
     sk_sp<SkTypeface> skia_typeface(manager->matchFamilyStyleCharacter(
-        0, SkFontStyle(), bcp47, 1, fallback_char));
+        0, SkFontStyle(), bcp47, bcp47_count, code_point));
     if (!skia_typeface)
       continue;
 
-    std::vector<minikin::Font> minikin_fonts;
-    minikin_fonts.emplace_back(std::make_shared<FontSkia>(skia_typeface),
-                               minikin::FontStyle());
-    fallback_fonts_[fallback_char] =
-        std::make_shared<minikin::FontFamily>(std::move(minikin_fonts));
+    std::lock_guard<std::mutex> lock(mutex_);
+    return AddFallbackFontLocked(std::move(skia_typeface));
   }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  missing_characters_.insert(code_point);
+  return false;
+}
+
+bool FontCollection::AddFallbackFontLocked(sk_sp<SkTypeface> typeface) {
+  if (!fallback_font_ids_.insert(typeface->uniqueID()).second)
+    return false;
+
+  SkString family_name;
+  typeface->getFamilyName(&family_name);
+
+  std::vector<minikin::Font> minikin_fonts;
+  minikin_fonts.emplace_back(std::make_shared<FontSkia>(std::move(typeface)),
+                             minikin::FontStyle());
+  fallback_fonts_.push_back(
+      std::make_shared<minikin::FontFamily>(std::move(minikin_fonts)));
+  if (std::find(fallback_font_families_.begin(), fallback_font_families_.end(),
+                family_name.c_str()) == fallback_font_families_.end()) {
+    fallback_font_families_.push_back(family_name.c_str());
+  }
+
+  // Collections are immutable, so the next request rebuilds them with the new
+  // fallback font.
+  font_collections_cache_.clear();
+  return true;
 }
 
 }  // namespace txt
@@ -19,8 +19,11 @@
 
 #include <deque>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include "lib/fxl/macros.h"
 #include "minikin/FontCollection.h"
 #include "minikin/FontFamily.h"
@@ -31,6 +34,11 @@
 
 namespace txt {
 
+// Fallback fonts are not looked up when a font manager is pushed, which would
+// enumerate the system fonts during startup. They are found the first time a
+// paragraph has a code point that no font found so far covers, or ahead of
+// time by WarmFallbackFonts() on a background thread. All methods may be
+// called on any thread.
 class FontCollection {
  public:
   FontCollection();
@@ -46,14 +54,56 @@ class FontCollection {
   std::shared_ptr<minikin::FontCollection> GetMinikinFontCollectionForFamily(
       const std::string& family);
 
+  // Looks up fallback fonts for the code points of text that neither family
+  // nor the fallback fonts found so far cover. Returns true if a fallback font
+  // was found, in which case collections returned before do not include it.
+  bool ResolveFallbackFonts(const std::string& family,
+                            const uint16_t* text,
+                            size_t count);
+
+  // Looks up the fallback fonts of common scripts (emoji, CJK, Hebrew and
+  // Arabic) ahead of time.
+  void WarmFallbackFonts();
+
+  // The family names of the fallback fonts found so far.
+  std::vector<std::string> GetFallbackFontFamilies() const;
+
+  // Adds fallback fonts by family name, for example those a previous launch
+  // found, without matching the system fonts against individual code points.
+  void AddFallbackFontFamilies(const std::vector<std::string>& families);
+
  private:
+  FRIEND_TEST(ParagraphTest, LazyFallbackFontsParagraph);
+
+  mutable std::mutex mutex_;
   std::deque<sk_sp<SkFontMgr>> skia_font_managers_;
   std::unordered_map<std::string, std::shared_ptr<minikin::FontCollection>>
       font_collections_cache_;
-  std::unordered_map<SkUnichar, std::shared_ptr<minikin::FontFamily>>
-      fallback_fonts_;
+  std::unordered_map<std::string, std::shared_ptr<minikin::FontFamily>>
+      font_families_cache_;
+  // In the order they were found.
+  std::vector<std::shared_ptr<minikin::FontFamily>> fallback_fonts_;
+  std::vector<std::string> fallback_font_families_;
+  std::unordered_set<SkFontID> fallback_font_ids_;
+  // Code points that no font manager has a font for.
+  std::unordered_set<SkUnichar> missing_characters_;
+
+  std::shared_ptr<minikin::FontCollection>
+  GetMinikinFontCollectionForFamilyLocked(const std::string& family);
+
+  std::shared_ptr<minikin::FontFamily> GetFontFamilyLocked(
+      const std::string& family);
+
+  // Whether family, where not null, or a fallback font covers code_point, or
+  // whether there is no font for it at all.
+  bool IsResolvedLocked(const minikin::FontFamily* family,
+                        SkUnichar code_point) const;
+
+  // Asks the font managers for a font covering code_point without holding
+  // the lock. Returns true if a new fallback font was added.
+  bool FindFallbackFont(SkUnichar code_point);
 
-  void UpdateFallbackFonts(sk_sp<SkFontMgr> manager);
+  bool AddFallbackFontLocked(sk_sp<SkTypeface> typeface);
 
   FXL_DISALLOW_COPY_AND_ASSIGN(FontCollection);
 };
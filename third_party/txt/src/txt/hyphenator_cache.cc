@@ -0,0 +1,101 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hyphenator_cache.h"
+
+#include <ctype.h>
+
+#include <utility>
+
+#include "lib/fxl/logging.h"
+
+namespace txt {
+namespace {
+
+// The shortest word parts hyphenation leaves at either end of a word.
+const size_t kMinPrefix = 2;
+const size_t kMinSuffix = 2;
+
+// Pattern files are named by lower case tags, such as hyph-en-us.hyb.
+std::string NormalizeLocale(const std::string& locale) {
+  std::string name;
+  name.reserve(locale.size());
+  for (char c : locale)
+    name.push_back(c == '_' ? '-' : tolower(c));
+  return name;
+}
+
+}  // namespace
+
+HyphenatorCache& HyphenatorCache::Get() {
+  static HyphenatorCache* cache = new HyphenatorCache();
+  return *cache;
+}
+
+HyphenatorCache::HyphenatorCache() = default;
+
+HyphenatorCache::~HyphenatorCache() = default;
+
+void HyphenatorCache::SetPatternDirectory(const std::string& directory) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (directory == directory_)
+    return;
+  directory_ = directory;
+  // The new directory may have the patterns that were missing.
+  for (auto it = patterns_.begin(); it != patterns_.end();) {
+    if (!it->second.hyphenator) {
+      it = patterns_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+minikin::Hyphenator* HyphenatorCache::GetHyphenator(
+    const std::string& locale) {
+  std::string name = NormalizeLocale(locale);
+  if (name.empty())
+    return nullptr;
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (directory_.empty())
+    return nullptr;
+  if (minikin::Hyphenator* hyphenator = LoadLocked(name))
+    return hyphenator;
+  size_t separator = name.find('-');
+  if (separator == std::string::npos)
+    return nullptr;
+  return LoadLocked(name.substr(0, separator));
+}
+
+minikin::Hyphenator* HyphenatorCache::LoadLocked(const std::string& name) {
+  auto found = patterns_.find(name);
+  if (found != patterns_.end())
+    return found->second.hyphenator.get();
+
+  Patterns& patterns = patterns_[name];
+  auto mapping = std::make_unique<fml::FileMapping>(directory_ + "/hyph-" +
+                                                    name + ".hyb");
+  if (mapping->GetMapping() == nullptr)
+    return nullptr;
+  FXL_DLOG(INFO) << "Mapped " << mapping->GetSize()
+                 << " bytes of hyphenation patterns for " << name;
+  patterns.hyphenator.reset(minikin::Hyphenator::loadBinary(
+      mapping->GetMapping(), kMinPrefix, kMinSuffix));
+  patterns.mapping = std::move(mapping);
+  return patterns.hyphenator.get();
+}
+
+}  // namespace txt
@@ -0,0 +1,73 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef LIB_TXT_SRC_HYPHENATOR_CACHE_H_
+#define LIB_TXT_SRC_HYPHENATOR_CACHE_H_
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "flutter/fml/mapping.h"
+#include "lib/fxl/macros.h"
+#include "minikin/Hyphenator.h"
+
+namespace txt {
+
+// Loads the hyphenation patterns of a locale the first time a paragraph asks
+// for them, by mapping the hyph-<locale>.hyb file of the pattern directory.
+// The patterns stay mapped for the life of the process and their hyphenators
+// are shared by all paragraphs. All methods may be called on any thread.
+class HyphenatorCache {
+ public:
+  static HyphenatorCache& Get();
+
+  // Sets the directory holding the pattern files, such as the
+  // /system/usr/hyphen-data directory of Android. Locales that were already
+  // loaded keep their patterns.
+  void SetPatternDirectory(const std::string& directory);
+
+  // Returns the hyphenator of |locale|, a tag such as "en-US", or that of its
+  // language if the locale has no patterns of its own. Returns null if
+  // neither has patterns.
+  minikin::Hyphenator* GetHyphenator(const std::string& locale);
+
+ private:
+  struct Patterns {
+    std::unique_ptr<fml::FileMapping> mapping;
+    std::unique_ptr<minikin::Hyphenator> hyphenator;
+  };
+
+  std::mutex mutex_;
+  std::string directory_;
+  // Keyed by the normalized locale. Locales without patterns are kept with a
+  // null hyphenator, so that their files are looked up only once.
+  std::unordered_map<std::string, Patterns> patterns_;
+
+  HyphenatorCache();
+  ~HyphenatorCache();
+
+  // Maps the patterns of |name| unless that was tried before. Called with
+  // mutex_ held.
+  minikin::Hyphenator* LoadLocked(const std::string& name);
+
+  FXL_DISALLOW_COPY_AND_ASSIGN(HyphenatorCache);
+};
+
+}  // namespace txt
+
+#endif  // LIB_TXT_SRC_HYPHENATOR_CACHE_H_
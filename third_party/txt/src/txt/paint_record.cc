@@ -68,4 +68,9 @@ void PaintRecord::SetOffset(SkPoint pt) {
   offset_ = pt;
 }
 
+void PaintRecord::SetStyle(const TextStyle& style) {
+  FXL_DCHECK(style_.layout_equals(style));
+  style_ = style;
+}
+
 }  // namespace txt
@@ -61,6 +61,10 @@ class PaintRecord {
 
   const TextStyle& style() const { return style_; }
 
+  // Replaces the style with one that differs only in painting attributes. The
+  // text blob stays valid.
+  void SetStyle(const TextStyle& style);
+
   size_t line() const { return line_; }
 
   size_t GetRunWidth() const { return run_width_; }
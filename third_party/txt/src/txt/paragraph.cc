@@ -18,6 +18,8 @@
 
 #include <hb.h>
 #include <algorithm>
+#include <atomic>
+#include <functional>
 #include <limits>
 #include <numeric>
 #include <tuple>
@@ -27,7 +29,9 @@
 #include <minikin/Layout.h>
 #include "font_collection.h"
 #include "font_skia.h"
+#include "hyphenator_cache.h"
 #include "lib/fxl/logging.h"
+#include "lib/fxl/synchronization/waitable_event.h"
 #include "minikin/HbFontCache.h"
 #include "minikin/LayoutUtils.h"
 #include "minikin/LineBreaker.h"
@@ -120,6 +124,30 @@ void GetPaint(const TextStyle& style, SkPaint* paint) {
   paint->setTextSize(style.font_size);
 }
 
+// Returns true if the code unit ends a newline-delimited block of text.
+bool IsHardBreak(uint16_t code_unit) {
+  ULineBreak ulb = static_cast<ULineBreak>(
+      u_getIntPropertyValue(code_unit, UCHAR_LINE_BREAK));
+  return ulb == U_LB_LINE_FEED || ulb == U_LB_MANDATORY_BREAK;
+}
+
+// Runs task with each index in [0, count) on task_runner and waits for all of
+// them to finish.
+void RunConcurrently(fxl::TaskRunner* task_runner,
+                     size_t count,
+                     const std::function<void(size_t)>& task) {
+  std::atomic<size_t> remaining(count);
+  fxl::AutoResetWaitableEvent latch;
+  for (size_t index = 0; index < count; ++index) {
+    task_runner->PostTask([index, &task, &remaining, &latch]() {
+      task(index);
+      if (--remaining == 0)
+        latch.Signal();
+    });
+  }
+  latch.Wait();
+}
+
 void FindWords(const std::vector<uint16_t>& text,
                size_t start,
                size_t end,
@@ -140,27 +168,85 @@ void FindWords(const std::vector<uint16_t>& text,
     words->emplace_back(word_start - start, end - start);
 }
 
+// Returns the part of the hyphen edit of a line that applies to its last run.
+// Edits at the start of lines, which only some languages use, are not applied
+// since the glyphs they insert would not map to the text.
+uint32_t GetEndOfLineEdit(uint32_t line_edit) {
+  return minikin::HyphenEdit(line_edit).getEnd();
+}
+
 }  // namespace
 
 static const float kDoubleDecorationSpacing = 3.0f;
 
-Paragraph::GlyphLine::GlyphLine(std::vector<GlyphPosition>&& p, size_t tcu)
-    : positions(std::move(p)), total_code_units(tcu) {}
+// Paragraphs shorter than this are laid out on the calling thread even when a
+// worker task runner is set, as the hand off would cost more than it saves.
+static const size_t kMinConcurrentLayoutCodeUnits = 1024;
+
+// The bytes a laid out code unit typically costs before the paragraph has been
+// laid out: a shaped glyph and advance, a text blob glyph and position, a
+// glyph position and a measured width.
+static const size_t kEstimatedLayoutBytesPerCodeUnit =
+    sizeof(minikin::LayoutGlyph) + sizeof(float) + sizeof(SkGlyphID) +
+    2 * sizeof(SkScalar) + 2 * sizeof(float) + sizeof(uint16_t) +
+    sizeof(float);
+
+void Paragraph::GlyphLine::AddGlyph(double start,
+                                    double advance,
+                                    size_t code_units) {
+  FXL_DCHECK(code_units <= std::numeric_limits<uint16_t>::max());
+  starts_.push_back(start);
+  advances_.push_back(advance);
+  code_units_.push_back(code_units);
+}
 
-const Paragraph::GlyphPosition& Paragraph::GlyphLine::GetGlyphPosition(
-    size_t pos) const {
-  FXL_DCHECK(pos < total_code_units);
-  if (positions.size() == total_code_units)
-    return positions[pos];
+void Paragraph::GlyphLine::Finish(size_t code_unit_start,
+                                  size_t total_code_units) {
+  code_unit_start_ = code_unit_start;
+  total_code_units_ = total_code_units;
+  starts_.shrink_to_fit();
+  advances_.shrink_to_fit();
+  code_units_.shrink_to_fit();
+}
 
-  size_t unit_count = 0;
-  for (const Paragraph::GlyphPosition& gp : positions) {
-    if (pos < unit_count + gp.code_units)
-      return gp;
-    unit_count += gp.code_units;
+const std::vector<uint32_t>& Paragraph::GlyphLine::GetGlyphCodeUnitStarts()
+    const {
+  if (glyph_code_unit_starts_.empty()) {
+    glyph_code_unit_starts_.reserve(size() + 1);
+    uint32_t unit_count = 0;
+    for (uint16_t glyph_code_units : code_units_) {
+      glyph_code_unit_starts_.push_back(unit_count);
+      unit_count += glyph_code_units;
+    }
+    glyph_code_unit_starts_.push_back(unit_count);
   }
+  return glyph_code_unit_starts_;
+}
+
+size_t Paragraph::GlyphLine::GetGlyphIndex(size_t pos) const {
+  FXL_DCHECK(pos < total_code_units_);
+  FXL_DCHECK(!empty());
+  if (HasSingleCodeUnitGlyphs())
+    return pos;
+
+  // The last glyph whose first code unit is at or before pos.
+  const std::vector<uint32_t>& unit_starts = GetGlyphCodeUnitStarts();
+  auto it = std::upper_bound(unit_starts.begin(), unit_starts.end() - 1, pos);
+  return it - unit_starts.begin() - 1;
+}
+
+size_t Paragraph::GlyphLine::GetGlyphCodeUnitStart(size_t index) const {
+  FXL_DCHECK(index <= size());
+  if (HasSingleCodeUnitGlyphs())
+    return index;
+  return GetGlyphCodeUnitStarts()[index];
+}
 
-  return positions.back();
+size_t Paragraph::GlyphLine::GetMemoryUsage() const {
+  return sizeof(GlyphLine) + starts_.capacity() * sizeof(float) +
+         advances_.capacity() * sizeof(float) +
+         code_units_.capacity() * sizeof(uint16_t) +
+         glyph_code_unit_starts_.capacity() * sizeof(uint32_t);
 }
 
 Paragraph::Paragraph() {
@@ -175,85 +261,292 @@ void Paragraph::SetText(std::vector<uint16_t> text, StyledRuns runs) {
     return;
   text_ = std::move(text);
   runs_ = std::move(runs);
+  fallback_fonts_resolved_ = false;
+  ClearShapingCache();
+}
+
+void Paragraph::UpdateStyles(std::vector<uint16_t> text, StyledRuns runs) {
+  bool paint_only = text == text_ && runs.size() == runs_.size();
+  for (size_t i = 0; paint_only && i < runs.size(); ++i) {
+    StyledRuns::Run run = runs.GetRun(i);
+    StyledRuns::Run old_run = runs_.GetRun(i);
+    paint_only = run.start == old_run.start && run.end == old_run.end &&
+                 run.style.layout_equals(old_run.style);
+  }
+  if (!paint_only) {
+    SetText(std::move(text), std::move(runs));
+    return;
+  }
+
+  // The shaped runs, line breaks and text blobs are all still valid.
+  runs_ = std::move(runs);
+  for (size_t i = 0; i < records_.size(); ++i)
+    records_[i].SetStyle(runs_.GetRun(record_runs_[i]).style);
+}
+
+void Paragraph::UpdateText(std::vector<uint16_t> text,
+                           StyledRuns runs,
+                           size_t start,
+                           size_t old_end,
+                           size_t new_end) {
+  if (text.empty() || start > old_end || old_end > text_.size() ||
+      start > new_end || new_end > text.size() ||
+      text_.size() - old_end != text.size() - new_end) {
+    SetText(std::move(text), std::move(runs));
+    return;
+  }
+  needs_layout_ = true;
+  fallback_fonts_resolved_ = false;
+
+  // Widen the edit to the newline-delimited blocks it touches. The text after
+  // the edit is unchanged, so the block end moves with it.
+  size_t block_start = start;
+  while (block_start > 0 && !IsHardBreak(text_[block_start - 1]))
+    block_start--;
+  size_t old_block_end = old_end;
+  while (old_block_end < text_.size() && !IsHardBreak(text_[old_block_end]))
+    old_block_end++;
+  size_t new_block_end = old_block_end - old_end + new_end;
+  auto shift = [old_block_end, new_block_end](size_t position) {
+    return position - old_block_end + new_block_end;
+  };
+
+  if (char_widths_.size() == text_.size()) {
+    char_widths_.erase(char_widths_.begin() + block_start,
+                       char_widths_.begin() + old_block_end);
+    char_widths_.insert(char_widths_.begin() + block_start,
+                        new_block_end - block_start, 0.0f);
+  }
+
+  if (dirty_start_ < dirty_end_) {
+    dirty_start_ = std::min(dirty_start_, block_start);
+    dirty_end_ =
+        (dirty_end_ > old_block_end) ? shift(dirty_end_) : new_block_end;
+  } else {
+    dirty_start_ = block_start;
+    dirty_end_ = new_block_end;
+  }
+
+  // Keep the line breaks and shaped runs of the blocks around the edit,
+  // moving the ones after it to their new positions.
+  std::vector<LineRange> line_ranges;
+  std::vector<double> line_widths;
+  for (size_t i = 0; i < line_ranges_.size(); ++i) {
+    const LineRange& range = line_ranges_[i];
+    if (range.end < block_start) {
+      line_ranges.push_back(range);
+      line_widths.push_back(line_widths_[i]);
+    } else if (range.start > old_block_end) {
+      line_ranges.emplace_back(shift(range.start), shift(range.end),
+                               range.hard_break, range.hyphen_edit);
+      line_widths.push_back(line_widths_[i]);
+    }
+  }
+  line_ranges_ = std::move(line_ranges);
+  line_widths_ = std::move(line_widths);
+
+  std::map<std::pair<size_t, size_t>, minikin::Layout> shaped_runs;
+  for (auto& shaped_run : shaped_runs_) {
+    const std::pair<size_t, size_t>& range = shaped_run.first;
+    if (range.second < block_start) {
+      shaped_runs.emplace(range, std::move(shaped_run.second));
+    } else if (range.first > old_block_end) {
+      shaped_runs.emplace(
+          std::make_pair(shift(range.first), shift(range.second)),
+          std::move(shaped_run.second));
+    }
+  }
+  shaped_runs_ = std::move(shaped_runs);
+
+  text_ = std::move(text);
+  runs_ = std::move(runs);
+}
+
+void Paragraph::ClearShapingCache() {
+  char_widths_.clear();
+  shaped_runs_.clear();
+  line_breaks_width_ = -1;
+  dirty_start_ = 0;
+  dirty_end_ = 0;
 }
 
 bool Paragraph::ComputeLineBreaks() {
+  // Line breaks from the previous layout can be kept for blocks that were not
+  // edited since, as long as the width did not change.
+  std::vector<LineRange> kept_line_ranges;
+  std::vector<double> kept_line_widths;
+  if (line_breaks_width_ == width_) {
+    kept_line_ranges.swap(line_ranges_);
+    kept_line_widths.swap(line_widths_);
+  }
   line_ranges_.clear();
   line_widths_.clear();
+  line_breaks_width_ = -1;
 
   std::vector<size_t> newline_positions;
   for (size_t i = 0; i < text_.size(); ++i) {
-    ULineBreak ulb = static_cast<ULineBreak>(
-        u_getIntPropertyValue(text_[i], UCHAR_LINE_BREAK));
-    if (ulb == U_LB_LINE_FEED || ulb == U_LB_MANDATORY_BREAK)
+    if (IsHardBreak(text_[i]))
       newline_positions.push_back(i);
   }
   newline_positions.push_back(text_.size());
 
+  // The advances measured here only depend on the text and its styles, so
+  // they are measured once and reused when only the width changes.
+  bool measured = (char_widths_.size() == text_.size());
+  if (!measured)
+    char_widths_.assign(text_.size(), 0.0f);
+
+  // Every block either keeps its lines or has them computed by a BlockBreak.
+  // The font collections are resolved here because the txt::FontCollection
+  // may only be used from this thread.
+  std::vector<BlockBreak> block_breaks(newline_positions.size());
+  std::vector<BlockBreak*> pending_breaks;
+  size_t pending_code_units = 0;
   size_t run_index = 0;
+  size_t kept_line = 0;
   for (size_t newline_index = 0; newline_index < newline_positions.size();
        ++newline_index) {
-    size_t block_start =
+    BlockBreak& block = block_breaks[newline_index];
+    block.start =
         (newline_index > 0) ? newline_positions[newline_index - 1] + 1 : 0;
-    size_t block_end = newline_positions[newline_index];
-    size_t block_size = block_end - block_start;
+    block.end = newline_positions[newline_index];
 
-    if (block_size == 0) {
-      line_ranges_.emplace_back(block_start, block_start, true);
-      line_widths_.push_back(0);
+    if (block.start == block.end) {
+      block.line_ranges.emplace_back(block.start, block.start, true);
+      block.line_widths.push_back(0);
       continue;
     }
 
-    breaker_.setLineWidths(0.0f, 0, width_);
-    breaker_.setJustified(paragraph_style_.text_align == TextAlign::justify);
-    breaker_.setStrategy(paragraph_style_.break_strategy);
-    breaker_.resize(block_size);
-    memcpy(breaker_.buffer(), text_.data() + block_start,
-           block_size * sizeof(text_[0]));
-    breaker_.setText();
+    block.measure =
+        !measured || (dirty_start_ < dirty_end_ && block.start < dirty_end_ &&
+                      block.end > dirty_start_);
+
+    if (!block.measure) {
+      // Look for the kept lines covering exactly this block.
+      while (kept_line < kept_line_ranges.size() &&
+             kept_line_ranges[kept_line].start < block.start)
+        kept_line++;
+      size_t last_line = kept_line;
+      while (last_line < kept_line_ranges.size() &&
+             kept_line_ranges[last_line].end < block.end)
+        last_line++;
+      if (kept_line < kept_line_ranges.size() &&
+          kept_line_ranges[kept_line].start == block.start &&
+          last_line < kept_line_ranges.size() &&
+          kept_line_ranges[last_line].end == block.end &&
+          kept_line_ranges[last_line].hard_break) {
+        block.line_ranges.assign(kept_line_ranges.begin() + kept_line,
+                                 kept_line_ranges.begin() + last_line + 1);
+        block.line_widths.assign(kept_line_widths.begin() + kept_line,
+                                 kept_line_widths.begin() + last_line + 1);
+        kept_line = last_line + 1;
+
+        // Skip the runs that the LineBreaker would have been given.
+        while (run_index < runs_.size()) {
+          StyledRuns::Run run = runs_.GetRun(run_index);
+          if (run.start >= block.end || run.end > block.end)
+            break;
+          run_index++;
+        }
+        continue;
+      }
+    }
 
-    // Add the runs that include this line to the LineBreaker.
+    // Collect the runs that include this block for the LineBreaker.
     while (run_index < runs_.size()) {
       StyledRuns::Run run = runs_.GetRun(run_index);
-      if (run.start >= block_end)
+      if (run.start >= block.end)
         break;
 
-      minikin::FontStyle font;
-      minikin::MinikinPaint paint;
-      GetFontAndMinikinPaint(run.style, &font, &paint);
-      std::shared_ptr<minikin::FontCollection> collection =
+      BlockBreak::Run break_run;
+      GetFontAndMinikinPaint(run.style, &break_run.font, &break_run.paint);
+      break_run.collection =
           font_collection_->GetMinikinFontCollectionForFamily(
               run.style.font_family);
-      if (collection == nullptr) {
+      if (break_run.collection == nullptr) {
         FXL_LOG(INFO) << "Could not find font collection for family \""
                       << run.style.font_family << "\".";
+        char_widths_.clear();
         return false;
       }
-      size_t run_start = std::max(run.start, block_start) - block_start;
-      size_t run_end = std::min(run.end, block_end) - block_start;
-      bool isRtl = (paragraph_style_.text_direction == TextDirection::rtl);
-      breaker_.addStyleRun(&paint, collection, font, run_start, run_end, isRtl);
+      break_run.start = std::max(run.start, block.start) - block.start;
+      break_run.end = std::min(run.end, block.end) - block.start;
+      block.runs.push_back(std::move(break_run));
 
-      if (run.end > block_end)
+      if (run.end > block.end)
         break;
       run_index++;
     }
 
-    size_t breaks_count = breaker_.computeBreaks();
-    const int* breaks = breaker_.getBreaks();
-    for (size_t i = 0; i < breaks_count; ++i) {
-      size_t break_start = (i > 0) ? breaks[i - 1] : 0;
-      line_ranges_.emplace_back(break_start + block_start,
-                                breaks[i] + block_start, i == breaks_count - 1);
-      line_widths_.push_back(breaker_.getWidths()[i]);
-    }
+    pending_breaks.push_back(&block);
+    pending_code_units += block.end - block.start;
+  }
+
+  if (worker_task_runner_ && pending_breaks.size() > 1 &&
+      pending_code_units >= kMinConcurrentLayoutCodeUnits) {
+    // LineBreaker keeps per block state, so each task uses its own.
+    RunConcurrently(worker_task_runner_.get(), pending_breaks.size(),
+                    [this, &pending_breaks](size_t index) {
+                      minikin::LineBreaker breaker;
+                      breaker.setLocale(locale_, hyphenator_);
+                      BreakBlock(&breaker, pending_breaks[index]);
+                    });
+  } else {
+    for (BlockBreak* block : pending_breaks)
+      BreakBlock(&breaker_, block);
+  }
 
-    breaker_.finish();
+  for (BlockBreak& block : block_breaks) {
+    line_ranges_.insert(line_ranges_.end(), block.line_ranges.begin(),
+                        block.line_ranges.end());
+    line_widths_.insert(line_widths_.end(), block.line_widths.begin(),
+                        block.line_widths.end());
   }
 
+  dirty_start_ = 0;
+  dirty_end_ = 0;
+  line_breaks_width_ = width_;
   return true;
 }
 
+void Paragraph::BreakBlock(minikin::LineBreaker* breaker, BlockBreak* block) {
+  size_t block_size = block->end - block->start;
+  breaker->setLineWidths(0.0f, 0, width_);
+  breaker->setJustified(paragraph_style_.text_align == TextAlign::justify);
+  breaker->setStrategy(paragraph_style_.break_strategy);
+  breaker->setHyphenationFrequency(paragraph_style_.hyphenation_frequency);
+  breaker->resize(block_size);
+  memcpy(breaker->buffer(), text_.data() + block->start,
+         block_size * sizeof(text_[0]));
+  breaker->setText();
+
+  bool isRtl = (paragraph_style_.text_direction == TextDirection::rtl);
+  for (BlockBreak::Run& run : block->runs) {
+    const float* widths =
+        block->measure ? nullptr
+                       : char_widths_.data() + block->start + run.start;
+    breaker->addStyleRun(&run.paint, run.collection, run.font, run.start,
+                         run.end, isRtl, widths);
+  }
+
+  if (block->measure) {
+    std::copy(breaker->charWidths(), breaker->charWidths() + block_size,
+              char_widths_.begin() + block->start);
+  }
+
+  size_t breaks_count = breaker->computeBreaks();
+  const int* breaks = breaker->getBreaks();
+  for (size_t i = 0; i < breaks_count; ++i) {
+    size_t break_start = (i > 0) ? breaks[i - 1] : 0;
+    block->line_ranges.emplace_back(
+        break_start + block->start, breaks[i] + block->start,
+        i == breaks_count - 1, breaker->getFlags()[i]);
+    block->line_widths.push_back(breaker->getWidths()[i]);
+  }
+
+  breaker->finish();
+}
+
 void Paragraph::Layout(double width, bool force) {
   // Do not allow calling layout multiple times without changing anything.
   if (!needs_layout_ && width == width_ && !force) {
@@ -261,6 +554,16 @@ void Paragraph::Layout(double width, bool force) {
   }
   needs_layout_ = false;
 
+  if (force)
+    ClearShapingCache();
+
+  // Text shaped before a new fallback font was found would not use it.
+  if (!fallback_fonts_resolved_) {
+    fallback_fonts_resolved_ = true;
+    if (ResolveFallbackFonts())
+      ClearShapingCache();
+  }
+
   width_ = width;
 
   if (!ComputeLineBreaks()) {
@@ -273,10 +576,14 @@ void Paragraph::Layout(double width, bool force) {
   paint.setSubpixelText(true);
 
   records_.clear();
+  record_runs_.clear();
+  text_blob_bytes_ = 0;
   line_heights_.clear();
   glyph_position_x_.clear();
 
-  minikin::Layout layout;
+  // Shaped runs that are still used by this layout move from shaped_runs_
+  // into here, and the rest are dropped at the end.
+  std::map<std::pair<size_t, size_t>, minikin::Layout> shaped_runs;
   SkTextBlobBuilder builder;
   size_t run_index = 0;
   double y_offset = 0;
@@ -286,6 +593,9 @@ void Paragraph::Layout(double width, bool force) {
   size_t line_limit = std::min(paragraph_style_.max_lines, line_ranges_.size());
   did_exceed_max_lines_ = (line_ranges_.size() > paragraph_style_.max_lines);
 
+  if (worker_task_runner_)
+    ShapeRunsConcurrently(line_limit);
+
   for (size_t line_number = 0; line_number < line_limit; ++line_number) {
     const LineRange& line_range = line_ranges_[line_number];
 
@@ -306,6 +616,7 @@ void Paragraph::Layout(double width, bool force) {
 
     // Find the runs comprising this line.
     std::vector<StyledRuns::Run> line_runs;
+    const size_t line_first_run = run_index;
     while (run_index < runs_.size()) {
       StyledRuns::Run run = runs_.GetRun(run_index);
       if (run.start >= line_range.end)
@@ -316,7 +627,7 @@ void Paragraph::Layout(double width, bool force) {
       run_index++;
     }
 
-    std::vector<GlyphPosition> glyph_single_line_position_x;
+    GlyphLine glyph_single_line_position_x;
     double run_x_offset = GetLineXOffset(line_number);
     std::vector<PaintRecord> paint_records;
 
@@ -346,13 +657,13 @@ void Paragraph::Layout(double width, bool force) {
       if (ellipsis.length() && !isinf(width_) && !line_range.hard_break &&
           (line_number == line_limit - 1 ||
            paragraph_style_.max_lines == std::numeric_limits<size_t>::max())) {
-        float ellipsis_width = layout.measureText(
+        float ellipsis_width = minikin::Layout::measureText(
             reinterpret_cast<const uint16_t*>(ellipsis.data()), 0,
             ellipsis.length(), ellipsis.length(), bidiFlags, font,
             minikin_paint, minikin_font_collection, nullptr);
 
         std::vector<float> text_advances(text_count);
-        float text_width = layout.measureText(
+        float text_width = minikin::Layout::measureText(
             text_ptr, 0, text_count, text_count, bidiFlags, font, minikin_paint,
             minikin_font_collection, text_advances.data());
 
@@ -382,8 +693,30 @@ void Paragraph::Layout(double width, bool force) {
         }
       }
 
-      layout.doLayout(text_ptr, 0, text_count, text_count, bidiFlags, font,
-                      minikin_paint, minikin_font_collection);
+      // Shaping does not depend on the width, so a run covering the same text
+      // as in the previous layout is reused as is.
+      minikin::Layout ellipsized_layout;
+      minikin::Layout* run_layout = &ellipsized_layout;
+      if (ellipsized_text.empty()) {
+        if (line_run_end == line_range.end)
+          minikin_paint.hyphenEdit = GetEndOfLineEdit(line_range.hyphen_edit);
+        auto key = std::make_pair(line_run_start, line_run_end);
+        auto cached = shaped_runs_.find(key);
+        if (cached != shaped_runs_.end()) {
+          auto it = shaped_runs.emplace(key, std::move(cached->second)).first;
+          run_layout = &it->second;
+        } else {
+          auto it = shaped_runs.emplace(key, minikin::Layout()).first;
+          it->second.doLayout(text_ptr, 0, text_count, text_count, bidiFlags,
+                              font, minikin_paint, minikin_font_collection);
+          run_layout = &it->second;
+        }
+      } else {
+        ellipsized_layout.doLayout(text_ptr, 0, text_count, text_count,
+                                   bidiFlags, font, minikin_paint,
+                                   minikin_font_collection);
+      }
+      const minikin::Layout& layout = *run_layout;
 
       // Break the layout into blobs that share the same SkPaint parameters.
       std::vector<Range> glyph_blobs;
@@ -401,6 +734,8 @@ void Paragraph::Layout(double width, bool force) {
         paint.setTypeface(GetTypefaceForGlyph(layout, glyph_blob.start));
         const SkTextBlobBuilder::RunBuffer& blob_buffer =
             builder.allocRunPos(paint, glyph_blob.end - glyph_blob.start);
+        text_blob_bytes_ += (glyph_blob.end - glyph_blob.start) *
+                            (sizeof(SkGlyphID) + 2 * sizeof(SkScalar));
 
         for (size_t glyph_index = glyph_blob.start;
              glyph_index < glyph_blob.end; ++glyph_index) {
@@ -412,6 +747,10 @@ void Paragraph::Layout(double width, bool force) {
           blob_buffer.pos[pos_index] = glyph_x_offset;
           blob_buffer.pos[pos_index + 1] = layout.getY(glyph_index);
 
+          // A hyphen added at the end of the line covers no text.
+          if (code_unit_index >= text_count)
+            continue;
+
           if (word_index < words.size() &&
               code_unit_index == words[word_index].start) {
             word_start_position = run_x_offset + glyph_x_offset;
@@ -436,14 +775,15 @@ void Paragraph::Layout(double width, bool force) {
           }
           float subglyph_advance =
               glyph_advance / subglyph_code_unit_counts.size();
-          glyph_single_line_position_x.emplace_back(
-              run_x_offset + glyph_x_offset, subglyph_advance,
-              subglyph_code_unit_counts[0]);
+          glyph_single_line_position_x.AddGlyph(run_x_offset + glyph_x_offset,
+                                                subglyph_advance,
+                                                subglyph_code_unit_counts[0]);
 
           // Compute positions for the additional characters in the ligature.
           for (size_t i = 1; i < subglyph_code_unit_counts.size(); ++i) {
-            glyph_single_line_position_x.emplace_back(
-                glyph_single_line_position_x.back().start + subglyph_advance,
+            glyph_single_line_position_x.AddGlyph(
+                glyph_single_line_position_x.glyph_end(
+                    glyph_single_line_position_x.size() - 1),
                 subglyph_advance, subglyph_code_unit_counts[i]);
           }
 
@@ -455,7 +795,8 @@ void Paragraph::Layout(double width, bool force) {
 
             if (!isnan(word_start_position)) {
               double word_width =
-                  glyph_single_line_position_x.back().glyph_end() -
+                  glyph_single_line_position_x.glyph_end(
+                      glyph_single_line_position_x.size() - 1) -
                   word_start_position;
               max_word_width = std::max(word_width, max_word_width);
               word_start_position = std::numeric_limits<double>::quiet_NaN();
@@ -466,6 +807,7 @@ void Paragraph::Layout(double width, bool force) {
 
       SkPaint::FontMetrics metrics;
       paint.getFontMetrics(&metrics);
+      text_blob_bytes_ += sizeof(SkTextBlob);
       paint_records.emplace_back(run.style, SkPoint::Make(run_x_offset, 0),
                                  builder.make(), metrics, line_number,
                                  layout.getAdvance());
@@ -501,19 +843,29 @@ void Paragraph::Layout(double width, bool force) {
     y_offset += roundf(max_line_spacing + prev_max_descent);
     prev_max_descent = max_descent;
 
-    for (PaintRecord& paint_record : paint_records) {
+    for (size_t i = 0; i < paint_records.size(); ++i) {
+      PaintRecord& paint_record = paint_records[i];
       paint_record.SetOffset(
           SkPoint::Make(paint_record.offset().x(), y_offset));
       records_.emplace_back(std::move(paint_record));
+      record_runs_.push_back(line_first_run + i);
     }
 
     size_t next_line_start = (line_number < line_ranges_.size() - 1)
                                  ? line_ranges_[line_number + 1].start
                                  : text_.size();
-    glyph_position_x_.emplace_back(std::move(glyph_single_line_position_x),
-                                   next_line_start - line_range.start);
+    size_t line_code_unit_start =
+        glyph_position_x_.empty() ? 0
+                                  : glyph_position_x_.back().code_unit_start() +
+                                        glyph_position_x_.back()
+                                            .total_code_units();
+    glyph_single_line_position_x.Finish(line_code_unit_start,
+                                        next_line_start - line_range.start);
+    glyph_position_x_.push_back(std::move(glyph_single_line_position_x));
   }
 
+  shaped_runs_ = std::move(shaped_runs);
+
   max_intrinsic_width_ = 0;
   for (double line_width : line_widths_) {
     max_intrinsic_width_ += line_width;
@@ -521,6 +873,73 @@ void Paragraph::Layout(double width, bool force) {
   min_intrinsic_width_ = std::min(max_word_width, max_intrinsic_width_);
 }
 
+void Paragraph::ShapeRunsConcurrently(size_t line_limit) {
+  struct RunShape {
+    std::pair<size_t, size_t> range;
+    minikin::FontStyle font;
+    minikin::MinikinPaint paint;
+    std::shared_ptr<minikin::FontCollection> collection;
+    minikin::Layout layout;
+  };
+  std::vector<RunShape> shapes;
+  size_t shape_code_units = 0;
+
+  size_t run_index = 0;
+  for (size_t line_number = 0; line_number < line_limit; ++line_number) {
+    const LineRange& line_range = line_ranges_[line_number];
+
+    // Ellipsized lines are shaped with the ellipsis in Layout(), and may end
+    // the layout early.
+    if (paragraph_style_.ellipsis.length() && !isinf(width_) &&
+        !line_range.hard_break &&
+        (line_number == line_limit - 1 ||
+         paragraph_style_.max_lines == std::numeric_limits<size_t>::max()))
+      break;
+
+    while (run_index < runs_.size()) {
+      StyledRuns::Run run = runs_.GetRun(run_index);
+      if (run.start >= line_range.end)
+        break;
+
+      auto range = std::make_pair(std::max(run.start, line_range.start),
+                                  std::min(run.end, line_range.end));
+      if (shaped_runs_.find(range) == shaped_runs_.end()) {
+        shapes.emplace_back();
+        RunShape& shape = shapes.back();
+        shape.range = range;
+        GetFontAndMinikinPaint(run.style, &shape.font, &shape.paint);
+        if (range.second == line_range.end)
+          shape.paint.hyphenEdit = GetEndOfLineEdit(line_range.hyphen_edit);
+        shape.collection = font_collection_->GetMinikinFontCollectionForFamily(
+            run.style.font_family);
+        shape_code_units += range.second - range.first;
+      }
+
+      if (run.end > line_range.end)
+        break;
+      run_index++;
+    }
+  }
+
+  if (shapes.size() < 2 || shape_code_units < kMinConcurrentLayoutCodeUnits)
+    return;
+
+  int bidiFlags = (paragraph_style_.text_direction == TextDirection::rtl)
+                      ? minikin::kBidi_RTL
+                      : minikin::kBidi_LTR;
+  RunConcurrently(worker_task_runner_.get(), shapes.size(),
+                  [this, &shapes, bidiFlags](size_t index) {
+                    RunShape& shape = shapes[index];
+                    size_t count = shape.range.second - shape.range.first;
+                    shape.layout.doLayout(text_.data() + shape.range.first, 0,
+                                          count, count, bidiFlags, shape.font,
+                                          shape.paint, shape.collection);
+                  });
+
+  for (RunShape& shape : shapes)
+    shaped_runs_.emplace(shape.range, std::move(shape.layout));
+}
+
 double Paragraph::GetLineXOffset(size_t line) {
   if (line >= line_widths_.size() || isinf(width_))
     return 0;
@@ -565,6 +984,25 @@ size_t Paragraph::TextSize() const {
   return text_.size();
 }
 
+size_t Paragraph::GetMemoryUsage() const {
+  size_t bytes = sizeof(Paragraph) + text_.capacity() * sizeof(uint16_t) +
+                 runs_.GetMemoryUsage();
+  if (width_ < 0)
+    return bytes + text_.size() * kEstimatedLayoutBytesPerCodeUnit;
+
+  bytes += line_ranges_.capacity() * sizeof(LineRange) +
+           line_widths_.capacity() * sizeof(double) +
+           line_heights_.capacity() * sizeof(double) +
+           char_widths_.capacity() * sizeof(float);
+  bytes += records_.capacity() * sizeof(PaintRecord) +
+           record_runs_.capacity() * sizeof(size_t) + text_blob_bytes_;
+  for (const GlyphLine& line : glyph_position_x_)
+    bytes += line.GetMemoryUsage();
+  for (const auto& shaped_run : shaped_runs_)
+    bytes += shaped_run.second.getMemoryUsage();
+  return bytes;
+}
+
 double Paragraph::GetHeight() const {
   return line_heights_.size() ? line_heights_.back() : 0;
 }
@@ -576,11 +1014,38 @@ double Paragraph::GetMaxWidth() const {
 void Paragraph::SetParagraphStyle(const ParagraphStyle& style) {
   needs_layout_ = true;
   paragraph_style_ = style;
+  locale_ = style.locale.empty() ? icu::Locale()
+                                 : icu::Locale(style.locale.c_str());
+  hyphenator_ =
+      style.hyphenation_frequency == minikin::kHyphenationFrequency_None
+          ? nullptr
+          : HyphenatorCache::Get().GetHyphenator(style.locale);
+  breaker_.setLocale(locale_, hyphenator_);
+  ClearShapingCache();
+}
+
+void Paragraph::SetWorkerTaskRunner(
+    fxl::RefPtr<fxl::TaskRunner> worker_task_runner) {
+  worker_task_runner_ = std::move(worker_task_runner);
 }
 
 void Paragraph::SetFontCollection(
     std::shared_ptr<FontCollection> font_collection) {
   font_collection_ = std::move(font_collection);
+  fallback_fonts_resolved_ = false;
+  ClearShapingCache();
+}
+
+bool Paragraph::ResolveFallbackFonts() {
+  bool found = false;
+  for (size_t i = 0; i < runs_.size(); ++i) {
+    StyledRuns::Run run = runs_.GetRun(i);
+    found = font_collection_->ResolveFallbackFonts(run.style.font_family,
+                                                   text_.data() + run.start,
+                                                   run.end - run.start) ||
+            found;
+  }
+  return found;
 }
 
 // The x,y coordinates will be the very top left corner of the rendered
@@ -764,37 +1229,21 @@ std::vector<SkRect> Paragraph::GetRectsForRange(size_t start,
   if (end <= start || start == end)
     return rects;
 
-  size_t pos = 0;
-  size_t line;
-  for (line = 0; line < glyph_position_x_.size(); ++line) {
-    if (start < pos + glyph_position_x_[line].total_code_units)
+  // The first line that ends after start.
+  auto line_it = std::upper_bound(
+      glyph_position_x_.begin(), glyph_position_x_.end(), start,
+      [](size_t pos, const GlyphLine& line) {
+        return pos < line.code_unit_start() + line.total_code_units();
+      });
+
+  for (; line_it != glyph_position_x_.end(); ++line_it) {
+    size_t line = line_it - glyph_position_x_.begin();
+    size_t line_start = line_it->code_unit_start();
+    if (end <= line_start)
       break;
-    pos += glyph_position_x_[line].total_code_units;
-  }
-  if (line == glyph_position_x_.size())
-    return rects;
-
-  if (end <= pos + glyph_position_x_[line].total_code_units) {
-    rects.push_back(GetRectForLineRange(line, start - pos, end - pos));
-    return rects;
-  }
-
-  rects.push_back(GetRectForLineRange(
-      line, start - pos, glyph_position_x_[line].total_code_units));
-
-  while (true) {
-    pos += glyph_position_x_[line].total_code_units;
-    line++;
-    if (line == glyph_position_x_.size())
-      break;
-
-    if (end <= pos + glyph_position_x_[line].total_code_units) {
-      rects.push_back(GetRectForLineRange(line, 0, end - pos));
-      break;
-    } else {
-      rects.push_back(GetRectForLineRange(
-          line, 0, glyph_position_x_[line].total_code_units));
-    }
+    rects.push_back(GetRectForLineRange(
+        line, start > line_start ? start - line_start : 0,
+        std::min(end - line_start, line_it->total_code_units())));
   }
 
   return rects;
@@ -805,13 +1254,13 @@ SkRect Paragraph::GetRectForLineRange(size_t line,
                                       size_t end) const {
   FXL_DCHECK(line < glyph_position_x_.size());
   const GlyphLine& glyph_line = glyph_position_x_[line];
-  if (glyph_line.positions.empty())
+  if (glyph_line.empty())
     return SkRect::MakeEmpty();
 
-  FXL_DCHECK(start < glyph_line.total_code_units);
-  SkScalar left = glyph_line.GetGlyphPosition(start).start;
-  end = std::min(end, glyph_line.total_code_units);
-  SkScalar right = glyph_line.GetGlyphPosition(end - 1).glyph_end();
+  FXL_DCHECK(start < glyph_line.total_code_units());
+  SkScalar left = glyph_line.start(glyph_line.GetGlyphIndex(start));
+  end = std::min(end, glyph_line.total_code_units());
+  SkScalar right = glyph_line.glyph_end(glyph_line.GetGlyphIndex(end - 1));
   SkScalar top = (line > 0) ? line_heights_[line - 1] : 0;
   SkScalar bottom = line_heights_[line];
   return SkRect::MakeLTRB(left, top, right, bottom);
@@ -824,33 +1273,35 @@ Paragraph::PositionWithAffinity Paragraph::GetGlyphPositionAtCoordinate(
   if (line_heights_.empty())
     return PositionWithAffinity(0, DOWNSTREAM);
 
-  size_t offset = 0;
-  size_t y_index;
-  for (y_index = 0; y_index < line_heights_.size() - 1; ++y_index) {
-    if (dy < line_heights_[y_index])
-      break;
-    offset += glyph_position_x_[y_index].total_code_units;
-  }
+  // The first line whose bottom is below dy, or the last line.
+  size_t y_index =
+      std::upper_bound(line_heights_.begin(), line_heights_.end() - 1, dy) -
+      line_heights_.begin();
 
-  const std::vector<GlyphPosition>& line_glyph_position =
-      glyph_position_x_[y_index].positions;
-  size_t x_index;
-  for (x_index = 0; x_index < line_glyph_position.size(); ++x_index) {
+  const GlyphLine& line_glyph_position = glyph_position_x_[y_index];
+  auto boundary = [&](size_t x_index) {
     double glyph_end = (x_index < line_glyph_position.size() - 1)
-                           ? line_glyph_position[x_index + 1].start
-                           : line_glyph_position[x_index].glyph_end();
-    double boundary;
-    if (using_glyph_center_as_boundary) {
-      boundary = (line_glyph_position[x_index].start + glyph_end) / 2.0f;
+                           ? line_glyph_position.start(x_index + 1)
+                           : line_glyph_position.glyph_end(x_index);
+    if (using_glyph_center_as_boundary)
+      return (line_glyph_position.start(x_index) + glyph_end) / 2.0f;
+    return glyph_end;
+  };
+
+  // The first glyph whose boundary is after dx.
+  size_t x_index = 0;
+  size_t x_end = line_glyph_position.size();
+  while (x_index < x_end) {
+    size_t mid = x_index + (x_end - x_index) / 2;
+    if (dx < boundary(mid)) {
+      x_end = mid;
     } else {
-      boundary = glyph_end;
+      x_index = mid + 1;
     }
-
-    if (dx < boundary)
-      break;
-
-    offset += line_glyph_position[x_index].code_units;
   }
+
+  size_t offset = line_glyph_position.code_unit_start() +
+                  line_glyph_position.GetGlyphCodeUnitStart(x_index);
   return PositionWithAffinity(offset, x_index > 0 ? UPSTREAM : DOWNSTREAM);
 }
 
@@ -17,6 +17,7 @@
 #ifndef LIB_TXT_SRC_PARAGRAPH_H_
 #define LIB_TXT_SRC_PARAGRAPH_H_
 
+#include <map>
 #include <set>
 #include <tuple>
 #include <vector>
@@ -24,6 +25,8 @@
 #include "font_collection.h"
 #include "lib/fxl/compiler_specific.h"
 #include "lib/fxl/macros.h"
+#include "lib/fxl/tasks/task_runner.h"
+#include "minikin/Layout.h"
 #include "minikin/LineBreaker.h"
 #include "paint_record.h"
 #include "paragraph_style.h"
@@ -71,6 +74,15 @@ class Paragraph {
   //
   // Layout calculates the positioning of all the glyphs. Must call this method
   // before Painting and getting any statistics from this class.
+  //
+  // The results of shaping the text do not depend on the width, so they are
+  // kept between calls. Calling Layout() again with only a new width re-runs
+  // line breaking and positioning and only shapes lines whose text range
+  // changed. Passing force discards the kept shaping results.
+  //
+  // After an edit made through ParagraphBuilder::Update(), only the
+  // newline-delimited blocks touched by the edit are measured, broken into
+  // lines and shaped again.
   void Layout(double width, bool force = false);
 
   // Paints the Laid out text onto the supplied SkCanvas at (x, y) offset from
@@ -83,6 +95,15 @@ class Paragraph {
   // Returns the number of characters/unicode characters. AKA text_.size()
   size_t TextSize() const;
 
+  // Returns the bytes held by the text, styles and layout of the paragraph.
+  // Before the first Layout() the layout is estimated from the length of the
+  // text, so that the size is meaningful as soon as the paragraph is built.
+  size_t GetMemoryUsage() const;
+
+  // Returns the bytes held by the text blobs of the most recent Layout(),
+  // which pictures the paragraph is painted into keep alive.
+  size_t GetTextBlobMemoryUsage() const { return text_blob_bytes_; }
+
   // Returns the height of the laid out paragraph. NOTE this is not a tight
   // bounding height of the glyphs, as some glyphs do not reach as low as they
   // can.
@@ -149,6 +170,12 @@ class Paragraph {
   // Layout from being calculated by setting to false.
   void SetDirty(bool dirty = true);
 
+  // Lets Layout() break and shape the newline-delimited blocks of long
+  // paragraphs concurrently on the given task runner, whose tasks may run in
+  // parallel. Layout() blocks until they are done, so the runner must not be
+  // serviced by the thread calling Layout(). Null lays out serially.
+  void SetWorkerTaskRunner(fxl::RefPtr<fxl::TaskRunner> worker_task_runner);
+
  private:
   friend class ParagraphBuilder;
   FRIEND_TEST(ParagraphTest, SimpleParagraph);
@@ -172,6 +199,16 @@ class Paragraph {
   FRIEND_TEST(ParagraphTest, HyphenBreakParagraph);
   FRIEND_TEST(ParagraphTest, RepeatLayoutParagraph);
   FRIEND_TEST(ParagraphTest, Ellipsize);
+  FRIEND_TEST(ParagraphTest, WidthOnlyRelayoutParagraph);
+  FRIEND_TEST(ParagraphTest, IncrementalRelayoutParagraph);
+  FRIEND_TEST(ParagraphTest, ConcurrentLayoutParagraph);
+  FRIEND_TEST(ParagraphTest, LayoutCacheStorageParagraph);
+  FRIEND_TEST(ParagraphTest, PaintOnlyRestyleParagraph);
+  FRIEND_TEST(ParagraphTest, LazyFallbackFontsParagraph);
+  FRIEND_TEST(ParagraphTest, CompactGlyphPositionsParagraph);
+  FRIEND_TEST(ParagraphTest, LongParagraphHitTesting);
+  FRIEND_TEST(ParagraphTest, Utf8TextMatchesIcu);
+  FRIEND_TEST(ParagraphTest, HyphenationWithoutPatternsParagraph);
 
   // Starting data to layout.
   std::vector<uint16_t> text_;
@@ -180,45 +217,116 @@ class Paragraph {
   std::shared_ptr<FontCollection> font_collection_;
 
   minikin::LineBreaker breaker_;
+  // The locale and hyphenator of paragraph_style_, which the line breakers
+  // are set to.
+  icu::Locale locale_;
+  minikin::Hyphenator* hyphenator_ = nullptr;
 
   struct LineRange {
-    LineRange(size_t s, size_t e, bool h) : start(s), end(e), hard_break(h) {}
+    LineRange(size_t s, size_t e, bool h, uint32_t edit = 0)
+        : start(s), end(e), hard_break(h), hyphen_edit(edit) {}
     size_t start, end;
     bool hard_break;
+    // The minikin::HyphenEdit of a line broken inside a word.
+    uint32_t hyphen_edit;
   };
   std::vector<LineRange> line_ranges_;
   std::vector<double> line_widths_;
 
+  // The width that line_ranges_ were computed for, or -1 if they can not be
+  // reused by the next layout.
+  double line_breaks_width_ = -1;
+
   // Stores the result of Layout().
   std::vector<PaintRecord> records_;
+  // The index in runs_ of the run each of records_ was laid out from.
+  std::vector<size_t> record_runs_;
+  // The bytes held by the text blobs of records_.
+  size_t text_blob_bytes_ = 0;
 
   std::vector<double> line_heights_;
   bool did_exceed_max_lines_;
 
-  struct GlyphPosition {
-    const double start;
-    const double advance;
-    const size_t code_units;
+  // The laid out x positions of the glyphs of one line. Positions are kept
+  // as parallel arrays of floats and 16 bit code unit counts, which is less
+  // than half the size of a struct per glyph on long paragraphs.
+  class GlyphLine {
+   public:
+    GlyphLine() = default;
+    GlyphLine(GlyphLine&& other) = default;
+    GlyphLine& operator=(GlyphLine&& other) = default;
+
+    void AddGlyph(double start, double advance, size_t code_units);
+
+    // Called once all glyphs are added. The line starts at code_unit_start
+    // of the text and may cover more code units than its glyphs, for example
+    // the trailing newline.
+    void Finish(size_t code_unit_start, size_t total_code_units);
+
+    size_t size() const { return starts_.size(); }
+    bool empty() const { return starts_.empty(); }
+    double start(size_t index) const { return starts_[index]; }
+    double advance(size_t index) const { return advances_[index]; }
+    double glyph_end(size_t index) const {
+      return starts_[index] + advances_[index];
+    }
+    size_t code_units(size_t index) const { return code_units_[index]; }
+    size_t code_unit_start() const { return code_unit_start_; }
+    size_t total_code_units() const { return total_code_units_; }
+
+    // Returns the index of the glyph containing the given code unit index
+    // within the line.
+    size_t GetGlyphIndex(size_t pos) const;
+
+    // Returns the code unit index within the line of the first code unit of
+    // the glyph at index. An index of size() returns the code units of all
+    // glyphs.
+    size_t GetGlyphCodeUnitStart(size_t index) const;
+
+    size_t GetMemoryUsage() const;
+
+   private:
+    std::vector<float> starts_;
+    std::vector<float> advances_;
+    std::vector<uint16_t> code_units_;
+    size_t code_unit_start_ = 0;
+    size_t total_code_units_ = 0;
+
+    // The code unit index each glyph starts at, followed by the code units of
+    // all glyphs. Only lines with multi code unit glyphs need it, so it is
+    // computed by the first query that does.
+    mutable std::vector<uint32_t> glyph_code_unit_starts_;
+
+    bool HasSingleCodeUnitGlyphs() const {
+      return size() == total_code_units_;
+    }
+
+    const std::vector<uint32_t>& GetGlyphCodeUnitStarts() const;
+
+    FXL_DISALLOW_COPY_AND_ASSIGN(GlyphLine);
+  };
 
-    GlyphPosition(double s, double a, size_t cu)
-        : start(s), advance(a), code_units(cu) {}
+  // Holds the laid out x positions of each glyph.
+  std::vector<GlyphLine> glyph_position_x_;
 
-    double glyph_end() const { return start + advance; }
-  };
+  // Advance of each code unit of text_, as measured by the line breaker. Empty
+  // until the text has been measured.
+  std::vector<float> char_widths_;
 
-  struct GlyphLine {
-    const std::vector<GlyphPosition> positions;
-    const size_t total_code_units;
+  // The shaped runs used by the most recent Layout(), keyed by the code unit
+  // range each covers. Ellipsized runs are not kept.
+  std::map<std::pair<size_t, size_t>, minikin::Layout> shaped_runs_;
 
-    GlyphLine(std::vector<GlyphPosition>&& p, size_t tcu);
+  fxl::RefPtr<fxl::TaskRunner> worker_task_runner_;
 
-    // Return the GlyphPosition containing the given code unit index within
-    // the line.
-    const GlyphPosition& GetGlyphPosition(size_t pos) const;
-  };
+  // Whether the font collection was asked for fallback fonts covering text_.
+  bool fallback_fonts_resolved_ = false;
 
-  // Holds the laid out x positions of each glyph.
-  std::vector<GlyphLine> glyph_position_x_;
+  // The code units edited by UpdateText() since the last layout, widened to
+  // whole blocks. Everything kept from previous layouts for this range is
+  // stale.
+  size_t dirty_start_ = 0;
+  size_t dirty_end_ = 0;
 
   // The max width of the paragraph as provided in the most recent Layout()
   // call.
@@ -244,13 +352,66 @@ class Paragraph {
   // into breaker_ in InitBreaker(), which is called in Layout().
   void SetText(std::vector<uint16_t> text, StyledRuns runs);
 
+  // Same as SetText(), for text that differs from text_ only in that the code
+  // units in [start, old_end) were replaced with [start, new_end) of text.
+  // The measurements, line breaks and shaped runs of the blocks outside of
+  // the edit are kept for the next Layout().
+  void UpdateText(std::vector<uint16_t> text,
+                  StyledRuns runs,
+                  size_t start,
+                  size_t old_end,
+                  size_t new_end);
+
+  // Same as SetText(), except that runs which cover the same ranges as runs_
+  // and differ only in painting attributes replace the styles of the laid out
+  // records without another Layout().
+  void UpdateStyles(std::vector<uint16_t> text, StyledRuns runs);
+
   void SetParagraphStyle(const ParagraphStyle& style);
 
   void SetFontCollection(std::shared_ptr<FontCollection> font_collection);
 
+  // Discards the measurements, line breaks and shaped runs kept from previous
+  // layouts.
+  void ClearShapingCache();
+
+  // Lets the font collection find fallback fonts for the code points of
+  // text_ that its fonts don't cover. Returns true if it found new ones.
+  bool ResolveFallbackFonts();
+
+  // The lines of one newline-delimited block, either kept from the previous
+  // layout or computed by BreakBlock().
+  struct BlockBreak {
+    struct Run {
+      minikin::FontStyle font;
+      minikin::MinikinPaint paint;
+      std::shared_ptr<minikin::FontCollection> collection;
+      // Relative to the start of the block.
+      size_t start;
+      size_t end;
+    };
+
+    size_t start = 0;
+    size_t end = 0;
+    // Whether char_widths_ has to be measured for this block.
+    bool measure = false;
+    std::vector<Run> runs;
+    std::vector<LineRange> line_ranges;
+    std::vector<double> line_widths;
+  };
+
   // Break the text into lines.
   bool ComputeLineBreaks();
 
+  // Breaks one block into lines with the given breaker. Only touches the
+  // block and its range of char_widths_, so distinct blocks may be broken
+  // concurrently.
+  void BreakBlock(minikin::LineBreaker* breaker, BlockBreak* block);
+
+  // Shapes the runs of the first line_limit lines that are not in
+  // shaped_runs_ yet on worker_task_runner_, if there are enough of them.
+  void ShapeRunsConcurrently(size_t line_limit);
+
   // Calculate the starting X offset of a line based on the line's width and
   // alignment.
   double GetLineXOffset(size_t line);
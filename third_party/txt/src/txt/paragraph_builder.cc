@@ -15,13 +15,64 @@
  */
 #include "lib/fxl/logging.h"
 
+#include <string.h>
+
 #include <list>
 
 #include "paragraph_builder.h"
 #include "paragraph_style.h"
-#include "third_party/icu/source/common/unicode/unistr.h"
+#include "third_party/icu/source/common/unicode/ustring.h"
 
 namespace txt {
+namespace {
+
+// Whether the eight bytes at |bytes| are all ASCII.
+bool IsAsciiWord(const uint8_t* bytes) {
+  uint64_t word;
+  memcpy(&word, bytes, sizeof(word));
+  return !(word & 0x8080808080808080ull);
+}
+
+// Appends the UTF-8 |text| to |out| as UTF-16. Most text is ASCII, whose runs
+// are found eight bytes at a time and widened by a loop the compiler
+// vectorizes. Runs of other characters are decoded by ICU, with malformed
+// sequences replaced by U+FFFD.
+void AppendUtf8AsUtf16(const char* text,
+                       size_t length,
+                       std::vector<uint16_t>* out) {
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(text);
+  const uint8_t* end = bytes + length;
+  out->reserve(out->size() + length);
+  while (bytes < end) {
+    const uint8_t* ascii_end = bytes;
+    while (end - ascii_end >= 8 && IsAsciiWord(ascii_end))
+      ascii_end += 8;
+    while (ascii_end < end && *ascii_end < 0x80)
+      ascii_end++;
+    out->insert(out->end(), bytes, ascii_end);
+    bytes = ascii_end;
+    if (bytes == end)
+      break;
+
+    // Every byte of a multi-byte sequence is at least 0x80.
+    const uint8_t* other_end = bytes;
+    while (other_end < end && *other_end >= 0x80)
+      other_end++;
+    // Never more UTF-16 code units than UTF-8 bytes.
+    const size_t start = out->size();
+    out->resize(start + (other_end - bytes));
+    int32_t decoded_length = 0;
+    UErrorCode status = U_ZERO_ERROR;
+    u_strFromUTF8WithSub(reinterpret_cast<UChar*>(out->data() + start),
+                         other_end - bytes, &decoded_length,
+                         reinterpret_cast<const char*>(bytes),
+                         other_end - bytes, 0xFFFD, nullptr, &status);
+    out->resize(U_SUCCESS(status) ? start + decoded_length : start);
+    bytes = other_end;
+  }
+}
+
+}  // namespace
 
 ParagraphBuilder::ParagraphBuilder(
     ParagraphStyle style,
@@ -64,7 +115,8 @@ void ParagraphBuilder::Pop() {
 }
 
 const TextStyle& ParagraphBuilder::PeekStyle() const {
-  return runs_.PeekStyle();
+  // Fall back to the paragraph's default style once everything was popped.
+  return runs_.GetStyle(style_stack_.empty() ? 0 : style_stack_.back());
 }
 
 void ParagraphBuilder::AddText(const std::u16string& text) {
@@ -72,17 +124,11 @@ void ParagraphBuilder::AddText(const std::u16string& text) {
 }
 
 void ParagraphBuilder::AddText(const std::string& text) {
-  auto icu_text = icu::UnicodeString::fromUTF8(text);
-  std::u16string u16_text(icu_text.getBuffer(),
-                          icu_text.getBuffer() + icu_text.length());
-  AddText(u16_text);
+  AppendUtf8AsUtf16(text.data(), text.size(), &text_);
 }
 
 void ParagraphBuilder::AddText(const char* text) {
-  auto icu_text = icu::UnicodeString::fromUTF8(text);
-  std::u16string u16_text(icu_text.getBuffer(),
-                          icu_text.getBuffer() + icu_text.length());
-  AddText(u16_text);
+  AppendUtf8AsUtf16(text, strlen(text), &text_);
 }
 
 std::unique_ptr<Paragraph> ParagraphBuilder::Build() {
@@ -95,4 +141,18 @@ std::unique_ptr<Paragraph> ParagraphBuilder::Build() {
   return paragraph;
 }
 
+void ParagraphBuilder::Update(Paragraph* paragraph,
+                              size_t start,
+                              size_t old_end,
+                              size_t new_end) {
+  runs_.EndRunIfNeeded(text_.size());
+  paragraph->UpdateText(std::move(text_), std::move(runs_), start, old_end,
+                        new_end);
+}
+
+void ParagraphBuilder::Restyle(Paragraph* paragraph) {
+  runs_.EndRunIfNeeded(text_.size());
+  paragraph->UpdateStyles(std::move(text_), std::move(runs_));
+}
+
 }  // namespace txt
@@ -60,10 +60,10 @@ class ParagraphBuilder {
   // on the style_stack_;
   void AddText(const std::u16string& text);
 
-  // Converts to u16string before adding.
+  // Converts from UTF-8 while adding, with a fast path for ASCII.
   void AddText(const std::string& text);
 
-  // Converts to u16string before adding.
+  // Converts from UTF-8 while adding, with a fast path for ASCII.
   void AddText(const char* text);
 
   void SetParagraphStyle(const ParagraphStyle& style);
@@ -72,6 +72,24 @@ class ParagraphBuilder {
   // to a SkCanvas.
   std::unique_ptr<Paragraph> Build();
 
+  // Hands the text and runs built so far to an existing paragraph, whose text
+  // differs from them only in that the code units in [start, old_end) were
+  // replaced with [start, new_end) of the new text. The paragraph keeps its
+  // paragraph style and font collection, and its next Layout() only reshapes
+  // the newline-delimited blocks touched by the edit. The text outside of the
+  // edit must be styled the same as before.
+  void Update(Paragraph* paragraph,
+              size_t start,
+              size_t old_end,
+              size_t new_end);
+
+  // Hands the text and runs built so far to an existing paragraph. If the
+  // text and run boundaries are unchanged and the styles differ only in
+  // painting attributes (color and decorations), the paragraph keeps its
+  // layout and text blobs and only paints with the new styles. Otherwise it is
+  // laid out from scratch on its next Layout().
+  void Restyle(Paragraph* paragraph);
+
  private:
   std::vector<uint16_t> text_;
   std::vector<size_t> style_stack_;
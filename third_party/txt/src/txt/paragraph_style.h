@@ -58,6 +58,12 @@ class ParagraphStyle {
   // kBreakStrategy_Balanced will balance between the two.
   minikin::BreakStrategy break_strategy =
       minikin::BreakStrategy::kBreakStrategy_Greedy;
+  // The locale of the text, such as "en-US". Words are broken by its rules
+  // and, when hyphenation is enabled, hyphenated by its patterns in the
+  // HyphenatorCache. Empty uses the default locale and never hyphenates.
+  std::string locale;
+  minikin::HyphenationFrequency hyphenation_frequency =
+      minikin::kHyphenationFrequency_None;
 };
 
 }  // namespace txt
@@ -24,12 +24,16 @@ StyledRuns::StyledRuns() = default;
 
 StyledRuns::~StyledRuns() = default;
 
+StyledRuns::StyledRuns(const StyledRuns& other) = default;
+
 StyledRuns::StyledRuns(StyledRuns&& other) {
   styles_.swap(other.styles_);
   runs_.swap(other.runs_);
 }
 
-const StyledRuns& StyledRuns::operator=(StyledRuns&& other) {
+StyledRuns& StyledRuns::operator=(const StyledRuns& other) = default;
+
+StyledRuns& StyledRuns::operator=(StyledRuns&& other) {
   styles_.swap(other.styles_);
   runs_.swap(other.runs_);
   return *this;
@@ -46,10 +50,6 @@ size_t StyledRuns::AddStyle(const TextStyle& style) {
   return style_index;
 }
 
-const TextStyle& StyledRuns::PeekStyle() const {
-  return styles_.back();
-}
-
 void StyledRuns::StartRun(size_t style_index, size_t start) {
   runs_.push_back(IndexedRun{style_index, start, start});
 }
@@ -71,4 +71,12 @@ StyledRuns::Run StyledRuns::GetRun(size_t index) const {
   return Run{styles_[run.style_index], run.start, run.end};
 }
 
+size_t StyledRuns::GetMemoryUsage() const {
+  size_t bytes = styles_.capacity() * sizeof(TextStyle) +
+                 runs_.capacity() * sizeof(IndexedRun);
+  for (const TextStyle& style : styles_)
+    bytes += style.font_family.capacity();
+  return bytes;
+}
+
 }  // namespace txt
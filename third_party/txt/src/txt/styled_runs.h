@@ -17,7 +17,6 @@
 #ifndef LIB_TXT_SRC_STYLED_RUNS_H_
 #define LIB_TXT_SRC_STYLED_RUNS_H_
 
-#include <list>
 #include <vector>
 
 #include "text_style.h"
@@ -39,18 +38,22 @@ class StyledRuns {
 
   ~StyledRuns();
 
-  StyledRuns(const StyledRuns& other) = delete;
+  // Runs refer to styles by index, so copies and moves need no fixups.
+  StyledRuns(const StyledRuns& other);
 
   StyledRuns(StyledRuns&& other);
 
-  const StyledRuns& operator=(StyledRuns&& other);
+  StyledRuns& operator=(const StyledRuns& other);
+
+  StyledRuns& operator=(StyledRuns&& other);
 
   void swap(StyledRuns& other);
 
   size_t AddStyle(const TextStyle& style);
 
-  // Returns the last TextStyle on the stack.
-  const TextStyle& PeekStyle() const;
+  const TextStyle& GetStyle(size_t style_index) const {
+    return styles_[style_index];
+  }
 
   void StartRun(size_t style_index, size_t start);
 
@@ -60,6 +63,9 @@ class StyledRuns {
 
   Run GetRun(size_t index) const;
 
+  // Returns the bytes held by the styles and runs.
+  size_t GetMemoryUsage() const;
+
  private:
   FRIEND_TEST(ParagraphTest, SimpleParagraph);
   FRIEND_TEST(ParagraphTest, SimpleRedParagraph);
@@ -49,6 +49,11 @@ class TextStyle {
   TextStyle();
 
   bool equals(const TextStyle& other) const;
+
+  // Whether text in the two styles is shaped and positioned the same way. The
+  // styles may still differ in attributes that only affect painting, such as
+  // the color and the decorations.
+  bool layout_equals(const TextStyle& other) const;
 };
 
 }  // namespace txt
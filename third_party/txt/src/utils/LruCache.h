@@ -51,6 +51,8 @@ class LruCache {
   bool remove(const TKey& key);
   bool removeOldest();
   void clear();
+  // Evicts the oldest entries until at most maxCapacity remain.
+  void setMaxCapacity(uint32_t maxCapacity);
   const TValue& peekOldestValue();
 
  private:
@@ -247,6 +249,16 @@ bool LruCache<TKey, TValue>::removeOldest() {
   return false;
 }
 
+template <typename TKey, typename TValue>
+void LruCache<TKey, TValue>::setMaxCapacity(uint32_t maxCapacity) {
+  mMaxCapacity = maxCapacity;
+  if (mMaxCapacity == kUnlimitedCapacity) {
+    return;
+  }
+  while (size() > mMaxCapacity && removeOldest()) {
+  }
+}
+
 template <typename TKey, typename TValue>
 const TValue& LruCache<TKey, TValue>::peekOldestValue() {
   if (mOldest) {
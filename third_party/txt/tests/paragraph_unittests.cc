@@ -14,12 +14,18 @@
  * limitations under the License.
  */
 
+#include <map>
+#include <mutex>
+
+#include "flutter/fml/worker_pool.h"
 #include "lib/fxl/logging.h"
+#include "minikin/Layout.h"
 #include "render_test.h"
 #include "third_party/icu/source/common/unicode/unistr.h"
 #include "third_party/skia/include/core/SkColor.h"
 #include "txt/font_style.h"
 #include "txt/font_weight.h"
+#include "txt/hyphenator_cache.h"
 #include "txt/paragraph.h"
 #include "txt/paragraph_builder.h"
 #include "utils.h"
@@ -1525,4 +1531,624 @@ TEST_F(ParagraphTest, Ellipsize) {
   ASSERT_EQ(paragraph->records_.size(), 1ull);
 }
 
+TEST_F(ParagraphTest, WidthOnlyRelayoutParagraph) {
+  const char* text =
+      "Sentence to layout at diff widths to get diff line counts. short words "
+      "short words short words short words short words short words short words "
+      "short words short words short words short words short words short words";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+  paragraph_style.break_strategy = minikin::kBreakStrategy_HighQuality;
+
+  txt::TextStyle text_style;
+  text_style.font_family = "Roboto";
+  text_style.font_size = 31;
+  text_style.color = SK_ColorBLACK;
+
+  txt::ParagraphBuilder builder(paragraph_style, GetTestFontCollection());
+  builder.PushStyle(text_style);
+  builder.AddText(u16_text);
+  builder.Pop();
+  auto paragraph = builder.Build();
+
+  txt::ParagraphBuilder fresh_builder(paragraph_style,
+                                      GetTestFontCollection());
+  fresh_builder.PushStyle(text_style);
+  fresh_builder.AddText(u16_text);
+  fresh_builder.Pop();
+  auto fresh_paragraph = fresh_builder.Build();
+
+  paragraph->Layout(600);
+  ASSERT_EQ(paragraph->char_widths_.size(), u16_text.length());
+  ASSERT_EQ(paragraph->shaped_runs_.size(), paragraph->GetLineCount());
+
+  // Relaying out at a new width reuses the measured text and must produce the
+  // same result as a paragraph that is laid out at that width directly.
+  paragraph->Layout(300);
+  fresh_paragraph->Layout(300);
+  ASSERT_EQ(paragraph->shaped_runs_.size(), paragraph->GetLineCount());
+  ASSERT_EQ(paragraph->GetLineCount(), fresh_paragraph->GetLineCount());
+  ASSERT_EQ(paragraph->line_widths_, fresh_paragraph->line_widths_);
+  ASSERT_EQ(paragraph->GetHeight(), fresh_paragraph->GetHeight());
+  ASSERT_EQ(paragraph->glyph_position_x_.size(),
+            fresh_paragraph->glyph_position_x_.size());
+  for (size_t line = 0; line < paragraph->glyph_position_x_.size(); ++line) {
+    const auto& positions = paragraph->glyph_position_x_[line];
+    const auto& fresh_positions =
+        fresh_paragraph->glyph_position_x_[line];
+    ASSERT_EQ(positions.size(), fresh_positions.size());
+    for (size_t i = 0; i < positions.size(); ++i) {
+      ASSERT_EQ(positions.start(i), fresh_positions.start(i));
+      ASSERT_EQ(positions.advance(i), fresh_positions.advance(i));
+    }
+  }
+
+  paragraph->Paint(GetCanvas(), 0, 0);
+  ASSERT_TRUE(Snapshot());
+
+  // Forcing a layout discards the kept shaping results.
+  paragraph->Layout(300, true);
+  ASSERT_EQ(paragraph->char_widths_.size(), u16_text.length());
+  ASSERT_EQ(paragraph->GetLineCount(), fresh_paragraph->GetLineCount());
+}
+
+TEST_F(ParagraphTest, IncrementalRelayoutParagraph) {
+  const char* text =
+      "First block of text that wraps onto a few lines.\n"
+      "Second block of text that is going to be edited.\n"
+      "Third block of text that also wraps onto a few lines.";
+  const char* edited_text =
+      "First block of text that wraps onto a few lines.\n"
+      "Second block of longer text that has been edited.\n"
+      "Third block of text that also wraps onto a few lines.";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+  auto icu_edited_text = icu::UnicodeString::fromUTF8(edited_text);
+  std::u16string u16_edited_text(
+      icu_edited_text.getBuffer(),
+      icu_edited_text.getBuffer() + icu_edited_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  text_style.font_family = "Roboto";
+  text_style.font_size = 26;
+  text_style.color = SK_ColorBLACK;
+
+  txt::ParagraphBuilder builder(paragraph_style, GetTestFontCollection());
+  builder.PushStyle(text_style);
+  builder.AddText(u16_text);
+  builder.Pop();
+  auto paragraph = builder.Build();
+  paragraph->Layout(300);
+  size_t first_block_runs = 0;
+  for (const auto& shaped_run : paragraph->shaped_runs_) {
+    if (shaped_run.first.second < u16_text.find(u'\n'))
+      first_block_runs++;
+  }
+
+  // Replace "going to be" with "longer text that has been".
+  const size_t start = u16_text.find(u"going");
+  const size_t old_end = u16_text.find(u" edited");
+  const size_t new_end = u16_edited_text.find(u" edited");
+
+  txt::ParagraphBuilder edit_builder(paragraph_style, GetTestFontCollection());
+  edit_builder.PushStyle(text_style);
+  edit_builder.AddText(u16_edited_text);
+  edit_builder.Pop();
+  edit_builder.Update(paragraph.get(), start, old_end, new_end);
+
+  // Only the edited block has to be measured and shaped again.
+  ASSERT_EQ(paragraph->dirty_start_, u16_text.find(u'\n') + 1);
+  ASSERT_EQ(paragraph->dirty_end_, u16_edited_text.rfind(u'\n'));
+  size_t kept_runs = paragraph->shaped_runs_.size();
+  ASSERT_GT(kept_runs, first_block_runs);
+
+  paragraph->Layout(300);
+  paragraph->Paint(GetCanvas(), 0, 0);
+  ASSERT_TRUE(Snapshot());
+
+  txt::ParagraphBuilder fresh_builder(paragraph_style,
+                                      GetTestFontCollection());
+  fresh_builder.PushStyle(text_style);
+  fresh_builder.AddText(u16_edited_text);
+  fresh_builder.Pop();
+  auto fresh_paragraph = fresh_builder.Build();
+  fresh_paragraph->Layout(300);
+
+  ASSERT_EQ(paragraph->text_.size(), u16_edited_text.length());
+  ASSERT_EQ(paragraph->char_widths_, fresh_paragraph->char_widths_);
+  ASSERT_EQ(paragraph->line_widths_, fresh_paragraph->line_widths_);
+  ASSERT_EQ(paragraph->GetLineCount(), fresh_paragraph->GetLineCount());
+  ASSERT_EQ(paragraph->GetHeight(), fresh_paragraph->GetHeight());
+  for (size_t line = 0; line < paragraph->line_ranges_.size(); ++line) {
+    ASSERT_EQ(paragraph->line_ranges_[line].start,
+              fresh_paragraph->line_ranges_[line].start);
+    ASSERT_EQ(paragraph->line_ranges_[line].end,
+              fresh_paragraph->line_ranges_[line].end);
+  }
+  ASSERT_EQ(paragraph->GetRectsForRange(0, u16_edited_text.length()),
+            fresh_paragraph->GetRectsForRange(0, u16_edited_text.length()));
+}
+
+TEST_F(ParagraphTest, ConcurrentLayoutParagraph) {
+  std::u16string u16_text;
+  for (size_t i = 0; i < 40; ++i) {
+    u16_text += u"This block of text is long enough to wrap onto a few lines "
+                u"and is broken and shaped independently of the others.\n";
+  }
+
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  text_style.font_family = "Roboto";
+  text_style.font_size = 20;
+  text_style.color = SK_ColorBLACK;
+
+  txt::ParagraphBuilder builder(paragraph_style, GetTestFontCollection());
+  builder.PushStyle(text_style);
+  builder.AddText(u16_text);
+  builder.Pop();
+  auto paragraph = builder.Build();
+
+  txt::ParagraphBuilder serial_builder(paragraph_style,
+                                       GetTestFontCollection());
+  serial_builder.PushStyle(text_style);
+  serial_builder.AddText(u16_text);
+  serial_builder.Pop();
+  auto serial_paragraph = serial_builder.Build();
+
+  fml::WorkerPool worker_pool("txt_worker", 4);
+  paragraph->SetWorkerTaskRunner(worker_pool.GetTaskRunner());
+  paragraph->Layout(GetTestCanvasWidth());
+  serial_paragraph->Layout(GetTestCanvasWidth());
+
+  ASSERT_GT(paragraph->GetLineCount(), 40ull);
+  ASSERT_EQ(paragraph->GetLineCount(), serial_paragraph->GetLineCount());
+  ASSERT_EQ(paragraph->char_widths_, serial_paragraph->char_widths_);
+  ASSERT_EQ(paragraph->line_widths_, serial_paragraph->line_widths_);
+  ASSERT_EQ(paragraph->GetHeight(), serial_paragraph->GetHeight());
+  for (size_t line = 0; line < paragraph->glyph_position_x_.size(); ++line) {
+    const auto& positions = paragraph->glyph_position_x_[line];
+    const auto& serial_positions =
+        serial_paragraph->glyph_position_x_[line];
+    ASSERT_EQ(positions.size(), serial_positions.size());
+    for (size_t i = 0; i < positions.size(); ++i)
+      ASSERT_EQ(positions.start(i), serial_positions.start(i));
+  }
+
+  paragraph->Paint(GetCanvas(), 0, 0);
+  ASSERT_TRUE(Snapshot());
+}
+
+namespace {
+
+class MapLayoutCacheStorage : public minikin::LayoutCacheStorage {
+ public:
+  bool get(const std::string& key, std::string* value) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = values_.find(key);
+    if (found == values_.end()) {
+      return false;
+    }
+    hits_++;
+    *value = found->second;
+    return true;
+  }
+
+  void put(const std::string& key, const std::string& value) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    values_[key] = value;
+  }
+
+  size_t size() const { return values_.size(); }
+
+  size_t hits() const { return hits_; }
+
+ private:
+  std::mutex mutex_;
+  std::map<std::string, std::string> values_;
+  size_t hits_ = 0;
+};
+
+}  // namespace
+
+TEST_F(ParagraphTest, LayoutCacheStorageParagraph) {
+  const char* text =
+      "Words shaped on one launch are restored from storage on the next one.";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  text_style.font_family = "Roboto";
+  text_style.font_size = 26;
+  text_style.color = SK_ColorBLACK;
+
+  auto storage = std::make_shared<MapLayoutCacheStorage>();
+  minikin::Layout::setCacheStorage(storage);
+  minikin::Layout::purgeCaches();
+
+  txt::ParagraphBuilder builder(paragraph_style, GetTestFontCollection());
+  builder.PushStyle(text_style);
+  builder.AddText(u16_text);
+  builder.Pop();
+  auto paragraph = builder.Build();
+  paragraph->Layout(300);
+  ASSERT_GT(storage->size(), 0ull);
+  ASSERT_EQ(storage->hits(), 0ull);
+
+  // With the in-memory cache gone, the words only come from storage.
+  minikin::Layout::purgeCaches();
+  txt::ParagraphBuilder restored_builder(paragraph_style,
+                                         GetTestFontCollection());
+  restored_builder.PushStyle(text_style);
+  restored_builder.AddText(u16_text);
+  restored_builder.Pop();
+  auto restored_paragraph = restored_builder.Build();
+  restored_paragraph->Layout(300);
+  minikin::Layout::setCacheStorage(nullptr);
+
+  ASSERT_GT(storage->hits(), 0ull);
+  ASSERT_EQ(restored_paragraph->GetLineCount(), paragraph->GetLineCount());
+  ASSERT_EQ(restored_paragraph->line_widths_, paragraph->line_widths_);
+  ASSERT_EQ(restored_paragraph->GetHeight(), paragraph->GetHeight());
+  ASSERT_EQ(restored_paragraph->glyph_position_x_.size(),
+            paragraph->glyph_position_x_.size());
+  for (size_t line = 0; line < paragraph->glyph_position_x_.size(); ++line) {
+    const auto& positions = paragraph->glyph_position_x_[line];
+    const auto& restored_positions =
+        restored_paragraph->glyph_position_x_[line];
+    ASSERT_EQ(restored_positions.size(), positions.size());
+    for (size_t i = 0; i < positions.size(); ++i) {
+      ASSERT_EQ(restored_positions.start(i), positions.start(i));
+      ASSERT_EQ(restored_positions.advance(i), positions.advance(i));
+    }
+  }
+
+  restored_paragraph->Paint(GetCanvas(), 0, 0);
+  ASSERT_TRUE(Snapshot());
+}
+
+TEST_F(ParagraphTest, PaintOnlyRestyleParagraph) {
+  const char* text = "Restyled text keeps its glyphs if only its paint changes";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  text_style.font_family = "Roboto";
+  text_style.font_size = 26;
+  text_style.color = SK_ColorRED;
+
+  txt::ParagraphBuilder builder(paragraph_style, GetTestFontCollection());
+  builder.PushStyle(text_style);
+  builder.AddText(u16_text);
+  builder.Pop();
+  auto paragraph = builder.Build();
+  paragraph->Layout(300);
+  ASSERT_EQ(paragraph->record_runs_.size(), paragraph->records_.size());
+  std::vector<SkTextBlob*> blobs;
+  for (const PaintRecord& record : paragraph->records_)
+    blobs.push_back(record.text());
+
+  // A new color and decoration reuse the laid out blobs.
+  txt::TextStyle blue_style = text_style;
+  blue_style.color = SK_ColorBLUE;
+  blue_style.decoration = TextDecoration::kUnderline;
+  txt::ParagraphBuilder blue_builder(paragraph_style, GetTestFontCollection());
+  blue_builder.PushStyle(blue_style);
+  blue_builder.AddText(u16_text);
+  blue_builder.Pop();
+  blue_builder.Restyle(paragraph.get());
+  ASSERT_FALSE(paragraph->needs_layout_);
+  ASSERT_EQ(paragraph->records_.size(), blobs.size());
+  for (size_t i = 0; i < blobs.size(); ++i) {
+    ASSERT_EQ(paragraph->records_[i].text(), blobs[i]);
+    ASSERT_EQ(paragraph->records_[i].style().color, SK_ColorBLUE);
+    ASSERT_EQ(paragraph->records_[i].style().decoration,
+              TextDecoration::kUnderline);
+  }
+
+  paragraph->Paint(GetCanvas(), 0, 0);
+  ASSERT_TRUE(Snapshot());
+
+  // A new font size needs another layout.
+  txt::TextStyle large_style = blue_style;
+  large_style.font_size = 40;
+  txt::ParagraphBuilder large_builder(paragraph_style, GetTestFontCollection());
+  large_builder.PushStyle(large_style);
+  large_builder.AddText(u16_text);
+  large_builder.Pop();
+  large_builder.Restyle(paragraph.get());
+  ASSERT_TRUE(paragraph->needs_layout_);
+  paragraph->Layout(300);
+  ASSERT_EQ(paragraph->records_[0].style().font_size, 40);
+}
+
+TEST_F(ParagraphTest, LazyFallbackFontsParagraph) {
+  const char* text = "Roboto has no glyph for 左 or 線";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  // Pushing the font manager does not look up any fallback fonts.
+  auto font_collection = GetTestFontCollection();
+  ASSERT_TRUE(font_collection->GetFallbackFontFamilies().empty());
+  ASSERT_TRUE(font_collection->missing_characters_.empty());
+
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  text_style.font_family = "Roboto";
+  text_style.font_size = 26;
+  text_style.color = SK_ColorBLACK;
+
+  txt::ParagraphBuilder builder(paragraph_style, font_collection);
+  builder.PushStyle(text_style);
+  builder.AddText(u16_text);
+  builder.Pop();
+  auto paragraph = builder.Build();
+  ASSERT_FALSE(paragraph->fallback_fonts_resolved_);
+  paragraph->Layout(GetTestCanvasWidth());
+  ASSERT_TRUE(paragraph->fallback_fonts_resolved_);
+
+  // The test font manager has no fallback fonts, so only the code points
+  // Roboto doesn't cover were looked up, and they are not looked up again.
+  ASSERT_EQ(font_collection->missing_characters_.size(), 2ull);
+  ASSERT_EQ(font_collection->missing_characters_.count(0x5de6), 1ull);
+  ASSERT_EQ(font_collection->missing_characters_.count(0x7dda), 1ull);
+  ASSERT_FALSE(font_collection->ResolveFallbackFonts(
+      text_style.font_family,
+      reinterpret_cast<const uint16_t*>(u16_text.data()), u16_text.size()));
+
+  paragraph->Paint(GetCanvas(), 0, 0);
+  ASSERT_TRUE(Snapshot());
+}
+
+TEST_F(ParagraphTest, CompactGlyphPositionsParagraph) {
+  // Each emoji is a surrogate pair.
+  const char* text = "😀😃😄";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  text_style.font_family = "Noto Color Emoji";
+  text_style.font_size = 50;
+  text_style.color = SK_ColorBLACK;
+
+  txt::ParagraphBuilder builder(paragraph_style, GetTestFontCollection());
+  builder.PushStyle(text_style);
+  builder.AddText(u16_text);
+  builder.Pop();
+  auto paragraph = builder.Build();
+  paragraph->Layout(GetTestCanvasWidth());
+
+  ASSERT_EQ(paragraph->glyph_position_x_.size(), 1ull);
+  const auto& line = paragraph->glyph_position_x_[0];
+  ASSERT_EQ(line.size(), 3ull);
+  ASSERT_EQ(line.total_code_units(), u16_text.size());
+  for (size_t i = 0; i < line.size(); ++i)
+    ASSERT_EQ(line.code_units(i), 2ull);
+
+  // Both code units of a surrogate pair map to its glyph.
+  const size_t expected_glyphs[] = {0, 0, 1, 1, 2, 2};
+  ASSERT_EQ(u16_text.size(), sizeof(expected_glyphs) / sizeof(size_t));
+  for (size_t pos = 0; pos < u16_text.size(); ++pos)
+    ASSERT_EQ(line.GetGlyphIndex(pos), expected_glyphs[pos]);
+  for (size_t i = 1; i < line.size(); ++i)
+    ASSERT_NEAR(line.start(i), line.glyph_end(i - 1), 0.01);
+
+  paragraph->Paint(GetCanvas(), 0, 0);
+  ASSERT_TRUE(Snapshot());
+}
+
+TEST_F(ParagraphTest, LongParagraphHitTesting) {
+  const char* text =
+      "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do "
+      "eiusmod tempor incididunt ut labore et dolore magna aliqua. ";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  text_style.font_family = "Roboto";
+  text_style.font_size = 26;
+  text_style.color = SK_ColorBLACK;
+
+  txt::ParagraphBuilder builder(paragraph_style, GetTestFontCollection());
+  builder.PushStyle(text_style);
+  for (size_t i = 0; i < 50; ++i)
+    builder.AddText(u16_text);
+  builder.Pop();
+  auto paragraph = builder.Build();
+  paragraph->Layout(GetTestCanvasWidth());
+  ASSERT_GT(paragraph->GetLineCount(), 40ull);
+
+  // Selecting the whole text returns a rect per line.
+  std::vector<SkRect> rects =
+      paragraph->GetRectsForRange(0, u16_text.size() * 50);
+  ASSERT_EQ(rects.size(), paragraph->GetLineCount());
+
+  for (size_t line = 0; line < paragraph->GetLineCount(); ++line) {
+    const auto& glyph_line = paragraph->glyph_position_x_[line];
+    double top = line > 0 ? paragraph->line_heights_[line - 1] : 0;
+    ASSERT_EQ(rects[line].top(), top);
+
+    // The left edge of a line hits its first code unit.
+    ASSERT_EQ(paragraph->GetGlyphPositionAtCoordinate(-1, top + 1).position,
+              glyph_line.code_unit_start());
+
+    // The middle of each glyph hits it.
+    for (size_t i = 0; i < glyph_line.size(); ++i) {
+      double x = glyph_line.start(i) + glyph_line.advance(i) / 4;
+      ASSERT_EQ(paragraph->GetGlyphPositionAtCoordinate(x, top + 1).position,
+                glyph_line.code_unit_start() + i);
+    }
+  }
+
+  // A range in the middle of a line returns a single rect.
+  const auto& line = paragraph->glyph_position_x_[10];
+  rects = paragraph->GetRectsForRange(line.code_unit_start() + 2,
+                                      line.code_unit_start() + 5);
+  ASSERT_EQ(rects.size(), 1ull);
+  ASSERT_EQ(rects[0].left(), line.start(2));
+  ASSERT_EQ(rects[0].right(), line.glyph_end(4));
+}
+
+TEST_F(ParagraphTest, LayoutCacheUsageParagraph) {
+  const char* text = "Cached words are accounted until they are purged.";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  text_style.font_family = "Roboto";
+  text_style.font_size = 26;
+  text_style.color = SK_ColorBLACK;
+
+  minikin::Layout::purgeCaches();
+  size_t entries = 1;
+  size_t bytes = 1;
+  minikin::Layout::getCacheUsage(&entries, &bytes);
+  ASSERT_EQ(entries, 0ull);
+  ASSERT_EQ(bytes, 0ull);
+
+  txt::ParagraphBuilder builder(paragraph_style, GetTestFontCollection());
+  builder.PushStyle(text_style);
+  builder.AddText(u16_text);
+  builder.Pop();
+  auto paragraph = builder.Build();
+  paragraph->Layout(300);
+  minikin::Layout::getCacheUsage(&entries, &bytes);
+  ASSERT_GT(entries, 0ull);
+  ASSERT_GT(bytes, entries * sizeof(minikin::Layout));
+
+  minikin::Layout::purgeCaches();
+  minikin::Layout::getCacheUsage(&entries, &bytes);
+  ASSERT_EQ(entries, 0ull);
+  ASSERT_EQ(bytes, 0ull);
+}
+
+TEST_F(ParagraphTest, MemoryUsageParagraph) {
+  const char* text = "The memory of a paragraph grows with its layout.";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  text_style.font_family = "Roboto";
+  text_style.font_size = 26;
+  text_style.color = SK_ColorBLACK;
+  txt::ParagraphBuilder builder(paragraph_style, GetTestFontCollection());
+  builder.PushStyle(text_style);
+  builder.AddText(u16_text);
+  builder.Pop();
+  auto paragraph = builder.Build();
+
+  // Before layout the layout is estimated.
+  size_t estimated_bytes = paragraph->GetMemoryUsage();
+  ASSERT_GT(estimated_bytes, u16_text.size() * sizeof(uint16_t));
+  ASSERT_EQ(paragraph->GetTextBlobMemoryUsage(), 0ull);
+
+  paragraph->Layout(300);
+  size_t blob_bytes = paragraph->GetTextBlobMemoryUsage();
+  ASSERT_GT(blob_bytes, u16_text.size() * sizeof(SkGlyphID));
+  ASSERT_GT(paragraph->GetMemoryUsage(), blob_bytes);
+
+  // Another layout replaces the blobs rather than adding to them.
+  paragraph->Layout(100);
+  ASSERT_GT(paragraph->GetTextBlobMemoryUsage(), 0ull);
+  ASSERT_LT(paragraph->GetTextBlobMemoryUsage(), 2 * blob_bytes);
+}
+
+TEST_F(ParagraphTest, HyphenationWithoutPatternsParagraph) {
+  txt::HyphenatorCache::Get().SetPatternDirectory("/nonexistent");
+  ASSERT_EQ(txt::HyphenatorCache::Get().GetHyphenator("en-US"), nullptr);
+  ASSERT_EQ(txt::HyphenatorCache::Get().GetHyphenator(""), nullptr);
+
+  const char* text = "Extraordinarily long words are broken where they fit.";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+  txt::TextStyle text_style;
+  text_style.font_family = "Roboto";
+  text_style.font_size = 26;
+
+  // Without patterns, hyphenation leaves the line breaks as they were.
+  std::vector<size_t> line_ends[2];
+  for (int hyphenate = 0; hyphenate < 2; hyphenate++) {
+    txt::ParagraphStyle paragraph_style;
+    if (hyphenate) {
+      paragraph_style.locale = "en-US";
+      paragraph_style.hyphenation_frequency =
+          minikin::kHyphenationFrequency_Normal;
+    }
+    txt::ParagraphBuilder builder(paragraph_style, GetTestFontCollection());
+    builder.PushStyle(text_style);
+    builder.AddText(u16_text);
+    builder.Pop();
+    auto paragraph = builder.Build();
+    paragraph->Layout(200);
+    for (const auto& line : paragraph->line_ranges_)
+      line_ends[hyphenate].push_back(line.end);
+  }
+  ASSERT_GT(line_ends[0].size(), 1ull);
+  ASSERT_EQ(line_ends[0], line_ends[1]);
+  txt::HyphenatorCache::Get().SetPatternDirectory("");
+}
+
+TEST_F(ParagraphTest, PeekStyleAfterPop) {
+  txt::ParagraphStyle paragraph_style;
+  paragraph_style.font_size = 12;
+  txt::ParagraphBuilder builder(paragraph_style, GetTestFontCollection());
+
+  txt::TextStyle outer_style;
+  outer_style.color = SK_ColorRED;
+  builder.PushStyle(outer_style);
+  txt::TextStyle inner_style;
+  inner_style.color = SK_ColorBLUE;
+  builder.PushStyle(inner_style);
+  ASSERT_TRUE(builder.PeekStyle().equals(inner_style));
+
+  builder.Pop();
+  ASSERT_TRUE(builder.PeekStyle().equals(outer_style));
+
+  builder.Pop();
+  builder.Pop();
+  ASSERT_EQ(builder.PeekStyle().font_size, 12);
+}
+
+TEST_F(ParagraphTest, Utf8TextMatchesIcu) {
+  const std::string texts[] = {
+      "",
+      "Plain ASCII that spans several words",
+      "caf\xC3\xA9 na\xC3\xAFve \xE4\xB8\xAD\xE6\x96\x87 then ASCII again",
+      "\xF0\x9F\x98\x80 emoji first, then text",
+      "malformed \xC3 byte and \xFF here",
+      "ends in a truncated sequence \xE4\xB8",
+  };
+  for (const std::string& text : texts) {
+    txt::ParagraphBuilder builder(txt::ParagraphStyle(),
+                                  GetTestFontCollection());
+    builder.AddText(text);
+    auto paragraph = builder.Build();
+
+    auto icu_text = icu::UnicodeString::fromUTF8(text);
+    ASSERT_EQ(paragraph->text_.size(),
+              static_cast<size_t>(icu_text.length()));
+    for (size_t i = 0; i < paragraph->text_.size(); i++) {
+      ASSERT_EQ(paragraph->text_[i], icu_text[i]);
+    }
+  }
+}
+
 }  // namespace txt
@@ -14,11 +14,13 @@ namespace vulkan {
 
 VulkanBackbuffer::VulkanBackbuffer(const VulkanProcTable& p_vk,
                                    const VulkanHandle<VkDevice>& device,
-                                   const VulkanHandle<VkCommandPool>& pool)
+                                   const VulkanHandle<VkCommandPool>& pool,
+                                   bool enable_timestamps)
     : vk(p_vk),
       device_(device),
       usage_command_buffer_(p_vk, device, pool),
       render_command_buffer_(p_vk, device, pool),
+      timestamps_pending_(false),
       valid_(false) {
   if (!usage_command_buffer_.IsValid() || !render_command_buffer_.IsValid()) {
     FXL_DLOG(INFO) << "Command buffers were not valid.";
@@ -35,6 +37,11 @@ VulkanBackbuffer::VulkanBackbuffer(const VulkanProcTable& p_vk,
     return;
   }
 
+  if (enable_timestamps && !CreateTimestampQueryPool()) {
+    FXL_DLOG(INFO) << "Could not create the timestamp query pool.";
+    return;
+  }
+
   valid_ = true;
 }
 
@@ -96,6 +103,38 @@ bool VulkanBackbuffer::CreateFences() {
   return true;
 }
 
+bool VulkanBackbuffer::CreateTimestampQueryPool() {
+  const VkQueryPoolCreateInfo create_info = {
+      .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+      .pNext = nullptr,
+      .flags = 0,
+      .queryType = VK_QUERY_TYPE_TIMESTAMP,
+      .queryCount = 2,
+      .pipelineStatistics = 0,
+  };
+
+  VkQueryPool pool = VK_NULL_HANDLE;
+
+  if (VK_CALL_LOG_ERROR(vk.CreateQueryPool(device_, &create_info, nullptr,
+                                           &pool)) != VK_SUCCESS) {
+    return false;
+  }
+
+  timestamp_query_pool_ = {pool, [this](VkQueryPool pool) {
+                             vk.DestroyQueryPool(device_, pool, nullptr);
+                           }};
+  return true;
+}
+
+bool VulkanBackbuffer::IsReady() const {
+  for (const auto& fence : use_fences_) {
+    if (vk.GetFenceStatus(device_, fence) != VK_SUCCESS) {
+      return false;
+    }
+  }
+  return true;
+}
+
 bool VulkanBackbuffer::WaitFences() {
   VkFence fences[use_fences_.size()];
 
@@ -144,4 +183,9 @@ VulkanCommandBuffer& VulkanBackbuffer::GetRenderCommandBuffer() {
   return render_command_buffer_;
 }
 
+const VulkanHandle<VkQueryPool>& VulkanBackbuffer::GetTimestampQueryPool()
+    const {
+  return timestamp_query_pool_;
+}
+
 }  // namespace vulkan
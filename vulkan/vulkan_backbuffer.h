@@ -20,12 +20,17 @@ class VulkanBackbuffer {
  public:
   VulkanBackbuffer(const VulkanProcTable& vk,
                    const VulkanHandle<VkDevice>& device,
-                   const VulkanHandle<VkCommandPool>& pool);
+                   const VulkanHandle<VkCommandPool>& pool,
+                   bool enable_timestamps = false);
 
   ~VulkanBackbuffer();
 
   bool IsValid() const;
 
+  // Whether the device is done with the last frame rendered with this
+  // backbuffer, so that WaitFences would not block.
+  bool IsReady() const;
+
   FXL_WARN_UNUSED_RESULT
   bool WaitFences();
 
@@ -44,6 +49,16 @@ class VulkanBackbuffer {
 
   VulkanCommandBuffer& GetRenderCommandBuffer();
 
+  // A pool of two timestamp queries for the start and the end of the frames
+  // rendered with this backbuffer. Null unless timestamps are enabled.
+  const VulkanHandle<VkQueryPool>& GetTimestampQueryPool() const;
+
+  // Whether both timestamps of the last frame rendered with this backbuffer
+  // were submitted, so that they may be read once the fences are signaled.
+  bool HasPendingTimestamps() const { return timestamps_pending_; }
+
+  void SetHasPendingTimestamps(bool pending) { timestamps_pending_ = pending; }
+
  private:
   const VulkanProcTable& vk;
   const VulkanHandle<VkDevice>& device_;
@@ -51,12 +66,16 @@ class VulkanBackbuffer {
   std::array<VulkanHandle<VkFence>, 2> use_fences_;
   VulkanCommandBuffer usage_command_buffer_;
   VulkanCommandBuffer render_command_buffer_;
+  VulkanHandle<VkQueryPool> timestamp_query_pool_;
+  bool timestamps_pending_;
   bool valid_;
 
   bool CreateSemaphores();
 
   bool CreateFences();
 
+  bool CreateTimestampQueryPool();
+
   FXL_DISALLOW_COPY_AND_ASSIGN(VulkanBackbuffer);
 };
 
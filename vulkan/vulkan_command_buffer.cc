@@ -49,10 +49,13 @@ VkCommandBuffer VulkanCommandBuffer::Handle() const {
 }
 
 bool VulkanCommandBuffer::Begin() const {
+  // The command buffers of a backbuffer are re-recorded for every frame and
+  // submitted once per recording, which lets the driver skip preparing them
+  // for resubmission.
   const VkCommandBufferBeginInfo info{
       .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
       .pNext = nullptr,
-      .flags = 0,
+      .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
       .pInheritanceInfo = nullptr,
   };
 
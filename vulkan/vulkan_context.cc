@@ -0,0 +1,102 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/vulkan/vulkan_context.h"
+
+#include <utility>
+
+#include "flutter/vulkan/vulkan_application.h"
+#include "flutter/vulkan/vulkan_device.h"
+#include "lib/fxl/logging.h"
+#include "third_party/skia/include/gpu/vk/GrVkInterface.h"
+
+namespace vulkan {
+
+VulkanContext::VulkanContext(fxl::RefPtr<VulkanProcTable> proc_table,
+                             std::vector<std::string> extensions)
+    : vk_(std::move(proc_table)), valid_(false) {
+  if (!vk_ || !vk_->HasAcquiredMandatoryProcAddresses()) {
+    FXL_DLOG(INFO) << "Proc table has not acquired mandatory proc addresses.";
+    return;
+  }
+
+  // Create the application instance.
+
+  application_ = std::make_unique<VulkanApplication>(*vk_, "Flutter",
+                                                     std::move(extensions));
+
+  if (!application_->IsValid() || !vk_->AreInstanceProcsSetup()) {
+    // Make certain the application instance was created and it setup the
+    // instance proc table entries.
+    FXL_DLOG(INFO) << "Instance proc addresses have not been setup.";
+    return;
+  }
+
+  // Create the device.
+
+  device_ = application_->AcquireFirstCompatibleLogicalDevice();
+
+  if (device_ == nullptr || !device_->IsValid() ||
+      !vk_->AreDeviceProcsSetup()) {
+    // Make certain the device was created and it setup the device proc table
+    // entries.
+    FXL_DLOG(INFO) << "Device proc addresses have not been setup.";
+    return;
+  }
+
+  valid_ = true;
+}
+
+VulkanContext::~VulkanContext() = default;
+
+bool VulkanContext::IsValid() const {
+  return valid_;
+}
+
+sk_sp<GrVkBackendContext> VulkanContext::CreateSkiaBackendContext(
+    uint32_t extensions) {
+  return CreateSkiaBackendContext(device_->GetQueueHandle(), extensions);
+}
+
+sk_sp<GrVkBackendContext> VulkanContext::CreateSkiaResourceBackendContext() {
+  if (!device_->GetResourceQueueHandle()) {
+    return nullptr;
+  }
+  return CreateSkiaBackendContext(device_->GetResourceQueueHandle(), 0);
+}
+
+sk_sp<GrVkBackendContext> VulkanContext::CreateSkiaBackendContext(
+    VkQueue queue,
+    uint32_t extensions) {
+  if (!IsValid()) {
+    return nullptr;
+  }
+
+  auto interface = vk_->CreateSkiaInterface();
+
+  if (interface == nullptr || !interface->validate(0)) {
+    return nullptr;
+  }
+
+  uint32_t skia_features = 0;
+  if (!device_->GetPhysicalDeviceFeaturesSkia(&skia_features)) {
+    return nullptr;
+  }
+
+  auto context = sk_make_sp<GrVkBackendContext>();
+  context->fInstance = application_->GetInstance();
+  context->fPhysicalDevice = device_->GetPhysicalDeviceHandle();
+  context->fDevice = device_->GetHandle();
+  context->fQueue = queue;
+  context->fGraphicsQueueIndex = device_->GetGraphicsQueueIndex();
+  context->fMinAPIVersion = application_->GetAPIVersion();
+  context->fExtensions = extensions;
+  context->fFeatures = skia_features;
+  context->fInterface.reset(interface.release());
+  // Several backend contexts share the handles, which this object owns.
+  context->fOwnsInstanceAndDevice = false;
+  return context;
+}
+
+}  // namespace vulkan
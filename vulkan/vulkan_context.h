@@ -0,0 +1,69 @@
+// Copyright 2017 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_VULKAN_VULKAN_CONTEXT_H_
+#define FLUTTER_VULKAN_VULKAN_CONTEXT_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "flutter/vulkan/vulkan_handle.h"
+#include "flutter/vulkan/vulkan_proc_table.h"
+#include "lib/fxl/macros.h"
+#include "lib/fxl/memory/ref_counted.h"
+#include "third_party/skia/include/core/SkRefCnt.h"
+#include "third_party/skia/include/gpu/vk/GrVkBackendContext.h"
+
+namespace vulkan {
+
+class VulkanApplication;
+class VulkanDevice;
+
+// The instance and device shared by the Skia contexts that render to windows
+// and the one that uploads resources. The Skia backend contexts do not own the
+// handles, so this must outlive the GrContexts created from them.
+class VulkanContext : public fxl::RefCountedThreadSafe<VulkanContext> {
+ public:
+  // |extensions| are the instance extensions, which must include those needed
+  // by the native surfaces of the windows using this context.
+  VulkanContext(fxl::RefPtr<VulkanProcTable> proc_table,
+                std::vector<std::string> extensions);
+
+  bool IsValid() const;
+
+  const fxl::RefPtr<VulkanProcTable>& GetProcTable() const { return vk_; }
+
+  VulkanApplication& GetApplication() const { return *application_; }
+
+  VulkanDevice& GetDevice() const { return *device_; }
+
+  // For a context that presents through the graphics queue. |extensions| is a
+  // mask of GrVkExtensionFlags.
+  sk_sp<GrVkBackendContext> CreateSkiaBackendContext(uint32_t extensions);
+
+  // For a context on another thread, which submits to the second queue of the
+  // graphics family. Returns null if the device only has one such queue.
+  sk_sp<GrVkBackendContext> CreateSkiaResourceBackendContext();
+
+ private:
+  fxl::RefPtr<VulkanProcTable> vk_;
+  // The device must be destroyed before the instance.
+  std::unique_ptr<VulkanApplication> application_;
+  std::unique_ptr<VulkanDevice> device_;
+  bool valid_;
+
+  ~VulkanContext();
+
+  sk_sp<GrVkBackendContext> CreateSkiaBackendContext(VkQueue queue,
+                                                     uint32_t extensions);
+
+  FRIEND_REF_COUNTED_THREAD_SAFE(VulkanContext);
+  FRIEND_MAKE_REF_COUNTED(VulkanContext);
+  FXL_DISALLOW_COPY_AND_ASSIGN(VulkanContext);
+};
+
+}  // namespace vulkan
+
+#endif  // FLUTTER_VULKAN_VULKAN_CONTEXT_H_
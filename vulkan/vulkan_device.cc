@@ -4,6 +4,7 @@
 
 #include "flutter/vulkan/vulkan_device.h"
 
+#include <algorithm>
 #include <limits>
 #include <map>
 #include <vector>
@@ -35,26 +36,36 @@ VulkanDevice::VulkanDevice(VulkanProcTable& p_vk,
     : vk(p_vk),
       physical_device_(std::move(physical_device)),
       graphics_queue_index_(std::numeric_limits<uint32_t>::max()),
+      timestamp_valid_bits_(0),
       valid_(false) {
   if (!physical_device_ || !vk.AreInstanceProcsSetup()) {
     return;
   }
 
-  graphics_queue_index_ = FindGraphicsQueueIndex(GetQueueFamilyProperties());
+  const auto queue_family_properties = GetQueueFamilyProperties();
+  graphics_queue_index_ = FindGraphicsQueueIndex(queue_family_properties);
 
   if (graphics_queue_index_ == kVulkanInvalidGraphicsQueueIndex) {
     FXL_DLOG(INFO) << "Could not find the graphics queue index.";
     return;
   }
 
-  const float priorities[1] = {1.0f};
+  timestamp_valid_bits_ =
+      queue_family_properties[graphics_queue_index_].timestampValidBits;
+
+  // A second queue in the graphics family, where there is one, lets a
+  // resource context upload on another thread without synchronizing with the
+  // onscreen context. Uploads are less urgent than frames.
+  const float priorities[2] = {1.0f, 0.5f};
+  const uint32_t queue_count = std::min<uint32_t>(
+      2, queue_family_properties[graphics_queue_index_].queueCount);
 
   const VkDeviceQueueCreateInfo queue_create = {
       .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
       .pNext = nullptr,
       .flags = 0,
       .queueFamilyIndex = graphics_queue_index_,
-      .queueCount = 1,
+      .queueCount = queue_count,
       .pQueuePriorities = priorities,
   };
 
@@ -115,6 +126,12 @@ VulkanDevice::VulkanDevice(VulkanProcTable& p_vk,
 
   queue_ = queue;
 
+  if (queue_count > 1) {
+    VkQueue resource_queue = VK_NULL_HANDLE;
+    vk.GetDeviceQueue(device_, graphics_queue_index_, 1, &resource_queue);
+    resource_queue_ = resource_queue;
+  }
+
   const VkCommandPoolCreateInfo command_pool_create_info = {
       .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
       .pNext = nullptr,
@@ -166,6 +183,10 @@ const VulkanHandle<VkQueue>& VulkanDevice::GetQueueHandle() const {
   return queue_;
 }
 
+const VulkanHandle<VkQueue>& VulkanDevice::GetResourceQueueHandle() const {
+  return resource_queue_;
+}
+
 const VulkanHandle<VkCommandPool>& VulkanDevice::GetCommandPool() const {
   return command_pool_;
 }
@@ -174,6 +195,10 @@ uint32_t VulkanDevice::GetGraphicsQueueIndex() const {
   return graphics_queue_index_;
 }
 
+uint32_t VulkanDevice::GetTimestampValidBits() const {
+  return timestamp_valid_bits_;
+}
+
 bool VulkanDevice::GetSurfaceCapabilities(
     const VulkanSurface& surface,
     VkSurfaceCapabilitiesKHR* capabilities) const {
@@ -217,6 +242,15 @@ bool VulkanDevice::GetPhysicalDeviceFeatures(
   return true;
 }
 
+bool VulkanDevice::GetPhysicalDeviceProperties(
+    VkPhysicalDeviceProperties* properties) const {
+  if (properties == nullptr || !physical_device_) {
+    return false;
+  }
+  vk.GetPhysicalDeviceProperties(physical_device_, properties);
+  return true;
+}
+
 bool VulkanDevice::GetPhysicalDeviceFeaturesSkia(uint32_t* sk_features) const {
   if (sk_features == nullptr) {
     return false;
@@ -321,6 +355,7 @@ bool VulkanDevice::ChooseSurfaceFormat(const VulkanSurface& surface,
 }
 
 bool VulkanDevice::ChoosePresentMode(const VulkanSurface& surface,
+                                     bool prefer_mailbox,
                                      VkPresentModeKHR* present_mode) const {
   if (!surface.IsValid() || present_mode == nullptr) {
     return false;
@@ -333,10 +368,36 @@ bool VulkanDevice::ChoosePresentMode(const VulkanSurface& surface,
   // powered by Vsync pulses instead of depending the the submit to block.
   // However, for platforms that don't have VSync providers setup, it is better
   // to fall back to FIFO. For platforms that do have VSync providers, there
-  // should be little difference. In case there is a need for a mode other than
-  // FIFO, availability checks must be performed here before returning the
-  // result. FIFO is always present.
+  // should be little difference. FIFO is always present.
   *present_mode = VK_PRESENT_MODE_FIFO_KHR;
+
+  if (!prefer_mailbox) {
+    return true;
+  }
+
+  // Mailbox lets the presentation engine replace a queued image instead of
+  // making acquires wait for it to be displayed.
+  uint32_t mode_count = 0;
+  if (VK_CALL_LOG_ERROR(vk.GetPhysicalDeviceSurfacePresentModesKHR(
+          physical_device_, surface.Handle(), &mode_count, nullptr)) !=
+          VK_SUCCESS ||
+      mode_count == 0) {
+    return true;
+  }
+
+  VkPresentModeKHR modes[mode_count];
+  if (VK_CALL_LOG_ERROR(vk.GetPhysicalDeviceSurfacePresentModesKHR(
+          physical_device_, surface.Handle(), &mode_count, modes)) !=
+      VK_SUCCESS) {
+    return true;
+  }
+
+  for (uint32_t i = 0; i < mode_count; i++) {
+    if (modes[i] == VK_PRESENT_MODE_MAILBOX_KHR) {
+      *present_mode = VK_PRESENT_MODE_MAILBOX_KHR;
+      break;
+    }
+  }
   return true;
 }
 
@@ -31,10 +31,18 @@ class VulkanDevice {
 
   const VulkanHandle<VkQueue>& GetQueueHandle() const;
 
+  // A second queue in the graphics queue family, or a null handle if the
+  // family only has one.
+  const VulkanHandle<VkQueue>& GetResourceQueueHandle() const;
+
   const VulkanHandle<VkCommandPool>& GetCommandPool() const;
 
   uint32_t GetGraphicsQueueIndex() const;
 
+  // The number of meaningful bits in the timestamps written on the graphics
+  // queue. Zero if the queue does not support timestamps.
+  uint32_t GetTimestampValidBits() const;
+
   void ReleaseDeviceOwnership();
 
   FXL_WARN_UNUSED_RESULT
@@ -44,6 +52,10 @@ class VulkanDevice {
   FXL_WARN_UNUSED_RESULT
   bool GetPhysicalDeviceFeatures(VkPhysicalDeviceFeatures* features) const;
 
+  FXL_WARN_UNUSED_RESULT
+  bool GetPhysicalDeviceProperties(
+      VkPhysicalDeviceProperties* properties) const;
+
   FXL_WARN_UNUSED_RESULT
   bool GetPhysicalDeviceFeaturesSkia(
       uint32_t* /* mask of GrVkFeatureFlags */ features) const;
@@ -52,8 +64,11 @@ class VulkanDevice {
   bool ChooseSurfaceFormat(const VulkanSurface& surface,
                            VkSurfaceFormatKHR* format) const;
 
+  // Chooses VK_PRESENT_MODE_MAILBOX_KHR if |prefer_mailbox| is set and the
+  // surface supports it, VK_PRESENT_MODE_FIFO_KHR otherwise.
   FXL_WARN_UNUSED_RESULT
   bool ChoosePresentMode(const VulkanSurface& surface,
+                         bool prefer_mailbox,
                          VkPresentModeKHR* present_mode) const;
 
   FXL_WARN_UNUSED_RESULT
@@ -71,8 +86,10 @@ class VulkanDevice {
   VulkanHandle<VkPhysicalDevice> physical_device_;
   VulkanHandle<VkDevice> device_;
   VulkanHandle<VkQueue> queue_;
+  VulkanHandle<VkQueue> resource_queue_;
   VulkanHandle<VkCommandPool> command_pool_;
   uint32_t graphics_queue_index_;
+  uint32_t timestamp_valid_bits_;
   bool valid_;
 
   std::vector<VkQueueFamilyProperties> GetQueueFamilyProperties() const;
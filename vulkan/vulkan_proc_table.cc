@@ -79,6 +79,7 @@ bool VulkanProcTable::SetupInstanceProcAddresses(
   ACQUIRE_PROC(EnumeratePhysicalDevices, handle);
   ACQUIRE_PROC(GetDeviceProcAddr, handle);
   ACQUIRE_PROC(GetPhysicalDeviceFeatures, handle);
+  ACQUIRE_PROC(GetPhysicalDeviceProperties, handle);
   ACQUIRE_PROC(GetPhysicalDeviceQueueFamilyProperties, handle);
   ACQUIRE_PROC(GetPhysicalDeviceSurfaceCapabilitiesKHR, handle);
   ACQUIRE_PROC(GetPhysicalDeviceSurfaceFormatsKHR, handle);
@@ -122,14 +123,18 @@ bool VulkanProcTable::SetupDeviceProcAddresses(
   ACQUIRE_PROC(BeginCommandBuffer, handle);
   ACQUIRE_PROC(BindImageMemory, handle);
   ACQUIRE_PROC(CmdPipelineBarrier, handle);
+  ACQUIRE_PROC(CmdResetQueryPool, handle);
+  ACQUIRE_PROC(CmdWriteTimestamp, handle);
   ACQUIRE_PROC(CreateCommandPool, handle);
   ACQUIRE_PROC(CreateFence, handle);
   ACQUIRE_PROC(CreateImage, handle);
+  ACQUIRE_PROC(CreateQueryPool, handle);
   ACQUIRE_PROC(CreateSemaphore, handle);
   ACQUIRE_PROC(CreateSwapchainKHR, handle);
   ACQUIRE_PROC(DestroyCommandPool, handle);
   ACQUIRE_PROC(DestroyFence, handle);
   ACQUIRE_PROC(DestroyImage, handle);
+  ACQUIRE_PROC(DestroyQueryPool, handle);
   ACQUIRE_PROC(DestroySemaphore, handle);
   ACQUIRE_PROC(DestroySwapchainKHR, handle);
   ACQUIRE_PROC(DeviceWaitIdle, handle);
@@ -137,7 +142,9 @@ bool VulkanProcTable::SetupDeviceProcAddresses(
   ACQUIRE_PROC(FreeCommandBuffers, handle);
   ACQUIRE_PROC(FreeMemory, handle);
   ACQUIRE_PROC(GetDeviceQueue, handle);
+  ACQUIRE_PROC(GetFenceStatus, handle);
   ACQUIRE_PROC(GetImageMemoryRequirements, handle);
+  ACQUIRE_PROC(GetQueryPoolResults, handle);
   ACQUIRE_PROC(GetSwapchainImagesKHR, handle);
   ACQUIRE_PROC(QueuePresentKHR, handle);
   ACQUIRE_PROC(QueueSubmit, handle);
@@ -69,12 +69,15 @@ class VulkanProcTable : public fxl::RefCountedThreadSafe<VulkanProcTable> {
   DEFINE_PROC(BeginCommandBuffer);
   DEFINE_PROC(BindImageMemory);
   DEFINE_PROC(CmdPipelineBarrier);
+  DEFINE_PROC(CmdResetQueryPool);
+  DEFINE_PROC(CmdWriteTimestamp);
   DEFINE_PROC(CreateCommandPool);
   DEFINE_PROC(CreateDebugReportCallbackEXT);
   DEFINE_PROC(CreateDevice);
   DEFINE_PROC(CreateFence);
   DEFINE_PROC(CreateImage);
   DEFINE_PROC(CreateInstance);
+  DEFINE_PROC(CreateQueryPool);
   DEFINE_PROC(CreateSemaphore);
   DEFINE_PROC(CreateSwapchainKHR);
   DEFINE_PROC(DestroyCommandPool);
@@ -83,6 +86,7 @@ class VulkanProcTable : public fxl::RefCountedThreadSafe<VulkanProcTable> {
   DEFINE_PROC(DestroyFence);
   DEFINE_PROC(DestroyImage);
   DEFINE_PROC(DestroyInstance);
+  DEFINE_PROC(DestroyQueryPool);
   DEFINE_PROC(DestroySemaphore);
   DEFINE_PROC(DestroySurfaceKHR);
   DEFINE_PROC(DestroySwapchainKHR);
@@ -96,14 +100,17 @@ class VulkanProcTable : public fxl::RefCountedThreadSafe<VulkanProcTable> {
   DEFINE_PROC(FreeMemory);
   DEFINE_PROC(GetDeviceProcAddr);
   DEFINE_PROC(GetDeviceQueue);
+  DEFINE_PROC(GetFenceStatus);
   DEFINE_PROC(GetImageMemoryRequirements);
   DEFINE_PROC(GetInstanceProcAddr);
   DEFINE_PROC(GetPhysicalDeviceFeatures);
+  DEFINE_PROC(GetPhysicalDeviceProperties);
   DEFINE_PROC(GetPhysicalDeviceQueueFamilyProperties);
   DEFINE_PROC(GetPhysicalDeviceSurfaceCapabilitiesKHR);
   DEFINE_PROC(GetPhysicalDeviceSurfaceFormatsKHR);
   DEFINE_PROC(GetPhysicalDeviceSurfacePresentModesKHR);
   DEFINE_PROC(GetPhysicalDeviceSurfaceSupportKHR);
+  DEFINE_PROC(GetQueryPoolResults);
   DEFINE_PROC(GetSwapchainImagesKHR);
   DEFINE_PROC(QueuePresentKHR);
   DEFINE_PROC(QueueSubmit);
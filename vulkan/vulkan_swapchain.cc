@@ -4,6 +4,7 @@
 
 #include "flutter/vulkan/vulkan_swapchain.h"
 
+#include "flutter/glue/trace_event.h"
 #include "flutter/vulkan/vulkan_backbuffer.h"
 #include "flutter/vulkan/vulkan_device.h"
 #include "flutter/vulkan/vulkan_image.h"
@@ -20,7 +21,9 @@ VulkanSwapchain::VulkanSwapchain(const VulkanProcTable& p_vk,
                                  const VulkanSurface& surface,
                                  GrContext* skia_context,
                                  std::unique_ptr<VulkanSwapchain> old_swapchain,
-                                 uint32_t queue_family_index)
+                                 uint32_t queue_family_index,
+                                 bool prefer_mailbox_present_mode,
+                                 bool enable_timestamp_queries)
     : vk(p_vk),
       device_(device),
       capabilities_(),
@@ -28,6 +31,10 @@ VulkanSwapchain::VulkanSwapchain(const VulkanProcTable& p_vk,
       current_pipeline_stage_(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT),
       current_backbuffer_index_(0),
       current_image_index_(0),
+      timestamps_enabled_(false),
+      timestamp_period_(0),
+      timestamp_mask_(0),
+      has_gpu_frame_time_(false),
       valid_(false) {
   if (!device_.IsValid() || !surface.IsValid() || skia_context == nullptr) {
     FXL_DLOG(INFO) << "Device or surface is invalid.";
@@ -45,11 +52,34 @@ VulkanSwapchain::VulkanSwapchain(const VulkanProcTable& p_vk,
   }
 
   VkPresentModeKHR present_mode = VK_PRESENT_MODE_FIFO_KHR;
-  if (!device_.ChoosePresentMode(surface, &present_mode)) {
+  if (!device_.ChoosePresentMode(surface, prefer_mailbox_present_mode,
+                                 &present_mode)) {
     FXL_DLOG(INFO) << "Could not choose present mode.";
     return;
   }
 
+  // In mailbox mode, one image is being displayed and another may be queued,
+  // so one more image keeps an image free to acquire.
+  uint32_t image_count = capabilities_.minImageCount;
+  if (present_mode == VK_PRESENT_MODE_MAILBOX_KHR &&
+      (capabilities_.maxImageCount == 0 ||
+       image_count < capabilities_.maxImageCount)) {
+    image_count++;
+  }
+
+  const uint32_t timestamp_valid_bits = device_.GetTimestampValidBits();
+  VkPhysicalDeviceProperties properties;
+  if (enable_timestamp_queries && timestamp_valid_bits > 0 &&
+      device_.GetPhysicalDeviceProperties(&properties)) {
+    timestamps_enabled_ = true;
+    timestamp_period_ = properties.limits.timestampPeriod;
+    timestamp_mask_ = timestamp_valid_bits >= 64
+                          ? std::numeric_limits<uint64_t>::max()
+                          : (uint64_t{1} << timestamp_valid_bits) - 1;
+  } else if (enable_timestamp_queries) {
+    FXL_LOG(INFO) << "The graphics queue does not support timestamps.";
+  }
+
   // Check if the surface can present.
 
   VkBool32 supported = VK_FALSE;
@@ -84,7 +114,7 @@ VulkanSwapchain::VulkanSwapchain(const VulkanProcTable& p_vk,
       .pNext = nullptr,
       .flags = 0,
       .surface = surface_handle,
-      .minImageCount = capabilities_.minImageCount,
+      .minImageCount = image_count,
       .imageFormat = surface_format_.format,
       .imageColorSpace = surface_format_.colorSpace,
       .imageExtent = capabilities_.currentExtent,
@@ -232,7 +262,8 @@ bool VulkanSwapchain::CreateSwapchainImages(GrContext* skia_context) {
   for (const VkImage& image : images) {
     // Populate the backbuffer.
     auto backbuffer = std::make_unique<VulkanBackbuffer>(
-        vk, device_.GetHandle(), device_.GetCommandPool());
+        vk, device_.GetHandle(), device_.GetCommandPool(),
+        timestamps_enabled_);
 
     if (!backbuffer->IsValid()) {
       return false;
@@ -272,8 +303,17 @@ VulkanBackbuffer* VulkanSwapchain::GetNextBackbuffer() {
     return nullptr;
   }
 
+  // Prefer a backbuffer the device is done with over waiting for the oldest
+  // one. If none is done, the oldest finishes first.
   auto next_backbuffer_index =
       (current_backbuffer_index_ + 1) % backbuffers_.size();
+  for (size_t i = 0; i < available_backbuffers; i++) {
+    auto index = (current_backbuffer_index_ + 1 + i) % available_backbuffers;
+    if (backbuffers_[index]->IsValid() && backbuffers_[index]->IsReady()) {
+      next_backbuffer_index = index;
+      break;
+    }
+  }
 
   auto& backbuffer = backbuffers_[next_backbuffer_index];
 
@@ -285,6 +325,36 @@ VulkanBackbuffer* VulkanSwapchain::GetNextBackbuffer() {
   return backbuffer.get();
 }
 
+void VulkanSwapchain::ReadTimestamps(VulkanBackbuffer& backbuffer) {
+  if (!backbuffer.HasPendingTimestamps()) {
+    return;
+  }
+  backbuffer.SetHasPendingTimestamps(false);
+
+  // The fences of the backbuffer are signaled, so the results are available.
+  uint64_t timestamps[2] = {};
+  if (VK_CALL_LOG_ERROR(vk.GetQueryPoolResults(
+          device_.GetHandle(), backbuffer.GetTimestampQueryPool(), 0, 2,
+          sizeof(timestamps), timestamps, sizeof(uint64_t),
+          VK_QUERY_RESULT_64_BIT)) != VK_SUCCESS) {
+    return;
+  }
+
+  const uint64_t ticks = (timestamps[1] - timestamps[0]) & timestamp_mask_;
+  gpu_frame_time_ = fxl::TimeDelta::FromNanoseconds(
+      static_cast<int64_t>(ticks * timestamp_period_));
+  has_gpu_frame_time_ = true;
+}
+
+bool VulkanSwapchain::TakeGpuFrameTime(fxl::TimeDelta* time) {
+  if (!has_gpu_frame_time_) {
+    return false;
+  }
+  *time = gpu_frame_time_;
+  has_gpu_frame_time_ = false;
+  return true;
+}
+
 VulkanSwapchain::AcquireResult VulkanSwapchain::AcquireSurface() {
   AcquireResult error = {AcquireStatus::ErrorSurfaceLost, nullptr};
 
@@ -308,9 +378,12 @@ VulkanSwapchain::AcquireResult VulkanSwapchain::AcquireSurface() {
   // Step 1:
   // Wait for use readiness.
   // ---------------------------------------------------------------------------
-  if (!backbuffer->WaitFences()) {
-    FXL_DLOG(INFO) << "Failed waiting on fences.";
-    return error;
+  {
+    TRACE_EVENT0("flutter", "VulkanSwapchain::WaitFences");
+    if (!backbuffer->WaitFences()) {
+      FXL_DLOG(INFO) << "Failed waiting on fences.";
+      return error;
+    }
   }
 
   // ---------------------------------------------------------------------------
@@ -322,19 +395,26 @@ VulkanSwapchain::AcquireResult VulkanSwapchain::AcquireSurface() {
     return error;
   }
 
+  ReadTimestamps(*backbuffer);
+
   // ---------------------------------------------------------------------------
   // Step 3:
   // Acquire the next image index.
   // ---------------------------------------------------------------------------
   uint32_t next_image_index = 0;
 
-  VkResult acquire_result = VK_CALL_LOG_ERROR(
-      vk.AcquireNextImageKHR(device_.GetHandle(),                   //
-                             swapchain_,                            //
-                             std::numeric_limits<uint64_t>::max(),  //
-                             backbuffer->GetUsageSemaphore(),       //
-                             VK_NULL_HANDLE,                        //
-                             &next_image_index));
+  VkResult acquire_result = VK_SUCCESS;
+  {
+    // Blocks while the presentation engine holds every image.
+    TRACE_EVENT0("flutter", "VulkanSwapchain::AcquireNextImage");
+    acquire_result = VK_CALL_LOG_ERROR(
+        vk.AcquireNextImageKHR(device_.GetHandle(),                   //
+                               swapchain_,                            //
+                               std::numeric_limits<uint64_t>::max(),  //
+                               backbuffer->GetUsageSemaphore(),       //
+                               VK_NULL_HANDLE,                        //
+                               &next_image_index));
+  }
 
   switch (acquire_result) {
     case VK_SUCCESS:
@@ -392,6 +472,18 @@ VulkanSwapchain::AcquireResult VulkanSwapchain::AcquireSurface() {
     current_pipeline_stage_ = destination_pipeline_stage;
   }
 
+  // The frame starts once the image is available and in the layout Skia
+  // renders to. Queries must be reset before they are written again.
+  const VulkanHandle<VkQueryPool>& timestamp_pool =
+      backbuffer->GetTimestampQueryPool();
+  if (timestamp_pool) {
+    const VkCommandBuffer command_buffer =
+        backbuffer->GetUsageCommandBuffer().Handle();
+    vk.CmdResetQueryPool(command_buffer, timestamp_pool, 0, 2);
+    vk.CmdWriteTimestamp(command_buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                         timestamp_pool, 0);
+  }
+
   // ---------------------------------------------------------------------------
   // Step 6:
   // End recording to the command buffer.
@@ -498,6 +590,16 @@ bool VulkanSwapchain::Submit() {
     current_pipeline_stage_ = destination_pipeline_stage;
   }
 
+  // Skia submitted the commands of the frame when the render target handle
+  // was accessed above, so they complete before this timestamp is written.
+  const VulkanHandle<VkQueryPool>& timestamp_pool =
+      backbuffer->GetTimestampQueryPool();
+  if (timestamp_pool) {
+    vk.CmdWriteTimestamp(backbuffer->GetRenderCommandBuffer().Handle(),
+                         VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, timestamp_pool,
+                         1);
+  }
+
   // ---------------------------------------------------------------------------
   // Step 3:
   // End recording to the command buffer.
@@ -529,6 +631,8 @@ bool VulkanSwapchain::Submit() {
     return false;
   }
 
+  backbuffer->SetHasPendingTimestamps(static_cast<bool>(timestamp_pool));
+
   // ---------------------------------------------------------------------------
   // Step 5:
   // Submit the present operation and wait on the render semaphore.
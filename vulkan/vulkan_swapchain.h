@@ -12,6 +12,7 @@
 #include "flutter/vulkan/vulkan_handle.h"
 #include "lib/fxl/compiler_specific.h"
 #include "lib/fxl/macros.h"
+#include "lib/fxl/time/time_delta.h"
 #include "third_party/skia/include/core/SkSize.h"
 #include "third_party/skia/include/core/SkSurface.h"
 
@@ -30,7 +31,9 @@ class VulkanSwapchain {
                   const VulkanSurface& surface,
                   GrContext* skia_context,
                   std::unique_ptr<VulkanSwapchain> old_swapchain,
-                  uint32_t queue_family_index);
+                  uint32_t queue_family_index,
+                  bool prefer_mailbox_present_mode = false,
+                  bool enable_timestamp_queries = false);
 
   ~VulkanSwapchain();
 
@@ -61,6 +64,12 @@ class VulkanSwapchain {
 
   SkISize GetSize() const;
 
+  // Sets |time| to how long the device spent on the most recent frame whose
+  // timestamps have been read since the previous call. Timestamps are read
+  // when their backbuffer is reused. Returns false if there is no new
+  // measurement or timestamp queries are not enabled.
+  bool TakeGpuFrameTime(fxl::TimeDelta* time);
+
  private:
   const VulkanProcTable& vk;
   const VulkanDevice& device_;
@@ -73,6 +82,13 @@ class VulkanSwapchain {
   VkPipelineStageFlagBits current_pipeline_stage_;
   size_t current_backbuffer_index_;
   size_t current_image_index_;
+  // Set if timestamp queries were requested and the queue supports them.
+  bool timestamps_enabled_;
+  // The nanoseconds per timestamp tick.
+  double timestamp_period_;
+  uint64_t timestamp_mask_;
+  fxl::TimeDelta gpu_frame_time_;
+  bool has_gpu_frame_time_;
   bool valid_;
 
   std::vector<VkImage> GetImages() const;
@@ -85,6 +101,8 @@ class VulkanSwapchain {
 
   VulkanBackbuffer* GetNextBackbuffer();
 
+  void ReadTimestamps(VulkanBackbuffer& backbuffer);
+
   FXL_DISALLOW_COPY_AND_ASSIGN(VulkanSwapchain);
 };
 
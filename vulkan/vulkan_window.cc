@@ -4,65 +4,73 @@
 
 #include "flutter/vulkan/vulkan_window.h"
 
+#include <iomanip>
 #include <memory>
+#include <sstream>
 #include <string>
 
-#include "flutter/vulkan/vulkan_application.h"
 #include "flutter/vulkan/vulkan_device.h"
 #include "flutter/vulkan/vulkan_native_surface.h"
 #include "flutter/vulkan/vulkan_surface.h"
 #include "flutter/vulkan/vulkan_swapchain.h"
 #include "third_party/skia/include/gpu/GrContext.h"
-#include "third_party/skia/include/gpu/vk/GrVkInterface.h"
 
 namespace vulkan {
 
-VulkanWindow::VulkanWindow(fxl::RefPtr<VulkanProcTable> proc_table,
-                           std::unique_ptr<VulkanNativeSurface> native_surface)
-    : valid_(false), vk(std::move(proc_table)) {
-  if (!vk || !vk->HasAcquiredMandatoryProcAddresses()) {
-    FXL_DLOG(INFO) << "Proc table has not acquired mandatory proc addresses.";
-    return;
-  }
-
-  if (native_surface == nullptr || !native_surface->IsValid()) {
-    FXL_DLOG(INFO) << "Native surface is invalid.";
-    return;
+static fxl::RefPtr<VulkanContext> CreateContext(
+    fxl::RefPtr<VulkanProcTable> proc_table,
+    const VulkanNativeSurface* native_surface) {
+  if (!proc_table || native_surface == nullptr ||
+      !native_surface->IsValid()) {
+    return nullptr;
   }
 
-  // Create the application instance.
-
   std::vector<std::string> extensions = {
       VK_KHR_SURFACE_EXTENSION_NAME,      // parent extension
       native_surface->GetExtensionName()  // child extension
   };
 
-  application_ = std::make_unique<VulkanApplication>(*vk, "Flutter",
-                                                     std::move(extensions));
+  return fxl::MakeRefCounted<VulkanContext>(std::move(proc_table),
+                                            std::move(extensions));
+}
 
-  if (!application_->IsValid() || !vk->AreInstanceProcsSetup()) {
-    // Make certain the application instance was created and it setup the
-    // instance proc table entries.
-    FXL_DLOG(INFO) << "Instance proc addresses have not been setup.";
+VulkanWindow::VulkanWindow(fxl::RefPtr<VulkanProcTable> proc_table,
+                           std::unique_ptr<VulkanNativeSurface> native_surface,
+                           PersistentCacheFactory persistent_cache_factory,
+                           bool prefer_mailbox_present_mode,
+                           bool enable_timestamp_queries)
+    : VulkanWindow(CreateContext(std::move(proc_table), native_surface.get()),
+                   std::move(native_surface),
+                   std::move(persistent_cache_factory),
+                   prefer_mailbox_present_mode,
+                   enable_timestamp_queries) {}
+
+VulkanWindow::VulkanWindow(fxl::RefPtr<VulkanContext> context,
+                           std::unique_ptr<VulkanNativeSurface> native_surface,
+                           PersistentCacheFactory persistent_cache_factory,
+                           bool prefer_mailbox_present_mode,
+                           bool enable_timestamp_queries)
+    : valid_(false),
+      context_(std::move(context)),
+      persistent_cache_factory_(std::move(persistent_cache_factory)),
+      prefer_mailbox_present_mode_(prefer_mailbox_present_mode),
+      enable_timestamp_queries_(enable_timestamp_queries) {
+  if (native_surface == nullptr || !native_surface->IsValid()) {
+    FXL_DLOG(INFO) << "Native surface is invalid.";
     return;
   }
 
-  // Create the device.
-
-  logical_device_ = application_->AcquireFirstCompatibleLogicalDevice();
-
-  if (logical_device_ == nullptr || !logical_device_->IsValid() ||
-      !vk->AreDeviceProcsSetup()) {
-    // Make certain the device was created and it setup the device proc table
-    // entries.
-    FXL_DLOG(INFO) << "Device proc addresses have not been setup.";
+  if (!context_ || !context_->IsValid()) {
+    FXL_DLOG(INFO) << "The Vulkan instance or device could not be created.";
     return;
   }
 
+  vk = context_->GetProcTable();
+
   // Create the logical surface from the native platform surface.
 
-  surface_ = std::make_unique<VulkanSurface>(*vk, *application_,
-                                             std::move(native_surface));
+  surface_ = std::make_unique<VulkanSurface>(
+      *vk, context_->GetApplication(), std::move(native_surface));
 
   if (!surface_->IsValid()) {
     FXL_DLOG(INFO) << "Vulkan surface is invalid.";
@@ -103,9 +111,15 @@ bool VulkanWindow::CreateSkiaGrContext() {
     return false;
   }
 
+  GrContextOptions options;
+  if (persistent_cache_factory_) {
+    persistent_cache_ = persistent_cache_factory_(GetDriverVersion());
+    options.fPersistentCache = persistent_cache_.get();
+  }
+
   sk_sp<GrContext> context(GrContext::Create(
       kVulkan_GrBackend,
-      reinterpret_cast<GrBackendContext>(backend_context.get())));
+      reinterpret_cast<GrBackendContext>(backend_context.get()), options));
 
   if (context == nullptr) {
     return false;
@@ -119,36 +133,27 @@ bool VulkanWindow::CreateSkiaGrContext() {
   return true;
 }
 
-sk_sp<GrVkBackendContext> VulkanWindow::CreateSkiaBackendContext() {
-  auto interface = vk->CreateSkiaInterface();
-
-  if (interface == nullptr || !interface->validate(0)) {
-    return nullptr;
+// Pipeline caches are only valid for the device and driver whose pipeline
+// cache UUID they were created with.
+std::string VulkanWindow::GetDriverVersion() const {
+  VkPhysicalDeviceProperties properties = {};
+  if (!context_->GetDevice().GetPhysicalDeviceProperties(&properties)) {
+    return std::string();
   }
-
-  uint32_t skia_features = 0;
-  if (!logical_device_->GetPhysicalDeviceFeaturesSkia(&skia_features)) {
-    return nullptr;
+  std::ostringstream version;
+  version << "vulkan\n" << std::hex << properties.vendorID << "-"
+          << properties.deviceID << "-" << properties.driverVersion << "-";
+  for (uint32_t i = 0; i < VK_UUID_SIZE; i++) {
+    version << std::setw(2) << std::setfill('0')
+            << static_cast<uint32_t>(properties.pipelineCacheUUID[i]);
   }
+  return version.str();
+}
 
-  // The Skia backend context takes ownership of the device and the instance.
-  // Make sure we release our ownership now.
-  logical_device_->ReleaseDeviceOwnership();
-  application_->ReleaseInstanceOwnership();
-
-  auto context = sk_make_sp<GrVkBackendContext>();
-  context->fInstance = application_->GetInstance();
-  context->fPhysicalDevice = logical_device_->GetPhysicalDeviceHandle();
-  context->fDevice = logical_device_->GetHandle();
-  context->fQueue = logical_device_->GetQueueHandle();
-  context->fGraphicsQueueIndex = logical_device_->GetGraphicsQueueIndex();
-  context->fMinAPIVersion = application_->GetAPIVersion();
-  context->fExtensions = kKHR_surface_GrVkExtensionFlag |
-                         kKHR_swapchain_GrVkExtensionFlag |
-                         surface_->GetNativeSurface().GetSkiaExtensionName();
-  context->fFeatures = skia_features;
-  context->fInterface.reset(interface.release());
-  return context;
+sk_sp<GrVkBackendContext> VulkanWindow::CreateSkiaBackendContext() {
+  return context_->CreateSkiaBackendContext(
+      kKHR_surface_GrVkExtensionFlag | kKHR_swapchain_GrVkExtensionFlag |
+      surface_->GetNativeSurface().GetSkiaExtensionName());
 }
 
 sk_sp<SkSurface> VulkanWindow::AcquireSurface() {
@@ -225,6 +230,10 @@ bool VulkanWindow::SwapBuffers() {
   return swapchain_->Submit();
 }
 
+bool VulkanWindow::TakeGpuFrameTime(fxl::TimeDelta* time) {
+  return swapchain_ != nullptr && swapchain_->TakeGpuFrameTime(time);
+}
+
 bool VulkanWindow::RecreateSwapchain() {
   // This way, we always lose our reference to the old swapchain. Even if we
   // cannot create a new one to replace it.
@@ -234,10 +243,6 @@ bool VulkanWindow::RecreateSwapchain() {
     return false;
   }
 
-  if (logical_device_ == nullptr || !logical_device_->IsValid()) {
-    return false;
-  }
-
   if (surface_ == nullptr || !surface_->IsValid()) {
     return false;
   }
@@ -246,9 +251,11 @@ bool VulkanWindow::RecreateSwapchain() {
     return false;
   }
 
+  VulkanDevice& device = context_->GetDevice();
   auto swapchain = std::make_unique<VulkanSwapchain>(
-      *vk, *logical_device_, *surface_, skia_gr_context_.get(),
-      std::move(old_swapchain), logical_device_->GetGraphicsQueueIndex());
+      *vk, device, *surface_, skia_gr_context_.get(), std::move(old_swapchain),
+      device.GetGraphicsQueueIndex(), prefer_mailbox_present_mode_,
+      enable_timestamp_queries_);
 
   if (!swapchain->IsValid()) {
     return false;
@@ -5,34 +5,55 @@
 #ifndef FLUTTER_VULKAN_VULKAN_WINDOW_H_
 #define FLUTTER_VULKAN_VULKAN_WINDOW_H_
 
+#include <functional>
 #include <memory>
+#include <string>
 #include <tuple>
 #include <utility>
 #include <vector>
 
+#include "flutter/vulkan/vulkan_context.h"
 #include "flutter/vulkan/vulkan_proc_table.h"
 #include "lib/fxl/compiler_specific.h"
 #include "lib/fxl/macros.h"
+#include "lib/fxl/time/time_delta.h"
 #include "third_party/skia/include/core/SkRefCnt.h"
 #include "third_party/skia/include/core/SkSize.h"
 #include "third_party/skia/include/core/SkSurface.h"
 #include "third_party/skia/include/gpu/GrContext.h"
+#include "third_party/skia/include/gpu/GrContextOptions.h"
 #include "third_party/skia/include/gpu/vk/GrVkBackendContext.h"
 
 namespace vulkan {
 
 class VulkanNativeSurface;
-class VulkanDevice;
 class VulkanSurface;
 class VulkanSwapchain;
 class VulkanImage;
-class VulkanApplication;
 class VulkanBackbuffer;
 
 class VulkanWindow {
  public:
+  // Returns the cache for the pipelines compiled by the Skia context, or null.
+  // |driver_version| identifies the device and its driver.
+  using PersistentCacheFactory =
+      std::function<std::unique_ptr<GrContextOptions::PersistentCache>(
+          const std::string& driver_version)>;
+
+  // Creates an instance and device used by this window only.
   VulkanWindow(fxl::RefPtr<VulkanProcTable> proc_table,
-               std::unique_ptr<VulkanNativeSurface> native_surface);
+               std::unique_ptr<VulkanNativeSurface> native_surface,
+               PersistentCacheFactory persistent_cache_factory = nullptr,
+               bool prefer_mailbox_present_mode = false,
+               bool enable_timestamp_queries = false);
+
+  // Renders with the device of |context|, whose instance must have been
+  // created with the extension of |native_surface|.
+  VulkanWindow(fxl::RefPtr<VulkanContext> context,
+               std::unique_ptr<VulkanNativeSurface> native_surface,
+               PersistentCacheFactory persistent_cache_factory = nullptr,
+               bool prefer_mailbox_present_mode = false,
+               bool enable_timestamp_queries = false);
 
   ~VulkanWindow();
 
@@ -44,20 +65,29 @@ class VulkanWindow {
 
   bool SwapBuffers();
 
+  // See |VulkanSwapchain::TakeGpuFrameTime|.
+  bool TakeGpuFrameTime(fxl::TimeDelta* time);
+
  private:
   bool valid_;
   fxl::RefPtr<VulkanProcTable> vk;
-  // Note: The order of objects here is important because the
-  // GrVkBackendContext assumes ownership of the device and instance handles.
+  // Owns the device and instance handles, so it must outlive everything
+  // below.
+  fxl::RefPtr<VulkanContext> context_;
   sk_sp<GrVkBackendContext> skia_vk_backend_context_;
-  std::unique_ptr<VulkanApplication> application_;
-  std::unique_ptr<VulkanDevice> logical_device_;
   std::unique_ptr<VulkanSurface> surface_;
   std::unique_ptr<VulkanSwapchain> swapchain_;
+  PersistentCacheFactory persistent_cache_factory_;
+  const bool prefer_mailbox_present_mode_;
+  const bool enable_timestamp_queries_;
+  // Outlives skia_gr_context_.
+  std::unique_ptr<GrContextOptions::PersistentCache> persistent_cache_;
   sk_sp<GrContext> skia_gr_context_;
 
   bool CreateSkiaGrContext();
 
+  std::string GetDriverVersion() const;
+
   sk_sp<GrVkBackendContext> CreateSkiaBackendContext();
 
   FXL_WARN_UNUSED_RESULT